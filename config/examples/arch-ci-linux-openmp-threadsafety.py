@@ -0,0 +1,24 @@
+#!/usr/bin/env python
+
+import os
+petsc_hash_pkgs=os.path.join(os.getenv('HOME'),'petsc-hash-pkgs')
+if not os.path.isdir(petsc_hash_pkgs): os.mkdir(petsc_hash_pkgs)
+
+# runs the tests that require openmp threadsafety, such as the threaded blocks of PCBJACOBI and PCASM;
+# --with-threadsafety requires --with-debugging=0 and --with-log=0
+configure_options = [
+  '--package-prefix-hash='+petsc_hash_pkgs,
+  '--with-debugging=0',
+  '--with-log=0',
+  '--with-openmp=1',
+  '--with-threadsafety=1',
+  '--download-mpich=1',
+  '--with-fc=0',
+  '--with-shared-libraries=1'
+  ]
+
+if __name__ == '__main__':
+  import sys,os
+  sys.path.insert(0,os.path.abspath('config'))
+  import configure
+  configure.petsc_configure(configure_options)
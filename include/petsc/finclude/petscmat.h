@@ -95,6 +95,9 @@
 #define MATAIJSELL         'aijsell'
 #define MATSEQAIJSELL      'seqaijsell'
 #define MATMPIAIJSELL      'mpiaijsell'
+#define MATAIJOMP          'aijomp'
+#define MATSEQAIJOMP       'seqaijomp'
+#define MATMPIAIJOMP       'mpiaijomp'
 #define MATAIJMKL          'aijmkl'
 #define MATSEQAIJMKL       'seqaijmkl'
 #define MATMPIAIJMKL       'mpiaijmkl'
@@ -45,6 +45,8 @@ struct _DMOps {
 
   PetscErrorCode (*globaltolocalbegin)(DM,Vec,InsertMode,Vec);
   PetscErrorCode (*globaltolocalend)(DM,Vec,InsertMode,Vec);
+  PetscErrorCode (*globaltolocalbeginmultiple)(DM,PetscInt,Vec*,InsertMode,Vec*);
+  PetscErrorCode (*globaltolocalendmultiple)(DM,PetscInt,Vec*,InsertMode,Vec*);
   PetscErrorCode (*localtoglobalbegin)(DM,Vec,InsertMode,Vec);
   PetscErrorCode (*localtoglobalend)(DM,Vec,InsertMode,Vec);
   PetscErrorCode (*localtolocalbegin)(DM,Vec,InsertMode,Vec);
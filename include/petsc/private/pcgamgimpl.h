@@ -10,6 +10,7 @@ struct _PCGAMGOps {
   PetscErrorCode (*coarsen)(PC, Mat*, PetscCoarsenData**);
   PetscErrorCode (*prolongator)(PC, Mat, Mat, PetscCoarsenData*, Mat*);
   PetscErrorCode (*optprolongator)(PC, Mat, Mat*);
+  PetscErrorCode (*updateprolongator)(PC, Mat, Mat, Mat*); /* recompute the values of the optimized prolongator from the tentative one, see PCGAMGSetReuseAggregates() */
   PetscErrorCode (*createlevel)(PC, Mat, PetscInt, Mat *, Mat *, PetscMPIInt *, IS *, PetscBool);
   PetscErrorCode (*createdefaultdata)(PC, Mat); /* for data methods that have a default (SA) */
   PetscErrorCode (*setfromoptions)(PetscOptionItems*,PC);
@@ -23,6 +24,9 @@ typedef struct gamg_TAG {
   PetscInt  setup_count;
   PetscBool repart;
   PetscBool reuse_prol;
+  PetscBool reuse_aggs;
+  PetscInt  numeric_count; /* number of setups that only recomputed values since the last full one */
+  Mat       Prol0[PETSC_MG_MAXLEVELS]; /* tentative prolongators with the columns of the coarse grids, kept for PCGAMGSetReuseAggregates() */
   PetscBool use_aggs_in_asm;
   PetscBool use_parallel_coarse_grid_solver;
   PCGAMGLayoutType layout_type;
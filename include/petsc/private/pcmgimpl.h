@@ -31,6 +31,13 @@ typedef struct {
   PetscLogEvent eventsmoothsolve;
   PetscLogEvent eventresidual;
   PetscLogEvent eventinterprestrict;
+
+  /* agglomeration of the coarse levels onto fewer processes, see PCMGSetAgglomeration() */
+  PetscSubcomm  psubcomm;                      /* the processes working on the level */
+  PetscMPIInt   nactive;                       /* their number, 0 if the level is not agglomerated */
+  PetscInt      M;                             /* global size of the level */
+  PetscBool     idle;                          /* this process has no rows on the level */
+  Vec           cb,cx;                         /* b and x of the coarser level laid out on the processes of this level */
 } PC_MG_Levels;
 
 /*
@@ -53,6 +60,10 @@ typedef struct {
   PetscErrorCode (*view)(PC,PetscViewer);     /* GAMG and other objects that use PCMG can set their own viewer here */
   PetscReal      min_eigen_DinvA[PETSC_MG_MAXLEVELS];
   PetscReal      max_eigen_DinvA[PETSC_MG_MAXLEVELS];
+
+  PetscInt     agglomeqlim;                   /* agglomerate a level while it has fewer rows per process */
+  PetscInt     agglomfactor;                  /* divide the number of processes by this at each agglomeration */
+  PC_MG_Levels **alevels;                     /* the levels run by the cycle when some of them are agglomerated */
 } PC_MG;
 
 PETSC_INTERN PetscErrorCode PCSetUp_MG(PC);
@@ -61,6 +72,13 @@ PETSC_INTERN PetscErrorCode PCSetFromOptions_MG(PetscOptionItems *PetscOptionsOb
 PETSC_INTERN PetscErrorCode PCView_MG(PC,PetscViewer);
 PETSC_INTERN PetscErrorCode PCMGGetLevels_MG(PC,PetscInt *);
 PETSC_INTERN PetscErrorCode PCMGSetLevels_MG(PC,PetscInt,MPI_Comm *);
+PETSC_INTERN PetscErrorCode PCMGAgglomerateSetUp_Private(PC);
+PETSC_INTERN PetscErrorCode PCMGAgglomerateUpdate_Private(PC);
+PETSC_INTERN PetscErrorCode PCMGAgglomerateGetSmoother_Private(PC,PetscInt,KSP*);
+PETSC_INTERN PetscErrorCode PCMGAgglomerateReset_Private(PC);
+PETSC_INTERN PetscErrorCode PCMGAgglomerateView_Private(PC_MG_Levels*,PC_MG_Levels*,PetscViewer);
+PETSC_INTERN PetscErrorCode PCMGAgglomerateRestrict_Private(PC_MG_Levels*,PC_MG_Levels*);
+PETSC_INTERN PetscErrorCode PCMGAgglomerateInterpolateAdd_Private(PC_MG_Levels*,PC_MG_Levels*);
 PETSC_DEPRECATED_FUNCTION("Use PCMGResidualDefault() (since version 3.5)") PETSC_STATIC_INLINE PetscErrorCode PCMGResidual_Default(Mat A,Vec b,Vec x,Vec r) {
   return PCMGResidualDefault(A,b,x,r);
 }
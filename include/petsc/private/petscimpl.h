@@ -836,6 +836,19 @@ typedef enum {STATE_BEGIN, STATE_PENDING, STATE_END} SRState;
 
 typedef enum {PETSC_SR_REDUCE_SUM=0,PETSC_SR_REDUCE_MAX=1,PETSC_SR_REDUCE_MIN=2} PetscSRReductionType;
 
+/*
+   The binned sum of PetscReal used by the reproducible reductions, see VecSetReproducibleReductions(). All the
+   members are PetscReal so that it is communicated as an array of them.
+*/
+#define PETSC_BINNED_FOLD 3
+typedef struct {
+  PetscReal op;                           /* PETSC_SR_REDUCE_SUM, or PETSC_SR_REDUCE_MAX or PETSC_SR_REDUCE_MIN of value */
+  PetscReal index;                        /* the bin of bins[0], the others are the bins below it; -1 when empty */
+  PetscReal value;                        /* the sum of the infinite summands, or the maximum or the minimum */
+  PetscReal bins[PETSC_BINNED_FOLD];
+  PetscReal carries[PETSC_BINNED_FOLD];   /* multiples of the unit of the bin above moved out of each bin */
+} PetscBinnedSum;
+
 typedef struct {
   MPI_Comm    comm;
   MPI_Request request;
@@ -848,6 +861,9 @@ typedef struct {
   PetscInt    maxops;       /* total amount of space we have for requests */
   PetscInt    numopsbegin;  /* number of requests that have been queued in */
   PetscInt    numopsend;    /* number of requests that have been gotten by user */
+  PetscBool      binned;    /* are the queued reductions reproducible? */
+  PetscBinnedSum *lbinned;  /* binned sums of the reproducible reductions before and after the communication */
+  PetscBinnedSum *gbinned;
 } PetscSplitReduction;
 
 PETSC_EXTERN PetscErrorCode PetscSplitReductionGet(MPI_Comm,PetscSplitReduction**);
@@ -926,6 +942,7 @@ PETSC_INTERN PetscSpinlock PetscViewerASCIISpinLockOpen;
 PETSC_INTERN PetscSpinlock PetscViewerASCIISpinLockStdout;
 PETSC_INTERN PetscSpinlock PetscViewerASCIISpinLockStderr;
 PETSC_INTERN PetscSpinlock PetscCommSpinLock;
+PETSC_INTERN PetscSpinlock PetscMallocSpinLock;
 #endif
 #endif
 
@@ -35,10 +35,15 @@ struct _PetscSFOps {
   PetscErrorCode (*Duplicate)(PetscSF,PetscSFDuplicateOption,PetscSF);
   PetscErrorCode (*BcastAndOpBegin)(PetscSF,MPI_Datatype,PetscMemType,const void*,PetscMemType,      void*,      MPI_Op);
   PetscErrorCode (*BcastAndOpEnd)  (PetscSF,MPI_Datatype,PetscMemType,const void*,PetscMemType,      void*,      MPI_Op);
+  PetscErrorCode (*BcastAndOpEndAny)(PetscSF,MPI_Datatype,PetscMemType,const void*,PetscMemType,     void*,      MPI_Op,PetscMPIInt*); /* Optional */
   PetscErrorCode (*ReduceBegin)    (PetscSF,MPI_Datatype,PetscMemType,const void*,PetscMemType,      void*,      MPI_Op);
   PetscErrorCode (*ReduceEnd)      (PetscSF,MPI_Datatype,PetscMemType,const void*,PetscMemType,      void*,      MPI_Op);
   PetscErrorCode (*FetchAndOpBegin)(PetscSF,MPI_Datatype,PetscMemType,      void*,PetscMemType,const void*,void*,MPI_Op);
   PetscErrorCode (*FetchAndOpEnd)  (PetscSF,MPI_Datatype,PetscMemType,      void*,PetscMemType,const void*,void*,MPI_Op);
+  PetscErrorCode (*BcastAndOpMultipleBegin)(PetscSF,MPI_Datatype,PetscInt,const void*const*,void*const*,MPI_Op); /* Host memory only */
+  PetscErrorCode (*BcastAndOpMultipleEnd)  (PetscSF,MPI_Datatype,PetscInt,const void*const*,void*const*,MPI_Op);
+  PetscErrorCode (*ReduceMultipleBegin)    (PetscSF,MPI_Datatype,PetscInt,const void*const*,void*const*,MPI_Op);
+  PetscErrorCode (*ReduceMultipleEnd)      (PetscSF,MPI_Datatype,PetscInt,const void*const*,void*const*,MPI_Op);
   PetscErrorCode (*BcastToZero)    (PetscSF,MPI_Datatype,PetscMemType,const void*,PetscMemType,      void*); /* For interal use only */
   PetscErrorCode (*GetRootRanks)(PetscSF,PetscInt*,const PetscMPIInt**,const PetscInt**,const PetscInt**,const PetscInt**);
   PetscErrorCode (*GetLeafRanks)(PetscSF,PetscInt*,const PetscMPIInt**,const PetscInt**,const PetscInt**);
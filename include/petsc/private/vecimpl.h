@@ -178,6 +178,7 @@ PETSC_EXTERN PetscLogEvent VEC_Swap;
 PETSC_EXTERN PetscLogEvent VEC_AssemblyBegin;
 PETSC_EXTERN PetscLogEvent VEC_DotNorm2;
 PETSC_EXTERN PetscLogEvent VEC_AXPBYPCZ;
+PETSC_EXTERN PetscLogEvent VEC_Fuse;
 PETSC_EXTERN PetscLogEvent VEC_Ops;
 PETSC_EXTERN PetscLogEvent VEC_ViennaCLCopyToGPU;
 PETSC_EXTERN PetscLogEvent VEC_ViennaCLCopyFromGPU;
@@ -282,6 +283,37 @@ PETSC_INTERN PetscErrorCode VecReciprocal_Default(Vec);
 PETSC_INTERN PetscErrorCode VecStrideSubSetGather_Default(Vec,PetscInt,const PetscInt[],const PetscInt[],Vec,InsertMode);
 PETSC_INTERN PetscErrorCode VecStrideSubSetScatter_Default(Vec,PetscInt,const PetscInt[],const PetscInt[],Vec,InsertMode);
 
+/* Reproducible reductions, a PetscScalar is reduced as PETSC_BINNED_CMUL binned sums */
+#define PETSC_BINNED_CMUL ((PetscInt)(sizeof(PetscScalar)/sizeof(PetscReal)))
+PETSC_INTERN PetscBool    VecReproducibleReductions;
+PETSC_INTERN MPI_Datatype MPIU_BINNEDSUM;
+PETSC_INTERN MPI_Op       MPIU_BINNEDSUM_OP;
+PETSC_INTERN void MPIAPI  PetscBinnedSum_Local(void*,void*,PetscMPIInt*,MPI_Datatype*);
+PETSC_INTERN PetscScalar  PetscBinnedSumGetScalar(const PetscBinnedSum[]);
+PETSC_INTERN PetscErrorCode VecDotBinnedLocal_Private(Vec,Vec,PetscBool,PetscBinnedSum[]);
+PETSC_INTERN PetscErrorCode VecMDotBinnedLocal_Private(Vec,PetscInt,const Vec[],PetscBool,PetscBinnedSum[]);
+PETSC_INTERN PetscErrorCode VecNormBinnedLocal_Private(Vec,NormType,PetscBinnedSum[]);
+PETSC_INTERN PetscErrorCode VecDotBinned_Private(Vec,Vec,PetscBool,PetscScalar*);
+PETSC_INTERN PetscErrorCode VecMDotBinned_Private(Vec,PetscInt,const Vec[],PetscBool,PetscScalar[]);
+PETSC_INTERN PetscErrorCode VecNormBinned_Private(Vec,NormType,PetscReal*);
+PETSC_INTERN PetscErrorCode VecDotNorm2Binned_Private(Vec,Vec,PetscScalar*,PetscReal*);
+
+/* reuse of the arrays of destroyed vectors, see VecSetPoolArrays() */
+PETSC_INTERN PetscBool      VecPoolArrays;
+PETSC_INTERN PetscErrorCode VecPoolGetArray_Private(PetscLayout,PetscInt,PetscScalar**);
+PETSC_INTERN PetscErrorCode VecPoolRestoreArray_Private(PetscLayout,PetscInt,PetscScalar**);
+PETSC_INTERN PetscErrorCode VecPoolView_Private(FILE*);
+
+/* are the reductions of x with the nv vectors y[] computed with binned sums? */
+PETSC_STATIC_INLINE PetscBool VecUseBinned_Private(Vec x,PetscInt nv,const Vec y[])
+{
+  PetscInt i;
+
+  if (!VecReproducibleReductions || !x->petscnative) return PETSC_FALSE;
+  for (i=0; i<nv; i++) if (!y[i]->petscnative) return PETSC_FALSE;
+  return PETSC_TRUE;
+}
+
 #if defined(PETSC_HAVE_MATLAB_ENGINE)
 PETSC_EXTERN PetscErrorCode VecMatlabEnginePut_Default(PetscObject,void*);
 PETSC_EXTERN PetscErrorCode VecMatlabEngineGet_Default(PetscObject,void*);
@@ -293,6 +293,9 @@ typedef struct _VecScatterOps *VecScatterOps;
 struct _VecScatterOps {
   PetscErrorCode (*begin)(VecScatter,Vec,Vec,InsertMode,ScatterMode);
   PetscErrorCode (*end)(VecScatter,Vec,Vec,InsertMode,ScatterMode);
+  PetscErrorCode (*endany)(VecScatter,Vec,Vec,InsertMode,ScatterMode,PetscMPIInt*);
+  PetscErrorCode (*beginmultiple)(VecScatter,PetscInt,Vec*,Vec*,InsertMode,ScatterMode);
+  PetscErrorCode (*endmultiple)(VecScatter,PetscInt,Vec*,Vec*,InsertMode,ScatterMode);
   PetscErrorCode (*copy)(VecScatter,VecScatter);
   PetscErrorCode (*destroy)(VecScatter);
   PetscErrorCode (*setup)(VecScatter);
@@ -252,6 +252,8 @@ struct _n_PetscLayout{
   PetscBool              setupcalled; /* Forbid setup more than once */
   PetscInt               oldn,oldN;   /* Checking if setup is allowed */
   PetscInt               oldbs;       /* And again */
+  void                   *pool;       /* arrays of destroyed vectors with this layout kept for reuse, see VecSetPoolArrays() */
+  PetscErrorCode         (*pooldestroy)(void**);
 };
 
 /*@C
@@ -25,6 +25,7 @@ typedef const char *PetscSFType;
 #define PETSCSFGATHER     "gather"
 #define PETSCSFALLTOALL   "alltoall"
 #define PETSCSFWINDOW     "window"
+#define PETSCSFNODE       "node"
 
 /*E
    PetscSFPattern - Pattern of the PetscSF graph
@@ -86,6 +87,7 @@ PETSC_EXTERN PetscErrorCode PetscSFSetFromOptions(PetscSF);
 PETSC_EXTERN PetscErrorCode PetscSFDuplicate(PetscSF,PetscSFDuplicateOption,PetscSF*);
 PETSC_EXTERN PetscErrorCode PetscSFWindowSetSyncType(PetscSF,PetscSFWindowSyncType);
 PETSC_EXTERN PetscErrorCode PetscSFWindowGetSyncType(PetscSF,PetscSFWindowSyncType*);
+PETSC_EXTERN PetscErrorCode PetscSFNodeSetNodeSize(PetscSF,PetscInt);
 PETSC_EXTERN PetscErrorCode PetscSFSetRankOrder(PetscSF,PetscBool);
 PETSC_EXTERN PetscErrorCode PetscSFSetGraph(PetscSF,PetscInt,PetscInt,const PetscInt*,PetscCopyMode,const PetscSFNode*,PetscCopyMode);
 PETSC_EXTERN PetscErrorCode PetscSFSetGraphWithPattern(PetscSF,PetscLayout,PetscSFPattern);
@@ -106,11 +108,18 @@ PETSC_EXTERN PetscErrorCode PetscSFBcastAndOpBegin(PetscSF,MPI_Datatype,const vo
   PetscAttrMPIPointerWithType(3,2) PetscAttrMPIPointerWithType(4,2);
 PETSC_EXTERN PetscErrorCode PetscSFBcastAndOpEnd(PetscSF,MPI_Datatype,const void*,void*,MPI_Op)
   PetscAttrMPIPointerWithType(3,2) PetscAttrMPIPointerWithType(4,2);
+PETSC_EXTERN PetscErrorCode PetscSFBcastAndOpEndAny(PetscSF,MPI_Datatype,const void*,void*,MPI_Op,PetscMPIInt*)
+  PetscAttrMPIPointerWithType(3,2) PetscAttrMPIPointerWithType(4,2);
 /* Reduce leafdata into rootdata using provided operation */
 PETSC_EXTERN PetscErrorCode PetscSFReduceBegin(PetscSF,MPI_Datatype,const void*,void *,MPI_Op)
   PetscAttrMPIPointerWithType(3,2) PetscAttrMPIPointerWithType(4,2);
 PETSC_EXTERN PetscErrorCode PetscSFReduceEnd(PetscSF,MPI_Datatype,const void*,void*,MPI_Op)
   PetscAttrMPIPointerWithType(3,2) PetscAttrMPIPointerWithType(4,2);
+/* The same operations on k arrays at once, with one message per process for all of them */
+PETSC_EXTERN PetscErrorCode PetscSFBcastAndOpMultipleBegin(PetscSF,MPI_Datatype,PetscInt,const void*const*,void*const*,MPI_Op);
+PETSC_EXTERN PetscErrorCode PetscSFBcastAndOpMultipleEnd(PetscSF,MPI_Datatype,PetscInt,const void*const*,void*const*,MPI_Op);
+PETSC_EXTERN PetscErrorCode PetscSFReduceMultipleBegin(PetscSF,MPI_Datatype,PetscInt,const void*const*,void*const*,MPI_Op);
+PETSC_EXTERN PetscErrorCode PetscSFReduceMultipleEnd(PetscSF,MPI_Datatype,PetscInt,const void*const*,void*const*,MPI_Op);
 /* Atomically modifies (using provided operation) rootdata using leafdata from each leaf, value at root at time of modification is returned in leafupdate. */
 PETSC_EXTERN PetscErrorCode PetscSFFetchAndOpBegin(PetscSF,MPI_Datatype,void*,const void*,void*,MPI_Op)
   PetscAttrMPIPointerWithType(3,2) PetscAttrMPIPointerWithType(4,2) PetscAttrMPIPointerWithType(5,2);
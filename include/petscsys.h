@@ -1140,6 +1140,37 @@ PETSC_EXTERN PetscErrorCode PetscMallocClear(void);
 PETSC_EXTERN PetscErrorCode PetscMallocSetDRAM(void);
 PETSC_EXTERN PetscErrorCode PetscMallocResetDRAM(void);
 
+/*E
+    PetscMallocPageType - The pages used for large allocations
+
+$   PETSC_MALLOC_PAGES_DEFAULT - the pages given by the system
+$   PETSC_MALLOC_PAGES_TRANSPARENT - transparent huge pages, asked for with madvise()
+$   PETSC_MALLOC_PAGES_HUGE - explicit 2MB huge pages, which must have been reserved
+
+    Level: advanced
+
+.seealso: PetscMallocSetPolicy(), PetscMallocNumaType
+E*/
+typedef enum {PETSC_MALLOC_PAGES_DEFAULT,PETSC_MALLOC_PAGES_TRANSPARENT,PETSC_MALLOC_PAGES_HUGE} PetscMallocPageType;
+PETSC_EXTERN const char *const PetscMallocPageTypes[];
+
+/*E
+    PetscMallocNumaType - The placement of large allocations on the NUMA nodes
+
+$   PETSC_MALLOC_NUMA_DEFAULT - the placement given by the system, usually on the node that first touches each page
+$   PETSC_MALLOC_NUMA_LOCAL - on the node of the thread that allocates the memory
+$   PETSC_MALLOC_NUMA_INTERLEAVE - the pages are interleaved over the nodes
+
+    Level: advanced
+
+.seealso: PetscMallocSetPolicy(), PetscMallocPageType
+E*/
+typedef enum {PETSC_MALLOC_NUMA_DEFAULT,PETSC_MALLOC_NUMA_LOCAL,PETSC_MALLOC_NUMA_INTERLEAVE} PetscMallocNumaType;
+PETSC_EXTERN const char *const PetscMallocNumaTypes[];
+
+PETSC_EXTERN PetscErrorCode PetscMallocSetPolicy(PetscMallocPageType,PetscMallocNumaType,PetscLogDouble);
+PETSC_EXTERN PetscErrorCode PetscMallocGetPolicy(PetscMallocPageType*,PetscMallocNumaType*,PetscLogDouble*);
+
 #define MPIU_PETSCLOGDOUBLE  MPI_DOUBLE
 #define MPIU_2PETSCLOGDOUBLE MPI_2DOUBLE_PRECISION
 
@@ -1157,6 +1188,7 @@ PETSC_EXTERN PetscErrorCode PetscMallocGetDebug(PetscBool*,PetscBool*,PetscBool*
 PETSC_EXTERN PetscErrorCode PetscMallocValidate(int,const char[],const char[]);
 PETSC_EXTERN PetscErrorCode PetscMallocViewSet(PetscLogDouble);
 PETSC_EXTERN PetscErrorCode PetscMallocViewGet(PetscBool*);
+PETSC_EXTERN PetscErrorCode PetscMallocViewRegister(PetscErrorCode (*)(FILE*));
 
 PETSC_EXTERN const char *const PetscDataTypes[];
 PETSC_EXTERN PetscErrorCode PetscDataTypeToMPIDataType(PetscDataType,MPI_Datatype*);
@@ -340,6 +340,9 @@ PETSC_EXTERN PetscErrorCode VecRegister(const char[],PetscErrorCode (*)(Vec));
 
 PETSC_EXTERN PetscErrorCode VecScatterBegin(VecScatter,Vec,Vec,InsertMode,ScatterMode);
 PETSC_EXTERN PetscErrorCode VecScatterEnd(VecScatter,Vec,Vec,InsertMode,ScatterMode);
+PETSC_EXTERN PetscErrorCode VecScatterEndAny(VecScatter,Vec,Vec,InsertMode,ScatterMode,PetscMPIInt*);
+PETSC_EXTERN PetscErrorCode VecScatterBeginMultiple(VecScatter,PetscInt,Vec[],Vec[],InsertMode,ScatterMode);
+PETSC_EXTERN PetscErrorCode VecScatterEndMultiple(VecScatter,PetscInt,Vec[],Vec[],InsertMode,ScatterMode);
 PETSC_EXTERN PetscErrorCode VecScatterDestroy(VecScatter*);
 PETSC_EXTERN PetscErrorCode VecScatterSetUp(VecScatter);
 PETSC_EXTERN PetscErrorCode VecScatterCopy(VecScatter,VecScatter *);
@@ -453,6 +456,32 @@ PETSC_EXTERN PetscErrorCode VecMDotEnd(Vec,PetscInt,const Vec[],PetscScalar[]);
 PETSC_EXTERN PetscErrorCode VecMTDotBegin(Vec,PetscInt,const Vec[],PetscScalar[]);
 PETSC_EXTERN PetscErrorCode VecMTDotEnd(Vec,PetscInt,const Vec[],PetscScalar[]);
 PETSC_EXTERN PetscErrorCode PetscCommSplitReductionBegin(MPI_Comm);
+PETSC_EXTERN PetscErrorCode VecSetReproducibleReductions(PetscBool);
+PETSC_EXTERN PetscErrorCode VecGetReproducibleReductions(PetscBool*);
+PETSC_EXTERN PetscErrorCode VecSetPoolArrays(PetscBool);
+PETSC_EXTERN PetscErrorCode VecGetPoolArrays(PetscBool*);
+
+/*S
+     VecFuse - Records a short sequence of vector operations that are then computed in a single pass over the vectors
+
+   Level: advanced
+
+.seealso:  VecFuseCreate(), VecFuseExecute()
+S*/
+typedef struct _n_VecFuse* VecFuse;
+PETSC_EXTERN PetscErrorCode VecFuseCreate(MPI_Comm,VecFuse*);
+PETSC_EXTERN PetscErrorCode VecFuseDestroy(VecFuse*);
+PETSC_EXTERN PetscErrorCode VecFuseAXPY(VecFuse,Vec,PetscScalar,Vec);
+PETSC_EXTERN PetscErrorCode VecFuseAYPX(VecFuse,Vec,PetscScalar,Vec);
+PETSC_EXTERN PetscErrorCode VecFuseWAXPY(VecFuse,Vec,PetscScalar,Vec,Vec);
+PETSC_EXTERN PetscErrorCode VecFusePointwiseMult(VecFuse,Vec,Vec,Vec);
+PETSC_EXTERN PetscErrorCode VecFuseAXPBYPCZ(VecFuse,Vec,PetscScalar,PetscScalar,PetscScalar,Vec,Vec);
+PETSC_EXTERN PetscErrorCode VecFuseDot(VecFuse,Vec,Vec,PetscScalar*);
+PETSC_EXTERN PetscErrorCode VecFuseTDot(VecFuse,Vec,Vec,PetscScalar*);
+PETSC_EXTERN PetscErrorCode VecFuseNorm(VecFuse,Vec,PetscReal*);
+PETSC_EXTERN PetscErrorCode VecFuseExecute(VecFuse);
+PETSC_EXTERN PetscErrorCode VecFuseExecuteBegin(VecFuse);
+PETSC_EXTERN PetscErrorCode VecFuseExecuteEnd(VecFuse);
 
 PETSC_EXTERN PetscErrorCode VecPinToCPU(Vec,PetscBool);
 
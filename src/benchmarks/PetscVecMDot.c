@@ -0,0 +1,52 @@
+#include <petscvec.h>
+#include <petsctime.h>
+
+/*
+   Times VecMDot() and VecMAXPY() as used by GMRES with a long restart; compare for example
+
+     ./PetscVecMDot -vec_multi_block_size 0
+     ./PetscVecMDot
+     ./PetscVecMDot -omp_num_threads 4 -vec_multi_use_threads
+*/
+int main(int argc,char **argv)
+{
+  Vec            x,*y;
+  PetscScalar    *z;
+  PetscLogDouble t1 = 0.0,t2 = 0.0,t3 = 0.0;
+  PetscErrorCode ierr;
+  PetscInt       i,n = 100000,nv = 100,its = 10;
+  PetscRandom    rand;
+
+  ierr = PetscInitialize(&argc,&argv,0,0);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nv",&nv,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-its",&its,NULL);CHKERRQ(ierr);
+
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&rand);CHKERRQ(ierr);
+  ierr = VecCreate(PETSC_COMM_SELF,&x);CHKERRQ(ierr);
+  ierr = VecSetSizes(x,n,n);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(x);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rand);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(x,nv,&y);CHKERRQ(ierr);
+  for (i=0; i<nv; i++) {ierr = VecSetRandom(y[i],rand);CHKERRQ(ierr);}
+  ierr = PetscMalloc1(nv,&z);CHKERRQ(ierr);
+
+  PetscPreLoadBegin(PETSC_TRUE,"VecMDot");
+  ierr = PetscTime(&t1);CHKERRQ(ierr);
+  for (i=0; i<its; i++) {ierr = VecMDot(x,nv,y,z);CHKERRQ(ierr);}
+  ierr = PetscTime(&t2);CHKERRQ(ierr);
+  for (i=0; i<nv; i++) z[i] = 1.e-3/nv;
+  for (i=0; i<its; i++) {ierr = VecMAXPY(x,nv,z,y);CHKERRQ(ierr);}
+  ierr = PetscTime(&t3);CHKERRQ(ierr);
+  PetscPreLoadEnd();
+  fprintf(stdout,"VecMDot/VecMAXPY n %d nv %d : \n",(int)n,(int)nv);
+  fprintf(stdout," VecMDot  Time %g\n",(t2-t1)/its);
+  fprintf(stdout," VecMAXPY Time %g\n",(t3-t2)/its);
+
+  ierr = PetscFree(z);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(nv,&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
@@ -0,0 +1,58 @@
+#include <petscvec.h>
+#include <petsctime.h>
+
+/*
+   Times VecDot(), VecNorm(,NORM_1_AND_2,) and VecMDot() with the usual sums and with the reproducible ones; compare for example
+
+     ./PetscVecReproducible
+     ./PetscVecReproducible -n 10000
+*/
+int main(int argc,char **argv)
+{
+  Vec            x,*y;
+  PetscScalar    dot,*z;
+  PetscReal      nrm[2];
+  PetscLogDouble t[4],tt[2][3];
+  PetscErrorCode ierr;
+  PetscInt       i,k,n = 1000000,nv = 8,its = 10;
+  PetscRandom    rand;
+
+  ierr = PetscInitialize(&argc,&argv,0,0);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nv",&nv,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-its",&its,NULL);CHKERRQ(ierr);
+
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&rand);CHKERRQ(ierr);
+  ierr = VecCreate(PETSC_COMM_SELF,&x);CHKERRQ(ierr);
+  ierr = VecSetSizes(x,n,n);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(x);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rand);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(x,nv,&y);CHKERRQ(ierr);
+  for (i=0; i<nv; i++) {ierr = VecSetRandom(y[i],rand);CHKERRQ(ierr);}
+  ierr = PetscMalloc1(nv,&z);CHKERRQ(ierr);
+
+  for (k=0; k<2; k++) {
+    ierr = VecSetReproducibleReductions((PetscBool)k);CHKERRQ(ierr);
+    PetscPreLoadBegin(PETSC_TRUE,k ? "Reproducible" : "Usual");
+    ierr = PetscTime(&t[0]);CHKERRQ(ierr);
+    for (i=0; i<its; i++) {ierr = VecDot(x,y[0],&dot);CHKERRQ(ierr);}
+    ierr = PetscTime(&t[1]);CHKERRQ(ierr);
+    for (i=0; i<its; i++) {ierr = VecNorm(x,NORM_1_AND_2,nrm);CHKERRQ(ierr);} /* these norms are not cached */
+    ierr = PetscTime(&t[2]);CHKERRQ(ierr);
+    for (i=0; i<its; i++) {ierr = VecMDot(x,nv,y,z);CHKERRQ(ierr);}
+    ierr = PetscTime(&t[3]);CHKERRQ(ierr);
+    PetscPreLoadEnd();
+    for (i=0; i<3; i++) tt[k][i] = (t[i+1]-t[i])/its;
+  }
+  fprintf(stdout,"Usual and reproducible reductions n %d nv %d : \n",(int)n,(int)nv);
+  fprintf(stdout," VecDot  Time %g %g ratio %g\n",tt[0][0],tt[1][0],tt[1][0]/tt[0][0]);
+  fprintf(stdout," VecNorm Time %g %g ratio %g\n",tt[0][1],tt[1][1],tt[1][1]/tt[0][1]);
+  fprintf(stdout," VecMDot Time %g %g ratio %g\n",tt[0][2],tt[1][2],tt[1][2]/tt[0][2]);
+
+  ierr = PetscFree(z);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(nv,&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
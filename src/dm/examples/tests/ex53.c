@@ -0,0 +1,130 @@
+static char help[] = "Tests DMGlobalToLocalBeginMultiple/EndMultiple() and VecScatterBeginMultiple/EndMultiple() against the single vector routines.\n\n";
+
+#include <petscdmda.h>
+#include <petscdmplex.h>
+
+/* The local vectors are sequential so VecEqual() only compares the entries of this process */
+static PetscErrorCode CheckLocalVecs(Vec x,Vec y,const char *name,PetscInt i)
+{
+  PetscErrorCode ierr;
+  PetscBool      flg;
+  PetscMPIInt    eq,alleq;
+
+  PetscFunctionBegin;
+  ierr = VecEqual(x,y,&flg);CHKERRQ(ierr);
+  eq   = (PetscMPIInt)flg;
+  ierr = MPIU_Allreduce(&eq,&alleq,1,MPI_INT,MPI_LAND,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%s vector %D equal %s\n",name,i,PetscBools[alleq ? PETSC_TRUE : PETSC_FALSE]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  DM             dm;
+  Vec            g[5],l[5],g0[5],gref,lref;
+  VecScatter     gtol;
+  PetscInt       i,k = 5;
+  PetscBool      plex = PETSC_FALSE;
+  PetscBool      flg;
+  PetscRandom    rand;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-k",&k,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-plex",&plex,NULL);CHKERRQ(ierr);
+  if (k < 1 || k > 5) SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_ARG_OUTOFRANGE,"-k must be between 1 and 5");
+  if (plex) {
+    PetscSection s;
+    DM           pdm;
+    PetscInt     p,pStart,pEnd,vStart,vEnd;
+
+    /* One unknown per vertex, communicated with the section PetscSF */
+    ierr = DMPlexCreateBoxMesh(PETSC_COMM_WORLD,2,PETSC_FALSE,NULL,NULL,NULL,NULL,PETSC_TRUE,&dm);CHKERRQ(ierr);
+    ierr = DMPlexDistribute(dm,1,NULL,&pdm);CHKERRQ(ierr);
+    if (pdm) {
+      ierr = DMDestroy(&dm);CHKERRQ(ierr);
+      dm   = pdm;
+    }
+    ierr = DMPlexGetChart(dm,&pStart,&pEnd);CHKERRQ(ierr);
+    ierr = DMPlexGetDepthStratum(dm,0,&vStart,&vEnd);CHKERRQ(ierr);
+    ierr = PetscSectionCreate(PETSC_COMM_WORLD,&s);CHKERRQ(ierr);
+    ierr = PetscSectionSetChart(s,pStart,pEnd);CHKERRQ(ierr);
+    for (p=vStart; p<vEnd; p++) {ierr = PetscSectionSetDof(s,p,1);CHKERRQ(ierr);}
+    ierr = PetscSectionSetUp(s);CHKERRQ(ierr);
+    ierr = DMSetLocalSection(dm,s);CHKERRQ(ierr);
+    ierr = PetscSectionDestroy(&s);CHKERRQ(ierr);
+  } else {
+    ierr = DMDACreate2d(PETSC_COMM_WORLD,DM_BOUNDARY_PERIODIC,DM_BOUNDARY_NONE,DMDA_STENCIL_BOX,8,7,PETSC_DECIDE,PETSC_DECIDE,2,1,NULL,NULL,&dm);CHKERRQ(ierr);
+  }
+  ierr = DMSetFromOptions(dm);CHKERRQ(ierr);
+  ierr = DMSetUp(dm);CHKERRQ(ierr);
+
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = DMCreateGlobalVector(dm,&gref);CHKERRQ(ierr);
+  ierr = DMCreateLocalVector(dm,&lref);CHKERRQ(ierr);
+  for (i=0; i<k; i++) {
+    ierr = VecDuplicate(gref,&g[i]);CHKERRQ(ierr);
+    ierr = VecDuplicate(lref,&l[i]);CHKERRQ(ierr);
+    ierr = VecSetRandom(g[i],rand);CHKERRQ(ierr);
+    ierr = VecSet(l[i],-1.0);CHKERRQ(ierr);
+  }
+
+  ierr = DMGlobalToLocalBeginMultiple(dm,k,g,INSERT_VALUES,l);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEndMultiple(dm,k,g,INSERT_VALUES,l);CHKERRQ(ierr);
+  for (i=0; i<k; i++) {
+    ierr = VecSet(lref,-1.0);CHKERRQ(ierr);
+    ierr = DMGlobalToLocal(dm,g[i],INSERT_VALUES,lref);CHKERRQ(ierr);
+    ierr = CheckLocalVecs(l[i],lref,"DMGlobalToLocalBeginMultiple()",i);CHKERRQ(ierr);
+  }
+
+  if (!plex) {
+    /* Reverse scatter adding the local vectors into the global ones */
+    ierr = DMDAGetScatter(dm,&gtol,NULL);CHKERRQ(ierr);
+    for (i=0; i<k; i++) {
+      ierr = VecSetRandom(l[i],rand);CHKERRQ(ierr);
+      ierr = VecDuplicate(g[i],&g0[i]);CHKERRQ(ierr);
+      ierr = VecCopy(g[i],g0[i]);CHKERRQ(ierr);
+    }
+    ierr = VecScatterBeginMultiple(gtol,k,l,g,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+    ierr = VecScatterEndMultiple(gtol,k,l,g,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+    for (i=0; i<k; i++) {
+      ierr = VecScatterBegin(gtol,l[i],g0[i],ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+      ierr = VecScatterEnd(gtol,l[i],g0[i],ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+      ierr = VecEqual(g[i],g0[i],&flg);CHKERRQ(ierr);
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"VecScatterBeginMultiple() vector %D equal %s\n",i,PetscBools[flg]);CHKERRQ(ierr);
+      ierr = VecDestroy(&g0[i]);CHKERRQ(ierr);
+    }
+  }
+
+  for (i=0; i<k; i++) {
+    ierr = VecDestroy(&g[i]);CHKERRQ(ierr);
+    ierr = VecDestroy(&l[i]);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&gref);CHKERRQ(ierr);
+  ierr = VecDestroy(&lref);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = DMDestroy(&dm);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      nsize: {{1 4}}
+      args: -k 1
+      output_file: output/ex53_1.out
+
+   test:
+      suffix: 5
+      nsize: {{1 4}}
+      output_file: output/ex53_5.out
+
+   test:
+      suffix: plex
+      nsize: 3
+      args: -plex
+
+TEST*/
@@ -113,6 +113,8 @@ extern PetscErrorCode  DMCreateGlobalVector_DA(DM,Vec*);
 extern PetscErrorCode  DMCreateLocalVector_DA(DM,Vec*);
 extern PetscErrorCode  DMGlobalToLocalBegin_DA(DM,Vec,InsertMode,Vec);
 extern PetscErrorCode  DMGlobalToLocalEnd_DA(DM,Vec,InsertMode,Vec);
+extern PetscErrorCode  DMGlobalToLocalBeginMultiple_DA(DM,PetscInt,Vec*,InsertMode,Vec*);
+extern PetscErrorCode  DMGlobalToLocalEndMultiple_DA(DM,PetscInt,Vec*,InsertMode,Vec*);
 extern PetscErrorCode  DMLocalToGlobalBegin_DA(DM,Vec,InsertMode,Vec);
 extern PetscErrorCode  DMLocalToGlobalEnd_DA(DM,Vec,InsertMode,Vec);
 extern PetscErrorCode  DMLocalToLocalBegin_DA(DM,Vec,InsertMode,Vec);
@@ -418,6 +420,8 @@ PETSC_EXTERN PetscErrorCode DMCreate_DA(DM da)
 
   da->ops->globaltolocalbegin          = DMGlobalToLocalBegin_DA;
   da->ops->globaltolocalend            = DMGlobalToLocalEnd_DA;
+  da->ops->globaltolocalbeginmultiple  = DMGlobalToLocalBeginMultiple_DA;
+  da->ops->globaltolocalendmultiple    = DMGlobalToLocalEndMultiple_DA;
   da->ops->localtoglobalbegin          = DMLocalToGlobalBegin_DA;
   da->ops->localtoglobalend            = DMLocalToGlobalEnd_DA;
   da->ops->localtolocalbegin           = DMLocalToLocalBegin_DA;
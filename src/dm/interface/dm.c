@@ -2405,6 +2405,139 @@ PetscErrorCode  DMGlobalToLocalEnd(DM dm,Vec g,InsertMode mode,Vec l)
   PetscFunctionReturn(0);
 }
 
+/*@
+    DMGlobalToLocalBeginMultiple - Begins updating several local vectors from global vectors of the same DM
+
+    Neighbor-wise Collective on dm
+
+    Input Parameters:
++   dm - the DM object
+.   k - the number of vectors
+.   g - the k global vectors
+.   mode - INSERT_VALUES or ADD_VALUES
+-   l - the k local vectors, l[i] being updated from g[i]
+
+    Notes:
+    This does the same as calling DMGlobalToLocalBegin() and DMGlobalToLocalEnd() for each pair of vectors, but when
+    the DM communicates with a PetscSF (for example DMPLEX) or a VecScatter that supports it (for example DMDA) the ghost
+    values of all k vectors going to the same process are sent in a single message.
+
+    Level: intermediate
+
+.seealso DMGlobalToLocalEndMultiple(), DMGlobalToLocalBegin(), VecScatterBeginMultiple(), PetscSFBcastAndOpMultipleBegin()
+
+@*/
+PetscErrorCode DMGlobalToLocalBeginMultiple(DM dm,PetscInt k,Vec g[],InsertMode mode,Vec l[])
+{
+  PetscSF                 sf;
+  PetscErrorCode          ierr;
+  PetscInt                i;
+  DMGlobalToLocalHookLink link;
+  InsertMode              imode = mode == INSERT_ALL_VALUES ? INSERT_VALUES : (mode == ADD_ALL_VALUES ? ADD_VALUES : mode);
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
+  if (k < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of vectors %D cannot be negative",k);
+  if (!k) PetscFunctionReturn(0);
+  PetscValidPointer(g,3);
+  PetscValidPointer(l,5);
+  for (link=dm->gtolhook; link; link=link->next) {
+    if (link->beginhook) {
+      for (i=0; i<k; i++) {ierr = (*link->beginhook)(dm,g[i],mode,l[i],link->ctx);CHKERRQ(ierr);}
+    }
+  }
+  ierr = DMGetSectionSF(dm, &sf);CHKERRQ(ierr);
+  if (sf) {
+    const PetscScalar **gArrays;
+    PetscScalar       **lArrays;
+
+    if (mode == ADD_VALUES) SETERRQ1(PetscObjectComm((PetscObject)dm), PETSC_ERR_ARG_OUTOFRANGE, "Invalid insertion mode %D", mode);
+    ierr = PetscMalloc2(k,&gArrays,k,&lArrays);CHKERRQ(ierr);
+    for (i=0; i<k; i++) {
+      ierr = VecGetArray(l[i], &lArrays[i]);CHKERRQ(ierr);
+      ierr = VecGetArrayRead(g[i], &gArrays[i]);CHKERRQ(ierr);
+    }
+    ierr = PetscSFBcastAndOpMultipleBegin(sf, MPIU_SCALAR, k, (const void*const*)gArrays, (void*const*)lArrays, MPIU_REPLACE);CHKERRQ(ierr);
+    for (i=0; i<k; i++) {
+      ierr = VecRestoreArray(l[i], &lArrays[i]);CHKERRQ(ierr);
+      ierr = VecRestoreArrayRead(g[i], &gArrays[i]);CHKERRQ(ierr);
+    }
+    ierr = PetscFree2(gArrays,lArrays);CHKERRQ(ierr);
+  } else if (dm->ops->globaltolocalbeginmultiple) {
+    ierr = (*dm->ops->globaltolocalbeginmultiple)(dm,k,g,imode,l);CHKERRQ(ierr);
+  } else {
+    /* No batched communication for this type, so do the updates one after the other */
+    if (!dm->ops->globaltolocalbegin || !dm->ops->globaltolocalend) SETERRQ1(PetscObjectComm((PetscObject)dm), PETSC_ERR_SUP, "Missing DMGlobalToLocalBegin() for type %s",((PetscObject)dm)->type_name);
+    for (i=0; i<k; i++) {
+      ierr = (*dm->ops->globaltolocalbegin)(dm,g[i],imode,l[i]);CHKERRQ(ierr);
+      ierr = (*dm->ops->globaltolocalend)(dm,g[i],imode,l[i]);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+    DMGlobalToLocalEndMultiple - Ends updating several local vectors from global vectors, started with DMGlobalToLocalBeginMultiple()
+
+    Neighbor-wise Collective on dm
+
+    Input Parameters:
++   dm - the DM object
+.   k - the number of vectors
+.   g - the k global vectors
+.   mode - INSERT_VALUES or ADD_VALUES
+-   l - the k local vectors
+
+    Level: intermediate
+
+.seealso DMGlobalToLocalBeginMultiple(), DMGlobalToLocalEnd()
+
+@*/
+PetscErrorCode DMGlobalToLocalEndMultiple(DM dm,PetscInt k,Vec g[],InsertMode mode,Vec l[])
+{
+  PetscSF                 sf;
+  PetscErrorCode          ierr;
+  PetscInt                i;
+  PetscBool               transform;
+  DMGlobalToLocalHookLink link;
+  InsertMode              imode = mode == INSERT_ALL_VALUES ? INSERT_VALUES : (mode == ADD_ALL_VALUES ? ADD_VALUES : mode);
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
+  if (k <= 0) PetscFunctionReturn(0);
+  PetscValidPointer(g,3);
+  PetscValidPointer(l,5);
+  ierr = DMGetSectionSF(dm, &sf);CHKERRQ(ierr);
+  ierr = DMHasBasisTransform(dm, &transform);CHKERRQ(ierr);
+  if (sf) {
+    const PetscScalar **gArrays;
+    PetscScalar       **lArrays;
+
+    if (mode == ADD_VALUES) SETERRQ1(PetscObjectComm((PetscObject)dm), PETSC_ERR_ARG_OUTOFRANGE, "Invalid insertion mode %D", mode);
+    ierr = PetscMalloc2(k,&gArrays,k,&lArrays);CHKERRQ(ierr);
+    for (i=0; i<k; i++) {
+      ierr = VecGetArray(l[i], &lArrays[i]);CHKERRQ(ierr);
+      ierr = VecGetArrayRead(g[i], &gArrays[i]);CHKERRQ(ierr);
+    }
+    ierr = PetscSFBcastAndOpMultipleEnd(sf, MPIU_SCALAR, k, (const void*const*)gArrays, (void*const*)lArrays, MPIU_REPLACE);CHKERRQ(ierr);
+    for (i=0; i<k; i++) {
+      ierr = VecRestoreArray(l[i], &lArrays[i]);CHKERRQ(ierr);
+      ierr = VecRestoreArrayRead(g[i], &gArrays[i]);CHKERRQ(ierr);
+      if (transform) {ierr = DMPlexGlobalToLocalBasis(dm, l[i]);CHKERRQ(ierr);}
+    }
+    ierr = PetscFree2(gArrays,lArrays);CHKERRQ(ierr);
+  } else if (dm->ops->globaltolocalendmultiple) {
+    ierr = (*dm->ops->globaltolocalendmultiple)(dm,k,g,imode,l);CHKERRQ(ierr);
+  }
+  for (i=0; i<k; i++) {
+    ierr = DMGlobalToLocalHook_Constraints(dm,g[i],mode,l[i],NULL);CHKERRQ(ierr);
+    for (link=dm->gtolhook; link; link=link->next) {
+      if (link->endhook) {ierr = (*link->endhook)(dm,g[i],mode,l[i],link->ctx);CHKERRQ(ierr);}
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
 /*@C
    DMLocalToGlobalHookAdd - adds a callback to be run when a local to global is called
 
@@ -0,0 +1,122 @@
+static char help[] = "Tests rebuilding PCGAMG for a sequence of matrices with the same nonzero structure with PCGAMGSetReuseAggregates().\n\
+The solutions are compared with those of PCGAMG built from scratch for each matrix. The last two matrices have a new\n\
+nonzero structure, so the preconditioner that reuses the aggregates has to be built again from scratch.\n\
+  -m <m> : number of grid points in each direction\n\
+  -steps <steps> : number of matrices with the first nonzero structure\n\n";
+
+#include <petscksp.h>
+
+/*
+   the 5-point Laplacian with the coefficient 1 + s*(x+y) + s*s*x*y, whose entries change with s but not its nonzero structure;
+   with diag the diagonal neighbors are coupled as well, which changes the nonzero structure
+*/
+static PetscErrorCode FormMatrix(Mat A,PetscInt m,PetscReal s,PetscBool diag)
+{
+  PetscInt       i,j,Ii,J,Istart,Iend;
+  PetscReal      h = 1.0/(m+1),x,y,c,cx,cy,d = 0.0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (Ii=Istart; Ii<Iend; Ii++) {
+    i  = Ii/m; j = Ii - i*m;
+    x  = (i+1)*h; y = (j+1)*h;
+    c  = 1.0 + s*(x+y) + s*s*x*y;
+    cx = 1.0 + s*(x+h+y) + s*s*(x+h)*y;
+    cy = 1.0 + s*(x+y+h) + s*s*x*(y+h);
+    if (i>0)   {J = Ii - m; ierr = MatSetValues(A,1,&Ii,1,&J,&c,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<m-1) {J = Ii + m; ierr = MatSetValues(A,1,&Ii,1,&J,&cx,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {J = Ii - 1; ierr = MatSetValues(A,1,&Ii,1,&J,&c,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<m-1) {J = Ii + 1; ierr = MatSetValues(A,1,&Ii,1,&J,&cy,INSERT_VALUES);CHKERRQ(ierr);}
+    if (diag) {
+      d = 0.1*c;
+      if (i>0 && j>0)     {J = Ii - m - 1; ierr = MatSetValues(A,1,&Ii,1,&J,&d,INSERT_VALUES);CHKERRQ(ierr);}
+      if (i>0 && j<m-1)   {J = Ii - m + 1; ierr = MatSetValues(A,1,&Ii,1,&J,&d,INSERT_VALUES);CHKERRQ(ierr);}
+      if (i<m-1 && j>0)   {J = Ii + m - 1; ierr = MatSetValues(A,1,&Ii,1,&J,&d,INSERT_VALUES);CHKERRQ(ierr);}
+      if (i<m-1 && j<m-1) {J = Ii + m + 1; ierr = MatSetValues(A,1,&Ii,1,&J,&d,INSERT_VALUES);CHKERRQ(ierr);}
+    }
+    c    = -(2.0*c + cx + cy + 4.0*d);
+    ierr = MatSetValues(A,1,&Ii,1,&Ii,&c,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatScale(A,-1.0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A;
+  Vec            x,y,b;
+  KSP            ksp[2];
+  PC             pc;
+  PetscInt       m = 32,steps = 3,k,l,its[2];
+  PetscReal      nrm,err;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-steps",&steps,NULL);CHKERRQ(ierr);
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,m*m,m*m);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,5,NULL);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,5,NULL,2,NULL);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = VecSet(b,1.0);CHKERRQ(ierr);
+
+  /* the first solver keeps its aggregates, the second is built from scratch for each matrix */
+  for (l=0; l<2; l++) {
+    ierr = KSPCreate(PETSC_COMM_WORLD,&ksp[l]);CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp[l],A,A);CHKERRQ(ierr);
+    ierr = KSPSetType(ksp[l],KSPCG);CHKERRQ(ierr);
+    ierr = KSPSetTolerances(ksp[l],1.e-10,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT);CHKERRQ(ierr);
+    ierr = KSPGetPC(ksp[l],&pc);CHKERRQ(ierr);
+    ierr = PCSetType(pc,PCGAMG);CHKERRQ(ierr);
+    ierr = KSPSetFromOptions(ksp[l]);CHKERRQ(ierr);
+    ierr = PCGAMGSetReuseAggregates(pc,l ? PETSC_FALSE : PETSC_TRUE);CHKERRQ(ierr);
+  }
+
+  for (k=0; k<steps+2; k++) {
+    ierr = FormMatrix(A,m,0.5*k,(PetscBool)(k >= steps));CHKERRQ(ierr);
+    ierr = KSPSolve(ksp[0],b,x);CHKERRQ(ierr);
+    ierr = KSPSolve(ksp[1],b,y);CHKERRQ(ierr);
+    ierr = KSPGetIterationNumber(ksp[0],&its[0]);CHKERRQ(ierr);
+    ierr = KSPGetIterationNumber(ksp[1],&its[1]);CHKERRQ(ierr);
+    ierr = VecNorm(y,NORM_2,&nrm);CHKERRQ(ierr);
+    ierr = VecAXPY(y,-1.0,x);CHKERRQ(ierr);
+    ierr = VecNorm(y,NORM_2,&err);CHKERRQ(ierr);
+    if (its[0] == its[1]) {
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"Matrix %D: same number of iterations, solutions %s\n",k,err < 1.e-6*nrm ? "agree" : "differ");CHKERRQ(ierr);
+    } else {
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"Matrix %D: iterations %D with reused aggregates %D with a new setup, solutions %s\n",k,its[0],its[1],err < 1.e-6*nrm ? "agree" : "differ");CHKERRQ(ierr);
+    }
+  }
+
+  for (l=0; l<2; l++) {ierr = KSPDestroy(&ksp[l]);CHKERRQ(ierr);}
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      nsize: {{1 4}}
+      args: -pc_gamg_coarse_eq_limit 20 -pc_gamg_process_eq_limit 40 -mg_levels_ksp_max_it 2 -pc_gamg_agg_nsmooths {{0 1}}
+      output_file: output/ex64_1.out
+
+   test:
+      suffix: agglomerate
+      nsize: 4
+      args: -pc_gamg_coarse_eq_limit 20 -pc_gamg_process_eq_limit 40 -mg_levels_ksp_max_it 2 -pc_gamg_agg_nsmooths 0 -pc_mg_agglomerate_eq_limit 100 -pc_mg_agglomerate_factor 2 -mg_levels_ksp_type {{chebyshev richardson}} -mg_levels_pc_type sor
+      output_file: output/ex64_1.out
+
+TEST*/
@@ -0,0 +1,100 @@
+static char help[] = "Tests KSPCHEBYSHEV with PCJACOBI for a sequence of matrices with the same nonzero structure.\n\
+The eigenvalues are estimated again according to KSPChebyshevEstEigSetLag().\n\
+  -m <m> : number of grid points in each direction\n\
+  -steps <steps> : number of matrices\n\n";
+
+#include <petscksp.h>
+
+/* the 5-point Laplacian with the coefficient 1 + s*(x+y), whose entries change with s but not its nonzero structure */
+static PetscErrorCode FormMatrix(Mat A,PetscInt m,PetscReal s)
+{
+  PetscInt       i,j,Ii,J,Istart,Iend;
+  PetscReal      h = 1.0/(m+1),x,y;
+  PetscScalar    c,cx,cy;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (Ii=Istart; Ii<Iend; Ii++) {
+    i  = Ii/m; j = Ii - i*m;
+    x  = (i+1)*h; y = (j+1)*h;
+    c  = 1.0 + s*(x+y);
+    cx = 1.0 + s*(x+h+y);
+    cy = 1.0 + s*(x+y+h);
+    if (i>0)   {J = Ii - m; ierr = MatSetValues(A,1,&Ii,1,&J,&c,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<m-1) {J = Ii + m; ierr = MatSetValues(A,1,&Ii,1,&J,&cx,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {J = Ii - 1; ierr = MatSetValues(A,1,&Ii,1,&J,&c,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<m-1) {J = Ii + 1; ierr = MatSetValues(A,1,&Ii,1,&J,&cy,INSERT_VALUES);CHKERRQ(ierr);}
+    c    = -(2.0*c + cx + cy);
+    ierr = MatSetValues(A,1,&Ii,1,&Ii,&c,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatScale(A,-1.0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A;
+  Vec            x,b;
+  KSP            ksp,kspest;
+  PC             pc;
+  PetscInt       m = 16,steps = 4,k,its,estits;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-steps",&steps,NULL);CHKERRQ(ierr);
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,m*m,m*m);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,5,NULL);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,5,NULL,2,NULL);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecSet(b,1.0);CHKERRQ(ierr);
+
+  ierr = KSPCreate(PETSC_COMM_WORLD,&ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+  ierr = KSPSetType(ksp,KSPCHEBYSHEV);CHKERRQ(ierr);
+  ierr = KSPGetPC(ksp,&pc);CHKERRQ(ierr);
+  ierr = PCSetType(pc,PCJACOBI);CHKERRQ(ierr);
+  ierr = KSPChebyshevEstEigSet(ksp,0.02,0.0,0.0,1.1);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(ksp,1.e-6,PETSC_DEFAULT,PETSC_DEFAULT,500);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+  ierr = KSPChebyshevEstEigGetKSP(ksp,&kspest);CHKERRQ(ierr);
+
+  for (k=0; k<steps; k++) {
+    ierr = FormMatrix(A,m,0.1*k);CHKERRQ(ierr);
+    ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+    ierr = KSPGetIterationNumber(ksp,&its);CHKERRQ(ierr);
+    ierr = KSPGetTotalIterations(kspest,&estits);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Matrix %D: iterations %D, iterations of the eigenvalue estimates so far %D\n",k,its,estits);CHKERRQ(ierr);
+  }
+
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      nsize: {{1 3}}
+      args: -ksp_chebyshev_fused {{0 1}} -ksp_norm_type {{preconditioned unpreconditioned}}
+      output_file: output/ex65_1.out
+
+   test:
+      suffix: lag_never
+      args: -ksp_chebyshev_esteig_lag -1
+
+   test:
+      suffix: lag_2
+      args: -ksp_chebyshev_esteig_lag 2
+
+TEST*/
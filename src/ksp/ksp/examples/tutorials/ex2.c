@@ -232,6 +232,21 @@ int main(int argc,char **args)
       suffix: 4
       args: -pc_type eisenstat -ksp_monitor_short -ksp_gmres_cgs_refinement_type refine_always
 
+   test:
+      suffix: sor_multicolor
+      args: -ksp_type cg -pc_type sor -pc_sor_symmetric -pc_sor_multicolor -pc_sor_its 2 -ksp_monitor_short -ksp_view
+
+   test:
+      suffix: sor_multicolor_2
+      nsize: 2
+      args: -ksp_type cg -pc_type sor -pc_sor_local_symmetric -pc_sor_multicolor -pc_sor_omega 1.2 -sor_mat_coloring_type jp -ksp_monitor_short
+
+   test:
+      suffix: sor_multicolor_threads
+      requires: openmp
+      args: -ksp_type cg -pc_type sor -pc_sor_symmetric -pc_sor_multicolor -pc_sor_its 2 -ksp_monitor_short -ksp_view -omp_num_threads 3
+      output_file: output/ex2_sor_multicolor.out
+
    test:
       suffix: 5
       nsize: 2
@@ -253,6 +268,42 @@ int main(int argc,char **args)
       nsize: 4
       args: -pc_type bjacobi -pc_bjacobi_blocks 4 -ksp_monitor_short -sub_pc_type jacobi -sub_ksp_type gmres
 
+   test:
+      suffix: bjacobi_local_blocks
+      nsize: 2
+      args: -m 20 -n 20 -pc_type bjacobi -pc_bjacobi_local_blocks 4 -sub_pc_type lu -ksp_monitor_short
+
+   test:
+      suffix: bjacobi_local_blocks_threads
+      nsize: 2
+      requires: openmp threadsafety
+      args: -m 20 -n 20 -pc_type bjacobi -pc_bjacobi_local_blocks 4 -sub_pc_type lu -ksp_monitor_short -pc_bjacobi_threaded_blocks -omp_num_threads 2
+      output_file: output/ex2_bjacobi_local_blocks.out
+
+   test:
+      suffix: asm_local_blocks
+      nsize: 2
+      args: -m 20 -n 20 -pc_type asm -pc_asm_local_blocks 4 -sub_pc_type lu -ksp_monitor_short
+
+   test:
+      suffix: asm_local_blocks_threads
+      nsize: 2
+      requires: openmp threadsafety
+      args: -m 20 -n 20 -pc_type asm -pc_asm_local_blocks 4 -sub_pc_type lu -ksp_monitor_short -pc_asm_threaded_blocks -omp_num_threads 2
+      output_file: output/ex2_asm_local_blocks.out
+
+   test:
+      suffix: asm_local_blocks_transpose
+      nsize: 2
+      args: -m 20 -n 20 -pc_type asm -pc_asm_local_blocks 4 -sub_pc_type lu -ksp_monitor_short -ksp_type bicg
+
+   test:
+      suffix: asm_local_blocks_transpose_threads
+      nsize: 2
+      requires: openmp threadsafety
+      args: -m 20 -n 20 -pc_type asm -pc_asm_local_blocks 4 -sub_pc_type lu -ksp_monitor_short -ksp_type bicg -pc_asm_threaded_blocks -omp_num_threads 2
+      output_file: output/ex2_asm_local_blocks_transpose.out
+
    test:
       suffix: fbcgs
       args: -ksp_type fbcgs -pc_type ilu
@@ -266,6 +317,16 @@ int main(int argc,char **args)
       suffix: groppcg
       args: -ksp_monitor_short -ksp_type groppcg -m 9 -n 9
 
+   test:
+      suffix: lag_norm
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type {{cg bcgs gmres}separate output} -ksp_lag_norm -m 9 -n 9
+
+   test:
+      suffix: lag_norm_default
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type cg -ksp_norm_type {{preconditioned unpreconditioned natural}separate output} -ksp_lag_norm_default -m 9 -n 9
+
    test:
       suffix: mkl_pardiso_cholesky
       requires: mkl_pardiso
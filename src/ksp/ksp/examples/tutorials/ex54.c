@@ -220,6 +220,12 @@ int main(int argc,char **args)
       nsize: 4
       args: -ne 49 -alpha 1.e-3 -ksp_type cg -pc_type gamg -pc_gamg_type agg -pc_gamg_agg_nsmooths 1 -ksp_converged_reason -mg_levels_ksp_chebyshev_esteig 0,0.05,0,1.1 -mg_levels_esteig_ksp_type cg -mg_levels_esteig_ksp_max_it 10 -mg_levels_pc_type sor -pc_gamg_use_sa_esteig
 
+   test:
+      suffix: mis2
+      nsize: {{1 4}}
+      args: -ne 49 -alpha 1.e-3 -ksp_type cg -pc_type gamg -pc_gamg_type agg -pc_gamg_agg_nsmooths 1 -ksp_converged_reason -mg_levels_ksp_chebyshev_esteig 0,0.05,0,1.1 -mg_levels_esteig_ksp_type cg -mg_levels_esteig_ksp_max_it 10 -mg_levels_pc_type sor -pc_gamg_use_sa_esteig -mat_coarsen_type mis2
+      output_file: output/ex54_1.out
+
    test:
       suffix: seqaijmkl
       nsize: 4
@@ -238,4 +244,16 @@ int main(int argc,char **args)
       requires: triangle
       output_file: output/ex54_0.out
 
+   test:
+      suffix: agglomerate
+      nsize: 4
+      args: -ne 119 -pc_type gamg -pc_gamg_agg_nsmooths 1 -pc_gamg_coarse_eq_limit 400 -pc_mg_agglomerate_eq_limit {{0 2000}} -mg_levels_pc_type {{sor jacobi}} -ksp_converged_reason
+      output_file: output/ex54_agglomerate.out
+
+   test:
+      suffix: agglomerate_asm
+      nsize: 4
+      args: -ne 119 -pc_type gamg -pc_gamg_agg_nsmooths 1 -pc_gamg_coarse_eq_limit 400 -pc_mg_agglomerate_eq_limit {{0 2000}} -pc_gamg_asm_use_agg -ksp_converged_reason
+      output_file: output/ex54_agglomerate_asm.out
+
 TEST*/
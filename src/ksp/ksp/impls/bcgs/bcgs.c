@@ -13,21 +13,39 @@ PetscErrorCode KSPSetFromOptions_BCGS(PetscOptionItems *PetscOptionsObject,KSP k
 
 PetscErrorCode KSPSetUp_BCGS(KSP ksp)
 {
+  KSP_BCGS       *bcgs = (KSP_BCGS*)ksp->data;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
   ierr = KSPSetWorkVecs(ksp,6);CHKERRQ(ierr);
+  if (!bcgs->fuse) {ierr = VecFuseCreate(PetscObjectComm((PetscObject)ksp),&bcgs->fuse);CHKERRQ(ierr);}
   PetscFunctionReturn(0);
 }
 
 
+/* tests the convergence of the current iterate when the norm of its residual is computed in the next iteration */
+static PetscErrorCode KSPBCGSLaggedConverged_Private(KSP ksp,PetscReal dp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->rnorm = dp;
+  ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,ksp->its,dp);CHKERRQ(ierr);
+  ierr = (*ksp->converged)(ksp,ksp->its,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode KSPSolve_BCGS(KSP ksp)
 {
   PetscErrorCode ierr;
   PetscInt       i;
-  PetscScalar    rho,rhoold,alpha,beta,omega,omegaold,d1;
+  PetscScalar    rho,rhoold,alpha,beta,omega,omegaold,d1,tt,srp,trp;
   Vec            X,B,V,P,R,RP,T,S;
   PetscReal      dp    = 0.0,d2;
+  PetscBool      lag   = ksp->lagnorm;
   KSP_BCGS       *bcgs = (KSP_BCGS*)ksp->data;
 
   PetscFunctionBegin;
@@ -79,14 +97,27 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
   omegaold = 1.0;
   ierr     = VecSet(P,0.0);CHKERRQ(ierr);
   ierr     = VecSet(V,0.0);CHKERRQ(ierr);
+  ierr     = VecDot(R,RP,&rho);CHKERRQ(ierr);     /*   rho <- (r,rp)      */
 
   i=0;
   do {
-    ierr = VecDot(R,RP,&rho);CHKERRQ(ierr);       /*   rho <- (r,rp)      */
+    /* after the first iteration rho <- (r,rp) is computed in one pass with the update of r */
     beta = (rho/rhoold) * (alpha/omegaold);
     ierr = VecAXPBYPCZ(P,1.0,-omegaold*beta,beta,R,V);CHKERRQ(ierr);  /* p <- r - omega * beta* v + beta * p */
     ierr = KSP_PCApplyBAorAB(ksp,P,V,T);CHKERRQ(ierr);  /*   v <- K p           */
-    ierr = VecDot(V,RP,&d1);CHKERRQ(ierr);
+    if (lag && i) {
+      /* the convergence of the previous iterate, which x still holds, is tested with the norm reduced together with (v,rp) */
+      ierr = VecFuseDot(bcgs->fuse,V,RP,&d1);CHKERRQ(ierr);
+      if (ksp->normtype != KSP_NORM_NONE && ksp->chknorm < i+1) {
+        ierr = VecFuseNorm(bcgs->fuse,R,&dp);CHKERRQ(ierr);
+      }
+      ierr = VecFuseExecute(bcgs->fuse);CHKERRQ(ierr);
+      if (ksp->normtype != KSP_NORM_NONE && ksp->chknorm < i+1) KSPCheckNorm(ksp,dp);
+      ierr = KSPBCGSLaggedConverged_Private(ksp,dp);CHKERRQ(ierr);
+      if (ksp->reason) break;
+    } else {
+      ierr = VecDot(V,RP,&d1);CHKERRQ(ierr);
+    }
     KSPCheckDot(ksp,d1);
     if (d1 == 0.0) {
       if (ksp->errorifnotconverged) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"KSPSolve has not converged due to Nan or Inf inner product");
@@ -98,7 +129,21 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
     alpha = rho / d1;                 /*   a <- rho / (v,rp)  */
     ierr  = VecWAXPY(S,-alpha,V,R);CHKERRQ(ierr);     /*   s <- r - a v       */
     ierr  = KSP_PCApplyBAorAB(ksp,S,T,R);CHKERRQ(ierr); /*   t <- K s    */
-    ierr  = VecDotNorm2(S,T,&d1,&d2);CHKERRQ(ierr);
+    if (lag) {
+      /* (s,rp) and (t,rp) give rho for the next iteration without a reduction after the update of r, the first part
+         of the update of x is done while they are reduced */
+      ierr = VecFuseDot(bcgs->fuse,S,T,&d1);CHKERRQ(ierr);
+      ierr = VecFuseDot(bcgs->fuse,T,T,&tt);CHKERRQ(ierr);
+      ierr = VecFuseDot(bcgs->fuse,S,RP,&srp);CHKERRQ(ierr);
+      ierr = VecFuseDot(bcgs->fuse,T,RP,&trp);CHKERRQ(ierr);
+      ierr = VecFuseExecuteBegin(bcgs->fuse);CHKERRQ(ierr);
+      ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)S));CHKERRQ(ierr);
+      ierr = VecAXPY(X,alpha,P);CHKERRQ(ierr);        /*   x <- x + a p       */
+      ierr = VecFuseExecuteEnd(bcgs->fuse);CHKERRQ(ierr);
+      d2   = PetscRealPart(tt);
+    } else {
+      ierr = VecDotNorm2(S,T,&d1,&d2);CHKERRQ(ierr);
+    }
     if (d2 == 0.0) {
       /* t is 0.  if s is 0, then alpha v == r, and hence alpha p
          may be our solution.  Give it a try? */
@@ -107,7 +152,7 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
         ksp->reason = KSP_DIVERGED_BREAKDOWN;
         break;
       }
-      ierr = VecAXPY(X,alpha,P);CHKERRQ(ierr);   /*   x <- x + a p       */
+      if (!lag) {ierr = VecAXPY(X,alpha,P);CHKERRQ(ierr);}   /*   x <- x + a p       */
       ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
       ksp->its++;
       ksp->rnorm  = 0.0;
@@ -118,32 +163,54 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
       break;
     }
     omega = d1 / d2;                               /*   w <- (t's) / (t't) */
-    ierr  = VecAXPBYPCZ(X,alpha,omega,1.0,P,S);CHKERRQ(ierr); /* x <- alpha * p + omega * s + x */
-    ierr  = VecWAXPY(R,-omega,T,S);CHKERRQ(ierr);     /*   r <- s - w t       */
-    if (ksp->normtype != KSP_NORM_NONE && ksp->chknorm < i+2) {
-      ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);
-      KSPCheckNorm(ksp,dp);
-    }
-
     rhoold   = rho;
     omegaold = omega;
+    if (lag) {
+      ierr = VecFuseAXPY(bcgs->fuse,X,omega,S);CHKERRQ(ierr);     /* x <- omega * s + x */
+      ierr = VecFuseWAXPY(bcgs->fuse,R,-omega,T,S);CHKERRQ(ierr); /*   r <- s - w t       */
+      ierr = VecFuseExecute(bcgs->fuse);CHKERRQ(ierr);
+      rho  = srp - omega*trp;                                     /*   rho <- (r,rp) for the next iteration */
+      ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+      ksp->its++;
+      ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+    } else {
+      ierr = VecFuseAXPY(bcgs->fuse,X,alpha,P);CHKERRQ(ierr);     /* x <- alpha * p + omega * s + x */
+      ierr = VecFuseAXPY(bcgs->fuse,X,omega,S);CHKERRQ(ierr);
+      ierr = VecFuseWAXPY(bcgs->fuse,R,-omega,T,S);CHKERRQ(ierr); /*   r <- s - w t       */
+      if (ksp->normtype != KSP_NORM_NONE && ksp->chknorm < i+2) {
+        ierr = VecFuseNorm(bcgs->fuse,R,&dp);CHKERRQ(ierr);
+      }
+      ierr = VecFuseDot(bcgs->fuse,R,RP,&rho);CHKERRQ(ierr);      /*   rho <- (r,rp) for the next iteration */
+      ierr = VecFuseExecute(bcgs->fuse);CHKERRQ(ierr);
+      if (ksp->normtype != KSP_NORM_NONE && ksp->chknorm < i+2) KSPCheckNorm(ksp,dp);
 
-    ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
-    ksp->its++;
-    ksp->rnorm = dp;
-    ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
-    ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
-    ierr = KSPMonitor(ksp,i+1,dp);CHKERRQ(ierr);
-    ierr = (*ksp->converged)(ksp,i+1,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
-    if (ksp->reason) break;
-    if (rho == 0.0) {
+      ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+      ksp->its++;
+      ksp->rnorm = dp;
+      ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+      ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
+      ierr = KSPMonitor(ksp,i+1,dp);CHKERRQ(ierr);
+      ierr = (*ksp->converged)(ksp,i+1,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+      if (ksp->reason) break;
+    }
+    if (rhoold == 0.0) {
       ksp->reason = KSP_DIVERGED_BREAKDOWN;
       break;
     }
     i++;
   } while (i<ksp->max_it);
 
-  if (i >= ksp->max_it) ksp->reason = KSP_DIVERGED_ITS;
+  if (i >= ksp->max_it) {
+    /* the last iterate has not been tested yet */
+    if (lag) {
+      if (ksp->normtype != KSP_NORM_NONE && ksp->chknorm < i+1) {
+        ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);
+        KSPCheckNorm(ksp,dp);
+      }
+      ierr = KSPBCGSLaggedConverged_Private(ksp,dp);CHKERRQ(ierr);
+    }
+    if (!ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+  }
 
   ierr = KSPUnwindPreconditioner(ksp,X,T);CHKERRQ(ierr);
   if (bcgs->guess) {
@@ -181,6 +248,7 @@ PetscErrorCode KSPReset_BCGS(KSP ksp)
 
   PetscFunctionBegin;
   ierr = VecDestroy(&cg->guess);CHKERRQ(ierr);
+  ierr = VecFuseDestroy(&cg->fuse);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -9,7 +9,8 @@
 #include <petsc/private/kspimpl.h>        /*I "petscksp.h" I*/
 
 typedef struct {
-  Vec guess;   /* if using right preconditioning with nonzero initial guess must keep that around to "fix" solution */
+  Vec     guess;   /* if using right preconditioning with nonzero initial guess must keep that around to "fix" solution */
+  VecFuse fuse;    /* computes the vector updates at the end of an iteration together with the reductions that follow */
 } KSP_BCGS;
 
 PETSC_INTERN PetscErrorCode KSPSetFromOptions_BCGS(PetscOptionItems *PetscOptionsObject,KSP);
@@ -61,6 +61,7 @@ static PetscErrorCode KSPSetUp_CG(KSP ksp)
   /* get work vectors needed by CG */
   if (cgP->singlereduction) nwork += 2;
   ierr = KSPSetWorkVecs(ksp,nwork);CHKERRQ(ierr);
+  if (!cgP->fuse) {ierr = VecFuseCreate(PetscObjectComm((PetscObject)ksp),&cgP->fuse);CHKERRQ(ierr);}
 
   /*
      If user requested computations of eigenvalues then allocate work
@@ -81,6 +82,7 @@ static PetscErrorCode KSPSetUp_CG(KSP ksp)
      A macro used in the following KSPSolve_CG and KSPSolve_CG_SingleReduction routines
 */
 #define VecXDot(x,y,a) (((cg->type) == (KSP_CG_HERMITIAN)) ? VecDot(x,y,a) : VecTDot(x,y,a))
+#define VecFuseXDot(f,x,y,a) (((cg->type) == (KSP_CG_HERMITIAN)) ? VecFuseDot(f,x,y,a) : VecFuseTDot(f,x,y,a))
 
 /*
      KSPSolve_CG - This routine actually applies the conjugate gradient method
@@ -99,6 +101,7 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
   PetscScalar    dpi = 0.0,a = 1.0,beta,betaold = 1.0,b = 0,*e = 0,*d = 0,dpiold;
   PetscReal      dp  = 0.0;
   Vec            X,B,Z,R,P,W;
+  VecFuse        fuse;
   KSP_CG         *cg;
   Mat            Amat,Pmat;
   PetscBool      diagonalscale;
@@ -116,6 +119,7 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
   Z             = ksp->work[1];
   P             = ksp->work[2];
   W             = Z;
+  fuse          = cg->fuse;            /* the vector updates and the reductions that follow them are done in one pass */
 
   if (eigs) {e = cg->e; d = cg->d; e[0] = 0.0; }
   ierr = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
@@ -131,11 +135,20 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
   switch (ksp->normtype) {
     case KSP_NORM_PRECONDITIONED:
       ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*    z <- Br                           */
-      ierr = VecNorm(Z,NORM_2,&dp);CHKERRQ(ierr);              /*    dp <- z'*z = e'*A'*B'*B*A*e       */
+      ierr = VecFuseNorm(fuse,Z,&dp);CHKERRQ(ierr);            /*    dp <- z'*z = e'*A'*B'*B*A*e       */
+      ierr = VecFuseXDot(fuse,Z,R,&beta);CHKERRQ(ierr);        /*    beta <- z'*r                      */
+      ierr = VecFuseExecute(fuse);CHKERRQ(ierr);
       KSPCheckNorm(ksp,dp);
       break;
     case KSP_NORM_UNPRECONDITIONED:
-      ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);              /*    dp <- r'*r = e'*A'*A*e            */
+      if (ksp->lagnorm) {                                      /*    the norm waits for beta to share its reduction */
+        ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);             /*    z <- Br                           */
+        ierr = VecFuseNorm(fuse,R,&dp);CHKERRQ(ierr);          /*    dp <- r'*r = e'*A'*A*e            */
+        ierr = VecFuseXDot(fuse,Z,R,&beta);CHKERRQ(ierr);      /*    beta <- z'*r                      */
+        ierr = VecFuseExecute(fuse);CHKERRQ(ierr);
+      } else {
+        ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);            /*    dp <- r'*r = e'*A'*A*e            */
+      }
       KSPCheckNorm(ksp,dp);
       break;
     case KSP_NORM_NATURAL:
@@ -156,13 +169,11 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
   ierr = (*ksp->converged)(ksp,0,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);     /* test for convergence */
   if (ksp->reason) PetscFunctionReturn(0);
 
-  if (ksp->normtype != KSP_NORM_PRECONDITIONED && (ksp->normtype != KSP_NORM_NATURAL)) {
+  if (ksp->normtype == KSP_NORM_NONE || (ksp->normtype == KSP_NORM_UNPRECONDITIONED && !ksp->lagnorm)) {
     ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);                /*     z <- Br                           */
-  }
-  if (ksp->normtype != KSP_NORM_NATURAL) {
     ierr = VecXDot(Z,R,&beta);CHKERRQ(ierr);                  /*     beta <- z'*r                      */
-    KSPCheckDot(ksp,beta);
   }
+  KSPCheckDot(ksp,beta);
 
   i = 0;
   do {
@@ -204,22 +215,51 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
     }
     a = beta/dpi;                                              /*     a = beta/p'w                     */
     if (eigs) d[i] = PetscSqrtReal(PetscAbsScalar(b))*e[i] + 1.0/a;
-    ierr = VecAXPY(X,a,P);CHKERRQ(ierr);                       /*     x <- x + ap                      */
-    ierr = VecAXPY(R,-a,W);CHKERRQ(ierr);                      /*     r <- r - aw                      */
-    if (ksp->normtype == KSP_NORM_PRECONDITIONED && ksp->chknorm < i+2) {
-      ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*     z <- Br                          */
-      ierr = VecNorm(Z,NORM_2,&dp);CHKERRQ(ierr);              /*     dp <- z'*z                       */
-      KSPCheckNorm(ksp,dp);
-    } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED && ksp->chknorm < i+2) {
-      ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);              /*     dp <- r'*r                       */
-      KSPCheckNorm(ksp,dp);
-    } else if (ksp->normtype == KSP_NORM_NATURAL) {
+    if (ksp->lagnorm) {
+      /* the norm is computed with beta after the preconditioner is applied, and x is updated while they are reduced */
+      ierr = VecAXPY(R,-a,W);CHKERRQ(ierr);                    /*     r <- r - aw                      */
       ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*     z <- Br                          */
-      ierr = VecXDot(Z,R,&beta);CHKERRQ(ierr);                 /*     beta <- r'*z                     */
-      KSPCheckDot(ksp,beta);
-      dp = PetscSqrtReal(PetscAbsScalar(beta));
+      if (ksp->normtype == KSP_NORM_PRECONDITIONED && ksp->chknorm < i+2) {
+        ierr = VecFuseNorm(fuse,Z,&dp);CHKERRQ(ierr);          /*     dp <- z'*z                       */
+      } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED && ksp->chknorm < i+2) {
+        ierr = VecFuseNorm(fuse,R,&dp);CHKERRQ(ierr);          /*     dp <- r'*r                       */
+      }
+      ierr = VecFuseXDot(fuse,Z,R,&beta);CHKERRQ(ierr);        /*     beta <- z'*r                     */
+      ierr = VecFuseExecuteBegin(fuse);CHKERRQ(ierr);
+      ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)R));CHKERRQ(ierr);
+      ierr = VecAXPY(X,a,P);CHKERRQ(ierr);                     /*     x <- x + ap                      */
+      ierr = VecFuseExecuteEnd(fuse);CHKERRQ(ierr);
+      if ((ksp->normtype == KSP_NORM_PRECONDITIONED || ksp->normtype == KSP_NORM_UNPRECONDITIONED) && ksp->chknorm < i+2) {
+        KSPCheckNorm(ksp,dp);
+      } else if (ksp->normtype == KSP_NORM_NATURAL) {
+        KSPCheckDot(ksp,beta);
+        dp = PetscSqrtReal(PetscAbsScalar(beta));              /*     dp <- r'*z                       */
+      } else {
+        dp = 0.0;
+      }
     } else {
-      dp = 0.0;
+      ierr = VecFuseAXPY(fuse,X,a,P);CHKERRQ(ierr);            /*     x <- x + ap                      */
+      ierr = VecFuseAXPY(fuse,R,-a,W);CHKERRQ(ierr);           /*     r <- r - aw                      */
+      if (ksp->normtype == KSP_NORM_UNPRECONDITIONED && ksp->chknorm < i+2) {
+        ierr = VecFuseNorm(fuse,R,&dp);CHKERRQ(ierr);          /*     dp <- r'*r                       */
+      }
+      ierr = VecFuseExecute(fuse);CHKERRQ(ierr);
+      if (ksp->normtype == KSP_NORM_PRECONDITIONED && ksp->chknorm < i+2) {
+        ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);             /*     z <- Br                          */
+        ierr = VecFuseNorm(fuse,Z,&dp);CHKERRQ(ierr);          /*     dp <- z'*z                       */
+        ierr = VecFuseXDot(fuse,Z,R,&beta);CHKERRQ(ierr);      /*     beta <- z'*r                     */
+        ierr = VecFuseExecute(fuse);CHKERRQ(ierr);
+        KSPCheckNorm(ksp,dp);
+      } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED && ksp->chknorm < i+2) {
+        KSPCheckNorm(ksp,dp);
+      } else if (ksp->normtype == KSP_NORM_NATURAL) {
+        ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);             /*     z <- Br                          */
+        ierr = VecXDot(Z,R,&beta);CHKERRQ(ierr);               /*     beta <- r'*z                     */
+        KSPCheckDot(ksp,beta);
+        dp = PetscSqrtReal(PetscAbsScalar(beta));
+      } else {
+        dp = 0.0;
+      }
     }
     ksp->rnorm = dp;
     ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
@@ -228,13 +268,13 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
     ierr = (*ksp->converged)(ksp,i+1,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
     if (ksp->reason) break;
 
-    if ((ksp->normtype != KSP_NORM_PRECONDITIONED && (ksp->normtype != KSP_NORM_NATURAL)) || (ksp->chknorm >= i+2)) {
+    if (!ksp->lagnorm && ((ksp->normtype != KSP_NORM_PRECONDITIONED && (ksp->normtype != KSP_NORM_NATURAL)) || (ksp->chknorm >= i+2))) {
       ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*     z <- Br                          */
     }
-    if ((ksp->normtype != KSP_NORM_NATURAL) || (ksp->chknorm >= i+2)) {
+    if (!ksp->lagnorm && ((ksp->normtype != KSP_NORM_NATURAL && ksp->normtype != KSP_NORM_PRECONDITIONED) || (ksp->chknorm >= i+2))) {
       ierr = VecXDot(Z,R,&beta);CHKERRQ(ierr);                 /*     beta <- z'*r                     */
-      KSPCheckDot(ksp,beta);
     }
+    KSPCheckDot(ksp,beta);
 
     i++;
   } while (i<ksp->max_it);
@@ -435,6 +475,7 @@ PetscErrorCode KSPDestroy_CG(KSP ksp)
   if (ksp->calc_sings) {
     ierr = PetscFree4(cg->e,cg->d,cg->ee,cg->dd);CHKERRQ(ierr);
   }
+  ierr = VecFuseDestroy(&cg->fuse);CHKERRQ(ierr);
   ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPCGSetType_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPCGUseSingleReduction_C",NULL);CHKERRQ(ierr);
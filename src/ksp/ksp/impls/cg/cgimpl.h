@@ -34,6 +34,7 @@ typedef struct {
   PetscReal   *ee,*dd;             /* work space for Lanczos algorithm */
 
   PetscBool singlereduction;          /* use variant of CG that combines both inner products */
+  VecFuse   fuse;                     /* computes the vector updates and reductions of an iteration in one pass */
 } KSP_CG;
 
 #endif
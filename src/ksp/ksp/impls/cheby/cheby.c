@@ -8,6 +8,7 @@ static PetscErrorCode KSPReset_Chebyshev(KSP ksp)
 
   PetscFunctionBegin;
   ierr = KSPReset(cheb->kspest);CHKERRQ(ierr);
+  cheb->estimated = PETSC_FALSE;
   PetscFunctionReturn(0);
 }
 
@@ -60,6 +61,7 @@ static PetscErrorCode KSPChebyshevEstEigSet_Chebyshev(KSP ksp,PetscReal a,PetscR
 
       /* We cannot turn off convergence testing because GMRES will break down if you attempt to keep iterating after a zero norm is obtained */
       ierr = KSPSetTolerances(cheb->kspest,1.e-12,PETSC_DEFAULT,PETSC_DEFAULT,cheb->eststeps);CHKERRQ(ierr);
+      cheb->estimated = PETSC_FALSE;
     }
     if (a >= 0) cheb->tform[0] = a;
     if (b >= 0) cheb->tform[1] = b;
@@ -84,6 +86,17 @@ static PetscErrorCode KSPChebyshevEstEigSetUseNoisy_Chebyshev(KSP ksp,PetscBool
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode KSPChebyshevEstEigSetLag_Chebyshev(KSP ksp,PetscInt lag)
+{
+  KSP_Chebyshev  *cheb = (KSP_Chebyshev*)ksp->data;
+
+  PetscFunctionBegin;
+  if (lag < -1 || !lag) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Lag must be -1 or positive, not %D",lag);
+  cheb->lag      = lag;
+  cheb->nchanges = 0;
+  PetscFunctionReturn(0);
+}
+
 /*@
    KSPChebyshevSetEigenvalues - Sets estimates for the extreme eigenvalues
    of the preconditioned problem.
@@ -191,6 +204,40 @@ PetscErrorCode KSPChebyshevEstEigSetUseNoisy(KSP ksp,PetscBool use)
   PetscFunctionReturn(0);
 }
 
+/*@
+   KSPChebyshevEstEigSetLag - Sets how often the eigenvalues are estimated again when the operators change
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - linear solver context
+-  lag - -1 to never estimate them again after the first estimate, 1 to estimate them each time the operators
+         change, 2 to estimate them every second time the operators change, etc.
+
+   Options Database:
+.  -ksp_chebyshev_esteig_lag <lag>
+
+   Notes:
+   The default is 1. Between two estimates the bounds are obtained by applying the transform of KSPChebyshevEstEigSet()
+   to the last estimate. This saves the iterations of the estimator when the operators change only a little between
+   two setups, for example when Chebyshev is the smoother of a PCMG whose operators are updated at each time step or
+   nonlinear iteration.
+
+   Level: intermediate
+
+.seealso: KSPChebyshevEstEigSet(), SNESSetLagPreconditioner()
+@*/
+PetscErrorCode KSPChebyshevEstEigSetLag(KSP ksp,PetscInt lag)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,lag,2);
+  ierr = PetscTryMethod(ksp,"KSPChebyshevEstEigSetLag_C",(KSP,PetscInt),(ksp,lag));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
   KSPChebyshevEstEigGetKSP - Get the Krylov method context used to estimate eigenvalues for the Chebyshev method.  If
   a Krylov method is not being used for this purpose, NULL is returned.  The reference count of the returned KSP is
@@ -233,11 +280,13 @@ static PetscErrorCode KSPSetFromOptions_Chebyshev(PetscOptionItems *PetscOptions
   PetscInt       neigarg = 2, nestarg = 4;
   PetscReal      eminmax[2] = {0., 0.};
   PetscReal      tform[4] = {PETSC_DECIDE,PETSC_DECIDE,PETSC_DECIDE,PETSC_DECIDE};
-  PetscBool      flgeig, flgest;
+  PetscInt       lag = cheb->lag;
+  PetscBool      flgeig, flgest, flglag;
 
   PetscFunctionBegin;
   ierr = PetscOptionsHead(PetscOptionsObject,"KSP Chebyshev Options");CHKERRQ(ierr);
   ierr = PetscOptionsInt("-ksp_chebyshev_esteig_steps","Number of est steps in Chebyshev","",cheb->eststeps,&cheb->eststeps,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-ksp_chebyshev_fused","Apply the polynomial with one pass over the vectors per step when the preconditioner is Jacobi","",cheb->fused,&cheb->fused,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsRealArray("-ksp_chebyshev_eigenvalues","extreme eigenvalues","KSPChebyshevSetEigenvalues",eminmax,&neigarg,&flgeig);CHKERRQ(ierr);
   if (flgeig) {
     if (neigarg != 2) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_INCOMP,"-ksp_chebyshev_eigenvalues: must specify 2 parameters, min and max eigenvalues");
@@ -266,6 +315,8 @@ static PetscErrorCode KSPSetFromOptions_Chebyshev(PetscOptionItems *PetscOptions
 
   if (cheb->kspest) {
     ierr = PetscOptionsBool("-ksp_chebyshev_esteig_noisy","Use noisy right hand side for estimate","KSPChebyshevEstEigSetUseNoisy",cheb->usenoisy,&cheb->usenoisy,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsInt("-ksp_chebyshev_esteig_lag","Estimate the eigenvalues again every lag-th change of the operators, -1 for never","KSPChebyshevEstEigSetLag",lag,&lag,&flglag);CHKERRQ(ierr);
+    if (flglag) {ierr = KSPChebyshevEstEigSetLag(ksp,lag);CHKERRQ(ierr);}
     ierr = KSPSetFromOptions(cheb->kspest);CHKERRQ(ierr);
   }
   ierr = PetscOptionsTail();CHKERRQ(ierr);
@@ -316,6 +367,7 @@ static PetscErrorCode KSPSolve_Chebyshev(KSP ksp)
   Vec            sol_orig,b,p[3],r;
   Mat            Amat,Pmat;
   PetscBool      diagonalscale;
+  Vec            diag = NULL;
 
   PetscFunctionBegin;
   ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
@@ -331,67 +383,73 @@ static PetscErrorCode KSPSolve_Chebyshev(KSP ksp)
     ierr = PetscObjectStateGet((PetscObject)Amat,&amatstate);CHKERRQ(ierr);
     ierr = PetscObjectStateGet((PetscObject)Pmat,&pmatstate);CHKERRQ(ierr);
     if (amatid != cheb->amatid || pmatid != cheb->pmatid || amatstate != cheb->amatstate || pmatstate != cheb->pmatstate) {
-      PetscReal          max=0.0,min=0.0;
-      Vec                B;
-      KSPConvergedReason reason;
+      if (cheb->estimated && (cheb->lag < 0 || ++cheb->nchanges < cheb->lag)) {
+        ierr = PetscInfo(ksp,"Using the eigenvalue estimates of previous operators\n");CHKERRQ(ierr);
+      } else {
+        PetscReal          max=0.0,min=0.0;
+        Vec                B;
+        KSPConvergedReason reason;
+
+        if (cheb->usenoisy) {
+          B  = ksp->work[1];
+          {
+            PetscErrorCode ierr;
+            PetscInt       n,i,istart;
+            PetscScalar    *xx;
+            ierr = VecGetOwnershipRange(B,&istart,NULL);CHKERRQ(ierr);
+            ierr = VecGetLocalSize(B,&n);CHKERRQ(ierr);
+            ierr = VecGetArrayWrite(B,&xx);CHKERRQ(ierr);
+            for (i=0; i<n; i++) {
+              PetscScalar v = chebyhash(i+istart);
+              xx[i] = v;
+            }
+            ierr = VecRestoreArrayWrite(B,&xx);CHKERRQ(ierr);
+          }
+        } else {
+          PC        pc;
+          PetscBool change;
 
-      if (cheb->usenoisy) {
-        B  = ksp->work[1];
-        {
-          PetscErrorCode ierr;
-          PetscInt       n,i,istart;
-          PetscScalar    *xx;
-          ierr = VecGetOwnershipRange(B,&istart,NULL);CHKERRQ(ierr);
-          ierr = VecGetLocalSize(B,&n);CHKERRQ(ierr);
-          ierr = VecGetArrayWrite(B,&xx);CHKERRQ(ierr);
-          for (i=0; i<n; i++) {
-            PetscScalar v = chebyhash(i+istart);
-            xx[i] = v;
+          ierr = KSPGetPC(cheb->kspest,&pc);CHKERRQ(ierr);
+          ierr = PCPreSolveChangeRHS(pc,&change);CHKERRQ(ierr);
+          if (change) {
+            B = ksp->work[1];
+            ierr = VecCopy(ksp->vec_rhs,B);CHKERRQ(ierr);
+          } else {
+            B = ksp->vec_rhs;
           }
-          ierr = VecRestoreArrayWrite(B,&xx);CHKERRQ(ierr);
         }
-      } else {
-        PC        pc;
-        PetscBool change;
-
-        ierr = KSPGetPC(cheb->kspest,&pc);CHKERRQ(ierr);
-        ierr = PCPreSolveChangeRHS(pc,&change);CHKERRQ(ierr);
-        if (change) {
-          B = ksp->work[1];
-          ierr = VecCopy(ksp->vec_rhs,B);CHKERRQ(ierr);
-        } else {
-          B = ksp->vec_rhs;
+        ierr = KSPSolve(cheb->kspest,B,ksp->work[0]);CHKERRQ(ierr);
+        ierr = KSPGetConvergedReason(cheb->kspest,&reason);CHKERRQ(ierr);
+        if (reason == KSP_DIVERGED_ITS) {
+            ierr = PetscInfo(ksp,"Eigen estimator ran for prescribed number of iterations\n");CHKERRQ(ierr);
+        } else if (reason == KSP_DIVERGED_PC_FAILED) {
+            PetscInt       its;
+            PCFailedReason pcreason;
+            PC             pc;
+
+            ierr = KSPGetIterationNumber(cheb->kspest,&its);CHKERRQ(ierr);
+            ierr = KSPGetPC(cheb->kspest,&pc);CHKERRQ(ierr);
+            ierr = PCGetFailedReason(pc,&pcreason);CHKERRQ(ierr);
+            if (!pcreason) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_PLIB,"KSP has KSP_DIVERGED_PC_FAILED but PC has no error flag");
+            ksp->reason = KSP_DIVERGED_PC_FAILED;
+            ierr = VecSetInf(ksp->vec_sol);CHKERRQ(ierr);
+            ierr = PetscInfo3(ksp,"Eigen estimator failed: %s %s at iteration %D",KSPConvergedReasons[reason],PCFailedReasons[pcreason],its);CHKERRQ(ierr);
+            PetscFunctionReturn(0);
+        } else if (reason==KSP_CONVERGED_RTOL ||reason==KSP_CONVERGED_ATOL) {
+          ierr = PetscInfo(ksp,"Eigen estimator converged prematurely. Should not happen except for small or low rank problem\n");CHKERRQ(ierr);
+        } else if (reason < 0) {
+          ierr = PetscInfo1(ksp,"Eigen estimator failed %s, using estimates anyway\n",KSPConvergedReasons[reason]);CHKERRQ(ierr);
         }
-      }
-      ierr = KSPSolve(cheb->kspest,B,ksp->work[0]);CHKERRQ(ierr);
-      ierr = KSPGetConvergedReason(cheb->kspest,&reason);CHKERRQ(ierr);
-      if (reason == KSP_DIVERGED_ITS) {
-          ierr = PetscInfo(ksp,"Eigen estimator ran for prescribed number of iterations\n");CHKERRQ(ierr);
-      } else if (reason == KSP_DIVERGED_PC_FAILED) {
-          PetscInt       its;
-          PCFailedReason pcreason;
-          PC             pc;
-
-          ierr = KSPGetIterationNumber(cheb->kspest,&its);CHKERRQ(ierr);
-          ierr = KSPGetPC(cheb->kspest,&pc);CHKERRQ(ierr);
-          ierr = PCGetFailedReason(pc,&pcreason);CHKERRQ(ierr);
-          if (!pcreason) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_PLIB,"KSP has KSP_DIVERGED_PC_FAILED but PC has no error flag");
-          ksp->reason = KSP_DIVERGED_PC_FAILED;
-          ierr = VecSetInf(ksp->vec_sol);CHKERRQ(ierr);
-          ierr = PetscInfo3(ksp,"Eigen estimator failed: %s %s at iteration %D",KSPConvergedReasons[reason],PCFailedReasons[pcreason],its);CHKERRQ(ierr);
-          PetscFunctionReturn(0);
-      } else if (reason==KSP_CONVERGED_RTOL ||reason==KSP_CONVERGED_ATOL) {
-        ierr = PetscInfo(ksp,"Eigen estimator converged prematurely. Should not happen except for small or low rank problem\n");CHKERRQ(ierr);
-      } else if (reason < 0) {
-        ierr = PetscInfo1(ksp,"Eigen estimator failed %s, using estimates anyway\n",KSPConvergedReasons[reason]);CHKERRQ(ierr);
-      }
 
-      ierr = KSPChebyshevComputeExtremeEigenvalues_Private(cheb->kspest,&min,&max);CHKERRQ(ierr);
+        ierr = KSPChebyshevComputeExtremeEigenvalues_Private(cheb->kspest,&min,&max);CHKERRQ(ierr);
 
-      cheb->emin_computed = min;
-      cheb->emax_computed = max;
-      cheb->emin = cheb->tform[0]*min + cheb->tform[1]*max;
-      cheb->emax = cheb->tform[2]*min + cheb->tform[3]*max;
+        cheb->emin_computed = min;
+        cheb->emax_computed = max;
+        cheb->estimated     = PETSC_TRUE;
+        cheb->nchanges      = 0;
+      }
+      cheb->emin = cheb->tform[0]*cheb->emin_computed + cheb->tform[1]*cheb->emax_computed;
+      cheb->emax = cheb->tform[2]*cheb->emin_computed + cheb->tform[3]*cheb->emax_computed;
 
       cheb->amatid    = amatid;
       cheb->pmatid    = pmatid;
@@ -467,15 +525,38 @@ static PetscErrorCode KSPSolve_Chebyshev(KSP ksp)
   ksp->its = 1;
   ierr   = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
 
+  /* with PCJACOBI the residual, its scaling and the update of the solution are done in one pass over the vectors */
+  if (cheb->fused && !ksp->transpose_solve) {
+    MatNullSpace nullsp;
+
+    ierr = MatGetNullSpace(Amat,&nullsp);CHKERRQ(ierr);
+    if (!nullsp) {ierr = PetscTryMethod(ksp->pc,"PCJacobiGetDiagonal_C",(PC,Vec*),(ksp->pc,&diag));CHKERRQ(ierr);}
+    if (diag && !cheb->fuse) {ierr = VecFuseCreate(PetscObjectComm((PetscObject)ksp),&cheb->fuse);CHKERRQ(ierr);}
+  }
+
   for (i=1; i<ksp->max_it; i++) {
     ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
     ksp->its++;
     ierr   = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
 
     ierr = KSP_MatMult(ksp,Amat,p[k],r);CHKERRQ(ierr);          /*  r = b - Ap[k]    */
-    ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
-    /* calculate residual norm if requested */
-    if (ksp->normtype) {
+    c[kp1] = 2.0*mu*c[k] - c[km1];
+    omega  = omegaprod*c[k]/c[kp1];
+    if (diag) {
+      ierr = VecFuseAYPX(cheb->fuse,r,-1.0,b);CHKERRQ(ierr);
+      if (ksp->normtype == KSP_NORM_UNPRECONDITIONED || ksp->normtype == KSP_NORM_NATURAL) {
+        ierr = VecFuseNorm(cheb->fuse,r,&rnorm);CHKERRQ(ierr);
+      }
+      ierr = VecFusePointwiseMult(cheb->fuse,p[kp1],diag,r);CHKERRQ(ierr);      /*  p[kp1] = B^{-1}r  */
+      if (ksp->normtype == KSP_NORM_PRECONDITIONED) {
+        ierr = VecFuseNorm(cheb->fuse,p[kp1],&rnorm);CHKERRQ(ierr);
+      }
+      /* y^{k+1} = omega(y^{k} - y^{k-1} + Gamma*r^{k}) + y^{k-1} */
+      ierr = VecFuseAXPBYPCZ(cheb->fuse,p[kp1],1.0-omega,omega,omega*Gamma*scale,p[km1],p[k]);CHKERRQ(ierr);
+      ierr = VecFuseExecute(cheb->fuse);CHKERRQ(ierr);
+    } else {
+      ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
+      /* calculate residual norm if requested */
       switch (ksp->normtype) {
       case KSP_NORM_PRECONDITIONED:
         ierr = KSP_PCApply(ksp,r,p[kp1]);CHKERRQ(ierr);             /*  p[kp1] = B^{-1}r  */
@@ -489,6 +570,8 @@ static PetscErrorCode KSPSolve_Chebyshev(KSP ksp)
         rnorm = 0.0;
         break;
       }
+    }
+    if (ksp->normtype) {
       KSPCheckNorm(ksp,rnorm);
       ierr         = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
       ksp->rnorm   = rnorm;
@@ -497,19 +580,15 @@ static PetscErrorCode KSPSolve_Chebyshev(KSP ksp)
       ierr = KSPMonitor(ksp,i,rnorm);CHKERRQ(ierr);
       ierr = (*ksp->converged)(ksp,i,rnorm,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
       if (ksp->reason) break;
+    }
+    ksp->vec_sol = p[k];
+    if (!diag) {
       if (ksp->normtype != KSP_NORM_PRECONDITIONED) {
         ierr = KSP_PCApply(ksp,r,p[kp1]);CHKERRQ(ierr);             /*  p[kp1] = B^{-1}r  */
       }
-    } else {
-      ierr = KSP_PCApply(ksp,r,p[kp1]);CHKERRQ(ierr);             /*  p[kp1] = B^{-1}r  */
+      /* y^{k+1} = omega(y^{k} - y^{k-1} + Gamma*r^{k}) + y^{k-1} */
+      ierr = VecAXPBYPCZ(p[kp1],1.0-omega,omega,omega*Gamma*scale,p[km1],p[k]);CHKERRQ(ierr);
     }
-    ksp->vec_sol = p[k];
-
-    c[kp1] = 2.0*mu*c[k] - c[km1];
-    omega  = omegaprod*c[k]/c[kp1];
-
-    /* y^{k+1} = omega(y^{k} - y^{k-1} + Gamma*r^{k}) + y^{k-1} */
-    ierr = VecAXPBYPCZ(p[kp1],1.0-omega,omega,omega*Gamma*scale,p[km1],p[k]);CHKERRQ(ierr);
 
     ktmp = km1;
     km1  = k;
@@ -575,6 +654,11 @@ static  PetscErrorCode KSPView_Chebyshev(KSP ksp,PetscViewer viewer)
       if (cheb->usenoisy) {
         ierr = PetscViewerASCIIPrintf(viewer,"  estimating eigenvalues using noisy right hand side\n");CHKERRQ(ierr);
       }
+      if (cheb->lag < 0) {
+        ierr = PetscViewerASCIIPrintf(viewer,"  eigenvalues are not estimated again when the operators change\n");CHKERRQ(ierr);
+      } else if (cheb->lag > 1) {
+        ierr = PetscViewerASCIIPrintf(viewer,"  eigenvalues estimated again every %D changes of the operators\n",cheb->lag);CHKERRQ(ierr);
+      }
     }
   }
   PetscFunctionReturn(0);
@@ -587,9 +671,11 @@ static PetscErrorCode KSPDestroy_Chebyshev(KSP ksp)
 
   PetscFunctionBegin;
   ierr = KSPDestroy(&cheb->kspest);CHKERRQ(ierr);
+  ierr = VecFuseDestroy(&cheb->fuse);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevSetEigenvalues_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSet_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSetUseNoisy_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSetLag_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigGetKSP_C",NULL);CHKERRQ(ierr);
   ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -604,7 +690,9 @@ static PetscErrorCode KSPDestroy_Chebyshev(KSP ksp)
 .   -ksp_chebyshev_esteig <a,b,c,d> - estimate eigenvalues using a Krylov method, then use this
                          transform for Chebyshev eigenvalue bounds (KSPChebyshevEstEigSet())
 .   -ksp_chebyshev_esteig_steps - number of estimation steps
--   -ksp_chebyshev_esteig_noisy - use noisy number generator to create right hand side for eigenvalue estimator
+.   -ksp_chebyshev_esteig_noisy - use noisy number generator to create right hand side for eigenvalue estimator
+.   -ksp_chebyshev_esteig_lag <lag> - estimate the eigenvalues again every lag-th time the operators change, -1 for never (KSPChebyshevEstEigSetLag())
+-   -ksp_chebyshev_fused - with PCJACOBI compute the residual, apply the preconditioner and update the solution in one pass over the vectors (off by default)
 
    Level: beginner
 
@@ -616,8 +704,11 @@ static PetscErrorCode KSPDestroy_Chebyshev(KSP ksp)
           Chebyshev is configured as a smoother by default, targetting the "upper" part of the spectrum.
           The user should call KSPChebyshevSetEigenvalues() if they have eigenvalue estimates.
 
+          With -ksp_chebyshev_fused the Jacobi scaling is done inside the fused pass over the vectors, so it is not
+          logged as PCApply in -log_view.
+
 .seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP,
-           KSPChebyshevSetEigenvalues(), KSPChebyshevEstEigSet(), KSPChebyshevEstEigSetUseNoisy()
+           KSPChebyshevSetEigenvalues(), KSPChebyshevEstEigSet(), KSPChebyshevEstEigSetUseNoisy(), KSPChebyshevEstEigSetLag()
            KSPRICHARDSON, KSPCG, PCMG
 
 M*/
@@ -645,6 +736,8 @@ PETSC_EXTERN PetscErrorCode KSPCreate_Chebyshev(KSP ksp)
   chebyshevP->tform[3] = 1.1;
   chebyshevP->eststeps = 10;
   chebyshevP->usenoisy = PETSC_TRUE;
+  chebyshevP->lag      = 1;
+  chebyshevP->fused    = PETSC_FALSE;
 
   ksp->ops->setup          = KSPSetUp_Chebyshev;
   ksp->ops->solve          = KSPSolve_Chebyshev;
@@ -658,6 +751,7 @@ PETSC_EXTERN PetscErrorCode KSPCreate_Chebyshev(KSP ksp)
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevSetEigenvalues_C",KSPChebyshevSetEigenvalues_Chebyshev);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSet_C",KSPChebyshevEstEigSet_Chebyshev);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSetUseNoisy_C",KSPChebyshevEstEigSetUseNoisy_Chebyshev);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSetLag_C",KSPChebyshevEstEigSetLag_Chebyshev);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigGetKSP_C",KSPChebyshevEstEigGetKSP_Chebyshev);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
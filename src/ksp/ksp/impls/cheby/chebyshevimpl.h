@@ -14,6 +14,11 @@ typedef struct {
   PetscReal        tform[4];     /* transform from Krylov estimates to Chebyshev bounds */
   PetscInt         eststeps;     /* number of kspest steps in KSP used to estimate eigenvalues */
   PetscBool        usenoisy;    /* use noisy right hand side vector to estimate eigenvalues */
+  PetscInt         lag;          /* estimate the eigenvalues again every lag-th time the operators change, -1 for never */
+  PetscInt         nchanges;     /* number of changes of the operators since the last estimate */
+  PetscBool        estimated;    /* emin_computed and emax_computed hold an estimate */
+  PetscBool        fused;        /* apply the polynomial with one pass over the vectors per step when the PC is Jacobi */
+  VecFuse          fuse;
   /* For tracking when to update the eigenvalue estimates */
   PetscObjectId    amatid,    pmatid;
   PetscObjectState amatstate, pmatstate;
@@ -1,14 +1,31 @@
 
 #include <petsc/private/kspimpl.h>
 
+typedef struct {
+  VecFuse fuse;   /* computes the vector updates and the reductions of an iteration in few passes over the vectors */
+} KSP_CR;
+
 static PetscErrorCode KSPSetUp_CR(KSP ksp)
 {
+  KSP_CR         *cr = (KSP_CR*)ksp->data;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
   if (ksp->pc_side == PC_RIGHT) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"no right preconditioning for KSPCR");
   else if (ksp->pc_side == PC_SYMMETRIC) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"no symmetric preconditioning for KSPCR");
   ierr = KSPSetWorkVecs(ksp,6);CHKERRQ(ierr);
+  if (!cr->fuse) {ierr = VecFuseCreate(PetscObjectComm((PetscObject)ksp),&cr->fuse);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_CR(KSP ksp)
+{
+  KSP_CR         *cr = (KSP_CR*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecFuseDestroy(&cr->fuse);CHKERRQ(ierr);
+  ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -21,6 +38,7 @@ static PetscErrorCode  KSPSolve_CR(KSP ksp)
   PetscScalar    apq,btop, bbot;
   Vec            X,B,R,RT,P,AP,ART,Q;
   Mat            Amat, Pmat;
+  VecFuse        fuse = ((KSP_CR*)ksp->data)->fuse;
 
   PetscFunctionBegin;
   X   = ksp->vec_sol;
@@ -44,22 +62,21 @@ static PetscErrorCode  KSPSolve_CR(KSP ksp)
   ierr = KSP_MatMult(ksp,Amat,P,AP);CHKERRQ(ierr);      /*   AP  <- A*P         */
   ierr = VecCopy(P,RT);CHKERRQ(ierr);                   /*   RT  <- P           */
   ierr = VecCopy(AP,ART);CHKERRQ(ierr);                 /*   ART <- AP          */
-  ierr = VecDotBegin(RT,ART,&btop);CHKERRQ(ierr);          /*   (RT,ART)           */
+  ierr = VecFuseDot(fuse,RT,ART,&btop);CHKERRQ(ierr);      /*   (RT,ART)           */
 
   if (ksp->normtype == KSP_NORM_PRECONDITIONED) {
-    ierr = VecNormBegin(RT,NORM_2,&dp);CHKERRQ(ierr);        /*   dp <- RT'*RT       */
-    ierr = VecDotEnd   (RT,ART,&btop);CHKERRQ(ierr);           /*   (RT,ART)           */
-    ierr = VecNormEnd  (RT,NORM_2,&dp);CHKERRQ(ierr);        /*   dp <- RT'*RT       */
+    ierr = VecFuseNorm(fuse,RT,&dp);CHKERRQ(ierr);           /*   dp <- RT'*RT       */
+    ierr = VecFuseExecute(fuse);CHKERRQ(ierr);
     KSPCheckNorm(ksp,dp);
   } else if (ksp->normtype == KSP_NORM_NONE) {
-      dp   = 0.0; /* meaningless value that is passed to monitor and convergence test */
+    ierr = VecFuseExecute(fuse);CHKERRQ(ierr);
+    dp   = 0.0; /* meaningless value that is passed to monitor and convergence test */
   } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {
-    ierr = VecNormBegin(R,NORM_2,&dp);CHKERRQ(ierr);         /*   dp <- R'*R         */
-    ierr = VecDotEnd   (RT,ART,&btop);CHKERRQ(ierr);          /*   (RT,ART)           */
-    ierr = VecNormEnd  (R,NORM_2,&dp);CHKERRQ(ierr);        /*   dp <- RT'*RT       */
+    ierr = VecFuseNorm(fuse,R,&dp);CHKERRQ(ierr);            /*   dp <- R'*R         */
+    ierr = VecFuseExecute(fuse);CHKERRQ(ierr);
     KSPCheckNorm(ksp,dp);
   } else if (ksp->normtype == KSP_NORM_NATURAL) {
-    ierr = VecDotEnd   (RT,ART,&btop);CHKERRQ(ierr);           /*   (RT,ART)           */
+    ierr = VecFuseExecute(fuse);CHKERRQ(ierr);
     dp   = PetscSqrtReal(PetscAbsScalar(btop));                  /* dp = sqrt(R,AR)      */
   } else SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"KSPNormType of %d not supported",(int)ksp->normtype);
   if (PetscAbsScalar(btop) < 0.0) {
@@ -90,28 +107,27 @@ static PetscErrorCode  KSPSolve_CR(KSP ksp)
     }
     ai = btop/apq;                                      /* ai = (RT,ART)/(AP,Q)  */
 
-    ierr = VecAXPY(X,ai,P);CHKERRQ(ierr);              /*   X   <- X + ai*P     */
-    ierr = VecAXPY(RT,-ai,Q);CHKERRQ(ierr);             /*   RT  <- RT - ai*Q    */
+    ierr = VecFuseAXPY(fuse,X,ai,P);CHKERRQ(ierr);     /*   X   <- X + ai*P     */
+    ierr = VecFuseAXPY(fuse,RT,-ai,Q);CHKERRQ(ierr);    /*   RT  <- RT - ai*Q    */
+    ierr = VecFuseExecute(fuse);CHKERRQ(ierr);
     ierr = KSP_MatMult(ksp,Amat,RT,ART);CHKERRQ(ierr);  /*   ART <-   A*RT       */
     bbot = btop;
-    ierr = VecDotBegin(RT,ART,&btop);CHKERRQ(ierr);
+    ierr = VecFuseDot(fuse,RT,ART,&btop);CHKERRQ(ierr);
 
     if (ksp->normtype == KSP_NORM_PRECONDITIONED) {
-      ierr = VecNormBegin(RT,NORM_2,&dp);CHKERRQ(ierr);      /*   dp <- || RT ||      */
-      ierr = VecDotEnd   (RT,ART,&btop);CHKERRQ(ierr);
-      ierr = VecNormEnd  (RT,NORM_2,&dp);CHKERRQ(ierr);      /*   dp <- || RT ||      */
+      ierr = VecFuseNorm(fuse,RT,&dp);CHKERRQ(ierr);         /*   dp <- || RT ||      */
+      ierr = VecFuseExecute(fuse);CHKERRQ(ierr);
       KSPCheckNorm(ksp,dp);
     } else if (ksp->normtype == KSP_NORM_NATURAL) {
-      ierr = VecDotEnd(RT,ART,&btop);CHKERRQ(ierr);
+      ierr = VecFuseExecute(fuse);CHKERRQ(ierr);
       dp   = PetscSqrtReal(PetscAbsScalar(btop));                /* dp = sqrt(R,AR)       */
     } else if (ksp->normtype == KSP_NORM_NONE) {
-      ierr = VecDotEnd(RT,ART,&btop);CHKERRQ(ierr);
+      ierr = VecFuseExecute(fuse);CHKERRQ(ierr);
       dp   = 0.0; /* meaningless value that is passed to monitor and convergence test */
     } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {
-      ierr = VecAXPY(R,ai,AP);CHKERRQ(ierr);           /*   R   <- R - ai*AP    */
-      ierr = VecNormBegin(R,NORM_2,&dp);CHKERRQ(ierr);       /*   dp <- R'*R          */
-      ierr = VecDotEnd   (RT,ART,&btop);CHKERRQ(ierr);
-      ierr = VecNormEnd  (R,NORM_2,&dp);CHKERRQ(ierr);       /*   dp <- R'*R          */
+      ierr = VecFuseAXPY(fuse,R,ai,AP);CHKERRQ(ierr);        /*   R   <- R - ai*AP    */
+      ierr = VecFuseNorm(fuse,R,&dp);CHKERRQ(ierr);          /*   dp <- R'*R          */
+      ierr = VecFuseExecute(fuse);CHKERRQ(ierr);
       KSPCheckNorm(ksp,dp);
     } else SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"KSPNormType of %d not supported",(int)ksp->normtype);
     if (PetscAbsScalar(btop) < 0.0) {
@@ -131,8 +147,9 @@ static PetscErrorCode  KSPSolve_CR(KSP ksp)
     if (ksp->reason) break;
 
     bi   = btop/bbot;
-    ierr = VecAYPX(P,bi,RT);CHKERRQ(ierr);              /*   P <- RT + Bi P     */
-    ierr = VecAYPX(AP,bi,ART);CHKERRQ(ierr);            /*   AP <- ART + Bi AP  */
+    ierr = VecFuseAYPX(fuse,P,bi,RT);CHKERRQ(ierr);     /*   P <- RT + Bi P     */
+    ierr = VecFuseAYPX(fuse,AP,bi,ART);CHKERRQ(ierr);   /*   AP <- ART + Bi AP  */
+    ierr = VecFuseExecute(fuse);CHKERRQ(ierr);
     i++;
   } while (i<ksp->max_it);
   if (i >= ksp->max_it) ksp->reason =  KSP_DIVERGED_ITS;
@@ -161,9 +178,12 @@ static PetscErrorCode  KSPSolve_CR(KSP ksp)
 M*/
 PETSC_EXTERN PetscErrorCode KSPCreate_CR(KSP ksp)
 {
+  KSP_CR         *cr;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  ierr      = PetscNewLog(ksp,&cr);CHKERRQ(ierr);
+  ksp->data = (void*)cr;
   ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
   ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_LEFT,2);CHKERRQ(ierr);
   ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NATURAL,PC_LEFT,2);CHKERRQ(ierr);
@@ -171,7 +191,7 @@ PETSC_EXTERN PetscErrorCode KSPCreate_CR(KSP ksp)
 
   ksp->ops->setup          = KSPSetUp_CR;
   ksp->ops->solve          = KSPSolve_CR;
-  ksp->ops->destroy        = KSPDestroyDefault;
+  ksp->ops->destroy        = KSPDestroy_CR;
   ksp->ops->buildsolution  = KSPBuildSolutionDefault;
   ksp->ops->buildresidual  = KSPBuildResidualDefault;
   ksp->ops->setfromoptions = 0;
@@ -38,7 +38,7 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
   PetscErrorCode ierr;
   PetscInt       j;
   PetscScalar    *hh,*hes,*lhh;
-  PetscReal      hnrm, wnrm;
+  PetscReal      hnrm, wnrm = 0.0;
   PetscBool      refine = (PetscBool)(gmres->cgstype == KSP_GMRES_CGS_REFINE_ALWAYS);
 
   PetscFunctionBegin;
@@ -62,7 +62,15 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
      This is really a matrix-vector product, with the matrix stored
      as pointer to rows
   */
-  ierr = VecMDot(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr); /* <v,vnew> */
+  if (gmres->orthognorm && gmres->cgstype == KSP_GMRES_CGS_REFINE_NEVER) {
+    /* the norm of vnew before the orthogonalization shares the reduction, see below */
+    ierr = VecMDotBegin(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr);
+    ierr = VecNormBegin(VEC_VV(it+1),NORM_2,&wnrm);CHKERRQ(ierr);
+    ierr = VecMDotEnd(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr);
+    ierr = VecNormEnd(VEC_VV(it+1),NORM_2,&wnrm);CHKERRQ(ierr);
+  } else {
+    ierr = VecMDot(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr); /* <v,vnew> */
+  }
   for (j=0; j<=it; j++) {
     KSPCheckDot(ksp,lhh[j]);
     lhh[j] = -lhh[j];
@@ -79,6 +87,17 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
     hes[j] -= lhh[j];     /* hes += <v,vnew> */
   }
 
+  /*
+     Since the basis is orthonormal the norm of the orthogonalized vnew is sqrt(|vnew|^2 - sum |<v,vnew>|^2), which
+     saves the reduction of its norm. It is only used when there is little cancellation, otherwise the caller computes
+     the norm
+  */
+  if (gmres->orthognorm && gmres->cgstype == KSP_GMRES_CGS_REFINE_NEVER) {
+    hnrm = 0.0;
+    for (j=0; j<=it; j++) hnrm += PetscRealPart(lhh[j] * PetscConj(lhh[j]));
+    if (wnrm*wnrm - hnrm > 0.01*wnrm*wnrm) gmres->orthognrm = PetscSqrtReal(wnrm*wnrm - hnrm);
+  }
+
   /*
    *  the second step classical Gram-Schmidt is only necessary
    *  when a simple test criteria is not passed
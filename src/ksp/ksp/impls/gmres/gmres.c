@@ -152,11 +152,18 @@ PetscErrorCode KSPGMRESCycle(PetscInt *itcount,KSP ksp)
     ierr = KSP_PCApplyBAorAB(ksp,VEC_VV(it),VEC_VV(1+it),VEC_TEMP_MATOP);CHKERRQ(ierr);
 
     /* update hessenberg matrix and do Gram-Schmidt */
+    gmres->orthognorm = ksp->lagnorm;
+    gmres->orthognrm  = -1.0;
     ierr = (*gmres->orthog)(ksp,it);CHKERRQ(ierr);
     if (ksp->reason) break;
 
     /* vv(i+1) . vv(i+1) */
-    ierr = VecNormalize(VEC_VV(it+1),&tt);CHKERRQ(ierr);
+    if (gmres->orthognrm >= 0.0) {
+      tt   = gmres->orthognrm;
+      ierr = VecScale(VEC_VV(it+1),1.0/tt);CHKERRQ(ierr);
+    } else {
+      ierr = VecNormalize(VEC_VV(it+1),&tt);CHKERRQ(ierr);
+    }
     KSPCheckNorm(ksp,tt);
 
     /* save the magnitude */
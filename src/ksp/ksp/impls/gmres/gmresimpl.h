@@ -30,6 +30,8 @@
                                                                         \
   PetscErrorCode (*orthog)(KSP,PetscInt);                    \
   KSPGMRESCGSRefinementType cgstype;                                    \
+  PetscBool orthognorm;       /* the orthogonalization may also compute the norm of the new vector */ \
+  PetscReal orthognrm;        /* that norm, negative if it was not computed */ \
                                                                         \
   Vec      *vecs;                                        /* the work vectors */ \
   Vec      *vecb;                                        /* holds the last full basis vectors of the Krylov subspace to compute (harmonic) Ritz pairs */ \
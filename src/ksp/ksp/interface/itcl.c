@@ -291,7 +291,8 @@ PetscErrorCode  KSPMonitorSetFromOptions(KSP ksp,const char name[],const char he
        works only for PCBCGS, PCIBCGS and and PCCG
 .   -ksp_lag_norm - compute the norm of the residual for the ith iteration on the i+1 iteration; this means that one can use
        the norm of the residual for convergence test WITHOUT an extra MPI_Allreduce() limiting global synchronizations.
-       This will require 1 more iteration of the solver than usual.
+       This will require 1 more iteration of the solver than usual. Works for KSPIBCGS, KSPCG, KSPBCGS and KSPGMRES, see KSPSetLagNorm()
+.   -ksp_lag_norm_default - lag the residual norm of every KSP, whatever its options prefix, unless -ksp_lag_norm is given for it
 .   -ksp_guess_type - Type of initial guess generator for repeated linear solves
 .   -ksp_fischer_guess <model,size> - uses the Fischer initial guess generator for repeated linear solves
 .   -ksp_constant_null_space - assume the operator (matrix) has the constant vector in its null space
@@ -336,6 +337,13 @@ PetscErrorCode  KSPSetFromOptions(KSP ksp)
   }
 
   ierr = KSPRegisterAll();CHKERRQ(ierr);
+  /* Without the options prefix of the KSP so that one option reaches all the solvers; -ksp_lag_norm below overrides it */
+  ierr = PetscOptionsBegin(comm,NULL,"Krylov Method (KSP) defaults","KSP");CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-ksp_lag_norm_default","Lag the calculation of the residual norm of all the KSP","KSPSetLagNorm",ksp->lagnorm,&flag,&flg);CHKERRQ(ierr);
+  if (flg) {
+    ierr = KSPSetLagNorm(ksp,flag);CHKERRQ(ierr);
+  }
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
   ierr = PetscObjectOptionsBegin((PetscObject)ksp);CHKERRQ(ierr);
   ierr = PetscOptionsFList("-ksp_type","Krylov method","KSPSetType",KSPList,(char*)(((PetscObject)ksp)->type_name ? ((PetscObject)ksp)->type_name : KSPGMRES),type,256,&flg);CHKERRQ(ierr);
   if (flg) {
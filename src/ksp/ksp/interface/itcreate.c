@@ -334,10 +334,19 @@ PetscErrorCode  KSPSetCheckNormIteration(KSP ksp,PetscInt it)
 -  flg - PETSC_TRUE or PETSC_FALSE
 
    Options Database Keys:
-.  -ksp_lag_norm - lag the calculated residual norm
++  -ksp_lag_norm - lag the calculated residual norm
+-  -ksp_lag_norm_default - lag the residual norm of all the KSP that call KSPSetFromOptions(), whatever their options prefix
 
    Notes:
-   Currently only works with KSPIBCGS.
+   Works with KSPIBCGS, KSPCG, KSPBCGS and KSPGMRES, other methods ignore it.
+
+   KSPCG computes the norm in the same reduction as the inner product that follows the application of the
+   preconditioner and updates the solution while that reduction is in progress. KSPBCGS computes the norm of the
+   residual of an iterate in the first reduction of the next iteration and tests the convergence there, it has
+   one global reduction less per iteration. KSPGMRES with classical Gram-Schmidt and no refinement obtains the norm
+   of the new Krylov vector from the reduction of the orthogonalization, which is less accurate than computing it
+   when the basis loses orthogonality. For KSPCG and KSPBCGS the iterates are the same as without lagging up to
+   rounding, but a converged solve may do some extra work that is discarded.
 
    Use KSPSetNormType(ksp,KSP_NORM_NONE) to never check the norm
 
@@ -697,6 +706,7 @@ PetscErrorCode  KSPCreate(MPI_Comm comm,KSP *inksp)
   ksp->divtol  = 1.e4;
 
   ksp->chknorm        = -1;
+  ksp->lagnorm        = PETSC_FALSE;
   ksp->normtype       = ksp->normtype_set = KSP_NORM_DEFAULT;
   ksp->rnorm          = 0.0;
   ksp->its            = 0;
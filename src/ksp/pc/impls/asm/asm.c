@@ -11,6 +11,10 @@
 */
 #include <petsc/private/pcimpl.h>     /*I "petscpc.h" I*/
 #include <petscdm.h>
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+#include <omp.h>
+extern PetscInt PetscNumOMPThreads;
+#endif
 
 typedef struct {
   PetscInt   n, n_local, n_local_true;
@@ -30,12 +34,25 @@ typedef struct {
   PetscBool  same_local_solves;   /* flag indicating whether all local solvers are same */
   PetscBool  sort_indices;        /* flag to sort subdomain indices */
   PetscBool  dm_subdomains;       /* whether DM is allowed to define subdomains */
+  PetscBool  threaded_blocks;     /* solve the local blocks concurrently on OpenMP threads */
   PCCompositeType loctype;        /* the type of composition for local solves */
   MatType    sub_mat_type;        /* the type of Mat used for subdomain solves (can be MATSAME or NULL) */
   /* For multiplicative solve */
   Mat       *lmats;               /* submatrices for overlapping multiplicative (process) subdomain */
 } PC_ASM;
 
+/*
+   Number of threads the local blocks are solved on, 1 if they are solved one after the other.
+   Calling KSPSolve() from several threads at once requires PETSc configured --with-threadsafety.
+*/
+static PetscInt PCASMGetNumThreads_Private(PC_ASM *osm)
+{
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+  if (osm->threaded_blocks && osm->n_local_true > 1) return PetscMin(PetscMax(PetscNumOMPThreads,1),osm->n_local_true);
+#endif
+  return 1;
+}
+
 static PetscErrorCode PCView_ASM(PC pc,PetscViewer viewer)
 {
   PC_ASM         *osm = (PC_ASM*)pc->data;
@@ -56,6 +73,7 @@ static PetscErrorCode PCView_ASM(PC pc,PetscViewer viewer)
     ierr = PetscViewerASCIIPrintf(viewer,"  restriction/interpolation type - %s\n",PCASMTypes[osm->type]);CHKERRQ(ierr);
     if (osm->dm_subdomains) {ierr = PetscViewerASCIIPrintf(viewer,"  Additive Schwarz: using DM to define subdomains\n");CHKERRQ(ierr);}
     if (osm->loctype != PC_COMPOSITE_ADDITIVE) {ierr = PetscViewerASCIIPrintf(viewer,"  Additive Schwarz: local solve composition type - %s\n",PCCompositeTypes[osm->loctype]);CHKERRQ(ierr);}
+    if (PCASMGetNumThreads_Private(osm) > 1) {ierr = PetscViewerASCIIPrintf(viewer,"  Additive Schwarz: local blocks handled concurrently on %D threads\n",PCASMGetNumThreads_Private(osm));CHKERRQ(ierr);}
     ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)pc),&rank);CHKERRQ(ierr);
     if (osm->same_local_solves) {
       if (osm->ksp) {
@@ -450,6 +468,7 @@ static PetscErrorCode PCSetUpOnBlocks_ASM(PC pc)
   KSPConvergedReason reason;
 
   PetscFunctionBegin;
+  /* the blocks are set up one after the other even with -pc_asm_threaded_blocks, the factorizations create PETSc objects */
   for (i=0; i<osm->n_local_true; i++) {
     ierr = KSPSetUp(osm->ksp[i]);CHKERRQ(ierr);
     ierr = KSPGetConvergedReason(osm->ksp[i],&reason);CHKERRQ(ierr);
@@ -460,11 +479,54 @@ static PetscErrorCode PCSetUpOnBlocks_ASM(PC pc)
   PetscFunctionReturn(0);
 }
 
+/*
+   The additive local composition (or its transpose) with the blocks distributed over nt threads. The right hand sides of
+   all the blocks are restricted from osm->lx before the threads start, since a scatter from osm->lx changes its read lock;
+   each thread then solves its blocks, whose solutions are added to osm->ly one block at a time, so a thread adds its block
+   while the other threads are still solving theirs.
+*/
+static PetscErrorCode PCASMApplyBlocksThreaded_Private(PC pc,PetscInt nt,ScatterMode forward,ScatterMode reverse,PetscBool transpose)
+{
+  PC_ASM         *osm = (PC_ASM*)pc->data;
+  PetscErrorCode ierr = 0;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  for (i=0; i<osm->n_local_true; i++) {
+    ierr = VecScatterBegin(osm->lrestriction[i],osm->lx,osm->x[i],INSERT_VALUES,forward);CHKERRQ(ierr);
+    ierr = VecScatterEnd(osm->lrestriction[i],osm->lx,osm->x[i],INSERT_VALUES,forward);CHKERRQ(ierr);
+  }
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+#pragma omp parallel for num_threads(nt) schedule(dynamic,1)
+#endif
+  for (i=0; i<osm->n_local_true; i++) {
+    PetscErrorCode berr;
+
+    berr = transpose ? KSPSolveTranspose(osm->ksp[i],osm->x[i],osm->y[i]) : KSPSolve(osm->ksp[i],osm->x[i],osm->y[i]);
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+#pragma omp critical (PCASMBlocks)
+#endif
+    {
+      if (!berr) berr = KSPCheckSolve(osm->ksp[i],pc,osm->y[i]);
+      if (osm->lprolongation) {
+        if (!berr) berr = VecScatterBegin(osm->lprolongation[i],osm->y[i],osm->ly,ADD_VALUES,forward);
+        if (!berr) berr = VecScatterEnd(osm->lprolongation[i],osm->y[i],osm->ly,ADD_VALUES,forward);
+      } else {
+        if (!berr) berr = VecScatterBegin(osm->lrestriction[i],osm->y[i],osm->ly,ADD_VALUES,reverse);
+        if (!berr) berr = VecScatterEnd(osm->lrestriction[i],osm->y[i],osm->ly,ADD_VALUES,reverse);
+      }
+      if (berr && !ierr) ierr = berr;
+    }
+  }
+  CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode PCApply_ASM(PC pc,Vec x,Vec y)
 {
   PC_ASM         *osm = (PC_ASM*)pc->data;
   PetscErrorCode ierr;
-  PetscInt       i,n_local_true = osm->n_local_true;
+  PetscInt       i,n_local_true = osm->n_local_true,nt = PCASMGetNumThreads_Private(osm);
   ScatterMode    forward = SCATTER_FORWARD,reverse = SCATTER_REVERSE;
 
   PetscFunctionBegin;
@@ -490,6 +552,13 @@ static PetscErrorCode PCApply_ASM(PC pc,Vec x,Vec y)
     ierr = VecScatterBegin(osm->restriction, x, osm->lx, INSERT_VALUES, forward);CHKERRQ(ierr);
     ierr = VecScatterEnd(osm->restriction, x, osm->lx, INSERT_VALUES, forward);CHKERRQ(ierr);
 
+    if (nt > 1 && osm->loctype == PC_COMPOSITE_ADDITIVE) {
+      ierr = PCASMApplyBlocksThreaded_Private(pc,nt,forward,reverse,PETSC_FALSE);CHKERRQ(ierr);
+      ierr = VecScatterBegin(osm->restriction, osm->ly, y, ADD_VALUES, reverse);CHKERRQ(ierr);
+      ierr = VecScatterEnd(osm->restriction, osm->ly, y, ADD_VALUES, reverse);CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+
     /* Restrict local RHS to the overlapping 0-block RHS */
     ierr = VecScatterBegin(osm->lrestriction[0], osm->lx, osm->x[0], INSERT_VALUES, forward);CHKERRQ(ierr);
     ierr = VecScatterEnd(osm->lrestriction[0], osm->lx, osm->x[0],  INSERT_VALUES, forward);CHKERRQ(ierr);
@@ -537,7 +606,7 @@ static PetscErrorCode PCApplyTranspose_ASM(PC pc,Vec x,Vec y)
 {
   PC_ASM         *osm = (PC_ASM*)pc->data;
   PetscErrorCode ierr;
-  PetscInt       i,n_local_true = osm->n_local_true;
+  PetscInt       i,n_local_true = osm->n_local_true,nt = PCASMGetNumThreads_Private(osm);
   ScatterMode    forward = SCATTER_FORWARD,reverse = SCATTER_REVERSE;
 
   PetscFunctionBegin;
@@ -564,6 +633,14 @@ static PetscErrorCode PCApplyTranspose_ASM(PC pc,Vec x,Vec y)
   ierr = VecScatterBegin(osm->restriction, x, osm->lx, INSERT_VALUES, forward);CHKERRQ(ierr);
   ierr = VecScatterEnd(osm->restriction, x, osm->lx, INSERT_VALUES, forward);CHKERRQ(ierr);
 
+  /* the transposed blocks are always composed additively */
+  if (nt > 1) {
+    ierr = PCASMApplyBlocksThreaded_Private(pc,nt,forward,reverse,PETSC_TRUE);CHKERRQ(ierr);
+    ierr = VecScatterBegin(osm->restriction, osm->ly, y, ADD_VALUES, reverse);CHKERRQ(ierr);
+    ierr = VecScatterEnd(osm->restriction, osm->ly, y, ADD_VALUES, reverse);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
   /* Restrict local RHS to the overlapping 0-block RHS */
   ierr = VecScatterBegin(osm->lrestriction[0], osm->lx, osm->x[0], INSERT_VALUES, forward);CHKERRQ(ierr);
   ierr = VecScatterEnd(osm->lrestriction[0], osm->lx, osm->x[0],  INSERT_VALUES, forward);CHKERRQ(ierr);
@@ -707,6 +784,10 @@ static PetscErrorCode PCSetFromOptions_ASM(PetscOptionItems *PetscOptionsObject,
   if(flg){
     ierr = PCASMSetSubMatType(pc,sub_mat_type);CHKERRQ(ierr);
   }
+  ierr = PetscOptionsBool("-pc_asm_threaded_blocks","Solve the local blocks concurrently on the -omp_num_threads threads","None",osm->threaded_blocks,&osm->threaded_blocks,NULL);CHKERRQ(ierr);
+#if !defined(PETSC_HAVE_OPENMP) || !defined(PETSC_HAVE_THREADSAFETY)
+  if (osm->threaded_blocks) {ierr = PetscInfo(pc,"Solving the local blocks one after the other, -pc_asm_threaded_blocks requires PETSc configured --with-openmp --with-threadsafety\n");CHKERRQ(ierr);}
+#endif
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -801,6 +882,16 @@ static PetscErrorCode  PCASMSetOverlap_ASM(PC pc,PetscInt ovl)
   PetscFunctionReturn(0);
 }
 
+/* PCMG gives the same overlap to the smoothers of the levels it moves onto fewer processes */
+static PetscErrorCode  PCASMGetOverlap_ASM(PC pc,PetscInt *ovl)
+{
+  PC_ASM *osm = (PC_ASM*)pc->data;
+
+  PetscFunctionBegin;
+  *ovl = osm->overlap;
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode  PCASMSetType_ASM(PC pc,PCASMType type)
 {
   PC_ASM *osm = (PC_ASM*)pc->data;
@@ -1249,7 +1340,8 @@ PetscErrorCode  PCASMGetSubKSP(PC pc,PetscInt *n_local,PetscInt *first_local,KSP
 +  -pc_asm_blocks <blks> - Sets total blocks
 .  -pc_asm_overlap <ovl> - Sets overlap
 .  -pc_asm_type [basic,restrict,interpolate,none] - Sets ASM type, default is restrict
--  -pc_asm_local_type [additive, multiplicative] - Sets ASM type, default is additive
+.  -pc_asm_local_type [additive, multiplicative] - Sets ASM type, default is additive
+-  -pc_asm_threaded_blocks - Solves the local blocks concurrently on the -omp_num_threads threads
 
      IMPORTANT: If you run with, for example, 3 blocks on 1 processor or 3 blocks on 3 processors you
       will get a different convergence rate due to the default option of -pc_asm_type restrict. Use
@@ -1266,6 +1358,13 @@ PetscErrorCode  PCASMGetSubKSP(PC pc,PetscInt *n_local,PetscInt *first_local,KSP
          and set the options directly on the resulting KSP object (you can access its PC
          with KSPGetPC())
 
+     With -pc_asm_threaded_blocks a process owning several blocks solves them concurrently on OpenMP threads (they are
+         still factored one after the other),
+         so one process per socket with many blocks can replace one process per block. This requires PETSc configured
+         --with-openmp --with-threadsafety and the additive local composition, except for PCApplyTranspose() whose blocks are
+         always composed additively; the solutions of overlapping blocks are then summed in an order that may change from
+         one application to the next.
+
    Level: beginner
 
     References:
@@ -1323,6 +1422,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_ASM(PC pc)
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMSetLocalSubdomains_C",PCASMSetLocalSubdomains_ASM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMSetTotalSubdomains_C",PCASMSetTotalSubdomains_ASM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMSetOverlap_C",PCASMSetOverlap_ASM);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMGetOverlap_C",PCASMGetOverlap_ASM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMSetType_C",PCASMSetType_ASM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMGetType_C",PCASMGetType_ASM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMSetLocalType_C",PCASMSetLocalType_ASM);CHKERRQ(ierr);
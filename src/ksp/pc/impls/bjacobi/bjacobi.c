@@ -4,11 +4,27 @@
 */
 
 #include <../src/ksp/pc/impls/bjacobi/bjacobi.h> /*I "petscpc.h" I*/
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+#include <omp.h>
+extern PetscInt PetscNumOMPThreads;
+#endif
 
 static PetscErrorCode PCSetUp_BJacobi_Singleblock(PC,Mat,Mat);
 static PetscErrorCode PCSetUp_BJacobi_Multiblock(PC,Mat,Mat);
 static PetscErrorCode PCSetUp_BJacobi_Multiproc(PC);
 
+/*
+   Number of threads the local blocks are solved on, 1 if they are solved one after the other.
+   Calling KSPSolve() from several threads at once requires PETSc configured --with-threadsafety.
+*/
+static PetscInt PCBJacobiGetNumThreads_Private(PC_BJacobi *jac)
+{
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+  if (jac->threaded_blocks && jac->n_local > 1 && !jac->psubcomm) return PetscMin(PetscMax(PetscNumOMPThreads,1),jac->n_local);
+#endif
+  return 1;
+}
+
 static PetscErrorCode PCSetUp_BJacobi(PC pc)
 {
   PC_BJacobi     *jac = (PC_BJacobi*)pc->data;
@@ -167,6 +183,10 @@ static PetscErrorCode PCSetFromOptions_BJacobi(PetscOptionItems *PetscOptionsObj
   if (flg) {ierr = PCBJacobiSetTotalBlocks(pc,blocks,NULL);CHKERRQ(ierr);}
   ierr = PetscOptionsInt("-pc_bjacobi_local_blocks","Local number of blocks","PCBJacobiSetLocalBlocks",jac->n_local,&blocks,&flg);CHKERRQ(ierr);
   if (flg) {ierr = PCBJacobiSetLocalBlocks(pc,blocks,NULL);CHKERRQ(ierr);}
+  ierr = PetscOptionsBool("-pc_bjacobi_threaded_blocks","Solve the local blocks concurrently on the -omp_num_threads threads","None",jac->threaded_blocks,&jac->threaded_blocks,NULL);CHKERRQ(ierr);
+#if !defined(PETSC_HAVE_OPENMP) || !defined(PETSC_HAVE_THREADSAFETY)
+  if (jac->threaded_blocks) {ierr = PetscInfo(pc,"Solving the local blocks one after the other, -pc_bjacobi_threaded_blocks requires PETSc configured --with-openmp --with-threadsafety\n");CHKERRQ(ierr);}
+#endif
   if (jac->ksp) {
     /* The sub-KSP has already been set up (e.g., PCSetUp_BJacobi_Singleblock), but KSPSetFromOptions was not called
      * unless we had already been called. */
@@ -198,6 +218,7 @@ static PetscErrorCode PCView_BJacobi(PC pc,PetscViewer viewer)
       ierr = PetscViewerASCIIPrintf(viewer,"  using Amat local matrix, number of blocks = %D\n",jac->n);CHKERRQ(ierr);
     }
     ierr = PetscViewerASCIIPrintf(viewer,"  number of blocks = %D\n",jac->n);CHKERRQ(ierr);
+    if (PCBJacobiGetNumThreads_Private(jac) > 1) {ierr = PetscViewerASCIIPrintf(viewer,"  local blocks handled concurrently on %D threads\n",PCBJacobiGetNumThreads_Private(jac));CHKERRQ(ierr);}
     ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)pc),&rank);CHKERRQ(ierr);
     if (jac->same_local_solves) {
       ierr = PetscViewerASCIIPrintf(viewer,"  Local solve is same for all blocks, in the following KSP and PC objects:\n");CHKERRQ(ierr);
@@ -505,7 +526,8 @@ PetscErrorCode  PCBJacobiGetLocalBlocks(PC pc, PetscInt *blocks, const PetscInt
 
    Options Database Keys:
 +  -pc_use_amat - use Amat to apply block of operator in inner Krylov method
--  -pc_bjacobi_blocks <n> - use n total blocks
+.  -pc_bjacobi_blocks <n> - use n total blocks
+-  -pc_bjacobi_threaded_blocks - solve the local blocks concurrently on the -omp_num_threads threads
 
    Notes:
     Each processor can have one or more blocks, or a single block can be shared by several processes. Defaults to one block per processor.
@@ -523,6 +545,11 @@ PetscErrorCode  PCBJacobiGetLocalBlocks(PC pc, PetscInt *blocks, const PetscInt
 
      The options prefix for each block is sub_, for example -sub_pc_type lu.
 
+     With -pc_bjacobi_threaded_blocks a process owning several blocks solves them concurrently on OpenMP threads (they are
+         still factored one after the other),
+         so one process per socket with many blocks can replace one process per block. This requires PETSc configured
+         --with-openmp --with-threadsafety.
+
      When multiple processes share a single block, each block encompasses exactly all the unknowns owned its set of processes.
 
    Level: beginner
@@ -877,6 +904,7 @@ static PetscErrorCode PCSetUpOnBlocks_BJacobi_Multiblock(PC pc)
   KSPConvergedReason reason;
 
   PetscFunctionBegin;
+  /* the blocks are set up one after the other even with -pc_bjacobi_threaded_blocks, the factorizations create PETSc objects */
   for (i=0; i<n_local; i++) {
     ierr = KSPSetUp(jac->ksp[i]);CHKERRQ(ierr);
     ierr = KSPGetConvergedReason(jac->ksp[i],&reason);CHKERRQ(ierr);
@@ -887,6 +915,41 @@ static PetscErrorCode PCSetUpOnBlocks_BJacobi_Multiblock(PC pc)
   PetscFunctionReturn(0);
 }
 
+/*
+   Solves (or transpose solves) the blocks with the blocks distributed over nt threads. The blocks read and write
+   disjoint parts of the arrays of x and y, only the check of the solve, which may set the failed reason of pc, is serialized.
+*/
+static PetscErrorCode PCApplyBlocksThreaded_BJacobi_Multiblock(PC pc,PetscInt nt,const PetscScalar *xin,PetscScalar *yin,PetscBool transpose)
+{
+  PC_BJacobi            *jac = (PC_BJacobi*)pc->data;
+  PC_BJacobi_Multiblock *bjac = (PC_BJacobi_Multiblock*)jac->data;
+  PetscErrorCode        ierr = 0;
+  PetscInt              i;
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+#pragma omp parallel for num_threads(nt) schedule(dynamic,1)
+#endif
+  for (i=0; i<jac->n_local; i++) {
+    PetscErrorCode berr;
+
+    berr = VecPlaceArray(bjac->x[i],xin+bjac->starts[i]);
+    if (!berr) berr = VecPlaceArray(bjac->y[i],yin+bjac->starts[i]);
+    if (!berr) berr = transpose ? KSPSolveTranspose(jac->ksp[i],bjac->x[i],bjac->y[i]) : KSPSolve(jac->ksp[i],bjac->x[i],bjac->y[i]);
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+#pragma omp critical (PCBJacobiBlocks)
+#endif
+    {
+      if (!berr) berr = KSPCheckSolve(jac->ksp[i],pc,bjac->y[i]);
+      if (!berr) berr = VecResetArray(bjac->x[i]);
+      if (!berr) berr = VecResetArray(bjac->y[i]);
+      if (berr && !ierr) ierr = berr;
+    }
+  }
+  CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*
       Preconditioner for block Jacobi
 */
@@ -894,7 +957,7 @@ static PetscErrorCode PCApply_BJacobi_Multiblock(PC pc,Vec x,Vec y)
 {
   PC_BJacobi            *jac = (PC_BJacobi*)pc->data;
   PetscErrorCode        ierr;
-  PetscInt              i,n_local = jac->n_local;
+  PetscInt              i,n_local = jac->n_local,nt = PCBJacobiGetNumThreads_Private(jac);
   PC_BJacobi_Multiblock *bjac = (PC_BJacobi_Multiblock*)jac->data;
   PetscScalar           *yin;
   const PetscScalar     *xin;
@@ -902,6 +965,12 @@ static PetscErrorCode PCApply_BJacobi_Multiblock(PC pc,Vec x,Vec y)
   PetscFunctionBegin;
   ierr = VecGetArrayRead(x,&xin);CHKERRQ(ierr);
   ierr = VecGetArray(y,&yin);CHKERRQ(ierr);
+  if (nt > 1) {
+    ierr = PCApplyBlocksThreaded_BJacobi_Multiblock(pc,nt,xin,yin,PETSC_FALSE);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(x,&xin);CHKERRQ(ierr);
+    ierr = VecRestoreArray(y,&yin);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   for (i=0; i<n_local; i++) {
     /*
        To avoid copying the subvector from x into a workspace we instead
@@ -931,7 +1000,7 @@ static PetscErrorCode PCApplyTranspose_BJacobi_Multiblock(PC pc,Vec x,Vec y)
 {
   PC_BJacobi            *jac = (PC_BJacobi*)pc->data;
   PetscErrorCode        ierr;
-  PetscInt              i,n_local = jac->n_local;
+  PetscInt              i,n_local = jac->n_local,nt = PCBJacobiGetNumThreads_Private(jac);
   PC_BJacobi_Multiblock *bjac = (PC_BJacobi_Multiblock*)jac->data;
   PetscScalar           *yin;
   const PetscScalar     *xin;
@@ -939,6 +1008,12 @@ static PetscErrorCode PCApplyTranspose_BJacobi_Multiblock(PC pc,Vec x,Vec y)
   PetscFunctionBegin;
   ierr = VecGetArrayRead(x,&xin);CHKERRQ(ierr);
   ierr = VecGetArray(y,&yin);CHKERRQ(ierr);
+  if (nt > 1) {
+    ierr = PCApplyBlocksThreaded_BJacobi_Multiblock(pc,nt,xin,yin,PETSC_TRUE);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(x,&xin);CHKERRQ(ierr);
+    ierr = VecRestoreArray(y,&yin);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   for (i=0; i<n_local; i++) {
     /*
        To avoid copying the subvector from x into a workspace we instead
@@ -21,6 +21,7 @@ typedef struct {
   PetscInt     *l_lens;           /* lens of each block */
   PetscInt     *g_lens;
   PetscSubcomm psubcomm;          /* for multiple processors per block */
+  PetscBool    threaded_blocks;   /* solve the local blocks concurrently on OpenMP threads */
 } PC_BJacobi;
 
 /*
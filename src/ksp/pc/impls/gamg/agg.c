@@ -102,9 +102,11 @@ static PetscErrorCode PCGAMGSetSymGraph_AGG(PC pc, PetscBool n)
    Notes:
    Squaring the graph increases the rate of coarsening (aggressive coarsening) and thereby reduces the complexity of the coarse grids, and generally results in slower solver converge rates. Reducing coarse grid complexity reduced the complexity of Galerkin coarse grid construction considerably.
 
+   With -mat_coarsen_type mis2 the aggregates of these levels come from a distance-2 maximal independent set of the graph, which does not form the squared graph.
+
    Level: intermediate
 
-.seealso: PCGAMGSetSymGraph(), PCGAMGSetThreshold()
+.seealso: PCGAMGSetSymGraph(), PCGAMGSetThreshold(), MATCOARSENMIS2
 @*/
 PetscErrorCode PCGAMGSetSquareGraph(PC pc, PetscInt n)
 {
@@ -861,6 +863,7 @@ static PetscErrorCode PCGAMGCoarsen_AGG(PC a_pc,Mat *a_Gmat1,PetscCoarsenData **
   PetscReal      hashfact;
   PetscInt       iSwapIndex;
   PetscRandom    random;
+  PetscBool      ismis2;
 
   PetscFunctionBegin;
   ierr = PetscLogEventBegin(PC_GAMGCoarsen_AGG,0,0,0,0);CHKERRQ(ierr);
@@ -871,60 +874,87 @@ static PetscErrorCode PCGAMGCoarsen_AGG(PC a_pc,Mat *a_Gmat1,PetscCoarsenData **
   if (bs != 1) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_PLIB,"bs %D must be 1",bs);
   nloc = n/bs;
 
+  /* a distance-2 MIS of the graph gives the aggregates of the squared graph without forming it */
+  ierr = MatCoarsenCreate(comm, &crs);CHKERRQ(ierr);
+  ierr = MatCoarsenSetFromOptions(crs);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)crs,MATCOARSENMIS2,&ismis2);CHKERRQ(ierr);
   if (pc_gamg->current_level < pc_gamg_agg->square_graph) {
-    ierr = PetscInfo2(a_pc,"Square Graph on level %D of %D to square\n",pc_gamg->current_level+1,pc_gamg_agg->square_graph);CHKERRQ(ierr);
-    ierr = MatTransposeMatMult(Gmat1, Gmat1, MAT_INITIAL_MATRIX, PETSC_DEFAULT, &Gmat2);CHKERRQ(ierr);
-  } else Gmat2 = Gmat1;
-
-  /* get MIS aggs - randomize */
-  ierr = PetscMalloc1(nloc, &permute);CHKERRQ(ierr);
-  ierr = PetscCalloc1(nloc, &bIndexSet);CHKERRQ(ierr);
-  for (Ii = 0; Ii < nloc; Ii++) {
-    permute[Ii]   = Ii;
-  }
-  ierr = PetscRandomCreate(PETSC_COMM_SELF,&random);CHKERRQ(ierr);
-  ierr = MatGetOwnershipRange(Gmat1, &Istart, &Iend);CHKERRQ(ierr);
-  for (Ii = 0; Ii < nloc; Ii++) {
-    ierr = PetscRandomGetValueReal(random,&hashfact);CHKERRQ(ierr);
-    iSwapIndex = (PetscInt) (hashfact*nloc)%nloc;
-    if (!bIndexSet[iSwapIndex] && iSwapIndex != Ii) {
-      PetscInt iTemp = permute[iSwapIndex];
-      permute[iSwapIndex]   = permute[Ii];
-      permute[Ii]           = iTemp;
-      bIndexSet[iSwapIndex] = PETSC_TRUE;
+    if (ismis2) {
+      ierr = PetscInfo2(a_pc,"Distance-2 MIS instead of squaring the graph on level %D of %D to square\n",pc_gamg->current_level+1,pc_gamg_agg->square_graph);CHKERRQ(ierr);
+      Gmat2 = Gmat1;
+    } else {
+      ierr = PetscInfo2(a_pc,"Square Graph on level %D of %D to square\n",pc_gamg->current_level+1,pc_gamg_agg->square_graph);CHKERRQ(ierr);
+#if defined PETSC_GAMG_USE_LOG
+      ierr = PetscLogEventBegin(petsc_gamg_setup_events[GRAPH_SQR],0,0,0,0);CHKERRQ(ierr);
+#endif
+      ierr = MatTransposeMatMult(Gmat1, Gmat1, MAT_INITIAL_MATRIX, PETSC_DEFAULT, &Gmat2);CHKERRQ(ierr);
+#if defined PETSC_GAMG_USE_LOG
+      ierr = PetscLogEventEnd(petsc_gamg_setup_events[GRAPH_SQR],0,0,0,0);CHKERRQ(ierr);
+#endif
+    }
+  } else {
+    if (ismis2) {
+      ierr   = MatCoarsenSetType(crs,MATCOARSENMIS);CHKERRQ(ierr);
+      ismis2 = PETSC_FALSE;
     }
+    Gmat2 = Gmat1;
   }
-  ierr = PetscFree(bIndexSet);CHKERRQ(ierr);
-  ierr = PetscRandomDestroy(&random);CHKERRQ(ierr);
-  ierr = ISCreateGeneral(PETSC_COMM_SELF, nloc, permute, PETSC_USE_POINTER, &perm);CHKERRQ(ierr);
+
 #if defined PETSC_GAMG_USE_LOG
   ierr = PetscLogEventBegin(petsc_gamg_setup_events[SET4],0,0,0,0);CHKERRQ(ierr);
 #endif
-  ierr = MatCoarsenCreate(comm, &crs);CHKERRQ(ierr);
-  ierr = MatCoarsenSetFromOptions(crs);CHKERRQ(ierr);
-  ierr = MatCoarsenSetGreedyOrdering(crs, perm);CHKERRQ(ierr);
+  if (ismis2) perm = NULL; /* the MIS-2 has its own fixed random ordering */
+  else {
+    /* get MIS aggs - randomize */
+    ierr = PetscMalloc1(nloc, &permute);CHKERRQ(ierr);
+    ierr = PetscCalloc1(nloc, &bIndexSet);CHKERRQ(ierr);
+    for (Ii = 0; Ii < nloc; Ii++) {
+      permute[Ii]   = Ii;
+    }
+    ierr = PetscRandomCreate(PETSC_COMM_SELF,&random);CHKERRQ(ierr);
+    ierr = MatGetOwnershipRange(Gmat1, &Istart, &Iend);CHKERRQ(ierr);
+    for (Ii = 0; Ii < nloc; Ii++) {
+      ierr = PetscRandomGetValueReal(random,&hashfact);CHKERRQ(ierr);
+      iSwapIndex = (PetscInt) (hashfact*nloc)%nloc;
+      if (!bIndexSet[iSwapIndex] && iSwapIndex != Ii) {
+        PetscInt iTemp = permute[iSwapIndex];
+        permute[iSwapIndex]   = permute[Ii];
+        permute[Ii]           = iTemp;
+        bIndexSet[iSwapIndex] = PETSC_TRUE;
+      }
+    }
+    ierr = PetscFree(bIndexSet);CHKERRQ(ierr);
+    ierr = PetscRandomDestroy(&random);CHKERRQ(ierr);
+    ierr = ISCreateGeneral(PETSC_COMM_SELF, nloc, permute, PETSC_USE_POINTER, &perm);CHKERRQ(ierr);
+    ierr = MatCoarsenSetGreedyOrdering(crs, perm);CHKERRQ(ierr);
+  }
   ierr = MatCoarsenSetAdjacency(crs, Gmat2);CHKERRQ(ierr);
   ierr = MatCoarsenSetStrictAggs(crs, PETSC_TRUE);CHKERRQ(ierr);
   ierr = MatCoarsenApply(crs);CHKERRQ(ierr);
   ierr = MatCoarsenGetData(crs, agg_lists);CHKERRQ(ierr); /* output */
   ierr = MatCoarsenDestroy(&crs);CHKERRQ(ierr);
 
-  ierr = ISDestroy(&perm);CHKERRQ(ierr);
-  ierr = PetscFree(permute);CHKERRQ(ierr);
-#if defined PETSC_GAMG_USE_LOG
-  ierr = PetscLogEventEnd(petsc_gamg_setup_events[SET4],0,0,0,0);CHKERRQ(ierr);
-#endif
+  if (perm) {
+    ierr = ISDestroy(&perm);CHKERRQ(ierr);
+    ierr = PetscFree(permute);CHKERRQ(ierr);
+  }
 
   /* smooth aggs */
   if (Gmat2 != Gmat1) {
     const PetscCoarsenData *llist = *agg_lists;
     ierr     = smoothAggs(a_pc,Gmat2, Gmat1, *agg_lists);CHKERRQ(ierr);
+#if defined PETSC_GAMG_USE_LOG
+    ierr     = PetscLogEventEnd(petsc_gamg_setup_events[SET4],0,0,0,0);CHKERRQ(ierr);
+#endif
     ierr     = MatDestroy(&Gmat1);CHKERRQ(ierr);
     *a_Gmat1 = Gmat2; /* output */
     ierr     = PetscCDGetMat(llist, &mat);CHKERRQ(ierr);
     if (mat) SETERRQ(comm,PETSC_ERR_ARG_WRONG, "Auxilary matrix with squared graph????");
   } else {
     const PetscCoarsenData *llist = *agg_lists;
+#if defined PETSC_GAMG_USE_LOG
+    ierr = PetscLogEventEnd(petsc_gamg_setup_events[SET4],0,0,0,0);CHKERRQ(ierr);
+#endif
     /* see if we have a matrix that takes precedence (returned from MatCoarsenApply) */
     ierr = PetscCDGetMat(llist, &mat);CHKERRQ(ierr);
     if (mat) {
@@ -1079,6 +1109,116 @@ static PetscErrorCode PCGAMGProlongator_AGG(PC pc,Mat Amat,Mat Gmat,PetscCoarsen
   PetscFunctionReturn(0);
 }
 
+/* -------------------------------------------------------------------------- */
+/*
+   PCGAMGSmoothEigenvalues_AGG - estimate the extreme eigenvalues of D^{-1}A used to smooth the prolongator, and
+   cache them for the Chebyshev smoothers
+
+  Input Parameter:
+   . pc - this
+   . Amat - matrix on this fine level
+ Output Parameter:
+   . a_emin, a_emax - the eigenvalue estimates
+*/
+static PetscErrorCode PCGAMGSmoothEigenvalues_AGG(PC pc,Mat Amat,PetscReal *a_emin,PetscReal *a_emax)
+{
+  PetscErrorCode ierr;
+  PC_MG          *mg          = (PC_MG*)pc->data;
+  PC_GAMG        *pc_gamg     = (PC_GAMG*)mg->innerctx;
+  MPI_Comm       comm;
+  KSP            eksp;
+  Vec            bb, xx;
+  PC             epc;
+  PetscReal      emax, emin;
+  PetscRandom    random;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)Amat,&comm);CHKERRQ(ierr);
+  if ( pc_gamg->emax > 0) {
+    emin = pc_gamg->emin;
+    emax = pc_gamg->emax;
+  } else {
+    ierr = MatCreateVecs(Amat, &bb, 0);CHKERRQ(ierr);
+    ierr = MatCreateVecs(Amat, &xx, 0);CHKERRQ(ierr);
+    ierr = PetscRandomCreate(PETSC_COMM_SELF,&random);CHKERRQ(ierr);
+    ierr = VecSetRandom(bb,random);CHKERRQ(ierr);
+    ierr = PetscRandomDestroy(&random);CHKERRQ(ierr);
+
+    ierr = KSPCreate(comm,&eksp);CHKERRQ(ierr);
+    ierr = KSPSetType(eksp, pc_gamg->esteig_type);CHKERRQ(ierr);
+    ierr = KSPSetErrorIfNotConverged(eksp,pc->erroriffailure);CHKERRQ(ierr);
+    ierr = KSPSetTolerances(eksp,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT,pc_gamg->esteig_max_it);CHKERRQ(ierr);
+    ierr = KSPSetNormType(eksp, KSP_NORM_NONE);CHKERRQ(ierr);
+
+    ierr = KSPSetInitialGuessNonzero(eksp, PETSC_FALSE);CHKERRQ(ierr);
+    ierr = KSPSetOperators(eksp, Amat, Amat);CHKERRQ(ierr);
+    ierr = KSPSetComputeSingularValues(eksp,PETSC_TRUE);CHKERRQ(ierr);
+
+    ierr = KSPGetPC(eksp, &epc);CHKERRQ(ierr);
+    ierr = PCSetType(epc, PCJACOBI);CHKERRQ(ierr);  /* smoother in smoothed agg. */
+
+    /* solve - keep stuff out of logging */
+    ierr = PetscLogEventDeactivate(KSP_Solve);CHKERRQ(ierr);
+    ierr = PetscLogEventDeactivate(PC_Apply);CHKERRQ(ierr);
+    ierr = KSPSolve(eksp, bb, xx);CHKERRQ(ierr);
+    ierr = KSPCheckSolve(eksp,pc,xx);CHKERRQ(ierr);
+    ierr = PetscLogEventActivate(KSP_Solve);CHKERRQ(ierr);
+    ierr = PetscLogEventActivate(PC_Apply);CHKERRQ(ierr);
+
+    ierr = KSPComputeExtremeSingularValues(eksp, &emax, &emin);CHKERRQ(ierr);
+    ierr = PetscInfo3(pc,"Smooth P0: max eigen=%e min=%e PC=%s\n",emax,emin,PCJACOBI);CHKERRQ(ierr);
+    ierr = VecDestroy(&xx);CHKERRQ(ierr);
+    ierr = VecDestroy(&bb);CHKERRQ(ierr);
+    ierr = KSPDestroy(&eksp);CHKERRQ(ierr);
+  }
+  if (pc_gamg->use_sa_esteig) {
+    mg->min_eigen_DinvA[pc_gamg->current_level] = emin;
+    mg->max_eigen_DinvA[pc_gamg->current_level] = emax;
+    ierr = PetscInfo3(pc,"Smooth P0: level %D, cache spectra %g %g\n",pc_gamg->current_level,(double)emin,(double)emax);CHKERRQ(ierr);
+  } else {
+    mg->min_eigen_DinvA[pc_gamg->current_level] = 0;
+    mg->max_eigen_DinvA[pc_gamg->current_level] = 0;
+  }
+  *a_emin = emin;
+  *a_emax = emax;
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCGAMGSmoothProlongator_AGG - one smoothing step P1 := (I - omega/lam D^{-1}A)P0
+
+  Input Parameter:
+   . Amat - matrix on this fine level
+   . emax - estimate of the largest eigenvalue of D^{-1}A
+   . Prol - prolongator to smooth
+   . scall - MAT_INITIAL_MATRIX to create a_P, or MAT_REUSE_MATRIX to recompute its values with its nonzero structure
+ In/Output Parameter:
+   . a_P - smoothed prolongator
+*/
+static PetscErrorCode PCGAMGSmoothProlongator_AGG(Mat Amat,PetscReal emax,Mat Prol,MatReuse scall,Mat *a_P)
+{
+  PetscErrorCode ierr;
+  Vec            diag;
+  PetscReal      alpha;
+
+  PetscFunctionBegin;
+#if defined PETSC_GAMG_USE_LOG
+  ierr = PetscLogEventBegin(petsc_gamg_setup_events[SET9],0,0,0,0);CHKERRQ(ierr);
+#endif
+  ierr  = MatMatMult(Amat, Prol, scall, PETSC_DEFAULT, a_P);CHKERRQ(ierr);
+  ierr  = MatCreateVecs(Amat, &diag, 0);CHKERRQ(ierr);
+  ierr  = MatGetDiagonal(Amat, diag);CHKERRQ(ierr); /* effectively PCJACOBI */
+  ierr  = VecReciprocal(diag);CHKERRQ(ierr);
+  ierr  = MatDiagonalScale(*a_P, diag, 0);CHKERRQ(ierr);
+  ierr  = VecDestroy(&diag);CHKERRQ(ierr);
+  alpha = -1.4/emax;
+  ierr  = MatAYPX(*a_P, alpha, Prol, SUBSET_NONZERO_PATTERN);CHKERRQ(ierr);
+#if defined PETSC_GAMG_USE_LOG
+  ierr = PetscLogEventEnd(petsc_gamg_setup_events[SET9],0,0,0,0);CHKERRQ(ierr);
+#endif
+  PetscFunctionReturn(0);
+}
+
 /* -------------------------------------------------------------------------- */
 /*
    PCGAMGOptProlongator_AGG
@@ -1097,65 +1237,15 @@ static PetscErrorCode PCGAMGOptProlongator_AGG(PC pc,Mat Amat,Mat *a_P)
   PC_GAMG_AGG    *pc_gamg_agg = (PC_GAMG_AGG*)pc_gamg->subctx;
   PetscInt       jj;
   Mat            Prol  = *a_P;
-  MPI_Comm       comm;
-  KSP            eksp;
-  Vec            bb, xx;
-  PC             epc;
-  PetscReal      alpha, emax, emin;
-  PetscRandom    random;
+  PetscReal      emax, emin;
 
   PetscFunctionBegin;
-  ierr = PetscObjectGetComm((PetscObject)Amat,&comm);CHKERRQ(ierr);
   ierr = PetscLogEventBegin(PC_GAMGOptProlongator_AGG,0,0,0,0);CHKERRQ(ierr);
 
   /* compute maximum value of operator to be used in smoother */
   if (0 < pc_gamg_agg->nsmooths) {
     /* get eigen estimates */
-    if ( pc_gamg->emax > 0) {
-      emin = pc_gamg->emin;
-      emax = pc_gamg->emax;
-    } else {
-      ierr = MatCreateVecs(Amat, &bb, 0);CHKERRQ(ierr);
-      ierr = MatCreateVecs(Amat, &xx, 0);CHKERRQ(ierr);
-      ierr = PetscRandomCreate(PETSC_COMM_SELF,&random);CHKERRQ(ierr);
-      ierr = VecSetRandom(bb,random);CHKERRQ(ierr);
-      ierr = PetscRandomDestroy(&random);CHKERRQ(ierr);
-
-      ierr = KSPCreate(comm,&eksp);CHKERRQ(ierr);
-      ierr = KSPSetType(eksp, pc_gamg->esteig_type);CHKERRQ(ierr);
-      ierr = KSPSetErrorIfNotConverged(eksp,pc->erroriffailure);CHKERRQ(ierr);
-      ierr = KSPSetTolerances(eksp,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT,pc_gamg->esteig_max_it);CHKERRQ(ierr);
-      ierr = KSPSetNormType(eksp, KSP_NORM_NONE);CHKERRQ(ierr);
-
-      ierr = KSPSetInitialGuessNonzero(eksp, PETSC_FALSE);CHKERRQ(ierr);
-      ierr = KSPSetOperators(eksp, Amat, Amat);CHKERRQ(ierr);
-      ierr = KSPSetComputeSingularValues(eksp,PETSC_TRUE);CHKERRQ(ierr);
-
-      ierr = KSPGetPC(eksp, &epc);CHKERRQ(ierr);
-      ierr = PCSetType(epc, PCJACOBI);CHKERRQ(ierr);  /* smoother in smoothed agg. */
-
-      /* solve - keep stuff out of logging */
-      ierr = PetscLogEventDeactivate(KSP_Solve);CHKERRQ(ierr);
-      ierr = PetscLogEventDeactivate(PC_Apply);CHKERRQ(ierr);
-      ierr = KSPSolve(eksp, bb, xx);CHKERRQ(ierr);
-      ierr = KSPCheckSolve(eksp,pc,xx);CHKERRQ(ierr);
-      ierr = PetscLogEventActivate(KSP_Solve);CHKERRQ(ierr);
-      ierr = PetscLogEventActivate(PC_Apply);CHKERRQ(ierr);
-
-      ierr = KSPComputeExtremeSingularValues(eksp, &emax, &emin);CHKERRQ(ierr);
-      ierr = PetscInfo3(pc,"Smooth P0: max eigen=%e min=%e PC=%s\n",emax,emin,PCJACOBI);CHKERRQ(ierr);
-      ierr = VecDestroy(&xx);CHKERRQ(ierr);
-      ierr = VecDestroy(&bb);CHKERRQ(ierr);
-      ierr = KSPDestroy(&eksp);CHKERRQ(ierr);
-    }
-    if (pc_gamg->use_sa_esteig) {
-      mg->min_eigen_DinvA[pc_gamg->current_level] = emin;
-      mg->max_eigen_DinvA[pc_gamg->current_level] = emax;
-      ierr = PetscInfo3(pc,"Smooth P0: level %D, cache spectra %g %g\n",pc_gamg->current_level,(double)emin,(double)emax);CHKERRQ(ierr);
-    } else {
-      mg->min_eigen_DinvA[pc_gamg->current_level] = 0;
-      mg->max_eigen_DinvA[pc_gamg->current_level] = 0;
-    }
+    ierr = PCGAMGSmoothEigenvalues_AGG(pc,Amat,&emin,&emax);CHKERRQ(ierr);
   } else {
     mg->min_eigen_DinvA[pc_gamg->current_level] = 0;
     mg->max_eigen_DinvA[pc_gamg->current_level] = 0;
@@ -1163,27 +1253,61 @@ static PetscErrorCode PCGAMGOptProlongator_AGG(PC pc,Mat Amat,Mat *a_P)
 
   /* smooth P0 */
   for (jj = 0; jj < pc_gamg_agg->nsmooths; jj++) {
-    Mat       tMat;
-    Vec       diag;
+    Mat tMat;
 
-#if defined PETSC_GAMG_USE_LOG
-    ierr = PetscLogEventBegin(petsc_gamg_setup_events[SET9],0,0,0,0);CHKERRQ(ierr);
-#endif
+    ierr = PCGAMGSmoothProlongator_AGG(Amat,emax,Prol,MAT_INITIAL_MATRIX,&tMat);CHKERRQ(ierr);
+    ierr = MatDestroy(&Prol);CHKERRQ(ierr);
+    Prol = tMat;
+  }
+  ierr = PetscLogEventEnd(PC_GAMGOptProlongator_AGG,0,0,0,0);CHKERRQ(ierr);
+  *a_P = Prol;
+  PetscFunctionReturn(0);
+}
 
-    /* smooth P1 := (I - omega/lam D^{-1}A)P0 */
-    ierr  = MatMatMult(Amat, Prol, MAT_INITIAL_MATRIX, PETSC_DEFAULT, &tMat);CHKERRQ(ierr);
-    ierr  = MatCreateVecs(Amat, &diag, 0);CHKERRQ(ierr);
-    ierr  = MatGetDiagonal(Amat, diag);CHKERRQ(ierr); /* effectively PCJACOBI */
-    ierr  = VecReciprocal(diag);CHKERRQ(ierr);
-    ierr  = MatDiagonalScale(tMat, diag, 0);CHKERRQ(ierr);
-    ierr  = VecDestroy(&diag);CHKERRQ(ierr);
-    alpha = -1.4/emax;
-    ierr  = MatAYPX(tMat, alpha, Prol, SUBSET_NONZERO_PATTERN);CHKERRQ(ierr);
-    ierr  = MatDestroy(&Prol);CHKERRQ(ierr);
-    Prol  = tMat;
-#if defined PETSC_GAMG_USE_LOG
-    ierr = PetscLogEventEnd(petsc_gamg_setup_events[SET9],0,0,0,0);CHKERRQ(ierr);
-#endif
+/*
+   PCGAMGUpdateProlongator_AGG - recompute the smoothed prolongator for an operator with the same nonzero structure,
+   the tentative prolongator of the aggregates does not depend on the operator and is kept
+
+  Input Parameter:
+   . pc - this
+   . Amat - matrix on this fine level
+   . Prol0 - tentative prolongator
+ In/Output Parameter:
+   . a_P - smoothed prolongator, created if NULL, otherwise its values are recomputed reusing the symbolic product
+*/
+static PetscErrorCode PCGAMGUpdateProlongator_AGG(PC pc,Mat Amat,Mat Prol0,Mat *a_P)
+{
+  PetscErrorCode ierr;
+  PC_MG          *mg          = (PC_MG*)pc->data;
+  PC_GAMG        *pc_gamg     = (PC_GAMG*)mg->innerctx;
+  PC_GAMG_AGG    *pc_gamg_agg = (PC_GAMG_AGG*)pc_gamg->subctx;
+  PetscInt       jj;
+  Mat            Prol = Prol0;
+  PetscReal      emax, emin;
+
+  PetscFunctionBegin;
+  if (!pc_gamg_agg->nsmooths) {
+    mg->min_eigen_DinvA[pc_gamg->current_level] = 0;
+    mg->max_eigen_DinvA[pc_gamg->current_level] = 0;
+    if (!*a_P) {
+      ierr = PetscObjectReference((PetscObject)Prol0);CHKERRQ(ierr);
+      *a_P = Prol0;
+    }
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscLogEventBegin(PC_GAMGOptProlongator_AGG,0,0,0,0);CHKERRQ(ierr);
+  ierr = PCGAMGSmoothEigenvalues_AGG(pc,Amat,&emin,&emax);CHKERRQ(ierr);
+  for (jj = 0; jj < pc_gamg_agg->nsmooths; jj++) {
+    Mat tMat;
+
+    if (jj == pc_gamg_agg->nsmooths-1 && *a_P) { /* the last product has the structure of the prolongator */
+      tMat = *a_P;
+      ierr = PCGAMGSmoothProlongator_AGG(Amat,emax,Prol,MAT_REUSE_MATRIX,&tMat);CHKERRQ(ierr);
+    } else {
+      ierr = PCGAMGSmoothProlongator_AGG(Amat,emax,Prol,MAT_INITIAL_MATRIX,&tMat);CHKERRQ(ierr);
+    }
+    if (Prol != Prol0) {ierr = MatDestroy(&Prol);CHKERRQ(ierr);}
+    Prol = tMat;
   }
   ierr = PetscLogEventEnd(PC_GAMGOptProlongator_AGG,0,0,0,0);CHKERRQ(ierr);
   *a_P = Prol;
@@ -1218,6 +1342,7 @@ PetscErrorCode  PCCreateGAMG_AGG(PC pc)
   pc_gamg->ops->coarsen           = PCGAMGCoarsen_AGG;
   pc_gamg->ops->prolongator       = PCGAMGProlongator_AGG;
   pc_gamg->ops->optprolongator    = PCGAMGOptProlongator_AGG;
+  pc_gamg->ops->updateprolongator = PCGAMGUpdateProlongator_AGG;
   pc_gamg->ops->createdefaultdata = PCSetData_AGG;
   pc_gamg->ops->view              = PCView_GAMG_AGG;
 
@@ -45,6 +45,9 @@ PetscErrorCode PCReset_GAMG(PC pc)
   }
   pc_gamg->emin = 0;
   pc_gamg->emax = 0;
+  for (level = 0; level < PETSC_MG_MAXLEVELS ; level++) {
+    ierr = MatDestroy(&pc_gamg->Prol0[level]);CHKERRQ(ierr);
+  }
   PetscFunctionReturn(0);
 }
 
@@ -425,6 +428,122 @@ static PetscErrorCode PCGAMGCreateLevel_GAMG(PC pc,Mat Amat_fine,PetscInt cr_bs,
   PetscFunctionReturn(0);
 }
 
+/* -------------------------------------------------------------------------- */
+/*
+   PCGAMGSetChebyshevEigenvalues_Private - setup cheby eigen estimates from SA
+
+   Input Parameter:
+   . pc - the preconditioner context
+   . update - the estimates are recomputed for a new operator, so the ones set from SA before are replaced
+*/
+static PetscErrorCode PCGAMGSetChebyshevEigenvalues_Private(PC pc,PetscBool update)
+{
+  PetscErrorCode ierr;
+  PC_MG          *mg      = (PC_MG*)pc->data;
+  PC_GAMG        *pc_gamg = (PC_GAMG*)mg->innerctx;
+  PetscInt       lidx,level;
+
+  PetscFunctionBegin;
+  for (lidx = 1, level = pc_gamg->Nlevels-2; level >= 0 ; lidx++, level--) {
+    KSP       smoother,asmoother;
+    PetscBool ischeb;
+    ierr = PCMGGetSmoother(pc, lidx, &smoother);CHKERRQ(ierr);
+    ierr = PetscObjectTypeCompare((PetscObject)smoother,KSPCHEBYSHEV,&ischeb);CHKERRQ(ierr);
+    if (ischeb) {
+      KSP_Chebyshev  *cheb = (KSP_Chebyshev*)smoother->data;
+      /* let command line emax override using SA's eigenvalues, those were set from SA if no KSP estimates them */
+      if (mg->max_eigen_DinvA[level] > 0 && (cheb->emax == 0. || (update && !cheb->kspest && cheb->emax_computed > 0))) {
+        PC        subpc;
+        PetscBool isjac;
+        ierr = KSPGetPC(smoother, &subpc);CHKERRQ(ierr);
+        ierr = PetscObjectTypeCompare((PetscObject)subpc,PCJACOBI,&isjac);CHKERRQ(ierr);
+        if ( (isjac && pc_gamg->use_sa_esteig==-1) || pc_gamg->use_sa_esteig==1) {
+          PetscReal       emax,emin;
+          Mat             A;
+          emin = mg->min_eigen_DinvA[level];
+          emax = mg->max_eigen_DinvA[level];
+          ierr = KSPGetOperators(smoother,NULL,&A);CHKERRQ(ierr);
+          ierr = PetscInfo4(pc,"PCSetUp_GAMG: call KSPChebyshevSetEigenvalues on level %D (N=%D) with emax = %g emin = %g\n",level,A->rmap->N,(double)emax,(double)emin);CHKERRQ(ierr);
+          cheb->emin_computed = emin;
+          cheb->emax_computed = emax;
+          ierr = KSPChebyshevSetEigenvalues(smoother, cheb->tform[2]*emin + cheb->tform[3]*emax, cheb->tform[0]*emin + cheb->tform[1]*emax);CHKERRQ(ierr);
+          /* the smoother that runs the level when PCMG moved it onto fewer processes */
+          ierr = PCMGAgglomerateGetSmoother_Private(pc, lidx, &asmoother);CHKERRQ(ierr);
+          ierr = PetscObjectTypeCompare((PetscObject)asmoother,KSPCHEBYSHEV,&ischeb);CHKERRQ(ierr);
+          if (ischeb) {
+            KSP_Chebyshev *acheb = (KSP_Chebyshev*)asmoother->data;
+            acheb->emin_computed = emin;
+            acheb->emax_computed = emax;
+            ierr = KSPChebyshevSetEigenvalues(asmoother, acheb->tform[2]*emin + acheb->tform[3]*emax, acheb->tform[0]*emin + acheb->tform[1]*emax);CHKERRQ(ierr);
+          }
+        }
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+   PCGAMGSetUpNumeric_Private - Recomputes the prolongators and the coarse grid operators of the hierarchy built by
+   the previous setup for a new operator with the same nonzero structure. The aggregates and the tentative prolongators
+   are kept, and the first time the products are formed again their symbolic part is kept for the next setups.
+
+   Input Parameter:
+.  pc - the preconditioner context
+*/
+static PetscErrorCode PCGAMGSetUpNumeric_Private(PC pc)
+{
+  PetscErrorCode ierr;
+  PC_MG          *mg       = (PC_MG*)pc->data;
+  PC_GAMG        *pc_gamg  = (PC_GAMG*)mg->innerctx;
+  PC_MG_Levels   **mglevels = mg->levels;
+  MatReuse       scall     = pc_gamg->numeric_count++ ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX;
+  PetscInt       level,lidx;
+  Mat            A = pc->pmat,B,P;
+
+  PetscFunctionBegin;
+  ierr = PetscInfo2(pc,"numeric setup %D (%s products)\n",pc_gamg->numeric_count,scall == MAT_REUSE_MATRIX ? "reusing the symbolic" : "new");CHKERRQ(ierr);
+  ierr = KSPSetOperators(mglevels[pc_gamg->Nlevels-1]->smoothd,A,A);CHKERRQ(ierr);
+  for (level = 0, lidx = pc_gamg->Nlevels-1; lidx > 0; level++, lidx--) {
+    pc_gamg->current_level = level;
+#if defined PETSC_GAMG_USE_LOG
+    ierr = PetscLogEventBegin(petsc_gamg_setup_events[SET1],0,0,0,0);CHKERRQ(ierr);
+#endif
+    if (pc_gamg->ops->updateprolongator) {
+      P    = scall == MAT_REUSE_MATRIX ? mglevels[lidx]->interpolate : NULL;
+      ierr = (*pc_gamg->ops->updateprolongator)(pc,A,pc_gamg->Prol0[level+1],&P);CHKERRQ(ierr);
+      if (scall == MAT_INITIAL_MATRIX) {
+        ierr = PCMGSetInterpolation(pc,lidx,P);CHKERRQ(ierr);
+        ierr = PCMGSetRestriction(pc,lidx,P);CHKERRQ(ierr);
+        ierr = MatDestroy(&P);CHKERRQ(ierr);
+      }
+    }
+    P = mglevels[lidx]->interpolate;
+#if defined PETSC_GAMG_USE_LOG
+    ierr = PetscLogEventEnd(petsc_gamg_setup_events[SET1],0,0,0,0);CHKERRQ(ierr);
+    ierr = PetscLogEventBegin(petsc_gamg_setup_events[SET2],0,0,0,0);CHKERRQ(ierr);
+#endif
+    if (scall == MAT_INITIAL_MATRIX) {
+      ierr = MatPtAP(A,P,MAT_INITIAL_MATRIX,2.0,&B);CHKERRQ(ierr);
+      ierr = KSPSetOperators(mglevels[lidx-1]->smoothd,B,B);CHKERRQ(ierr);
+      ierr = MatDestroy(&mglevels[lidx-1]->A);CHKERRQ(ierr);
+      mglevels[lidx-1]->A = B; /* the operator of the residual, kept by PCMG */
+    } else {
+      ierr = KSPGetOperators(mglevels[lidx-1]->smoothd,NULL,&B);CHKERRQ(ierr);
+      ierr = MatPtAP(A,P,MAT_REUSE_MATRIX,1.0,&B);CHKERRQ(ierr);
+      ierr = KSPSetOperators(mglevels[lidx-1]->smoothd,B,B);CHKERRQ(ierr);
+    }
+#if defined PETSC_GAMG_USE_LOG
+    ierr = PetscLogEventEnd(petsc_gamg_setup_events[SET2],0,0,0,0);CHKERRQ(ierr);
+#endif
+    ierr = KSPGetOperators(mglevels[lidx-1]->smoothd,NULL,&A);CHKERRQ(ierr);
+  }
+  ierr = PCSetUp_MG(pc);CHKERRQ(ierr);
+  ierr = PCGAMGSetChebyshevEigenvalues_Private(pc,PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /* -------------------------------------------------------------------------- */
 /*
    PCSetUp_GAMG - Prepares for the use of the GAMG preconditioner
@@ -448,6 +567,7 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
   PetscLogDouble nnz0=0.,nnztot=0.;
   MatInfo        info;
   PetscBool      is_last = PETSC_FALSE;
+  IS             Pcolumnperm = NULL;
 
   PetscFunctionBegin;
   ierr = PetscObjectGetComm((PetscObject)pc,&comm);CHKERRQ(ierr);
@@ -455,9 +575,17 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
   ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
 
   if (pc_gamg->setup_count++ > 0) {
-    if ((PetscBool)(!pc_gamg->reuse_prol)) {
-      /* reset everything */
+    if (!pc_gamg->reuse_prol && pc_gamg->reuse_aggs && pc->setupcalled && pc->flag == SAME_NONZERO_PATTERN && pc_gamg->Nlevels > 1 && pc_gamg->Prol0[1] && (pc_gamg->ops->updateprolongator || !pc_gamg->ops->optprolongator)) {
+      /* keep the aggregates, recompute the values */
+      ierr = PCGAMGSetUpNumeric_Private(pc);CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    } else if ((PetscBool)(!pc_gamg->reuse_prol)) {
+      /* reset everything, including the tentative prolongators and the products kept for a new nonzero structure */
       ierr = PCReset_MG(pc);CHKERRQ(ierr);
+      for (level = 0; level < PETSC_MG_MAXLEVELS ; level++) {
+        ierr = MatDestroy(&pc_gamg->Prol0[level]);CHKERRQ(ierr);
+      }
+      pc_gamg->numeric_count = 0;
       pc->setupcalled = 0;
     } else {
       PC_MG_Levels **mglevels = mg->levels;
@@ -552,6 +680,11 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
         /* get new block size of coarse matrices */
         ierr = MatGetBlockSizes(Prol11, NULL, &bs);CHKERRQ(ierr);
 
+        if (pc_gamg->reuse_aggs) { /* keep the tentative prolongator */
+          ierr = PetscObjectReference((PetscObject)Prol11);CHKERRQ(ierr);
+          pc_gamg->Prol0[level1] = Prol11;
+        }
+
         if (pc_gamg->ops->optprolongator) {
           /* smooth */
           ierr = pc_gamg->ops->optprolongator(pc, Aarr[level], &Prol11);CHKERRQ(ierr);
@@ -587,7 +720,22 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
     if (is_last) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Is last ????????");
     if (N <= pc_gamg->coarse_eq_limit) is_last = PETSC_TRUE;
     if (level1 == pc_gamg->Nlevels-1) is_last = PETSC_TRUE;
-    ierr = pc_gamg->ops->createlevel(pc, Aarr[level], bs, &Parr[level1], &Aarr[level1], &nactivepe, NULL, is_last);CHKERRQ(ierr);
+    ierr = pc_gamg->ops->createlevel(pc, Aarr[level], bs, &Parr[level1], &Aarr[level1], &nactivepe, pc_gamg->reuse_aggs ? &Pcolumnperm : NULL, is_last);CHKERRQ(ierr);
+    if (Pcolumnperm) { /* the columns of the prolongator were moved with the coarse grid */
+      IS       findices;
+      PetscInt Istart,Iend,f_bs;
+      Mat      Pnew;
+
+      ierr = MatGetBlockSize(Aarr[level], &f_bs);CHKERRQ(ierr);
+      ierr = MatGetOwnershipRange(pc_gamg->Prol0[level1], &Istart, &Iend);CHKERRQ(ierr);
+      ierr = ISCreateStride(comm,Iend-Istart,Istart,1,&findices);CHKERRQ(ierr);
+      ierr = ISSetBlockSize(findices,f_bs);CHKERRQ(ierr);
+      ierr = MatCreateSubMatrix(pc_gamg->Prol0[level1], findices, Pcolumnperm, MAT_INITIAL_MATRIX, &Pnew);CHKERRQ(ierr);
+      ierr = ISDestroy(&findices);CHKERRQ(ierr);
+      ierr = ISDestroy(&Pcolumnperm);CHKERRQ(ierr);
+      ierr = MatDestroy(&pc_gamg->Prol0[level1]);CHKERRQ(ierr);
+      pc_gamg->Prol0[level1] = Pnew;
+    }
 
 #if defined PETSC_GAMG_USE_LOG
     ierr = PetscLogEventEnd(petsc_gamg_setup_events[SET2],0,0,0,0);CHKERRQ(ierr);
@@ -694,30 +842,7 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
     ierr = PCSetUp_MG(pc);CHKERRQ(ierr);
 
     /* setup cheby eigen estimates from SA */
-    for (lidx = 1, level = pc_gamg->Nlevels-2; level >= 0 ; lidx++, level--) {
-      KSP       smoother;
-      PetscBool ischeb;
-      ierr = PCMGGetSmoother(pc, lidx, &smoother);CHKERRQ(ierr);
-      ierr = PetscObjectTypeCompare((PetscObject)smoother,KSPCHEBYSHEV,&ischeb);CHKERRQ(ierr);
-      if (ischeb) {
-        KSP_Chebyshev  *cheb = (KSP_Chebyshev*)smoother->data;
-        if (mg->max_eigen_DinvA[level] > 0 && cheb->emax == 0.) { /* let command line emax override using SA's eigenvalues */
-          PC        subpc;
-          PetscBool isjac;
-          ierr = KSPGetPC(smoother, &subpc);CHKERRQ(ierr);
-          ierr = PetscObjectTypeCompare((PetscObject)subpc,PCJACOBI,&isjac);CHKERRQ(ierr);
-          if ( (isjac && pc_gamg->use_sa_esteig==-1) || pc_gamg->use_sa_esteig==1) {
-            PetscReal       emax,emin;
-            emin = mg->min_eigen_DinvA[level];
-            emax = mg->max_eigen_DinvA[level];
-            ierr = PetscInfo4(pc,"PCSetUp_GAMG: call KSPChebyshevSetEigenvalues on level %D (N=%D) with emax = %g emin = %g\n",level,Aarr[level]->rmap->N,(double)emax,(double)emin);CHKERRQ(ierr);
-            cheb->emin_computed = emin;
-            cheb->emax_computed = emax;
-            ierr = KSPChebyshevSetEigenvalues(smoother, cheb->tform[2]*emin + cheb->tform[3]*emax, cheb->tform[0]*emin + cheb->tform[1]*emax);CHKERRQ(ierr);
-          }
-        }
-      }
-    }
+    ierr = PCGAMGSetChebyshevEigenvalues_Private(pc,PETSC_FALSE);CHKERRQ(ierr);
 
     /* clean up */
     for (level=1; level<pc_gamg->Nlevels; level++) {
@@ -1078,6 +1203,54 @@ static PetscErrorCode PCGAMGSetReuseInterpolation_GAMG(PC pc, PetscBool n)
   PetscFunctionReturn(0);
 }
 
+/*@
+   PCGAMGSetReuseAggregates - Keep the aggregates when rebuilding the algebraic multigrid preconditioner for a matrix
+   with the same nonzero structure, and only recompute the values of the prolongators and coarse grid operators
+
+   Collective on PC
+
+   Input Parameters:
++  pc - the preconditioner context
+-  n - PETSC_TRUE or PETSC_FALSE
+
+   Options Database Key:
+.  -pc_gamg_reuse_aggregates <true,false>
+
+   Level: intermediate
+
+   Notes:
+    This is meant for a sequence of matrices with the same nonzero structure whose entries change moderately, such as the
+    Jacobians of a Newton iteration. The graph, its coarsening and the tentative prolongators are computed in the first setup
+    only. The later setups smooth the tentative prolongators with the new matrix and form the Galerkin coarse grid operators,
+    reusing the symbolic part of these products from the second setup on, so they cost a few matrix-matrix products.
+    Unlike PCGAMGSetReuseInterpolation() the prolongators follow the new matrix. The eigenvalue estimates used to smooth
+    the prolongators, and for the Chebyshev smoothers if they are taken from them, are recomputed.
+
+    PCGAMGSetReuseInterpolation() takes precedence. If the matrix nonzero structure changes the preconditioner is built again
+    from scratch, and the new aggregates are kept for the next setups.
+
+.seealso: PCGAMGSetReuseInterpolation(), PCReset()
+@*/
+PetscErrorCode PCGAMGSetReuseAggregates(PC pc, PetscBool n)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  ierr = PetscTryMethod(pc,"PCGAMGSetReuseAggregates_C",(PC,PetscBool),(pc,n));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PCGAMGSetReuseAggregates_GAMG(PC pc, PetscBool n)
+{
+  PC_MG   *mg      = (PC_MG*)pc->data;
+  PC_GAMG *pc_gamg = (PC_GAMG*)mg->innerctx;
+
+  PetscFunctionBegin;
+  pc_gamg->reuse_aggs = n;
+  PetscFunctionReturn(0);
+}
+
 /*@
    PCGAMGASMSetUseAggs - Have the PCGAMG smoother on each level use the aggregates defined by the coarsening process as the subdomains for the additive Schwarz preconditioner.
 
@@ -1523,6 +1696,7 @@ PetscErrorCode PCSetFromOptions_GAMG(PetscOptionItems *PetscOptionsObject,PC pc)
   ierr = PetscOptionsBool("-pc_gamg_use_sa_esteig","Use eigen estimate from Smoothed aggregation for smoother","PCGAMGSetUseSAEstEig",f2,&f2,&flag);CHKERRQ(ierr);
   if (flag) pc_gamg->use_sa_esteig = f2 ? 1 : 0;
   ierr = PetscOptionsBool("-pc_gamg_reuse_interpolation","Reuse prolongation operator","PCGAMGReuseInterpolation",pc_gamg->reuse_prol,&pc_gamg->reuse_prol,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-pc_gamg_reuse_aggregates","Reuse aggregates and symbolic products, recompute values","PCGAMGSetReuseAggregates",pc_gamg->reuse_aggs,&pc_gamg->reuse_aggs,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-pc_gamg_asm_use_agg","Use aggregation aggregates for ASM smoother","PCGAMGASMSetUseAggs",pc_gamg->use_aggs_in_asm,&pc_gamg->use_aggs_in_asm,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-pc_gamg_use_parallel_coarse_grid_solver","Use parallel coarse grid solver (otherwise put last grid on one process)","PCGAMGSetUseParallelCoarseGridSolve",pc_gamg->use_parallel_coarse_grid_solver,&pc_gamg->use_parallel_coarse_grid_solver,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-pc_gamg_cpu_pin_coarse_grids","Pin coarse grids to the CPU","PCGAMGSetCpuPinCoarseGrids",pc_gamg->cpu_pin_coarse_grids,&pc_gamg->cpu_pin_coarse_grids,NULL);CHKERRQ(ierr);
@@ -1565,6 +1739,7 @@ PetscErrorCode PCSetFromOptions_GAMG(PetscOptionItems *PetscOptionsObject,PC pc)
 +   -pc_gamg_type <type> - one of agg, geo, or classical
 .   -pc_gamg_repartition  <true,default=false> - repartition the degrees of freedom accross the coarse grids as they are determined
 .   -pc_gamg_reuse_interpolation <true,default=false> - when rebuilding the algebraic multigrid preconditioner reuse the previously computed interpolations
+.   -pc_gamg_reuse_aggregates <true,default=false> - when rebuilding the algebraic multigrid preconditioner for a matrix with the same nonzero structure reuse the aggregates and recompute only the values
 .   -pc_gamg_asm_use_agg <true,default=false> - use the aggregates from the coasening process to defined the subdomains on each level for the PCASM smoother
 .   -pc_gamg_process_eq_limit <limit, default=50> - GAMG will reduce the number of MPI processes used directly on the coarse grids so that there are around <limit>
                                         equations on each process that has degrees of freedom
@@ -1575,7 +1750,8 @@ PetscErrorCode PCSetFromOptions_GAMG(PetscOptionItems *PetscOptionsObject,PC pc)
    Options Database Keys for default Aggregation:
 +  -pc_gamg_agg_nsmooths <nsmooth, default=1> - number of smoothing steps to use with smooth aggregation
 .  -pc_gamg_sym_graph <true,default=false> - symmetrize the graph before computing the aggregation
--  -pc_gamg_square_graph <n,default=1> - number of levels to square the graph before aggregating it
+.  -pc_gamg_square_graph <n,default=1> - number of levels to square the graph before aggregating it
+-  -mat_coarsen_type mis2 - aggregate with a threaded distance-2 maximal independent set of the graph instead of squaring it, see MATCOARSENMIS2
 
    Multigrid options:
 +  -pc_mg_cycles <v> - v or w, see PCMGSetCycleType()
@@ -1593,7 +1769,7 @@ PetscErrorCode PCSetFromOptions_GAMG(PetscOptionItems *PetscOptionsObject,PC pc)
   Level: intermediate
 
 .seealso:  PCCreate(), PCSetType(), MatSetBlockSize(), PCMGType, PCSetCoordinates(), MatSetNearNullSpace(), PCGAMGSetType(), PCGAMGAGG, PCGAMGGEO, PCGAMGCLASSICAL, PCGAMGSetProcEqLim(),
-           PCGAMGSetCoarseEqLim(), PCGAMGSetRepartition(), PCGAMGRegister(), PCGAMGSetReuseInterpolation(), PCGAMGASMSetUseAggs(), PCGAMGSetUseParallelCoarseGridSolve(), PCGAMGSetNlevels(), PCGAMGSetThreshold(), PCGAMGGetType(), PCGAMGSetReuseInterpolation(), PCGAMGSetUseSAEstEig(), PCGAMGSetEstEigKSPMaxIt(), PCGAMGSetEstEigKSPType()
+           PCGAMGSetCoarseEqLim(), PCGAMGSetRepartition(), PCGAMGRegister(), PCGAMGSetReuseInterpolation(), PCGAMGASMSetUseAggs(), PCGAMGSetUseParallelCoarseGridSolve(), PCGAMGSetNlevels(), PCGAMGSetThreshold(), PCGAMGGetType(), PCGAMGSetReuseInterpolation(), PCGAMGSetUseSAEstEig(), PCGAMGSetEstEigKSPMaxIt(), PCGAMGSetEstEigKSPType(), PCGAMGSetReuseAggregates()
 M*/
 
 PETSC_EXTERN PetscErrorCode PCCreate_GAMG(PC pc)
@@ -1640,6 +1816,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_GAMG(PC pc)
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetEigenvalues_C",PCGAMGSetEigenvalues_GAMG);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetUseSAEstEig_C",PCGAMGSetUseSAEstEig_GAMG);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetReuseInterpolation_C",PCGAMGSetReuseInterpolation_GAMG);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetReuseAggregates_C",PCGAMGSetReuseAggregates_GAMG);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGASMSetUseAggs_C",PCGAMGASMSetUseAggs_GAMG);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetUseParallelCoarseGridSolve_C",PCGAMGSetUseParallelCoarseGridSolve_GAMG);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetCpuPinCoarseGrids_C",PCGAMGSetCpuPinCoarseGrids_GAMG);CHKERRQ(ierr);
@@ -1651,6 +1828,8 @@ PETSC_EXTERN PetscErrorCode PCCreate_GAMG(PC pc)
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetNlevels_C",PCGAMGSetNlevels_GAMG);CHKERRQ(ierr);
   pc_gamg->repart           = PETSC_FALSE;
   pc_gamg->reuse_prol       = PETSC_FALSE;
+  pc_gamg->reuse_aggs       = PETSC_FALSE;
+  pc_gamg->numeric_count    = 0;
   pc_gamg->use_aggs_in_asm  = PETSC_FALSE;
   pc_gamg->use_parallel_coarse_grid_solver = PETSC_FALSE;
   pc_gamg->cpu_pin_coarse_grids = PETSC_FALSE;
@@ -1708,7 +1887,7 @@ PetscErrorCode PCGAMGInitializePackage(void)
   ierr = PetscLogEventRegister("  Graph", PC_CLASSID, &petsc_gamg_setup_events[GRAPH]);CHKERRQ(ierr);
   /* PetscLogEventRegister("    G.Mat", PC_CLASSID, &petsc_gamg_setup_events[GRAPH_MAT]); */
   /* PetscLogEventRegister("    G.Filter", PC_CLASSID, &petsc_gamg_setup_events[GRAPH_FILTER]); */
-  /* PetscLogEventRegister("    G.Square", PC_CLASSID, &petsc_gamg_setup_events[GRAPH_SQR]); */
+  ierr = PetscLogEventRegister("  G.Square", PC_CLASSID, &petsc_gamg_setup_events[GRAPH_SQR]);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("  MIS/Agg", PC_CLASSID, &petsc_gamg_setup_events[SET4]);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("  geo: growSupp", PC_CLASSID, &petsc_gamg_setup_events[SET5]);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("  geo: triangle", PC_CLASSID, &petsc_gamg_setup_events[SET6]);CHKERRQ(ierr);
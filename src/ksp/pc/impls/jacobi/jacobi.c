@@ -272,6 +272,23 @@ static PetscErrorCode PCApply_Jacobi(PC pc,Vec x,Vec y)
   ierr = VecPointwiseMult(y,x,jac->diag);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
+
+/*
+   PCJacobiGetDiagonal_Jacobi - Gives the vector of the inverse of the diagonal used by PCApply(), so that
+   Krylov methods such as KSPCHEBYSHEV can apply the preconditioner within their own vector operations
+*/
+static PetscErrorCode PCJacobiGetDiagonal_Jacobi(PC pc,Vec *diag)
+{
+  PC_Jacobi      *jac = (PC_Jacobi*)pc->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!jac->diag) {
+    ierr = PCSetUp_Jacobi_NonSymmetric(pc);CHKERRQ(ierr);
+  }
+  *diag = jac->diag;
+  PetscFunctionReturn(0);
+}
 /* -------------------------------------------------------------------------- */
 /*
    PCApplySymmetricLeftOrRight_Jacobi - Applies the left or right part of a
@@ -430,6 +447,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_Jacobi(PC pc)
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCJacobiGetType_C",PCJacobiGetType_Jacobi);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCJacobiSetUseAbs_C",PCJacobiSetUseAbs_Jacobi);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCJacobiGetUseAbs_C",PCJacobiGetUseAbs_Jacobi);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCJacobiGetDiagonal_C",PCJacobiGetDiagonal_Jacobi);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
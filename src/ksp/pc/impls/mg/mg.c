@@ -41,14 +41,24 @@ PetscErrorCode PCMGMCycle_Private(PC pc,PC_MG_Levels **mglevelsin,PCRichardsonCo
 
     mgc = *(mglevelsin - 1);
     if (mglevels->eventinterprestrict) {ierr = PetscLogEventBegin(mglevels->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
-    ierr = MatRestrict(mglevels->restrct,mglevels->r,mgc->b);CHKERRQ(ierr);
+    if (mglevels->cb) { /* the coarser level is agglomerated on fewer processes */
+      ierr = PCMGAgglomerateRestrict_Private(mglevels,mgc);CHKERRQ(ierr);
+    } else {
+      ierr = MatRestrict(mglevels->restrct,mglevels->r,mgc->b);CHKERRQ(ierr);
+    }
     if (mglevels->eventinterprestrict) {ierr = PetscLogEventEnd(mglevels->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
-    ierr = VecSet(mgc->x,0.0);CHKERRQ(ierr);
-    while (cycles--) {
-      ierr = PCMGMCycle_Private(pc,mglevelsin-1,reason);CHKERRQ(ierr);
+    if (!mgc->idle) {
+      ierr = VecSet(mgc->x,0.0);CHKERRQ(ierr);
+      while (cycles--) {
+        ierr = PCMGMCycle_Private(pc,mglevelsin-1,reason);CHKERRQ(ierr);
+      }
     }
     if (mglevels->eventinterprestrict) {ierr = PetscLogEventBegin(mglevels->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
-    ierr = MatInterpolateAdd(mglevels->interpolate,mgc->x,mglevels->x,mglevels->x);CHKERRQ(ierr);
+    if (mglevels->cx) {
+      ierr = PCMGAgglomerateInterpolateAdd_Private(mglevels,mgc);CHKERRQ(ierr);
+    } else {
+      ierr = MatInterpolateAdd(mglevels->interpolate,mgc->x,mglevels->x,mglevels->x);CHKERRQ(ierr);
+    }
     if (mglevels->eventinterprestrict) {ierr = PetscLogEventEnd(mglevels->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
     if (mglevels->eventsmoothsolve) {ierr = PetscLogEventBegin(mglevels->eventsmoothsolve,0,0,0,0);CHKERRQ(ierr);}
     ierr = KSPSolve(mglevels->smoothu,mglevels->b,mglevels->x);CHKERRQ(ierr);    /* post smooth */
@@ -61,7 +71,7 @@ PetscErrorCode PCMGMCycle_Private(PC pc,PC_MG_Levels **mglevelsin,PCRichardsonCo
 static PetscErrorCode PCApplyRichardson_MG(PC pc,Vec b,Vec x,Vec w,PetscReal rtol,PetscReal abstol, PetscReal dtol,PetscInt its,PetscBool zeroguess,PetscInt *outits,PCRichardsonConvergedReason *reason)
 {
   PC_MG          *mg        = (PC_MG*)pc->data;
-  PC_MG_Levels   **mglevels = mg->levels;
+  PC_MG_Levels   **mglevels = mg->levels,**cyclevels;
   PetscErrorCode ierr;
   PC             tpc;
   PetscBool      changeu,changed;
@@ -94,6 +104,7 @@ static PetscErrorCode PCApplyRichardson_MG(PC pc,Vec b,Vec x,Vec w,PetscReal rto
     ierr = VecCopy(b,mglevels[levels-1]->b);CHKERRQ(ierr);
   }
   mglevels[levels-1]->x = x;
+  if (mg->alevels) {ierr = PCMGAgglomerateUpdate_Private(pc);CHKERRQ(ierr);}
 
   mg->rtol   = rtol;
   mg->abstol = abstol;
@@ -113,18 +124,20 @@ static PetscErrorCode PCApplyRichardson_MG(PC pc,Vec b,Vec x,Vec w,PetscReal rto
 
   /* since smoother is applied to full system, not just residual we need to make sure that smoothers don't
      stop prematurely due to small residual */
+  cyclevels = mg->alevels ? mg->alevels : mglevels;
   for (i=1; i<levels; i++) {
-    ierr = KSPSetTolerances(mglevels[i]->smoothu,0,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT);CHKERRQ(ierr);
-    if (mglevels[i]->smoothu != mglevels[i]->smoothd) {
+    if (!cyclevels[i]->smoothu) continue; /* agglomerated level without rows on this process */
+    ierr = KSPSetTolerances(cyclevels[i]->smoothu,0,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT);CHKERRQ(ierr);
+    if (cyclevels[i]->smoothu != cyclevels[i]->smoothd) {
       /* For Richardson the initial guess is nonzero since it is solving in each cycle the original system not just applying as a preconditioner */
-      ierr = KSPSetInitialGuessNonzero(mglevels[i]->smoothd,PETSC_TRUE);CHKERRQ(ierr);
-      ierr = KSPSetTolerances(mglevels[i]->smoothd,0,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT);CHKERRQ(ierr);
+      ierr = KSPSetInitialGuessNonzero(cyclevels[i]->smoothd,PETSC_TRUE);CHKERRQ(ierr);
+      ierr = KSPSetTolerances(cyclevels[i]->smoothd,0,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT);CHKERRQ(ierr);
     }
   }
 
   *reason = (PCRichardsonConvergedReason)0;
   for (i=0; i<its; i++) {
-    ierr = PCMGMCycle_Private(pc,mglevels+levels-1,reason);CHKERRQ(ierr);
+    ierr = PCMGMCycle_Private(pc,cyclevels+levels-1,reason);CHKERRQ(ierr);
     if (*reason) break;
   }
   if (!*reason) *reason = PCRICHARDSON_CONVERGED_ITS;
@@ -164,6 +177,7 @@ PetscErrorCode PCReset_MG(PC pc)
       ierr = KSPReset(mglevels[i]->smoothu);CHKERRQ(ierr);
     }
   }
+  ierr = PCMGAgglomerateReset_Private(pc);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -378,9 +392,15 @@ static PetscErrorCode PCApply_MG(PC pc,Vec b,Vec x)
   mglevels[levels-1]->x = x;
 
   if (mg->am == PC_MG_MULTIPLICATIVE) {
+    PC_MG_Levels **cyclevels = mglevels;
+
+    if (mg->alevels) {
+      ierr      = PCMGAgglomerateUpdate_Private(pc);CHKERRQ(ierr);
+      cyclevels = mg->alevels;
+    }
     ierr = VecSet(x,0.0);CHKERRQ(ierr);
     for (i=0; i<mg->cyclesperpcapply; i++) {
-      ierr = PCMGMCycle_Private(pc,mglevels+levels-1,NULL);CHKERRQ(ierr);
+      ierr = PCMGMCycle_Private(pc,cyclevels+levels-1,NULL);CHKERRQ(ierr);
     }
   } else if (mg->am == PC_MG_ADDITIVE) {
     ierr = PCMGACycle_Private(pc,mglevels);CHKERRQ(ierr);
@@ -398,8 +418,8 @@ static PetscErrorCode PCApply_MG(PC pc,Vec b,Vec x)
 PetscErrorCode PCSetFromOptions_MG(PetscOptionItems *PetscOptionsObject,PC pc)
 {
   PetscErrorCode   ierr;
-  PetscInt         levels,cycles;
-  PetscBool        flg;
+  PetscInt         levels,cycles,eqlim,factor;
+  PetscBool        flg,flg2;
   PC_MG            *mg = (PC_MG*)pc->data;
   PC_MG_Levels     **mglevels;
   PCMGType         mgtype;
@@ -408,6 +428,8 @@ PetscErrorCode PCSetFromOptions_MG(PetscOptionItems *PetscOptionsObject,PC pc)
 
   PetscFunctionBegin;
   levels = PetscMax(mg->nlevels,1);
+  eqlim  = mg->agglomeqlim;
+  factor = mg->agglomfactor;
   ierr = PetscOptionsHead(PetscOptionsObject,"Multigrid options");CHKERRQ(ierr);
   ierr = PetscOptionsInt("-pc_mg_levels","Number of Levels","PCMGSetLevels",levels,&levels,&flg);CHKERRQ(ierr);
   if (!flg && !mg->levels && pc->dm) {
@@ -444,6 +466,11 @@ PetscErrorCode PCSetFromOptions_MG(PetscOptionItems *PetscOptionsObject,PC pc)
       ierr = PCMGMultiplicativeSetCycles(pc,cycles);CHKERRQ(ierr);
     }
   }
+  ierr = PetscOptionsInt("-pc_mg_agglomerate_eq_limit","Agglomerate a coarse level onto fewer processes while it has fewer rows per process","PCMGSetAgglomeration",mg->agglomeqlim,&eqlim,&flg);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-pc_mg_agglomerate_factor","Divide the number of processes by this factor at each agglomeration","PCMGSetAgglomeration",mg->agglomfactor,&factor,&flg2);CHKERRQ(ierr);
+  if (flg || flg2) {
+    ierr = PCMGSetAgglomeration(pc,eqlim,factor);CHKERRQ(ierr);
+  }
   flg  = PETSC_FALSE;
   ierr = PetscOptionsBool("-pc_mg_log","Log times for each multigrid level","None",flg,&flg,NULL);CHKERRQ(ierr);
   if (flg) {
@@ -521,6 +548,9 @@ PetscErrorCode PCView_MG(PC pc,PetscViewer viewer)
     } else {
       ierr = PetscViewerASCIIPrintf(viewer,"    Not using Galerkin computed coarse grid matrices\n");CHKERRQ(ierr);
     }
+    if (mg->agglomeqlim) {
+      ierr = PetscViewerASCIIPrintf(viewer,"    Agglomerating the coarse levels with fewer than %D rows per process, reduction factor %D\n",mg->agglomeqlim,mg->agglomfactor);CHKERRQ(ierr);
+    }
     if (mg->view){
       ierr = (*mg->view)(pc,viewer);CHKERRQ(ierr);
     }
@@ -530,6 +560,10 @@ PetscErrorCode PCView_MG(PC pc,PetscViewer viewer)
       } else {
         ierr = PetscViewerASCIIPrintf(viewer,"Down solver (pre-smoother) on level %D -------------------------------\n",i);CHKERRQ(ierr);
       }
+      if (mg->alevels && mg->alevels[i]->nactive) {
+        ierr = PCMGAgglomerateView_Private(mglevels[i],mg->alevels[i],viewer);CHKERRQ(ierr);
+        continue;
+      }
       ierr = PetscViewerASCIIPushTab(viewer);CHKERRQ(ierr);
       ierr = KSPView(mglevels[i]->smoothd,viewer);CHKERRQ(ierr);
       ierr = PetscViewerASCIIPopTab(viewer);CHKERRQ(ierr);
@@ -849,7 +883,11 @@ PetscErrorCode PCSetUp_MG(PC pc)
     }
   }
 
+  /* the agglomerated levels have their own smoothers, set up there */
+  ierr = PCMGAgglomerateSetUp_Private(pc);CHKERRQ(ierr);
+
   for (i=1; i<n; i++) {
+    if (mg->alevels && mg->alevels[i]->nactive) continue;
     if (mglevels[i]->smoothu == mglevels[i]->smoothd || mg->am == PC_MG_FULL || mg->am == PC_MG_KASKADE || mg->cyclesperpcapply > 1){
       /* if doing only down then initial guess is zero */
       ierr = KSPSetInitialGuessNonzero(mglevels[i]->smoothd,PETSC_TRUE);CHKERRQ(ierr);
@@ -867,6 +905,7 @@ PetscErrorCode PCSetUp_MG(PC pc)
     }
   }
   for (i=1; i<n; i++) {
+    if (mg->alevels && mg->alevels[i]->nactive) continue;
     if (mglevels[i]->smoothu && mglevels[i]->smoothu != mglevels[i]->smoothd) {
       Mat downmat,downpmat;
 
@@ -887,12 +926,14 @@ PetscErrorCode PCSetUp_MG(PC pc)
     }
   }
 
-  if (mglevels[0]->eventsmoothsetup) {ierr = PetscLogEventBegin(mglevels[0]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
-  ierr = KSPSetUp(mglevels[0]->smoothd);CHKERRQ(ierr);
-  if (mglevels[0]->smoothd->reason == KSP_DIVERGED_PC_FAILED) {
-    pc->failedreason = PC_SUBPC_ERROR;
+  if (!mg->alevels) {
+    if (mglevels[0]->eventsmoothsetup) {ierr = PetscLogEventBegin(mglevels[0]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
+    ierr = KSPSetUp(mglevels[0]->smoothd);CHKERRQ(ierr);
+    if (mglevels[0]->smoothd->reason == KSP_DIVERGED_PC_FAILED) {
+      pc->failedreason = PC_SUBPC_ERROR;
+    }
+    if (mglevels[0]->eventsmoothsetup) {ierr = PetscLogEventEnd(mglevels[0]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
   }
-  if (mglevels[0]->eventsmoothsetup) {ierr = PetscLogEventEnd(mglevels[0]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
 
   /*
      Dump the interpolation/restriction matrices plus the
@@ -1293,6 +1334,8 @@ PetscErrorCode  PCGetCoarseOperators_MG(PC pc,PetscInt *num_levels,Mat *coarseOp
 .  -pc_mg_distinct_smoothup - configure up (after interpolation) and down (before restriction) smoothers separately (with different options prefixes)
 .  -pc_mg_galerkin <both,pmat,mat,none> - use Galerkin process to compute coarser operators, i.e. Acoarse = R A R'
 .  -pc_mg_multiplicative_cycles - number of cycles to use as the preconditioner (defaults to 1)
+.  -pc_mg_agglomerate_eq_limit <n> - move a coarse level onto fewer processes while it has fewer than n rows per process, see PCMGSetAgglomeration()
+.  -pc_mg_agglomerate_factor <f> - divide the number of processes by f at each agglomeration
 .  -pc_mg_dump_matlab - dumps the matrices for each level and the restriction/interpolation matrices
                         to the Socket viewer for reading from MATLAB.
 -  -pc_mg_dump_binary - dumps the matrices for each level and the restriction/interpolation matrices
@@ -1314,7 +1357,7 @@ PetscErrorCode  PCGetCoarseOperators_MG(PC pc,PetscInt *num_levels,Mat *coarseOp
            PCMGSetLevels(), PCMGGetLevels(), PCMGSetType(), PCMGSetCycleType(),
            PCMGSetDistinctSmoothUp(), PCMGGetCoarseSolve(), PCMGSetResidual(), PCMGSetInterpolation(),
            PCMGSetRestriction(), PCMGGetSmoother(), PCMGGetSmootherUp(), PCMGGetSmootherDown(),
-           PCMGSetCycleTypeOnLevel(), PCMGSetRhs(), PCMGSetX(), PCMGSetR()
+           PCMGSetCycleTypeOnLevel(), PCMGSetRhs(), PCMGSetX(), PCMGSetR(), PCMGSetAgglomeration()
 M*/
 
 PETSC_EXTERN PetscErrorCode PCCreate_MG(PC pc)
@@ -1329,6 +1372,8 @@ PETSC_EXTERN PetscErrorCode PCCreate_MG(PC pc)
   mg->am       = PC_MG_MULTIPLICATIVE;
   mg->galerkin = PC_MG_GALERKIN_NONE;
 
+  mg->agglomfactor = 4;
+
   pc->useAmat = PETSC_TRUE;
 
   pc->ops->apply          = PCApply_MG;
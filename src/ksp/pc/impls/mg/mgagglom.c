@@ -0,0 +1,672 @@
+
+/*
+    Agglomeration of the coarse levels of the multigrid preconditioner onto fewer processes
+*/
+#include <petsc/private/pcmgimpl.h>                    /*I "petscksp.h" I*/
+#include <petsc/private/kspimpl.h>
+#include <../src/ksp/pc/impls/bjacobi/bjacobi.h> /* to keep same_local_solves */
+#include <../src/ksp/ksp/impls/cheby/chebyshevimpl.h>
+
+/*@
+   PCMGSetAgglomeration - Moves the coarse levels of the multigrid hierarchy onto fewer and fewer processes, so that
+   the smoothers, residuals and the coarse solve on these levels only involve the processes that still have work.
+
+   Logically Collective on PC
+
+   Input Parameters:
++  pc     - the multigrid context
+.  eqlim  - a level is moved onto fewer processes while it has fewer than eqlim rows per process, 0 turns the agglomeration off
+-  factor - the number of processes is divided by this factor at each reduction, use PETSC_DEFAULT for the default of 4
+
+   Options Database Keys:
++  -pc_mg_agglomerate_eq_limit <eqlim> - the number of rows per process below which a level is agglomerated
+-  -pc_mg_agglomerate_factor <factor> - the reduction factor of the number of processes
+
+   Level: advanced
+
+   Notes:
+   A level never has more processes than the next finer level, and the processes of a level are the first ones of the
+   communicator of the PC. The communicators of the levels are created once with PetscSubcomm; the operators, restrictions
+   and interpolations are moved onto them with MatCreateSubMatrices() and MatCreateMPIMatConcatenateSeqMat() (as in PCTELESCOPE)
+   each time the PC is set up. The processes that have no rows on a level skip it in the cycle, so they take part in neither
+   its smoothers nor its reductions.
+
+   The smoothers of the agglomerated levels are new KSP objects with the types, tolerances and options prefixes of the
+   smoothers of PCMGGetSmoother(), so they are configured with the same options. They also get the Chebyshev eigenvalue
+   bounds, the solvers of the blocks of PCBJACOBI and the subdomains of PCASM set on these smoothers; the subdomains of a
+   process go to the process that gets its first row. Only the multiplicative multigrid is
+   supported, and the operators of all the levels must be available when the PC is set up: either Galerkin coarse
+   operators (PCMGSetGalerkin()) or operators set with KSPSetOperators() on the smoothers.
+
+.seealso: PCMGSetLevels(), PCMGSetGalerkin(), PCTELESCOPE, PCGAMGSetProcEqLim()
+@*/
+PetscErrorCode PCMGSetAgglomeration(PC pc,PetscInt eqlim,PetscInt factor)
+{
+  PC_MG *mg = (PC_MG*)pc->data;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidLogicalCollectiveInt(pc,eqlim,2);
+  PetscValidLogicalCollectiveInt(pc,factor,3);
+  if (eqlim < 0) SETERRQ1(PetscObjectComm((PetscObject)pc),PETSC_ERR_ARG_OUTOFRANGE,"Number of rows per process %D cannot be negative",eqlim);
+  if (factor != PETSC_DEFAULT && factor < 2) SETERRQ1(PetscObjectComm((PetscObject)pc),PETSC_ERR_ARG_OUTOFRANGE,"Reduction factor %D must be at least 2",factor);
+  mg->agglomeqlim = eqlim;
+  if (factor != PETSC_DEFAULT) mg->agglomfactor = factor;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Moves the rows of A onto the processes of comm, with m rows on this process and n local columns in the result.
+   Processes with comm equal to MPI_COMM_NULL take part in the extraction but get no matrix.
+*/
+static PetscErrorCode PCMGAgglomerateMat_Private(Mat A,MPI_Comm comm,PetscInt m,PetscInt n,MatReuse reuse,Mat *B)
+{
+  PetscErrorCode ierr;
+  Mat            Aaij = NULL,*Alocal;
+  IS             isrow,iscol;
+  PetscInt       rstart,N;
+  PetscBool      has;
+
+  PetscFunctionBegin;
+  ierr    = MPI_Scan(&m,&rstart,1,MPIU_INT,MPI_SUM,PetscObjectComm((PetscObject)A));CHKERRQ(ierr);
+  rstart -= m;
+  ierr    = MatGetSize(A,NULL,&N);CHKERRQ(ierr);
+  /* for example the MAIJ interpolations of DMDA */
+  ierr = MatHasOperation(A,MATOP_CREATE_SUBMATRICES,&has);CHKERRQ(ierr);
+  if (!has) {
+    ierr = MatConvert(A,MATAIJ,MAT_INITIAL_MATRIX,&Aaij);CHKERRQ(ierr);
+    A    = Aaij;
+  }
+  ierr = ISCreateStride(PETSC_COMM_SELF,m,rstart,1,&isrow);CHKERRQ(ierr);
+  ierr = ISCreateStride(PETSC_COMM_SELF,N,0,1,&iscol);CHKERRQ(ierr);
+  ierr = MatCreateSubMatrices(A,1,&isrow,&iscol,MAT_INITIAL_MATRIX,&Alocal);CHKERRQ(ierr);
+  if (comm != MPI_COMM_NULL) {
+    ierr = MatCreateMPIMatConcatenateSeqMat(comm,Alocal[0],n,reuse,B);CHKERRQ(ierr);
+  }
+  ierr = MatDestroySubMatrices(1,&Alocal);CHKERRQ(ierr);
+  ierr = ISDestroy(&isrow);CHKERRQ(ierr);
+  ierr = ISDestroy(&iscol);CHKERRQ(ierr);
+  ierr = MatDestroy(&Aaij);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Creates a smoother on comm with the type, tolerances, options prefix and Chebyshev eigenvalue bounds of ksp
+*/
+static PetscErrorCode PCMGAgglomerateCreateSmoother_Private(PC pc,KSP ksp,MPI_Comm comm,PetscInt level,KSP *aksp)
+{
+  PC_MG          *mg = (PC_MG*)pc->data;
+  PetscErrorCode ierr;
+  KSPType        type;
+  PCType         pctype;
+  KSPNormType    normtype;
+  const char     *prefix;
+  PetscReal      rtol,abstol,dtol;
+  PetscInt       maxits;
+  PC             ipc,aipc;
+  PetscBool      redundant,ischeb;
+  PetscMPIInt    size;
+
+  PetscFunctionBegin;
+  ierr = KSPCreate(comm,aksp);CHKERRQ(ierr);
+  ierr = KSPSetErrorIfNotConverged(*aksp,pc->erroriffailure);CHKERRQ(ierr);
+  ierr = PetscObjectIncrementTabLevel((PetscObject)*aksp,(PetscObject)pc,mg->nlevels-level);CHKERRQ(ierr);
+  ierr = PetscObjectComposedDataSetInt((PetscObject)*aksp,PetscMGLevelId,level);CHKERRQ(ierr);
+  ierr = KSPGetOptionsPrefix(ksp,&prefix);CHKERRQ(ierr);
+  ierr = KSPSetOptionsPrefix(*aksp,prefix);CHKERRQ(ierr);
+  ierr = KSPGetType(ksp,&type);CHKERRQ(ierr);
+  if (type) {ierr = KSPSetType(*aksp,type);CHKERRQ(ierr);}
+  ierr = KSPGetTolerances(ksp,&rtol,&abstol,&dtol,&maxits);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(*aksp,rtol,abstol,dtol,maxits);CHKERRQ(ierr);
+  ierr = KSPGetNormType(ksp,&normtype);CHKERRQ(ierr);
+  ierr = KSPSetNormType(*aksp,normtype);CHKERRQ(ierr);
+  if (ksp->converged == KSPConvergedSkip) {
+    ierr = KSPSetConvergenceTest(*aksp,KSPConvergedSkip,NULL,NULL);CHKERRQ(ierr);
+  }
+  ierr = KSPGetPC(ksp,&ipc);CHKERRQ(ierr);
+  ierr = KSPGetPC(*aksp,&aipc);CHKERRQ(ierr);
+  ierr = PCGetType(ipc,&pctype);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)ipc,PCREDUNDANT,&redundant);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  /* as in PCMGSetLevels_MG() the default coarse solver is LU on a single process */
+  if (redundant && size == 1) pctype = PCLU;
+  if (pctype) {ierr = PCSetType(aipc,pctype);CHKERRQ(ierr);}
+  if (!level) {ierr = PCFactorSetShiftType(aipc,MAT_SHIFT_INBLOCKS);CHKERRQ(ierr);}
+  ierr = PetscObjectTypeCompare((PetscObject)ksp,KSPCHEBYSHEV,&ischeb);CHKERRQ(ierr);
+  if (ischeb) {
+    KSP_Chebyshev *cheb = (KSP_Chebyshev*)ksp->data,*acheb = (KSP_Chebyshev*)(*aksp)->data;
+
+    if (cheb->emax > 0.) {ierr = KSPChebyshevSetEigenvalues(*aksp,cheb->emax,cheb->emin);CHKERRQ(ierr);}
+    acheb->emin_computed = cheb->emin_computed;
+    acheb->emax_computed = cheb->emax_computed;
+  }
+  ierr = KSPSetFromOptions(*aksp);CHKERRQ(ierr);
+  ierr = PetscLogObjectParent((PetscObject)pc,(PetscObject)*aksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Gives the block of a PCBJACOBI smoother created on fewer processes the solver of the block of ksp, for example the LU
+   coarse solver of PCGAMG. The operators of aksp must be set.
+*/
+static PetscErrorCode PCMGAgglomerateCopyBJacobi_Private(KSP ksp,KSP aksp)
+{
+  PetscErrorCode     ierr;
+  PC                 ipc,aipc,spc,aspc;
+  KSP                *sksp,*asksp;
+  KSPType            type;
+  PCType             pctype;
+  MatFactorShiftType shifttype;
+  PetscReal          rtol,abstol,dtol;
+  PetscInt           n,an,maxits;
+  PetscBool          isbjac,aisbjac,same;
+  PetscErrorCode     (*f)(PC,MatFactorShiftType*);
+
+  PetscFunctionBegin;
+  ierr = KSPGetPC(ksp,&ipc);CHKERRQ(ierr);
+  ierr = KSPGetPC(aksp,&aipc);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)ipc,PCBJACOBI,&isbjac);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)aipc,PCBJACOBI,&aisbjac);CHKERRQ(ierr);
+  if (!isbjac || !aisbjac || !ipc->setupcalled) PetscFunctionReturn(0);
+  /* PCBJacobiGetSubKSP() resets the flag */
+  same = ((PC_BJacobi*)ipc->data)->same_local_solves;
+  ierr = PCBJacobiGetSubKSP(ipc,&n,NULL,&sksp);CHKERRQ(ierr);
+  ((PC_BJacobi*)ipc->data)->same_local_solves = same;
+  ierr = PCSetUp(aipc);CHKERRQ(ierr);
+  ierr = PCBJacobiGetSubKSP(aipc,&an,NULL,&asksp);CHKERRQ(ierr);
+  ((PC_BJacobi*)aipc->data)->same_local_solves = same;
+  if (n != 1 || an != 1) PetscFunctionReturn(0);
+
+  ierr = KSPGetType(sksp[0],&type);CHKERRQ(ierr);
+  if (type) {ierr = KSPSetType(asksp[0],type);CHKERRQ(ierr);}
+  ierr = KSPGetTolerances(sksp[0],&rtol,&abstol,&dtol,&maxits);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(asksp[0],rtol,abstol,dtol,maxits);CHKERRQ(ierr);
+  ierr = KSPGetPC(sksp[0],&spc);CHKERRQ(ierr);
+  ierr = KSPGetPC(asksp[0],&aspc);CHKERRQ(ierr);
+  ierr = PCGetType(spc,&pctype);CHKERRQ(ierr);
+  if (pctype) {ierr = PCSetType(aspc,pctype);CHKERRQ(ierr);}
+  ierr = PetscObjectQueryFunction((PetscObject)spc,"PCFactorGetShiftType_C",&f);CHKERRQ(ierr);
+  if (f) {
+    ierr = PCFactorGetShiftType(spc,&shifttype);CHKERRQ(ierr);
+    ierr = PCFactorSetShiftType(aspc,shifttype);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Moves the subdomains set on the PCASM of the smoother ksp, for example the aggregates of PCGAMG, to the smoother aksp
+   created on fewer processes, with m rows on this process. Collective on pc, aksp is NULL on the idle processes.
+*/
+static PetscErrorCode PCMGAgglomerateCopyASM_Private(PC pc,KSP ksp,KSP aksp,PetscInt m)
+{
+  PetscErrorCode  ierr;
+  MPI_Comm        comm;
+  PetscMPIInt     size,rank,q,p,tag,nreqs = 0,len;
+  PC              ipc,aipc;
+  Mat             B;
+  IS              *is,*ais;
+  PCASMType       type;
+  PCCompositeType loctype;
+  PetscInt        n = 0,i,j,k,ovl,nsub = 0,nidx = 0,nis = 0,off,cnt[2],*counts,*starts,*sbuf = NULL,*rbuf = NULL,*sizes;
+  PetscMPIInt     *dest;
+  const PetscInt  *ranges,*idx;
+  PetscBool       isasm,has;
+  MPI_Request     *reqs;
+
+  PetscFunctionBegin;
+  ierr = KSPGetPC(ksp,&ipc);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)ipc,PCASM,&isasm);CHKERRQ(ierr);
+  if (!isasm) PetscFunctionReturn(0);
+  ierr = PetscObjectGetComm((PetscObject)pc,&comm);CHKERRQ(ierr);
+  ierr = PCASMGetLocalSubdomains(ipc,&n,&is,NULL);CHKERRQ(ierr);
+  if (!is) n = 0;
+  has  = is ? PETSC_TRUE : PETSC_FALSE;
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&has,1,MPIU_BOOL,MPI_LOR,comm);CHKERRQ(ierr);
+  if (!has) PetscFunctionReturn(0);
+
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = PetscMalloc5(size+1,&starts,2*size,&counts,size,&dest,size+1,&reqs,n,&sizes);CHKERRQ(ierr);
+  /* the rows of each process on the fewer processes, and the process that gets the first row of each process */
+  starts[0] = 0;
+  ierr = MPI_Allgather(&m,1,MPIU_INT,starts+1,1,MPIU_INT,comm);CHKERRQ(ierr);
+  for (q=0; q<size; q++) starts[q+1] += starts[q];
+  ierr = KSPGetOperators(ksp,NULL,&B);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRanges(B,&ranges);CHKERRQ(ierr);
+  for (q=0; q<size; q++) {
+    k = PetscMin(ranges[q],starts[size]-1);
+    for (p=0; p<size-1 && starts[p+1] <= k; p++) ;
+    dest[q] = p;
+  }
+
+  /* the sizes of the subdomains that are not empty followed by their indices */
+  for (i=0; i<n; i++) {
+    ierr = ISGetLocalSize(is[i],&sizes[nsub]);CHKERRQ(ierr);
+    if (sizes[nsub]) nidx += sizes[nsub++];
+  }
+  cnt[0] = nsub; cnt[1] = nidx;
+  ierr = MPI_Allgather(cnt,2,MPIU_INT,counts,2,MPIU_INT,comm);CHKERRQ(ierr);
+  ierr = PetscObjectGetNewTag((PetscObject)pc,&tag);CHKERRQ(ierr);
+  if (nsub) {
+    ierr = PetscMalloc1(nsub+nidx,&sbuf);CHKERRQ(ierr);
+    ierr = PetscArraycpy(sbuf,sizes,nsub);CHKERRQ(ierr);
+    for (i=0,off=nsub; i<n; i++) {
+      ierr = ISGetLocalSize(is[i],&k);CHKERRQ(ierr);
+      ierr = ISGetIndices(is[i],&idx);CHKERRQ(ierr);
+      ierr = PetscArraycpy(sbuf+off,idx,k);CHKERRQ(ierr);
+      ierr = ISRestoreIndices(is[i],&idx);CHKERRQ(ierr);
+      off += k;
+    }
+    ierr = PetscMPIIntCast(nsub+nidx,&len);CHKERRQ(ierr);
+    ierr = MPI_Isend(sbuf,len,MPIU_INT,dest[rank],tag,comm,&reqs[nreqs++]);CHKERRQ(ierr);
+  }
+  for (q=0,k=0; q<size; q++) if (counts[2*q] && dest[q] == rank) k += counts[2*q]+counts[2*q+1];
+  ierr = PetscMalloc1(k,&rbuf);CHKERRQ(ierr);
+  for (q=0,off=0; q<size; q++) {
+    if (!counts[2*q] || dest[q] != rank) continue;
+    ierr = PetscMPIIntCast(counts[2*q]+counts[2*q+1],&len);CHKERRQ(ierr);
+    ierr = MPI_Irecv(rbuf+off,len,MPIU_INT,q,tag,comm,&reqs[nreqs++]);CHKERRQ(ierr);
+    nis += counts[2*q];
+    off += len;
+  }
+  ierr = MPI_Waitall(nreqs,reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+
+  if (aksp) {
+    ierr = KSPGetPC(aksp,&aipc);CHKERRQ(ierr);
+    ierr = PetscMalloc1(PetscMax(nis,1),&ais);CHKERRQ(ierr);
+    for (q=0,off=0,j=0; q<size; q++) {
+      if (!counts[2*q] || dest[q] != rank) continue;
+      for (i=0,k=off+counts[2*q]; i<counts[2*q]; i++) {
+        ierr = ISCreateGeneral(PETSC_COMM_SELF,rbuf[off+i],rbuf+k,PETSC_COPY_VALUES,&ais[j++]);CHKERRQ(ierr);
+        k   += rbuf[off+i];
+      }
+      off = k;
+    }
+    /* as PCGAMG does for a process without aggregates */
+    if (!nis) {
+      ierr = ISCreateGeneral(PETSC_COMM_SELF,0,NULL,PETSC_COPY_VALUES,&ais[0]);CHKERRQ(ierr);
+      nis  = 1;
+    }
+    ierr = PCASMSetLocalSubdomains(aipc,nis,ais,NULL);CHKERRQ(ierr);
+    for (i=0; i<nis; i++) {ierr = ISDestroy(&ais[i]);CHKERRQ(ierr);}
+    ierr = PetscFree(ais);CHKERRQ(ierr);
+    ierr = PCASMGetType(ipc,&type);CHKERRQ(ierr);
+    ierr = PCASMSetType(aipc,type);CHKERRQ(ierr);
+    ierr = PCASMGetLocalType(ipc,&loctype);CHKERRQ(ierr);
+    ierr = PCASMSetLocalType(aipc,loctype);CHKERRQ(ierr);
+    ierr = PetscUseMethod(ipc,"PCASMGetOverlap_C",(PC,PetscInt*),(ipc,&ovl));CHKERRQ(ierr);
+    ierr = PCASMSetOverlap(aipc,ovl);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(sbuf);CHKERRQ(ierr);
+  ierr = PetscFree(rbuf);CHKERRQ(ierr);
+  ierr = PetscFree5(starts,counts,dest,reqs,sizes);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCMGAgglomerateSetUp_Private - Decides how many processes work on each level and builds mg->alevels, the levels run by
+   the multiplicative cycle.
+
+   Each agglomerated level owns its smoothers, operator and vectors, and the next finer level owns the restriction and
+   interpolation laid out on the processes of both. The other levels point to the objects of mg->levels, see
+   PCMGAgglomerateUpdate_Private().
+*/
+PetscErrorCode PCMGAgglomerateSetUp_Private(PC pc)
+{
+  PC_MG          *mg = (PC_MG*)pc->data;
+  PC_MG_Levels   **mglevels = mg->levels,**alevels;
+  PetscErrorCode ierr;
+  PetscInt       n = mglevels[0]->levels,i,M,bs,*m;
+  PetscMPIInt    size,rank,*nactive;
+  MPI_Comm       comm,*lcomm;
+  PetscBool      same = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)pc,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  if (!mg->agglomeqlim || size == 1 || n == 1) {
+    ierr = PCMGAgglomerateReset_Private(pc);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (mg->am != PC_MG_MULTIPLICATIVE) SETERRQ(comm,PETSC_ERR_SUP,"Agglomeration of the coarse levels is only supported with the multiplicative multigrid");
+
+  ierr = PetscMalloc3(n,&nactive,n,&m,n,&lcomm);CHKERRQ(ierr);
+  nactive[n-1] = size;
+  for (i=n-2; i>=0; i--) {
+    Mat         B;
+    PetscBool   opsset;
+    PetscMPIInt lsize;
+
+    ierr = MPI_Comm_size(PetscObjectComm((PetscObject)mglevels[i]->smoothd),&lsize);CHKERRQ(ierr);
+    if (lsize != size) SETERRQ1(comm,PETSC_ERR_SUP,"Agglomeration of the coarse levels needs all the levels on the communicator of the PC, level %D is not",i);
+    ierr = KSPGetOperatorsSet(mglevels[i]->smoothd,NULL,&opsset);CHKERRQ(ierr);
+    if (!opsset) SETERRQ1(comm,PETSC_ERR_ARG_WRONGSTATE,"Agglomeration needs the operator of level %D when the PC is set up, use Galerkin coarse operators or KSPSetOperators() on its smoother",i);
+    ierr = KSPGetOperators(mglevels[i]->smoothd,NULL,&B);CHKERRQ(ierr);
+    ierr = MatGetSize(B,&M,NULL);CHKERRQ(ierr);
+    nactive[i] = nactive[i+1];
+    while (nactive[i] > 1 && M < mg->agglomeqlim*nactive[i]) nactive[i] = PetscMax(1,nactive[i]/mg->agglomfactor);
+  }
+  if (nactive[0] == size) {
+    ierr = PetscFree3(nactive,m,lcomm);CHKERRQ(ierr);
+    ierr = PCMGAgglomerateReset_Private(pc);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  /* the communicators, smoothers and vectors are kept while the sizes of the levels do not change */
+  if (mg->alevels) {
+    same = PETSC_TRUE;
+    for (i=0; i<n-1; i++) {
+      Mat B;
+
+      ierr = KSPGetOperators(mglevels[i]->smoothd,NULL,&B);CHKERRQ(ierr);
+      ierr = MatGetSize(B,&M,NULL);CHKERRQ(ierr);
+      if (mg->alevels[i]->M != M || mg->alevels[i]->nactive != (nactive[i] < size ? nactive[i] : 0)) same = PETSC_FALSE;
+    }
+    if (!same) {ierr = PCMGAgglomerateReset_Private(pc);CHKERRQ(ierr);}
+  }
+  if (!mg->alevels) {
+    ierr = PetscMalloc1(n,&mg->alevels);CHKERRQ(ierr);
+    for (i=0; i<n; i++) {
+      Mat B;
+
+      ierr = PetscNewLog(pc,&mg->alevels[i]);CHKERRQ(ierr);
+      ierr = KSPGetOperators(mglevels[i]->smoothd,NULL,&B);CHKERRQ(ierr);
+      ierr = MatGetSize(B,&mg->alevels[i]->M,NULL);CHKERRQ(ierr);
+      mg->alevels[i]->nactive  = nactive[i] < size ? nactive[i] : 0;
+      mg->alevels[i]->idle     = (PetscBool)(rank >= nactive[i]);
+      mg->alevels[i]->residual = PCMGResidualDefault;
+    }
+    /* a new communicator wherever the number of processes decreases */
+    for (i=n-2; i>=0; i--) {
+      if (!mg->alevels[i]->nactive) continue;
+      if (nactive[i] == nactive[i+1]) {
+        mg->alevels[i]->psubcomm = mg->alevels[i+1]->psubcomm;
+        continue;
+      }
+      ierr = PetscSubcommCreate(comm,&mg->alevels[i]->psubcomm);CHKERRQ(ierr);
+      ierr = PetscSubcommSetNumber(mg->alevels[i]->psubcomm,2);CHKERRQ(ierr);
+      ierr = PetscSubcommSetTypeGeneral(mg->alevels[i]->psubcomm,rank < nactive[i] ? 0 : 1,rank);CHKERRQ(ierr);
+    }
+  }
+  alevels = mg->alevels;
+  ierr    = PCMGAgglomerateUpdate_Private(pc);CHKERRQ(ierr);
+
+  for (i=0; i<n; i++) {
+    Mat B;
+
+    ierr = KSPGetOperators(mglevels[i]->smoothd,NULL,&B);CHKERRQ(ierr);
+    if (!alevels[i]->nactive) {
+      ierr     = MatGetLocalSize(B,&m[i],NULL);CHKERRQ(ierr);
+      lcomm[i] = comm;
+    } else {
+      ierr     = MatGetBlockSize(B,&bs);CHKERRQ(ierr);
+      m[i]     = alevels[i]->idle ? 0 : bs*(alevels[i]->M/bs/nactive[i] + ((alevels[i]->M/bs) % nactive[i] > rank));
+      lcomm[i] = alevels[i]->idle ? MPI_COMM_NULL : PetscSubcommChild(alevels[i]->psubcomm);
+    }
+  }
+
+  for (i=0; i<n; i++) {
+    PC_MG_Levels *a = alevels[i];
+    MatReuse     reuse = (same && pc->flag == SAME_NONZERO_PATTERN) ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX;
+
+    if (a->nactive) {
+      Mat A,B,Ared = NULL,Bred = NULL;
+
+      if (!a->idle && !a->smoothd) {
+        ierr = PCMGAgglomerateCreateSmoother_Private(pc,mglevels[i]->smoothd,lcomm[i],i,&a->smoothd);CHKERRQ(ierr);
+        if (mglevels[i]->smoothu != mglevels[i]->smoothd) {
+          ierr = PCMGAgglomerateCreateSmoother_Private(pc,mglevels[i]->smoothu,lcomm[i],i,&a->smoothu);CHKERRQ(ierr);
+        } else a->smoothu = a->smoothd;
+      }
+      ierr = KSPGetOperators(mglevels[i]->smoothd,&A,&B);CHKERRQ(ierr);
+      if (reuse == MAT_REUSE_MATRIX && !a->idle) {ierr = KSPGetOperators(a->smoothd,&Ared,&Bred);CHKERRQ(ierr);}
+      ierr = PCMGAgglomerateMat_Private(A,lcomm[i],m[i],m[i],reuse,&Ared);CHKERRQ(ierr);
+      if (B != A) {
+        ierr = PCMGAgglomerateMat_Private(B,lcomm[i],m[i],m[i],reuse,&Bred);CHKERRQ(ierr);
+      } else Bred = Ared;
+      if (reuse == MAT_INITIAL_MATRIX && !a->idle) {
+        ierr = KSPSetOperators(a->smoothd,Ared,Bred);CHKERRQ(ierr);
+        if (a->smoothu != a->smoothd) {ierr = KSPSetOperators(a->smoothu,Ared,Bred);CHKERRQ(ierr);}
+        ierr = MatDestroy(&a->A);CHKERRQ(ierr);
+        a->A = Ared;
+        if (Bred != Ared) {ierr = MatDestroy(&Bred);CHKERRQ(ierr);}
+      }
+      /* what the options do not give to the new smoothers */
+      if (!same) {
+        ierr = PCMGAgglomerateCopyASM_Private(pc,mglevels[i]->smoothd,a->idle ? NULL : a->smoothd,m[i]);CHKERRQ(ierr);
+        if (!a->idle) {ierr = PCMGAgglomerateCopyBJacobi_Private(mglevels[i]->smoothd,a->smoothd);CHKERRQ(ierr);}
+        if (mglevels[i]->smoothu != mglevels[i]->smoothd) {
+          ierr = PCMGAgglomerateCopyASM_Private(pc,mglevels[i]->smoothu,a->idle ? NULL : a->smoothu,m[i]);CHKERRQ(ierr);
+          if (!a->idle) {ierr = PCMGAgglomerateCopyBJacobi_Private(mglevels[i]->smoothu,a->smoothu);CHKERRQ(ierr);}
+        }
+      }
+      if (!a->idle && !a->b) {
+        ierr = MatCreateVecs(a->A,&a->x,&a->b);CHKERRQ(ierr);
+        if (i) {ierr = VecDuplicate(a->b,&a->r);CHKERRQ(ierr);}
+      }
+    }
+
+    /* the transfers between this level and an agglomerated coarser level */
+    if (i && alevels[i-1]->nactive) {
+      Mat       P = mglevels[i]->interpolate,R = mglevels[i]->restrct;
+      PetscInt  MP,MR;
+      PetscBool idle = a->idle;
+
+      if (reuse == MAT_INITIAL_MATRIX) {
+        ierr = MatDestroy(&a->interpolate);CHKERRQ(ierr);
+        ierr = MatDestroy(&a->restrct);CHKERRQ(ierr);
+      }
+      ierr = MatGetSize(P,&MP,NULL);CHKERRQ(ierr);
+      if (MP == a->M) {
+        ierr = PCMGAgglomerateMat_Private(P,lcomm[i],m[i],m[i-1],reuse,&a->interpolate);CHKERRQ(ierr);
+      } else {
+        ierr = PCMGAgglomerateMat_Private(P,lcomm[i],m[i-1],m[i],reuse,&a->interpolate);CHKERRQ(ierr);
+      }
+      if (R == P) {
+        if (reuse == MAT_INITIAL_MATRIX && !idle) {
+          ierr       = PetscObjectReference((PetscObject)a->interpolate);CHKERRQ(ierr);
+          a->restrct = a->interpolate;
+        }
+      } else {
+        ierr = MatGetSize(R,&MR,NULL);CHKERRQ(ierr);
+        if (MR == alevels[i-1]->M) {
+          ierr = PCMGAgglomerateMat_Private(R,lcomm[i],m[i-1],m[i],reuse,&a->restrct);CHKERRQ(ierr);
+        } else {
+          ierr = PCMGAgglomerateMat_Private(R,lcomm[i],m[i],m[i-1],reuse,&a->restrct);CHKERRQ(ierr);
+        }
+      }
+      /* the right hand side and solution of the coarser level seen from the processes of this level */
+      if (!idle && !a->cb && alevels[i-1]->psubcomm != a->psubcomm) {
+        ierr = VecCreateMPIWithArray(lcomm[i],1,m[i-1],alevels[i-1]->M,NULL,&a->cb);CHKERRQ(ierr);
+        ierr = VecCreateMPIWithArray(lcomm[i],1,m[i-1],alevels[i-1]->M,NULL,&a->cx);CHKERRQ(ierr);
+      }
+    }
+  }
+
+  /* set up the smoothers of the agglomerated levels, which PCSetUp_MG() skips */
+  for (i=0; i<n; i++) {
+    PC_MG_Levels *a = alevels[i];
+
+    if (!a->nactive || a->idle) continue;
+    if (i && (a->smoothu == a->smoothd || mg->cyclesperpcapply > 1)) {
+      ierr = KSPSetInitialGuessNonzero(a->smoothd,PETSC_TRUE);CHKERRQ(ierr);
+    }
+    if (a->eventsmoothsetup) {ierr = PetscLogEventBegin(a->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
+    ierr = KSPSetUp(a->smoothd);CHKERRQ(ierr);
+    if (a->smoothd->reason == KSP_DIVERGED_PC_FAILED) pc->failedreason = PC_SUBPC_ERROR;
+    if (a->smoothu != a->smoothd) {
+      ierr = KSPSetInitialGuessNonzero(a->smoothu,PETSC_TRUE);CHKERRQ(ierr);
+      ierr = KSPSetUp(a->smoothu);CHKERRQ(ierr);
+      if (a->smoothu->reason == KSP_DIVERGED_PC_FAILED) pc->failedreason = PC_SUBPC_ERROR;
+    }
+    if (a->eventsmoothsetup) {ierr = PetscLogEventEnd(a->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
+  }
+  ierr = PetscFree3(nactive,m,lcomm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCMGAgglomerateGetSmoother_Private - Gets the smoother that runs level l on this process in place of the one of
+   PCMGGetSmoother() when the level is agglomerated, NULL otherwise or if the process is idle on the level
+*/
+PetscErrorCode PCMGAgglomerateGetSmoother_Private(PC pc,PetscInt l,KSP *ksp)
+{
+  PC_MG *mg = (PC_MG*)pc->data;
+
+  PetscFunctionBegin;
+  *ksp = NULL;
+  if (mg->alevels && mg->alevels[l]->nactive && !mg->alevels[l]->idle) *ksp = mg->alevels[l]->smoothd;
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCMGAgglomerateUpdate_Private - Points the levels of mg->alevels that are not agglomerated to the objects of mg->levels,
+   which may change between two applications of the preconditioner (for example the right hand side of the finest level).
+*/
+PetscErrorCode PCMGAgglomerateUpdate_Private(PC pc)
+{
+  PC_MG        *mg = (PC_MG*)pc->data;
+  PC_MG_Levels **mglevels = mg->levels,**alevels = mg->alevels;
+  PetscInt     n = mglevels[0]->levels,i;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) {
+    PC_MG_Levels *a = alevels[i],*l = mglevels[i];
+
+    a->cycles              = l->cycles;
+    a->level               = l->level;
+    a->levels              = l->levels;
+    a->eventsmoothsetup    = l->eventsmoothsetup;
+    a->eventsmoothsolve    = l->eventsmoothsolve;
+    a->eventresidual       = l->eventresidual;
+    a->eventinterprestrict = l->eventinterprestrict;
+    if (a->nactive) continue;
+    a->b        = l->b;
+    a->x        = l->x;
+    a->r        = l->r;
+    a->A        = l->A;
+    a->residual = l->residual;
+    a->smoothd  = l->smoothd;
+    a->smoothu  = l->smoothu;
+    if (!i || !alevels[i-1]->nactive) {
+      a->interpolate = l->interpolate;
+      a->restrct     = l->restrct;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCMGAgglomerateReset_Private - Destroys mg->alevels
+*/
+PetscErrorCode PCMGAgglomerateReset_Private(PC pc)
+{
+  PC_MG          *mg = (PC_MG*)pc->data;
+  PC_MG_Levels   **alevels = mg->alevels;
+  PetscErrorCode ierr;
+  PetscInt       n,i;
+
+  PetscFunctionBegin;
+  if (!alevels) PetscFunctionReturn(0);
+  n = alevels[0]->levels;
+  for (i=0; i<n; i++) {
+    PC_MG_Levels *a = alevels[i];
+
+    if (a->nactive) {
+      if (a->smoothu != a->smoothd) {ierr = KSPDestroy(&a->smoothu);CHKERRQ(ierr);}
+      ierr = KSPDestroy(&a->smoothd);CHKERRQ(ierr);
+      ierr = MatDestroy(&a->A);CHKERRQ(ierr);
+      ierr = VecDestroy(&a->b);CHKERRQ(ierr);
+      ierr = VecDestroy(&a->x);CHKERRQ(ierr);
+      ierr = VecDestroy(&a->r);CHKERRQ(ierr);
+    }
+    if (i && alevels[i-1]->nactive) {
+      ierr = MatDestroy(&a->restrct);CHKERRQ(ierr);
+      ierr = MatDestroy(&a->interpolate);CHKERRQ(ierr);
+    }
+    ierr = VecDestroy(&a->cb);CHKERRQ(ierr);
+    ierr = VecDestroy(&a->cx);CHKERRQ(ierr);
+    if (a->psubcomm && alevels[i+1]->psubcomm != a->psubcomm) {ierr = PetscSubcommDestroy(&a->psubcomm);CHKERRQ(ierr);}
+  }
+  for (i=0; i<n; i++) {ierr = PetscFree(alevels[i]);CHKERRQ(ierr);}
+  ierr = PetscFree(mg->alevels);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCMGAgglomerateView_Private - Views the smoothers of the agglomerated level a, whose smoothers in mg->levels are those of l
+*/
+PetscErrorCode PCMGAgglomerateView_Private(PC_MG_Levels *l,PC_MG_Levels *a,PetscViewer viewer)
+{
+  PetscErrorCode ierr;
+  MPI_Comm       subcomm = PetscSubcommChild(a->psubcomm);
+  PetscViewer    sviewer;
+
+  PetscFunctionBegin;
+  ierr = PetscViewerASCIIPushTab(viewer);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"Agglomerated onto %d MPI processes\n",(int)a->nactive);CHKERRQ(ierr);
+  ierr = PetscViewerGetSubViewer(viewer,subcomm,&sviewer);CHKERRQ(ierr);
+  if (!a->idle) {
+    ierr = KSPView(a->smoothd,sviewer);CHKERRQ(ierr);
+  }
+  ierr = PetscViewerRestoreSubViewer(viewer,subcomm,&sviewer);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPopTab(viewer);CHKERRQ(ierr);
+  if (a->level && l->smoothd == l->smoothu) {
+    ierr = PetscViewerASCIIPrintf(viewer,"Up solver (post-smoother) same as down solver (pre-smoother)\n");CHKERRQ(ierr);
+  } else if (a->level) {
+    ierr = PetscViewerASCIIPrintf(viewer,"Up solver (post-smoother) on level %D -------------------------------\n",a->level);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPushTab(viewer);CHKERRQ(ierr);
+    ierr = PetscViewerGetSubViewer(viewer,subcomm,&sviewer);CHKERRQ(ierr);
+    if (!a->idle) {
+      ierr = KSPView(a->smoothu,sviewer);CHKERRQ(ierr);
+    }
+    ierr = PetscViewerRestoreSubViewer(viewer,subcomm,&sviewer);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPopTab(viewer);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCMGAgglomerateRestrict_Private - Restricts the residual of a level into the right hand side of the next coarser
+   level, which lives on fewer processes.
+*/
+PetscErrorCode PCMGAgglomerateRestrict_Private(PC_MG_Levels *mglevels,PC_MG_Levels *mgc)
+{
+  PetscErrorCode ierr;
+  PetscScalar    *array;
+
+  PetscFunctionBegin;
+  if (!mgc->idle) {
+    ierr = VecGetArray(mgc->b,&array);CHKERRQ(ierr);
+    ierr = VecPlaceArray(mglevels->cb,array);CHKERRQ(ierr);
+  }
+  ierr = MatRestrict(mglevels->restrct,mglevels->r,mglevels->cb);CHKERRQ(ierr);
+  if (!mgc->idle) {
+    ierr = VecResetArray(mglevels->cb);CHKERRQ(ierr);
+    ierr = VecRestoreArray(mgc->b,&array);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCMGAgglomerateInterpolateAdd_Private - Adds the interpolated correction of the next coarser level, which lives on
+   fewer processes, to the solution of a level.
+*/
+PetscErrorCode PCMGAgglomerateInterpolateAdd_Private(PC_MG_Levels *mglevels,PC_MG_Levels *mgc)
+{
+  PetscErrorCode ierr;
+  PetscScalar    *array;
+
+  PetscFunctionBegin;
+  if (!mgc->idle) {
+    ierr = VecGetArray(mgc->x,&array);CHKERRQ(ierr);
+    ierr = VecPlaceArray(mglevels->cx,array);CHKERRQ(ierr);
+  }
+  ierr = MatInterpolateAdd(mglevels->interpolate,mglevels->cx,mglevels->x,mglevels->x);CHKERRQ(ierr);
+  if (!mgc->idle) {
+    ierr = VecResetArray(mglevels->cx);CHKERRQ(ierr);
+    ierr = VecRestoreArray(mgc->x,&array);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
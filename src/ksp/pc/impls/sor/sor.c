@@ -10,6 +10,7 @@ typedef struct {
   MatSORType sym;         /* forward, reverse, symmetric etc. */
   PetscReal  omega;
   PetscReal  fshift;
+  PetscBool  multicolor;  /* relax the rows color by color, see MatSORSetMulticolor() */
 } PC_SOR;
 
 static PetscErrorCode PCDestroy_SOR(PC pc)
@@ -21,6 +22,27 @@ static PetscErrorCode PCDestroy_SOR(PC pc)
   PetscFunctionReturn(0);
 }
 
+/*
+   Relaxes with pc->pmat; the multicolor ordering is only switched on for the duration of the sweeps so that
+   the setting of the user's matrix is left as it was
+*/
+static PetscErrorCode PCSORRelax_Private(PC pc,Vec b,MatSORType flag,PetscInt its,Vec y)
+{
+  PC_SOR         *jac = (PC_SOR*)pc->data;
+  PetscBool      multicolor = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (jac->multicolor) {
+    ierr = MatSORGetMulticolor(pc->pmat,&multicolor);CHKERRQ(ierr);
+    if (!multicolor) {ierr = MatSORSetMulticolor(pc->pmat,PETSC_TRUE);CHKERRQ(ierr);}
+  }
+  ierr = MatSOR(pc->pmat,b,jac->omega,flag,jac->fshift,its,jac->lits,y);CHKERRQ(ierr);
+  if (jac->multicolor && !multicolor) {ierr = MatSORSetMulticolor(pc->pmat,PETSC_FALSE);CHKERRQ(ierr);}
+  ierr = MatFactorGetError(pc->pmat,(MatFactorError*)&pc->failedreason);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode PCApply_SOR(PC pc,Vec x,Vec y)
 {
   PC_SOR         *jac = (PC_SOR*)pc->data;
@@ -28,8 +50,7 @@ static PetscErrorCode PCApply_SOR(PC pc,Vec x,Vec y)
   PetscInt       flag = jac->sym | SOR_ZERO_INITIAL_GUESS;
 
   PetscFunctionBegin;
-  ierr = MatSOR(pc->pmat,x,jac->omega,(MatSORType)flag,jac->fshift,jac->its,jac->lits,y);CHKERRQ(ierr);
-  ierr = MatFactorGetError(pc->pmat,(MatFactorError*)&pc->failedreason);CHKERRQ(ierr);
+  ierr = PCSORRelax_Private(pc,x,(MatSORType)flag,jac->its,y);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -43,8 +64,7 @@ static PetscErrorCode PCApplyTranspose_SOR(PC pc,Vec x,Vec y)
   PetscFunctionBegin;
   ierr = MatIsSymmetricKnown(pc->pmat,&set,&sym);CHKERRQ(ierr);
   if (!set || !sym || (jac->sym != SOR_SYMMETRIC_SWEEP && jac->sym != SOR_LOCAL_SYMMETRIC_SWEEP)) SETERRQ(PetscObjectComm((PetscObject)pc),PETSC_ERR_SUP,"Can only apply transpose of SOR if matrix is symmetric and sweep is symmetric");
-  ierr = MatSOR(pc->pmat,x,jac->omega,(MatSORType)flag,jac->fshift,jac->its,jac->lits,y);CHKERRQ(ierr);
-  ierr = MatFactorGetError(pc->pmat,(MatFactorError*)&pc->failedreason);CHKERRQ(ierr);
+  ierr = PCSORRelax_Private(pc,x,(MatSORType)flag,jac->its,y);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -57,8 +77,7 @@ static PetscErrorCode PCApplyRichardson_SOR(PC pc,Vec b,Vec y,Vec w,PetscReal rt
   PetscFunctionBegin;
   ierr = PetscInfo1(pc,"Warning, convergence critera ignored, using %D iterations\n",its);CHKERRQ(ierr);
   if (guesszero) stype = (MatSORType) (stype | SOR_ZERO_INITIAL_GUESS);
-  ierr = MatSOR(pc->pmat,b,jac->omega,stype,jac->fshift,its*jac->its,jac->lits,y);CHKERRQ(ierr);
-  ierr = MatFactorGetError(pc->pmat,(MatFactorError*)&pc->failedreason);CHKERRQ(ierr); 
+  ierr = PCSORRelax_Private(pc,b,stype,its*jac->its,y);CHKERRQ(ierr);
   *outits = its;
   *reason = PCRICHARDSON_CONVERGED_ITS;
   PetscFunctionReturn(0);
@@ -76,6 +95,7 @@ PetscErrorCode PCSetFromOptions_SOR(PetscOptionItems *PetscOptionsObject,PC pc)
   ierr = PetscOptionsReal("-pc_sor_diagonal_shift","Add to the diagonal entries","",jac->fshift,&jac->fshift,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsInt("-pc_sor_its","number of inner SOR iterations","PCSORSetIterations",jac->its,&jac->its,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsInt("-pc_sor_lits","number of local inner SOR iterations","PCSORSetIterations",jac->lits,&jac->lits,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-pc_sor_multicolor","relax the rows color by color, with threads","PCSORSetMulticolor",jac->multicolor,&jac->multicolor,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBoolGroupBegin("-pc_sor_symmetric","SSOR, not SOR","PCSORSetSymmetric",&flg);CHKERRQ(ierr);
   if (flg) {ierr = PCSORSetSymmetric(pc,SOR_SYMMETRIC_SWEEP);CHKERRQ(ierr);}
   ierr = PetscOptionsBoolGroup("-pc_sor_backward","use backward sweep instead of forward","PCSORSetSymmetric",&flg);CHKERRQ(ierr);
@@ -115,6 +135,7 @@ PetscErrorCode PCView_SOR(PC pc,PetscViewer viewer)
     else if (sym & SOR_LOCAL_BACKWARD_SWEEP)                                 sortype = "local_backward";
     else                                                                     sortype = "unknown";
     ierr = PetscViewerASCIIPrintf(viewer,"  type = %s, iterations = %D, local iterations = %D, omega = %g\n",sortype,jac->its,jac->lits,(double)jac->omega);CHKERRQ(ierr);
+    if (jac->multicolor) {ierr = PetscViewerASCIIPrintf(viewer,"  using multicolor ordering\n");CHKERRQ(ierr);}
   }
   PetscFunctionReturn(0);
 }
@@ -150,6 +171,24 @@ static PetscErrorCode  PCSORSetIterations_SOR(PC pc,PetscInt its,PetscInt lits)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode  PCSORSetMulticolor_SOR(PC pc,PetscBool flg)
+{
+  PC_SOR *jac = (PC_SOR*)pc->data;
+
+  PetscFunctionBegin;
+  jac->multicolor = flg;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode  PCSORGetMulticolor_SOR(PC pc,PetscBool *flg)
+{
+  PC_SOR *jac = (PC_SOR*)pc->data;
+
+  PetscFunctionBegin;
+  *flg = jac->multicolor;
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode  PCSORGetSymmetric_SOR(PC pc,MatSORType *flag)
 {
   PC_SOR *jac = (PC_SOR*)pc->data;
@@ -395,6 +434,69 @@ PetscErrorCode  PCSORSetIterations(PC pc,PetscInt its,PetscInt lits)
   PetscFunctionReturn(0);
 }
 
+/*@
+   PCSORSetMulticolor - Sets the SOR preconditioner to relax the rows color by color; the colors are independent
+   sets of the graph of the (local part of the) matrix computed once with a MatColoring, so that the rows of
+   each color are relaxed concurrently by the OpenMP threads.
+
+   Logically Collective on PC
+
+   Input Parameters:
++  pc - the preconditioner context
+-  flg - PETSC_TRUE to use the multicolor ordering
+
+   Options Database Keys:
++  -pc_sor_multicolor - Activates the multicolor ordering
+-  -sor_mat_coloring_type <greedy,jp> - the MatColoring used for the colors
+
+   Notes:
+   The sweep type, omega, the diagonal shift and the iteration counts keep their meaning; since the rows are
+   visited in a different order than the natural one the iterates differ, though symmetric sweeps still give a
+   symmetric positive definite preconditioner for symmetric positive definite matrices. Only AIJ matrices support
+   it, other formats ignore it.
+   The ordering is only activated on the matrix while the preconditioner is applied, see MatSORSetMulticolor().
+
+   Level: intermediate
+
+.seealso: PCSORSetSymmetric(), PCSORGetMulticolor(), MatSORSetMulticolor()
+@*/
+PetscErrorCode  PCSORSetMulticolor(PC pc,PetscBool flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidLogicalCollectiveBool(pc,flg,2);
+  ierr = PetscTryMethod(pc,"PCSORSetMulticolor_C",(PC,PetscBool),(pc,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PCSORGetMulticolor - Gets whether the SOR preconditioner relaxes the rows color by color
+
+   Not Collective
+
+   Input Parameter:
+.  pc - the preconditioner context
+
+   Output Parameter:
+.  flg - PETSC_TRUE if the multicolor ordering is used
+
+   Level: intermediate
+
+.seealso: PCSORSetMulticolor()
+@*/
+PetscErrorCode  PCSORGetMulticolor(PC pc,PetscBool *flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidBoolPointer(flg,2);
+  ierr = PetscUseMethod(pc,"PCSORGetMulticolor_C",(PC,PetscBool*),(pc,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*MC
      PCSOR - (S)SOR (successive over relaxation, Gauss-Seidel) preconditioning
 
@@ -408,7 +510,8 @@ PetscErrorCode  PCSORSetIterations(PC pc,PetscInt its,PetscInt lits)
 .  -pc_sor_omega <omega> - Sets omega
 .  -pc_sor_diagonal_shift <shift> - shift the diagonal entries; useful if the matrix has zeros on the diagonal
 .  -pc_sor_its <its> - Sets number of iterations   (default 1)
--  -pc_sor_lits <lits> - Sets number of local iterations  (default 1)
+.  -pc_sor_lits <lits> - Sets number of local iterations  (default 1)
+-  -pc_sor_multicolor - Relax the rows color by color, with the OpenMP threads
 
    Level: beginner
 
@@ -431,7 +534,7 @@ PetscErrorCode  PCSORSetIterations(PC pc,PetscInt its,PetscInt lits)
           the maximum number of iterations you've selected for KSP. It is usually used in this mode as a smoother for multigrid.
 
 .seealso:  PCCreate(), PCSetType(), PCType (for list of available types), PC,
-           PCSORSetIterations(), PCSORSetSymmetric(), PCSORSetOmega(), PCEISENSTAT
+           PCSORSetIterations(), PCSORSetSymmetric(), PCSORSetOmega(), PCSORSetMulticolor(), PCEISENSTAT
 M*/
 
 PETSC_EXTERN PetscErrorCode PCCreate_SOR(PC pc)
@@ -462,6 +565,8 @@ PETSC_EXTERN PetscErrorCode PCCreate_SOR(PC pc)
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCSORGetSymmetric_C",PCSORGetSymmetric_SOR);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCSORGetOmega_C",PCSORGetOmega_SOR);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCSORGetIterations_C",PCSORGetIterations_SOR);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCSORSetMulticolor_C",PCSORSetMulticolor_SOR);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCSORGetMulticolor_C",PCSORGetMulticolor_SOR);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
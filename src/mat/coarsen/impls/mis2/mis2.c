@@ -0,0 +1,309 @@
+#include <petsc/private/matimpl.h>    /*I "petscmat.h" I*/
+#include <../src/mat/impls/aij/seq/aij.h>
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+#include <petscsf.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+extern PetscInt PetscNumOMPThreads;
+#endif
+
+/*
+   The state of a vertex is kept in the two high bits of a key whose low bits are a fixed random
+   priority, a hash of its global index; selected vertices have the largest keys and removed ones the smallest
+*/
+#define MIS2_OUT        0
+#define MIS2_UNDECIDED  1
+#define MIS2_IN         2
+#define MIS2_MASK       (((PetscInt64)1 << 61) - 1)
+#define MIS2_STATE(key) ((PetscInt)((key) >> 61))
+#define MIS2_KEY(state,h) (((PetscInt64)(state) << 61) | (h))
+
+typedef struct {
+  PetscInt nrounds; /* number of rounds of the last MIS */
+} MatCoarsen_MIS2;
+
+/*
+   A bijection of [0,2^61) so that the priorities are distinct, random looking and
+   independent of the number of processes and threads
+*/
+PETSC_STATIC_INLINE PetscInt64 MatCoarsenMIS2Hash(PetscInt gid)
+{
+  uint64_t x = (uint64_t)gid;
+
+  x ^= x >> 31; x = (x * 0x7fb5d329728ea185ULL) & (uint64_t)MIS2_MASK;
+  x ^= x >> 27; x = (x * 0x81dadef4bc2dd44dULL) & (uint64_t)MIS2_MASK;
+  x ^= x >> 33;
+  return (PetscInt64)x;
+}
+
+/*
+   out[i] = max(in[i], in[j], gin[k]) over the neighbors j (local) and k (ghost) of row i
+*/
+static void MatCoarsenMIS2Max_Private(PetscInt nloc,const PetscInt *ai,const PetscInt *aj,const PetscInt *bi,const PetscInt *bj,const PetscInt *browid,const PetscInt64 *in,const PetscInt64 *gin,PetscInt64 *out,PetscInt nt)
+{
+  PetscInt i;
+
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static) if(nt > 1 && nloc > 64)
+#endif
+  for (i=0; i<nloc; i++) {
+    PetscInt64 m = in[i];
+    PetscInt   j,r;
+
+    for (j=ai[i]; j<ai[i+1]; j++) m = PetscMax(m,in[aj[j]]);
+    if (browid && (r = browid[i]) >= 0) {
+      for (j=bi[r]; j<bi[r+1]; j++) m = PetscMax(m,gin[bj[j]]);
+    }
+    out[i] = m;
+  }
+}
+
+/*
+   MatCoarsenApply_MIS2 - distance-2 maximal independent set and aggregates of a graph.
+
+   The MIS is the parallel Luby type algorithm of Bell, Dalton and Olson: in each round every vertex takes the
+   maximum key over its neighbors twice, with a ghost update in between, so that an undecided vertex whose key is
+   the largest within distance two joins the set and an undecided vertex within distance two of a selected one
+   leaves it. Each pass over the local vertices only reads the keys of the previous pass, so it is threaded and the
+   independent set depends neither on the number of threads nor on the number of processes.
+
+   The aggregates are the selected vertices with their neighbors, each joining the selected neighbor with the largest
+   key; a remaining vertex then joins the aggregate of a neighbor when that aggregate is rooted on the same process.
+   The few vertices left, next to process boundaries, are aggregated greedily with their local neighbors.
+*/
+static PetscErrorCode MatCoarsenApply_MIS2(MatCoarsen coarse)
+{
+  MatCoarsen_MIS2  *mis2 = (MatCoarsen_MIS2*)coarse->subctx;
+  Mat              Gmat = coarse->graph;
+  Mat_SeqAIJ       *matA,*matB = NULL;
+  Mat_MPIAIJ       *mpimat = NULL;
+  PetscErrorCode   ierr;
+  MPI_Comm         comm;
+  PetscBool        isMPI,isAIJ;
+  PetscInt         nloc = Gmat->rmap->n,nghosts = 0,my0,Iend,i,j,r,nt = 1,nundone,nselected = 0,nremoved = 0,ngreedy = 0,nrounds = 0;
+  const PetscInt   *ai,*aj,*bi = NULL,*bj = NULL;
+  PetscInt         *browid = NULL,*parent,*gparent = NULL;
+  PetscInt64       *key,*m1,*m2,*gkey = NULL,*gm1 = NULL;
+  PetscInt64       gundone;
+  PetscCoarsenData *agg_lists;
+  PetscLayout      layout;
+  PetscSF          sf = NULL;
+
+  PetscFunctionBegin;
+  if (!coarse->strict_aggs) SETERRQ(PetscObjectComm((PetscObject)coarse),PETSC_ERR_SUP,"Only strict (non overlapping) aggregates");
+  ierr = PetscObjectGetComm((PetscObject)Gmat,&comm);CHKERRQ(ierr);
+  ierr = PetscObjectBaseTypeCompare((PetscObject)Gmat,MATMPIAIJ,&isMPI);CHKERRQ(ierr);
+  if (isMPI) {
+    mpimat = (Mat_MPIAIJ*)Gmat->data;
+    matA   = (Mat_SeqAIJ*)mpimat->A->data;
+    matB   = (Mat_SeqAIJ*)mpimat->B->data;
+    ierr   = MatCheckCompressedRow(mpimat->B,matB->nonzerorowcnt,&matB->compressedrow,matB->i,nloc,-1.0);CHKERRQ(ierr);
+    ierr   = VecGetLocalSize(mpimat->lvec,&nghosts);CHKERRQ(ierr);
+  } else {
+    ierr = PetscObjectBaseTypeCompare((PetscObject)Gmat,MATSEQAIJ,&isAIJ);CHKERRQ(ierr);
+    if (!isAIJ) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_USER,"Require AIJ matrix.");
+    matA = (Mat_SeqAIJ*)Gmat->data;
+  }
+#if defined(PETSC_HAVE_OPENMP)
+  nt = PetscMax(PetscNumOMPThreads,1);
+#endif
+  ierr = MatGetOwnershipRange(Gmat,&my0,&Iend);CHKERRQ(ierr);
+  ai   = matA->i; aj = matA->j;
+  ierr = PetscMalloc4(nloc,&key,nloc,&m1,nloc,&m2,nloc,&parent);CHKERRQ(ierr);
+  if (mpimat) {
+    bi   = matB->compressedrow.i; bj = matB->j;
+    ierr = PetscMalloc4(nloc,&browid,nghosts,&gkey,nghosts,&gm1,nghosts,&gparent);CHKERRQ(ierr);
+    for (i=0; i<nloc; i++) browid[i] = -1;
+    for (r=0; r<matB->compressedrow.nrows; r++) browid[matB->compressedrow.rindex[r]] = r;
+    ierr = PetscSFCreate(comm,&sf);CHKERRQ(ierr);
+    ierr = MatGetLayouts(Gmat,&layout,NULL);CHKERRQ(ierr);
+    ierr = PetscSFSetGraphLayout(sf,layout,nghosts,NULL,PETSC_COPY_VALUES,mpimat->garray);CHKERRQ(ierr);
+  }
+
+  /* vertices without neighbors are removed, they are in no aggregate (parent -2) */
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static) private(j) reduction(+:nremoved) if(nt > 1 && nloc > 64)
+#endif
+  for (i=0; i<nloc; i++) {
+    PetscBool nbr = (PetscBool)(browid && browid[i] >= 0 && bi[browid[i]+1] > bi[browid[i]]);
+
+    for (j=ai[i]; j<ai[i+1] && !nbr; j++) if (aj[j] != i) nbr = PETSC_TRUE;
+    parent[i] = nbr ? -1 : -2;
+    key[i]    = MIS2_KEY(nbr ? MIS2_UNDECIDED : MIS2_OUT,MatCoarsenMIS2Hash(my0+i));
+    if (!nbr) nremoved++;
+  }
+
+  /* MIS-2 */
+  do {
+    nrounds++;
+    if (sf) {
+      ierr = PetscSFBcastBegin(sf,MPIU_INT64,key,gkey);CHKERRQ(ierr);
+      ierr = PetscSFBcastEnd(sf,MPIU_INT64,key,gkey);CHKERRQ(ierr);
+    }
+    MatCoarsenMIS2Max_Private(nloc,ai,aj,bi,bj,browid,key,gkey,m1,nt);
+    if (sf) {
+      ierr = PetscSFBcastBegin(sf,MPIU_INT64,m1,gm1);CHKERRQ(ierr);
+      ierr = PetscSFBcastEnd(sf,MPIU_INT64,m1,gm1);CHKERRQ(ierr);
+    }
+    MatCoarsenMIS2Max_Private(nloc,ai,aj,bi,bj,browid,m1,gm1,m2,nt);
+    nundone = 0;
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static) reduction(+:nundone) if(nt > 1 && nloc > 64)
+#endif
+    for (i=0; i<nloc; i++) {
+      if (MIS2_STATE(key[i]) != MIS2_UNDECIDED) continue;
+      if (m2[i] == key[i]) key[i] = MIS2_KEY(MIS2_IN,key[i] & MIS2_MASK);
+      else if (MIS2_STATE(m2[i]) == MIS2_IN) key[i] = MIS2_KEY(MIS2_OUT,key[i] & MIS2_MASK);
+      else nundone++;
+    }
+    gundone = nundone;
+    if (sf) {ierr = MPIU_Allreduce(MPI_IN_PLACE,&gundone,1,MPIU_INT64,MPI_SUM,comm);CHKERRQ(ierr);}
+  } while (gundone);
+  mis2->nrounds = nrounds;
+
+  /* first the neighbors of the selected vertices, the keys of the ghosts are final after this */
+  if (sf) {
+    ierr = PetscSFBcastBegin(sf,MPIU_INT64,key,gkey);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sf,MPIU_INT64,key,gkey);CHKERRQ(ierr);
+  }
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static) private(j,r) reduction(+:nselected) if(nt > 1 && nloc > 64)
+#endif
+  for (i=0; i<nloc; i++) {
+    PetscInt64 best = -1;
+    PetscInt   p = -1;
+
+    if (parent[i] == -2) continue;
+    if (MIS2_STATE(key[i]) == MIS2_IN) {parent[i] = my0 + i; nselected++; continue;}
+    for (j=ai[i]; j<ai[i+1]; j++) {
+      if (MIS2_STATE(key[aj[j]]) == MIS2_IN && key[aj[j]] > best) {best = key[aj[j]]; p = my0 + aj[j];}
+    }
+    if (browid && (r = browid[i]) >= 0) {
+      for (j=bi[r]; j<bi[r+1]; j++) {
+        if (MIS2_STATE(gkey[bj[j]]) == MIS2_IN && gkey[bj[j]] > best) {best = gkey[bj[j]]; p = mpimat->garray[bj[j]];}
+      }
+    }
+    parent[i] = p;
+  }
+
+  /* then the vertices at distance two, joining the aggregate of a neighbor rooted on this process */
+  if (sf) {
+    ierr = PetscSFBcastBegin(sf,MPIU_INT,parent,gparent);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sf,MPIU_INT,parent,gparent);CHKERRQ(ierr);
+  }
+  /* m1 is reused as the list of the new parents, so the pass only reads those of the previous one */
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static) private(j,r) if(nt > 1 && nloc > 64)
+#endif
+  for (i=0; i<nloc; i++) {
+    PetscInt64 best = -1,h;
+    PetscInt   p = parent[i],q;
+
+    if (p == -1) {
+      for (j=ai[i]; j<ai[i+1]; j++) {
+        q = parent[aj[j]];
+        if (q >= my0 && q < Iend && (h = MatCoarsenMIS2Hash(q)) > best) {best = h; p = q;}
+      }
+      if (browid && (r = browid[i]) >= 0) {
+        for (j=bi[r]; j<bi[r+1]; j++) {
+          q = gparent[bj[j]];
+          if (q >= my0 && q < Iend && (h = MatCoarsenMIS2Hash(q)) > best) {best = h; p = q;}
+        }
+      }
+    }
+    m1[i] = p;
+  }
+  for (i=0; i<nloc; i++) parent[i] = (PetscInt)m1[i];
+
+  /* the rest start new aggregates with their local neighbors that are left */
+  for (i=0; i<nloc; i++) {
+    if (parent[i] != -1) continue;
+    parent[i] = my0 + i;
+    ngreedy++;
+    for (j=ai[i]; j<ai[i+1]; j++) if (parent[aj[j]] == -1) parent[aj[j]] = my0 + i;
+  }
+
+  /* the aggregates of the local roots, each one headed by its root; the ghosts joining a local root are added last */
+  ierr = PetscCDCreate(nloc,&agg_lists);CHKERRQ(ierr);
+  coarse->agg_lists = agg_lists;
+  for (i=0; i<nloc; i++) {
+    if (parent[i] == my0 + i) {ierr = PetscCDAppendID(agg_lists,i,my0+i);CHKERRQ(ierr);}
+  }
+  for (i=0; i<nloc; i++) {
+    if (parent[i] >= my0 && parent[i] < Iend && parent[i] != my0 + i) {ierr = PetscCDAppendID(agg_lists,parent[i]-my0,my0+i);CHKERRQ(ierr);}
+  }
+  if (sf) {
+    ierr = PetscSFBcastBegin(sf,MPIU_INT,parent,gparent);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sf,MPIU_INT,parent,gparent);CHKERRQ(ierr);
+    for (j=0; j<nghosts; j++) {
+      if (gparent[j] >= my0 && gparent[j] < Iend) {ierr = PetscCDAppendID(agg_lists,gparent[j]-my0,mpimat->garray[j]);CHKERRQ(ierr);}
+    }
+  }
+  ierr = PetscInfo5(Gmat,"\t %D rounds, removed %D of %D vertices, %D selected, %D aggregates added next to process boundaries\n",nrounds,nremoved,nloc,nselected,ngreedy);CHKERRQ(ierr);
+
+  ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+  ierr = PetscFree4(key,m1,m2,parent);CHKERRQ(ierr);
+  if (mpimat) {ierr = PetscFree4(browid,gkey,gm1,gparent);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatCoarsenView_MIS2(MatCoarsen coarse,PetscViewer viewer)
+{
+  MatCoarsen_MIS2 *mis2 = (MatCoarsen_MIS2*)coarse->subctx;
+  PetscErrorCode  ierr;
+  PetscBool       iascii;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  distance-2 MIS aggregator, %D rounds in the last coarsening\n",mis2->nrounds);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatCoarsenDestroy_MIS2(MatCoarsen coarse)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(coarse->subctx);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   MATCOARSENMIS2 - Aggregates a graph with a distance-2 maximal independent set computed with threads
+
+   Collective
+
+   Input Parameter:
+.  coarse - the coarsen context
+
+   Notes:
+   The selected vertices are at least three edges apart and every vertex is within two edges of one, so the aggregates
+   are those that MATCOARSENMIS produces on the square of the graph, without forming the squared graph. The random
+   priorities are a hash of the global vertex numbers, thus the independent set is the same for any number of processes
+   and OpenMP threads (-omp_num_threads) and the greedy ordering of MatCoarsenSetGreedyOrdering() is not used.
+
+   PCGAMG uses it in place of squaring the graph on the levels selected with -pc_gamg_square_graph when -mat_coarsen_type mis2 is given.
+
+   Only strict aggregates are supported, see MatCoarsenSetStrictAggs().
+
+   Level: beginner
+
+.seealso: MatCoarsenSetType(), MatCoarsenType, MATCOARSENMIS
+M*/
+
+PETSC_EXTERN PetscErrorCode MatCoarsenCreate_MIS2(MatCoarsen coarse)
+{
+  PetscErrorCode  ierr;
+  MatCoarsen_MIS2 *mis2;
+
+  PetscFunctionBegin;
+  ierr           = PetscNewLog(coarse,&mis2);CHKERRQ(ierr);
+  coarse->subctx = (void*)mis2;
+
+  coarse->ops->apply   = MatCoarsenApply_MIS2;
+  coarse->ops->view    = MatCoarsenView_MIS2;
+  coarse->ops->destroy = MatCoarsenDestroy_MIS2;
+  PetscFunctionReturn(0);
+}
@@ -3,6 +3,7 @@
 #include <petsc/private/matimpl.h>
 
 PETSC_EXTERN PetscErrorCode MatCoarsenCreate_MIS(MatCoarsen);
+PETSC_EXTERN PetscErrorCode MatCoarsenCreate_MIS2(MatCoarsen);
 PETSC_EXTERN PetscErrorCode MatCoarsenCreate_HEM(MatCoarsen);
 
 /*@C
@@ -34,6 +35,7 @@ PetscErrorCode  MatCoarsenRegisterAll(void)
   MatCoarsenRegisterAllCalled = PETSC_TRUE;
 
   ierr = MatCoarsenRegister(MATCOARSENMIS,MatCoarsenCreate_MIS);CHKERRQ(ierr);
+  ierr = MatCoarsenRegister(MATCOARSENMIS2,MatCoarsenCreate_MIS2);CHKERRQ(ierr);
   ierr = MatCoarsenRegister(MATCOARSENHEM,MatCoarsenCreate_HEM);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
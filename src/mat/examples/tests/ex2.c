@@ -191,6 +191,12 @@ int main(int argc,char **argv)
       args: -mat_type seqaij -rectA
       filter: grep -v "Mat Object"
 
+   test:
+      suffix: 11_A_hash
+      args: -mat_type seqaij -rectA -mat_hash_assembly
+      filter: grep -v "Mat Object"
+      output_file: output/ex2_11_A.out
+
    test:
       suffix: 12_A
       args: -mat_type seqdense -rectA
@@ -220,6 +226,13 @@ int main(int argc,char **argv)
       args: -mat_type mpiaij
       filter: grep -v type | grep -v "MPI processes"
 
+   test:
+      suffix: 23_hash
+      nsize: 3
+      args: -mat_type mpiaij -mat_hash_assembly
+      filter: grep -v type | grep -v "MPI processes"
+      output_file: output/ex2_23.out
+
    test:
       suffix: 24
       nsize: 3
@@ -0,0 +1,111 @@
+static char help[] = "Tests MatSetPreallocationCOO() and MatSetValuesCOO()\n\n";
+
+#include <petscmat.h>
+
+/*
+   Element-by-element assembly of a 1d stencil: element e couples rows e and e+1. Elements are split evenly
+   among the processes, independently of the row ownership, so some entries are off-process and most are repeated.
+   Each process also passes an entry with a negative row index that must be ignored.
+*/
+static PetscErrorCode GetCOO(PetscInt N,PetscInt *n,PetscInt **coo_i,PetscInt **coo_j)
+{
+  PetscMPIInt    rank,size;
+  PetscInt       ne = N-1,estart,eend,e,k = 0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr   = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr   = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  estart = (ne*rank)/size;
+  eend   = (ne*(rank+1))/size;
+  *n     = 4*(eend-estart)+1;
+  ierr   = PetscMalloc2(*n,coo_i,*n,coo_j);CHKERRQ(ierr);
+  for (e=estart; e<eend; e++) {
+    (*coo_i)[k] = e;   (*coo_j)[k++] = e;
+    (*coo_i)[k] = e;   (*coo_j)[k++] = e+1;
+    (*coo_i)[k] = e+1; (*coo_j)[k++] = e;
+    (*coo_i)[k] = e+1; (*coo_j)[k++] = e+1;
+  }
+  (*coo_i)[k] = -1; (*coo_j)[k++] = 0;
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Mat            A,B;
+  PetscInt       N = 12,n,k,it,*coo_i,*coo_j;
+  PetscScalar    *coo_v;
+  PetscReal      norm;
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-N",&N,NULL);CHKERRQ(ierr);
+  ierr = GetCOO(N,&n,&coo_i,&coo_j);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&coo_v);CHKERRQ(ierr);
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,N,N);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSetPreallocationCOO(A,n,coo_i,coo_j);CHKERRQ(ierr);
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&B);CHKERRQ(ierr);
+  ierr = MatSetSizes(B,PETSC_DECIDE,PETSC_DECIDE,N,N);CHKERRQ(ierr);
+  ierr = MatSetType(B,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSetUp(B);CHKERRQ(ierr);
+
+  /* assemble several times with new values to check that the cached communication and positions are reused correctly */
+  for (it=0; it<3; it++) {
+    for (k=0; k<n; k++) coo_v[k] = (PetscScalar)(1 + it + coo_i[k] + 2*coo_j[k]);
+    ierr = MatSetValuesCOO(A,coo_v,INSERT_VALUES);CHKERRQ(ierr);
+    if (it == 2) { /* adding the same values again doubles the matrix */
+      ierr = MatSetValuesCOO(A,coo_v,ADD_VALUES);CHKERRQ(ierr);
+    }
+
+    ierr = MatZeroEntries(B);CHKERRQ(ierr);
+    for (k=0; k<n; k++) {
+      ierr = MatSetValue(B,coo_i[k],coo_j[k],coo_v[k],ADD_VALUES);CHKERRQ(ierr);
+    }
+    ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    if (it == 2) {
+      ierr = MatScale(B,2.0);CHKERRQ(ierr);
+    }
+
+    ierr = MatMultEqual(A,B,4,&flg);CHKERRQ(ierr);
+    if (!flg) {
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"Iteration %D: MatSetValuesCOO() and MatSetValues() give different matrices\n",it);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatNorm(A,NORM_FROBENIUS,&norm);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Norm %g\n",(double)norm);CHKERRQ(ierr);
+
+  ierr = PetscFree(coo_v);CHKERRQ(ierr);
+  ierr = PetscFree2(coo_i,coo_j);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      nsize: {{1 3}}
+      args: -mat_type aij
+      output_file: output/ex242_1.out
+
+   test:
+      suffix: baij
+      nsize: {{1 3}}
+      args: -mat_type baij -mat_block_size 2
+      output_file: output/ex242_1.out
+
+   test:
+      suffix: dense
+      nsize: {{1 3}}
+      args: -mat_type dense
+      output_file: output/ex242_1.out
+
+TEST*/
@@ -0,0 +1,111 @@
+static char help[] = "Tests the MATAIJAUTO format autotuner.\n\n";
+
+#include <petscmat.h>
+
+int main(int argc,char **argv)
+{
+  Mat            A,B;
+  Vec            x,y;
+  PetscInt       nb = 20,bs = 2,rstart,rend,row,ib,jb,c,k,cols[3*8];
+  PetscScalar    vals[3*8];
+  PetscReal      norm;
+  PetscBool      flg;
+  MatType        type;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nb",&nb,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-bs",&bs,NULL);CHKERRQ(ierr);
+  if (bs < 1 || bs > 8) SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_ARG_OUTOFRANGE,"Block size must be between 1 and 8");
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,nb*bs,nb*bs);CHKERRQ(ierr);
+  ierr = MatSetBlockSize(A,bs);CHKERRQ(ierr);
+  ierr = MatSetType(A,MATAIJAUTO);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,3*bs,NULL);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,3*bs,NULL,2*bs,NULL);CHKERRQ(ierr);
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,nb*bs,nb*bs,3*bs,NULL,2*bs,NULL,&B);CHKERRQ(ierr);
+  ierr = MatCreateVecs(B,&x,&y);CHKERRQ(ierr);
+  ierr = VecSet(x,1.0);CHKERRQ(ierr);
+
+  /*
+     A 1d three point stencil of dense bs x bs blocks whose values only depend on the row and column, so that the
+     same matrix is obtained for any number of processes; the tuned matrix is an ordinary matrix of its new type
+     after the first assembly, so the second one checks that assembling it again keeps it working
+  */
+  for (k=0; k<2; k++) {
+    ierr = MatGetOwnershipRange(B,&rstart,&rend);CHKERRQ(ierr);
+    for (row=rstart; row<rend; row++) {
+      ib = row/bs;
+      c  = 0;
+      for (jb=PetscMax(ib-1,0); jb<=PetscMin(ib+1,nb-1); jb++) {
+        PetscInt l;
+
+        for (l=0; l<bs; l++) {
+          cols[c] = jb*bs+l;
+          vals[c] = (cols[c] == row) ? 4.0 : -1.0/(1 + row + cols[c]);
+          c++;
+        }
+      }
+      ierr = MatSetValues(A,1,&row,c,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
+      if (!k) {ierr = MatSetValues(B,1,&row,c,cols,vals,INSERT_VALUES);CHKERRQ(ierr);}
+    }
+    ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    if (!k) {
+      ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+      ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    }
+
+    ierr = MatMultEqual(A,B,4,&flg);CHKERRQ(ierr);
+    ierr = MatMult(A,x,y);CHKERRQ(ierr);
+    ierr = VecNorm(y,NORM_2,&norm);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Assembly %D: products equal to AIJ %s, norm of the row sums %g\n",k,PetscBools[flg],(double)norm);CHKERRQ(ierr);
+  }
+
+  /* the selected format depends on the timings, only print it when there is a single candidate */
+  ierr = PetscOptionsHasName(NULL,NULL,"-mat_aijauto_types",&flg);CHKERRQ(ierr);
+  if (flg) {
+    ierr = MatGetType(A,&type);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Matrix type %s\n",type);CHKERRQ(ierr);
+  }
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      nsize: {{1 2}}
+      output_file: output/ex243_1.out
+
+   test:
+      suffix: baij
+      args: -mat_aijauto_types baij
+      output_file: output/ex243_baij.out
+
+   test:
+      suffix: baij_2
+      nsize: 2
+      args: -mat_aijauto_types baij
+      output_file: output/ex243_baij_2.out
+
+   test:
+      suffix: sell
+      args: -bs 1 -mat_aijauto_types sell
+      output_file: output/ex243_sell.out
+
+   test:
+      suffix: crl_2
+      nsize: 2
+      args: -bs 3 -mat_aijauto_types aijcrl
+      output_file: output/ex243_crl_2.out
+
+TEST*/
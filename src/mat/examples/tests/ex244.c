@@ -0,0 +1,196 @@
+static char help[] = "Tests MATAIJSINGLE against MATAIJ: products, SOR sweeps and factor solves.\n\n";
+
+#include <petscmat.h>
+#include <float.h>
+
+/*
+   Assembles a 2d five point stencil with variable coefficients on an n x n grid
+*/
+static PetscErrorCode AssembleMatrix(Mat A,PetscInt n)
+{
+  PetscInt       rstart,rend,row,i,j;
+  PetscScalar    v;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (row=rstart; row<rend; row++) {
+    i = row/n; j = row - i*n;
+    v = -1.0/(1 + i + j);
+    if (i>0)   {ierr = MatSetValue(A,row,row-n,v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<n-1) {ierr = MatSetValue(A,row,row+n,v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {ierr = MatSetValue(A,row,row-1,v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<n-1) {ierr = MatSetValue(A,row,row+1,v,INSERT_VALUES);CHKERRQ(ierr);}
+    ierr = MatSetValue(A,row,row,4.0 + 1.0/(1 + row),INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The single precision copy rounds every stored value once, so results may differ from the double precision ones
+   by a small multiple of the single precision unit round off; this is the only tolerance used in the test
+*/
+#define SINGLE_TOL (100*FLT_EPSILON)
+
+/* Prints whether the relative difference of x and y is within SINGLE_TOL */
+static PetscErrorCode CheckVecs(Vec x,Vec y,const char *op)
+{
+  Vec            d;
+  PetscReal      nd,nx;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDuplicate(x,&d);CHKERRQ(ierr);
+  ierr = VecWAXPY(d,-1.0,x,y);CHKERRQ(ierr);
+  ierr = VecNorm(d,NORM_2,&nd);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_2,&nx);CHKERRQ(ierr);
+  if (nd > SINGLE_TOL*nx) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%s differs: relative difference %g\n",op,(double)(nd/nx));CHKERRQ(ierr);}
+  else {ierr = PetscPrintf(PETSC_COMM_WORLD,"%s agrees\n",op);CHKERRQ(ierr);}
+  ierr = VecDestroy(&d);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckMult(Mat A,Mat B,Vec x,Vec y,Vec z)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = MatMult(B,x,z);CHKERRQ(ierr);
+  ierr = CheckVecs(y,z,"MatMult()");CHKERRQ(ierr);
+  ierr = MatMultAdd(A,x,y,y);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,z,z);CHKERRQ(ierr);
+  ierr = CheckVecs(y,z,"MatMultAdd()");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Mat            A,B,FA,FB;
+  Vec            x,y,z;
+  PetscInt       n = 10,k;
+  PetscMPIInt    size;
+  PetscRandom    rand;
+  MatType        type;
+  IS             rperm,cperm;
+  MatFactorInfo  info;
+  PetscErrorCode ierr;
+  const MatSORType sortypes[] = {SOR_FORWARD_SWEEP,SOR_BACKWARD_SWEEP,SOR_SYMMETRIC_SWEEP,SOR_APPLY_UPPER};
+  const char       *sornames[] = {"MatSOR() forward","MatSOR() backward","MatSOR() symmetric","MatSOR() apply upper"};
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,n*n,n*n,5,NULL,2,NULL,&A);CHKERRQ(ierr);
+  ierr = AssembleMatrix(A,n);CHKERRQ(ierr);
+  ierr = MatConvert(A,MATAIJSINGLE,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+  ierr = MatGetType(B,&type);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Matrix type %s\n",type);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rand);CHKERRQ(ierr);
+
+  ierr = CheckMult(A,B,x,y,z);CHKERRQ(ierr);
+
+  /* the single precision copy must follow changes of the values */
+  ierr = MatScale(A,2.0);CHKERRQ(ierr);
+  ierr = MatScale(B,2.0);CHKERRQ(ierr);
+  ierr = CheckMult(A,B,x,y,z);CHKERRQ(ierr);
+  ierr = MatDiagonalScale(A,x,NULL);CHKERRQ(ierr);
+  ierr = MatDiagonalScale(B,x,NULL);CHKERRQ(ierr);
+  ierr = CheckMult(A,B,x,y,z);CHKERRQ(ierr);
+  ierr = AssembleMatrix(A,n);CHKERRQ(ierr);
+  ierr = AssembleMatrix(B,n);CHKERRQ(ierr);
+  ierr = CheckMult(A,B,x,y,z);CHKERRQ(ierr);
+
+  if (size == 1) {
+    PetscScalar *a;
+
+    ierr = MatSeqAIJGetArray(B,&a);CHKERRQ(ierr);
+    a[0] = 3.0;
+    ierr = MatSeqAIJRestoreArray(B,&a);CHKERRQ(ierr);
+    ierr = MatSetValue(A,0,0,3.0,INSERT_VALUES);CHKERRQ(ierr);
+    ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = CheckMult(A,B,x,y,z);CHKERRQ(ierr);
+
+    for (k=0; k<4; k++) {
+      ierr = VecSet(y,0.0);CHKERRQ(ierr);
+      ierr = VecSet(z,0.0);CHKERRQ(ierr);
+      ierr = MatSOR(A,x,1.2,sortypes[k],0.0,2,1,y);CHKERRQ(ierr);
+      ierr = MatSOR(B,x,1.2,sortypes[k],0.0,2,1,z);CHKERRQ(ierr);
+      ierr = CheckVecs(y,z,sornames[k]);CHKERRQ(ierr);
+    }
+    ierr = MatSOR(A,x,1.0,(MatSORType)(SOR_ZERO_INITIAL_GUESS | SOR_SYMMETRIC_SWEEP),0.0,1,1,y);CHKERRQ(ierr);
+    ierr = MatSOR(B,x,1.0,(MatSORType)(SOR_ZERO_INITIAL_GUESS | SOR_SYMMETRIC_SWEEP),0.0,1,1,z);CHKERRQ(ierr);
+    ierr = CheckVecs(y,z,"MatSOR() zero initial guess");CHKERRQ(ierr);
+    ierr = MatSOR(A,x,1.0,SOR_EISENSTAT,0.0,1,1,y);CHKERRQ(ierr);
+    ierr = MatSOR(B,x,1.0,SOR_EISENSTAT,0.0,1,1,z);CHKERRQ(ierr);
+    ierr = CheckVecs(y,z,"MatSOR() Eisenstat");CHKERRQ(ierr);
+
+    /* factor solves, the numeric factorization is done twice to check that the copy is refreshed */
+    ierr = MatFactorInfoInitialize(&info);CHKERRQ(ierr);
+    info.fill = 1.0;
+    ierr = MatGetOrdering(A,MATORDERINGRCM,&rperm,&cperm);CHKERRQ(ierr);
+    ierr = MatGetFactor(A,MATSOLVERPETSC,MAT_FACTOR_ILU,&FA);CHKERRQ(ierr);
+    ierr = MatGetFactor(B,MATSOLVERPETSC,MAT_FACTOR_ILU,&FB);CHKERRQ(ierr);
+    ierr = MatILUFactorSymbolic(FA,A,rperm,cperm,&info);CHKERRQ(ierr);
+    ierr = MatILUFactorSymbolic(FB,B,rperm,cperm,&info);CHKERRQ(ierr);
+    for (k=0; k<2; k++) {
+      ierr = MatScale(A,2.0);CHKERRQ(ierr);
+      ierr = MatScale(B,2.0);CHKERRQ(ierr);
+      ierr = MatLUFactorNumeric(FA,A,&info);CHKERRQ(ierr);
+      ierr = MatLUFactorNumeric(FB,B,&info);CHKERRQ(ierr);
+      ierr = MatSolve(FA,x,y);CHKERRQ(ierr);
+      ierr = MatSolve(FB,x,z);CHKERRQ(ierr);
+      ierr = CheckVecs(y,z,"MatSolve() ILU");CHKERRQ(ierr);
+    }
+    ierr = MatDestroy(&FA);CHKERRQ(ierr);
+    ierr = MatDestroy(&FB);CHKERRQ(ierr);
+
+    ierr = MatGetFactor(A,MATSOLVERPETSC,MAT_FACTOR_LU,&FA);CHKERRQ(ierr);
+    ierr = MatGetFactor(B,MATSOLVERPETSC,MAT_FACTOR_LU,&FB);CHKERRQ(ierr);
+    ierr = MatLUFactorSymbolic(FA,A,rperm,cperm,&info);CHKERRQ(ierr);
+    ierr = MatLUFactorSymbolic(FB,B,rperm,cperm,&info);CHKERRQ(ierr);
+    ierr = MatLUFactorNumeric(FA,A,&info);CHKERRQ(ierr);
+    ierr = MatLUFactorNumeric(FB,B,&info);CHKERRQ(ierr);
+    ierr = MatSolve(FA,x,y);CHKERRQ(ierr);
+    ierr = MatSolve(FB,x,z);CHKERRQ(ierr);
+    ierr = CheckVecs(y,z,"MatSolve() LU");CHKERRQ(ierr);
+    ierr = MatDestroy(&FA);CHKERRQ(ierr);
+    ierr = MatDestroy(&FB);CHKERRQ(ierr);
+    ierr = ISDestroy(&rperm);CHKERRQ(ierr);
+    ierr = ISDestroy(&cperm);CHKERRQ(ierr);
+  }
+
+  /* converting back gives a plain AIJ matrix */
+  ierr = MatConvert(B,MATAIJ,MAT_INPLACE_MATRIX,&B);CHKERRQ(ierr);
+  ierr = CheckMult(A,B,x,y,z);CHKERRQ(ierr);
+
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+
+   test:
+      suffix: 2
+      nsize: 2
+      args: -n 12
+
+TEST*/
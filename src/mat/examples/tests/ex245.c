@@ -0,0 +1,116 @@
+static char help[] = "Tests MATAIJDELTA against MATAIJ: products and SOR sweeps, with rows too wide for the compressed indices.\n\n";
+
+#include <petscmat.h>
+
+int main(int argc,char **argv)
+{
+  Mat            A,B,M[2];
+  Vec            x,y,z;
+  PetscInt       n = 70000,stride = 1000,k,row,rstart,rend;
+  PetscMPIInt    size;
+  PetscBool      flg;
+  PetscRandom    rand;
+  MatType        type;
+  PetscErrorCode ierr;
+  const MatSORType sortypes[] = {SOR_FORWARD_SWEEP,SOR_BACKWARD_SWEEP,SOR_SYMMETRIC_SWEEP,SOR_APPLY_UPPER};
+  const char       *sornames[] = {"MatSOR() forward","MatSOR() backward","MatSOR() symmetric","MatSOR() apply upper"};
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-stride",&stride,NULL);CHKERRQ(ierr);
+
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,n,n,4,NULL,2,NULL,&A);CHKERRQ(ierr);
+  ierr = MatCreate(PETSC_COMM_WORLD,&B);CHKERRQ(ierr);
+  ierr = MatSetSizes(B,PETSC_DECIDE,PETSC_DECIDE,n,n);CHKERRQ(ierr);
+  ierr = MatSetType(B,MATAIJDELTA);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(B,4,NULL);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(B,4,NULL,2,NULL);CHKERRQ(ierr);
+
+  /*
+     A tridiagonal matrix with, every stride rows, an entry in the last column, so that these rows span more
+     columns than the 16-bit offsets can reach when n is larger than 65536
+  */
+  M[0] = A; M[1] = B;
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (k=0; k<2; k++) {
+    for (row=rstart; row<rend; row++) {
+      if (row>0)   {ierr = MatSetValue(M[k],row,row-1,-1.0/(1 + row),INSERT_VALUES);CHKERRQ(ierr);}
+      if (row<n-1) {ierr = MatSetValue(M[k],row,row+1,-1.0/(2 + row),INSERT_VALUES);CHKERRQ(ierr);}
+      ierr = MatSetValue(M[k],row,row,4.0,INSERT_VALUES);CHKERRQ(ierr);
+      if (!(row % stride) && row < n-2) {ierr = MatSetValue(M[k],row,n-1,0.5,INSERT_VALUES);CHKERRQ(ierr);}
+    }
+    ierr = MatAssemblyBegin(M[k],MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(M[k],MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  }
+  ierr = MatGetType(B,&type);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Matrix type %s\n",type);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rand);CHKERRQ(ierr);
+
+  ierr = MatMultEqual(A,B,4,&flg);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"MatMult() equal %s\n",PetscBools[flg]);CHKERRQ(ierr);
+  ierr = MatMultAddEqual(A,B,4,&flg);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"MatMultAdd() equal %s\n",PetscBools[flg]);CHKERRQ(ierr);
+
+  /* the sweeps only decode the column indices differently, so they must give bitwise identical results */
+  if (size == 1) {
+    for (k=0; k<4; k++) {
+      ierr = VecSet(y,0.0);CHKERRQ(ierr);
+      ierr = VecSet(z,0.0);CHKERRQ(ierr);
+      ierr = MatSOR(A,x,1.2,sortypes[k],0.0,2,1,y);CHKERRQ(ierr);
+      ierr = MatSOR(B,x,1.2,sortypes[k],0.0,2,1,z);CHKERRQ(ierr);
+      ierr = VecEqual(y,z,&flg);CHKERRQ(ierr);
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"%s equal %s\n",sornames[k],PetscBools[flg]);CHKERRQ(ierr);
+    }
+    ierr = MatSOR(A,x,1.0,(MatSORType)(SOR_ZERO_INITIAL_GUESS | SOR_SYMMETRIC_SWEEP),0.0,1,1,y);CHKERRQ(ierr);
+    ierr = MatSOR(B,x,1.0,(MatSORType)(SOR_ZERO_INITIAL_GUESS | SOR_SYMMETRIC_SWEEP),0.0,1,1,z);CHKERRQ(ierr);
+    ierr = VecEqual(y,z,&flg);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"MatSOR() zero initial guess equal %s\n",PetscBools[flg]);CHKERRQ(ierr);
+    ierr = MatSOR(A,x,1.0,SOR_EISENSTAT,0.0,1,1,y);CHKERRQ(ierr);
+    ierr = MatSOR(B,x,1.0,SOR_EISENSTAT,0.0,1,1,z);CHKERRQ(ierr);
+    ierr = VecEqual(y,z,&flg);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"MatSOR() Eisenstat equal %s\n",PetscBools[flg]);CHKERRQ(ierr);
+  }
+
+  /* a new nonzero in the first column of the last row makes that row too wide as well */
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatSetOption(B,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,NULL,&row);CHKERRQ(ierr);
+  if (row == n) {
+    ierr = MatSetValue(A,n-1,0,2.0,INSERT_VALUES);CHKERRQ(ierr);
+    ierr = MatSetValue(B,n-1,0,2.0,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatMultEqual(A,B,4,&flg);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"MatMult() with the new nonzero equal %s\n",PetscBools[flg]);CHKERRQ(ierr);
+  ierr = MatMultAddEqual(A,B,4,&flg);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"MatMultAdd() with the new nonzero equal %s\n",PetscBools[flg]);CHKERRQ(ierr);
+
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+
+   test:
+      suffix: 2
+      nsize: 2
+
+TEST*/
@@ -0,0 +1,129 @@
+static char help[] = "Tests the level scheduled triangular solves of LU and ILU factors of SeqAIJ matrices, with and without inodes.\n\n";
+
+#include <petscmat.h>
+
+/*
+   Factors A twice, the second factor with the options prefix levels_, and compares the solves with the tolerance
+   of MatMultEqual(); they only agree up to round off since the sequential solve of factors with inodes uses
+   unrolled kernels. The levels of the schedule are shown by MatView().
+*/
+static PetscErrorCode CheckFactor(Mat A,MatFactorType ftype,MatOrderingType otype,PetscReal levels,Vec x,Vec y,Vec z,const char *op)
+{
+  Mat            F[2];
+  IS             rperm,cperm;
+  MatFactorInfo  info;
+  PetscInt       k,l;
+  PetscReal      nd,ny;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatFactorInfoInitialize(&info);CHKERRQ(ierr);
+  info.fill   = 2.0;
+  info.levels = levels;
+  ierr = MatGetOrdering(A,otype,&rperm,&cperm);CHKERRQ(ierr);
+  for (k=0; k<2; k++) {
+    ierr = MatGetFactor(A,MATSOLVERPETSC,ftype,&F[k]);CHKERRQ(ierr);
+    if (k) {ierr = MatSetOptionsPrefix(F[k],"levels_");CHKERRQ(ierr);}
+    if (ftype == MAT_FACTOR_LU) {ierr = MatLUFactorSymbolic(F[k],A,rperm,cperm,&info);CHKERRQ(ierr);}
+    else {ierr = MatILUFactorSymbolic(F[k],A,rperm,cperm,&info);CHKERRQ(ierr);}
+  }
+  /* the numeric factorization is done twice to check that the schedule of the symbolic factorization is reused */
+  for (l=0; l<2; l++) {
+    for (k=0; k<2; k++) {ierr = MatLUFactorNumeric(F[k],A,&info);CHKERRQ(ierr);}
+    ierr = MatSolve(F[0],x,y);CHKERRQ(ierr);
+    ierr = MatSolve(F[1],x,z);CHKERRQ(ierr);
+    ierr = VecNorm(y,NORM_2,&ny);CHKERRQ(ierr);
+    ierr = VecAXPY(z,-1.0,y);CHKERRQ(ierr);
+    ierr = VecNorm(z,NORM_2,&nd);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_SELF,"%s agrees with the sequential solve %s\n",op,PetscBools[nd <= PETSC_SQRT_MACHINE_EPSILON*ny]);CHKERRQ(ierr);
+  }
+  ierr = PetscViewerPushFormat(PETSC_VIEWER_STDOUT_SELF,PETSC_VIEWER_ASCII_INFO);CHKERRQ(ierr);
+  ierr = MatView(F[1],PETSC_VIEWER_STDOUT_SELF);CHKERRQ(ierr);
+  ierr = PetscViewerPopFormat(PETSC_VIEWER_STDOUT_SELF);CHKERRQ(ierr);
+  for (k=0; k<2; k++) {ierr = MatDestroy(&F[k]);CHKERRQ(ierr);}
+  ierr = ISDestroy(&rperm);CHKERRQ(ierr);
+  ierr = ISDestroy(&cperm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Mat            A;
+  Vec            x,y,z;
+  PetscInt       n = 12,bs = 1,row,i,j,k,l,c,col[5],nc;
+  PetscScalar    v;
+  PetscRandom    rand;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-bs",&bs,NULL);CHKERRQ(ierr);
+
+  /*
+     A 2d five point stencil on an n x n grid with bs coupled unknowns per grid point; the unknowns of a
+     grid point have the same nonzero structure so the factors have inodes when bs > 1
+  */
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,n*n*bs,n*n*bs,5*bs,NULL,&A);CHKERRQ(ierr);
+  for (row=0; row<n*n; row++) {
+    i = row/n; j = row - i*n; nc = 0;
+    if (i>0)   col[nc++] = row-n;
+    if (j>0)   col[nc++] = row-1;
+    col[nc++] = row;
+    if (j<n-1) col[nc++] = row+1;
+    if (i<n-1) col[nc++] = row+n;
+    for (k=0; k<bs; k++) {
+      for (l=0; l<nc; l++) {
+        for (c=0; c<bs; c++) {
+          if (col[l] == row) v = (c == k) ? 4.0*bs + 1.0/(1 + row) : -0.5/(1 + c + k);
+          else v = (c == k) ? -1.0/(1 + i + j) : 0.1/(1 + c + k + l);
+          ierr = MatSetValue(A,row*bs+k,col[l]*bs+c,v,INSERT_VALUES);CHKERRQ(ierr);
+        }
+      }
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rand);CHKERRQ(ierr);
+
+  ierr = CheckFactor(A,MAT_FACTOR_ILU,MATORDERINGNATURAL,0,x,y,z,"MatSolve() ILU(0)");CHKERRQ(ierr);
+  ierr = CheckFactor(A,MAT_FACTOR_ILU,MATORDERINGRCM,2,x,y,z,"MatSolve() ILU(2)");CHKERRQ(ierr);
+  ierr = CheckFactor(A,MAT_FACTOR_LU,MATORDERINGND,0,x,y,z,"MatSolve() LU");CHKERRQ(ierr);
+
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      args: -levels_mat_solve_levels
+      output_file: output/ex246_1.out
+
+   test:
+      suffix: 2
+      args: -levels_mat_solve_levels -bs 3
+      output_file: output/ex246_2.out
+
+   test:
+      suffix: threads
+      requires: openmp
+      args: -omp_num_threads 3 -mat_solve_levels 0 -levels_mat_solve_levels
+      output_file: output/ex246_1.out
+
+   test:
+      suffix: threads_inode
+      requires: openmp
+      args: -omp_num_threads 4 -mat_solve_levels 0 -levels_mat_solve_levels -bs 3
+      output_file: output/ex246_2.out
+
+TEST*/
@@ -0,0 +1,123 @@
+static char help[] = "Tests MatMultMultiple() and MatMatMult() with a dense matrix against MatMult() for AIJ matrices.\n\n";
+
+#include <petscmat.h>
+
+int main(int argc,char **argv)
+{
+  Mat               A,B,C;
+  Vec               *x,*y,z,d,col;
+  PetscInt          i,j,k,l,rstart,rend,n = 30,N,nvecs[] = {1,2,3,4,5,7,8,9,15,16,19};
+  PetscReal         nd,nz;
+  PetscBool         multok,matok;
+  PetscScalar       v,*b;
+  const PetscScalar *xa;
+  PetscRandom       rand;
+  PetscErrorCode    ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  N    = n*n;
+
+  /* 2d five point stencil with some unsymmetric entries and a few empty rows */
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,N,N);CHKERRQ(ierr);
+  ierr = MatSetType(A,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,5,NULL);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,5,NULL,5,NULL);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (l=rstart; l<rend; l++) {
+    if (l % 7 == 3) continue;
+    i = l/n; j = l - i*n;
+    if (i>0)   {ierr = MatSetValue(A,l,l-n,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<n-1) {ierr = MatSetValue(A,l,l+n,-1.0/(1+i),INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {ierr = MatSetValue(A,l,l-1,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<n-1) {ierr = MatSetValue(A,l,l+1,-1.0/(1+j),INSERT_VALUES);CHKERRQ(ierr);}
+    v    = 4.0 + l;
+    ierr = MatSetValue(A,l,l,v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&z,&d);CHKERRQ(ierr);
+  ierr = VecCreateMPIWithArray(PETSC_COMM_WORLD,1,rend-rstart,N,NULL,&col);CHKERRQ(ierr);
+  for (l=0; l<(PetscInt)(sizeof(nvecs)/sizeof(nvecs[0])); l++) {
+    k    = nvecs[l];
+    ierr = VecDuplicateVecs(z,k,&x);CHKERRQ(ierr);
+    ierr = VecDuplicateVecs(d,k,&y);CHKERRQ(ierr);
+    for (i=0; i<k; i++) {
+      ierr = VecSetRandom(x[i],rand);CHKERRQ(ierr);
+      ierr = VecSet(y[i],-1.0);CHKERRQ(ierr);
+    }
+    /* the second product reuses the work vectors of the first one in parallel */
+    ierr = MatMultMultiple(A,k,(const Vec*)x,y);CHKERRQ(ierr);
+    ierr = MatMultMultiple(A,k,(const Vec*)x,y);CHKERRQ(ierr);
+
+    /* the same products with a dense matrix whose columns are the x[i] */
+    ierr = MatCreateDense(PETSC_COMM_WORLD,rend-rstart,PETSC_DECIDE,N,k,NULL,&B);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(B,&b);CHKERRQ(ierr);
+    for (i=0; i<k; i++) {
+      ierr = VecGetArrayRead(x[i],&xa);CHKERRQ(ierr);
+      ierr = PetscArraycpy(b+i*(rend-rstart),xa,rend-rstart);CHKERRQ(ierr);
+      ierr = VecRestoreArrayRead(x[i],&xa);CHKERRQ(ierr);
+    }
+    ierr = MatDenseRestoreArray(B,&b);CHKERRQ(ierr);
+    ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatMatMult(A,B,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&C);CHKERRQ(ierr);
+
+    multok = matok = PETSC_TRUE;
+    ierr   = MatDenseGetArray(C,&b);CHKERRQ(ierr);
+    for (i=0; i<k; i++) {
+      ierr = MatMult(A,x[i],z);CHKERRQ(ierr);
+      ierr = VecNorm(z,NORM_2,&nz);CHKERRQ(ierr);
+      ierr = VecWAXPY(d,-1.0,z,y[i]);CHKERRQ(ierr);
+      ierr = VecNorm(d,NORM_2,&nd);CHKERRQ(ierr);
+      if (nd > 100*PETSC_MACHINE_EPSILON*nz) multok = PETSC_FALSE;
+      ierr = VecPlaceArray(col,b+i*(rend-rstart));CHKERRQ(ierr);
+      ierr = VecAXPY(col,-1.0,z);CHKERRQ(ierr);
+      ierr = VecNorm(col,NORM_2,&nd);CHKERRQ(ierr);
+      ierr = VecResetArray(col);CHKERRQ(ierr);
+      if (nd > 100*PETSC_MACHINE_EPSILON*nz) matok = PETSC_FALSE;
+    }
+    ierr = MatDenseRestoreArray(C,&b);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"k = %D: MatMultMultiple() agrees with MatMult() %s, MatMatMult() agrees with MatMult() %s\n",k,PetscBools[multok],PetscBools[matok]);CHKERRQ(ierr);
+    ierr = MatDestroy(&C);CHKERRQ(ierr);
+    ierr = MatDestroy(&B);CHKERRQ(ierr);
+    ierr = VecDestroyVecs(k,&x);CHKERRQ(ierr);
+    ierr = VecDestroyVecs(k,&y);CHKERRQ(ierr);
+  }
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&d);CHKERRQ(ierr);
+  ierr = VecDestroy(&col);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      output_file: output/ex247_1.out
+
+   test:
+      suffix: 2
+      nsize: 3
+      output_file: output/ex247_1.out
+
+   test:
+      suffix: noinode
+      args: -mat_no_inode
+      output_file: output/ex247_1.out
+
+   test:
+      suffix: 2_noinode
+      nsize: 2
+      args: -mat_no_inode
+      output_file: output/ex247_1.out
+
+TEST*/
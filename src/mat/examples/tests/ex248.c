@@ -0,0 +1,100 @@
+static char help[] = "Tests MatMult() and MatMultAdd() for MPIAIJ with the off-diagonal block applied as the ghost values arrive.\n\n";
+
+#include <petscmat.h>
+
+int main(int argc,char **argv)
+{
+  Mat            A[2];
+  Vec            x,y;
+  PetscInt       i,k,t,rstart,rend,n = 40,N,col;
+  PetscScalar    v;
+  PetscReal      nrm;
+  PetscBool      flg[2];
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  N    = n*n;
+
+  /* A banded matrix with scattered long range couplings, so that a row has columns owned by several processes, the
+     second matrix multiplies the off-diagonal block after the scatter has completed */
+  for (t=0; t<2; t++) {
+    ierr = MatCreate(PETSC_COMM_WORLD,&A[t]);CHKERRQ(ierr);
+    ierr = MatSetSizes(A[t],PETSC_DECIDE,PETSC_DECIDE,N,N);CHKERRQ(ierr);
+    ierr = MatSetType(A[t],MATAIJ);CHKERRQ(ierr);
+    if (t) {ierr = MatSetOptionsPrefix(A[t],"ref_");CHKERRQ(ierr);}
+    ierr = MatSetFromOptions(A[t]);CHKERRQ(ierr);
+    ierr = MatSetUp(A[t]);CHKERRQ(ierr);
+    ierr = MatGetOwnershipRange(A[t],&rstart,&rend);CHKERRQ(ierr);
+    for (i=rstart; i<rend; i++) {
+      for (k=-2; k<=2; k++) {
+        col = (i+k*n+N)%N;
+        v   = (k ? -1.0 : 8.0) + 0.01*i;
+        ierr = MatSetValues(A[t],1,&i,1,&col,&v,ADD_VALUES);CHKERRQ(ierr);
+      }
+      col  = (7*i+3)%N;
+      v    = 1.0/(1+i%5);
+      ierr = MatSetValues(A[t],1,&i,1,&col,&v,ADD_VALUES);CHKERRQ(ierr);
+    }
+    ierr = MatAssemblyBegin(A[t],MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(A[t],MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  }
+
+  ierr = MatCreateVecs(A[0],&x,&y);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(x,&rstart,&rend);CHKERRQ(ierr);
+  for (i=rstart; i<rend; i++) {
+    v    = PetscSinReal(0.1*i);
+    ierr = VecSetValues(x,1,&i,&v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = VecAssemblyBegin(x);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(x);CHKERRQ(ierr);
+
+  /*
+     The second round adds new off-process nonzeros in every third row, which disassembles the matrices and changes
+     their ghost columns
+  */
+  for (k=0; k<2; k++) {
+    ierr = MatMultEqual(A[0],A[1],4,&flg[0]);CHKERRQ(ierr);
+    ierr = MatMultAddEqual(A[0],A[1],4,&flg[1]);CHKERRQ(ierr);
+    ierr = MatMult(A[0],x,y);CHKERRQ(ierr);
+    ierr = VecNorm(y,NORM_2,&nrm);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Assembly %D: MatMult() equal %s, MatMultAdd() equal %s, norm of the product %g\n",k,PetscBools[flg[0]],PetscBools[flg[1]],(double)nrm);CHKERRQ(ierr);
+    if (k) break;
+    for (t=0; t<2; t++) {
+      ierr = MatSetOption(A[t],MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+      ierr = MatGetOwnershipRange(A[t],&rstart,&rend);CHKERRQ(ierr);
+      for (i=rstart; i<rend; i++) {
+        if (i%3) continue;
+        col  = (i+N/2+1)%N;
+        v    = 0.5;
+        ierr = MatSetValues(A[t],1,&i,1,&col,&v,ADD_VALUES);CHKERRQ(ierr);
+      }
+      ierr = MatAssemblyBegin(A[t],MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+      ierr = MatAssemblyEnd(A[t],MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    }
+  }
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  for (t=0; t<2; t++) {
+    ierr = MatDestroy(&A[t]);CHKERRQ(ierr);
+  }
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      nsize: {{2 5}}
+      args: -ref_mat_mpiaij_mult_split 0
+      output_file: output/ex248_1.out
+
+   test:
+      suffix: 2
+      nsize: 4
+      args: -ref_mat_mpiaij_mult_split 0 -vecscatter_type mpi1
+      output_file: output/ex248_1.out
+
+TEST*/
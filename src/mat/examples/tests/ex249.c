@@ -0,0 +1,95 @@
+static char help[] = "Tests the distance-2 MIS coarsener MATCOARSENMIS2 on the graph of a 2d Laplacian.\n\
+  -m <m> : number of grid points in each direction\n\n";
+
+#include <petscmat.h>
+#include <petscmatcoarsen.h>
+
+int main(int argc,char **args)
+{
+  Mat              G;
+  MatCoarsen       crs;
+  PetscCoarsenData *agg_lists;
+  PetscCDIntNd     *pos;
+  Vec              count;
+  PetscInt         m = 20,i,j,Ii,J,Istart,Iend,naggs = 0,nout = 0,gid,sz,maxsz = 0;
+  PetscScalar      one = 1.0;
+  const PetscScalar *c;
+  PetscErrorCode   ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+
+  /* the graph of the 5-point stencil, with an isolated vertex at the last grid point */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,m*m,m*m,5,NULL,2,NULL,&G);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(G,&Istart,&Iend);CHKERRQ(ierr);
+  for (Ii=Istart; Ii<Iend; Ii++) {
+    i = Ii/m; j = Ii - i*m;
+    ierr = MatSetValues(G,1,&Ii,1,&Ii,&one,INSERT_VALUES);CHKERRQ(ierr);
+    if (Ii == m*m-1) continue;
+    if (i>0)                         {J = Ii - m; ierr = MatSetValues(G,1,&Ii,1,&J,&one,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<m-1 && Ii+m != m*m-1)      {J = Ii + m; ierr = MatSetValues(G,1,&Ii,1,&J,&one,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)                         {J = Ii - 1; ierr = MatSetValues(G,1,&Ii,1,&J,&one,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<m-1 && Ii+1 != m*m-1)      {J = Ii + 1; ierr = MatSetValues(G,1,&Ii,1,&J,&one,INSERT_VALUES);CHKERRQ(ierr);}
+  }
+  ierr = MatAssemblyBegin(G,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(G,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = MatCoarsenCreate(PETSC_COMM_WORLD,&crs);CHKERRQ(ierr);
+  ierr = MatCoarsenSetType(crs,MATCOARSENMIS2);CHKERRQ(ierr);
+  ierr = MatCoarsenSetAdjacency(crs,G);CHKERRQ(ierr);
+  ierr = MatCoarsenSetStrictAggs(crs,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = MatCoarsenSetFromOptions(crs);CHKERRQ(ierr);
+  ierr = MatCoarsenApply(crs);CHKERRQ(ierr);
+  ierr = MatCoarsenGetData(crs,&agg_lists);CHKERRQ(ierr);
+
+  /* every vertex but the isolated one is in exactly one aggregate */
+  ierr = MatCreateVecs(G,&count,NULL);CHKERRQ(ierr);
+  for (i=0; i<Iend-Istart; i++) {
+    ierr = PetscCDSizeAt(agg_lists,i,&sz);CHKERRQ(ierr);
+    if (!sz) continue;
+    naggs++;
+    maxsz = PetscMax(maxsz,sz);
+    ierr  = PetscCDGetHeadPos(agg_lists,i,&pos);CHKERRQ(ierr);
+    while (pos) {
+      ierr = PetscCDIntNdGetID(pos,&gid);CHKERRQ(ierr);
+      ierr = PetscCDGetNextPos(agg_lists,i,&pos);CHKERRQ(ierr);
+      ierr = VecSetValue(count,gid,1.0,ADD_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = VecAssemblyBegin(count);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(count);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(count,&c);CHKERRQ(ierr);
+  for (i=0; i<Iend-Istart; i++) {
+    if (PetscRealPart(c[i]) != (Istart+i == m*m-1 ? 0.0 : 1.0)) nout++;
+  }
+  ierr = VecRestoreArrayRead(count,&c);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&naggs,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&nout,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&maxsz,1,MPIU_INT,MPI_MAX,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Number of aggregates %D, largest %D, vertices in a wrong number of aggregates %D\n",naggs,maxsz,nout);CHKERRQ(ierr);
+
+  ierr = PetscCDDestroy(agg_lists);CHKERRQ(ierr);
+  ierr = MatCoarsenDestroy(&crs);CHKERRQ(ierr);
+  ierr = VecDestroy(&count);CHKERRQ(ierr);
+  ierr = MatDestroy(&G);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      output_file: output/ex249_1.out
+
+   test:
+      suffix: threads
+      requires: openmp
+      args: -omp_num_threads 3
+      output_file: output/ex249_1.out
+
+   test:
+      suffix: 2
+      nsize: 3
+
+TEST*/
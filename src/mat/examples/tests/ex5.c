@@ -283,4 +283,17 @@ int main(int argc,char **args)
       args: -mat_type sell -test_diagonalscale
       output_file: output/ex5_53.out
 
+   test:
+      suffix: aijomp_1
+      args: -mat_type aijomp -mat_aijomp_num_threads 3 -rectA
+      filter: grep -v type
+      output_file: output/ex5_11_A.out
+
+   test:
+      suffix: aijomp_2
+      nsize: 3
+      args: -mat_type aijomp -mat_aijomp_num_threads 2 -test_diagonalscale
+      filter: grep -v type
+      output_file: output/ex5_33.out
+
 TEST*/
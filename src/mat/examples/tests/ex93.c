@@ -269,4 +269,9 @@ PetscErrorCode testPTAPRectangular(void)
       args: -B_matmatmult_via scalable_fast
       output_file: output/ex93_1.out
 
+   test:
+      suffix: threaded
+      args: -B_matmatmult_via threaded -omp_num_threads 3
+      output_file: output/ex93_1.out
+
 TEST*/
@@ -328,6 +328,17 @@ int main(int argc,char **argv)
      args: -Mx 10 -My 5 -Mz 10 -matmatmult_via scalable -matptap_via scalable -inner_diag_matmatmult_via rowmerge -inner_offdiag_matmatmult_via rowmerge
      output_file: output/ex96_1.out
 
+   test:
+     suffix: seq_threaded
+     nsize: 3
+     args: -Mx 10 -My 5 -Mz 10 -matmatmult_via scalable -matptap_via scalable -inner_diag_matmatmult_via threaded -inner_offdiag_matmatmult_via threaded -omp_num_threads 2
+     output_file: output/ex96_1.out
+
+   test:
+     suffix: threaded
+     args: -Mx 10 -My 5 -Mz 10 -matmatmult_via threaded -omp_num_threads 3
+     output_file: output/ex96_1.out
+
    test:
      suffix: allatonce
      nsize: 3
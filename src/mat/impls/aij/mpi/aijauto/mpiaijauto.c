@@ -0,0 +1,63 @@
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+
+static PetscErrorCode MatAssemblyEnd_MPIAIJAUTO(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatAssemblyEnd_MPIAIJ(A,mode);CHKERRQ(ierr);
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+
+  /* the matrix is a plain MATMPIAIJ matrix from now on, which the tuner then converts */
+  A->ops->assemblyend = MatAssemblyEnd_MPIAIJ;
+  A->assembled        = PETSC_TRUE;
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATMPIAIJ);CHKERRQ(ierr);
+  ierr = MatAIJAutoTune_Private(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJAUTO(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATMPIAIJ);CHKERRQ(ierr);
+  A->ops->assemblyend = MatAssemblyEnd_MPIAIJAUTO;
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATMPIAIJAUTO);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   MATMPIAIJAUTO - MATMPIAIJAUTO = "mpiaijauto" - A parallel sparse matrix that selects its storage format at run time.
+
+   The matrix is preallocated and assembled as a MATMPIAIJ matrix. At the end of the first MAT_FINAL_ASSEMBLY the
+   candidate formats are timed with a few MatMult() on all the processes and the matrix is converted in place to
+   the one with the smallest maximum time over the processes. See MATSEQAIJAUTO for the options.
+
+   Level: intermediate
+
+.seealso: MatCreate(), MATAIJAUTO, MATSEQAIJAUTO, MATMPIAIJ, MATMPIAIJPERM, MATMPIAIJSELL, MATMPISELL, MATMPIBAIJ, MatConvert()
+M*/
+
+/*MC
+   MATAIJAUTO - MATAIJAUTO = "aijauto" - A sparse matrix type that picks the fastest storage format for MatMult() at run time.
+
+   This matrix type is identical to MATSEQAIJAUTO when constructed with a single process communicator,
+   and MATMPIAIJAUTO otherwise.  As a result, for single process communicators,
+   MatSeqAIJSetPreallocation() is supported, and similarly MatMPIAIJSetPreallocation() is supported
+   for communicators controlling multiple processes.  It is recommended that you call both of
+   the above preallocation routines for simplicity.
+
+   After the first final assembly the matrix has the type that was selected, so MatGetType() returns for example
+   MATSEQAIJPERM or MATMPISELL and not MATAIJAUTO.
+
+   Options Database Keys:
++  -mat_type aijauto - sets the matrix type to "aijauto" during a call to MatSetFromOptions()
+.  -mat_aijauto_types <aij,aijperm,aijsell,aijcrl,sell,baij> - candidate formats, without the seq/mpi prefix
+.  -mat_aijauto_nmult <10> - number of products timed for each candidate
+-  -mat_aijauto_max_padding <1.5> - SELL and CRL formats are not tried if padding would make them store more than this times the nonzeros
+
+  Level: beginner
+
+.seealso: MATSEQAIJAUTO, MATMPIAIJAUTO, MATAIJ, MATAIJPERM, MATAIJSELL, MATSELL, MATBAIJ
+M*/
@@ -205,6 +205,7 @@ PetscErrorCode MatDisAssemble_MPIAIJ(Mat A)
   }
   ierr = PetscFree(aij->garray);CHKERRQ(ierr);
   ierr = PetscLogObjectMemory((PetscObject)A,-ec*sizeof(PetscInt));CHKERRQ(ierr);
+  ierr = MatMPIAIJMultSplitDestroy_Private(&aij->split);CHKERRQ(ierr);
   ierr = MatDestroy(&B);CHKERRQ(ierr);
   ierr = PetscLogObjectParent((PetscObject)A,(PetscObject)Bnew);CHKERRQ(ierr);
 
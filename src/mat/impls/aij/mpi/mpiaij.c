@@ -19,7 +19,7 @@
 . -mat_type aij - sets the matrix type to "aij" during a call to MatSetFromOptions()
 
   Developer Notes:
-    Subclasses include MATAIJCUSP, MATAIJCUSPARSE, MATAIJPERM, MATAIJSELL, MATAIJMKL, MATAIJCRL, and also automatically switches over to use inodes when
+    Subclasses include MATAIJCUSP, MATAIJCUSPARSE, MATAIJPERM, MATAIJSELL, MATAIJOMP, MATAIJMKL, MATAIJCRL, and also automatically switches over to use inodes when
    enough exist.
 
   Level: beginner
@@ -1085,6 +1085,137 @@ PetscErrorCode MatZeroRowsColumns_MPIAIJ(Mat A,PetscInt N,const PetscInt rows[],
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode MatMPIAIJMultSplitDestroy_Private(Mat_MPIAIJMultSplit **split)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!*split) PetscFunctionReturn(0);
+  ierr = PetscFree2((*split)->ranks,(*split)->offset);CHKERRQ(ierr);
+  ierr = PetscFree4((*split)->row,(*split)->start,(*split)->len,(*split)->sum);CHKERRQ(ierr);
+  ierr = MatDestroy(&(*split)->B);CHKERRQ(ierr);
+  ierr = VecScatterDestroy(&(*split)->Mvctx);CHKERRQ(ierr);
+  ierr = PetscFree(*split);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Groups the entries of the off-diagonal block by the process owning their column. The entries of a row owned by one process
+   are contiguous when garray[] is sorted, so there is usually one piece per row and neighbor. The references to B and Mvctx
+   make sure a new block or a new scatter, after a disassembly for example, is not mistaken for the old one.
+*/
+static PetscErrorCode MatMPIAIJMultSplitSetUp_Private(Mat A,VecScatter Mvctx)
+{
+  Mat_MPIAIJ          *a = (Mat_MPIAIJ*)A->data;
+  Mat_SeqAIJ          *b = (Mat_SeqAIJ*)a->B->data;
+  Mat_MPIAIJMultSplit *split = a->split;
+  PetscInt            i,k,p,r,t = -1,m = a->B->rmap->n,nc = a->B->cmap->n,nranks,*owner,*cnt;
+  PetscMPIInt         rank;
+  PetscErrorCode      ierr;
+
+  PetscFunctionBegin;
+  if (split && split->B == a->B && split->Mvctx == Mvctx && split->nonzerostate == a->B->nonzerostate) PetscFunctionReturn(0);
+  ierr = MatMPIAIJMultSplitDestroy_Private(&a->split);CHKERRQ(ierr);
+  ierr = PetscNew(&split);CHKERRQ(ierr);
+
+  /* Number the processes owning ghost columns in increasing order and find the number of each ghost column's owner */
+  ierr = PetscMalloc2(nc,&owner,nc,&cnt);CHKERRQ(ierr);
+  for (k=0; k<nc; k++) {
+    ierr     = PetscLayoutFindOwner(A->cmap,a->garray[k],&rank);CHKERRQ(ierr);
+    owner[k] = cnt[k] = rank;
+  }
+  nranks = nc;
+  ierr   = PetscSortRemoveDupsInt(&nranks,cnt);CHKERRQ(ierr);
+  ierr   = PetscMalloc2(nranks,&split->ranks,nranks+1,&split->offset);CHKERRQ(ierr);
+  for (r=0; r<nranks; r++) {ierr = PetscMPIIntCast(cnt[r],&split->ranks[r]);CHKERRQ(ierr);}
+  for (k=0; k<nc; k++) {ierr = PetscFindInt(owner[k],nranks,cnt,&owner[k]);CHKERRQ(ierr);}
+  split->nranks = nranks;
+
+  /* Count the pieces of each process, then fill them in row order */
+  ierr = PetscArrayzero(split->offset,nranks+1);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    for (p=b->i[i]; p<b->i[i+1]; p++) if (p == b->i[i] || owner[b->j[p]] != owner[b->j[p-1]]) split->offset[owner[b->j[p]]+1]++;
+  }
+  for (r=0; r<nranks; r++) split->offset[r+1] += split->offset[r];
+  ierr = PetscMalloc4(split->offset[nranks],&split->row,split->offset[nranks],&split->start,split->offset[nranks],&split->len,split->offset[nranks],&split->sum);CHKERRQ(ierr);
+  ierr = PetscArraycpy(cnt,split->offset,nranks);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    for (p=b->i[i]; p<b->i[i+1]; p++) {
+      if (p == b->i[i] || owner[b->j[p]] != owner[b->j[p-1]]) {
+        t               = cnt[owner[b->j[p]]]++;
+        split->row[t]   = i;
+        split->start[t] = p;
+        split->len[t]   = 0;
+      }
+      split->len[t]++;
+    }
+  }
+  ierr = PetscFree2(owner,cnt);CHKERRQ(ierr);
+
+  ierr = PetscObjectReference((PetscObject)a->B);CHKERRQ(ierr);
+  ierr = PetscObjectReference((PetscObject)Mvctx);CHKERRQ(ierr);
+  split->B            = a->B;
+  split->Mvctx        = Mvctx;
+  split->nonzerostate = a->B->nonzerostate;
+  a->split            = split;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Completes the scatter of the ghost values started by the caller and adds the product of the off-diagonal block to yy.
+   The pieces of the block using the ghost values of one process are multiplied as soon as its message has landed, so the
+   slowest neighbors are waited for last. The products of the pieces are added to yy in piece order once all are known, so
+   the result does not depend on the order in which the messages arrive.
+*/
+static PetscErrorCode MatMultAddOffDiagonal_MPIAIJ_Private(Mat A,VecScatter Mvctx,Vec xx,Vec yy)
+{
+  Mat_MPIAIJ          *a = (Mat_MPIAIJ*)A->data;
+  Mat_SeqAIJ          *b = (Mat_SeqAIJ*)a->B->data;
+  Mat_MPIAIJMultSplit *split;
+  const PetscScalar   *x;
+  PetscScalar         *y,sum;
+  const MatScalar     *v;
+  const PetscInt      *j;
+  PetscInt            r,t,p;
+  PetscMPIInt         rank;
+  PetscBool           isseqaij;
+  PetscErrorCode      ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)a->B,MATSEQAIJ,&isseqaij);CHKERRQ(ierr);
+  if (!a->multsplit || !isseqaij) {
+    ierr = VecScatterEnd(Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = (*a->B->ops->multadd)(a->B,a->lvec,yy,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr  = MatMPIAIJMultSplitSetUp_Private(A,Mvctx);CHKERRQ(ierr);
+  split = a->split;
+  ierr  = VecGetArrayRead(a->lvec,&x);CHKERRQ(ierr);
+  while (1) {
+    ierr = VecScatterEndAny(Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD,&rank);CHKERRQ(ierr);
+    if (rank == MPI_UNDEFINED || rank == MPI_ANY_SOURCE) break;
+    ierr = PetscFindMPIInt(rank,split->nranks,split->ranks,&r);CHKERRQ(ierr);
+    if (r < 0) continue;
+    for (t=split->offset[r]; t<split->offset[r+1]; t++) {
+      v   = b->a + split->start[t];
+      j   = b->j + split->start[t];
+      sum = 0.0;
+      for (p=0; p<split->len[t]; p++) sum += v[p]*x[j[p]];
+      split->sum[t] = sum;
+    }
+  }
+  ierr = VecRestoreArrayRead(a->lvec,&x);CHKERRQ(ierr);
+  if (rank == MPI_ANY_SOURCE) { /* the scatter could not be completed piecewise */
+    ierr = (*a->B->ops->multadd)(a->B,a->lvec,yy,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  for (t=0; t<split->offset[split->nranks]; t++) y[split->row[t]] += split->sum[t];
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*b->nz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatMult_MPIAIJ(Mat A,Vec xx,Vec yy)
 {
   Mat_MPIAIJ     *a = (Mat_MPIAIJ*)A->data;
@@ -1098,8 +1229,50 @@ PetscErrorCode MatMult_MPIAIJ(Mat A,Vec xx,Vec yy)
 
   ierr = VecScatterBegin(Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
   ierr = (*a->A->ops->mult)(a->A,xx,yy);CHKERRQ(ierr);
-  ierr = VecScatterEnd(Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-  ierr = (*a->B->ops->multadd)(a->B,a->lvec,yy,yy);CHKERRQ(ierr);
+  ierr = MatMultAddOffDiagonal_MPIAIJ_Private(A,Mvctx,xx,yy);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The diagonal and off-diagonal blocks are each applied to all the vectors at once; the ghost values of the
+   vectors are communicated one after the other, the first one overlapped with the diagonal block products
+*/
+static PetscErrorCode MatMultMultiple_MPIAIJ(Mat A,PetscInt k,const Vec x[],Vec y[])
+{
+  Mat_MPIAIJ     *a = (Mat_MPIAIJ*)A->data;
+  PetscErrorCode ierr,(*f)(Mat,PetscInt,const Vec[],Vec[]);
+  PetscInt       l,n,nl = 0;
+  Vec            *lvec;
+  VecScatter     Mvctx = a->Mvctx;
+
+  PetscFunctionBegin;
+  /* the work vectors are kept on the matrix, they are made again when more are needed or lvec has changed size */
+  ierr = VecGetLocalSize(a->lvec,&n);CHKERRQ(ierr);
+  if (a->nlvecs) {ierr = VecGetLocalSize(a->lvecs[0],&nl);CHKERRQ(ierr);}
+  if (a->nlvecs < k || nl != n) {
+    if (a->nlvecs) {ierr = VecDestroyVecs(a->nlvecs,&a->lvecs);CHKERRQ(ierr);}
+    ierr      = VecDuplicateVecs(a->lvec,PetscMax(k,a->nlvecs),&a->lvecs);CHKERRQ(ierr);
+    a->nlvecs = PetscMax(k,a->nlvecs);
+  }
+  lvec = a->lvecs;
+  ierr = VecScatterBegin(Mvctx,x[0],lvec[0],INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = PetscObjectQueryFunction((PetscObject)a->A,"MatMultMultiple_C",&f);CHKERRQ(ierr);
+  if (f) {
+    ierr = (*f)(a->A,k,x,y);CHKERRQ(ierr);
+  } else {
+    for (l=0; l<k; l++) {ierr = (*a->A->ops->mult)(a->A,x[l],y[l]);CHKERRQ(ierr);}
+  }
+  ierr = VecScatterEnd(Mvctx,x[0],lvec[0],INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  for (l=1; l<k; l++) {
+    ierr = VecScatterBegin(Mvctx,x[l],lvec[l],INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = VecScatterEnd(Mvctx,x[l],lvec[l],INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectQueryFunction((PetscObject)a->B,"MatMultMultiple_C",&f);CHKERRQ(ierr);
+  if (f == MatMultMultiple_SeqAIJ) {
+    ierr = MatMultAddMultiple_SeqAIJ(a->B,k,(const Vec*)lvec,y);CHKERRQ(ierr);
+  } else {
+    for (l=0; l<k; l++) {ierr = (*a->B->ops->multadd)(a->B,lvec[l],y[l],y[l]);CHKERRQ(ierr);}
+  }
   PetscFunctionReturn(0);
 }
 
@@ -1123,8 +1296,7 @@ PetscErrorCode MatMultAdd_MPIAIJ(Mat A,Vec xx,Vec yy,Vec zz)
   if (a->Mvctx_mpi1_flg) Mvctx = a->Mvctx_mpi1;
   ierr = VecScatterBegin(Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
   ierr = (*a->A->ops->multadd)(a->A,xx,yy,zz);CHKERRQ(ierr);
-  ierr = VecScatterEnd(Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-  ierr = (*a->B->ops->multadd)(a->B,a->lvec,zz,zz);CHKERRQ(ierr);
+  ierr = MatMultAddOffDiagonal_MPIAIJ_Private(A,Mvctx,xx,zz);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -1258,10 +1430,13 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
 #endif
   ierr = PetscFree(aij->garray);CHKERRQ(ierr);
   ierr = VecDestroy(&aij->lvec);CHKERRQ(ierr);
+  if (aij->nlvecs) {ierr = VecDestroyVecs(aij->nlvecs,&aij->lvecs);CHKERRQ(ierr);}
   ierr = VecScatterDestroy(&aij->Mvctx);CHKERRQ(ierr);
   if (aij->Mvctx_mpi1) {ierr = VecScatterDestroy(&aij->Mvctx_mpi1);CHKERRQ(ierr);}
   ierr = PetscFree2(aij->rowvalues,aij->rowindices);CHKERRQ(ierr);
   ierr = PetscFree(aij->ld);CHKERRQ(ierr);
+  ierr = MatDestroyCOO_MPIXAIJ_Private(&aij->coo);CHKERRQ(ierr);
+  ierr = MatMPIAIJMultSplitDestroy_Private(&aij->split);CHKERRQ(ierr);
   ierr = PetscFree(mat->data);CHKERRQ(ierr);
 
   ierr = PetscObjectChangeTypeName((PetscObject)mat,0);CHKERRQ(ierr);
@@ -1269,8 +1444,13 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatRetrieveValues_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatIsTranspose_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMPIAIJSetPreallocation_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSORSetMulticolor_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSORGetMulticolor_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMultMultiple_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatResetPreallocation_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMPIAIJSetPreallocationCSR_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetPreallocationCOO_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetValuesCOO_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatDiagonalScaleLocal_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatConvert_mpiaij_mpibaij_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatConvert_mpiaij_mpisbaij_C",NULL);CHKERRQ(ierr);
@@ -1564,6 +1744,29 @@ PetscErrorCode MatView_MPIAIJ(Mat mat,PetscViewer viewer)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode MatSORSetMulticolor_MPIAIJ(Mat mat,PetscBool flg)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!aij->A) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must preallocate the matrix first");
+  /* the local sweeps are done by the diagonal block */
+  ierr = MatSORSetMulticolor(aij->A,flg);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSORGetMulticolor_MPIAIJ(Mat mat,PetscBool *flg)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!aij->A) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must preallocate the matrix first");
+  ierr = MatSORGetMulticolor(aij->A,flg);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatSOR_MPIAIJ(Mat matin,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
 {
   Mat_MPIAIJ     *mat = (Mat_MPIAIJ*)matin->data;
@@ -2207,12 +2410,121 @@ PetscErrorCode MatCopy_MPIAIJ(Mat A,Mat B,MatStructure str)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode MatSetValues_MPIAIJ_Hash(Mat mat,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],const PetscScalar v[],InsertMode addv)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  Mat_SeqAIJ     *a   = (Mat_SeqAIJ*)aij->A->data,*b = (Mat_SeqAIJ*)aij->B->data;
+  PetscInt       rstart = mat->rmap->rstart,rend = mat->rmap->rend;
+  PetscInt       cstart = mat->cmap->rstart,cend = mat->cmap->rend;
+  PetscInt       i,j,row,col;
+  PetscScalar    value = 0.0;
+  PetscBool      ignorezeroentries = a->ignorezeroentries;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<m; i++) {
+    if (im[i] < 0) continue;
+#if defined(PETSC_USE_DEBUG)
+    if (im[i] >= mat->rmap->N) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row too large: row %D max %D",im[i],mat->rmap->N-1);
+#endif
+    if (im[i] >= rstart && im[i] < rend) {
+      row = im[i] - rstart;
+      for (j=0; j<n; j++) {
+        col = in[j];
+        if (col < 0) continue;
+#if defined(PETSC_USE_DEBUG)
+        if (col >= mat->cmap->N) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column too large: col %D max %D",col,mat->cmap->N-1);
+#endif
+        if (v) value = aij->roworiented ? v[i*n+j] : v[i+j*m];
+        if (ignorezeroentries && value == 0.0 && (addv == ADD_VALUES) && im[i] != col) continue;
+        if (col >= cstart && col < cend) {
+          ierr = MatSeqAIJHashSetValue_Private(a,row,col-cstart,value,addv);CHKERRQ(ierr);
+        } else {
+          ierr = MatSeqAIJHashSetValue_Private(b,row,col,value,addv);CHKERRQ(ierr);
+        }
+      }
+    } else {
+      if (mat->nooffprocentries) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Setting off process row %D even though MatSetOption(,MAT_NO_OFF_PROC_ENTRIES,PETSC_TRUE) was set",im[i]);
+      if (!aij->donotstash) {
+        mat->assembled = PETSC_FALSE;
+        if (aij->roworiented) {
+          ierr = MatStashValuesRow_Private(&mat->stash,im[i],n,in,v+i*n,(PetscBool)(ignorezeroentries && (addv == ADD_VALUES)));CHKERRQ(ierr);
+        } else {
+          ierr = MatStashValuesCol_Private(&mat->stash,im[i],n,in,v+i,m,(PetscBool)(ignorezeroentries && (addv == ADD_VALUES)));CHKERRQ(ierr);
+        }
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatAssemblyEnd_MPIAIJ_Hash(Mat mat,MatAssemblyType mode)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  PetscMPIInt    n;
+  PetscInt       i,j,rstart,ncols,flg;
+  PetscInt       *row,*col;
+  PetscScalar    *val;
+  PetscBool      donotstash;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!aij->donotstash && !mat->nooffprocentries) {
+    while (1) {
+      ierr = MatStashScatterGetMesg_Private(&mat->stash,&n,&row,&col,&val,&flg);CHKERRQ(ierr);
+      if (!flg) break;
+
+      for (i=0; i<n; ) {
+        for (j=i,rstart=row[j]; j<n; j++) {
+          if (row[j] != rstart) break;
+        }
+        if (j < n) ncols = j-i;
+        else       ncols = n-i;
+        ierr = MatSetValues_MPIAIJ_Hash(mat,1,row+i,ncols,col+i,val+i,mat->insertmode);CHKERRQ(ierr);
+        i = j;
+      }
+    }
+    ierr = MatStashScatterEnd_Private(&mat->stash);CHKERRQ(ierr);
+  }
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+
+  /* all entries are local now: build both blocks with exact preallocation and finish with the regular assembly */
+  ierr = MatSeqAIJHashToCSR_Private(aij->A);CHKERRQ(ierr);
+  ierr = MatSeqAIJHashToCSR_Private(aij->B);CHKERRQ(ierr);
+  mat->ops->setvalues   = aij->htsetvalues;
+  mat->ops->assemblyend = aij->htassemblyend;
+  donotstash            = aij->donotstash;
+  aij->donotstash       = PETSC_TRUE;
+  ierr = (*mat->ops->assemblyend)(mat,mode);CHKERRQ(ierr);
+  aij->donotstash       = donotstash;
+  PetscFunctionReturn(0);
+}
+
+/*
+   With -mat_hash_assembly an unpreallocated matrix collects its entries in hash tables in the diagonal and off-diagonal
+   blocks until the first final assembly, see MatSetUp_SeqAIJ_Hash(). Off-process entries still go through the stash.
+*/
 PetscErrorCode MatSetUp_MPIAIJ(Mat A)
 {
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)A->data;
+  PetscBool      hash = PETSC_FALSE;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = MatMPIAIJSetPreallocation(A,PETSC_DEFAULT,0,PETSC_DEFAULT,0);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(((PetscObject)A)->options,((PetscObject)A)->prefix,"-mat_hash_assembly",&hash,NULL);CHKERRQ(ierr);
+  if (!hash || A->structure_only) {
+    ierr = MatMPIAIJSetPreallocation(A,PETSC_DEFAULT,0,PETSC_DEFAULT,0);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = MatMPIAIJSetPreallocation(A,0,NULL,0,NULL);CHKERRQ(ierr);
+  ierr = MatSetOption(aij->A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatSetOption(aij->B,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatSetUp_SeqAIJ_Hash(aij->A);CHKERRQ(ierr);
+  ierr = MatSetUp_SeqAIJ_Hash(aij->B);CHKERRQ(ierr);
+  aij->htsetvalues    = A->ops->setvalues;
+  aij->htassemblyend  = A->ops->assemblyend;
+  A->ops->setvalues   = MatSetValues_MPIAIJ_Hash;
+  A->ops->assemblyend = MatAssemblyEnd_MPIAIJ_Hash;
   PetscFunctionReturn(0);
 }
 
@@ -2568,6 +2880,7 @@ PetscErrorCode MatMPIAIJSetUseScalableIncreaseOverlap(Mat A,PetscBool sc)
 
 PetscErrorCode MatSetFromOptions_MPIAIJ(PetscOptionItems *PetscOptionsObject,Mat A)
 {
+  Mat_MPIAIJ           *a = (Mat_MPIAIJ*)A->data;
   PetscErrorCode       ierr;
   PetscBool            sc = PETSC_FALSE,flg;
 
@@ -2578,6 +2891,7 @@ PetscErrorCode MatSetFromOptions_MPIAIJ(PetscOptionItems *PetscOptionsObject,Mat
   if (flg) {
     ierr = MatMPIAIJSetUseScalableIncreaseOverlap(A,sc);CHKERRQ(ierr);
   }
+  ierr = PetscOptionsBool("-mat_mpiaij_mult_split","Multiply the off-diagonal block by the ghost values of each process as they arrive","MatMult",a->multsplit,&a->multsplit,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -2895,6 +3209,7 @@ PetscErrorCode MatDuplicate_MPIAIJ(Mat matin,MatDuplicateOption cpvalues,Mat *ne
   a->rank         = oldmat->rank;
   a->donotstash   = oldmat->donotstash;
   a->roworiented  = oldmat->roworiented;
+  a->multsplit    = oldmat->multsplit;
   a->rowindices   = 0;
   a->rowvalues    = 0;
   a->getrowactive = PETSC_FALSE;
@@ -4002,6 +4317,198 @@ PetscErrorCode MatMPIAIJSetPreallocationCSR_MPIAIJ(Mat B,const PetscInt Ii[],con
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode MatDestroyCOO_MPIXAIJ_Private(Mat_MPICOO **coo)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!*coo) PetscFunctionReturn(0);
+  ierr = PetscSFDestroy(&(*coo)->sf);CHKERRQ(ierr);
+  ierr = PetscFree2((*coo)->sendperm,(*coo)->sendbuf);CHKERRQ(ierr);
+  ierr = PetscFree((*coo)->recvbuf);CHKERRQ(ierr);
+  ierr = PetscFree4((*coo)->Aperm,(*coo)->Apos,(*coo)->Bperm,(*coo)->Bpos);CHKERRQ(ierr);
+  ierr = PetscFree(*coo);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Shared by MPIAIJ and MPIBAIJ: mat has been preallocated (empty) so that its diagonal block A and its off-diagonal
+   block B (with global column indices) exist. The entries owned by other processes are sent to their owners once,
+   with a PetscSF that is kept for MatSetValuesCOO(), then the nonzero structure of A and B is laid out with
+   MatSeqXAIJSetPreallocationCOO_Private() and mat is assembled. prealloc() is the preallocation routine of the blocks.
+*/
+PetscErrorCode MatSetPreallocationCOO_MPIXAIJ_Private(Mat mat,Mat A,Mat B,PetscInt bs,PetscErrorCode (*prealloc)(Mat,PetscInt,const PetscInt[]),PetscInt n,const PetscInt coo_i[],const PetscInt coo_j[],Mat_MPICOO **cooout)
+{
+  Mat_MPICOO     *coo;
+  MPI_Comm       comm;
+  PetscSF        sf1;
+  PetscSFNode    *iremote1,*iremote;
+  PetscMPIInt    owner;
+  PetscInt       rstart = mat->rmap->rstart,rend = mat->rmap->rend,cstart = mat->cmap->rstart,cend = mat->cmap->rend,N = mat->cmap->N;
+  PetscInt       k,s,r,q,nranks,nrecv = 0,nloc,*sendrank,*rcount,*roffset,*sendi,*sendj,*recvi,*recvj,*Aij,*Bij;
+  PetscBool      nooffprocentries;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)mat,&comm);CHKERRQ(ierr);
+  ierr = PetscNew(&coo);CHKERRQ(ierr);
+
+  /* find the entries owned by other processes and group them by owner */
+  for (k=0; k<n; k++) {
+    if (coo_i[k] < 0 || coo_j[k] < 0) continue;
+    if (coo_j[k] >= N) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column %D of entry %D is too large, maximum %D",coo_j[k],k,N-1);
+    if (coo_i[k] < rstart || coo_i[k] >= rend) coo->nsend++;
+  }
+  ierr = PetscMalloc2(coo->nsend,&coo->sendperm,coo->nsend,&coo->sendbuf);CHKERRQ(ierr);
+  ierr = PetscMalloc1(coo->nsend,&sendrank);CHKERRQ(ierr);
+  for (k=0,s=0; k<n; k++) {
+    if (coo_i[k] < 0 || coo_j[k] < 0 || (coo_i[k] >= rstart && coo_i[k] < rend)) continue;
+    ierr = PetscLayoutFindOwner(mat->rmap,coo_i[k],&owner);CHKERRQ(ierr);
+    sendrank[s]        = owner;
+    coo->sendperm[s++] = k;
+  }
+  ierr = PetscSortIntWithArray(coo->nsend,sendrank,coo->sendperm);CHKERRQ(ierr);
+  for (s=0,nranks=0; s<coo->nsend; s++) if (!s || sendrank[s] != sendrank[s-1]) nranks++;
+
+  /* each owner learns how many entries it receives, and each sender where its entries go, with one fetch-and-add */
+  ierr = PetscMalloc3(nranks,&iremote1,nranks,&rcount,nranks,&roffset);CHKERRQ(ierr);
+  for (s=0,r=-1; s<coo->nsend; s++) {
+    if (!s || sendrank[s] != sendrank[s-1]) {
+      r++;
+      iremote1[r].rank  = sendrank[s];
+      iremote1[r].index = 0;
+      rcount[r]         = 0;
+    }
+    rcount[r]++;
+  }
+  ierr = PetscSFCreate(comm,&sf1);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(sf1,1,nranks,NULL,PETSC_OWN_POINTER,iremote1,PETSC_COPY_VALUES);CHKERRQ(ierr);
+  ierr = PetscSFFetchAndOpBegin(sf1,MPIU_INT,&nrecv,rcount,roffset,MPI_SUM);CHKERRQ(ierr);
+  ierr = PetscSFFetchAndOpEnd(sf1,MPIU_INT,&nrecv,rcount,roffset,MPI_SUM);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sf1);CHKERRQ(ierr);
+  coo->nrecv = nrecv;
+
+  ierr = PetscMalloc1(coo->nsend,&iremote);CHKERRQ(ierr);
+  for (s=0,r=-1; s<coo->nsend; s++) {
+    if (!s || sendrank[s] != sendrank[s-1]) r++;
+    iremote[s].rank  = sendrank[s];
+    iremote[s].index = roffset[r]++;
+  }
+  ierr = PetscSFCreate(comm,&coo->sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(coo->sf,nrecv,coo->nsend,NULL,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(coo->sf);CHKERRQ(ierr);
+  ierr = PetscFree(sendrank);CHKERRQ(ierr);
+  ierr = PetscFree3(iremote1,rcount,roffset);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nrecv,&coo->recvbuf);CHKERRQ(ierr);
+
+  /* ship the (i,j) of the off-process entries */
+  ierr = PetscMalloc4(coo->nsend,&sendi,coo->nsend,&sendj,nrecv,&recvi,nrecv,&recvj);CHKERRQ(ierr);
+  for (s=0; s<coo->nsend; s++) {
+    sendi[s] = coo_i[coo->sendperm[s]];
+    sendj[s] = coo_j[coo->sendperm[s]];
+  }
+  ierr = PetscSFReduceBegin(coo->sf,MPIU_INT,sendi,recvi,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(coo->sf,MPIU_INT,sendi,recvi,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(coo->sf,MPIU_INT,sendj,recvj,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(coo->sf,MPIU_INT,sendj,recvj,MPIU_REPLACE);CHKERRQ(ierr);
+
+  /* split the local and received entries between the diagonal and off-diagonal blocks, local ones first */
+  nloc = n + nrecv;
+  ierr = PetscMalloc4(nloc,&coo->Aperm,nloc,&coo->Apos,nloc,&coo->Bperm,nloc,&coo->Bpos);CHKERRQ(ierr);
+  ierr = PetscMalloc2(2*nloc,&Aij,2*nloc,&Bij);CHKERRQ(ierr);
+  for (q=0; q<nloc; q++) {
+    PetscInt i,j,p;
+
+    if (q == n) {coo->nAl = coo->nA; coo->nBl = coo->nB;}
+    if (q < n) {
+      i = coo_i[q]; j = coo_j[q]; p = q;
+      if (i < rstart || i >= rend || j < 0) continue;
+    } else {
+      i = recvi[q-n]; j = recvj[q-n]; p = q-n;
+    }
+    if (j >= cstart && j < cend) {
+      Aij[coo->nA]          = i - rstart;
+      Aij[nloc+coo->nA]     = j - cstart;
+      coo->Aperm[coo->nA++] = p;
+    } else {
+      Bij[coo->nB]          = i - rstart;
+      Bij[nloc+coo->nB]     = j;
+      coo->Bperm[coo->nB++] = p;
+    }
+  }
+  if (!nrecv) {coo->nAl = coo->nA; coo->nBl = coo->nB;}
+  ierr = PetscFree4(sendi,sendj,recvi,recvj);CHKERRQ(ierr);
+
+  ierr = MatSeqXAIJSetPreallocationCOO_Private(A,bs,prealloc,coo->nA,Aij,Aij+nloc,coo->Apos);CHKERRQ(ierr);
+  ierr = MatSeqXAIJSetPreallocationCOO_Private(B,bs,prealloc,coo->nB,Bij,Bij+nloc,coo->Bpos);CHKERRQ(ierr);
+  ierr = PetscFree2(Aij,Bij);CHKERRQ(ierr);
+
+  nooffprocentries      = mat->nooffprocentries;
+  mat->nooffprocentries = PETSC_TRUE;
+  ierr = MatAssemblyBegin(mat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(mat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  mat->nooffprocentries = nooffprocentries;
+  ierr = MatSetOption(mat,MAT_NEW_NONZERO_LOCATION_ERR,PETSC_TRUE);CHKERRQ(ierr);
+
+  coo->nonzerostate = mat->nonzerostate;
+  *cooout           = coo;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Shared by MPIAIJ and MPIBAIJ: Aa and Ba are the value arrays of the diagonal and off-diagonal blocks, of
+   length Anz and Bnz. The off-process values are in flight while the local ones are added.
+*/
+PetscErrorCode MatSetValuesCOO_MPIXAIJ_Private(Mat_MPICOO *coo,const PetscScalar v[],InsertMode imode,MatScalar *Aa,PetscInt Anz,MatScalar *Ba,PetscInt Bnz)
+{
+  PetscInt       k;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (k=0; k<coo->nsend; k++) coo->sendbuf[k] = v[coo->sendperm[k]];
+  ierr = PetscSFReduceBegin(coo->sf,MPIU_SCALAR,coo->sendbuf,coo->recvbuf,MPIU_REPLACE);CHKERRQ(ierr);
+  if (imode == INSERT_VALUES) {
+    ierr = PetscArrayzero(Aa,Anz);CHKERRQ(ierr);
+    ierr = PetscArrayzero(Ba,Bnz);CHKERRQ(ierr);
+  }
+  for (k=0; k<coo->nAl; k++) Aa[coo->Apos[k]] += v[coo->Aperm[k]];
+  for (k=0; k<coo->nBl; k++) Ba[coo->Bpos[k]] += v[coo->Bperm[k]];
+  ierr = PetscSFReduceEnd(coo->sf,MPIU_SCALAR,coo->sendbuf,coo->recvbuf,MPIU_REPLACE);CHKERRQ(ierr);
+  for (k=coo->nAl; k<coo->nA; k++) Aa[coo->Apos[k]] += coo->recvbuf[coo->Aperm[k]];
+  for (k=coo->nBl; k<coo->nB; k++) Ba[coo->Bpos[k]] += coo->recvbuf[coo->Bperm[k]];
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSetPreallocationCOO_MPIAIJ(Mat mat,PetscInt n,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatDestroyCOO_MPIXAIJ_Private(&aij->coo);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(mat,0,NULL,0,NULL);CHKERRQ(ierr);
+  ierr = MatSetPreallocationCOO_MPIXAIJ_Private(mat,aij->A,aij->B,1,MatSeqAIJSetPreallocation,n,coo_i,coo_j,&aij->coo);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSetValuesCOO_MPIAIJ(Mat mat,const PetscScalar v[],InsertMode imode)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  PetscScalar    *Aa,*Ba;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!aij->coo || aij->coo->nonzerostate != mat->nonzerostate) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call MatSetPreallocationCOO() first, and the nonzero structure must not change afterwards");
+  ierr = MatSeqAIJGetArray(aij->A,&Aa);CHKERRQ(ierr);
+  ierr = MatSeqAIJGetArray(aij->B,&Ba);CHKERRQ(ierr);
+  ierr = MatSetValuesCOO_MPIXAIJ_Private(aij->coo,v,imode,Aa,((Mat_SeqAIJ*)aij->A->data)->nz,Ba,((Mat_SeqAIJ*)aij->B->data)->nz);CHKERRQ(ierr);
+  ierr = MatSeqAIJRestoreArray(aij->A,&Aa);CHKERRQ(ierr);
+  ierr = MatSeqAIJRestoreArray(aij->B,&Ba);CHKERRQ(ierr);
+  ierr = MatSeqAIJInvalidateDiagonal(aij->A);CHKERRQ(ierr);
+  ierr = VecDestroy(&aij->diag);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
    MatMPIAIJSetPreallocationCSR - Allocates memory for a sparse parallel matrix in AIJ format
    (the default parallel PETSc format).
@@ -5901,6 +6408,9 @@ PetscErrorCode MatGetCommunicationStructs(Mat A, Vec *lvec, PetscInt *colmap[],
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJCRL(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJPERM(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJSELL(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJOMP(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJSingle(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJDelta(Mat,MatType,MatReuse,Mat*);
 #if defined(PETSC_HAVE_MKL_SPARSE)
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJMKL(Mat,MatType,MatReuse,Mat*);
 #endif
@@ -5985,7 +6495,9 @@ PETSC_INTERN PetscErrorCode MatMatMult_MPIDense_MPIAIJ(Mat A,Mat B,MatReuse scal
    MATMPIAIJ - MATMPIAIJ = "mpiaij" - A matrix type to be used for parallel sparse matrices.
 
    Options Database Keys:
-. -mat_type mpiaij - sets the matrix type to "mpiaij" during a call to MatSetFromOptions()
++ -mat_type mpiaij - sets the matrix type to "mpiaij" during a call to MatSetFromOptions()
+- -mat_hash_assembly - if the matrix is not preallocated, collect the entries of the first assembly in a hash table and
+                       preallocate exactly from it, avoiding the reallocations of MatSetValues()
 
    Level: beginner
 
@@ -6027,8 +6539,9 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat B)
   b->roworiented = PETSC_TRUE;
 
   /* stuff used for matrix vector multiply */
-  b->lvec  = NULL;
-  b->Mvctx = NULL;
+  b->lvec      = NULL;
+  b->Mvctx     = NULL;
+  b->multsplit = PETSC_TRUE;
 
   /* stuff for MatGetRow() */
   b->rowindices   = 0;
@@ -6043,11 +6556,19 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatRetrieveValues_C",MatRetrieveValues_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatIsTranspose_C",MatIsTranspose_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetPreallocation_C",MatMPIAIJSetPreallocation_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSORSetMulticolor_C",MatSORSetMulticolor_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSORGetMulticolor_C",MatSORGetMulticolor_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMultMultiple_C",MatMultMultiple_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatResetPreallocation_C",MatResetPreallocation_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetPreallocationCSR_C",MatMPIAIJSetPreallocationCSR_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetPreallocationCOO_C",MatSetPreallocationCOO_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetValuesCOO_C",MatSetValuesCOO_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatDiagonalScaleLocal_C",MatDiagonalScaleLocal_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijperm_C",MatConvert_MPIAIJ_MPIAIJPERM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijsell_C",MatConvert_MPIAIJ_MPIAIJSELL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijomp_C",MatConvert_MPIAIJ_MPIAIJOMP);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijsingle_C",MatConvert_MPIAIJ_MPIAIJSingle);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijdelta_C",MatConvert_MPIAIJ_MPIAIJDelta);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijmkl_C",MatConvert_MPIAIJ_MPIAIJMKL);CHKERRQ(ierr);
 #endif
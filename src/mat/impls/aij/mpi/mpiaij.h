@@ -38,6 +38,28 @@ typedef struct { /* used by MatPtAP_MPIAIJ_MPIAIJ() and MatMatMult_MPIAIJ_MPIAIJ
   PetscErrorCode (*view)(Mat,PetscViewer);
 } Mat_APMPI;
 
+typedef struct { /* used by MatSetPreallocationCOO() and MatSetValuesCOO() for MPIAIJ and MPIBAIJ */
+  PetscInt         nsend,nrecv;        /* number of entries sent to and received from the owning processes */
+  PetscInt         *sendperm;          /* location in coo_v[] of each entry sent */
+  PetscScalar      *sendbuf,*recvbuf;
+  PetscSF          sf;                 /* leaves are sendbuf[], roots are recvbuf[] on the owning process */
+  PetscInt         nA,nAl,nB,nBl;      /* number of entries going into the diagonal and off-diagonal blocks, the first nAl (nBl) are local */
+  PetscInt         *Aperm,*Apos;       /* coo_v[Aperm[k]] (k < nAl) or recvbuf[Aperm[k]] (k >= nAl) is added to the values of A at Apos[k] */
+  PetscInt         *Bperm,*Bpos;
+  PetscObjectState nonzerostate;       /* nonzero state of the matrix for which the above is valid */
+} Mat_MPICOO;
+
+typedef struct { /* used by MatMult_MPIAIJ() to apply the off-diagonal block as the ghost values of each process arrive */
+  PetscInt         nranks;             /* number of processes owning ghost columns */
+  PetscMPIInt      *ranks;             /* these processes, in increasing order */
+  PetscInt         *offset;            /* the pieces of ranks[r] are [offset[r],offset[r+1]) */
+  PetscInt         *row,*start,*len;   /* a piece is a run of len entries of a row of B, starting at start, whose columns are owned by one process */
+  PetscScalar      *sum;               /* product of each piece with the ghost values, added to the result in piece order once all are known */
+  Mat              B;                  /* the off-diagonal block, */
+  VecScatter       Mvctx;              /* the scatter of its ghost values, */
+  PetscObjectState nonzerostate;       /* and its nonzero state, for which the above is valid */
+} Mat_MPIAIJMultSplit;
+
 typedef struct {
   Mat A,B;                             /* local submatrices: A (diag part),
                                            B (off-diag part) */
@@ -60,6 +82,8 @@ typedef struct {
 
   /* The following variables are used for matrix-vector products */
   Vec        lvec;                 /* local vector */
+  Vec        *lvecs;               /* nlvecs work vectors like lvec, used by MatMultMultiple() */
+  PetscInt   nlvecs;
   Vec        diag;
   VecScatter Mvctx,Mvctx_mpi1;     /* scatter context for vector */
   PetscBool  Mvctx_mpi1_flg;       /* if true, additional Mvctx_mpi1 is requested for mat-mat ops, default false */
@@ -79,6 +103,17 @@ typedef struct {
   /* used by MatMatMatMult() */
   Mat_MatMatMatMult *matmatmatmult;
 
+  /* used by MatSetPreallocationCOO() and MatSetValuesCOO() */
+  Mat_MPICOO *coo;
+
+  /* used by MatMult_MPIAIJ() and MatMultAdd_MPIAIJ() to overlap the off-diagonal product with the scatter, see -mat_mpiaij_mult_split */
+  PetscBool           multsplit;
+  Mat_MPIAIJMultSplit *split;
+
+  /* operations replaced while the first assembly goes through hash tables, see MatSetUp_MPIAIJ() */
+  PetscErrorCode (*htsetvalues)(Mat,PetscInt,const PetscInt[],PetscInt,const PetscInt[],const PetscScalar[],InsertMode);
+  PetscErrorCode (*htassemblyend)(Mat,MatAssemblyType);
+
   /* Used by MPICUSP and MPICUSPARSE classes */
   void * spptr;
 
@@ -90,6 +125,12 @@ PETSC_INTERN PetscErrorCode MatAssemblyEnd_MPIAIJ(Mat,MatAssemblyType);
 
 PETSC_INTERN PetscErrorCode MatSetUpMultiply_MPIAIJ(Mat);
 PETSC_INTERN PetscErrorCode MatDisAssemble_MPIAIJ(Mat);
+PETSC_INTERN PetscErrorCode MatSetPreallocationCOO_MPIXAIJ_Private(Mat,Mat,Mat,PetscInt,PetscErrorCode (*)(Mat,PetscInt,const PetscInt[]),PetscInt,const PetscInt[],const PetscInt[],Mat_MPICOO**);
+PETSC_INTERN PetscErrorCode MatSetValuesCOO_MPIXAIJ_Private(Mat_MPICOO*,const PetscScalar[],InsertMode,MatScalar*,PetscInt,MatScalar*,PetscInt);
+PETSC_INTERN PetscErrorCode MatDestroyCOO_MPIXAIJ_Private(Mat_MPICOO**);
+PETSC_INTERN PetscErrorCode MatMPIAIJMultSplitDestroy_Private(Mat_MPIAIJMultSplit**);
+PETSC_INTERN PetscErrorCode MatSetPreallocationCOO_MPIAIJ(Mat,PetscInt,const PetscInt[],const PetscInt[]);
+PETSC_INTERN PetscErrorCode MatSetValuesCOO_MPIAIJ(Mat,const PetscScalar[],InsertMode);
 PETSC_INTERN PetscErrorCode MatDuplicate_MPIAIJ(Mat,MatDuplicateOption,Mat*);
 PETSC_INTERN PetscErrorCode MatIncreaseOverlap_MPIAIJ(Mat,PetscInt,IS [],PetscInt);
 PETSC_INTERN PetscErrorCode MatIncreaseOverlap_MPIAIJ_Scalable(Mat,PetscInt,IS [],PetscInt);
@@ -1159,22 +1159,34 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   ierr = PetscFree(a->ipre);CHKERRQ(ierr);
   ierr = PetscFree3(a->idiag,a->mdiag,a->ssor_work);CHKERRQ(ierr);
   ierr = PetscFree(a->solve_work);CHKERRQ(ierr);
+  ierr = MatSeqAIJSolveLevelsDestroy(A);CHKERRQ(ierr);
   ierr = ISDestroy(&a->icol);CHKERRQ(ierr);
   ierr = PetscFree(a->saved_values);CHKERRQ(ierr);
   ierr = ISColoringDestroy(&a->coloring);CHKERRQ(ierr);
   ierr = PetscFree2(a->compressedrow.i,a->compressedrow.rindex);CHKERRQ(ierr);
   ierr = PetscFree(a->matmult_abdense);CHKERRQ(ierr);
+  ierr = PetscFree(a->matmult_rstart);CHKERRQ(ierr);
+  ierr = PetscFree2(a->sor_colorptr,a->sor_colorrows);CHKERRQ(ierr);
+  ierr = PetscFree(a->coo_pos);CHKERRQ(ierr);
+  ierr = PetscHMapIJVDestroy(&a->ht);CHKERRQ(ierr);
+  ierr = PetscFree(a->htnnz);CHKERRQ(ierr);
 
   ierr = MatDestroy_SeqAIJ_Inode(A);CHKERRQ(ierr);
   ierr = PetscFree(A->data);CHKERRQ(ierr);
 
   ierr = PetscObjectChangeTypeName((PetscObject)A,0);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJSetColumnIndices_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSORSetMulticolor_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSORGetMulticolor_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatMultMultiple_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatStoreValues_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatRetrieveValues_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaij_seqsbaij_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaij_seqbaij_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaij_seqaijperm_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaij_seqaijomp_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaij_seqaijsingle_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaij_seqaijdelta_C",NULL);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_ELEMENTAL)
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaij_elemental_C",NULL);CHKERRQ(ierr);
 #endif
@@ -1189,6 +1201,8 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJSetPreallocation_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatResetPreallocation_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJSetPreallocationCSR_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSetPreallocationCOO_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSetValuesCOO_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatReorderForNonzeroDiagonal_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatPtAP_is_seqaij_C",NULL);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -1819,6 +1833,10 @@ PetscErrorCode MatSOR_SeqAIJ(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscR
   const PetscInt    *idx,*diag;
 
   PetscFunctionBegin;
+  if (a->sor_multicolor && !(flag & SOR_EISENSTAT) && flag != SOR_APPLY_UPPER && flag != SOR_APPLY_LOWER) {
+    ierr = MatSOR_SeqAIJ_Multicolor(A,bb,omega,flag,fshift,its,lits,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   its = its*lits;
 
   if (fshift != a->fshift || omega != a->omega) a->idiagvalid = PETSC_FALSE; /* must recompute idiag[] */
@@ -2884,6 +2902,7 @@ PetscErrorCode MatCopy_SeqAIJ(Mat A,Mat B,MatStructure str)
 
     if (a->i[A->rmap->n] != b->i[B->rmap->n]) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Number of nonzeros in two matrices are different");
     ierr = PetscArraycpy(b->a,a->a,a->i[A->rmap->n]);CHKERRQ(ierr);
+    ierr = MatSeqAIJInvalidateDiagonal(B);CHKERRQ(ierr);
     ierr = PetscObjectStateIncrease((PetscObject)B);CHKERRQ(ierr);
   } else {
     ierr = MatCopy_Basic(A,B,str);CHKERRQ(ierr);
@@ -2894,9 +2913,142 @@ PetscErrorCode MatCopy_SeqAIJ(Mat A,Mat B,MatStructure str)
 PetscErrorCode MatSetUp_SeqAIJ(Mat A)
 {
   PetscErrorCode ierr;
+  PetscBool      hash = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsGetBool(((PetscObject)A)->options,((PetscObject)A)->prefix,"-mat_hash_assembly",&hash,NULL);CHKERRQ(ierr);
+  if (hash && !A->structure_only) {
+    ierr = MatSetUp_SeqAIJ_Hash(A);CHKERRQ(ierr);
+  } else {
+    ierr = MatSeqAIJSetPreallocation_SeqAIJ(A,PETSC_DEFAULT,0);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValues_SeqAIJ_Hash(Mat A,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],const PetscScalar v[],InsertMode is)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscInt       k,l,row,col;
+  PetscScalar    value = 0.0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (k=0; k<m; k++) {
+    row = im[k];
+    if (row < 0) continue;
+#if defined(PETSC_USE_DEBUG)
+    if (row >= A->rmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row too large: row %D max %D",row,A->rmap->n-1);
+#endif
+    for (l=0; l<n; l++) {
+      col = in[l];
+      if (col < 0) continue;
+#if defined(PETSC_USE_DEBUG)
+      if (col >= A->cmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column too large: col %D max %D",col,A->cmap->n-1);
+#endif
+      if (v) value = a->roworiented ? v[l + k*n] : v[k + l*m];
+      if (value == 0.0 && a->ignorezeroentries && is == ADD_VALUES && row != col) continue;
+      ierr = MatSeqAIJHashSetValue_Private(a,row,col,value,is);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatZeroEntries_SeqAIJ_Hash(Mat A)
+{
+  Mat_SeqAIJ    *a = (Mat_SeqAIJ*)A->data;
+  PetscHashIter hi;
+
+  PetscFunctionBegin;
+  PetscHashIterBegin(a->ht,hi);
+  while (!PetscHashIterAtEnd(a->ht,hi)) {
+    PetscHashIterSetVal(a->ht,hi,0.0);
+    PetscHashIterNext(a->ht,hi);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatAssemblyEnd_SeqAIJ_Hash(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+  ierr = MatSeqAIJHashToCSR_Private(A);CHKERRQ(ierr);
+  ierr = (*A->ops->assemblyend)(A,mode);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Used instead of the default preallocation when MatSetUp() is called on an unpreallocated matrix and -mat_hash_assembly
+   is set. Until the first final assembly MatSetValues() only records entries in a hash table, which costs O(1) per entry
+   whatever the insertion order, instead of the repeated row reallocations of MatSetValues_SeqAIJ(). The exact
+   preallocation is then known, and the CSR structure is built once by MatSeqAIJHashToCSR_Private(); later assemblies
+   use the usual code.
+*/
+PetscErrorCode MatSetUp_SeqAIJ_Hash(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr =  MatSeqAIJSetPreallocation_SeqAIJ(A,PETSC_DEFAULT,0);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(A->rmap);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(A->cmap);CHKERRQ(ierr);
+  ierr = PetscHMapIJVCreate(&a->ht);CHKERRQ(ierr);
+  ierr = PetscCalloc1(A->rmap->n,&a->htnnz);CHKERRQ(ierr);
+  a->htsetvalues        = A->ops->setvalues;
+  a->htassemblyend      = A->ops->assemblyend;
+  a->htzeroentries      = A->ops->zeroentries;
+  A->ops->setvalues     = MatSetValues_SeqAIJ_Hash;
+  A->ops->assemblyend   = MatAssemblyEnd_SeqAIJ_Hash;
+  A->ops->zeroentries   = MatZeroEntries_SeqAIJ_Hash;
+  A->preallocated       = PETSC_TRUE;
+  ierr = PetscInfo(A,"Using a hash table for the first assembly\n");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Preallocates A exactly from the entries accumulated in the hash table, copies them into the CSR arrays (sorted by
+   column) and restores the regular operations. A is left unassembled.
+*/
+PetscErrorCode MatSeqAIJHashToCSR_Private(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscInt       m = A->rmap->n,nz,k,r,p,nonew,*ai,*ailen;
+  PetscHashIJKey *keys;
+  PetscScalar    *vals;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!a->ht) PetscFunctionReturn(0);
+  ierr = PetscHMapIJVGetSize(a->ht,&nz);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nz,&keys,nz,&vals);CHKERRQ(ierr);
+  k    = 0;
+  ierr = PetscHMapIJVGetPairs(a->ht,&k,keys,vals);CHKERRQ(ierr);
+  ierr = PetscHMapIJVDestroy(&a->ht);CHKERRQ(ierr);
+
+  A->ops->setvalues   = a->htsetvalues;
+  A->ops->assemblyend = a->htassemblyend;
+  A->ops->zeroentries = a->htzeroentries;
+  A->preallocated     = PETSC_FALSE;
+  nonew               = a->nonew; /* do not turn on MAT_NEW_NONZERO_ALLOCATION_ERR, the user never preallocated */
+  ierr = MatSeqAIJSetPreallocation(A,0,a->htnnz);CHKERRQ(ierr);
+  a->nonew            = nonew;
+  ierr = PetscFree(a->htnnz);CHKERRQ(ierr);
+
+  /* every row has exactly as many slots as entries, so the structure can be filled in directly */
+  ai    = a->i;
+  ailen = a->ilen;
+  for (k=0; k<nz; k++) {
+    r        = keys[k].i;
+    p        = ai[r] + ailen[r]++;
+    a->j[p]  = keys[k].j;
+    a->a[p]  = vals[k];
+  }
+  for (r=0; r<m; r++) {
+    ierr = PetscSortIntWithScalarArray(ailen[r],a->j+ai[r],a->a+ai[r]);CHKERRQ(ierr);
+  }
+  ierr = PetscFree2(keys,vals);CHKERRQ(ierr);
+  A->nonzerostate++;
   PetscFunctionReturn(0);
 }
 
@@ -4055,6 +4207,108 @@ PetscErrorCode  MatSeqAIJSetPreallocationCSR_SeqAIJ(Mat B,const PetscInt Ii[],co
   PetscFunctionReturn(0);
 }
 
+/*
+   Lays out the nonzero structure of a SeqAIJ or SeqBAIJ matrix (bs is 1 for SeqAIJ) from COO coordinates and
+   computes, for each coordinate, the location in a[] where its value goes; pos[k] < 0 for dropped coordinates.
+   prealloc() is the preallocation routine of the type. The matrix still needs to be assembled.
+*/
+PetscErrorCode MatSeqXAIJSetPreallocationCOO_Private(Mat A,PetscInt bs,PetscErrorCode (*prealloc)(Mat,PetscInt,const PetscInt[]),PetscInt n,const PetscInt coo_i[],const PetscInt coo_j[],PetscInt pos[])
+{
+  Mat_SeqAIJ     *a;
+  PetscInt       m,N,mbs,bs2 = bs*bs,k,r,p,*rptr,*cols,*nnz,*ai,*aj;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscLayoutSetUp(A->rmap);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(A->cmap);CHKERRQ(ierr);
+  m    = A->rmap->n;
+  N    = A->cmap->n;
+  mbs  = m/bs;
+
+  /* bucket the block columns by block row, then sort and remove duplicates in each row */
+  ierr = PetscCalloc2(mbs+1,&rptr,mbs,&nnz);CHKERRQ(ierr);
+  for (k=0; k<n; k++) {
+    if (coo_i[k] < 0 || coo_j[k] < 0) continue;
+    if (coo_i[k] >= m) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row %D of entry %D is too large, maximum %D",coo_i[k],k,m-1);
+    if (coo_j[k] >= N) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column %D of entry %D is too large, maximum %D",coo_j[k],k,N-1);
+    rptr[coo_i[k]/bs+1]++;
+  }
+  for (r=0; r<mbs; r++) rptr[r+1] += rptr[r];
+  ierr = PetscMalloc1(rptr[mbs],&cols);CHKERRQ(ierr);
+  for (k=0; k<n; k++) {
+    if (coo_i[k] < 0 || coo_j[k] < 0) continue;
+    r = coo_i[k]/bs;
+    cols[rptr[r]+nnz[r]++] = coo_j[k]/bs;
+  }
+  for (r=0; r<mbs; r++) {
+    ierr = PetscSortRemoveDupsInt(&nnz[r],cols+rptr[r]);CHKERRQ(ierr);
+  }
+
+  /* the preallocation gives every row exactly nnz[] slots, so the structure can be filled in directly */
+  ierr = (*prealloc)(A,0,nnz);CHKERRQ(ierr);
+  a    = (Mat_SeqAIJ*)A->data;
+  ai   = a->i;
+  aj   = a->j;
+  for (r=0; r<mbs; r++) {
+    ierr       = PetscArraycpy(aj+ai[r],cols+rptr[r],nnz[r]);CHKERRQ(ierr);
+    a->ilen[r] = nnz[r];
+  }
+  ierr = PetscArrayzero(a->a,bs2*ai[mbs]);CHKERRQ(ierr);
+  A->nonzerostate++;
+
+  for (k=0; k<n; k++) {
+    if (coo_i[k] < 0 || coo_j[k] < 0) {pos[k] = -1; continue;}
+    r    = coo_i[k]/bs;
+    ierr = PetscFindInt(coo_j[k]/bs,nnz[r],aj+ai[r],&p);CHKERRQ(ierr);
+    /* blocks are stored column major */
+    pos[k] = bs2*(ai[r]+p) + bs*(coo_j[k]%bs) + coo_i[k]%bs;
+  }
+  ierr = PetscFree2(rptr,nnz);CHKERRQ(ierr);
+  ierr = PetscFree(cols);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSetPreallocationCOO_SeqAIJ(Mat A,PetscInt n,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscInt       *pos;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(a->coo_pos);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&pos);CHKERRQ(ierr);
+  ierr = MatSeqXAIJSetPreallocationCOO_Private(A,1,MatSeqAIJSetPreallocation,n,coo_i,coo_j,pos);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_LOCATION_ERR,PETSC_TRUE);CHKERRQ(ierr);
+
+  a                   = (Mat_SeqAIJ*)A->data;
+  a->coo_n            = n;
+  a->coo_pos          = pos;
+  a->coo_nonzerostate = A->nonzerostate;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSetValuesCOO_SeqAIJ(Mat A,const PetscScalar v[],InsertMode imode)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  const PetscInt *pos = a->coo_pos;
+  PetscInt       k,n = a->coo_n;
+  PetscScalar    *aa;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!a->coo_nonzerostate || a->coo_nonzerostate != A->nonzerostate) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call MatSetPreallocationCOO() first, and the nonzero structure must not change afterwards");
+  ierr = MatSeqAIJGetArray(A,&aa);CHKERRQ(ierr);
+  if (imode == INSERT_VALUES) {ierr = PetscArrayzero(aa,a->nz);CHKERRQ(ierr);}
+  for (k=0; k<n; k++) {
+    if (pos[k] >= 0) aa[pos[k]] += v[k];
+  }
+  ierr = MatSeqAIJRestoreArray(A,&aa);CHKERRQ(ierr);
+  ierr = MatSeqAIJInvalidateDiagonal(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 #include <../src/mat/impls/dense/seq/dense.h>
 #include <petsc/private/kernels/petscaxpy.h>
 
@@ -4145,7 +4399,9 @@ PETSC_INTERN PetscErrorCode MatMatMult_SeqDense_SeqAIJ(Mat A,Mat B,MatReuse scal
    based on compressed sparse row format.
 
    Options Database Keys:
-. -mat_type seqaij - sets the matrix type to "seqaij" during a call to MatSetFromOptions()
++ -mat_type seqaij - sets the matrix type to "seqaij" during a call to MatSetFromOptions()
+- -mat_hash_assembly - if the matrix is not preallocated, collect the entries of the first assembly in a hash table and
+                       preallocate exactly from it, avoiding the reallocations of MatSetValues()
 
    Level: beginner
 
@@ -4176,7 +4432,7 @@ M*/
 . -mat_type aij - sets the matrix type to "aij" during a call to MatSetFromOptions()
 
   Developer Notes:
-    Subclasses include MATAIJCUSPARSE, MATAIJPERM, MATAIJSELL, MATAIJMKL, MATAIJCRL, and also automatically switches over to use inodes when
+    Subclasses include MATAIJCUSPARSE, MATAIJPERM, MATAIJSELL, MATAIJOMP, MATAIJMKL, MATAIJCRL, and also automatically switches over to use inodes when
    enough exist.
 
   Level: beginner
@@ -4402,12 +4658,18 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
 #endif
 
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetColumnIndices_C",MatSeqAIJSetColumnIndices_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSORSetMulticolor_C",MatSORSetMulticolor_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSORGetMulticolor_C",MatSORGetMulticolor_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMultMultiple_C",MatMultMultiple_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatStoreValues_C",MatStoreValues_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatRetrieveValues_C",MatRetrieveValues_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqsbaij_C",MatConvert_SeqAIJ_SeqSBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqbaij_C",MatConvert_SeqAIJ_SeqBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijperm_C",MatConvert_SeqAIJ_SeqAIJPERM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijsell_C",MatConvert_SeqAIJ_SeqAIJSELL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijomp_C",MatConvert_SeqAIJ_SeqAIJOMP);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijsingle_C",MatConvert_SeqAIJ_SeqAIJSingle);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijdelta_C",MatConvert_SeqAIJ_SeqAIJDelta);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijmkl_C",MatConvert_SeqAIJ_SeqAIJMKL);CHKERRQ(ierr);
 #endif
@@ -4430,6 +4692,8 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetPreallocation_C",MatSeqAIJSetPreallocation_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatResetPreallocation_C",MatResetPreallocation_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetPreallocationCSR_C",MatSeqAIJSetPreallocationCSR_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetPreallocationCOO_C",MatSetPreallocationCOO_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetValuesCOO_C",MatSetValuesCOO_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatReorderForNonzeroDiagonal_C",MatReorderForNonzeroDiagonal_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMult_seqdense_seqaij_C",MatMatMult_SeqDense_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMultSymbolic_seqdense_seqaij_C",MatMatMultSymbolic_SeqDense_SeqAIJ);CHKERRQ(ierr);
@@ -4490,6 +4754,7 @@ PetscErrorCode MatDuplicateNoCreate_SeqAIJ(Mat C,Mat A,MatDuplicateOption cpvalu
 
   c->ignorezeroentries = a->ignorezeroentries;
   c->roworiented       = a->roworiented;
+  c->sor_multicolor    = a->sor_multicolor;
   c->nonew             = a->nonew;
   if (a->diag) {
     ierr = PetscMalloc1(m+1,&c->diag);CHKERRQ(ierr);
@@ -5040,6 +5305,9 @@ PetscErrorCode  MatSeqAIJRegisterAll(void)
   ierr = MatSeqAIJRegister(MATSEQAIJCRL,      MatConvert_SeqAIJ_SeqAIJCRL);CHKERRQ(ierr);
   ierr = MatSeqAIJRegister(MATSEQAIJPERM,     MatConvert_SeqAIJ_SeqAIJPERM);CHKERRQ(ierr);
   ierr = MatSeqAIJRegister(MATSEQAIJSELL,     MatConvert_SeqAIJ_SeqAIJSELL);CHKERRQ(ierr);
+  ierr = MatSeqAIJRegister(MATSEQAIJOMP,      MatConvert_SeqAIJ_SeqAIJOMP);CHKERRQ(ierr);
+  ierr = MatSeqAIJRegister(MATSEQAIJSINGLE,   MatConvert_SeqAIJ_SeqAIJSingle);CHKERRQ(ierr);
+  ierr = MatSeqAIJRegister(MATSEQAIJDELTA,    MatConvert_SeqAIJ_SeqAIJDelta);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = MatSeqAIJRegister(MATSEQAIJMKL,      MatConvert_SeqAIJ_SeqAIJMKL);CHKERRQ(ierr);
 #endif
@@ -3,6 +3,7 @@
 #define __AIJ_H
 
 #include <petsc/private/matimpl.h>
+#include <petsc/private/hashmapijv.h>
 #include <petscctable.h>
 
 /*
@@ -38,6 +39,9 @@
   PetscBool         pivotinblocks;    /* pivot inside factorization of each diagonal block */ \
   Mat               parent;           /* set if this matrix was formed with MatDuplicate(...,MAT_SHARE_NONZERO_PATTERN,....); \
                                          means that this shares some data structures with the parent including diag, ilen, imax, i, j */\
+  PetscInt          coo_n;            /* number of entries given to MatSetPreallocationCOO() */ \
+  PetscInt          *coo_pos;         /* location in a[] of each of the coo_n entries, negative if the entry is ignored */ \
+  PetscObjectState  coo_nonzerostate; /* nonzero state of the matrix for which coo_pos[] is valid */ \
   Mat_SubSppt       *submatis1         /* used by MatCreateSubMatrices_MPIXAIJ_Local */
 
 typedef struct {
@@ -97,6 +101,26 @@ typedef struct {
   PetscObjectState mat_nonzerostate;               /* non-zero state when inodes were checked for */
 } Mat_SeqAIJ_Inode;
 
+/*
+   Schedule of a triangular solve with the factor: the tasks (rows, or inodes) are grouped in levels, a task only depends
+   on tasks of lower levels; each thread does its tasks level by level and waits only for the tasks of the other threads
+   that it depends on
+*/
+typedef struct {
+  PetscInt nlevels;
+  PetscInt *thrptr,*thrtasks;                      /* tasks of thread t, in the order they are done: thrtasks[thrptr[t]:thrptr[t+1]] */
+  PetscInt *depptr,*deps;                          /* tasks of other threads to wait for before task k: deps[depptr[k]:depptr[k+1]] */
+} Mat_SeqAIJ_SolveSchedule;
+
+typedef struct {
+  PetscInt                 ntasks,nthreads;
+  PetscBool                use;                    /* the schedule pays off, MatSolve_SeqAIJ_Levels() is installed */
+  PetscInt                 *tstart;                /* rows of task k are tstart[k]:tstart[k+1] */
+  Mat_SeqAIJ_SolveSchedule L,U;
+  PetscInt                 *done;                  /* done[k] == stamp once task k is finished in the current sweep */
+  PetscInt                 stamp;
+} Mat_SeqAIJ_SolveLevels;
+
 PETSC_INTERN PetscErrorCode MatView_SeqAIJ_Inode(Mat,PetscViewer);
 PETSC_INTERN PetscErrorCode MatAssemblyEnd_SeqAIJ_Inode(Mat,MatAssemblyType);
 PETSC_INTERN PetscErrorCode MatDestroy_SeqAIJ_Inode(Mat);
@@ -121,14 +145,29 @@ typedef struct {
   PetscBool   diagonaldense;                  /* all entries along the diagonal have been set; i.e. no missing diagonal terms */
   PetscScalar fshift,omega;                   /* last used omega and fshift */
 
+  PetscBool        sor_multicolor;            /* MatSOR() relaxes the rows color by color, see MatSORSetMulticolor() */
+  PetscInt         sor_ncolors;
+  PetscInt         *sor_colorptr,*sor_colorrows; /* rows of color c are sor_colorrows[sor_colorptr[c]:sor_colorptr[c+1]] */
+  PetscObjectState sor_nonzerostate;          /* nonzero state when the colors were computed */
+
   ISColoring  coloring;                       /* set with MatADSetColoring() used by MatADSetValues() */
+  Mat_SeqAIJ_SolveLevels *solvelevels;       /* level schedule of the threaded MatSolve() of a factor, see MatSeqAIJSolveLevelsSetUp() */
 
   PetscScalar         *matmult_abdense;    /* used by MatMatMult() */
+  PetscInt            *matmult_rstart;     /* row partition of the threaded MatMatMult(), one chunk per thread */
+  PetscInt            matmult_nthreads;
   Mat_AP              *ap;                 /* used by MatPtAP() */
   Mat_MatMatMatMult   *matmatmatmult;      /* used by MatMatMatMult() */
   Mat_RARt            *rart;               /* used by MatRARt() */
   Mat_MatMatTransMult *abt;                /* used by MatMatTransposeMult() */
   Mat_MatTransMatMult *atb;                /* used by MatTransposeMatMult() */
+
+  /* used while the first assembly of an unpreallocated matrix goes through a hash table, see MatSetUp_SeqAIJ_Hash() */
+  PetscHMapIJV   ht;                       /* (row,col) -> value of every entry set so far */
+  PetscInt       *htnnz;                   /* number of distinct columns in each row of ht */
+  PetscErrorCode (*htsetvalues)(Mat,PetscInt,const PetscInt[],PetscInt,const PetscInt[],const PetscScalar[],InsertMode);
+  PetscErrorCode (*htassemblyend)(Mat,MatAssemblyType);
+  PetscErrorCode (*htzeroentries)(Mat);
 } Mat_SeqAIJ;
 
 /*
@@ -147,6 +186,31 @@ PETSC_STATIC_INLINE PetscErrorCode MatSeqXAIJFreeAIJ(Mat AA,MatScalar **a,PetscI
   }
   return 0;
 }
+
+/*
+  Sets or adds one entry while the matrix is in hash assembly mode, counting the new locations per row
+*/
+PETSC_STATIC_INLINE PetscErrorCode MatSeqAIJHashSetValue_Private(Mat_SeqAIJ *A,PetscInt row,PetscInt col,PetscScalar value,InsertMode addv)
+{
+  PetscErrorCode ierr;
+  PetscHashIJKey key;
+  PetscHashIter  iter;
+  PetscBool      missing;
+  PetscScalar    old;
+
+  key.i = row;
+  key.j = col;
+  ierr  = PetscHMapIJVPut(A->ht,key,&iter,&missing);CHKERRQ(ierr);
+  if (missing) {
+    A->htnnz[row]++;
+  } else if (addv == ADD_VALUES) {
+    ierr   = PetscHMapIJVIterGet(A->ht,iter,&old);CHKERRQ(ierr);
+    value += old;
+  }
+  ierr = PetscHMapIJVIterSet(A->ht,iter,value);CHKERRQ(ierr);
+  return 0;
+}
+
 /*
     Allocates larger a, i, and j arrays for the XAIJ (AIJ, BAIJ, and SBAIJ) matrix types
     This is a macro because it takes the datatype as an argument which can be either a Mat or a MatScalar
@@ -237,6 +301,15 @@ PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJ(Mat A,Vec,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatMultTranspose_SeqAIJ(Mat A,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqAIJ(Mat A,Vec,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatSOR_SeqAIJ(Mat,Vec,PetscReal,MatSORType,PetscReal,PetscInt,PetscInt,Vec);
+PETSC_INTERN PetscErrorCode MatSOR_SeqAIJ_Multicolor(Mat,Vec,PetscReal,MatSORType,PetscReal,PetscInt,PetscInt,Vec);
+PETSC_INTERN PetscErrorCode MatSORSetMulticolor_SeqAIJ(Mat,PetscBool);
+PETSC_INTERN PetscErrorCode MatSORGetMulticolor_SeqAIJ(Mat,PetscBool*);
+PETSC_INTERN PetscErrorCode MatSeqAIJSolveLevelsSetUp(Mat);
+PETSC_INTERN PetscErrorCode MatSeqAIJSolveLevelsDestroy(Mat);
+PETSC_INTERN PetscErrorCode MatSolve_SeqAIJ_Levels(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatSeqAIJMultColumns_Private(Mat,const PetscScalar*,PetscInt,const PetscScalar*const*,PetscScalar*const*,InsertMode);
+PETSC_INTERN PetscErrorCode MatMultMultiple_SeqAIJ(Mat,PetscInt,const Vec[],Vec[]);
+PETSC_INTERN PetscErrorCode MatMultAddMultiple_SeqAIJ(Mat,PetscInt,const Vec[],Vec[]);
 
 PETSC_INTERN PetscErrorCode MatSetOption_SeqAIJ(Mat,MatOption,PetscBool);
 
@@ -286,6 +359,7 @@ PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_Heap(Mat,Mat,PetscR
 PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_BTHeap(Mat,Mat,PetscReal,Mat*);
 PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_RowMerge(Mat,Mat,PetscReal,Mat*);
 PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_LLCondensed(Mat,Mat,PetscReal,Mat*);
+PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_Threaded(Mat,Mat,PetscReal,Mat*);
 #if defined(PETSC_HAVE_HYPRE)
 PETSC_INTERN PetscErrorCode MatMatMultSymbolic_AIJ_AIJ_wHYPRE(Mat,Mat,PetscReal,Mat*);
 #endif
@@ -294,6 +368,7 @@ PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Sorted(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqDense_SeqAIJ(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable(Mat,Mat,Mat);
+PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Threaded(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Combined(Mat,Mat,Mat);
 
 PETSC_INTERN PetscErrorCode MatPtAP_SeqAIJ_SeqAIJ(Mat,Mat,MatReuse,PetscReal,Mat*);
@@ -366,6 +441,9 @@ PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_Elemental(Mat,MatType,MatReuse,Mat
 PETSC_INTERN PetscErrorCode MatConvert_AIJ_HYPRE(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJPERM(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSELL(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJOMP(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSingle(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJDelta(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJMKL(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJViennaCL(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatReorderForNonzeroDiagonal_SeqAIJ(Mat,PetscReal,IS,IS);
@@ -387,6 +465,14 @@ PETSC_INTERN PetscErrorCode MatCreateSubMatrix_SeqAIJ(Mat,IS,IS,PetscInt,MatReus
 
 PETSC_INTERN PetscErrorCode MatSeqAIJCompactOutExtraColumns_SeqAIJ(Mat,ISLocalToGlobalMapping*);
 
+PETSC_INTERN PetscErrorCode MatSetUp_SeqAIJ_Hash(Mat);
+PETSC_INTERN PetscErrorCode MatSeqAIJHashToCSR_Private(Mat);
+PETSC_INTERN PetscErrorCode MatAIJAutoTune_Private(Mat);
+PETSC_INTERN PetscErrorCode MatInvertDiagonal_SeqAIJ(Mat,PetscScalar,PetscScalar);
+PETSC_INTERN PetscErrorCode MatSeqXAIJSetPreallocationCOO_Private(Mat,PetscInt,PetscErrorCode (*)(Mat,PetscInt,const PetscInt[]),PetscInt,const PetscInt[],const PetscInt[],PetscInt[]);
+PETSC_INTERN PetscErrorCode MatSetPreallocationCOO_SeqAIJ(Mat,PetscInt,const PetscInt[],const PetscInt[]);
+PETSC_INTERN PetscErrorCode MatSetValuesCOO_SeqAIJ(Mat,const PetscScalar[],InsertMode);
+
 /*
     PetscSparseDenseMinusDot - The inner kernel of triangular solves and Gauss-Siedel smoothing. \sum_i xv[i] * r[xi[i]] for CSR storage
 
@@ -0,0 +1,288 @@
+/*
+  Defines the MATSEQAIJAUTO matrix class and the format autotuner shared with MATMPIAIJAUTO.
+
+  The matrix is assembled exactly as a MATSEQAIJ matrix. At the end of the first final
+  assembly the row-length distribution and block structure of the matrix are sampled to
+  rule out the formats that cannot pay off, the remaining candidate formats are built with
+  MatConvert() and a few MatMult() are timed with each of them, and the matrix is then
+  converted in place to the fastest format. From then on the matrix is an ordinary matrix
+  of the chosen type (MATSEQAIJ, MATSEQAIJPERM, MATSEQAIJSELL, MATSEQSELL, MATSEQBAIJ, ...),
+  later changes of the nonzero structure do not trigger a new tuning.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+
+#define MAT_AIJAUTO_MAX_TYPES 16
+#define MAT_AIJAUTO_MAX_BS    8
+#define MAT_AIJAUTO_SLICE     8 /* slice height of the SELL based formats */
+
+static const char *const MatAIJAutoDefaultTypes[] = {"aij","aijperm","aijsell","aijcrl","sell","baij",
+#if defined(PETSC_HAVE_OPENMP)
+                                                     "aijomp",
+#endif
+#if defined(PETSC_HAVE_MKL_SPARSE)
+                                                     "aijmkl",
+#endif
+                                                     NULL};
+
+/*
+   Collects the local row-length statistics, and the ratio of stored entries to nonzeros the SELL
+   (sliced ELLPACK) and CRL (ELLPACK) formats would have because of the padding of short rows
+*/
+static PetscErrorCode MatAIJAutoRowStatistics_Private(Mat A,PetscInt *nz,PetscInt *maxlen,PetscReal *sellpad,PetscReal *crlpad)
+{
+  PetscErrorCode ierr;
+  PetscInt       row,rstart,rend,ncols,slicemax = 0;
+  PetscReal      sellnz = 0.0;
+
+  PetscFunctionBegin;
+  ierr    = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  *nz     = 0;
+  *maxlen = 0;
+  for (row=rstart; row<rend; row++) {
+    ierr     = MatGetRow(A,row,&ncols,NULL,NULL);CHKERRQ(ierr);
+    *nz     += ncols;
+    *maxlen  = PetscMax(*maxlen,ncols);
+    slicemax = PetscMax(slicemax,ncols);
+    ierr     = MatRestoreRow(A,row,&ncols,NULL,NULL);CHKERRQ(ierr);
+    if ((row-rstart)%MAT_AIJAUTO_SLICE == MAT_AIJAUTO_SLICE-1 || row == rend-1) {
+      sellnz  += MAT_AIJAUTO_SLICE*slicemax;
+      slicemax = 0;
+    }
+  }
+  *sellpad = *nz ? sellnz/(*nz) : 1.0;
+  *crlpad  = *nz ? ((PetscReal)(rend-rstart)*(*maxlen))/(*nz) : 1.0;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Checks if the matrix consists of dense, aligned bs x bs blocks, so that it can be stored in
+   a BAIJ format without explicit zeros. Collective, the result is the same on all processes.
+*/
+static PetscErrorCode MatAIJAutoIsBlocked_Private(Mat A,PetscInt bs,PetscInt maxlen,PetscBool *isblock)
+{
+  PetscErrorCode ierr;
+  PetscInt       row,rstart,rend,cstart,cend,ncols,nfirst = 0,k,*first;
+  const PetscInt *cols;
+  PetscBool      blocked,same;
+
+  PetscFunctionBegin;
+  ierr    = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  ierr    = MatGetOwnershipRangeColumn(A,&cstart,&cend);CHKERRQ(ierr);
+  blocked = (PetscBool)(!(rstart%bs) && !(rend%bs) && !(cstart%bs) && !(cend%bs) && !(A->cmap->N%bs));
+  ierr    = PetscMalloc1(maxlen,&first);CHKERRQ(ierr);
+  for (row=rstart; blocked && row<rend; row++) {
+    ierr = MatGetRow(A,row,&ncols,&cols,NULL);CHKERRQ(ierr);
+    if (!((row-rstart)%bs)) {
+      /* the first row of a block row defines the pattern: full blocks starting at multiples of bs */
+      if (ncols%bs) blocked = PETSC_FALSE;
+      for (k=0; blocked && k<ncols; k++) {
+        if (k%bs ? cols[k] != cols[k-1]+1 : cols[k]%bs) blocked = PETSC_FALSE;
+      }
+      ierr   = PetscArraycpy(first,cols,ncols);CHKERRQ(ierr);
+      nfirst = ncols;
+    } else {
+      /* the other rows of the block row must have the same pattern */
+      if (ncols != nfirst) blocked = PETSC_FALSE;
+      else {
+        ierr = PetscArraycmp(first,cols,ncols,&same);CHKERRQ(ierr);
+        if (!same) blocked = PETSC_FALSE;
+      }
+    }
+    ierr = MatRestoreRow(A,row,&ncols,&cols,NULL);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(first);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(&blocked,isblock,1,MPIU_BOOL,MPI_LAND,PetscObjectComm((PetscObject)A));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Returns the largest time over all processes needed for nmult products, after one untimed product */
+static PetscErrorCode MatAIJAutoTimeMult_Private(Mat B,PetscInt nmult,PetscLogDouble *time)
+{
+  PetscErrorCode ierr;
+  Vec            x,y;
+  PetscInt       i;
+  PetscLogDouble t0,t1,t;
+
+  PetscFunctionBegin;
+  ierr = MatCreateVecs(B,&x,&y);CHKERRQ(ierr);
+  ierr = VecSet(x,1.0);CHKERRQ(ierr);
+  /* the first product sets up data some formats create lazily, and brings the matrix into cache */
+  ierr = MatMult(B,x,y);CHKERRQ(ierr);
+  ierr = MPI_Barrier(PetscObjectComm((PetscObject)B));CHKERRQ(ierr);
+  ierr = PetscTime(&t0);CHKERRQ(ierr);
+  for (i=0; i<nmult; i++) {
+    ierr = MatMult(B,x,y);CHKERRQ(ierr);
+  }
+  ierr = PetscTime(&t1);CHKERRQ(ierr);
+  t    = t1 - t0;
+  ierr = MPIU_Allreduce(&t,time,1,MPI_DOUBLE,MPI_MAX,PetscObjectComm((PetscObject)B));CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   MatAIJAutoTune_Private - Times MatMult() with the candidate formats and converts the assembled
+   MATSEQAIJ or MATMPIAIJ matrix A in place to the fastest one.
+
+   Options Database Keys:
++  -mat_aijauto_types <aij,aijperm,aijsell,aijcrl,sell,baij> - candidate formats, without the seq/mpi prefix
+.  -mat_aijauto_nmult <10> - number of products timed for each candidate
+-  -mat_aijauto_max_padding <1.5> - SELL and CRL formats are not tried if padding would make them store more than this times the nonzeros
+*/
+PETSC_INTERN PetscErrorCode MatAIJAutoTune_Private(Mat A)
+{
+  PetscErrorCode         ierr;
+  MPI_Comm               comm;
+  char                   *types[MAT_AIJAUTO_MAX_TYPES],cand[256],best[256],*prefix = NULL,*name = NULL;
+  const char             *mtype;
+  PetscInt               i,ntypes = MAT_AIJAUTO_MAX_TYPES,nmult = 10,bs = 1,bestbs = 1,nz,maxlen,gnz,gmaxlen,tbs;
+  PetscReal              maxpad = 1.5,pad[2],gpad[2];
+  PetscBool              isseq,flg,issell,iscrl,isbaij,isreplaced,isblock,blocktested = PETSC_FALSE;
+  PetscLogDouble         t,tbest = PETSC_MAX_REAL;
+  Mat                    B;
+
+  PetscFunctionBegin;
+  if (A->structure_only || !A->ops->mult) PetscFunctionReturn(0);
+  ierr = PetscObjectGetComm((PetscObject)A,&comm);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(MAT_AutoTune,A,0,0,0);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATSEQAIJ,&isseq);CHKERRQ(ierr);
+  ierr = PetscObjectOptionsBegin((PetscObject)A);CHKERRQ(ierr);
+  ierr = PetscOptionsStringArray("-mat_aijauto_types","Candidate formats (without the seq/mpi prefix)","MatSetType",types,&ntypes,&flg);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-mat_aijauto_nmult","Number of products timed for each candidate format","None",nmult,&nmult,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-mat_aijauto_max_padding","Largest ratio of stored entries to nonzeros for the SELL and CRL formats","None",maxpad,&maxpad,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (!flg) {
+    for (ntypes=0; MatAIJAutoDefaultTypes[ntypes]; ntypes++) {
+      ierr = PetscStrallocpy(MatAIJAutoDefaultTypes[ntypes],&types[ntypes]);CHKERRQ(ierr);
+    }
+  }
+
+  ierr = MatAIJAutoRowStatistics_Private(A,&nz,&maxlen,&pad[0],&pad[1]);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(pad,gpad,2,MPIU_REAL,MPIU_MAX,comm);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(&nz,&gnz,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(&maxlen,&gmaxlen,1,MPIU_INT,MPI_MAX,comm);CHKERRQ(ierr);
+  ierr = PetscInfo5(A,"Nonzeros %D, mean row length %g, longest row %D, SELL padding %g, CRL padding %g\n",gnz,A->rmap->N ? (double)gnz/A->rmap->N : 0.0,gmaxlen,(double)gpad[0],(double)gpad[1]);CHKERRQ(ierr);
+
+  /* the converters that use MatHeaderReplace() lose the local to global mappings, so those formats are not tried on matrices with mappings */
+  ierr = PetscStrallocpy(((PetscObject)A)->prefix,&prefix);CHKERRQ(ierr);
+  ierr = PetscStrallocpy(((PetscObject)A)->name,&name);CHKERRQ(ierr);
+  for (i=0; i<ntypes; i++) {
+    ierr = PetscStrncpy(cand,isseq ? "seq" : "mpi",sizeof(cand));CHKERRQ(ierr);
+    ierr = PetscStrlcat(cand,types[i],sizeof(cand));CHKERRQ(ierr);
+    ierr = PetscStrendswith(types[i],"sell",&issell);CHKERRQ(ierr);
+    ierr = PetscStrcmp(types[i],"aijcrl",&iscrl);CHKERRQ(ierr);
+    ierr = PetscStrcmp(types[i],"baij",&isbaij);CHKERRQ(ierr);
+    ierr = PetscStrcmp(types[i],"sell",&isreplaced);CHKERRQ(ierr);
+    ierr = PetscStrcmp(types[i],"aij",&flg);CHKERRQ(ierr);
+    isreplaced = (PetscBool)(isreplaced || isbaij);
+    if ((issell && gpad[0] > maxpad) || (iscrl && gpad[1] > maxpad)) {
+      ierr = PetscInfo2(A,"Not trying format %s, padding would exceed %g\n",cand,(double)maxpad);CHKERRQ(ierr);
+      continue;
+    }
+    if (isreplaced && (A->rmap->mapping || A->cmap->mapping)) {
+      ierr = PetscInfo1(A,"Not trying format %s on a matrix with a local to global mapping\n",cand);CHKERRQ(ierr);
+      continue;
+    }
+    if (isbaij) {
+      if (!blocktested) {
+        /* use the block size set by the user if the matrix has it, otherwise the largest one that fits */
+        isblock = PETSC_FALSE;
+        for (tbs=A->rmap->bs > 1 ? A->rmap->bs : MAT_AIJAUTO_MAX_BS; !isblock && tbs>1; tbs--) {
+          ierr = MatAIJAutoIsBlocked_Private(A,tbs,maxlen,&isblock);CHKERRQ(ierr);
+          if (isblock) bs = tbs;
+          if (A->rmap->bs > 1) break;
+        }
+        blocktested = PETSC_TRUE;
+        ierr = PetscInfo1(A,"Block size detected for BAIJ %D\n",bs);CHKERRQ(ierr);
+      }
+      if (bs == 1) continue;
+      ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+      ierr = MatSetBlockSizes(B,bs,bs);CHKERRQ(ierr);
+      ierr = MatConvert(B,cand,MAT_INPLACE_MATRIX,&B);CHKERRQ(ierr);
+    } else if (flg) {
+      B = A;
+    } else {
+      ierr = MatConvert(A,cand,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+    }
+    ierr = MatAIJAutoTimeMult_Private(B,nmult,&t);CHKERRQ(ierr);
+    ierr = PetscInfo3(A,"Format %s: %g seconds for %D products\n",cand,t,nmult);CHKERRQ(ierr);
+    if (t < tbest) {
+      tbest  = t;
+      bestbs = isbaij ? bs : 1;
+      ierr   = PetscStrncpy(best,cand,sizeof(best));CHKERRQ(ierr);
+    }
+    if (B != A) {ierr = MatDestroy(&B);CHKERRQ(ierr);}
+  }
+  for (i=0; i<ntypes; i++) {ierr = PetscFree(types[i]);CHKERRQ(ierr);}
+
+  ierr = PetscObjectGetType((PetscObject)A,&mtype);CHKERRQ(ierr);
+  if (tbest == PETSC_MAX_REAL) {
+    ierr = PetscInfo1(A,"No candidate format was timed, keeping %s\n",mtype);CHKERRQ(ierr);
+  } else {
+    ierr = PetscStrcmp(best,mtype,&flg);CHKERRQ(ierr);
+    if (!flg) {
+      if (bestbs > 1) {ierr = MatSetBlockSizes(A,bestbs,bestbs);CHKERRQ(ierr);}
+      ierr = MatConvert(A,best,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+      ierr = MatSetOptionsPrefix(A,prefix);CHKERRQ(ierr);
+      ierr = PetscObjectSetName((PetscObject)A,name);CHKERRQ(ierr);
+    }
+    ierr = PetscInfo2(A,"Using format %s, %g seconds per product\n",best,tbest/PetscMax(nmult,1));CHKERRQ(ierr);
+  }
+  ierr = PetscFree(prefix);CHKERRQ(ierr);
+  ierr = PetscFree(name);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(MAT_AutoTune,A,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatAssemblyEnd_SeqAIJAUTO(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatAssemblyEnd_SeqAIJ(A,mode);CHKERRQ(ierr);
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+
+  /* the matrix is a plain MATSEQAIJ matrix from now on, which the tuner then converts */
+  A->ops->assemblyend = MatAssemblyEnd_SeqAIJ;
+  A->assembled        = PETSC_TRUE;
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatAIJAutoTune_Private(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   MATSEQAIJAUTO - MATSEQAIJAUTO = "seqaijauto" - A sequential sparse matrix that selects its storage format at run time.
+
+   The matrix is preallocated and assembled as a MATSEQAIJ matrix. At the end of the first MAT_FINAL_ASSEMBLY the
+   formats that can pay off for its row-length distribution and block structure are timed with a few MatMult()
+   and the matrix is converted in place to the fastest one, after which it is an ordinary matrix of that type.
+   The decision is reported with -info, and the time spent tuning is logged in the MatAutoTune event.
+
+   Options Database Keys:
++  -mat_type seqaijauto - sets the matrix type to "seqaijauto" during a call to MatSetFromOptions()
+.  -mat_aijauto_types <aij,aijperm,aijsell,aijcrl,sell,baij> - candidate formats, without the seq/mpi prefix
+.  -mat_aijauto_nmult <10> - number of products timed for each candidate
+-  -mat_aijauto_max_padding <1.5> - SELL and CRL formats are not tried if padding would make them store more than this times the nonzeros
+
+   Notes:
+   BAIJ is only tried when the matrix consists of dense aligned blocks, with the block size set by the user or
+   the largest such block size up to 8. Changes of the nonzero structure after the first assembly do not cause
+   the format to be tuned again.
+
+   Level: intermediate
+
+.seealso: MatCreate(), MATAIJAUTO, MATMPIAIJAUTO, MATSEQAIJ, MATSEQAIJPERM, MATSEQAIJSELL, MATSEQSELL, MATSEQBAIJ, MatConvert()
+M*/
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJAUTO(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  A->ops->assemblyend = MatAssemblyEnd_SeqAIJAUTO;
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATSEQAIJAUTO);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
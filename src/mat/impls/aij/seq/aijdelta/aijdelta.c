@@ -0,0 +1,549 @@
+/*
+  Defines basic operations for the MATSEQAIJDELTA matrix class.
+  This class is derived from the MATSEQAIJ class and retains the
+  compressed row storage (aka Yale sparse matrix format) but, in
+  addition, stores the column indices in compressed form: for each row a
+  base column (the smallest column of the row) and, for each nonzero, the
+  16-bit offset of its column from the base. The kernels MatMult(),
+  MatMultAdd() and MatSOR() read these offsets instead of the PetscInt
+  column indices, which cuts the index traffic by 4 with 64-bit indices
+  (by 2 with 32-bit indices).
+
+  Rows whose columns do not all fit within 65535 of the base (outliers)
+  are flagged by a negative base and are processed with the PetscInt
+  column indices, which remain the reference for all other operations.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+
+/* largest offset that fits in the compressed column indices */
+#define MATSEQAIJDELTA_MAX_OFFSET 65535
+
+typedef struct {
+  PetscObjectState nonzerostate; /* nonzero state for which the compressed indices were computed */
+  PetscInt         *base;        /* smallest column of each row, or -1 if the row must use the full column indices */
+  unsigned short   *off;         /* column offsets from the base, parallel to a->j */
+  PetscInt         nz;           /* allocated length of off */
+  PetscInt         nescaped;     /* number of rows that use the full column indices */
+} Mat_SeqAIJDelta;
+
+/* Computes the compressed column indices if the nonzero structure has changed */
+static PetscErrorCode MatSeqAIJDeltaSetUp_Private(Mat A)
+{
+  PetscErrorCode  ierr;
+  Mat_SeqAIJ      *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJDelta *aijd = (Mat_SeqAIJDelta*)A->spptr;
+  PetscInt        m = A->rmap->n,i,k,nz,cmin,cmax;
+  const PetscInt  *aj;
+
+  PetscFunctionBegin;
+  if (aijd->nonzerostate == A->nonzerostate && aijd->base) PetscFunctionReturn(0);
+  nz = a->i[m];
+  if (nz > aijd->nz || !aijd->off) {
+    ierr     = PetscFree(aijd->off);CHKERRQ(ierr);
+    ierr     = PetscMalloc1(PetscMax(nz,1),&aijd->off);CHKERRQ(ierr);
+    aijd->nz = nz;
+  }
+  if (!aijd->base) {
+    ierr = PetscMalloc1(m,&aijd->base);CHKERRQ(ierr);
+  }
+  aijd->nescaped = 0;
+  for (i=0; i<m; i++) {
+    aj = a->j + a->i[i];
+    nz = a->i[i+1] - a->i[i];
+    if (!nz) {aijd->base[i] = 0; continue;}
+    cmin = cmax = aj[0];
+    for (k=1; k<nz; k++) {
+      cmin = PetscMin(cmin,aj[k]);
+      cmax = PetscMax(cmax,aj[k]);
+    }
+    if (cmax - cmin > MATSEQAIJDELTA_MAX_OFFSET) {
+      aijd->base[i] = -1;
+      aijd->nescaped++;
+      continue;
+    }
+    aijd->base[i] = cmin;
+    for (k=0; k<nz; k++) aijd->off[a->i[i]+k] = (unsigned short)(aj[k] - cmin);
+  }
+  aijd->nonzerostate = A->nonzerostate;
+  ierr = PetscInfo2(A,"Compressed column indices computed, %D of %D rows use the full column indices\n",aijd->nescaped,m);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqAIJDeltaReset_Private(Mat_SeqAIJDelta *aijd)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(aijd->base);CHKERRQ(ierr);
+  ierr = PetscFree(aijd->off);CHKERRQ(ierr);
+  aijd->nz           = 0;
+  aijd->nescaped     = 0;
+  aijd->nonzerostate = -1;
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJDelta_SeqAIJ(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  /* This routine is only called to convert a MATAIJDELTA to its base PETSc type, */
+  /* so we will ignore 'MatType type'. */
+  PetscErrorCode ierr;
+  Mat            B = *newmat;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+
+  /* Reset the original function pointers. */
+  B->ops->duplicate   = MatDuplicate_SeqAIJ;
+  B->ops->assemblyend = MatAssemblyEnd_SeqAIJ;
+  B->ops->destroy     = MatDestroy_SeqAIJ;
+  B->ops->mult        = MatMult_SeqAIJ;
+  B->ops->multadd     = MatMultAdd_SeqAIJ;
+  B->ops->sor         = MatSOR_SeqAIJ;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijdelta_seqaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMult_seqdense_seqaijdelta_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMultSymbolic_seqdense_seqaijdelta_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMultNumeric_seqdense_seqaijdelta_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatPtAP_is_seqaijdelta_C",NULL);CHKERRQ(ierr);
+
+  /* Free everything in the Mat_SeqAIJDelta data structure. */
+  ierr = MatSeqAIJDeltaReset_Private((Mat_SeqAIJDelta*)B->spptr);CHKERRQ(ierr);
+  ierr = PetscFree(B->spptr);CHKERRQ(ierr);
+
+  /* Let the inode routines be used again */
+  ((Mat_SeqAIJ*)B->data)->inode.use = PETSC_TRUE;
+
+  /* Change the type of B to MATSEQAIJ. */
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
+
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDestroy_SeqAIJDelta(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* If MatHeaderMerge() was used then this SeqAIJDelta matrix will not have a spptr. */
+  if (A->spptr) {
+    ierr = MatSeqAIJDeltaReset_Private((Mat_SeqAIJDelta*)A->spptr);CHKERRQ(ierr);
+    ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  }
+  /* Change the type of A back to SEQAIJ and use MatDestroy_SeqAIJ()
+   * to destroy everything that remains. */
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDuplicate_SeqAIJDelta(Mat A,MatDuplicateOption op,Mat *M)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatDuplicate_SeqAIJ(A,op,M);CHKERRQ(ierr);
+  /* the compressed indices are computed at the first use of the duplicate */
+  ierr = MatSeqAIJDeltaReset_Private((Mat_SeqAIJDelta*)(*M)->spptr);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatAssemblyEnd_SeqAIJDelta(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+
+  /* Disable the inode routines so that the compressed index kernels are not replaced by the
+   * inode ones in MatAssemblyEnd_SeqAIJ_Inode() */
+  a->inode.use = PETSC_FALSE;
+  ierr = MatAssemblyEnd_SeqAIJ(A,mode);CHKERRQ(ierr);
+  ierr = MatSeqAIJDeltaSetUp_Private(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Sum of v[k]*x[col[k]] over the n nonzeros of a row starting at v, added to (PlusDot) or subtracted from
+   (MinusDot) sum; off and aj are the compressed and the full column indices of these nonzeros, base the
+   base column of the row */
+#define MatSeqAIJDeltaPlusDot_Private(sum,x,v,off,aj,base,n) do { \
+    PetscInt __k; \
+    if ((base) < 0) { \
+      for (__k=0; __k<(n); __k++) (sum) += (v)[__k]*(x)[(aj)[__k]]; \
+    } else { \
+      const PetscScalar *__xb = (x) + (base); \
+      for (__k=0; __k<(n); __k++) (sum) += (v)[__k]*__xb[(off)[__k]]; \
+    } \
+  } while (0)
+
+#define MatSeqAIJDeltaMinusDot_Private(sum,x,v,off,aj,base,n) do { \
+    PetscInt __k; \
+    if ((base) < 0) { \
+      for (__k=0; __k<(n); __k++) (sum) -= (v)[__k]*(x)[(aj)[__k]]; \
+    } else { \
+      const PetscScalar *__xb = (x) + (base); \
+      for (__k=0; __k<(n); __k++) (sum) -= (v)[__k]*__xb[(off)[__k]]; \
+    } \
+  } while (0)
+
+static PetscErrorCode MatMult_SeqAIJDelta(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJDelta   *aijd = (Mat_SeqAIJDelta*)A->spptr;
+  PetscScalar       *y;
+  const PetscScalar *x;
+  const MatScalar   *aa;
+  PetscErrorCode    ierr;
+  PetscInt          m = A->rmap->n;
+  const PetscInt    *ii,*ridx = NULL;
+  PetscInt          n,i,r;
+  PetscScalar       sum;
+  PetscBool         usecprow = a->compressedrow.use;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJDeltaSetUp_Private(A);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  ii   = a->i;
+  if (usecprow) { /* use compressed row format */
+    ierr = PetscArrayzero(y,m);CHKERRQ(ierr);
+    m    = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  for (i=0; i<m; i++) {
+    r   = usecprow ? ridx[i] : i;
+    n   = ii[i+1] - ii[i];
+    aa  = a->a + ii[i];
+    sum = 0.0;
+    MatSeqAIJDeltaPlusDot_Private(sum,x,aa,aijd->off+ii[i],a->j+ii[i],aijd->base[r],n);
+    y[r] = sum;
+  }
+  ierr = PetscLogFlops(2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMultAdd_SeqAIJDelta(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJDelta   *aijd = (Mat_SeqAIJDelta*)A->spptr;
+  PetscScalar       *y,*z;
+  const PetscScalar *x;
+  const MatScalar   *aa;
+  PetscErrorCode    ierr;
+  PetscInt          m = A->rmap->n;
+  const PetscInt    *ii,*ridx = NULL;
+  PetscInt          n,i,r;
+  PetscScalar       sum;
+  PetscBool         usecprow = a->compressedrow.use;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJDeltaSetUp_Private(A);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  ii   = a->i;
+  if (usecprow) { /* use compressed row format */
+    if (zz != yy) {
+      ierr = PetscArraycpy(z,y,m);CHKERRQ(ierr);
+    }
+    m    = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  for (i=0; i<m; i++) {
+    r   = usecprow ? ridx[i] : i;
+    n   = ii[i+1] - ii[i];
+    aa  = a->a + ii[i];
+    sum = y[r];
+    MatSeqAIJDeltaPlusDot_Private(sum,x,aa,aijd->off+ii[i],a->j+ii[i],aijd->base[r],n);
+    z[r] = sum;
+  }
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Same as MatSOR_SeqAIJ() with the column indices loaded from the compressed indices */
+static PetscErrorCode MatSOR_SeqAIJDelta(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJDelta   *aijd = (Mat_SeqAIJDelta*)A->spptr;
+  PetscScalar       *x,d,sum,*t,scale;
+  const MatScalar   *v,*idiag=0,*mdiag;
+  const PetscScalar *b,*bs,*xb,*ts;
+  PetscErrorCode    ierr;
+  PetscInt          n,m = A->rmap->n,i,s;
+  const PetscInt    *diag,*base;
+  const unsigned short *off;
+
+  PetscFunctionBegin;
+  its = its*lits;
+
+  if (fshift != a->fshift || omega != a->omega) a->idiagvalid = PETSC_FALSE; /* must recompute idiag[] */
+  if (!a->idiagvalid) {ierr = MatInvertDiagonal_SeqAIJ(A,omega,fshift);CHKERRQ(ierr);}
+  a->fshift = fshift;
+  a->omega  = omega;
+  ierr      = MatSeqAIJDeltaSetUp_Private(A);CHKERRQ(ierr);
+
+  diag  = a->diag;
+  t     = a->ssor_work;
+  idiag = a->idiag;
+  mdiag = a->mdiag;
+  base  = aijd->base;
+  off   = aijd->off;
+
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  /* We count flops by assuming the upper triangular and lower triangular parts have the same number of nonzeros */
+  if (flag == SOR_APPLY_UPPER) {
+    /* apply (U + D/omega) to the vector */
+    bs = b;
+    for (i=0; i<m; i++) {
+      d   = fshift + mdiag[i];
+      s   = diag[i] + 1;
+      n   = a->i[i+1] - s;
+      v   = a->a + s;
+      sum = b[i]*d/omega;
+      MatSeqAIJDeltaPlusDot_Private(sum,bs,v,off+s,a->j+s,base[i],n);
+      x[i] = sum;
+    }
+    ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+    ierr = PetscLogFlops(a->nz);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  if (flag == SOR_APPLY_LOWER) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"SOR_APPLY_LOWER is not implemented");
+  else if (flag & SOR_EISENSTAT) {
+    /* Eisenstat's trick, see MatSOR_SeqAIJ() */
+    scale = (2.0/omega) - 1.0;
+
+    /*  x = (E + U)^{-1} b */
+    for (i=m-1; i>=0; i--) {
+      s   = diag[i] + 1;
+      n   = a->i[i+1] - s;
+      v   = a->a + s;
+      sum = b[i];
+      MatSeqAIJDeltaMinusDot_Private(sum,x,v,off+s,a->j+s,base[i],n);
+      x[i] = sum*idiag[i];
+    }
+
+    /*  t = b - (2*E - D)x */
+    for (i=0; i<m; i++) t[i] = b[i] - scale*mdiag[i]*x[i];
+
+    /*  t = (E + L)^{-1}t */
+    ts = t;
+    for (i=0; i<m; i++) {
+      s   = a->i[i];
+      n   = diag[i] - s;
+      v   = a->a + s;
+      sum = t[i];
+      MatSeqAIJDeltaMinusDot_Private(sum,ts,v,off+s,a->j+s,base[i],n);
+      t[i] = sum*idiag[i];
+      /*  x = x + t */
+      x[i] += t[i];
+    }
+
+    ierr = PetscLogFlops(6.0*m-1 + 2.0*a->nz);CHKERRQ(ierr);
+    ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (flag & SOR_ZERO_INITIAL_GUESS) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (i=0; i<m; i++) {
+        s   = a->i[i];
+        n   = diag[i] - s;
+        v   = a->a + s;
+        sum = b[i];
+        MatSeqAIJDeltaMinusDot_Private(sum,x,v,off+s,a->j+s,base[i],n);
+        t[i] = sum;
+        x[i] = sum*idiag[i];
+      }
+      xb   = t;
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (i=m-1; i>=0; i--) {
+        s   = diag[i] + 1;
+        n   = a->i[i+1] - s;
+        v   = a->a + s;
+        sum = xb[i];
+        MatSeqAIJDeltaMinusDot_Private(sum,x,v,off+s,a->j+s,base[i],n);
+        if (xb == b) {
+          x[i] = sum*idiag[i];
+        } else {
+          x[i] = (1-omega)*x[i] + sum*idiag[i];  /* omega in idiag */
+        }
+      }
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+    }
+    its--;
+  }
+  while (its--) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (i=0; i<m; i++) {
+        /* lower */
+        s   = a->i[i];
+        n   = diag[i] - s;
+        v   = a->a + s;
+        sum = b[i];
+        MatSeqAIJDeltaMinusDot_Private(sum,x,v,off+s,a->j+s,base[i],n);
+        t[i] = sum;             /* save application of the lower-triangular part */
+        /* upper */
+        s   = diag[i] + 1;
+        n   = a->i[i+1] - s;
+        v   = a->a + s;
+        MatSeqAIJDeltaMinusDot_Private(sum,x,v,off+s,a->j+s,base[i],n);
+        x[i] = (1. - omega)*x[i] + sum*idiag[i]; /* omega in idiag */
+      }
+      xb   = t;
+      ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (i=m-1; i>=0; i--) {
+        sum = xb[i];
+        if (xb == b) {
+          /* whole matrix (no checkpointing available) */
+          s   = a->i[i];
+          n   = a->i[i+1] - s;
+          v   = a->a + s;
+          MatSeqAIJDeltaMinusDot_Private(sum,x,v,off+s,a->j+s,base[i],n);
+          x[i] = (1. - omega)*x[i] + (sum + mdiag[i]*x[i])*idiag[i];
+        } else { /* lower-triangular part has been saved, so only apply upper-triangular */
+          s   = diag[i] + 1;
+          n   = a->i[i+1] - s;
+          v   = a->a + s;
+          MatSeqAIJDeltaMinusDot_Private(sum,x,v,off+s,a->j+s,base[i],n);
+          x[i] = (1. - omega)*x[i] + sum*idiag[i];  /* omega in idiag */
+        }
+      }
+      if (xb == b) {
+        ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+      } else {
+        ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+      }
+    }
+  }
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* This function prototype is needed in MatConvert_SeqAIJ_SeqAIJDelta(), below. */
+PETSC_INTERN PetscErrorCode MatPtAP_IS_XAIJ(Mat,Mat,MatReuse,PetscReal,Mat*);
+
+/* MatConvert_SeqAIJ_SeqAIJDelta converts a SeqAIJ matrix into a
+ * SeqAIJDelta matrix.  This routine is called by the MatCreate_SeqAIJDelta()
+ * routine, but can also be used to convert an assembled SeqAIJ matrix
+ * into a SeqAIJDelta one. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJDelta(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode  ierr;
+  Mat             B = *newmat;
+  Mat_SeqAIJDelta *aijd;
+  PetscBool       sametype;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+
+  ierr = PetscObjectTypeCompare((PetscObject)A,type,&sametype);CHKERRQ(ierr);
+  if (sametype) PetscFunctionReturn(0);
+
+  ierr     = PetscNewLog(B,&aijd);CHKERRQ(ierr);
+  B->spptr = (void*)aijd;
+  aijd->nonzerostate = -1;
+
+  /* Disable use of the inode routines so that the compressed index ones will be used instead.
+   * This happens in MatAssemblyEnd_SeqAIJDelta as well, but the assembly end may not be called, so set it here, too. */
+  ((Mat_SeqAIJ*)B->data)->inode.use = PETSC_FALSE;
+
+  B->ops->duplicate   = MatDuplicate_SeqAIJDelta;
+  B->ops->assemblyend = MatAssemblyEnd_SeqAIJDelta;
+  B->ops->destroy     = MatDestroy_SeqAIJDelta;
+  B->ops->mult        = MatMult_SeqAIJDelta;
+  B->ops->multadd     = MatMultAdd_SeqAIJDelta;
+  B->ops->sor         = MatSOR_SeqAIJDelta;
+
+  /* If A has already been assembled, compute the compressed indices now */
+  if (A->assembled) {
+    ierr = MatSeqAIJDeltaSetUp_Private(B);CHKERRQ(ierr);
+  }
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijdelta_seqaij_C",MatConvert_SeqAIJDelta_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMult_seqdense_seqaijdelta_C",MatMatMult_SeqDense_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMultSymbolic_seqdense_seqaijdelta_C",MatMatMultSymbolic_SeqDense_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMultNumeric_seqdense_seqaijdelta_C",MatMatMultNumeric_SeqDense_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatPtAP_is_seqaijdelta_C",MatPtAP_IS_XAIJ);CHKERRQ(ierr);
+
+  ierr    = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJDELTA);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatCreateSeqAIJDelta - Creates a sparse matrix of type SEQAIJDELTA.
+   This type inherits from AIJ and is largely identical, but also stores the column indices
+   in compressed form, a base column per row and a 16-bit offset per nonzero, that is used in
+   MatMult(), MatMultAdd() and MatSOR(). For matrices whose rows span less than 65536 columns,
+   as is typical of banded finite element and finite difference matrices, this reduces the
+   index traffic of these kernels by a factor of 4 with 64-bit PetscInt (2 with 32-bit).
+   Rows with a wider span are processed with the full column indices.
+   Because SEQAIJDELTA is a subtype of SEQAIJ, the option "-mat_seqaij_type seqaijdelta" can be used to make
+   sequential AIJ matrices (including the diagonal and off-diagonal blocks of MPIAIJ matrices)
+   default to being instances of MATSEQAIJDELTA.
+
+   Collective
+
+   Input Parameters:
++  comm - MPI communicator, set to PETSC_COMM_SELF
+.  m - number of rows
+.  n - number of columns
+.  nz - number of nonzeros per row (same for all rows)
+-  nnz - array containing the number of nonzeros in the various rows
+         (possibly different for each row) or NULL
+
+   Output Parameter:
+.  A - the matrix
+
+   Notes:
+   If nnz is given then nz is ignored
+
+   The full column indices are kept as well and are used by all other operations, so the matrix uses
+   more memory than a MATSEQAIJ matrix. The compressed indices are recomputed when the nonzero structure
+   changes.
+
+   Level: intermediate
+
+.seealso: MatCreate(), MatCreateMPIAIJDelta(), MatSetValues()
+@*/
+PetscErrorCode  MatCreateSeqAIJDelta(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,const PetscInt nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(*A,MATSEQAIJDELTA);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation_SeqAIJ(*A,nz,nnz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJDelta(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJDelta(A,MATSEQAIJDELTA,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,538 @@
+/*
+  Defines basic operations for the MATSEQAIJOMP matrix class.
+  This class is derived from the MATSEQAIJ class and retains the
+  compressed row storage (aka Yale sparse matrix format) but executes
+  the matrix-vector products with OpenMP threads. The rows are split
+  into one contiguous chunk per thread, the chunks being balanced by the
+  number of nonzeros (not the number of rows) so that each thread streams
+  roughly the same amount of matrix data.
+
+  When the nonzero structure changes, the a, j, and i arrays are
+  reallocated and copied by the threads that will later use them, so that
+  on NUMA machines each chunk of the matrix lives in memory local to the
+  thread that multiplies with it (first-touch placement).
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+extern PetscInt PetscNumOMPThreads;
+#endif
+
+typedef struct {
+  PetscObjectState nonzerostate; /* nonzero state for which the row partition was computed */
+  PetscInt         nthreads;     /* number of threads (and partitions) used in the kernels */
+  PetscInt         *rstart;      /* rows rstart[t] to rstart[t+1]-1 are handled by thread t */
+  PetscInt         *crstart;     /* same as rstart but for the compressed row format */
+  PetscInt         ncrows;       /* number of compressed rows crstart[] has been computed for */
+  PetscBool        firsttouch;   /* reallocate the matrix arrays with the thread that uses them */
+  PetscScalar      *work;        /* (nthreads-1)*nwork thread private buffers for MatMultTranspose() */
+  PetscInt         nwork;
+} Mat_SeqAIJOMP;
+
+/*
+   Splits the rows 0..m-1 of a CSR structure given by ii[] into nparts contiguous
+   chunks such that each chunk has approximately the same number of nonzeros.
+   A single row is never split, rstart[] must have room for nparts+1 entries.
+*/
+static PetscErrorCode MatSeqAIJOMPComputeRowPartition_Private(PetscInt m,const PetscInt *ii,PetscInt nparts,PetscInt *rstart)
+{
+  PetscInt  t,lo,hi,mid;
+  PetscReal nz = (PetscReal)(ii[m]-ii[0]),target;
+
+  PetscFunctionBegin;
+  rstart[0]      = 0;
+  rstart[nparts] = m;
+  for (t=1; t<nparts; t++) {
+    /* find the first row whose start is at or beyond the t-th fraction of the nonzeros */
+    target = ii[0] + nz*t/nparts;
+    lo     = rstart[t-1];
+    hi     = m;
+    while (lo < hi) {
+      mid = lo + (hi-lo)/2;
+      if ((PetscReal)ii[mid] < target) lo = mid+1;
+      else hi = mid;
+    }
+    rstart[t] = lo;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Reallocates the a, j, and i arrays and copies them over in parallel using the same
+   row partition as the multiply kernels, so the pages are placed near the threads that use them.
+*/
+static PetscErrorCode MatSeqAIJOMPFirstTouch_Private(Mat A)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+  PetscInt       m = A->rmap->n,nz = a->i[m],t,nt = aijomp->nthreads,*rstart = aijomp->rstart;
+  PetscInt       *oi = a->i,*oj = a->j,*ni,*nj;
+  MatScalar      *oa = a->a,*na;
+
+  PetscFunctionBegin;
+  /* only touch storage that this matrix owns outright */
+  if (!a->free_a || !a->free_ij || a->parent || A->structure_only || !m) PetscFunctionReturn(0);
+  ierr = PetscMalloc3(nz,&na,nz,&nj,m+1,&ni);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+#endif
+  for (t=0; t<nt; t++) {
+    PetscInt r,k;
+    for (r=rstart[t]; r<rstart[t+1]; r++) ni[r] = oi[r];
+    for (k=oi[rstart[t]]; k<oi[rstart[t+1]]; k++) {
+      nj[k] = oj[k];
+      na[k] = oa[k];
+    }
+  }
+  ni[m] = oi[m];
+  ierr  = MatSeqXAIJFreeAIJ(A,&a->a,&a->j,&a->i);CHKERRQ(ierr);
+  a->a            = na;
+  a->j            = nj;
+  a->i            = ni;
+  a->singlemalloc = PETSC_TRUE;
+  a->free_a       = PETSC_TRUE;
+  a->free_ij      = PETSC_TRUE;
+  a->maxnz        = nz;
+  PetscFunctionReturn(0);
+}
+
+/* Recompute the row partitions if the nonzero structure or compressed row information has changed */
+static PetscErrorCode MatSeqAIJOMPSetUpPartition_Private(Mat A,PetscBool firsttouch)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+  PetscBool      newstructure = (PetscBool)(aijomp->nonzerostate != A->nonzerostate);
+
+  PetscFunctionBegin;
+  if (newstructure || !aijomp->rstart) {
+    if (!aijomp->rstart) {ierr = PetscMalloc2(aijomp->nthreads+1,&aijomp->rstart,aijomp->nthreads+1,&aijomp->crstart);CHKERRQ(ierr);}
+    ierr = MatSeqAIJOMPComputeRowPartition_Private(A->rmap->n,a->i,aijomp->nthreads,aijomp->rstart);CHKERRQ(ierr);
+    if (firsttouch && aijomp->firsttouch) {ierr = MatSeqAIJOMPFirstTouch_Private(A);CHKERRQ(ierr);}
+    aijomp->nonzerostate = A->nonzerostate;
+    aijomp->ncrows       = -1;
+    ierr = PetscInfo2(A,"Using %D threads, largest chunk has %D rows\n",aijomp->nthreads,A->rmap->n ? aijomp->rstart[1]-aijomp->rstart[0] : 0);CHKERRQ(ierr);
+  }
+  if (a->compressedrow.use && aijomp->ncrows != a->compressedrow.nrows) {
+    ierr = MatSeqAIJOMPComputeRowPartition_Private(a->compressedrow.nrows,a->compressedrow.i,aijomp->nthreads,aijomp->crstart);CHKERRQ(ierr);
+    aijomp->ncrows = a->compressedrow.nrows;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqAIJOMPReset_Private(Mat_SeqAIJOMP *aijomp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree2(aijomp->rstart,aijomp->crstart);CHKERRQ(ierr);
+  ierr = PetscFree(aijomp->work);CHKERRQ(ierr);
+  aijomp->nwork  = 0;
+  aijomp->ncrows = -1;
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJOMP_SeqAIJ(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  /* This routine is only called to convert a MATAIJOMP to its base PETSc type, */
+  /* so we will ignore 'MatType type'. */
+  PetscErrorCode ierr;
+  Mat            B = *newmat;
+  Mat_SeqAIJOMP  *aijomp;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  aijomp = (Mat_SeqAIJOMP*)B->spptr;
+
+  /* Reset the original function pointers. */
+  B->ops->duplicate        = MatDuplicate_SeqAIJ;
+  B->ops->assemblyend      = MatAssemblyEnd_SeqAIJ;
+  B->ops->destroy          = MatDestroy_SeqAIJ;
+  B->ops->mult             = MatMult_SeqAIJ;
+  B->ops->multtranspose    = MatMultTranspose_SeqAIJ;
+  B->ops->multadd          = MatMultAdd_SeqAIJ;
+  B->ops->multtransposeadd = MatMultTransposeAdd_SeqAIJ;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijomp_seqaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMult_seqdense_seqaijomp_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMultSymbolic_seqdense_seqaijomp_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMultNumeric_seqdense_seqaijomp_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatPtAP_is_seqaijomp_C",NULL);CHKERRQ(ierr);
+
+  /* Free everything in the Mat_SeqAIJOMP data structure. */
+  ierr = MatSeqAIJOMPReset_Private(aijomp);CHKERRQ(ierr);
+  ierr = PetscFree(B->spptr);CHKERRQ(ierr);
+
+  /* Change the type of B to MATSEQAIJ. */
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
+
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJOMP(Mat A)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+
+  PetscFunctionBegin;
+  /* If MatHeaderMerge() was used then this SeqAIJOMP matrix will not have a spptr. */
+  if (aijomp) {
+    ierr = MatSeqAIJOMPReset_Private(aijomp);CHKERRQ(ierr);
+    ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  }
+  /* Change the type of A back to SEQAIJ and use MatDestroy_SeqAIJ()
+   * to destroy everything that remains. */
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDuplicate_SeqAIJOMP(Mat A,MatDuplicateOption op,Mat *M)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr,*aijomp_dest;
+
+  PetscFunctionBegin;
+  ierr = MatDuplicate_SeqAIJ(A,op,M);CHKERRQ(ierr);
+  aijomp_dest = (Mat_SeqAIJOMP*)(*M)->spptr;
+  ierr = MatSeqAIJOMPReset_Private(aijomp_dest);CHKERRQ(ierr);
+  aijomp_dest->nthreads     = aijomp->nthreads;
+  aijomp_dest->firsttouch   = aijomp->firsttouch;
+  aijomp_dest->nonzerostate = -1;
+  /* the copied arrays were touched by a single thread; redistribute them */
+  ierr = MatSeqAIJOMPSetUpPartition_Private(*M,PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatAssemblyEnd_SeqAIJOMP(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+
+  /* Disable the inode routines so that the threaded multiply kernels are not replaced by the
+   * inode ones in MatAssemblyEnd_SeqAIJ_Inode() */
+  a->inode.use = PETSC_FALSE;
+  ierr = MatAssemblyEnd_SeqAIJ(A,mode);CHKERRQ(ierr);
+  ierr = MatSeqAIJOMPSetUpPartition_Private(A,PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMult_SeqAIJOMP(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP     *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+  PetscScalar       *y;
+  const PetscScalar *x;
+  const PetscInt    *ii,*ridx=NULL,*rstart;
+  PetscInt          m = A->rmap->n,t,nt = aijomp->nthreads;
+  PetscBool         usecprow = a->compressedrow.use;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJOMPSetUpPartition_Private(A,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  if (usecprow) { /* use compressed row format */
+    ierr   = PetscArrayzero(y,m);CHKERRQ(ierr);
+    ii     = a->compressedrow.i;
+    ridx   = a->compressedrow.rindex;
+    rstart = aijomp->crstart;
+  } else {
+    ii     = a->i;
+    rstart = aijomp->rstart;
+  }
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+#endif
+  for (t=0; t<nt; t++) {
+    const PetscInt  *aj;
+    const MatScalar *aa;
+    PetscScalar     sum;
+    PetscInt        i,n;
+
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      n   = ii[i+1] - ii[i];
+      aj  = a->j + ii[i];
+      aa  = a->a + ii[i];
+      sum = 0.0;
+      PetscSparseDensePlusDot(sum,x,aa,aj,n);
+      if (usecprow) y[ridx[i]] = sum;
+      else y[i] = sum;
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqAIJOMP(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP     *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+  PetscScalar       *y,*z;
+  const PetscScalar *x;
+  const PetscInt    *ii,*ridx=NULL,*rstart;
+  PetscInt          m = A->rmap->n,t,nt = aijomp->nthreads;
+  PetscBool         usecprow = a->compressedrow.use;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJOMPSetUpPartition_Private(A,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  if (usecprow) { /* use compressed row format */
+    if (zz != yy) {
+      ierr = PetscArraycpy(z,y,m);CHKERRQ(ierr);
+    }
+    ii     = a->compressedrow.i;
+    ridx   = a->compressedrow.rindex;
+    rstart = aijomp->crstart;
+  } else {
+    ii     = a->i;
+    rstart = aijomp->rstart;
+  }
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+#endif
+  for (t=0; t<nt; t++) {
+    const PetscInt  *aj;
+    const MatScalar *aa;
+    PetscScalar     sum;
+    PetscInt        i,n,r;
+
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      r   = usecprow ? ridx[i] : i;
+      n   = ii[i+1] - ii[i];
+      aj  = a->j + ii[i];
+      aa  = a->a + ii[i];
+      sum = y[r];
+      PetscSparseDensePlusDot(sum,x,aa,aj,n);
+      z[r] = sum;
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Each thread scatters its rows into a private copy of the result (thread 0 directly into y),
+   then the copies are summed into y with the threads splitting the columns.
+*/
+PetscErrorCode MatMultTransposeAdd_SeqAIJOMP(Mat A,Vec xx,Vec zz,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP     *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+  PetscScalar       *y,*work;
+  const PetscScalar *x;
+  const PetscInt    *ii,*ridx=NULL,*rstart;
+  PetscInt          n = A->cmap->n,t,nt = aijomp->nthreads;
+  PetscBool         usecprow = a->compressedrow.use;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJOMPSetUpPartition_Private(A,PETSC_FALSE);CHKERRQ(ierr);
+  if (nt > 1 && aijomp->nwork < n) {
+    ierr = PetscFree(aijomp->work);CHKERRQ(ierr);
+    ierr = PetscMalloc1((nt-1)*n,&aijomp->work);CHKERRQ(ierr);
+    aijomp->nwork = n;
+  }
+  work = aijomp->work;
+  if (zz != yy) {ierr = VecCopy(zz,yy);CHKERRQ(ierr);}
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  if (usecprow) {
+    ii     = a->compressedrow.i;
+    ridx   = a->compressedrow.rindex;
+    rstart = aijomp->crstart;
+  } else {
+    ii     = a->i;
+    rstart = aijomp->rstart;
+  }
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+#endif
+  for (t=0; t<nt; t++) {
+    const PetscInt  *idx;
+    const MatScalar *v;
+    PetscScalar     alpha,*w;
+    PetscInt        i,j,nz;
+
+    if (t) {
+      w = work + (t-1)*n;
+      for (j=0; j<n; j++) w[j] = 0.0;
+    } else w = y;
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      idx   = a->j + ii[i];
+      v     = a->a + ii[i];
+      nz    = ii[i+1] - ii[i];
+      alpha = usecprow ? x[ridx[i]] : x[i];
+      for (j=0; j<nz; j++) w[idx[j]] += alpha*v[j];
+    }
+  }
+  if (nt > 1) {
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+#endif
+    for (t=0; t<nt; t++) {
+      PetscInt j,k,cstart = (n*t)/nt,cend = (n*(t+1))/nt;
+
+      for (k=0; k<nt-1; k++) {
+        const PetscScalar *w = work + k*n;
+        for (j=cstart; j<cend; j++) y[j] += w[j];
+      }
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz + (nt-1)*n);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultTranspose_SeqAIJOMP(Mat A,Vec xx,Vec yy)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecSet(yy,0.0);CHKERRQ(ierr);
+  ierr = MatMultTransposeAdd_SeqAIJOMP(A,xx,yy,yy);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* This function prototype is needed in MatConvert_SeqAIJ_SeqAIJOMP(), below. */
+PETSC_INTERN PetscErrorCode MatPtAP_IS_XAIJ(Mat,Mat,MatReuse,PetscReal,Mat*);
+
+/* MatConvert_SeqAIJ_SeqAIJOMP converts a SeqAIJ matrix into a
+ * SeqAIJOMP matrix.  This routine is called by the MatCreate_SeqAIJOMP()
+ * routine, but can also be used to convert an assembled SeqAIJ matrix
+ * into a SeqAIJOMP one. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJOMP(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode ierr;
+  Mat            B = *newmat;
+  Mat_SeqAIJOMP  *aijomp;
+  PetscBool      sametype;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+
+  ierr = PetscObjectTypeCompare((PetscObject)A,type,&sametype);CHKERRQ(ierr);
+  if (sametype) PetscFunctionReturn(0);
+
+  ierr     = PetscNewLog(B,&aijomp);CHKERRQ(ierr);
+  B->spptr = (void*)aijomp;
+
+  /* Disable use of the inode routines so that the threaded ones will be used instead.
+   * This happens in MatAssemblyEnd_SeqAIJOMP as well, but the assembly end may not be called, so set it here, too. */
+  ((Mat_SeqAIJ*)B->data)->inode.use = PETSC_FALSE;
+
+  B->ops->duplicate        = MatDuplicate_SeqAIJOMP;
+  B->ops->assemblyend      = MatAssemblyEnd_SeqAIJOMP;
+  B->ops->destroy          = MatDestroy_SeqAIJOMP;
+  B->ops->mult             = MatMult_SeqAIJOMP;
+  B->ops->multtranspose    = MatMultTranspose_SeqAIJOMP;
+  B->ops->multadd          = MatMultAdd_SeqAIJOMP;
+  B->ops->multtransposeadd = MatMultTransposeAdd_SeqAIJOMP;
+
+  aijomp->nonzerostate = -1;
+  aijomp->ncrows       = -1;
+  aijomp->firsttouch   = PETSC_TRUE;
+#if defined(PETSC_HAVE_OPENMP)
+  aijomp->nthreads     = PetscMax(PetscNumOMPThreads,1);
+#else
+  aijomp->nthreads     = 1;
+#endif
+
+  /* Parse command line options. */
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)A),((PetscObject)A)->prefix,"AIJOMP Options","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-mat_aijomp_num_threads","Number of threads used by the matrix kernels","None",aijomp->nthreads,&aijomp->nthreads,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-mat_aijomp_first_touch","Place the matrix storage with the threads that use it","None",aijomp->firsttouch,&aijomp->firsttouch,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (aijomp->nthreads < 1) SETERRQ1(PetscObjectComm((PetscObject)A),PETSC_ERR_ARG_OUTOFRANGE,"Number of threads %D must be positive",aijomp->nthreads);
+
+  /* If A has already been assembled, compute the partition now; the storage is redistributed as well */
+  if (A->assembled) {
+    ierr = MatSeqAIJOMPSetUpPartition_Private(B,PETSC_TRUE);CHKERRQ(ierr);
+  }
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijomp_seqaij_C",MatConvert_SeqAIJOMP_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMult_seqdense_seqaijomp_C",MatMatMult_SeqDense_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMultSymbolic_seqdense_seqaijomp_C",MatMatMultSymbolic_SeqDense_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMultNumeric_seqdense_seqaijomp_C",MatMatMultNumeric_SeqDense_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatPtAP_is_seqaijomp_C",MatPtAP_IS_XAIJ);CHKERRQ(ierr);
+
+  ierr    = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJOMP);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatCreateSeqAIJOMP - Creates a sparse matrix of type SEQAIJOMP.
+   This type inherits from AIJ and is largely identical, but performs
+   MatMult(), MatMultAdd(), MatMultTranspose() and MatMultTransposeAdd() with
+   OpenMP threads. The rows are divided between the threads in contiguous chunks
+   with approximately equal numbers of nonzeros, computed once after each assembly
+   that changes the nonzero structure.
+   Because SEQAIJOMP is a subtype of SEQAIJ, the option "-mat_seqaij_type seqaijomp" can be used to make
+   sequential AIJ matrices (including the diagonal and off-diagonal blocks of MPIAIJ matrices)
+   default to being instances of MATSEQAIJOMP.
+
+   Collective
+
+   Input Parameters:
++  comm - MPI communicator, set to PETSC_COMM_SELF
+.  m - number of rows
+.  n - number of columns
+.  nz - number of nonzeros per row (same for all rows)
+-  nnz - array containing the number of nonzeros in the various rows
+         (possibly different for each row) or NULL
+
+   Output Parameter:
+.  A - the matrix
+
+   Options Database Keys:
++  -mat_aijomp_num_threads <n> - number of threads used by the kernels, defaults to the number of OpenMP threads
+-  -mat_aijomp_first_touch <true> - after assembly, reallocate the matrix storage so each chunk is first touched by the thread that uses it
+
+   Notes:
+   If nnz is given then nz is ignored
+
+   Without OpenMP support (configure --with-openmp) the kernels run with a single thread.
+
+   Level: intermediate
+
+.seealso: MatCreate(), MatCreateMPIAIJOMP(), MatSetValues()
+@*/
+PetscErrorCode  MatCreateSeqAIJOMP(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,const PetscInt nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(*A,MATSEQAIJOMP);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation_SeqAIJ(*A,nz,nnz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJOMP(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJOMP(A,MATSEQAIJOMP,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
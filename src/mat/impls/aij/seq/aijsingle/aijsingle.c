@@ -0,0 +1,680 @@
+/*
+  Defines basic operations for the MATSEQAIJSINGLE matrix class.
+  This class is derived from the MATSEQAIJ class and retains the
+  compressed row storage (aka Yale sparse matrix format) but keeps, in
+  addition, a single precision copy of the nonzero values that is used by
+  the bandwidth bound kernels: MatMult(), MatMultAdd() and MatSOR(), and
+  MatSolve() with the LU and ILU factors obtained from MATSOLVERPETSC.
+  The values are converted to PetscScalar as they are loaded, all the
+  arithmetic is done in PetscScalar.
+
+  The double precision values remain the reference: they are used by all
+  other operations (MatSetValues(), MatGetRow(), the factorizations, ...)
+  and the single precision copy is refreshed whenever the object state of
+  the matrix has changed since it was last made.
+
+  The single precision storage is only used in real double precision
+  builds; otherwise the class is identical to MATSEQAIJ.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+
+PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_petsc(Mat,MatFactorType,Mat*);
+
+#if defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+#define MATSEQAIJSINGLE_FLOAT
+typedef float MatScalarSingle;
+#endif
+
+typedef struct {
+#if defined(MATSEQAIJSINGLE_FLOAT)
+  PetscObjectState state;      /* object state of the matrix when the copy was made */
+  PetscInt         nz;         /* allocated length of a */
+  MatScalarSingle  *a;         /* single precision copy of the values of the matrix, or of its factors */
+#endif
+  /* the numeric factorization of the MATSOLVERPETSC factor matrix, wrapped to make the single precision copy */
+  PetscErrorCode   (*lufactorsymbolic)(Mat,Mat,IS,IS,const MatFactorInfo*);
+  PetscErrorCode   (*ilufactorsymbolic)(Mat,Mat,IS,IS,const MatFactorInfo*);
+  PetscErrorCode   (*lufactornumeric)(Mat,Mat,const MatFactorInfo*);
+} Mat_SeqAIJSingle;
+
+#if defined(MATSEQAIJSINGLE_FLOAT)
+/* Copies the first nz values of the matrix (or factor) into the single precision array */
+static PetscErrorCode MatSeqAIJSingleCopyValues_Private(Mat A,PetscInt nz)
+{
+  PetscErrorCode   ierr;
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle *aijs = (Mat_SeqAIJSingle*)A->spptr;
+  PetscInt         k;
+
+  PetscFunctionBegin;
+  if (nz > aijs->nz) {
+    ierr     = PetscFree(aijs->a);CHKERRQ(ierr);
+    ierr     = PetscMalloc1(nz,&aijs->a);CHKERRQ(ierr);
+    aijs->nz = nz;
+  }
+  for (k=0; k<nz; k++) aijs->a[k] = (MatScalarSingle)a->a[k];
+  aijs->state = ((PetscObject)A)->state;
+  PetscFunctionReturn(0);
+}
+
+/* Refreshes the single precision copy of an assembled matrix if the values may have changed */
+PETSC_STATIC_INLINE PetscErrorCode MatSeqAIJSingleUpdate_Private(Mat A)
+{
+  PetscErrorCode   ierr;
+  Mat_SeqAIJSingle *aijs = (Mat_SeqAIJSingle*)A->spptr;
+
+  PetscFunctionBegin;
+  if (aijs->state != ((PetscObject)A)->state || !aijs->a) {
+    ierr = MatSeqAIJSingleCopyValues_Private(A,((Mat_SeqAIJ*)A->data)->i[A->rmap->n]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+#endif
+
+static PetscErrorCode MatSeqAIJSingleReset_Private(Mat_SeqAIJSingle *aijs)
+{
+#if defined(MATSEQAIJSINGLE_FLOAT)
+  PetscErrorCode ierr;
+#endif
+
+  PetscFunctionBegin;
+#if defined(MATSEQAIJSINGLE_FLOAT)
+  ierr       = PetscFree(aijs->a);CHKERRQ(ierr);
+  aijs->nz    = 0;
+  aijs->state = -1;
+#endif
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJSingle_SeqAIJ(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  /* This routine is only called to convert a MATAIJSINGLE to its base PETSc type, */
+  /* so we will ignore 'MatType type'. */
+  PetscErrorCode ierr;
+  Mat            B = *newmat;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+
+  /* Reset the original function pointers. */
+  B->ops->duplicate     = MatDuplicate_SeqAIJ;
+  B->ops->assemblyend   = MatAssemblyEnd_SeqAIJ;
+  B->ops->destroy       = MatDestroy_SeqAIJ;
+  B->ops->mult          = MatMult_SeqAIJ;
+  B->ops->multadd       = MatMultAdd_SeqAIJ;
+  B->ops->sor           = MatSOR_SeqAIJ;
+  B->ops->diagonalscale = MatDiagonalScale_SeqAIJ;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijsingle_seqaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJRestoreArray_C",MatSeqAIJRestoreArray_SeqAIJ);CHKERRQ(ierr);
+
+  /* Free everything in the Mat_SeqAIJSingle data structure. */
+  ierr = MatSeqAIJSingleReset_Private((Mat_SeqAIJSingle*)B->spptr);CHKERRQ(ierr);
+  ierr = PetscFree(B->spptr);CHKERRQ(ierr);
+
+  /* Let the inode routines be used again */
+  ((Mat_SeqAIJ*)B->data)->inode.use = PETSC_TRUE;
+
+  /* Change the type of B to MATSEQAIJ. */
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
+
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDestroy_SeqAIJSingle(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* If MatHeaderMerge() was used then this SeqAIJSingle matrix will not have a spptr. */
+  if (A->spptr) {
+    ierr = MatSeqAIJSingleReset_Private((Mat_SeqAIJSingle*)A->spptr);CHKERRQ(ierr);
+    ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  }
+  /* Change the type of A back to SEQAIJ and use MatDestroy_SeqAIJ()
+   * to destroy everything that remains. */
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDuplicate_SeqAIJSingle(Mat A,MatDuplicateOption op,Mat *M)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatDuplicate_SeqAIJ(A,op,M);CHKERRQ(ierr);
+  /* the single precision copy is not shared, it is made at the first use of the duplicate */
+  ierr = MatSeqAIJSingleReset_Private((Mat_SeqAIJSingle*)(*M)->spptr);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#if defined(MATSEQAIJSINGLE_FLOAT)
+/* The values can be changed through these without a change of the object state, so the copy is marked out of date */
+static PetscErrorCode MatSeqAIJRestoreArray_SeqAIJSingle(Mat A,PetscScalar *array[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJRestoreArray_SeqAIJ(A,array);CHKERRQ(ierr);
+  ((Mat_SeqAIJSingle*)A->spptr)->state = -1;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDiagonalScale_SeqAIJSingle(Mat A,Vec ll,Vec rr)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatDiagonalScale_SeqAIJ(A,ll,rr);CHKERRQ(ierr);
+  ((Mat_SeqAIJSingle*)A->spptr)->state = -1;
+  PetscFunctionReturn(0);
+}
+#endif
+
+static PetscErrorCode MatAssemblyEnd_SeqAIJSingle(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+
+  /* Disable the inode routines so that the single precision kernels are not replaced by the
+   * inode ones in MatAssemblyEnd_SeqAIJ_Inode() */
+  a->inode.use = PETSC_FALSE;
+  ierr = MatAssemblyEnd_SeqAIJ(A,mode);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#if defined(MATSEQAIJSINGLE_FLOAT)
+static PetscErrorCode MatMult_SeqAIJSingle(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle      *aijs = (Mat_SeqAIJSingle*)A->spptr;
+  PetscScalar           *y;
+  const PetscScalar     *x;
+  const MatScalarSingle *aa;
+  PetscErrorCode        ierr;
+  PetscInt              m = A->rmap->n;
+  const PetscInt        *aj,*ii,*ridx = NULL;
+  PetscInt              n,i,k;
+  PetscScalar           sum;
+  PetscBool             usecprow = a->compressedrow.use;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJSingleUpdate_Private(A);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  ii   = a->i;
+  if (usecprow) { /* use compressed row format */
+    ierr = PetscArrayzero(y,m);CHKERRQ(ierr);
+    m    = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  for (i=0; i<m; i++) {
+    n   = ii[i+1] - ii[i];
+    aj  = a->j + ii[i];
+    aa  = aijs->a + ii[i];
+    sum = 0.0;
+    for (k=0; k<n; k++) sum += aa[k]*x[aj[k]];
+    y[usecprow ? ridx[i] : i] = sum;
+  }
+  ierr = PetscLogFlops(2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMultAdd_SeqAIJSingle(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle      *aijs = (Mat_SeqAIJSingle*)A->spptr;
+  PetscScalar           *y,*z;
+  const PetscScalar     *x;
+  const MatScalarSingle *aa;
+  PetscErrorCode        ierr;
+  PetscInt              m = A->rmap->n;
+  const PetscInt        *aj,*ii,*ridx = NULL;
+  PetscInt              n,i,k,r;
+  PetscScalar           sum;
+  PetscBool             usecprow = a->compressedrow.use;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJSingleUpdate_Private(A);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  ii   = a->i;
+  if (usecprow) { /* use compressed row format */
+    if (zz != yy) {
+      ierr = PetscArraycpy(z,y,m);CHKERRQ(ierr);
+    }
+    m    = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  for (i=0; i<m; i++) {
+    r   = usecprow ? ridx[i] : i;
+    n   = ii[i+1] - ii[i];
+    aj  = a->j + ii[i];
+    aa  = aijs->a + ii[i];
+    sum = y[r];
+    for (k=0; k<n; k++) sum += aa[k]*x[aj[k]];
+    z[r] = sum;
+  }
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Sum of aa[k]*x[idx[k]] over the k<n nonzeros of a row, subtracted from sum */
+#define MatSeqAIJSingleMinusDot_Private(sum,x,aa,idx,n) do { \
+    PetscInt __k; \
+    for (__k=0; __k<(n); __k++) (sum) -= (aa)[__k]*(x)[(idx)[__k]]; \
+  } while (0)
+
+/* Same as MatSOR_SeqAIJ() with the off-diagonal values loaded from the single precision copy */
+static PetscErrorCode MatSOR_SeqAIJSingle(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle      *aijs = (Mat_SeqAIJSingle*)A->spptr;
+  PetscScalar           *x,d,sum,*t,scale;
+  const MatScalarSingle *v,*aa;
+  const MatScalar       *idiag=0,*mdiag;
+  const PetscScalar     *b,*bs,*xb,*ts;
+  PetscErrorCode        ierr;
+  PetscInt              n,m = A->rmap->n,i,k;
+  const PetscInt        *idx,*diag;
+
+  PetscFunctionBegin;
+  its = its*lits;
+
+  if (fshift != a->fshift || omega != a->omega) a->idiagvalid = PETSC_FALSE; /* must recompute idiag[] */
+  if (!a->idiagvalid) {ierr = MatInvertDiagonal_SeqAIJ(A,omega,fshift);CHKERRQ(ierr);}
+  a->fshift = fshift;
+  a->omega  = omega;
+  ierr      = MatSeqAIJSingleUpdate_Private(A);CHKERRQ(ierr);
+
+  diag  = a->diag;
+  t     = a->ssor_work;
+  idiag = a->idiag;
+  mdiag = a->mdiag;
+  aa    = aijs->a;
+
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  /* We count flops by assuming the upper triangular and lower triangular parts have the same number of nonzeros */
+  if (flag == SOR_APPLY_UPPER) {
+    /* apply (U + D/omega) to the vector */
+    bs = b;
+    for (i=0; i<m; i++) {
+      d   = fshift + mdiag[i];
+      n   = a->i[i+1] - diag[i] - 1;
+      idx = a->j + diag[i] + 1;
+      v   = aa + diag[i] + 1;
+      sum = b[i]*d/omega;
+      for (k=0; k<n; k++) sum += v[k]*bs[idx[k]];
+      x[i] = sum;
+    }
+    ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+    ierr = PetscLogFlops(a->nz);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  if (flag == SOR_APPLY_LOWER) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"SOR_APPLY_LOWER is not implemented");
+  else if (flag & SOR_EISENSTAT) {
+    /* Eisenstat's trick, see MatSOR_SeqAIJ() */
+    scale = (2.0/omega) - 1.0;
+
+    /*  x = (E + U)^{-1} b */
+    for (i=m-1; i>=0; i--) {
+      n   = a->i[i+1] - diag[i] - 1;
+      idx = a->j + diag[i] + 1;
+      v   = aa + diag[i] + 1;
+      sum = b[i];
+      MatSeqAIJSingleMinusDot_Private(sum,x,v,idx,n);
+      x[i] = sum*idiag[i];
+    }
+
+    /*  t = b - (2*E - D)x */
+    for (i=0; i<m; i++) t[i] = b[i] - scale*mdiag[i]*x[i];
+
+    /*  t = (E + L)^{-1}t */
+    ts = t;
+    for (i=0; i<m; i++) {
+      n   = diag[i] - a->i[i];
+      idx = a->j + a->i[i];
+      v   = aa + a->i[i];
+      sum = t[i];
+      MatSeqAIJSingleMinusDot_Private(sum,ts,v,idx,n);
+      t[i] = sum*idiag[i];
+      /*  x = x + t */
+      x[i] += t[i];
+    }
+
+    ierr = PetscLogFlops(6.0*m-1 + 2.0*a->nz);CHKERRQ(ierr);
+    ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (flag & SOR_ZERO_INITIAL_GUESS) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (i=0; i<m; i++) {
+        n   = diag[i] - a->i[i];
+        idx = a->j + a->i[i];
+        v   = aa + a->i[i];
+        sum = b[i];
+        MatSeqAIJSingleMinusDot_Private(sum,x,v,idx,n);
+        t[i] = sum;
+        x[i] = sum*idiag[i];
+      }
+      xb   = t;
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (i=m-1; i>=0; i--) {
+        n   = a->i[i+1] - diag[i] - 1;
+        idx = a->j + diag[i] + 1;
+        v   = aa + diag[i] + 1;
+        sum = xb[i];
+        MatSeqAIJSingleMinusDot_Private(sum,x,v,idx,n);
+        if (xb == b) {
+          x[i] = sum*idiag[i];
+        } else {
+          x[i] = (1-omega)*x[i] + sum*idiag[i];  /* omega in idiag */
+        }
+      }
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+    }
+    its--;
+  }
+  while (its--) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (i=0; i<m; i++) {
+        /* lower */
+        n   = diag[i] - a->i[i];
+        idx = a->j + a->i[i];
+        v   = aa + a->i[i];
+        sum = b[i];
+        MatSeqAIJSingleMinusDot_Private(sum,x,v,idx,n);
+        t[i] = sum;             /* save application of the lower-triangular part */
+        /* upper */
+        n   = a->i[i+1] - diag[i] - 1;
+        idx = a->j + diag[i] + 1;
+        v   = aa + diag[i] + 1;
+        MatSeqAIJSingleMinusDot_Private(sum,x,v,idx,n);
+        x[i] = (1. - omega)*x[i] + sum*idiag[i]; /* omega in idiag */
+      }
+      xb   = t;
+      ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (i=m-1; i>=0; i--) {
+        sum = xb[i];
+        if (xb == b) {
+          /* whole matrix (no checkpointing available) */
+          n   = a->i[i+1] - a->i[i];
+          idx = a->j + a->i[i];
+          v   = aa + a->i[i];
+          MatSeqAIJSingleMinusDot_Private(sum,x,v,idx,n);
+          x[i] = (1. - omega)*x[i] + (sum + mdiag[i]*x[i])*idiag[i];
+        } else { /* lower-triangular part has been saved, so only apply upper-triangular */
+          n   = a->i[i+1] - diag[i] - 1;
+          idx = a->j + diag[i] + 1;
+          v   = aa + diag[i] + 1;
+          MatSeqAIJSingleMinusDot_Private(sum,x,v,idx,n);
+          x[i] = (1. - omega)*x[i] + sum*idiag[i];  /* omega in idiag */
+        }
+      }
+      if (xb == b) {
+        ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+      } else {
+        ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+      }
+    }
+  }
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Same as MatSolve_SeqAIJ() with the factor values loaded from the single precision copy */
+static PetscErrorCode MatSolve_SeqAIJSingle(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle      *aijs = (Mat_SeqAIJSingle*)A->spptr;
+  IS                    iscol = a->col,isrow = a->row;
+  PetscErrorCode        ierr;
+  PetscInt              i,n = A->rmap->n,*vi,*ai = a->i,*aj = a->j,*adiag = a->diag,nz;
+  const PetscInt        *rout,*cout,*r,*c;
+  PetscScalar           *x,*tmp,sum;
+  const PetscScalar     *b;
+  const MatScalarSingle *aa = aijs->a,*v;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArrayWrite(xx,&x);CHKERRQ(ierr);
+  tmp  = a->solve_work;
+
+  ierr = ISGetIndices(isrow,&rout);CHKERRQ(ierr); r = rout;
+  ierr = ISGetIndices(iscol,&cout);CHKERRQ(ierr); c = cout;
+
+  /* forward solve the lower triangular */
+  tmp[0] = b[r[0]];
+  v      = aa;
+  vi     = aj;
+  for (i=1; i<n; i++) {
+    nz  = ai[i+1] - ai[i];
+    sum = b[r[i]];
+    MatSeqAIJSingleMinusDot_Private(sum,tmp,v,vi,nz);
+    tmp[i] = sum;
+    v     += nz; vi += nz;
+  }
+
+  /* backward solve the upper triangular */
+  for (i=n-1; i>=0; i--) {
+    v   = aa + adiag[i+1]+1;
+    vi  = aj + adiag[i+1]+1;
+    nz  = adiag[i]-adiag[i+1]-1;
+    sum = tmp[i];
+    MatSeqAIJSingleMinusDot_Private(sum,tmp,v,vi,nz);
+    x[c[i]] = tmp[i] = sum*v[nz]; /* v[nz] = aa[adiag[i]] */
+  }
+
+  ierr = ISRestoreIndices(isrow,&rout);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(iscol,&cout);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArrayWrite(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2*a->nz - A->cmap->n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+#endif
+
+static PetscErrorCode MatLUFactorNumeric_SeqAIJSingle(Mat B,Mat A,const MatFactorInfo *info)
+{
+  PetscErrorCode   ierr;
+  Mat_SeqAIJSingle *aijs = (Mat_SeqAIJSingle*)B->spptr;
+
+  PetscFunctionBegin;
+  ierr = (*aijs->lufactornumeric)(B,A,info);CHKERRQ(ierr);
+#if defined(MATSEQAIJSINGLE_FLOAT)
+  /* only the factors stored in the layout of MatSolve_SeqAIJ() (U stored backward from the end) are handled */
+  if (B->ops->solve == MatSolve_SeqAIJ || B->ops->solve == MatSolve_SeqAIJ_NaturalOrdering || B->ops->solve == MatSolve_SeqAIJ_Inode) {
+    Mat_SeqAIJ *b = (Mat_SeqAIJ*)B->data;
+
+    ierr = MatSeqAIJSingleCopyValues_Private(B,B->rmap->n ? b->diag[0]+1 : 0);CHKERRQ(ierr);
+    B->ops->solve = MatSolve_SeqAIJSingle;
+  } else {
+    ierr = PetscInfo(B,"Factor layout not supported, using double precision factors in MatSolve()\n");CHKERRQ(ierr);
+  }
+#endif
+  /* some numeric factorizations install another numeric routine for the next factorization */
+  if (B->ops->lufactornumeric != MatLUFactorNumeric_SeqAIJSingle) {
+    aijs->lufactornumeric   = B->ops->lufactornumeric;
+    B->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJSingle;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatLUFactorSymbolic_SeqAIJSingle(Mat B,Mat A,IS r,IS c,const MatFactorInfo *info)
+{
+  PetscErrorCode   ierr;
+  Mat_SeqAIJSingle *aijs = (Mat_SeqAIJSingle*)B->spptr;
+
+  PetscFunctionBegin;
+  ierr = (*aijs->lufactorsymbolic)(B,A,r,c,info);CHKERRQ(ierr);
+  aijs->lufactornumeric   = B->ops->lufactornumeric;
+  B->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJSingle;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatILUFactorSymbolic_SeqAIJSingle(Mat B,Mat A,IS r,IS c,const MatFactorInfo *info)
+{
+  PetscErrorCode   ierr;
+  Mat_SeqAIJSingle *aijs = (Mat_SeqAIJSingle*)B->spptr;
+
+  PetscFunctionBegin;
+  ierr = (*aijs->ilufactorsymbolic)(B,A,r,c,info);CHKERRQ(ierr);
+  aijs->lufactornumeric   = B->ops->lufactornumeric;
+  B->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJSingle;
+  PetscFunctionReturn(0);
+}
+
+/*
+   The LU and ILU factors of a MATSEQAIJSINGLE matrix are MATSEQAIJ matrices whose numeric factorization
+   makes a single precision copy of the factors that MatSolve() uses. The Cholesky and ICC factors are
+   the ones of MATSEQAIJ.
+*/
+PETSC_INTERN PetscErrorCode MatGetFactor_seqaijsingle_petsc(Mat A,MatFactorType ftype,Mat *B)
+{
+  PetscErrorCode   ierr;
+  Mat_SeqAIJSingle *aijs;
+
+  PetscFunctionBegin;
+  ierr = MatGetFactor_seqaij_petsc(A,ftype,B);CHKERRQ(ierr);
+  if (ftype != MAT_FACTOR_LU && ftype != MAT_FACTOR_ILU) PetscFunctionReturn(0);
+
+  ierr        = PetscNewLog(*B,&aijs);CHKERRQ(ierr);
+  (*B)->spptr = (void*)aijs;
+#if defined(MATSEQAIJSINGLE_FLOAT)
+  aijs->state = -1;
+#endif
+  aijs->lufactorsymbolic       = (*B)->ops->lufactorsymbolic;
+  aijs->ilufactorsymbolic      = (*B)->ops->ilufactorsymbolic;
+  (*B)->ops->lufactorsymbolic  = MatLUFactorSymbolic_SeqAIJSingle;
+  (*B)->ops->ilufactorsymbolic = MatILUFactorSymbolic_SeqAIJSingle;
+  (*B)->ops->destroy           = MatDestroy_SeqAIJSingle;
+  PetscFunctionReturn(0);
+}
+
+/* MatConvert_SeqAIJ_SeqAIJSingle converts a SeqAIJ matrix into a
+ * SeqAIJSingle matrix.  This routine is called by the MatCreate_SeqAIJSingle()
+ * routine, but can also be used to convert an assembled SeqAIJ matrix
+ * into a SeqAIJSingle one. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSingle(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode   ierr;
+  Mat              B = *newmat;
+  Mat_SeqAIJSingle *aijs;
+  PetscBool        sametype;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+
+  ierr = PetscObjectTypeCompare((PetscObject)A,type,&sametype);CHKERRQ(ierr);
+  if (sametype) PetscFunctionReturn(0);
+
+  ierr     = PetscNewLog(B,&aijs);CHKERRQ(ierr);
+  B->spptr = (void*)aijs;
+  ierr     = MatSeqAIJSingleReset_Private(aijs);CHKERRQ(ierr);
+
+  B->ops->duplicate   = MatDuplicate_SeqAIJSingle;
+  B->ops->assemblyend = MatAssemblyEnd_SeqAIJSingle;
+  B->ops->destroy     = MatDestroy_SeqAIJSingle;
+#if defined(MATSEQAIJSINGLE_FLOAT)
+  /* Disable use of the inode routines so that the single precision ones will be used instead.
+   * This happens in MatAssemblyEnd_SeqAIJSingle as well, but the assembly end may not be called, so set it here, too. */
+  ((Mat_SeqAIJ*)B->data)->inode.use = PETSC_FALSE;
+  B->ops->mult          = MatMult_SeqAIJSingle;
+  B->ops->multadd       = MatMultAdd_SeqAIJSingle;
+  B->ops->sor           = MatSOR_SeqAIJSingle;
+  B->ops->diagonalscale = MatDiagonalScale_SeqAIJSingle;
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJRestoreArray_C",MatSeqAIJRestoreArray_SeqAIJSingle);CHKERRQ(ierr);
+#endif
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijsingle_seqaij_C",MatConvert_SeqAIJSingle_SeqAIJ);CHKERRQ(ierr);
+
+  ierr    = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJSINGLE);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatCreateSeqAIJSingle - Creates a sparse matrix of type SEQAIJSINGLE.
+   This type inherits from AIJ and is largely identical, but keeps a single precision
+   copy of the matrix values that is used in MatMult(), MatMultAdd(), MatSOR() and, for the
+   LU and ILU factors from MATSOLVERPETSC, MatSolve(). These operations move about a third
+   fewer bytes, at the price of single precision accuracy of the matrix entries; all the
+   computations are still done in PetscScalar. This is intended for preconditioner matrices.
+   Because SEQAIJSINGLE is a subtype of SEQAIJ, the option "-mat_seqaij_type seqaijsingle" can be used to make
+   sequential AIJ matrices (including the diagonal and off-diagonal blocks of MPIAIJ matrices)
+   default to being instances of MATSEQAIJSINGLE.
+
+   Collective
+
+   Input Parameters:
++  comm - MPI communicator, set to PETSC_COMM_SELF
+.  m - number of rows
+.  n - number of columns
+.  nz - number of nonzeros per row (same for all rows)
+-  nnz - array containing the number of nonzeros in the various rows
+         (possibly different for each row) or NULL
+
+   Output Parameter:
+.  A - the matrix
+
+   Notes:
+   If nnz is given then nz is ignored
+
+   The double precision values are kept as well and are used by all other operations, in particular the
+   factorizations, so the matrix uses more memory than a MATSEQAIJ matrix. The single precision copy is
+   refreshed at the first use after the values of the matrix have changed.
+
+   The single precision copy is only used in real double precision builds, otherwise this is a MATSEQAIJ matrix.
+
+   Level: intermediate
+
+.seealso: MatCreate(), MatCreateMPIAIJSingle(), MatSetValues()
+@*/
+PetscErrorCode  MatCreateSeqAIJSingle(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,const PetscInt nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(*A,MATSEQAIJSINGLE);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation_SeqAIJ(*A,nz,nnz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJSingle(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJSingle(A,MATSEQAIJSINGLE,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
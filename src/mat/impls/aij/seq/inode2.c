@@ -21,6 +21,9 @@ PetscErrorCode MatView_SeqAIJ_Inode(Mat A,PetscViewer viewer)
       } else {
         ierr = PetscViewerASCIIPrintf(viewer,"not using I-node routines\n");CHKERRQ(ierr);
       }
+      if (a->solvelevels && a->solvelevels->use) {
+        ierr = PetscViewerASCIIPrintf(viewer,"using level scheduled triangular solves: %D tasks, %D levels in L, %D levels in U\n",a->solvelevels->ntasks,a->solvelevels->L.nlevels,a->solvelevels->U.nlevels);CHKERRQ(ierr);
+      }
     }
   }
   PetscFunctionReturn(0);
@@ -9,7 +9,10 @@
 #include <petscbt.h>
 #include <petsc/private/isimpl.h>
 #include <../src/mat/impls/dense/seq/dense.h>
-
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+extern PetscInt PetscNumOMPThreads;
+#endif
 
 PETSC_INTERN PetscErrorCode MatMatMult_SeqAIJ_SeqAIJ(Mat A,Mat B,MatReuse scall,PetscReal fill,Mat *C)
 {
@@ -44,17 +47,20 @@ PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ(Mat A,Mat B,PetscReal fill,Mat *
 {
   PetscErrorCode ierr;
 #if !defined(PETSC_HAVE_HYPRE)
-  const char     *algTypes[8] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","combined","rowmerge"};
-  PetscInt       nalg = 8;
-#else
-  const char     *algTypes[9] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","combined","rowmerge","hypre"};
+  const char     *algTypes[9] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","combined","rowmerge","threaded"};
   PetscInt       nalg = 9;
+#else
+  const char     *algTypes[10] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","combined","rowmerge","threaded","hypre"};
+  PetscInt       nalg = 10;
 #endif
   PetscInt       alg = 0; /* set default algorithm */
 
   PetscFunctionBegin;
+#if defined(PETSC_HAVE_OPENMP)
+  if (PetscNumOMPThreads > 1) alg = 8; /* use the threads when there are several */
+#endif
   ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)A),((PetscObject)A)->prefix,"MatMatMult","Mat");CHKERRQ(ierr);
-  ierr = PetscOptionsEList("-matmatmult_via","Algorithmic approach","MatMatMult",algTypes,nalg,algTypes[0],&alg,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEList("-matmatmult_via","Algorithmic approach","MatMatMult",algTypes,nalg,algTypes[alg],&alg,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsEnd();CHKERRQ(ierr);
   switch (alg) {
   case 1:
@@ -78,8 +84,11 @@ PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ(Mat A,Mat B,PetscReal fill,Mat *
   case 7:
     ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ_RowMerge(A,B,fill,C);CHKERRQ(ierr);
     break;
-#if defined(PETSC_HAVE_HYPRE)
   case 8:
+    ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ_Threaded(A,B,fill,C);CHKERRQ(ierr);
+    break;
+#if defined(PETSC_HAVE_HYPRE)
+  case 9:
     ierr = MatMatMultSymbolic_AIJ_AIJ_wHYPRE(A,B,fill,C);CHKERRQ(ierr);
     break;
 #endif
@@ -1013,6 +1022,217 @@ PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_RowMerge(Mat A,Mat B,PetscReal f
   PetscFunctionReturn(0);
 }
 
+/*
+   Splits the rows 0..m-1 into nparts contiguous chunks of about the same work, given the prefix sum w[] of
+   the work of the rows. rstart[] must have room for nparts+1 entries.
+*/
+static PetscErrorCode MatMatMultThreadedPartition_Private(PetscInt m,const PetscInt *w,PetscInt nparts,PetscInt *rstart)
+{
+  PetscInt  t,lo,hi,mid;
+  PetscReal target;
+
+  PetscFunctionBegin;
+  rstart[0]      = 0;
+  rstart[nparts] = m;
+  for (t=1; t<nparts; t++) {
+    target = (PetscReal)w[m]*t/nparts;
+    lo     = rstart[t-1];
+    hi     = m;
+    while (lo < hi) {
+      mid = lo + (hi-lo)/2;
+      if ((PetscReal)w[mid] < target) lo = mid+1;
+      else hi = mid;
+    }
+    rstart[t] = lo;
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Heap sort of the column indices of a row; it does not call PETSc functions so it can be used inside threads */
+PETSC_STATIC_INLINE void MatMatMultThreadedSortRow_Private(PetscInt n,PetscInt *v)
+{
+  PetscInt i,k,c,tmp;
+
+  if (n < 2) return;
+  for (i=n/2-1; i>=0; i--) { /* build a max heap */
+    for (k=i; (c=2*k+1)<n; k=c) {
+      if (c+1<n && v[c+1]>v[c]) c++;
+      if (v[k]>=v[c]) break;
+      tmp = v[k]; v[k] = v[c]; v[c] = tmp;
+    }
+  }
+  for (i=n-1; i>0; i--) { /* move the largest entry to the end */
+    tmp = v[0]; v[0] = v[i]; v[i] = tmp;
+    for (k=0; (c=2*k+1)<i; k=c) {
+      if (c+1<i && v[c+1]>v[c]) c++;
+      if (v[k]>=v[c]) break;
+      tmp = v[k]; v[k] = v[c]; v[c] = tmp;
+    }
+  }
+}
+
+/*
+   Row-wise product with one chunk of rows per thread, balanced by the number of multiply-adds. The symbolic
+   phase makes two passes with a dense marker array per thread: the first counts the nonzeros of each row of C,
+   the second fills the column indices once the row offsets are known. The numeric phase uses a dense
+   accumulator per thread; the partition and the accumulators are kept in C for the later numeric products.
+*/
+PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_Threaded(Mat A,Mat B,PetscReal fill,Mat *C)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data,*b = (Mat_SeqAIJ*)B->data,*c;
+  PetscInt       *ai = a->i,*aj = a->j,*bi = b->i,*bj = b->j,*ci,*cj,*rstart,*mark;
+  PetscInt       am = A->rmap->N,bn = B->cmap->N,bm = B->rmap->N;
+  PetscInt       i,j,t,nt = 1;
+  PetscReal      afill;
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_OPENMP)
+  nt = PetscMax(PetscNumOMPThreads,1);
+#endif
+  nt = PetscMax(PetscMin(nt,am),1);
+
+  /* partition the rows by the number of multiply-adds, accumulated temporarily in ci */
+  ierr  = PetscMalloc1(am+1,&ci);CHKERRQ(ierr);
+  ierr  = PetscMalloc1(nt+1,&rstart);CHKERRQ(ierr);
+  ci[0] = 0;
+  for (i=0; i<am; i++) {
+    ci[i+1] = ci[i];
+    for (j=ai[i]; j<ai[i+1]; j++) ci[i+1] += bi[aj[j]+1] - bi[aj[j]];
+  }
+  ierr = MatMatMultThreadedPartition_Private(am,ci,nt,rstart);CHKERRQ(ierr);
+
+  /* first pass: count the nonzeros of each row of C */
+  ierr = PetscMalloc1(nt*bn,&mark);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1) private(i,j)
+#endif
+  for (t=0; t<nt; t++) {
+    PetscInt *tmark = mark + t*bn,k,col,cnzi;
+
+    for (k=0; k<bn; k++) tmark[k] = -1;
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      cnzi = 0;
+      for (j=ai[i]; j<ai[i+1]; j++) {
+        for (k=bi[aj[j]]; k<bi[aj[j]+1]; k++) {
+          col = bj[k];
+          if (tmark[col] != i) {tmark[col] = i; cnzi++;}
+        }
+      }
+      ci[i+1] = cnzi;
+    }
+  }
+  for (i=0; i<am; i++) ci[i+1] += ci[i];
+
+  /* second pass: fill and sort the column indices of each row of C */
+  ierr = PetscMalloc1(ci[am]+1,&cj);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1) private(i,j)
+#endif
+  for (t=0; t<nt; t++) {
+    PetscInt *tmark = mark + t*bn,*cjj,k,col,cnzi;
+
+    for (k=0; k<bn; k++) tmark[k] = -1;
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      cjj  = cj + ci[i];
+      cnzi = 0;
+      for (j=ai[i]; j<ai[i+1]; j++) {
+        for (k=bi[aj[j]]; k<bi[aj[j]+1]; k++) {
+          col = bj[k];
+          if (tmark[col] != i) {tmark[col] = i; cjj[cnzi++] = col;}
+        }
+      }
+      MatMatMultThreadedSortRow_Private(cnzi,cjj);
+    }
+  }
+  ierr = PetscFree(mark);CHKERRQ(ierr);
+
+  /* put together the new symbolic matrix */
+  ierr = MatCreateSeqAIJWithArrays(PetscObjectComm((PetscObject)A),am,bn,ci,cj,NULL,C);CHKERRQ(ierr);
+  ierr = MatSetBlockSizesFromMats(*C,A,B);CHKERRQ(ierr);
+  ierr = MatSetType(*C,((PetscObject)A)->type_name);CHKERRQ(ierr);
+
+  /* MatCreateSeqAIJWithArrays flags matrix so PETSc doesn't free the user's arrays. */
+  /* These are PETSc arrays, so change flags so arrays can be deleted by PETSc */
+  c                         = (Mat_SeqAIJ*)((*C)->data);
+  c->free_a                 = PETSC_FALSE;
+  c->free_ij                = PETSC_TRUE;
+  c->nonew                  = 0;
+  c->matmult_rstart         = rstart;
+  c->matmult_nthreads       = nt;
+  (*C)->ops->matmultnumeric = MatMatMultNumeric_SeqAIJ_SeqAIJ_Threaded;
+
+  /* set MatInfo */
+  afill = (PetscReal)ci[am]/(ai[am]+bi[bm]) + 1.e-5;
+  if (afill < 1.0) afill = 1.0;
+  c->maxnz                     = ci[am];
+  c->nz                        = ci[am];
+  (*C)->info.mallocs           = 0;
+  (*C)->info.fill_ratio_given  = fill;
+  (*C)->info.fill_ratio_needed = afill;
+
+#if defined(PETSC_USE_INFO)
+  if (ci[am]) {
+    ierr = PetscInfo3((*C),"Threads %D; Fill ratio: given %g needed %g.\n",nt,(double)fill,(double)afill);CHKERRQ(ierr);
+  } else {
+    ierr = PetscInfo((*C),"Empty matrix product\n");CHKERRQ(ierr);
+  }
+#endif
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Threaded(Mat A,Mat B,Mat C)
+{
+  PetscErrorCode ierr;
+  PetscLogDouble flops = 0.0;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data,*b = (Mat_SeqAIJ*)B->data,*c = (Mat_SeqAIJ*)C->data;
+  PetscInt       *ai = a->i,*aj = a->j,*bi = b->i,*bj = b->j,*ci = c->i,*cj = c->j,*rstart = c->matmult_rstart;
+  PetscInt       cm = C->rmap->n,bn = B->cmap->N,nt = c->matmult_nthreads,t;
+  PetscScalar    *aa = a->a,*ba = b->a,*ca,*ab_dense;
+
+  PetscFunctionBegin;
+  if (!c->a) { /* first call of MatMatMultNumeric_SeqAIJ_SeqAIJ, allocate ca and matmult_abdense */
+    ierr      = PetscMalloc1(ci[cm]+1,&ca);CHKERRQ(ierr);
+    c->a      = ca;
+    c->free_a = PETSC_TRUE;
+  } else {
+    ca        = c->a;
+  }
+  if (!c->matmult_abdense) {
+    ierr = PetscCalloc1(nt*bn,&ab_dense);CHKERRQ(ierr);
+    c->matmult_abdense = ab_dense;
+  } else {
+    ab_dense = c->matmult_abdense;
+  }
+
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1) reduction(+:flops)
+#endif
+  for (t=0; t<nt; t++) {
+    PetscScalar *tab = ab_dense + t*bn,valtmp;
+    PetscInt    i,j,k,brow,bnzi;
+
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      /* build the ith row of C in the dense accumulator from the rows of B given by the nonzeros of row i of A */
+      for (j=ai[i]; j<ai[i+1]; j++) {
+        brow   = aj[j];
+        bnzi   = bi[brow+1] - bi[brow];
+        valtmp = aa[j];
+        for (k=0; k<bnzi; k++) tab[bj[bi[brow]+k]] += valtmp*ba[bi[brow]+k];
+        flops += 2*bnzi;
+      }
+      for (k=ci[i]; k<ci[i+1]; k++) {
+        ca[k]      = tab[cj[k]];
+        tab[cj[k]] = 0.0; /* zero the accumulator */
+      }
+    }
+  }
+  ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /* concatenate unique entries and then sort */
 PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_Sorted(Mat A,Mat B,PetscReal fill,Mat *C)
 {
@@ -1447,58 +1667,25 @@ PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqDense(Mat A,Mat B,PetscReal fill,Mat
 
 PetscErrorCode MatMatMultNumericAdd_SeqAIJ_SeqDense(Mat A,Mat B,Mat C)
 {
-  Mat_SeqAIJ        *a=(Mat_SeqAIJ*)A->data;
-  Mat_SeqDense      *bd = (Mat_SeqDense*)B->data;
+  Mat_SeqDense      *bd = (Mat_SeqDense*)B->data,*cd = (Mat_SeqDense*)C->data;
   PetscErrorCode    ierr;
-  PetscScalar       *c,r1,r2,r3,r4,*c1,*c2,*c3,*c4,aatmp;
-  const PetscScalar *aa,*b,*b1,*b2,*b3,*b4,*av;
-  const PetscInt    *aj;
-  PetscInt          cm=C->rmap->n,cn=B->cmap->n,bm=bd->lda,am=A->rmap->n;
-  PetscInt          am4=4*am,bm4=4*bm,col,i,j,n,ajtmp;
+  PetscScalar       *c,**cc;
+  const PetscScalar *b,**bb,*av;
+  PetscInt          cm=C->rmap->n,cn=B->cmap->n,col;
 
   PetscFunctionBegin;
   if (!cm || !cn) PetscFunctionReturn(0);
   ierr = MatSeqAIJGetArrayRead(A,&av);CHKERRQ(ierr);
   ierr = MatDenseGetArray(C,&c);CHKERRQ(ierr);
   ierr = MatDenseGetArrayRead(B,&b);CHKERRQ(ierr);
-  b1 = b; b2 = b1 + bm; b3 = b2 + bm; b4 = b3 + bm;
-  c1 = c; c2 = c1 + am; c3 = c2 + am; c4 = c3 + am;
-  for (col=0; col<cn-4; col += 4) {  /* over columns of C */
-    for (i=0; i<am; i++) {        /* over rows of C in those columns */
-      r1 = r2 = r3 = r4 = 0.0;
-      n  = a->i[i+1] - a->i[i];
-      aj = a->j + a->i[i];
-      aa = av + a->i[i];
-      for (j=0; j<n; j++) {
-        aatmp = aa[j]; ajtmp = aj[j];
-        r1 += aatmp*b1[ajtmp];
-        r2 += aatmp*b2[ajtmp];
-        r3 += aatmp*b3[ajtmp];
-        r4 += aatmp*b4[ajtmp];
-      }
-      c1[i] += r1;
-      c2[i] += r2;
-      c3[i] += r3;
-      c4[i] += r4;
-    }
-    b1 += bm4; b2 += bm4; b3 += bm4; b4 += bm4;
-    c1 += am4; c2 += am4; c3 += am4; c4 += am4;
-  }
-  for (; col<cn; col++) {   /* over extra columns of C */
-    for (i=0; i<am; i++) {  /* over rows of C in those columns */
-      r1 = 0.0;
-      n  = a->i[i+1] - a->i[i];
-      aj = a->j + a->i[i];
-      aa = av + a->i[i];
-      for (j=0; j<n; j++) {
-        r1 += aa[j]*b1[aj[j]];
-      }
-      c1[i] += r1;
-    }
-    b1 += bm;
-    c1 += am;
+  /* the columns of B and C are handed to the register blocked kernels that read each row of A once for up to 8 columns */
+  ierr = PetscMalloc2(cn,&bb,cn,&cc);CHKERRQ(ierr);
+  for (col=0; col<cn; col++) {
+    bb[col] = b + col*bd->lda;
+    cc[col] = c + col*cd->lda;
   }
-  ierr = PetscLogFlops(cn*(2.0*a->nz));CHKERRQ(ierr);
+  ierr = MatSeqAIJMultColumns_Private(A,av,cn,bb,cc,ADD_VALUES);CHKERRQ(ierr);
+  ierr = PetscFree2(bb,cc);CHKERRQ(ierr);
   ierr = MatDenseRestoreArray(C,&c);CHKERRQ(ierr);
   ierr = MatDenseRestoreArrayRead(B,&b);CHKERRQ(ierr);
   ierr = MatSeqAIJRestoreArrayRead(A,&av);CHKERRQ(ierr);
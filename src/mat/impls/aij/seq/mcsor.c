@@ -0,0 +1,155 @@
+/*
+  Defines multicolor relaxation (SOR, Gauss-Seidel) sweeps for SeqAIJ matrices; the rows are reordered into
+  independent sets by a MatColoring and the rows of each color are relaxed concurrently
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h> /*I "petscmat.h" I*/
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+extern PetscInt PetscNumOMPThreads;
+#endif
+
+PetscErrorCode MatSORSetMulticolor_SeqAIJ(Mat A,PetscBool flg)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ*)A->data;
+
+  PetscFunctionBegin;
+  a->sor_multicolor = flg;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSORGetMulticolor_SeqAIJ(Mat A,PetscBool *flg)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ*)A->data;
+
+  PetscFunctionBegin;
+  *flg = a->sor_multicolor;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Computes the color sets with a distance one coloring of the graph of A + A^T; rows i and j get different
+   colors whenever a_ij or a_ji is nonzero, so the update of a row never reads a value of its own color
+*/
+static PetscErrorCode MatSORMulticolorSetUp_SeqAIJ(Mat A)
+{
+  Mat_SeqAIJ      *a = (Mat_SeqAIJ*)A->data;
+  Mat             G,At;
+  MatColoring     mc;
+  ISColoring      iscoloring;
+  IS              *is;
+  const PetscInt  *rows;
+  PetscInt        c,k,n,cnt = 0,m = A->rmap->n;
+  const char      *prefix;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  if (a->sor_colorrows && a->sor_nonzerostate == A->nonzerostate) PetscFunctionReturn(0);
+  ierr = PetscFree2(a->sor_colorptr,a->sor_colorrows);CHKERRQ(ierr);
+
+  if (A->structurally_symmetric) {
+    ierr = PetscObjectReference((PetscObject)A);CHKERRQ(ierr);
+    G    = A;
+  } else {
+    ierr = MatTranspose(A,MAT_INITIAL_MATRIX,&At);CHKERRQ(ierr);
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&G);CHKERRQ(ierr);
+    ierr = MatAXPY(G,1.0,At,DIFFERENT_NONZERO_PATTERN);CHKERRQ(ierr);
+    ierr = MatDestroy(&At);CHKERRQ(ierr);
+  }
+
+  ierr = MatColoringCreate(G,&mc);CHKERRQ(ierr);
+  ierr = PetscObjectGetOptionsPrefix((PetscObject)A,&prefix);CHKERRQ(ierr);
+  ierr = PetscObjectSetOptionsPrefix((PetscObject)mc,prefix);CHKERRQ(ierr);
+  ierr = PetscObjectAppendOptionsPrefix((PetscObject)mc,"sor_");CHKERRQ(ierr);
+  ierr = MatColoringSetDistance(mc,1);CHKERRQ(ierr);
+  ierr = MatColoringSetType(mc,MATCOLORINGGREEDY);CHKERRQ(ierr);
+  ierr = MatColoringSetFromOptions(mc);CHKERRQ(ierr);
+  ierr = MatColoringApply(mc,&iscoloring);CHKERRQ(ierr);
+  ierr = MatColoringDestroy(&mc);CHKERRQ(ierr);
+  ierr = MatDestroy(&G);CHKERRQ(ierr);
+
+  ierr = ISColoringGetIS(iscoloring,PETSC_USE_POINTER,&a->sor_ncolors,&is);CHKERRQ(ierr);
+  ierr = PetscMalloc2(a->sor_ncolors+1,&a->sor_colorptr,m,&a->sor_colorrows);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)A,(a->sor_ncolors+1+m)*sizeof(PetscInt));CHKERRQ(ierr);
+  a->sor_colorptr[0] = 0;
+  for (c=0; c<a->sor_ncolors; c++) {
+    ierr = ISGetLocalSize(is[c],&n);CHKERRQ(ierr);
+    ierr = ISGetIndices(is[c],&rows);CHKERRQ(ierr);
+    for (k=0; k<n; k++) a->sor_colorrows[cnt++] = rows[k];
+    ierr = ISRestoreIndices(is[c],&rows);CHKERRQ(ierr);
+    a->sor_colorptr[c+1] = cnt;
+  }
+  ierr = ISColoringRestoreIS(iscoloring,PETSC_USE_POINTER,&is);CHKERRQ(ierr);
+  ierr = ISColoringDestroy(&iscoloring);CHKERRQ(ierr);
+  if (cnt != m) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Coloring covers %D of the %D rows",cnt,m);
+  ierr = PetscInfo2(A,"Multicolor relaxation uses %D colors for %D rows\n",a->sor_ncolors,m);CHKERRQ(ierr);
+  a->sor_nonzerostate = A->nonzerostate;
+  PetscFunctionReturn(0);
+}
+
+/*
+   x_i = (1 - omega) x_i + omega (b_i - sum_{j != i} a_ij x_j)/(a_ii + shift) for the rows of color c;
+   idiag[] holds omega/(a_ii + shift) and mdiag[] holds a_ii, so the whole row can be used in the product
+*/
+static void MatSORMulticolorSweep_Private(Mat A,PetscInt c,PetscReal omega,const PetscScalar *b,PetscScalar *x,PetscInt nt)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  const PetscInt    *rows = a->sor_colorrows,*ai = a->i,*aj = a->j;
+  const PetscScalar *idiag = a->idiag,*mdiag = a->mdiag;
+  const MatScalar   *aa = a->a;
+  PetscInt          k,start = a->sor_colorptr[c],end = a->sor_colorptr[c+1];
+
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static) if(nt > 1 && end - start > 64)
+#endif
+  for (k=start; k<end; k++) {
+    const PetscInt  row = rows[k],n = ai[row+1] - ai[row],*idx = aj + ai[row];
+    const MatScalar *v  = aa + ai[row];
+    PetscScalar     sum = b[row];
+
+    PetscSparseDenseMinusDot(sum,x,v,idx,n);
+    x[row] = (1. - omega)*x[row] + (sum + mdiag[row]*x[row])*idiag[row]; /* omega in idiag */
+  }
+}
+
+/*
+   The multicolor counterpart of MatSOR_SeqAIJ(), used when MatSORSetMulticolor() has been called
+*/
+PetscErrorCode MatSOR_SeqAIJ_Multicolor(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  PetscScalar       *x;
+  const PetscScalar *b;
+  PetscInt          c,nt = 1;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  its = its*lits;
+
+  if (fshift != a->fshift || omega != a->omega) a->idiagvalid = PETSC_FALSE; /* must recompute idiag[] */
+  if (!a->idiagvalid) {ierr = MatInvertDiagonal_SeqAIJ(A,omega,fshift);CHKERRQ(ierr);}
+  a->fshift = fshift;
+  a->omega  = omega;
+  ierr = MatSORMulticolorSetUp_SeqAIJ(A);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_OPENMP)
+  nt = PetscMax(PetscNumOMPThreads,1);
+#endif
+
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  /* with a zero initial guess the first sweep produces the same iterate as the natural ordering code, which skips the products with zero */
+  if (flag & SOR_ZERO_INITIAL_GUESS) {ierr = VecSet(xx,0.0);CHKERRQ(ierr);}
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  while (its--) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (c=0; c<a->sor_ncolors; c++) MatSORMulticolorSweep_Private(A,c,omega,b,x,nt);
+      ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+    }
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (c=a->sor_ncolors-1; c>=0; c--) MatSORMulticolorSweep_Private(A,c,omega,b,x,nt);
+      ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+    }
+  }
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
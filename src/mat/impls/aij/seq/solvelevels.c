@@ -0,0 +1,305 @@
+/*
+  Defines a threaded MatSolve() for LU and ILU factors of SeqAIJ matrices; the rows (or the inodes) of the
+  triangular factors are grouped in levels of independent tasks when the matrix is factored
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h> /*I "petscmat.h" I*/
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+extern PetscInt PetscNumOMPThreads;
+#endif
+#if defined(PETSC_HAVE_SCHED_CPU_SET_T)
+#include <sched.h>
+#endif
+
+/* a thread waiting for another one gives up its core after a short spin, so oversubscribed cores still make progress */
+#define MAT_SOLVE_LEVELS_SPIN 1000
+PETSC_STATIC_INLINE void MatSolveLevelsYield_Private(void)
+{
+#if defined(PETSC_HAVE_SCHED_CPU_SET_T)
+  sched_yield();
+#endif
+}
+
+PetscErrorCode MatSeqAIJSolveLevelsDestroy(Mat A)
+{
+  Mat_SeqAIJ             *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_SolveLevels *ls = a->solvelevels;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  if (!ls) PetscFunctionReturn(0);
+  ierr = PetscFree3(ls->L.thrptr,ls->L.thrtasks,ls->L.depptr);CHKERRQ(ierr);
+  ierr = PetscFree(ls->L.deps);CHKERRQ(ierr);
+  ierr = PetscFree3(ls->U.thrptr,ls->U.thrtasks,ls->U.depptr);CHKERRQ(ierr);
+  ierr = PetscFree(ls->U.deps);CHKERRQ(ierr);
+  ierr = PetscFree2(ls->tstart,ls->done);CHKERRQ(ierr);
+  ierr = PetscFree(a->solvelevels);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* the columns of row i of L (upper false) or of the strictly upper part of row i of U (upper true) */
+PETSC_STATIC_INLINE void MatSeqAIJSolveLevelsGetRow_Private(const Mat_SeqAIJ *a,PetscBool upper,PetscInt i,const PetscInt **cols,PetscInt *nz)
+{
+  if (upper) {
+    *cols = a->j + a->diag[i+1] + 1;
+    *nz   = a->diag[i] - a->diag[i+1] - 1;
+  } else {
+    *cols = a->j + a->i[i];
+    *nz   = a->i[i+1] - a->i[i];
+  }
+}
+
+/*
+   Builds the schedule of the sweep with L (upper false) or with U (upper true): the level of a task is one more than the
+   highest level of the tasks it reads from; each level is split in nthreads contiguous chunks and a task only waits, for
+   every other thread, for the last task of that thread it reads from, since the tasks of a thread are finished in order
+*/
+static PetscErrorCode MatSeqAIJSolveScheduleCreate_Private(Mat A,const PetscInt *rowtask,PetscBool upper,Mat_SeqAIJ_SolveSchedule *s)
+{
+  Mat_SeqAIJ             *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_SolveLevels *ls = a->solvelevels;
+  PetscInt               ntasks = ls->ntasks,nt = ls->nthreads,*tstart = ls->tstart;
+  PetscInt               *level,*owner,*pos,*levptr,*order,*lastpos,*touched;
+  PetscInt               i,j,k,kk,l,t,d,q,nz,cnt,ntouched,pass;
+  const PetscInt         *cols;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc6(ntasks,&level,ntasks,&owner,ntasks,&pos,ntasks,&order,nt,&lastpos,nt,&touched);CHKERRQ(ierr);
+
+  /* a task only reads from the tasks visited before it in the sweep */
+  s->nlevels = 0;
+  for (kk=0; kk<ntasks; kk++) {
+    k = upper ? ntasks-1-kk : kk;
+    l = 0;
+    for (i=tstart[k]; i<tstart[k+1]; i++) {
+      MatSeqAIJSolveLevelsGetRow_Private(a,upper,i,&cols,&nz);
+      for (j=0; j<nz; j++) {
+        d = rowtask[cols[j]];
+        if (d != k) l = PetscMax(l,level[d]+1);
+      }
+    }
+    level[k]   = l;
+    s->nlevels = PetscMax(s->nlevels,l+1);
+  }
+
+  /* order the tasks by level, keeping the order of the sweep inside a level */
+  ierr = PetscCalloc1(s->nlevels+1,&levptr);CHKERRQ(ierr);
+  for (k=0; k<ntasks; k++) levptr[level[k]+1]++;
+  for (l=0; l<s->nlevels; l++) levptr[l+1] += levptr[l];
+  for (kk=0; kk<ntasks; kk++) {
+    k = upper ? ntasks-1-kk : kk;
+    order[levptr[level[k]]++] = k;
+  }
+  for (l=s->nlevels; l>0; l--) levptr[l] = levptr[l-1];
+  levptr[0] = 0;
+
+  /* thread t does the t-th chunk of every level */
+  ierr = PetscMalloc3(nt+1,&s->thrptr,ntasks,&s->thrtasks,ntasks+1,&s->depptr);CHKERRQ(ierr);
+  ierr = PetscArrayzero(s->thrptr,nt+1);CHKERRQ(ierr);
+  for (l=0; l<s->nlevels; l++) {
+    cnt = levptr[l+1] - levptr[l];
+    for (t=0; t<nt; t++) s->thrptr[t+1] += (cnt*(t+1))/nt - (cnt*t)/nt;
+  }
+  for (t=0; t<nt; t++) s->thrptr[t+1] += s->thrptr[t];
+  for (t=0; t<nt; t++) {
+    cnt = 0;
+    for (l=0; l<s->nlevels; l++) {
+      PetscInt lcnt = levptr[l+1] - levptr[l];
+
+      for (kk=levptr[l]+(lcnt*t)/nt; kk<levptr[l]+(lcnt*(t+1))/nt; kk++) {
+        k        = order[kk];
+        owner[k] = t;
+        pos[k]   = cnt;
+        s->thrtasks[s->thrptr[t]+cnt++] = k;
+      }
+    }
+  }
+
+  /* the tasks of the other threads to wait for; the first pass counts them and the second one stores them */
+  for (t=0; t<nt; t++) lastpos[t] = -1;
+  for (pass=0; pass<2; pass++) {
+    s->depptr[0] = 0;
+    for (k=0; k<ntasks; k++) {
+      ntouched = 0;
+      for (i=tstart[k]; i<tstart[k+1]; i++) {
+        MatSeqAIJSolveLevelsGetRow_Private(a,upper,i,&cols,&nz);
+        for (j=0; j<nz; j++) {
+          d = rowtask[cols[j]];
+          t = owner[d];
+          if (d == k || t == owner[k]) continue;
+          if (lastpos[t] < 0) touched[ntouched++] = t;
+          lastpos[t] = PetscMax(lastpos[t],pos[d]);
+        }
+      }
+      for (q=0; q<ntouched; q++) {
+        t = touched[q];
+        if (pass) s->deps[s->depptr[k]+q] = s->thrtasks[s->thrptr[t]+lastpos[t]];
+        lastpos[t] = -1;
+      }
+      if (!pass) s->depptr[k+1] = s->depptr[k] + ntouched;
+    }
+    if (!pass) {ierr = PetscMalloc1(s->depptr[ntasks]+1,&s->deps);CHKERRQ(ierr);}
+  }
+  ierr = PetscFree(levptr);CHKERRQ(ierr);
+  ierr = PetscFree6(level,owner,pos,order,lastpos,touched);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   MatSeqAIJSolveLevelsSetUp - Called at the end of the numeric LU and ILU factorizations; when the threaded
+   solves are requested with -mat_solve_levels, it computes the level schedules of L and U and installs
+   MatSolve_SeqAIJ_Levels(). The tasks are the inodes of the factor if it has any, otherwise the rows.
+   Without the option the schedule is used with several OpenMP threads if the levels have on average
+   at least four tasks per thread.
+
+   The schedule only depends on the nonzero structure of the factor, so it is kept until the next symbolic
+   factorization, which destroys it, and later numeric factorizations only reinstall the solve.
+*/
+PetscErrorCode MatSeqAIJSolveLevelsSetUp(Mat C)
+{
+  Mat_SeqAIJ             *b = (Mat_SeqAIJ*)C->data;
+  Mat_SeqAIJ_SolveLevels *ls;
+  PetscInt               i,k,n = C->rmap->n,nt = 1,*rowtask;
+  PetscBool              flg,set;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_OPENMP)
+  nt = PetscMax(PetscNumOMPThreads,1);
+#endif
+  flg  = (PetscBool)(nt > 1);
+  ierr = PetscOptionsGetBool(((PetscObject)C)->options,((PetscObject)C)->prefix,"-mat_solve_levels",&flg,&set);CHKERRQ(ierr);
+  if (b->solvelevels && (!flg || b->solvelevels->nthreads != nt)) {ierr = MatSeqAIJSolveLevelsDestroy(C);CHKERRQ(ierr);}
+  if (!flg || !n) PetscFunctionReturn(0);
+
+  ls = b->solvelevels;
+  if (!ls) {
+    ierr = PetscNewLog(C,&ls);CHKERRQ(ierr);
+    b->solvelevels = ls;
+    ls->nthreads   = nt;
+    ls->ntasks     = b->inode.size ? b->inode.node_count : n;
+    ierr = PetscMalloc2(ls->ntasks+1,&ls->tstart,ls->ntasks,&ls->done);CHKERRQ(ierr);
+    ierr = PetscArrayzero(ls->done,ls->ntasks);CHKERRQ(ierr);
+    ierr = PetscMalloc1(n,&rowtask);CHKERRQ(ierr);
+    ls->tstart[0] = 0;
+    for (k=0; k<ls->ntasks; k++) {
+      ls->tstart[k+1] = ls->tstart[k] + (b->inode.size ? b->inode.size[k] : 1);
+      for (i=ls->tstart[k]; i<ls->tstart[k+1]; i++) rowtask[i] = k;
+    }
+    if (ls->tstart[ls->ntasks] != n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Inodes cover %D of the %D rows",ls->tstart[ls->ntasks],n);
+
+    ierr = MatSeqAIJSolveScheduleCreate_Private(C,rowtask,PETSC_FALSE,&ls->L);CHKERRQ(ierr);
+    ierr = MatSeqAIJSolveScheduleCreate_Private(C,rowtask,PETSC_TRUE,&ls->U);CHKERRQ(ierr);
+    ierr = PetscFree(rowtask);CHKERRQ(ierr);
+    ierr = PetscInfo5(C,"Level schedule for %D threads: %D tasks, %D levels in L and %D levels in U, %D waits\n",nt,ls->ntasks,ls->L.nlevels,ls->U.nlevels,ls->L.depptr[ls->ntasks]+ls->U.depptr[ls->ntasks]);CHKERRQ(ierr);
+  }
+
+  /* by default the threads are only used when the levels have several tasks for each thread */
+  ls->use = (PetscBool)(set || ls->ntasks >= 4*nt*PetscMax(ls->L.nlevels,ls->U.nlevels));
+  if (ls->use) C->ops->solve = MatSolve_SeqAIJ_Levels;
+  else {ierr = PetscInfo3(C,"Not using threaded triangular solves: %D tasks in %D levels for %D threads\n",ls->ntasks,PetscMax(ls->L.nlevels,ls->U.nlevels),nt);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+PETSC_STATIC_INLINE void MatSolveLevelsForwardRow_Private(const Mat_SeqAIJ *a,PetscInt i,const PetscInt *r,const PetscScalar *b,PetscScalar *tmp)
+{
+  const PetscInt  nz = a->i[i+1] - a->i[i],*vi = a->j + a->i[i];
+  const MatScalar *v = a->a + a->i[i];
+  PetscScalar     sum = b[r[i]];
+
+  PetscSparseDenseMinusDot(sum,tmp,v,vi,nz);
+  tmp[i] = sum;
+}
+
+PETSC_STATIC_INLINE void MatSolveLevelsBackwardRow_Private(const Mat_SeqAIJ *a,PetscInt i,const PetscInt *c,PetscScalar *tmp,PetscScalar *x)
+{
+  const PetscInt  nz = a->diag[i] - a->diag[i+1] - 1,*vi = a->j + a->diag[i+1] + 1;
+  const MatScalar *v = a->a + a->diag[i+1] + 1;
+  PetscScalar     sum = tmp[i];
+
+  PetscSparseDenseMinusDot(sum,tmp,v,vi,nz);
+  x[c[i]] = tmp[i] = sum*a->a[a->diag[i]];
+}
+
+/* the work of one thread in a sweep; it must not call PETSc functions since it runs inside a parallel region */
+static void MatSolveLevelsSweep_Private(const Mat_SeqAIJ *a,Mat_SeqAIJ_SolveLevels *ls,const Mat_SeqAIJ_SolveSchedule *s,PetscBool upper,PetscInt stamp,const PetscInt *r,const PetscInt *c,const PetscScalar *b,PetscScalar *tmp,PetscScalar *x)
+{
+  PetscInt t = 0,nthr = 1,p,q,k,d,i,v,spin;
+
+#if defined(PETSC_HAVE_OPENMP)
+  t    = omp_get_thread_num();
+  nthr = omp_get_num_threads();
+#endif
+  if (nthr != ls->nthreads) {
+    /* the schedule was made for another number of threads; the first thread does all the work in the order of the sweep */
+    if (t) return;
+    if (upper) for (i=ls->tstart[ls->ntasks]-1; i>=0; i--) MatSolveLevelsBackwardRow_Private(a,i,c,tmp,x);
+    else for (i=0; i<ls->tstart[ls->ntasks]; i++) MatSolveLevelsForwardRow_Private(a,i,r,b,tmp);
+    return;
+  }
+  for (p=s->thrptr[t]; p<s->thrptr[t+1]; p++) {
+    k = s->thrtasks[p];
+    for (q=s->depptr[k]; q<s->depptr[k+1]; q++) {
+      d    = s->deps[q];
+      spin = 0;
+      do {
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp atomic read
+#endif
+        v = ls->done[d];
+        if (v != stamp && ++spin > MAT_SOLVE_LEVELS_SPIN) MatSolveLevelsYield_Private();
+      } while (v != stamp);
+    }
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp flush
+#endif
+    if (upper) for (i=ls->tstart[k+1]-1; i>=ls->tstart[k]; i--) MatSolveLevelsBackwardRow_Private(a,i,c,tmp,x);
+    else for (i=ls->tstart[k]; i<ls->tstart[k+1]; i++) MatSolveLevelsForwardRow_Private(a,i,r,b,tmp);
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp flush
+#pragma omp atomic write
+#endif
+    ls->done[k] = stamp;
+  }
+}
+
+PetscErrorCode MatSolve_SeqAIJ_Levels(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqAIJ             *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_SolveLevels *ls = a->solvelevels;
+  PetscInt               stamp;
+  const PetscInt         *r,*c;
+  PetscScalar            *x,*tmp = a->solve_work;
+  const PetscScalar      *b;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  if (!A->rmap->n) PetscFunctionReturn(0);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArrayWrite(xx,&x);CHKERRQ(ierr);
+  ierr = ISGetIndices(a->row,&r);CHKERRQ(ierr);
+  ierr = ISGetIndices(a->col,&c);CHKERRQ(ierr);
+
+  /* forward solve the lower triangular */
+  stamp = ++ls->stamp;
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel num_threads(ls->nthreads)
+#endif
+  MatSolveLevelsSweep_Private(a,ls,&ls->L,PETSC_FALSE,stamp,r,c,b,tmp,x);
+
+  /* backward solve the upper triangular */
+  stamp = ++ls->stamp;
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel num_threads(ls->nthreads)
+#endif
+  MatSolveLevelsSweep_Private(a,ls,&ls->U,PETSC_TRUE,stamp,r,c,b,tmp,x);
+
+  ierr = ISRestoreIndices(a->row,&r);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(a->col,&c);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArrayWrite(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2*a->nz - A->cmap->n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
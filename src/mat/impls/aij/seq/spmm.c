@@ -0,0 +1,163 @@
+/*
+  Defines the product of a SeqAIJ matrix with several vectors (the columns of a dense matrix or a set of Vecs)
+  at once. Each row of the matrix is loaded once for up to eight right hand sides whose partial sums are kept
+  in registers, so the cost of streaming the matrix is shared by all the columns.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h> /*I "petscmat.h" I*/
+
+/*
+   The kernels compute c_l[row] (+)= sum_j a_{row,j} b_l[j] for the rows ridx[i] (or i when ridx is NULL),
+   i = 0,...,m-1, where ai[] are the row offsets of the (possibly compressed) rows
+*/
+static void MatSeqAIJMultColumns8_Private(PetscInt m,const PetscInt *ai,const PetscInt *ridx,const PetscInt *aj,const PetscScalar *aa,const PetscScalar *const *b,PetscScalar *const *c,InsertMode imode)
+{
+  const PetscScalar *b0 = b[0],*b1 = b[1],*b2 = b[2],*b3 = b[3],*b4 = b[4],*b5 = b[5],*b6 = b[6],*b7 = b[7];
+  PetscScalar       *c0 = c[0],*c1 = c[1],*c2 = c[2],*c3 = c[3],*c4 = c[4],*c5 = c[5],*c6 = c[6],*c7 = c[7];
+  PetscScalar       r0,r1,r2,r3,r4,r5,r6,r7,v;
+  PetscInt          i,j,col,row;
+
+  for (i=0; i<m; i++) {
+    row = ridx ? ridx[i] : i;
+    r0  = r1 = r2 = r3 = r4 = r5 = r6 = r7 = 0.0;
+    for (j=ai[i]; j<ai[i+1]; j++) {
+      v = aa[j]; col = aj[j];
+      r0 += v*b0[col]; r1 += v*b1[col]; r2 += v*b2[col]; r3 += v*b3[col];
+      r4 += v*b4[col]; r5 += v*b5[col]; r6 += v*b6[col]; r7 += v*b7[col];
+    }
+    if (imode == ADD_VALUES) {
+      c0[row] += r0; c1[row] += r1; c2[row] += r2; c3[row] += r3;
+      c4[row] += r4; c5[row] += r5; c6[row] += r6; c7[row] += r7;
+    } else {
+      c0[row] = r0; c1[row] = r1; c2[row] = r2; c3[row] = r3;
+      c4[row] = r4; c5[row] = r5; c6[row] = r6; c7[row] = r7;
+    }
+  }
+}
+
+static void MatSeqAIJMultColumns4_Private(PetscInt m,const PetscInt *ai,const PetscInt *ridx,const PetscInt *aj,const PetscScalar *aa,const PetscScalar *const *b,PetscScalar *const *c,InsertMode imode)
+{
+  const PetscScalar *b0 = b[0],*b1 = b[1],*b2 = b[2],*b3 = b[3];
+  PetscScalar       *c0 = c[0],*c1 = c[1],*c2 = c[2],*c3 = c[3];
+  PetscScalar       r0,r1,r2,r3,v;
+  PetscInt          i,j,col,row;
+
+  for (i=0; i<m; i++) {
+    row = ridx ? ridx[i] : i;
+    r0  = r1 = r2 = r3 = 0.0;
+    for (j=ai[i]; j<ai[i+1]; j++) {
+      v = aa[j]; col = aj[j];
+      r0 += v*b0[col]; r1 += v*b1[col]; r2 += v*b2[col]; r3 += v*b3[col];
+    }
+    if (imode == ADD_VALUES) {
+      c0[row] += r0; c1[row] += r1; c2[row] += r2; c3[row] += r3;
+    } else {
+      c0[row] = r0; c1[row] = r1; c2[row] = r2; c3[row] = r3;
+    }
+  }
+}
+
+static void MatSeqAIJMultColumns2_Private(PetscInt m,const PetscInt *ai,const PetscInt *ridx,const PetscInt *aj,const PetscScalar *aa,const PetscScalar *const *b,PetscScalar *const *c,InsertMode imode)
+{
+  const PetscScalar *b0 = b[0],*b1 = b[1];
+  PetscScalar       *c0 = c[0],*c1 = c[1];
+  PetscScalar       r0,r1,v;
+  PetscInt          i,j,col,row;
+
+  for (i=0; i<m; i++) {
+    row = ridx ? ridx[i] : i;
+    r0  = r1 = 0.0;
+    for (j=ai[i]; j<ai[i+1]; j++) {
+      v = aa[j]; col = aj[j];
+      r0 += v*b0[col]; r1 += v*b1[col];
+    }
+    if (imode == ADD_VALUES) {
+      c0[row] += r0; c1[row] += r1;
+    } else {
+      c0[row] = r0; c1[row] = r1;
+    }
+  }
+}
+
+static void MatSeqAIJMultColumns1_Private(PetscInt m,const PetscInt *ai,const PetscInt *ridx,const PetscInt *aj,const PetscScalar *aa,const PetscScalar *const *b,PetscScalar *const *c,InsertMode imode)
+{
+  const PetscScalar *b0 = b[0];
+  PetscScalar       *c0 = c[0];
+  PetscScalar       r0;
+  PetscInt          i,j,row;
+
+  for (i=0; i<m; i++) {
+    row = ridx ? ridx[i] : i;
+    r0  = 0.0;
+    for (j=ai[i]; j<ai[i+1]; j++) r0 += aa[j]*b0[aj[j]];
+    if (imode == ADD_VALUES) c0[row] += r0;
+    else c0[row] = r0;
+  }
+}
+
+/*
+   MatSeqAIJMultColumns_Private - computes c_l (+)= A b_l for l = 0,...,k-1 with the values av of A; the
+   columns are processed in blocks of 8, 4, 2 and 1 so the matrix is read at most k/8 + 3 times.
+
+   With ADD_VALUES the compressed row storage of A is used if available, with INSERT_VALUES every row is set.
+*/
+PetscErrorCode MatSeqAIJMultColumns_Private(Mat A,const PetscScalar *av,PetscInt k,const PetscScalar *const *b,PetscScalar *const *c,InsertMode imode)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  const PetscInt *ai = a->i,*ridx = NULL;
+  PetscInt       l = 0,m = A->rmap->n;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (imode == ADD_VALUES && a->compressedrow.use) {
+    m    = a->compressedrow.nrows;
+    ai   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  for (; l+8<=k; l+=8) MatSeqAIJMultColumns8_Private(m,ai,ridx,a->j,av,b+l,c+l,imode);
+  if (l+4<=k) {MatSeqAIJMultColumns4_Private(m,ai,ridx,a->j,av,b+l,c+l,imode); l += 4;}
+  if (l+2<=k) {MatSeqAIJMultColumns2_Private(m,ai,ridx,a->j,av,b+l,c+l,imode); l += 2;}
+  if (l<k)    {MatSeqAIJMultColumns1_Private(m,ai,ridx,a->j,av,b+l,c+l,imode);}
+  ierr = PetscLogFlops(k*2.0*a->nz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMultMultiple_SeqAIJ_Private(Mat A,PetscInt k,const Vec x[],Vec y[],InsertMode imode)
+{
+  const PetscScalar **b;
+  PetscScalar       **c;
+  const PetscScalar *av;
+  PetscInt          l;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc2(k,&b,k,&c);CHKERRQ(ierr);
+  for (l=0; l<k; l++) {ierr = VecGetArrayRead(x[l],&b[l]);CHKERRQ(ierr);}
+  for (l=0; l<k; l++) {ierr = VecGetArray(y[l],&c[l]);CHKERRQ(ierr);}
+  ierr = MatSeqAIJGetArrayRead(A,&av);CHKERRQ(ierr);
+  ierr = MatSeqAIJMultColumns_Private(A,av,k,b,c,imode);CHKERRQ(ierr);
+  ierr = MatSeqAIJRestoreArrayRead(A,&av);CHKERRQ(ierr);
+  for (l=0; l<k; l++) {ierr = VecRestoreArray(y[l],&c[l]);CHKERRQ(ierr);}
+  for (l=0; l<k; l++) {ierr = VecRestoreArrayRead(x[l],&b[l]);CHKERRQ(ierr);}
+  ierr = PetscFree2(b,c);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultMultiple_SeqAIJ(Mat A,PetscInt k,const Vec x[],Vec y[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMultMultiple_SeqAIJ_Private(A,k,x,y,INSERT_VALUES);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* y_l += A x_l, used for the off-diagonal part of MatMultMultiple_MPIAIJ() */
+PetscErrorCode MatMultAddMultiple_SeqAIJ(Mat A,PetscInt k,const Vec x[],Vec y[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMultMultiple_SeqAIJ_Private(A,k,x,y,ADD_VALUES);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
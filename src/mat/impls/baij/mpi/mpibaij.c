@@ -1333,6 +1333,7 @@ PetscErrorCode MatDestroy_MPIBAIJ(Mat mat)
   ierr = PetscFree(baij->barray);CHKERRQ(ierr);
   ierr = PetscFree2(baij->hd,baij->ht);CHKERRQ(ierr);
   ierr = PetscFree(baij->rangebs);CHKERRQ(ierr);
+  ierr = MatDestroyCOO_MPIXAIJ_Private(&baij->coo);CHKERRQ(ierr);
   ierr = PetscFree(mat->data);CHKERRQ(ierr);
 
   ierr = PetscObjectChangeTypeName((PetscObject)mat,0);CHKERRQ(ierr);
@@ -1340,6 +1341,8 @@ PetscErrorCode MatDestroy_MPIBAIJ(Mat mat)
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatRetrieveValues_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMPIBAIJSetPreallocation_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMPIBAIJSetPreallocationCSR_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetPreallocationCOO_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetValuesCOO_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatDiagonalScaleLocal_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetHashTableFactor_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatConvert_mpibaij_mpisbaij_C",NULL);CHKERRQ(ierr);
@@ -2780,6 +2783,33 @@ PetscErrorCode MatMPIBAIJSetPreallocationCSR_MPIBAIJ(Mat B,PetscInt bs,const Pet
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode MatSetPreallocationCOO_MPIBAIJ(Mat mat,PetscInt n,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  Mat_MPIBAIJ    *baij = (Mat_MPIBAIJ*)mat->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatDestroyCOO_MPIXAIJ_Private(&baij->coo);CHKERRQ(ierr);
+  ierr = MatMPIBAIJSetPreallocation(mat,PetscAbs(mat->rmap->bs),0,NULL,0,NULL);CHKERRQ(ierr);
+  ierr = MatSetPreallocationCOO_MPIXAIJ_Private(mat,baij->A,baij->B,mat->rmap->bs,MatSeqBAIJSetPreallocation_COO_Private,n,coo_i,coo_j,&baij->coo);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSetValuesCOO_MPIBAIJ(Mat mat,const PetscScalar v[],InsertMode imode)
+{
+  Mat_MPIBAIJ    *baij = (Mat_MPIBAIJ*)mat->data;
+  Mat_SeqBAIJ    *a = (Mat_SeqBAIJ*)baij->A->data,*b = (Mat_SeqBAIJ*)baij->B->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!baij->coo || baij->coo->nonzerostate != mat->nonzerostate) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call MatSetPreallocationCOO() first, and the nonzero structure must not change afterwards");
+  ierr = MatSetValuesCOO_MPIXAIJ_Private(baij->coo,v,imode,a->a,a->bs2*a->nz,b->a,b->bs2*b->nz);CHKERRQ(ierr);
+  a->idiagvalid = PETSC_FALSE;
+  ierr = PetscObjectStateIncrease((PetscObject)baij->A);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)baij->B);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
    MatMPIBAIJSetPreallocationCSR - Creates a sparse parallel matrix in BAIJ format using the given nonzero structure and (optional) numerical values
 
@@ -3064,6 +3094,8 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIBAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatRetrieveValues_C",MatRetrieveValues_MPIBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIBAIJSetPreallocation_C",MatMPIBAIJSetPreallocation_MPIBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIBAIJSetPreallocationCSR_C",MatMPIBAIJSetPreallocationCSR_MPIBAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetPreallocationCOO_C",MatSetPreallocationCOO_MPIBAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetValuesCOO_C",MatSetValuesCOO_MPIBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatDiagonalScaleLocal_C",MatDiagonalScaleLocal_MPIBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetHashTableFactor_C",MatSetHashTableFactor_MPIBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatPtAP_is_mpibaij_C",MatPtAP_IS_XAIJ);CHKERRQ(ierr);
@@ -62,6 +62,7 @@
   PetscInt  setvalueslen;       /* only used for single precision computations */              \
   MatScalar *setvaluescopy;     /* area double precision values in MatSetValuesXXX() are copied*/ \
                                 /* before calling MatSetValuesXXX_MPIBAIJ_MatScalar() */       \
+  Mat_MPICOO *coo;              /* communication and positions for MatSetValuesCOO() */        \
   PetscBool ijonly             /* used in  MatCreateSubMatrices_MPIBAIJ_local() for getting ij structure only */
 
 typedef struct {
@@ -78,4 +79,6 @@ PETSC_INTERN PetscErrorCode MatIncreaseOverlap_MPIBAIJ(Mat,PetscInt,IS[],PetscIn
 PETSC_INTERN PetscErrorCode MatIncreaseOverlap_MPIBAIJ_Once(Mat,PetscInt,IS*);
 PETSC_INTERN PetscErrorCode MatMPIBAIJSetPreallocation_MPIBAIJ(Mat B,PetscInt bs,PetscInt d_nz,const PetscInt *d_nnz,PetscInt o_nz,const PetscInt *o_nnz);
 PETSC_INTERN PetscErrorCode MatAXPYGetPreallocation_MPIBAIJ(Mat,const PetscInt *,Mat,const PetscInt*,PetscInt*);
+PETSC_INTERN PetscErrorCode MatSetPreallocationCOO_MPIBAIJ(Mat,PetscInt,const PetscInt[],const PetscInt[]);
+PETSC_INTERN PetscErrorCode MatSetValuesCOO_MPIBAIJ(Mat,const PetscScalar[],InsertMode);
 #endif
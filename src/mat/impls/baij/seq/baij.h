@@ -32,6 +32,9 @@ typedef struct {
 
 PETSC_INTERN PetscErrorCode MatSeqBAIJSetPreallocation_SeqBAIJ(Mat B,PetscInt bs,PetscInt nz,PetscInt *nnz);
 PETSC_INTERN PetscErrorCode MatAXPY_SeqBAIJ(Mat Y,PetscScalar a,Mat X,MatStructure str);
+PETSC_INTERN PetscErrorCode MatSeqBAIJSetPreallocation_COO_Private(Mat,PetscInt,const PetscInt[]);
+PETSC_INTERN PetscErrorCode MatSetPreallocationCOO_SeqBAIJ(Mat,PetscInt,const PetscInt[],const PetscInt[]);
+PETSC_INTERN PetscErrorCode MatSetValuesCOO_SeqBAIJ(Mat,const PetscScalar[],InsertMode);
 
 PETSC_INTERN PetscErrorCode MatGetColumnIJ_SeqBAIJ(Mat,PetscInt,PetscBool,PetscBool,PetscInt*,const PetscInt *[],const PetscInt *[],PetscBool*);
 PETSC_INTERN PetscErrorCode MatRestoreColumnIJ_SeqBAIJ(Mat,PetscInt,PetscBool,PetscBool,PetscInt*,const PetscInt *[],const PetscInt *[],PetscBool*);
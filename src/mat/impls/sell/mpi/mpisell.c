@@ -1748,8 +1748,7 @@ PetscErrorCode MatConvert_MPIAIJ_MPISELL(Mat A,MatType newtype,MatReuse reuse,Ma
     ierr = MatSetType(B,MATMPISELL);CHKERRQ(ierr);
     ierr = MatSetSizes(B,A->rmap->n,A->cmap->n,A->rmap->N,A->cmap->N);CHKERRQ(ierr);
     ierr = MatSetBlockSizes(B,A->rmap->bs,A->cmap->bs);CHKERRQ(ierr);
-    ierr = MatSeqAIJSetPreallocation(B,0,NULL);CHKERRQ(ierr);
-    ierr = MatMPIAIJSetPreallocation(B,0,NULL,0,NULL);CHKERRQ(ierr);
+    ierr = MatMPISELLSetPreallocation(B,0,NULL,0,NULL);CHKERRQ(ierr);
   }
   b    = (Mat_MPISELL*) B->data;
 
@@ -1760,6 +1759,11 @@ PetscErrorCode MatConvert_MPIAIJ_MPISELL(Mat A,MatType newtype,MatReuse reuse,Ma
     ierr = MatDestroy(&b->A);CHKERRQ(ierr);
     ierr = MatDestroy(&b->B);CHKERRQ(ierr);
     ierr = MatDisAssemble_MPIAIJ(A);CHKERRQ(ierr);
+    /* A is assembled again below, which must rebuild the communication pattern MatDisAssemble_MPIAIJ() destroyed */
+    A->assembled = PETSC_FALSE;
+    /* the off-diagonal block, now with global column indices, must be assembled before it can be converted */
+    ierr = MatAssemblyBegin(a->B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(a->B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
     ierr = MatConvert_SeqAIJ_SeqSELL(a->A, MATSEQSELL, MAT_INITIAL_MATRIX, &b->A);CHKERRQ(ierr);
     ierr = MatConvert_SeqAIJ_SeqSELL(a->B, MATSEQSELL, MAT_INITIAL_MATRIX, &b->B);CHKERRQ(ierr);
     ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
@@ -31,6 +31,15 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJPERM(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJSELL(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJSELL(Mat);
 
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJOMP(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJOMP(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJAUTO(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJAUTO(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJSingle(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJSingle(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJDelta(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJDelta(Mat);
+
 #if defined(PETSC_HAVE_MKL_SPARSE)
 PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJMKL(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJMKL(Mat);
@@ -117,6 +126,22 @@ PetscErrorCode  MatRegisterAll(void)
   ierr = MatRegister(MATMPIAIJSELL,     MatCreate_MPIAIJSELL);CHKERRQ(ierr);
   ierr = MatRegister(MATSEQAIJSELL,     MatCreate_SeqAIJSELL);CHKERRQ(ierr);
 
+  ierr = MatRegisterRootName(MATAIJOMP,MATSEQAIJOMP,MATMPIAIJOMP);CHKERRQ(ierr);
+  ierr = MatRegister(MATMPIAIJOMP,      MatCreate_MPIAIJOMP);CHKERRQ(ierr);
+  ierr = MatRegister(MATSEQAIJOMP,      MatCreate_SeqAIJOMP);CHKERRQ(ierr);
+
+  ierr = MatRegisterRootName(MATAIJAUTO,MATSEQAIJAUTO,MATMPIAIJAUTO);CHKERRQ(ierr);
+  ierr = MatRegister(MATMPIAIJAUTO,     MatCreate_MPIAIJAUTO);CHKERRQ(ierr);
+  ierr = MatRegister(MATSEQAIJAUTO,     MatCreate_SeqAIJAUTO);CHKERRQ(ierr);
+
+  ierr = MatRegisterRootName(MATAIJSINGLE,MATSEQAIJSINGLE,MATMPIAIJSINGLE);CHKERRQ(ierr);
+  ierr = MatRegister(MATMPIAIJSINGLE,   MatCreate_MPIAIJSingle);CHKERRQ(ierr);
+  ierr = MatRegister(MATSEQAIJSINGLE,   MatCreate_SeqAIJSingle);CHKERRQ(ierr);
+
+  ierr = MatRegisterRootName(MATAIJDELTA,MATSEQAIJDELTA,MATMPIAIJDELTA);CHKERRQ(ierr);
+  ierr = MatRegister(MATMPIAIJDELTA,    MatCreate_MPIAIJDelta);CHKERRQ(ierr);
+  ierr = MatRegister(MATSEQAIJDELTA,    MatCreate_SeqAIJDelta);CHKERRQ(ierr);
+
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = MatRegisterRootName(MATAIJMKL, MATSEQAIJMKL,MATMPIAIJMKL);CHKERRQ(ierr);
   ierr = MatRegister(MATMPIAIJMKL,      MatCreate_MPIAIJMKL);CHKERRQ(ierr);
@@ -30,7 +30,7 @@ PetscLogEvent MAT_MultHermitianTranspose,MAT_MultHermitianTransposeAdd;
 PetscLogEvent MAT_Getsymtranspose, MAT_Getsymtransreduced, MAT_GetBrowsOfAcols;
 PetscLogEvent MAT_GetBrowsOfAocols, MAT_Getlocalmat, MAT_Getlocalmatcondensed, MAT_Seqstompi, MAT_Seqstompinum, MAT_Seqstompisym;
 PetscLogEvent MAT_Applypapt, MAT_Applypapt_numeric, MAT_Applypapt_symbolic, MAT_GetSequentialNonzeroStructure;
-PetscLogEvent MAT_GetMultiProcBlock;
+PetscLogEvent MAT_GetMultiProcBlock, MAT_PreallCOO, MAT_SetVCOO, MAT_AutoTune;
 PetscLogEvent MAT_CUSPARSECopyToGPU, MAT_SetValuesBatch;
 PetscLogEvent MAT_ViennaCLCopyToGPU;
 PetscLogEvent MAT_DenseCopyToGPU, MAT_DenseCopyFromGPU;
@@ -2348,6 +2348,74 @@ PetscErrorCode MatMult(Mat mat,Vec x,Vec y)
   PetscFunctionReturn(0);
 }
 
+/*@
+   MatMultMultiple - Computes the matrix-vector products y[i] = A x[i] for a set of vectors.
+
+   Neighbor-wise Collective on Mat
+
+   Input Parameters:
++  mat - the matrix
+.  k   - the number of vectors
+-  x   - the vectors to be multiplied
+
+   Output Parameters:
+.  y - the results
+
+   Notes:
+   The vectors x[i] and y[j] cannot be the same.
+
+   For AIJ matrices the products are computed together so that each row of the matrix is read from memory
+   once for up to 8 vectors, which is considerably faster than k calls to MatMult() since sparse matrix-vector
+   products are limited by the memory bandwidth. Other matrix types call MatMult() for each vector.
+
+   Level: intermediate
+
+.seealso: MatMult(), MatMatMult(), VecMDot(), VecMAXPY()
+@*/
+PetscErrorCode MatMultMultiple(Mat mat,PetscInt k,const Vec x[],Vec y[])
+{
+  PetscErrorCode ierr,(*f)(Mat,PetscInt,const Vec[],Vec[]);
+  PetscInt       i,j;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(mat,MAT_CLASSID,1);
+  PetscValidType(mat,1);
+  if (k < 0) SETERRQ1(PetscObjectComm((PetscObject)mat),PETSC_ERR_ARG_OUTOFRANGE,"Number of vectors (given %D) cannot be negative",k);
+  if (!k) PetscFunctionReturn(0);
+  PetscValidPointer(x,3);
+  PetscValidPointer(y,4);
+  if (!mat->assembled) SETERRQ(PetscObjectComm((PetscObject)mat),PETSC_ERR_ARG_WRONGSTATE,"Not for unassembled matrix");
+  if (mat->factortype) SETERRQ(PetscObjectComm((PetscObject)mat),PETSC_ERR_ARG_WRONGSTATE,"Not for factored matrix");
+  for (i=0; i<k; i++) {
+    PetscValidHeaderSpecific(x[i],VEC_CLASSID,3);
+    PetscValidHeaderSpecific(y[i],VEC_CLASSID,4);
+#if !defined(PETSC_HAVE_CONSTRAINTS)
+    if (mat->cmap->N != x[i]->map->N) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Mat mat,Vec x: global dim %D %D",mat->cmap->N,x[i]->map->N);
+    if (mat->rmap->N != y[i]->map->N) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Mat mat,Vec y: global dim %D %D",mat->rmap->N,y[i]->map->N);
+    if (mat->rmap->n != y[i]->map->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Mat mat,Vec y: local dim %D %D",mat->rmap->n,y[i]->map->n);
+#endif
+    for (j=0; j<k; j++) {
+      if (x[i] == y[j]) SETERRQ(PetscObjectComm((PetscObject)mat),PETSC_ERR_ARG_WRONGSTATE,"x and y must be different vectors");
+    }
+  }
+  MatCheckPreallocated(mat,1);
+
+  ierr = PetscObjectQueryFunction((PetscObject)mat,"MatMultMultiple_C",&f);CHKERRQ(ierr);
+  if (f) {
+    for (i=0; i<k; i++) {
+      ierr = VecSetErrorIfLocked(y[i],4);CHKERRQ(ierr);
+      ierr = VecLockReadPush(x[i]);CHKERRQ(ierr);
+    }
+    ierr = PetscLogEventBegin(MAT_Mult,mat,x[0],y[0],0);CHKERRQ(ierr);
+    ierr = (*f)(mat,k,x,y);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(MAT_Mult,mat,x[0],y[0],0);CHKERRQ(ierr);
+    for (i=0; i<k; i++) {ierr = VecLockReadPop(x[i]);CHKERRQ(ierr);}
+  } else {
+    for (i=0; i<k; i++) {ierr = MatMult(mat,x[i],y[i]);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
 /*@
    MatMultTranspose - Computes matrix transpose times a vector y = A^T * x.
 
@@ -3925,6 +3993,76 @@ PetscErrorCode MatSOR(Mat mat,Vec b,PetscReal omega,MatSORType flag,PetscReal sh
   PetscFunctionReturn(0);
 }
 
+/*@
+   MatSORSetMulticolor - Sets MatSOR() to sweep the rows of the matrix color by color, where the colors
+   are independent sets of the graph of the matrix, so that the rows of a color can be relaxed in parallel.
+
+   Logically Collective on Mat
+
+   Input Parameters:
++  mat - the matrix
+-  flg - PETSC_TRUE to use the multicolor ordering, PETSC_FALSE to use the natural ordering
+
+   Options Database Keys:
++  -pc_sor_multicolor - activates the multicolor ordering for the matrix used by PCSOR
+-  -sor_mat_coloring_type <greedy,jp> - the MatColoring used to compute the colors
+
+   Notes:
+   The coloring is computed with a distance one MatColoring of the nonzero structure of A + A^T the first time
+   the matrix is relaxed and it is recomputed only when the nonzero structure changes. The rows of each color are
+   relaxed with the OpenMP threads, see -omp_num_threads; the results do not depend on the number of threads.
+
+   The relaxation parameters, the sweep directions (forward sweeps visit the colors in increasing order, backward
+   sweeps in decreasing order), the number of iterations and the zero initial guess have the same meaning as
+   for the natural ordering; SOR_EISENSTAT, SOR_APPLY_UPPER and SOR_APPLY_LOWER always use the natural ordering.
+   Since the rows are visited in a different order the iterates differ from those of the natural ordering.
+
+   For parallel matrices this applies to the sweeps on the diagonal block of each process, so it should be
+   called once the matrix is preallocated. Matrix types without support for it ignore this call; currently
+   it is supported by MATSEQAIJ and MATMPIAIJ (and the types derived from them that do not provide their own relaxation).
+
+   Level: advanced
+
+.seealso: MatSOR(), MatSORGetMulticolor(), PCSORSetMulticolor(), MatColoringCreate(), MATCOLORINGGREEDY
+@*/
+PetscErrorCode MatSORSetMulticolor(Mat mat,PetscBool flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(mat,MAT_CLASSID,1);
+  PetscValidLogicalCollectiveBool(mat,flg,2);
+  ierr = PetscTryMethod(mat,"MatSORSetMulticolor_C",(Mat,PetscBool),(mat,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   MatSORGetMulticolor - Gets whether MatSOR() sweeps the rows of the matrix color by color
+
+   Not Collective
+
+   Input Parameter:
+.  mat - the matrix
+
+   Output Parameter:
+.  flg - PETSC_TRUE if the multicolor ordering is used; always PETSC_FALSE for matrix types without support for it
+
+   Level: advanced
+
+.seealso: MatSOR(), MatSORSetMulticolor()
+@*/
+PetscErrorCode MatSORGetMulticolor(Mat mat,PetscBool *flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(mat,MAT_CLASSID,1);
+  PetscValidPointer(flg,2);
+  *flg = PETSC_FALSE;
+  ierr = PetscTryMethod(mat,"MatSORGetMulticolor_C",(Mat,PetscBool*),(mat,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*
       Default matrix copy routine.
 */
@@ -8721,16 +8859,16 @@ PetscErrorCode MatCreateVecs(Mat mat,Vec *right,Vec *left)
       ierr = VecCreate(PetscObjectComm((PetscObject)mat),right);CHKERRQ(ierr);
       ierr = VecSetSizes(*right,mat->cmap->n,PETSC_DETERMINE);CHKERRQ(ierr);
       ierr = VecSetBlockSize(*right,cbs);CHKERRQ(ierr);
-      ierr = VecSetType(*right,mat->defaultvectype);CHKERRQ(ierr);
       ierr = PetscLayoutReference(mat->cmap,&(*right)->map);CHKERRQ(ierr);
+      ierr = VecSetType(*right,mat->defaultvectype);CHKERRQ(ierr);
     }
     if (left) {
       if (mat->rmap->n < 0) SETERRQ(PetscObjectComm((PetscObject)mat),PETSC_ERR_ARG_WRONGSTATE,"PetscLayout for rows not yet setup");
       ierr = VecCreate(PetscObjectComm((PetscObject)mat),left);CHKERRQ(ierr);
       ierr = VecSetSizes(*left,mat->rmap->n,PETSC_DETERMINE);CHKERRQ(ierr);
       ierr = VecSetBlockSize(*left,rbs);CHKERRQ(ierr);
-      ierr = VecSetType(*left,mat->defaultvectype);CHKERRQ(ierr);
       ierr = PetscLayoutReference(mat->rmap,&(*left)->map);CHKERRQ(ierr);
+      ierr = VecSetType(*left,mat->defaultvectype);CHKERRQ(ierr);
     }
   }
   PetscFunctionReturn(0);
@@ -322,6 +322,167 @@ PetscErrorCode MatXAIJSetPreallocation(Mat A,PetscInt bs,const PetscInt dnnz[],c
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode MatSetPreallocationCOO_Basic(Mat A,PetscInt n,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  Mat            preallocator;
+  IS             is_coo_i,is_coo_j;
+  PetscScalar    zero = 0.0;
+  PetscInt       rbs,cbs,k;
+  void           (*xaij)(void) = NULL;
+  const char     *xaijnames[] = {"MatSeqAIJSetPreallocation_C","MatMPIAIJSetPreallocation_C","MatSeqBAIJSetPreallocation_C","MatMPIBAIJSetPreallocation_C",
+                                 "MatSeqSBAIJSetPreallocation_C","MatMPISBAIJSetPreallocation_C","MatISSetPreallocation_C"};
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* only types understood by MatXAIJSetPreallocation() benefit from counting the nonzeros first */
+  for (k=0; k<(PetscInt)(sizeof(xaijnames)/sizeof(xaijnames[0])) && !xaij; k++) {
+    ierr = PetscObjectQueryFunction((PetscObject)A,xaijnames[k],&xaij);CHKERRQ(ierr);
+  }
+  if (xaij) {
+    ierr = MatGetBlockSizes(A,&rbs,&cbs);CHKERRQ(ierr);
+    ierr = MatCreate(PetscObjectComm((PetscObject)A),&preallocator);CHKERRQ(ierr);
+    ierr = MatSetType(preallocator,MATPREALLOCATOR);CHKERRQ(ierr);
+    ierr = MatSetSizes(preallocator,A->rmap->n,A->cmap->n,A->rmap->N,A->cmap->N);CHKERRQ(ierr);
+    ierr = MatSetBlockSizes(preallocator,rbs,cbs);CHKERRQ(ierr);
+    ierr = MatSetUp(preallocator);CHKERRQ(ierr);
+    for (k=0; k<n; k++) {
+      ierr = MatSetValue(preallocator,coo_i[k],coo_j[k],zero,INSERT_VALUES);CHKERRQ(ierr);
+    }
+    ierr = MatAssemblyBegin(preallocator,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(preallocator,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatPreallocatorPreallocate(preallocator,PETSC_TRUE,A);CHKERRQ(ierr);
+    ierr = MatDestroy(&preallocator);CHKERRQ(ierr);
+  } else {
+    ierr = MatSetUp(A);CHKERRQ(ierr);
+  }
+  ierr = ISCreateGeneral(PETSC_COMM_SELF,n,coo_i,PETSC_COPY_VALUES,&is_coo_i);CHKERRQ(ierr);
+  ierr = ISCreateGeneral(PETSC_COMM_SELF,n,coo_j,PETSC_COPY_VALUES,&is_coo_j);CHKERRQ(ierr);
+  ierr = PetscObjectCompose((PetscObject)A,"__PETSc_coo_i",(PetscObject)is_coo_i);CHKERRQ(ierr);
+  ierr = PetscObjectCompose((PetscObject)A,"__PETSc_coo_j",(PetscObject)is_coo_j);CHKERRQ(ierr);
+  ierr = ISDestroy(&is_coo_i);CHKERRQ(ierr);
+  ierr = ISDestroy(&is_coo_j);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValuesCOO_Basic(Mat A,const PetscScalar coo_v[],InsertMode imode)
+{
+  IS             is_coo_i,is_coo_j;
+  const PetscInt *coo_i,*coo_j;
+  PetscInt       n,k;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectQuery((PetscObject)A,"__PETSc_coo_i",(PetscObject*)&is_coo_i);CHKERRQ(ierr);
+  ierr = PetscObjectQuery((PetscObject)A,"__PETSc_coo_j",(PetscObject*)&is_coo_j);CHKERRQ(ierr);
+  if (!is_coo_i || !is_coo_j) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call MatSetPreallocationCOO() first");
+  if (imode == INSERT_VALUES) {
+    ierr = MatZeroEntries(A);CHKERRQ(ierr);
+  }
+  ierr = ISGetLocalSize(is_coo_i,&n);CHKERRQ(ierr);
+  ierr = ISGetIndices(is_coo_i,&coo_i);CHKERRQ(ierr);
+  ierr = ISGetIndices(is_coo_j,&coo_j);CHKERRQ(ierr);
+  for (k=0; k<n; k++) {
+    ierr = MatSetValue(A,coo_i[k],coo_j[k],coo_v[k],ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = ISRestoreIndices(is_coo_i,&coo_i);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(is_coo_j,&coo_j);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatSetPreallocationCOO - set preallocation for a matrix using a coordinate format of the entries
+
+   Collective on Mat
+
+   Input Arguments:
++  A - matrix being preallocated
+.  n - number of entries given by this process
+.  coo_i - row indices (global numbering)
+-  coo_j - column indices (global numbering)
+
+   Notes:
+   The entries may be given in any order and may belong to rows owned by other processes. Repeated (i,j) pairs
+   are allowed and their values are summed by MatSetValuesCOO(). Entries with a negative row or column index are
+   ignored.
+
+   For AIJ and BAIJ matrices the off-process communication pattern and the location of every entry in the
+   compressed storage are computed once here, so that each later MatSetValuesCOO() is a single scatter-add with no
+   searching, sorting, or stash. The matrix is assembled on return and any later attempt to create a new nonzero
+   location generates an error.
+
+   The arrays coo_i and coo_j are not referenced after this call returns.
+
+   Level: beginner
+
+.seealso: MatSetValuesCOO(), MatSeqAIJSetPreallocation(), MatMPIAIJSetPreallocation(), MatSeqBAIJSetPreallocation(),
+          MatMPIBAIJSetPreallocation(), MatXAIJSetPreallocation(), MatCreateSeqAIJWithArrays()
+@*/
+PetscErrorCode MatSetPreallocationCOO(Mat A,PetscInt n,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  PetscErrorCode (*f)(Mat,PetscInt,const PetscInt[],const PetscInt[]) = NULL;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidType(A,1);
+  if (n) PetscValidIntPointer(coo_i,3);
+  if (n) PetscValidIntPointer(coo_j,4);
+  ierr = PetscLayoutSetUp(A->rmap);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(A->cmap);CHKERRQ(ierr);
+  ierr = PetscObjectQueryFunction((PetscObject)A,"MatSetPreallocationCOO_C",&f);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(MAT_PreallCOO,A,0,0,0);CHKERRQ(ierr);
+  if (f) {
+    ierr = (*f)(A,n,coo_i,coo_j);CHKERRQ(ierr);
+  } else {
+    ierr = MatSetPreallocationCOO_Basic(A,n,coo_i,coo_j);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(MAT_PreallCOO,A,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   MatSetValuesCOO - set values at once in a matrix preallocated using MatSetPreallocationCOO()
+
+   Collective on Mat
+
+   Input Arguments:
++  A - matrix being filled
+.  coo_v - the values, in the same order as the indices given to MatSetPreallocationCOO()
+-  imode - INSERT_VALUES replaces the current values of the matrix, ADD_VALUES adds to them
+
+   Notes:
+   Values of repeated (i,j) pairs are summed in both modes; INSERT_VALUES zeroes the matrix first. The matrix is
+   assembled on return, so MatAssemblyBegin() and MatAssemblyEnd() must not be called.
+
+   Level: beginner
+
+.seealso: MatSetPreallocationCOO(), MatSetValues(), InsertMode
+@*/
+PetscErrorCode MatSetValuesCOO(Mat A,const PetscScalar coo_v[],InsertMode imode)
+{
+  PetscErrorCode (*f)(Mat,const PetscScalar[],InsertMode) = NULL;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidType(A,1);
+  MatCheckPreallocated(A,1);
+  PetscValidLogicalCollectiveEnum(A,imode,3);
+  if (imode != INSERT_VALUES && imode != ADD_VALUES) SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_SUP,"Only INSERT_VALUES and ADD_VALUES are supported");
+  ierr = PetscObjectQueryFunction((PetscObject)A,"MatSetValuesCOO_C",&f);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(MAT_SetVCOO,A,0,0,0);CHKERRQ(ierr);
+  if (f) {
+    ierr = (*f)(A,coo_v,imode);CHKERRQ(ierr);
+  } else {
+    ierr = MatSetValuesCOO_Basic(A,coo_v,imode);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(MAT_SetVCOO,A,0,0,0);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*
         Merges some information from Cs header to A; the C object is then destroyed
 
@@ -0,0 +1,65 @@
+static char help[] = "Tests the allocation policy for large allocations set with -malloc_pages and -malloc_numa.\n\n";
+
+#include <petscsys.h>
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode      ierr;
+  PetscInt            i,n = 1000000,m,nerr = 0;
+  PetscScalar         *a,*b,*c;
+  PetscInt            *small;
+  PetscMallocPageType pages;
+  PetscMallocNumaType numa;
+  PetscLogDouble      threshold;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscMallocGetPolicy(&pages,&numa,&threshold);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Pages %s NUMA %s threshold %g\n",PetscMallocPageTypes[pages],PetscMallocNumaTypes[numa],threshold);CHKERRQ(ierr);
+
+  /* large and small allocations, freed in a different order than allocated */
+  ierr = PetscMalloc1(n,&a);CHKERRQ(ierr);
+  ierr = PetscCalloc1(n,&b);CHKERRQ(ierr);
+  ierr = PetscMalloc1(10,&small);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    if (b[i] != 0.0) nerr++;
+    a[i] = i;
+  }
+  for (i=0; i<10; i++) small[i] = i;
+
+  /* growing and shrinking large allocations keeps their entries */
+  for (m=2*n; m>0; m/=4) {
+    ierr = PetscRealloc(m*sizeof(PetscScalar),&a);CHKERRQ(ierr);
+    for (i=0; i<PetscMin(m,n); i++) if (a[i] != (PetscScalar)i) nerr++;
+  }
+  ierr = PetscFree(b);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&c);CHKERRQ(ierr);
+  for (i=0; i<n; i++) c[i] = -i;
+  for (i=0; i<10; i++) if (small[i] != i) nerr++;
+  ierr = PetscFree(small);CHKERRQ(ierr);
+  ierr = PetscFree(a);CHKERRQ(ierr);
+  ierr = PetscFree(c);CHKERRQ(ierr);
+
+  /* the policy can be changed at any time */
+  ierr = PetscMallocSetPolicy(PETSC_MALLOC_PAGES_TRANSPARENT,PETSC_MALLOC_NUMA_INTERLEAVE,PETSC_DEFAULT);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&a);CHKERRQ(ierr);
+  ierr = PetscMallocSetPolicy(pages,numa,threshold);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&b);CHKERRQ(ierr);
+  for (i=0; i<n; i++) a[i] = b[i] = i;
+  ierr = PetscFree(a);CHKERRQ(ierr);
+  ierr = PetscFree(b);CHKERRQ(ierr);
+
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Number of wrong entries %D\n",nerr);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      args: -malloc_pages {{default transparent huge}} -malloc_numa {{default local interleave}} -malloc_policy_threshold 1000000 -malloc_debug {{0 1}}
+      filter: grep -v "^Pages"
+      output_file: output/ex53_1.out
+
+TEST*/
@@ -2,6 +2,7 @@
     Code that allows a user to dictate what malloc() PETSc uses.
 */
 #include <petscsys.h>             /*I   "petscsys.h"   I*/
+#include <petsc/private/petscimpl.h>
 #include <stdarg.h>
 #if defined(PETSC_HAVE_MALLOC_H)
 #include <malloc.h>
@@ -13,6 +14,14 @@ typedef enum {PETSC_MK_DEFAULT=0,PETSC_MK_HBW_PREFERRED=1} PetscMemkindType;
 PetscMemkindType currentmktype = PETSC_MK_HBW_PREFERRED;
 PetscMemkindType previousmktype = PETSC_MK_HBW_PREFERRED;
 #endif
+#if defined(PETSC_HAVE_MMAP)
+#include <sys/mman.h>
+#endif
+#if defined(PETSC_HAVE_MMAP) && defined(__linux__) && !defined(PETSC_HAVE_MEMKIND)
+#include <unistd.h>
+#include <sys/syscall.h>
+#define PETSC_USE_MALLOC_POLICY
+#endif
 /*
         We want to make sure that all mallocs of double or complex numbers are complex aligned.
     1) on systems with memalign() we call that routine to get an aligned memory location
@@ -23,6 +32,125 @@ PetscMemkindType previousmktype = PETSC_MK_HBW_PREFERRED;
 */
 #define SHIFT_CLASSID 456123
 
+/*
+        The policy for large allocations, see PetscMallocSetPolicy(). Without memkind they are mapped with mmap() on
+    2MB boundaries, so that they can use huge pages and be placed on NUMA nodes with mbind() before they are touched.
+    The mapped regions are kept in a list so that PetscFreeAlign() and PetscReallocAlign() recognize them; since they
+    start on 2MB boundaries only such pointers are looked up. With thread safety the list is guarded by
+    PetscMallocSpinLock, which is only held while the list is searched or changed, not during mmap() or munmap().
+*/
+const char *const PetscMallocPageTypes[] = {"DEFAULT","TRANSPARENT","HUGE","PetscMallocPageType","PETSC_MALLOC_PAGES_",0};
+const char *const PetscMallocNumaTypes[] = {"DEFAULT","LOCAL","INTERLEAVE","PetscMallocNumaType","PETSC_MALLOC_NUMA_",0};
+
+#define PETSC_MALLOC_HUGE_PAGE ((size_t)2097152)
+static PetscMallocPageType petscmallocpages     = PETSC_MALLOC_PAGES_DEFAULT;
+static PetscMallocNumaType petscmallocnuma      = PETSC_MALLOC_NUMA_DEFAULT;
+static size_t              petscmallocthreshold = PETSC_MALLOC_HUGE_PAGE;
+
+#if defined(PETSC_USE_MALLOC_POLICY)
+/* from <linux/mempolicy.h>, which is not always installed */
+#define PETSC_MPOL_PREFERRED      1
+#define PETSC_MPOL_INTERLEAVE     3
+#define PETSC_MPOL_F_MEMS_ALLOWED (1<<2)
+#define PETSC_MAX_NUMA_NODES      1024
+
+typedef struct _n_PetscMallocRegion *PetscMallocRegion;
+struct _n_PetscMallocRegion {
+  void              *ptr;
+  size_t            mem,len;   /* the size requested and the size mapped */
+  PetscMallocRegion next;
+};
+static PetscMallocRegion petscmallocregions = NULL;
+
+static void PetscMallocPolicyInsert_Private(PetscMallocRegion region)
+{
+  (void)PetscSpinlockLock(&PetscMallocSpinLock);
+  region->next       = petscmallocregions;
+  petscmallocregions = region;
+  (void)PetscSpinlockUnlock(&PetscMallocSpinLock);
+}
+
+/* Maps mem bytes following the policy, the result is NULL if that fails and the usual allocation is to be used */
+static void PetscMallocPolicyMap_Private(size_t mem,void **result)
+{
+  size_t            len = ((mem+PETSC_MALLOC_HUGE_PAGE-1)/PETSC_MALLOC_HUGE_PAGE)*PETSC_MALLOC_HUGE_PAGE;
+  char              *p  = (char*)MAP_FAILED;
+  PetscMallocRegion region;
+
+  *result = NULL;
+  region  = (PetscMallocRegion)malloc(sizeof(struct _n_PetscMallocRegion));
+  if (!region) return;
+#if defined(MAP_HUGETLB)
+  if (petscmallocpages == PETSC_MALLOC_PAGES_HUGE) p = (char*)mmap(NULL,len,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB,-1,0);
+#endif
+  if (p == MAP_FAILED) {
+    /* map one huge page more and unmap the ends to start on a 2MB boundary; this is also the fallback for explicit
+       huge pages when none are reserved, the transparent ones are asked for then */
+    char   *q = (char*)mmap(NULL,len+PETSC_MALLOC_HUGE_PAGE,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+    size_t shift;
+
+    if (q == MAP_FAILED) {free(region); return;}
+    shift = (PETSC_MALLOC_HUGE_PAGE-((PETSC_UINTPTR_T)q)%PETSC_MALLOC_HUGE_PAGE)%PETSC_MALLOC_HUGE_PAGE;
+    if (shift) munmap(q,shift);
+    munmap(q+shift+len,PETSC_MALLOC_HUGE_PAGE-shift);
+    p = q+shift;
+#if defined(MADV_HUGEPAGE)
+    if (petscmallocpages != PETSC_MALLOC_PAGES_DEFAULT) (void)madvise(p,len,MADV_HUGEPAGE);
+#endif
+  }
+#if defined(SYS_mbind) && defined(SYS_get_mempolicy) && defined(SYS_getcpu)
+  if (petscmallocnuma != PETSC_MALLOC_NUMA_DEFAULT) {
+    const size_t  bits = 8*sizeof(unsigned long);
+    unsigned long nodes[PETSC_MAX_NUMA_NODES/(8*sizeof(unsigned long))];
+    unsigned int  cpu,node,i;
+    long          err;
+
+    for (i=0; i<PETSC_MAX_NUMA_NODES/bits; i++) nodes[i] = 0;
+    if (petscmallocnuma == PETSC_MALLOC_NUMA_LOCAL) {
+      err = syscall(SYS_getcpu,&cpu,&node,NULL);
+      if (!err && node < PETSC_MAX_NUMA_NODES) {
+        nodes[node/bits] = 1UL << (node%bits);
+        err = syscall(SYS_mbind,p,len,PETSC_MPOL_PREFERRED,nodes,PETSC_MAX_NUMA_NODES,0);
+      }
+    } else {
+      err = syscall(SYS_get_mempolicy,NULL,nodes,PETSC_MAX_NUMA_NODES,NULL,PETSC_MPOL_F_MEMS_ALLOWED);
+      if (!err) err = syscall(SYS_mbind,p,len,PETSC_MPOL_INTERLEAVE,nodes,PETSC_MAX_NUMA_NODES,0);
+    }
+    (void)err; /* the memory is placed by the default policy if this fails */
+  }
+#endif
+  region->ptr = p;
+  region->mem = mem;
+  region->len = len;
+  PetscMallocPolicyInsert_Private(region);
+  *result     = p;
+}
+
+/* Unlinks the region starting at ptr from the list and returns it, NULL if ptr was not mapped by the policy */
+static PetscMallocRegion PetscMallocPolicyRemove_Private(void *ptr)
+{
+  PetscMallocRegion *link,region = NULL;
+
+  if (((PETSC_UINTPTR_T)ptr)%PETSC_MALLOC_HUGE_PAGE) return NULL;
+  (void)PetscSpinlockLock(&PetscMallocSpinLock);
+  for (link=&petscmallocregions; *link; link=&(*link)->next) {
+    if ((*link)->ptr == ptr) {
+      region = *link;
+      *link  = region->next;
+      break;
+    }
+  }
+  (void)PetscSpinlockUnlock(&PetscMallocSpinLock);
+  return region;
+}
+
+static void PetscMallocPolicyUnmap_Private(PetscMallocRegion region)
+{
+  munmap(region->ptr,region->len);
+  free(region);
+}
+#endif
+
 PETSC_EXTERN PetscErrorCode PetscMallocAlign(size_t mem,PetscBool clear,int line,const char func[],const char file[],void **result)
 {
   PetscErrorCode ierr;
@@ -30,13 +158,33 @@ PETSC_EXTERN PetscErrorCode PetscMallocAlign(size_t mem,PetscBool clear,int line
   if (!mem) {*result = NULL; return 0;}
 #if defined(PETSC_HAVE_MEMKIND)
   {
-    if (!currentmktype) ierr = memkind_posix_memalign(MEMKIND_DEFAULT,result,PETSC_MEMALIGN,mem);
-    else ierr = memkind_posix_memalign(MEMKIND_HBW_PREFERRED,result,PETSC_MEMALIGN,mem);
+    memkind_t kind  = currentmktype ? MEMKIND_HBW_PREFERRED : MEMKIND_DEFAULT;
+    size_t    align = PETSC_MEMALIGN;
+
+    if (mem >= petscmallocthreshold && petscmallocpages == PETSC_MALLOC_PAGES_HUGE) kind = currentmktype ? MEMKIND_HBW_PREFERRED_HUGETLB : MEMKIND_HUGETLB;
+    if (mem >= petscmallocthreshold && petscmallocpages == PETSC_MALLOC_PAGES_TRANSPARENT) align = PETSC_MALLOC_HUGE_PAGE;
+    ierr = memkind_posix_memalign(kind,result,align,mem);
+    if (ierr == ENOMEM && (kind == MEMKIND_HUGETLB || kind == MEMKIND_HBW_PREFERRED_HUGETLB)) {
+      PetscInfo1(0,"Memkind: fail to request huge pages for %.0f, falling back to normal pages\n",(PetscLogDouble)mem);
+      ierr = memkind_posix_memalign(currentmktype ? MEMKIND_HBW_PREFERRED : MEMKIND_DEFAULT,result,align,mem);
+    }
     if (ierr == EINVAL) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_MEM,"Memkind: invalid 3rd or 4th argument of memkind_posix_memalign()");
     if (ierr == ENOMEM) PetscInfo1(0,"Memkind: fail to request HBW memory %.0f, falling back to normal memory\n",(PetscLogDouble)mem);
+#if defined(MADV_HUGEPAGE)
+    if (!ierr && align == PETSC_MALLOC_HUGE_PAGE) (void)madvise(*result,mem,MADV_HUGEPAGE);
+#endif
     if (clear) {ierr = PetscMemzero(*result,mem);CHKERRQ(ierr);}
   }
 #else
+#  if defined(PETSC_USE_MALLOC_POLICY)
+  if (mem >= petscmallocthreshold && (petscmallocpages != PETSC_MALLOC_PAGES_DEFAULT || petscmallocnuma != PETSC_MALLOC_NUMA_DEFAULT)) {
+    PetscMallocPolicyMap_Private(mem,result);
+    if (*result) { /* the mapped memory is already zero */
+      if (PetscLogMemory) {ierr = PetscMemzero(*result,mem);CHKERRQ(ierr);}
+      return 0;
+    }
+  }
+#  endif
 #  if defined(PETSC_HAVE_DOUBLE_ALIGN_MALLOC) && (PETSC_MEMALIGN == 8)
   if (clear) {
     *result = calloc(1+mem/sizeof(int),sizeof(int));
@@ -85,6 +233,12 @@ PETSC_EXTERN PetscErrorCode PetscFreeAlign(void *ptr,int line,const char func[],
 #if defined(PETSC_HAVE_MEMKIND)
   memkind_free(0,ptr); /* specify the kind to 0 so that memkind will look up for the right type */
 #else
+#  if defined(PETSC_USE_MALLOC_POLICY)
+  {
+    PetscMallocRegion region = PetscMallocPolicyRemove_Private(ptr);
+    if (region) {PetscMallocPolicyUnmap_Private(region); return 0;}
+  }
+#  endif
 #  if (!(defined(PETSC_HAVE_DOUBLE_ALIGN_MALLOC) && (PETSC_MEMALIGN == 8)) && !defined(PETSC_HAVE_MEMALIGN))
   {
     /*
@@ -118,6 +272,22 @@ PETSC_EXTERN PetscErrorCode PetscReallocAlign(size_t mem, int line, const char f
     *result = NULL;
     return 0;
   }
+#if defined(PETSC_USE_MALLOC_POLICY)
+  if (*result) {
+    /* a mapped region is moved to a new allocation, which follows the policy if it is still large enough */
+    PetscMallocRegion region = PetscMallocPolicyRemove_Private(*result);
+    void              *newResult;
+
+    if (region) {
+      ierr = PetscMallocAlign(mem,PETSC_FALSE,line,func,file,&newResult);
+      if (ierr) {PetscMallocPolicyInsert_Private(region); return ierr;}
+      ierr = PetscMemcpy(newResult,*result,PetscMin(mem,region->mem));if (ierr) return ierr;
+      PetscMallocPolicyUnmap_Private(region);
+      *result = newResult;
+      return 0;
+    }
+  }
+#endif
 #if defined(PETSC_HAVE_MEMKIND)
   if (!currentmktype) *result = memkind_realloc(MEMKIND_DEFAULT,*result,mem);
   else *result = memkind_realloc(MEMKIND_HBW_PREFERRED,*result,mem);
@@ -367,6 +537,77 @@ PetscErrorCode PetscMallocSetCoalesce(PetscBool coalesce)
   PetscFunctionReturn(0);
 }
 
+/*@
+   PetscMallocSetPolicy - Sets how the memory of large allocations, such as the storage of matrices and vectors, is
+   mapped to pages and placed on NUMA nodes
+
+   Not Collective
+
+   Input Parameters:
++  pages - PETSC_MALLOC_PAGES_DEFAULT, PETSC_MALLOC_PAGES_TRANSPARENT to ask for transparent huge pages with madvise(), or
+           PETSC_MALLOC_PAGES_HUGE to map explicit 2MB huge pages
+.  numa - PETSC_MALLOC_NUMA_DEFAULT, PETSC_MALLOC_NUMA_LOCAL to place the memory on the NUMA node of the calling thread,
+          or PETSC_MALLOC_NUMA_INTERLEAVE to interleave its pages over the NUMA nodes
+-  threshold - the size in bytes of the smallest allocation the policy applies to, or PETSC_DEFAULT for 2MB
+
+   Options Database Keys:
++  -malloc_pages <default,transparent,huge> - the pages of large allocations
+.  -malloc_numa <default,local,interleave> - the placement of large allocations
+-  -malloc_policy_threshold <bytes> - the size of the smallest allocation the policy applies to
+
+   Notes:
+   On Linux the allocations of at least threshold bytes are then mapped with mmap() on 2MB boundaries, and their
+   placement is set with mbind() before they are touched. Explicit huge pages must have been reserved by the system
+   administrator, for example in /proc/sys/vm/nr_hugepages; when none are left transparent huge pages are asked for
+   instead. With PETSC_MALLOC_NUMA_LOCAL the memory is placed on the node of the thread that allocates it but may go to
+   other nodes when that one is full. The policy only changes how the memory is obtained, so it can be changed at any
+   time; the memory that was already allocated keeps its pages and placement.
+
+   With memkind (-malloc_hbw) the huge page kinds of memkind are used and the NUMA placement is left to memkind. On other
+   systems this has no effect.
+
+   In a build with thread safety (--with-threadsafety) the list of the mapped allocations is guarded by a lock created in
+   PetscInitialize(), so the policy can then only be set after PetscInitialize().
+
+   Level: advanced
+
+.seealso: PetscMallocGetPolicy(), PetscMallocSetDRAM(), PetscMallocSetCoalesce()
+@*/
+PetscErrorCode PetscMallocSetPolicy(PetscMallocPageType pages,PetscMallocNumaType numa,PetscLogDouble threshold)
+{
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_THREADSAFETY)
+  if (!PetscInitializeCalled) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Must call PetscInitialize() before PetscMallocSetPolicy() with thread safety");
+#endif
+  petscmallocpages     = pages;
+  petscmallocnuma      = numa;
+  petscmallocthreshold = (threshold == PETSC_DEFAULT || threshold == PETSC_DECIDE) ? PETSC_MALLOC_HUGE_PAGE : (size_t)PetscMax(threshold,1);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PetscMallocGetPolicy - Gets how the memory of large allocations is mapped to pages and placed on NUMA nodes
+
+   Not Collective
+
+   Output Parameters:
++  pages - the pages of large allocations
+.  numa - the placement of large allocations
+-  threshold - the size in bytes of the smallest allocation the policy applies to
+
+   Level: advanced
+
+.seealso: PetscMallocSetPolicy()
+@*/
+PetscErrorCode PetscMallocGetPolicy(PetscMallocPageType *pages,PetscMallocNumaType *numa,PetscLogDouble *threshold)
+{
+  PetscFunctionBegin;
+  if (pages)     *pages     = petscmallocpages;
+  if (numa)      *numa      = petscmallocnuma;
+  if (threshold) *threshold = (PetscLogDouble)petscmallocthreshold;
+  PetscFunctionReturn(0);
+}
+
 /*@C
    PetscMallocA - Allocate and optionally clear one or more objects, possibly using coalesced malloc
 
@@ -2,6 +2,9 @@
 
 #if defined(PETSC_HAVE_MEMKIND)
 #include <hbwmalloc.h>
+#if defined(PETSC_HAVE_MMAP)
+#include <sys/mman.h>
+#endif
 #endif
 
 /*
@@ -36,7 +39,23 @@ static PetscErrorCode PetscHBWMalloc(size_t a,PetscBool clear,int lineno,const c
     and the allocated pointer is set to NULL if there is not enough HWB memory available.
   */
   {
-    int ierr = hbw_posix_memalign(result,PETSC_MEMALIGN,a);
+    PetscMallocPageType pages;
+    PetscLogDouble      threshold;
+    int                 ierr;
+
+    /* the large allocations follow the page policy of PetscMallocSetPolicy() */
+    ierr = PetscMallocGetPolicy(&pages,NULL,&threshold);CHKERRQ(ierr);
+    if (a >= threshold && pages == PETSC_MALLOC_PAGES_HUGE) {
+      ierr = hbw_posix_memalign_psize(result,PETSC_MEMALIGN,a,HBW_PAGESIZE_2MB);
+      if (ierr) ierr = hbw_posix_memalign(result,PETSC_MEMALIGN,a);
+    } else if (a >= threshold && pages == PETSC_MALLOC_PAGES_TRANSPARENT) {
+      ierr = hbw_posix_memalign(result,2097152,a);
+#if defined(MADV_HUGEPAGE)
+      if (!ierr) (void)madvise(*result,a,MADV_HUGEPAGE);
+#endif
+    } else {
+      ierr = hbw_posix_memalign(result,PETSC_MEMALIGN,a);
+    }
     if (ierr || !*result) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_MEM,"HBW Memory requested %.0f",(PetscLogDouble)a);
   }
   return 0;
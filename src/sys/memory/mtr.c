@@ -64,6 +64,12 @@ static int        PetscLogMalloc          = -1;
 static size_t     PetscLogMallocThreshold = 0;
 static size_t     *PetscLogMallocLength;
 static const char **PetscLogMallocFile,**PetscLogMallocFunction;
+/*
+      Functions registered with PetscMallocViewRegister() to show the memory that packages manage themselves
+*/
+#define MAXMALLOCVIEWERS 8
+static int            PetscMallocNumViewers = 0;
+static PetscErrorCode (*PetscMallocViewers[MAXMALLOCVIEWERS])(FILE*);
 
 /*@C
    PetscMallocValidate - Test the memory for corruption.  This can be called at any time between PetscInitialize() and PetscFinalize()
@@ -792,7 +798,7 @@ PetscErrorCode PetscMallocViewGet(PetscBool *logging)
 
      PetscMemoryView() gives a brief summary of current memory usage
 
-.seealso: PetscMallocGetCurrentUsage(), PetscMallocDump(), PetscMallocViewSet(), PetscMemoryView()
+.seealso: PetscMallocGetCurrentUsage(), PetscMallocDump(), PetscMallocViewSet(), PetscMallocViewRegister(), PetscMemoryView()
 @*/
 PetscErrorCode  PetscMallocView(FILE *fp)
 {
@@ -850,11 +856,41 @@ foundit:;
   free(shortlength);
   free(shortcount);
   free((char**)shortfunction);
+  for (i=0; i<PetscMallocNumViewers; i++) {
+    ierr = (*PetscMallocViewers[i])(fp);CHKERRQ(ierr);
+  }
   err = fflush(fp);
   if (err) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SYS,"fflush() failed on file");
   PetscFunctionReturn(0);
 }
 
+/*@C
+    PetscMallocViewRegister - Registers a function that PetscMallocView() calls to show statistics on memory that a
+       package manages itself, for example memory it keeps for reuse
+
+    Not Collective
+
+    Input Parameter:
+.   view - the function, it is called with the file pointer passed to PetscMallocView()
+
+    Level: developer
+
+    Notes:
+    Registering the same function again has no effect.
+
+.seealso: PetscMallocView(), PetscMallocViewSet()
+@*/
+PetscErrorCode PetscMallocViewRegister(PetscErrorCode (*view)(FILE*))
+{
+  int i;
+
+  PetscFunctionBegin;
+  for (i=0; i<PetscMallocNumViewers; i++) if (PetscMallocViewers[i] == view) PetscFunctionReturn(0);
+  if (PetscMallocNumViewers == MAXMALLOCVIEWERS) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Cannot register more than %d functions",MAXMALLOCVIEWERS);
+  PetscMallocViewers[PetscMallocNumViewers++] = view;
+  PetscFunctionReturn(0);
+}
+
 /* ---------------------------------------------------------------------------- */
 
 /*@
@@ -412,6 +412,19 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
   ierr = PetscOptionsGetBool(NULL,NULL,"-malloc_hbw",&flg1,NULL);CHKERRQ(ierr);
   /* ignore this option if malloc is already set */
   if (flg1 && !petscsetmallocvisited) {ierr = PetscSetUseHBWMalloc_Private();CHKERRQ(ierr);}
+  {
+    PetscMallocPageType pages;
+    PetscMallocNumaType numa;
+    PetscLogDouble      threshold;
+    PetscReal           mthreshold;
+
+    ierr = PetscMallocGetPolicy(&pages,&numa,&threshold);CHKERRQ(ierr);
+    mthreshold = threshold;
+    ierr = PetscOptionsGetEnum(NULL,NULL,"-malloc_pages",PetscMallocPageTypes,(PetscEnum*)&pages,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsGetEnum(NULL,NULL,"-malloc_numa",PetscMallocNumaTypes,(PetscEnum*)&numa,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsGetReal(NULL,NULL,"-malloc_policy_threshold",&mthreshold,NULL);CHKERRQ(ierr);
+    ierr = PetscMallocSetPolicy(pages,numa,(PetscLogDouble)mthreshold);CHKERRQ(ierr);
+  }
 
   flg1 = PETSC_FALSE;
   ierr = PetscOptionsGetBool(NULL,NULL,"-malloc_info",&flg1,NULL);CHKERRQ(ierr);
@@ -680,6 +693,9 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
     ierr = (*PetscHelpPrintf)(comm," -malloc_info: prints total memory usage\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -malloc_view <optional filename>: keeps log of all memory allocations, displays in PetscFinalize()\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -malloc_debug <true or false>: enables or disables extended checking for memory corruption\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -malloc_pages <default,transparent,huge>: pages of the large allocations, see PetscMallocSetPolicy()\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -malloc_numa <default,local,interleave>: placement of the large allocations on the NUMA nodes\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -malloc_policy_threshold <bytes>: size of the smallest allocation -malloc_pages and -malloc_numa apply to\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -options_view: dump list of options inputted\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -options_left: dump list of unused options\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -options_left no: don't dump list of unused options\n");CHKERRQ(ierr);
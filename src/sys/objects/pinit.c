@@ -63,6 +63,7 @@ PetscSpinlock PetscViewerASCIISpinLockOpen;
 PetscSpinlock PetscViewerASCIISpinLockStdout;
 PetscSpinlock PetscViewerASCIISpinLockStderr;
 PetscSpinlock PetscCommSpinLock;
+PetscSpinlock PetscMallocSpinLock;
 #endif
 
 /*
@@ -711,6 +712,9 @@ PetscInt PetscNumOMPThreads;
 .  -malloc_test - like -malloc_dump -malloc_debug, but only active for debugging builds, ignored in optimized build. May want to set in PETSC_OPTIONS environmental variable
 .  -malloc_view - show a list of all allocated memory during PetscFinalize()
 .  -malloc_view_threshold <t> - only list memory allocations of size greater than t with -malloc_view
+.  -malloc_pages <default,transparent,huge> - use huge pages for large allocations, see PetscMallocSetPolicy()
+.  -malloc_numa <default,local,interleave> - place large allocations on the local NUMA node or interleave them over the nodes
+.  -malloc_policy_threshold <bytes> - size of the smallest allocation -malloc_pages and -malloc_numa apply to
 .  -fp_trap - Stops on floating point exceptions
 .  -no_signal_handler - Indicates not to trap error signals
 .  -shared_tmp - indicates /tmp directory is shared by all processors
@@ -903,6 +907,7 @@ PetscErrorCode  PetscInitialize(int *argc,char ***args,const char file[],const c
   ierr = PetscSpinlockCreate(&PetscViewerASCIISpinLockStdout);CHKERRQ(ierr);
   ierr = PetscSpinlockCreate(&PetscViewerASCIISpinLockStderr);CHKERRQ(ierr);
   ierr = PetscSpinlockCreate(&PetscCommSpinLock);CHKERRQ(ierr);
+  ierr = PetscSpinlockCreate(&PetscMallocSpinLock);CHKERRQ(ierr);
 
   if (PETSC_COMM_WORLD == MPI_COMM_NULL) PETSC_COMM_WORLD = MPI_COMM_WORLD;
   ierr = MPI_Comm_set_errhandler(PETSC_COMM_WORLD,MPI_ERRORS_RETURN);CHKERRQ(ierr);
@@ -1605,6 +1610,7 @@ PetscErrorCode  PetscFinalize(void)
   ierr = PetscSpinlockDestroy(&PetscViewerASCIISpinLockStdout);CHKERRQ(ierr);
   ierr = PetscSpinlockDestroy(&PetscViewerASCIISpinLockStderr);CHKERRQ(ierr);
   ierr = PetscSpinlockDestroy(&PetscCommSpinLock);CHKERRQ(ierr);
+  ierr = PetscSpinlockDestroy(&PetscMallocSpinLock);CHKERRQ(ierr);
 
   if (PetscBeganMPI) {
 #if defined(PETSC_HAVE_MPI_FINALIZED)
@@ -0,0 +1,139 @@
+static char help[]= "Tests PetscSFBcastAndOpMultipleBegin/End() and PetscSFReduceMultipleBegin/End() against the single array routines.\n\n";
+
+#include <petscsf.h>
+
+/* The number of messages sent by all the processes so far, only counted when logging is enabled */
+static PetscErrorCode GetMessageCount(PetscLogDouble *ct)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *ct  = 0;
+#if defined(PETSC_USE_LOG)
+  ierr = MPIU_Allreduce(&petsc_isend_ct,ct,1,MPIU_PETSCLOGDOUBLE,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+#endif
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscSF        sf;
+  PetscSFNode    *iremote;
+  PetscInt       *ilocal;
+  PetscInt       i,j,a,k = 5,nroots = 8,nleaves,nleafspace,nerr;
+  PetscLogDouble ct[3];
+  PetscInt       **rootdata,**leafdata,*rootref,*leafref;
+  PetscMPIInt    rank,size;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-k",&k,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nroots",&nroots,NULL);CHKERRQ(ierr);
+
+  /* Each process has leaves on itself and on all the other processes, several leaves sharing a root, in a sparse
+     leaf space so that the leaf indices are not the identity */
+  nleaves    = 2*nroots;
+  nleafspace = 2*nleaves+1;
+  ierr = PetscMalloc1(nleaves,&ilocal);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nleaves,&iremote);CHKERRQ(ierr);
+  for (i=0; i<nleaves; i++) {
+    ilocal[i]       = nleafspace-1-2*i;
+    iremote[i].rank = (rank+i)%size;
+    iremote[i].index = (3*i+rank)%nroots;
+  }
+  ierr = PetscSFCreate(PETSC_COMM_WORLD,&sf);CHKERRQ(ierr);
+  ierr = PetscSFSetFromOptions(sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(sf,nroots,nleaves,ilocal,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+
+  ierr = PetscMalloc2(k,&rootdata,k,&leafdata);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nroots,&rootref,nleafspace,&leafref);CHKERRQ(ierr);
+  for (a=0; a<k; a++) {
+    ierr = PetscMalloc2(nroots,&rootdata[a],nleafspace,&leafdata[a]);CHKERRQ(ierr);
+  }
+
+  /*
+     Broadcast with replacement, then with addition; the batched broadcast sends one message to each process for all
+     the k arrays where the single array broadcasts send k
+  */
+  for (j=0; j<2; j++) {
+    MPI_Op op = j ? MPI_SUM : MPIU_REPLACE;
+
+    for (a=0; a<k; a++) {
+      for (i=0; i<nroots; i++) rootdata[a][i] = 1000*rank+100*a+i;
+      for (i=0; i<nleafspace; i++) leafdata[a][i] = -(i+a);
+    }
+    ierr = GetMessageCount(&ct[0]);CHKERRQ(ierr);
+    ierr = PetscSFBcastAndOpMultipleBegin(sf,MPIU_INT,k,(const void*const*)rootdata,(void*const*)leafdata,op);CHKERRQ(ierr);
+    ierr = PetscSFBcastAndOpMultipleEnd(sf,MPIU_INT,k,(const void*const*)rootdata,(void*const*)leafdata,op);CHKERRQ(ierr);
+    ierr = GetMessageCount(&ct[1]);CHKERRQ(ierr);
+    for (a=0,nerr=0; a<k; a++) {
+      for (i=0; i<nleafspace; i++) leafref[i] = -(i+a);
+      ierr = PetscSFBcastAndOpBegin(sf,MPIU_INT,rootdata[a],leafref,op);CHKERRQ(ierr);
+      ierr = PetscSFBcastAndOpEnd(sf,MPIU_INT,rootdata[a],leafref,op);CHKERRQ(ierr);
+      for (i=0; i<nleafspace; i++) if (leafref[i] != leafdata[a][i]) nerr++;
+    }
+    ierr = GetMessageCount(&ct[2]);CHKERRQ(ierr);
+    ierr = MPIU_Allreduce(MPI_IN_PLACE,&nerr,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Broadcast with %s: leaf arrays equal %s, messages batched %D, one array at a time %D\n",j ? "MPI_SUM" : "MPIU_REPLACE",PetscBools[!nerr],(PetscInt)(ct[1]-ct[0]),(PetscInt)(ct[2]-ct[1]));CHKERRQ(ierr);
+  }
+
+  /* Reduce with addition, then with maximum */
+  for (j=0; j<2; j++) {
+    MPI_Op op = j ? MPI_MAX : MPI_SUM;
+
+    for (a=0; a<k; a++) {
+      for (i=0; i<nroots; i++) rootdata[a][i] = i-a;
+      for (i=0; i<nleafspace; i++) leafdata[a][i] = 10*(a+1)*rank+i;
+    }
+    ierr = GetMessageCount(&ct[0]);CHKERRQ(ierr);
+    ierr = PetscSFReduceMultipleBegin(sf,MPIU_INT,k,(const void*const*)leafdata,(void*const*)rootdata,op);CHKERRQ(ierr);
+    ierr = PetscSFReduceMultipleEnd(sf,MPIU_INT,k,(const void*const*)leafdata,(void*const*)rootdata,op);CHKERRQ(ierr);
+    ierr = GetMessageCount(&ct[1]);CHKERRQ(ierr);
+    for (a=0,nerr=0; a<k; a++) {
+      for (i=0; i<nroots; i++) rootref[i] = i-a;
+      ierr = PetscSFReduceBegin(sf,MPIU_INT,leafdata[a],rootref,op);CHKERRQ(ierr);
+      ierr = PetscSFReduceEnd(sf,MPIU_INT,leafdata[a],rootref,op);CHKERRQ(ierr);
+      for (i=0; i<nroots; i++) if (rootref[i] != rootdata[a][i]) nerr++;
+    }
+    ierr = GetMessageCount(&ct[2]);CHKERRQ(ierr);
+    ierr = MPIU_Allreduce(MPI_IN_PLACE,&nerr,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Reduction with %s: root arrays equal %s, messages batched %D, one array at a time %D\n",j ? "MPI_MAX" : "MPI_SUM",PetscBools[!nerr],(PetscInt)(ct[1]-ct[0]),(PetscInt)(ct[2]-ct[1]));CHKERRQ(ierr);
+  }
+
+  for (a=0; a<k; a++) {
+    ierr = PetscFree2(rootdata[a],leafdata[a]);CHKERRQ(ierr);
+  }
+  ierr = PetscFree2(rootdata,leafdata);CHKERRQ(ierr);
+  ierr = PetscFree2(rootref,leafref);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      requires: define(PETSC_USE_LOG)
+
+   test:
+      suffix: 2
+      nsize: 3
+      requires: define(PETSC_USE_LOG)
+      args: -k 1
+
+   test:
+      suffix: 3
+      nsize: 3
+      requires: define(PETSC_USE_LOG)
+
+   test:
+      suffix: neighbor
+      nsize: 3
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES) define(PETSC_USE_LOG)
+      args: -sf_type neighbor
+
+TEST*/
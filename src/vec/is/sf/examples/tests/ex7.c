@@ -0,0 +1,149 @@
+static char help[]= "Tests PETSCSFNODE against PETSCSFBASIC on the same graph.\n\n";
+
+#include <petscsf.h>
+
+/* The number of messages sent by all the processes so far, only counted when logging is enabled */
+static PetscErrorCode GetMessageCount(PetscLogDouble *ct)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *ct  = 0;
+#if defined(PETSC_USE_LOG)
+  ierr = MPIU_Allreduce(&petsc_isend_ct,ct,1,MPIU_PETSCLOGDOUBLE,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+#endif
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscSF        sf[2];
+  PetscSFNode    *iremote;
+  PetscInt       *ilocal;
+  PetscInt       i,j,t,bs = 3,nroots = 10,nleaves,nleafspace,nerr;
+  PetscLogDouble ct[2],nmsgs[2];
+  PetscInt       *rootdata[2],*leafdata[2],*leafupdate[2],*rootdata2[2],*leafdata2[2];
+  PetscMPIInt    rank,size;
+  MPI_Datatype   unit;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nroots",&nroots,NULL);CHKERRQ(ierr);
+
+  /* Leaves in a sparse leaf space on a varying set of processes, with a varying number of leaves per process */
+  nleaves    = nroots+3*rank;
+  nleafspace = 2*nleaves+1;
+  for (t=0; t<2; t++) {
+    ierr = PetscMalloc1(nleaves,&ilocal);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nleaves,&iremote);CHKERRQ(ierr);
+    for (i=0; i<nleaves; i++) {
+      ilocal[i]        = nleafspace-1-2*i;
+      iremote[i].rank  = (rank+i*i)%size;
+      iremote[i].index = (5*i+rank)%nroots;
+    }
+    ierr = PetscSFCreate(PETSC_COMM_WORLD,&sf[t]);CHKERRQ(ierr);
+    ierr = PetscSFSetType(sf[t],t ? PETSCSFNODE : PETSCSFBASIC);CHKERRQ(ierr);
+    if (t) {ierr = PetscSFSetFromOptions(sf[t]);CHKERRQ(ierr);}
+    ierr = PetscSFSetGraph(sf[t],nroots,nleaves,ilocal,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+    ierr = PetscSFSetUp(sf[t]);CHKERRQ(ierr);
+    ierr = PetscMalloc3(nroots*bs,&rootdata[t],nleafspace*bs,&leafdata[t],nleafspace,&leafupdate[t]);CHKERRQ(ierr);
+    ierr = PetscMalloc2(nroots,&rootdata2[t],nleafspace,&leafdata2[t]);CHKERRQ(ierr);
+  }
+  ierr = MPI_Type_contiguous(bs,MPIU_INT,&unit);CHKERRQ(ierr);
+  ierr = MPI_Type_commit(&unit);CHKERRQ(ierr);
+
+  /*
+     The messages sent by each type are counted; PETSCSFNODE sends one message per pair of nodes instead of one per
+     pair of ranks, and none when all the ranks are on one node, except for fetch-and-op which takes the point-to-point
+     path of PETSCSFBASIC
+  */
+  for (t=0; t<2; t++) {
+    /* Broadcast with replacement and addition, the second one on a block type and overlapped with the first one */
+    ierr = GetMessageCount(&ct[0]);CHKERRQ(ierr);
+    for (i=0; i<nroots; i++) rootdata2[t][i] = 1000*rank+i;
+    for (i=0; i<nleafspace; i++) leafdata2[t][i] = -i;
+    for (i=0; i<nroots*bs; i++) rootdata[t][i] = 100*rank+i;
+    for (i=0; i<nleafspace*bs; i++) leafdata[t][i] = i;
+    ierr = PetscSFBcastBegin(sf[t],MPIU_INT,rootdata2[t],leafdata2[t]);CHKERRQ(ierr);
+    ierr = PetscSFBcastAndOpBegin(sf[t],unit,rootdata[t],leafdata[t],MPI_SUM);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sf[t],MPIU_INT,rootdata2[t],leafdata2[t]);CHKERRQ(ierr);
+    ierr = PetscSFBcastAndOpEnd(sf[t],unit,rootdata[t],leafdata[t],MPI_SUM);CHKERRQ(ierr);
+    ierr = GetMessageCount(&ct[1]);CHKERRQ(ierr);
+    nmsgs[t] = ct[1]-ct[0];
+  }
+  nerr = 0;
+  for (i=0; i<nleafspace; i++) if (leafdata2[0][i] != leafdata2[1][i]) nerr++;
+  for (i=0; i<nleafspace*bs; i++) if (leafdata[0][i] != leafdata[1][i]) nerr++;
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&nerr,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Broadcasts: leaf data equal %s, messages basic %D, node %D\n",PetscBools[!nerr],(PetscInt)nmsgs[0],(PetscInt)nmsgs[1]);CHKERRQ(ierr);
+
+  /* Reduce with addition, then with maximum, repeatedly to reuse the communication buffers */
+  for (j=0,nerr=0,nmsgs[0]=nmsgs[1]=0; j<4; j++) {
+    MPI_Op op = (j%2) ? MPI_MAX : MPI_SUM;
+
+    for (t=0; t<2; t++) {
+      ierr = GetMessageCount(&ct[0]);CHKERRQ(ierr);
+      for (i=0; i<nroots; i++) rootdata2[t][i] = i+j;
+      for (i=0; i<nleafspace; i++) leafdata2[t][i] = 10*rank+((i*7+j)%13);
+      ierr = PetscSFReduceBegin(sf[t],MPIU_INT,leafdata2[t],rootdata2[t],op);CHKERRQ(ierr);
+      ierr = PetscSFReduceEnd(sf[t],MPIU_INT,leafdata2[t],rootdata2[t],op);CHKERRQ(ierr);
+      ierr = GetMessageCount(&ct[1]);CHKERRQ(ierr);
+      nmsgs[t] += ct[1]-ct[0];
+    }
+    for (i=0; i<nroots; i++) if (rootdata2[0][i] != rootdata2[1][i]) nerr++;
+  }
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&nerr,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Reductions: root data equal %s, messages basic %D, node %D\n",PetscBools[!nerr],(PetscInt)nmsgs[0],(PetscInt)nmsgs[1]);CHKERRQ(ierr);
+
+  /* Fetch and add; the leaf updates depend on the order the leaves are processed, but their sums do not */
+  for (t=0; t<2; t++) {
+    for (i=0; i<nroots; i++) rootdata2[t][i] = i;
+    for (i=0; i<nleafspace; i++) {leafdata2[t][i] = rank+i; leafupdate[t][i] = 0;}
+    ierr = GetMessageCount(&ct[0]);CHKERRQ(ierr);
+    ierr = PetscSFFetchAndOpBegin(sf[t],MPIU_INT,rootdata2[t],leafdata2[t],leafupdate[t],MPI_SUM);CHKERRQ(ierr);
+    ierr = PetscSFFetchAndOpEnd(sf[t],MPIU_INT,rootdata2[t],leafdata2[t],leafupdate[t],MPI_SUM);CHKERRQ(ierr);
+    ierr = GetMessageCount(&ct[1]);CHKERRQ(ierr);
+    nmsgs[t] = ct[1]-ct[0];
+  }
+  nerr = 0;
+  for (i=0; i<nroots; i++) if (rootdata2[0][i] != rootdata2[1][i]) nerr++;
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&nerr,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Fetch and add: root data equal %s, messages basic %D, node %D\n",PetscBools[!nerr],(PetscInt)nmsgs[0],(PetscInt)nmsgs[1]);CHKERRQ(ierr);
+
+  ierr = MPI_Type_free(&unit);CHKERRQ(ierr);
+  for (t=0; t<2; t++) {
+    ierr = PetscFree3(rootdata[t],leafdata[t],leafupdate[t]);CHKERRQ(ierr);
+    ierr = PetscFree2(rootdata2[t],leafdata2[t]);CHKERRQ(ierr);
+    ierr = PetscSFDestroy(&sf[t]);CHKERRQ(ierr);
+  }
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) define(PETSC_USE_LOG)
+
+   test:
+      suffix: node0
+      nsize: 4
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) define(PETSC_USE_LOG)
+      args: -sf_node_size 0
+
+   test:
+      suffix: node1
+      nsize: 4
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) define(PETSC_USE_LOG)
+      args: -sf_node_size 1
+
+   test:
+      suffix: node3
+      nsize: 4
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY) define(PETSC_USE_LOG)
+      args: -sf_node_size 3
+
+TEST*/
@@ -0,0 +1,144 @@
+static char help[]= "Tests PETSCSFBASIC communicating contiguous and strided roots and leaves in place against packing them.\n\n";
+
+#include <petscsf.h>
+
+/* Are the n entries of a[] and b[] equal on all the processes? */
+static PetscErrorCode CheckEqual(PetscInt n,const PetscInt *a,const PetscInt *b,PetscBool *flg)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,nerr = 0;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) if (a[i] != b[i]) nerr++;
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&nerr,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  *flg = nerr ? PETSC_FALSE : PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscSF        sf[2];
+  PetscSFNode    *iremote;
+  PetscInt       *ilocal;
+  PetscInt       i,j,k,r,t,n = 20,rstride = 1,lstride = 1,bs = 2,nroots,nleaves,nleafspace,ninplace;
+  PetscInt       *rootdata[2],*leafdata[2],*rootbdata[2],*leafbdata[2],*inplace[2];
+  PetscMPIInt    rank,size,any;
+  PetscBool      flg[2];
+  MPI_Datatype   unit;
+  MPI_Op         ops[2] = {MPIU_REPLACE,MPI_SUM};
+  const char     *opnames[2] = {"MPIU_REPLACE","MPI_SUM"};
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-root_stride",&rstride,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-leaf_stride",&lstride,NULL);CHKERRQ(ierr);
+
+  /* The leaves of rank r are connected to a run of n roots on rank r with stride rstride, and they are a run with stride
+     lstride themselves, the second SF packs everything as a reference */
+  nroots     = rstride*n+2;
+  nleaves    = size*n;
+  nleafspace = lstride*nleaves+1;
+  ninplace   = PetscMax(nroots,nleafspace);
+  ierr = MPI_Type_contiguous(bs,MPIU_INT,&unit);CHKERRQ(ierr);
+  ierr = MPI_Type_commit(&unit);CHKERRQ(ierr);
+  for (t=0; t<2; t++) {
+    ierr = PetscMalloc1(nleaves,&ilocal);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nleaves,&iremote);CHKERRQ(ierr);
+    for (r=0; r<size; r++) {
+      for (k=0; k<n; k++) {
+        i                = r*n+k;
+        ilocal[i]        = lstride*i+1;
+        iremote[i].rank  = (rank+r)%size;
+        iremote[i].index = ((r+1)%2)+rstride*k;
+      }
+    }
+    ierr = PetscSFCreate(PETSC_COMM_WORLD,&sf[t]);CHKERRQ(ierr);
+    ierr = PetscSFSetType(sf[t],PETSCSFBASIC);CHKERRQ(ierr);
+    if (t) {ierr = PetscObjectSetOptionsPrefix((PetscObject)sf[t],"ref_");CHKERRQ(ierr);}
+    ierr = PetscSFSetFromOptions(sf[t]);CHKERRQ(ierr);
+    ierr = PetscSFSetGraph(sf[t],nroots,nleaves,ilocal,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+    ierr = PetscSFSetUp(sf[t]);CHKERRQ(ierr);
+    ierr = PetscSFViewFromOptions(sf[t],NULL,"-sf_view");CHKERRQ(ierr);
+    ierr = PetscMalloc5(nroots,&rootdata[t],nleafspace,&leafdata[t],bs*nroots,&rootbdata[t],bs*nleafspace,&leafbdata[t],ninplace,&inplace[t]);CHKERRQ(ierr);
+  }
+
+  /* Broadcast and reduce with replacement and addition, repeatedly so that in-place requests are reused */
+  for (j=0; j<4; j++) {
+    MPI_Op op = ops[j%2];
+
+    for (t=0; t<2; t++) {
+      for (i=0; i<nroots; i++) rootdata[t][i] = 100*rank+i+j;
+      for (i=0; i<nleafspace; i++) leafdata[t][i] = -i;
+      for (i=0; i<bs*nroots; i++) rootbdata[t][i] = 1000*rank+i;
+      for (i=0; i<bs*nleafspace; i++) leafbdata[t][i] = i+j;
+      ierr = PetscSFBcastAndOpBegin(sf[t],MPIU_INT,rootdata[t],leafdata[t],op);CHKERRQ(ierr);
+      ierr = PetscSFBcastAndOpEnd(sf[t],MPIU_INT,rootdata[t],leafdata[t],op);CHKERRQ(ierr);
+      ierr = PetscSFReduceBegin(sf[t],unit,leafbdata[t],rootbdata[t],op);CHKERRQ(ierr);
+      ierr = PetscSFReduceEnd(sf[t],unit,leafbdata[t],rootbdata[t],op);CHKERRQ(ierr);
+    }
+    ierr = CheckEqual(nleafspace,leafdata[0],leafdata[1],&flg[0]);CHKERRQ(ierr);
+    ierr = CheckEqual(bs*nroots,rootbdata[0],rootbdata[1],&flg[1]);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Pass %D with %s: broadcast leaves equal %s, reduced block roots equal %s\n",j,opnames[j%2],PetscBools[flg[0]],PetscBools[flg[1]]);CHKERRQ(ierr);
+  }
+
+  /* Broadcast with the leaves of each rank unpacked as they arrive */
+  for (t=0; t<2; t++) {
+    for (i=0; i<nroots; i++) rootdata[t][i] = 7*rank+i;
+    for (i=0; i<nleafspace; i++) leafdata[t][i] = -1;
+    ierr = PetscSFBcastAndOpBegin(sf[t],MPIU_INT,rootdata[t],leafdata[t],MPIU_REPLACE);CHKERRQ(ierr);
+    do {
+      ierr = PetscSFBcastAndOpEndAny(sf[t],MPIU_INT,rootdata[t],leafdata[t],MPIU_REPLACE,&any);CHKERRQ(ierr);
+    } while (any != MPI_UNDEFINED);
+  }
+  ierr = CheckEqual(nleafspace,leafdata[0],leafdata[1],&flg[0]);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Broadcast unpacked as the leaves arrive: leaves equal %s\n",PetscBools[flg[0]]);CHKERRQ(ierr);
+
+  /* Broadcast and reduce with rootdata and leafdata in the same array, where the local leaves are their own roots when
+     the strides are equal */
+  for (j=0; j<2; j++) {
+    for (t=0; t<2; t++) {
+      for (i=0; i<ninplace; i++) inplace[t][i] = 10*rank+i;
+      if (j) {
+        ierr = PetscSFReduceBegin(sf[t],MPIU_INT,inplace[t],inplace[t],MPI_SUM);CHKERRQ(ierr);
+        ierr = PetscSFReduceEnd(sf[t],MPIU_INT,inplace[t],inplace[t],MPI_SUM);CHKERRQ(ierr);
+      } else {
+        ierr = PetscSFBcastBegin(sf[t],MPIU_INT,inplace[t],inplace[t]);CHKERRQ(ierr);
+        ierr = PetscSFBcastEnd(sf[t],MPIU_INT,inplace[t],inplace[t]);CHKERRQ(ierr);
+      }
+    }
+    ierr = CheckEqual(ninplace,inplace[0],inplace[1],&flg[0]);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s with the roots and leaves in one array: equal %s\n",j ? "Reduction" : "Broadcast",PetscBools[flg[0]]);CHKERRQ(ierr);
+  }
+
+  ierr = MPI_Type_free(&unit);CHKERRQ(ierr);
+  for (t=0; t<2; t++) {
+    ierr = PetscFree5(rootdata[t],leafdata[t],rootbdata[t],leafbdata[t],inplace[t]);CHKERRQ(ierr);
+    ierr = PetscSFDestroy(&sf[t]);CHKERRQ(ierr);
+  }
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      nsize: {{1 2 3}}
+      args: -ref_sf_basic_direct 0 -root_stride {{1 3}} -leaf_stride {{1 2}}
+      output_file: output/ex8_1.out
+
+   # the info view shows which roots and leaves are communicated in place on each process
+   test:
+      suffix: view
+      nsize: 2
+      args: -ref_sf_basic_direct 0 -n 2 -sf_view ::ascii_info
+
+   test:
+      suffix: view_strided
+      nsize: 2
+      args: -ref_sf_basic_direct 0 -n 2 -root_stride 3 -leaf_stride 2 -sf_view ::ascii_info
+
+TEST*/
@@ -28,6 +28,7 @@ PETSC_INTERN PetscErrorCode PetscSFPackGet_Allgatherv(PetscSF sf,MPI_Datatype un
   ierr = PetscSFPackSetUp_Host(sf,link,unit);CHKERRQ(ierr);
   link->nrootreqs = 1;
   link->nleafreqs = 0;
+  link->narrays   = 1;
   ierr = PetscMalloc1(4,&link->reqs);CHKERRQ(ierr); /* 4 = (nrootreqs+nleafreqs)*4 */
   for (i=0; i<4; i++) link->reqs[i] = MPI_REQUEST_NULL; /* Initialized to NULL so that we know which need to be freed in Destroy */
 
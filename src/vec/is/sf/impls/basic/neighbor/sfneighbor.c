@@ -49,7 +49,7 @@ static PetscErrorCode PetscSFPackGet_Neighbor(PetscSF sf,MPI_Datatype unit,Petsc
   PetscErrorCode       ierr;
 
   PetscFunctionBegin;
-  ierr = PetscSFPackGet_Basic_Common(sf,unit,rootmtype,rootdata,leafmtype,leafdata,1/*nrootreqs*/,1/*nleafreqs*/,mylink);CHKERRQ(ierr);
+  ierr = PetscSFPackGet_Basic_Common(sf,unit,rootmtype,rootdata,leafmtype,leafdata,1/*nrootreqs*/,1/*nleafreqs*/,1/*narrays*/,mylink);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
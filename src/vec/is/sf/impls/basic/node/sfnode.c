@@ -0,0 +1,639 @@
+#include <../src/vec/is/sf/impls/basic/sfpack.h>
+#include <../src/vec/is/sf/impls/basic/sfbasic.h>
+
+/*@
+   PetscSFNodeSetNodeSize - Sets the number of ranks a PETSCSFNODE star forest treats as one node
+
+   Logically Collective
+
+   Input Arguments:
++  sf - star forest for communication
+-  nodesize - number of ranks sharing memory that are grouped together, or 0 to group all ranks sharing memory
+
+   Options Database Key:
+.  -sf_node_size <nodesize> - the number of ranks per node
+
+   Notes:
+   Must be called before PetscSFSetUp(). Groups smaller than the shared memory node keep the exchange within, e.g., a socket,
+   and allow exercising the off-node path on a single machine.
+
+   Level: advanced
+
+.seealso: PetscSFSetType(), PetscSFSetFromOptions()
+@*/
+PetscErrorCode PetscSFNodeSetNodeSize(PetscSF sf,PetscInt nodesize)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  PetscValidLogicalCollectiveInt(sf,nodesize,2);
+  ierr = PetscTryMethod(sf,"PetscSFNodeSetNodeSize_C",(PetscSF,PetscInt),(sf,nodesize));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+/*
+   PETSCSFNODE splits the graph built by SFBasic by the shared memory node of the peer ranks.
+
+   Each rank exposes a segment of an MPI-3 shared memory window, into which it packs its roots (Bcast) or leaves (Reduce)
+   in the same order as SFBasic, i.e., with the piece for the i-th peer starting at ioffset[i] (roffset[j] for leaves).
+   Edges between ranks of the same node are then served by unpacking directly from the segment of the peer.
+
+   Edges between ranks on different nodes are aggregated per node pair: the leader (rank 0 on the node) copies the pieces
+   of all ranks on its node destined to another node into one message, sent to the leader of that node, which receives it
+   into the trailing part of its own segment. There, the pieces are ordered by (root rank, leaf rank), which both leaders
+   can compute independently, so each rank unpacks its pieces at offsets computed once at setup.
+*/
+
+/* Communication plan of a leader, in units, for the pieces sent from (or received by) ranks on its node */
+typedef struct {
+  PetscMPIInt nmsgs;    /* Number of other nodes this node exchanges messages with */
+  PetscMPIInt *ranks;   /* Ranks (in the comm of the SF) of the leaders of these nodes */
+  PetscInt    *offset;  /* Message m is at [offset[m],offset[m+1]) in the leader's send or receive buffer */
+  PetscInt    nchunks;  /* Number of pieces, stored consecutively in the buffer */
+  PetscInt    *nrank;   /* Node rank whose segment holds the piece */
+  PetscInt    *srcoff;  /* Offset of the piece in that segment */
+  PetscInt    *count;   /* Length of the piece */
+} PetscSFNodePlan;
+
+typedef struct _n_PetscSFNodeLink *PetscSFNodeLink;
+struct _n_PetscSFNodeLink {
+  PetscSFPack     pack;           /* Provides the unit and the (un)pack kernels. Its buffers are not used */
+  MPI_Win         win;            /* Shared memory window over the node */
+  char            **base;         /* Start of the segment of each rank on the node */
+  char            *sendbuf;       /* Buffer of the leader to aggregate off-node messages */
+  MPI_Request     *reqs;          /* Requests of the leader for off-node messages */
+  PetscMPIInt     nreqs;
+  PetscMPIInt     tag;
+  const void      *rkey,*lkey;    /* rootdata and leafdata used as keys for operation */
+  PetscSFNodeLink next;
+};
+
+typedef struct {
+  SFBASICHEADER;
+  PetscInt        nodesize;      /* Number of ranks treated as a node, 0 for all ranks sharing memory */
+  MPI_Comm        ncomm;         /* Communicator of the ranks on my node */
+  PetscMPIInt     nrank,nsize;   /* My rank in ncomm and its size */
+  PetscInt        *inrank,*ioff; /* Node rank of iranks[i] (MPI_UNDEFINED if off node) and offset of its leaves in its segment or in the leader's receive buffer */
+  PetscInt        *lnrank,*loff; /* The same for the root ranks sf->ranks[j] */
+  PetscInt        segsize;       /* Length of the packing part of the segments, in units. The leader's receive buffer starts there in its segment */
+  PetscInt        recvsize;      /* Length of the receive buffer of the leader */
+  PetscSFNodePlan rplan,lplan;   /* Plans of the leader for root and leaf pieces. Bcast sends rplan and receives lplan, Reduce the other way around */
+  PetscSFNodeLink navail,ninuse;
+} PetscSF_Node;
+
+/*===================================================================================*/
+/*              Internal utility routines                                            */
+/*===================================================================================*/
+
+/* Pieces are ordered by the leader of the other node, then by root rank, then by leaf rank */
+static int PetscSFNodeCompareRecords_Private(const void *a,const void *b)
+{
+  const PetscInt *x = (const PetscInt*)a,*y = (const PetscInt*)b;
+  PetscInt       i;
+
+  for (i=0; i<3; i++) {
+    if (x[i] < y[i]) return -1;
+    if (x[i] > y[i]) return 1;
+  }
+  return 0;
+}
+
+#define NODE_RECORD 7 /* {leader of the other rank, root rank, leaf rank, node rank, offset in the segment, count, position in the gathered records} */
+
+/* Gathers the off-node pieces of the ranks on the node at the leader, which builds the plan. Every rank gets the offsets of its pieces in the leader's buffer */
+static PetscErrorCode PetscSFNodeBuildPlan_Private(PetscSF sf,PetscInt n,PetscInt *records,PetscSFNodePlan *plan,PetscInt *offsets)
+{
+  PetscErrorCode ierr;
+  PetscSF_Node   *dat = (PetscSF_Node*)sf->data;
+  PetscMPIInt    nn,*counts = NULL,*displs = NULL,*rcounts = NULL,*rdispls = NULL,p;
+  PetscInt       i,m,total = 0,*all = NULL,*alloffsets = NULL;
+
+  PetscFunctionBegin;
+  ierr = PetscMPIIntCast(n,&nn);CHKERRQ(ierr);
+  if (!dat->nrank) {ierr = PetscMalloc4(dat->nsize,&counts,dat->nsize+1,&displs,dat->nsize,&rcounts,dat->nsize,&rdispls);CHKERRQ(ierr);}
+  ierr = MPI_Gather(&nn,1,MPI_INT,counts,1,MPI_INT,0,dat->ncomm);CHKERRQ(ierr);
+  if (!dat->nrank) {
+    displs[0] = 0;
+    for (p=0; p<dat->nsize; p++) {
+      rcounts[p]  = counts[p]*NODE_RECORD;
+      rdispls[p]  = displs[p]*NODE_RECORD;
+      displs[p+1] = displs[p]+counts[p];
+    }
+    total = displs[dat->nsize];
+    ierr  = PetscMalloc2(total*NODE_RECORD,&all,total,&alloffsets);CHKERRQ(ierr);
+  }
+  ierr = MPI_Gatherv(records,nn*NODE_RECORD,MPIU_INT,all,rcounts,rdispls,MPIU_INT,0,dat->ncomm);CHKERRQ(ierr);
+
+  if (!dat->nrank) {
+    for (i=0; i<total; i++) all[i*NODE_RECORD+6] = i;
+    if (total) qsort(all,total,NODE_RECORD*sizeof(PetscInt),PetscSFNodeCompareRecords_Private);
+    for (i=0,plan->nmsgs=0; i<total; i++) if (!i || all[i*NODE_RECORD] != all[(i-1)*NODE_RECORD]) plan->nmsgs++;
+    plan->nchunks = total;
+    ierr = PetscMalloc2(plan->nmsgs,&plan->ranks,plan->nmsgs+1,&plan->offset);CHKERRQ(ierr);
+    ierr = PetscMalloc3(total,&plan->nrank,total,&plan->srcoff,total,&plan->count);CHKERRQ(ierr);
+    plan->offset[0] = 0;
+    for (i=0,m=-1; i<total; i++) {
+      const PetscInt *r = all+i*NODE_RECORD;
+      if (!i || r[0] != r[-NODE_RECORD]) {
+        m++;
+        ierr = PetscMPIIntCast(r[0],&plan->ranks[m]);CHKERRQ(ierr);
+        plan->offset[m+1] = plan->offset[m];
+      }
+      alloffsets[r[6]]   = plan->offset[m+1];
+      plan->nrank[i]     = r[3];
+      plan->srcoff[i]    = r[4];
+      plan->count[i]     = r[5];
+      plan->offset[m+1] += r[5];
+    }
+  }
+  ierr = MPI_Scatterv(alloffsets,counts,displs,MPIU_INT,offsets,nn,MPIU_INT,0,dat->ncomm);CHKERRQ(ierr);
+  if (!dat->nrank) {
+    ierr = PetscFree2(all,alloffsets);CHKERRQ(ierr);
+    ierr = PetscFree4(counts,displs,rcounts,rdispls);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFNodeDestroyPlan_Private(PetscSFNodePlan *plan)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree2(plan->ranks,plan->offset);CHKERRQ(ierr);
+  ierr = PetscFree3(plan->nrank,plan->srcoff,plan->count);CHKERRQ(ierr);
+  ierr = PetscMemzero(plan,sizeof(PetscSFNodePlan));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Make stores of the ranks on the node visible to each other */
+static PetscErrorCode PetscSFNodeSync_Private(PetscSF sf,PetscSFNodeLink link)
+{
+  PetscErrorCode ierr;
+  PetscSF_Node   *dat = (PetscSF_Node*)sf->data;
+
+  PetscFunctionBegin;
+  ierr = MPI_Win_sync(link->win);CHKERRQ(ierr);
+  ierr = MPI_Barrier(dat->ncomm);CHKERRQ(ierr);
+  ierr = MPI_Win_sync(link->win);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Links are created collectively on the node; since SF operations are collective, all ranks take the same link */
+static PetscErrorCode PetscSFNodeLinkGet_Private(PetscSF sf,MPI_Datatype unit,const void *rkey,const void *lkey,PetscSFNodeLink *mylink)
+{
+  PetscErrorCode  ierr;
+  PetscSF_Node    *dat = (PetscSF_Node*)sf->data;
+  PetscSFNodeLink link,*p;
+  PetscBool       match;
+  MPI_Aint        size;
+  PetscMPIInt     i,dispunit,nreqs;
+  char            *mybase;
+  size_t          ub;
+
+  PetscFunctionBegin;
+  for (p=&dat->navail; (link=*p); p=&link->next) {
+    ierr = MPIPetsc_Type_compare(unit,link->pack->unit,&match);CHKERRQ(ierr);
+    if (match) {*p = link->next; goto found;}
+  }
+  ierr = PetscNew(&link);CHKERRQ(ierr);
+  ierr = PetscNew(&link->pack);CHKERRQ(ierr);
+  ierr = PetscSFPackSetUp_Host(sf,link->pack,unit);CHKERRQ(ierr);
+  ierr = PetscCommGetNewTag(PetscObjectComm((PetscObject)sf),&link->tag);CHKERRQ(ierr);
+  ub   = link->pack->unitbytes;
+  size = (MPI_Aint)((dat->segsize+(dat->nrank ? 0 : dat->recvsize))*ub);
+  ierr = MPI_Win_allocate_shared(size,1,MPI_INFO_NULL,dat->ncomm,&mybase,&link->win);CHKERRQ(ierr);
+  ierr = PetscMalloc1(dat->nsize,&link->base);CHKERRQ(ierr);
+  for (i=0; i<dat->nsize; i++) {ierr = MPI_Win_shared_query(link->win,i,&size,&dispunit,&link->base[i]);CHKERRQ(ierr);}
+  ierr = MPI_Win_lock_all(MPI_MODE_NOCHECK,link->win);CHKERRQ(ierr);
+  if (!dat->nrank) {
+    ierr = PetscMPIIntCast(dat->rplan.nmsgs+dat->lplan.nmsgs,&nreqs);CHKERRQ(ierr);
+    ierr = PetscMalloc1(dat->recvsize*ub,&link->sendbuf);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nreqs,&link->reqs);CHKERRQ(ierr);
+  }
+
+found:
+  link->rkey  = rkey;
+  link->lkey  = lkey;
+  link->next  = dat->ninuse;
+  dat->ninuse = link;
+  *mylink     = link;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFNodeLinkGetInUse_Private(PetscSF sf,MPI_Datatype unit,const void *rkey,const void *lkey,PetscSFNodeLink *mylink)
+{
+  PetscErrorCode  ierr;
+  PetscSF_Node    *dat = (PetscSF_Node*)sf->data;
+  PetscSFNodeLink link,*p;
+  PetscBool       match;
+
+  PetscFunctionBegin;
+  for (p=&dat->ninuse; (link=*p); p=&link->next) {
+    ierr = MPIPetsc_Type_compare(unit,link->pack->unit,&match);CHKERRQ(ierr);
+    if (match && rkey == link->rkey && lkey == link->lkey) {
+      *p      = link->next;
+      *mylink = link;
+      PetscFunctionReturn(0);
+    }
+  }
+  SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Could not find link");
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFNodeLinkReclaim_Private(PetscSF sf,PetscSFNodeLink *link)
+{
+  PetscSF_Node *dat = (PetscSF_Node*)sf->data;
+
+  PetscFunctionBegin;
+  (*link)->rkey = NULL;
+  (*link)->lkey = NULL;
+  (*link)->next = dat->navail;
+  dat->navail   = *link;
+  *link         = NULL;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFNodeLinkDestroyAvailable_Private(PetscSFNodeLink *avail)
+{
+  PetscErrorCode  ierr;
+  PetscSFNodeLink link = *avail,next;
+
+  PetscFunctionBegin;
+  for (; link; link=next) {
+    next = link->next;
+    ierr = MPI_Win_unlock_all(link->win);CHKERRQ(ierr);
+    ierr = MPI_Win_free(&link->win);CHKERRQ(ierr);
+    if (!link->pack->isbuiltin) {ierr = MPI_Type_free(&link->pack->unit);CHKERRQ(ierr);}
+    ierr = PetscFree(link->pack);CHKERRQ(ierr);
+    ierr = PetscFree(link->base);CHKERRQ(ierr);
+    ierr = PetscFree(link->sendbuf);CHKERRQ(ierr);
+    ierr = PetscFree(link->reqs);CHKERRQ(ierr);
+    ierr = PetscFree(link);CHKERRQ(ierr);
+  }
+  *avail = NULL;
+  PetscFunctionReturn(0);
+}
+
+/* Packs the pieces of selected entries of data into my segment, self part first as in SFBasic */
+static PetscErrorCode PetscSFNodePack_Private(PetscSFNodeLink link,char *seg,PetscInt nself,PetscInt n,const PetscInt *idx,PetscSFPackOpt selfopt,PetscSFPackOpt opt,const void *data)
+{
+  PetscErrorCode ierr;
+  PetscErrorCode (*Pack)(PetscInt,const PetscInt*,PetscSFPack,PetscSFPackOpt,const void*,void*);
+
+  PetscFunctionBegin;
+  ierr = PetscSFPackGetPack(link->pack,PETSC_MEMTYPE_HOST,&Pack);CHKERRQ(ierr);
+  if (nself)   {ierr = (*Pack)(nself,idx,link->pack,selfopt,data,seg);CHKERRQ(ierr);}
+  if (n-nself) {ierr = (*Pack)(n-nself,idx+nself,link->pack,opt,data,seg+nself*link->pack->unitbytes);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFNodeUnpackAndOp_Private(PetscSFNodeLink link,PetscInt count,const PetscInt *idx,void *data,const char *buf,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscErrorCode (*UnpackAndOp)(PetscInt,const PetscInt*,PetscSFPack,PetscSFPackOpt,void*,const void*);
+
+  PetscFunctionBegin;
+  if (!count) PetscFunctionReturn(0);
+  ierr = PetscSFPackGetUnpackAndOp(link->pack,PETSC_MEMTYPE_HOST,op,PETSC_FALSE,&UnpackAndOp);CHKERRQ(ierr);
+  if (UnpackAndOp) {ierr = (*UnpackAndOp)(count,idx,link->pack,NULL,data,buf);CHKERRQ(ierr);}
+#if defined(PETSC_HAVE_MPI_REDUCE_LOCAL)
+  else {
+    PetscInt j;
+    for (j=0; j<count; j++) {ierr = MPI_Reduce_local(buf+j*link->pack->unitbytes,(char*)data+idx[j]*link->pack->unitbytes,1,link->pack->unit,op);CHKERRQ(ierr);}
+  }
+#else
+  else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No unpacking reduction operation for this MPI_Op");
+#endif
+  PetscFunctionReturn(0);
+}
+
+/* The leader posts the off-node receives into its receive buffer and sends the pieces of the ranks on its node, one message per node */
+static PetscErrorCode PetscSFNodeStartLeader_Private(PetscSF sf,PetscSFNodeLink link,const PetscSFNodePlan *splan,const PetscSFNodePlan *rplan)
+{
+  PetscErrorCode ierr;
+  PetscSF_Node   *dat = (PetscSF_Node*)sf->data;
+  MPI_Comm       comm = PetscObjectComm((PetscObject)sf);
+  size_t         ub = link->pack->unitbytes;
+  char           *recvbuf = link->base[0]+dat->segsize*ub;
+  PetscMPIInt    m,n;
+  PetscInt       c;
+
+  PetscFunctionBegin;
+  link->nreqs = 0;
+  for (m=0; m<rplan->nmsgs; m++) {
+    ierr = PetscMPIIntCast(rplan->offset[m+1]-rplan->offset[m],&n);CHKERRQ(ierr);
+    ierr = MPI_Irecv(recvbuf+rplan->offset[m]*ub,n,link->pack->unit,rplan->ranks[m],link->tag,comm,&link->reqs[link->nreqs++]);CHKERRQ(ierr);
+  }
+  for (c=0,m=0; c<splan->nchunks; c++) {
+    ierr = PetscMemcpy(link->sendbuf+m*ub,link->base[splan->nrank[c]]+splan->srcoff[c]*ub,splan->count[c]*ub);CHKERRQ(ierr);
+    m   += splan->count[c];
+  }
+  for (m=0; m<splan->nmsgs; m++) {
+    ierr = PetscMPIIntCast(splan->offset[m+1]-splan->offset[m],&n);CHKERRQ(ierr);
+    ierr = MPI_Isend(link->sendbuf+splan->offset[m]*ub,n,link->pack->unit,splan->ranks[m],link->tag,comm,&link->reqs[link->nreqs++]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*===================================================================================*/
+/*              Implementations of SF public APIs                                    */
+/*===================================================================================*/
+static PetscErrorCode PetscSFSetUp_Node(PetscSF sf)
+{
+  PetscErrorCode ierr;
+  PetscSF_Node   *dat = (PetscSF_Node*)sf->data;
+  MPI_Comm       comm,shmcomm;
+  PetscShmComm   pshmcomm;
+  MPI_Group      group,ngroup;
+  MPI_Request    *reqs;
+  PetscMPIInt    rank,shmrank,leader,tag[2],*peers,color;
+  PetscInt       i,j,nrootranks,nleafranks,nr,nl,*rsend,*rrecv,*lsend,*lrecv,*rrec,*lrec,*roff,*loff;
+  const PetscInt *rootoffset,*leafoffset;
+  const PetscMPIInt *rootranks,*leafranks;
+
+  PetscFunctionBegin;
+  ierr = PetscSFSetUp_Basic(sf);CHKERRQ(ierr);
+  ierr = PetscSFGetRootInfo_Basic(sf,&nrootranks,NULL,&rootranks,&rootoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscSFGetLeafInfo_Basic(sf,&nleafranks,NULL,&leafranks,&leafoffset,NULL,NULL);CHKERRQ(ierr);
+
+  /* The node communicator, split further into groups of nodesize ranks if requested */
+  comm = PetscObjectComm((PetscObject)sf);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = PetscShmCommGet(comm,&pshmcomm);CHKERRQ(ierr);
+  ierr = PetscShmCommGetMpiShmComm(pshmcomm,&shmcomm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(shmcomm,&shmrank);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(dat->nodesize > 0 ? shmrank/dat->nodesize : 0,&color);CHKERRQ(ierr);
+  ierr = MPI_Comm_split(shmcomm,color,shmrank,&dat->ncomm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(dat->ncomm,&dat->nrank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(dat->ncomm,&dat->nsize);CHKERRQ(ierr);
+  leader = rank;
+  ierr = MPI_Bcast(&leader,1,MPI_INT,0,dat->ncomm);CHKERRQ(ierr);
+
+  /* Node ranks of the peers, MPI_UNDEFINED for peers on other nodes */
+  ierr = PetscMalloc4(nrootranks,&dat->inrank,nrootranks,&dat->ioff,nleafranks,&dat->lnrank,nleafranks,&dat->loff);CHKERRQ(ierr);
+  ierr = PetscMalloc1(PetscMax(nrootranks,nleafranks),&peers);CHKERRQ(ierr);
+  ierr = MPI_Comm_group(comm,&group);CHKERRQ(ierr);
+  ierr = MPI_Comm_group(dat->ncomm,&ngroup);CHKERRQ(ierr);
+  ierr = MPI_Group_translate_ranks(group,(PetscMPIInt)nrootranks,(PetscMPIInt*)rootranks,ngroup,peers);CHKERRQ(ierr);
+  for (i=0; i<nrootranks; i++) dat->inrank[i] = peers[i];
+  ierr = MPI_Group_translate_ranks(group,(PetscMPIInt)nleafranks,(PetscMPIInt*)leafranks,ngroup,peers);CHKERRQ(ierr);
+  for (j=0; j<nleafranks; j++) dat->lnrank[j] = peers[j];
+  ierr = MPI_Group_free(&group);CHKERRQ(ierr);
+  ierr = MPI_Group_free(&ngroup);CHKERRQ(ierr);
+  ierr = PetscFree(peers);CHKERRQ(ierr);
+
+  /* Roots and leaves exchange their leaders and where their pieces for each other start in their segments */
+  ierr = PetscMalloc4(2*nrootranks,&rsend,2*nrootranks,&rrecv,2*nleafranks,&lsend,2*nleafranks,&lrecv);CHKERRQ(ierr);
+  ierr = PetscMalloc1(2*(nrootranks+nleafranks),&reqs);CHKERRQ(ierr);
+  ierr = PetscCommGetNewTag(comm,&tag[0]);CHKERRQ(ierr);
+  ierr = PetscCommGetNewTag(comm,&tag[1]);CHKERRQ(ierr);
+  for (i=0; i<nrootranks; i++) {
+    rsend[2*i] = leader; rsend[2*i+1] = rootoffset[i];
+    ierr = MPI_Irecv(rrecv+2*i,2,MPIU_INT,rootranks[i],tag[1],comm,&reqs[2*i]);CHKERRQ(ierr);
+    ierr = MPI_Isend(rsend+2*i,2,MPIU_INT,rootranks[i],tag[0],comm,&reqs[2*i+1]);CHKERRQ(ierr);
+  }
+  for (j=0; j<nleafranks; j++) {
+    lsend[2*j] = leader; lsend[2*j+1] = leafoffset[j];
+    ierr = MPI_Irecv(lrecv+2*j,2,MPIU_INT,leafranks[j],tag[0],comm,&reqs[2*(nrootranks+j)]);CHKERRQ(ierr);
+    ierr = MPI_Isend(lsend+2*j,2,MPIU_INT,leafranks[j],tag[1],comm,&reqs[2*(nrootranks+j)+1]);CHKERRQ(ierr);
+  }
+  ierr = MPI_Waitall(2*(nrootranks+nleafranks),reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  ierr = PetscFree(reqs);CHKERRQ(ierr);
+
+  /* Pieces with peers on the node are read from their segments; the others go through the leaders */
+  for (i=0,nr=0; i<nrootranks; i++) {if (dat->inrank[i] != MPI_UNDEFINED) dat->ioff[i] = rrecv[2*i+1]; else nr++;}
+  for (j=0,nl=0; j<nleafranks; j++) {if (dat->lnrank[j] != MPI_UNDEFINED) dat->loff[j] = lrecv[2*j+1]; else nl++;}
+  ierr = PetscMalloc4(nr*NODE_RECORD,&rrec,nl*NODE_RECORD,&lrec,nr,&roff,nl,&loff);CHKERRQ(ierr);
+  for (i=0,nr=0; i<nrootranks; i++) {
+    if (dat->inrank[i] != MPI_UNDEFINED) continue;
+    rrec[nr*NODE_RECORD+0] = rrecv[2*i];
+    rrec[nr*NODE_RECORD+1] = rank;
+    rrec[nr*NODE_RECORD+2] = rootranks[i];
+    rrec[nr*NODE_RECORD+3] = dat->nrank;
+    rrec[nr*NODE_RECORD+4] = rootoffset[i];
+    rrec[nr*NODE_RECORD+5] = rootoffset[i+1]-rootoffset[i];
+    rrec[nr*NODE_RECORD+6] = 0;
+    nr++;
+  }
+  for (j=0,nl=0; j<nleafranks; j++) {
+    if (dat->lnrank[j] != MPI_UNDEFINED) continue;
+    lrec[nl*NODE_RECORD+0] = lrecv[2*j];
+    lrec[nl*NODE_RECORD+1] = leafranks[j];
+    lrec[nl*NODE_RECORD+2] = rank;
+    lrec[nl*NODE_RECORD+3] = dat->nrank;
+    lrec[nl*NODE_RECORD+4] = leafoffset[j];
+    lrec[nl*NODE_RECORD+5] = leafoffset[j+1]-leafoffset[j];
+    lrec[nl*NODE_RECORD+6] = 0;
+    nl++;
+  }
+  ierr = PetscSFNodeBuildPlan_Private(sf,nr,rrec,&dat->rplan,roff);CHKERRQ(ierr);
+  ierr = PetscSFNodeBuildPlan_Private(sf,nl,lrec,&dat->lplan,loff);CHKERRQ(ierr);
+  for (i=0,nr=0; i<nrootranks; i++) if (dat->inrank[i] == MPI_UNDEFINED) dat->ioff[i] = roff[nr++];
+  for (j=0,nl=0; j<nleafranks; j++) if (dat->lnrank[j] == MPI_UNDEFINED) dat->loff[j] = loff[nl++];
+  ierr = PetscFree4(rrec,lrec,roff,loff);CHKERRQ(ierr);
+  ierr = PetscFree4(rsend,rrecv,lsend,lrecv);CHKERRQ(ierr);
+
+  /* Segments, all of the same length, hold either the packed roots or the packed leaves; the leader's receive buffer follows its segment */
+  dat->segsize = PetscMax(rootoffset[nrootranks],leafoffset[nleafranks]);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&dat->segsize,1,MPIU_INT,MPI_MAX,dat->ncomm);CHKERRQ(ierr);
+  if (!dat->nrank) dat->recvsize = PetscMax(dat->rplan.offset[dat->rplan.nmsgs],dat->lplan.offset[dat->lplan.nmsgs]);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReset_Node(PetscSF sf)
+{
+  PetscErrorCode ierr;
+  PetscSF_Node   *dat = (PetscSF_Node*)sf->data;
+
+  PetscFunctionBegin;
+  if (dat->ninuse) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Outstanding operation has not been completed");
+  ierr = PetscSFNodeLinkDestroyAvailable_Private(&dat->navail);CHKERRQ(ierr);
+  ierr = PetscSFNodeDestroyPlan_Private(&dat->rplan);CHKERRQ(ierr);
+  ierr = PetscSFNodeDestroyPlan_Private(&dat->lplan);CHKERRQ(ierr);
+  ierr = PetscFree4(dat->inrank,dat->ioff,dat->lnrank,dat->loff);CHKERRQ(ierr);
+  if (dat->ncomm != MPI_COMM_NULL) {ierr = MPI_Comm_free(&dat->ncomm);CHKERRQ(ierr);}
+  dat->segsize  = 0;
+  dat->recvsize = 0;
+  ierr = PetscSFReset_Basic(sf);CHKERRQ(ierr); /* Common part */
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFDestroy_Node(PetscSF sf)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReset_Node(sf);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)sf,"PetscSFNodeSetNodeSize_C",NULL);CHKERRQ(ierr);
+  ierr = PetscFree(sf->data);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFSetFromOptions_Node(PetscOptionItems *PetscOptionsObject,PetscSF sf)
+{
+  PetscErrorCode ierr;
+  PetscSF_Node   *dat = (PetscSF_Node*)sf->data;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"PetscSF Node options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-sf_node_size","Number of ranks sharing memory treated as one node, 0 for all of them","PetscSFNodeSetNodeSize",dat->nodesize,&dat->nodesize,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFView_Node(PetscSF sf,PetscViewer viewer)
+{
+  PetscErrorCode ierr;
+  PetscSF_Node   *dat = (PetscSF_Node*)sf->data;
+  PetscBool      iascii;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii && sf->setupcalled) {ierr = PetscViewerASCIIPrintf(viewer,"  ranks per node %d\n",dat->nsize);CHKERRQ(ierr);}
+  ierr = PetscSFView_Basic(sf,viewer);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFDuplicate_Node(PetscSF sf,PetscSFDuplicateOption opt,PetscSF newsf)
+{
+  PetscErrorCode ierr;
+  PetscSF_Node   *dat = (PetscSF_Node*)sf->data;
+
+  PetscFunctionBegin;
+  ierr = PetscSFNodeSetNodeSize(newsf,dat->nodesize);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpBegin_Node(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,void *leafdata,MPI_Op op)
+{
+  PetscErrorCode  ierr;
+  PetscSF_Node    *dat = (PetscSF_Node*)sf->data;
+  PetscSFNodeLink link;
+
+  PetscFunctionBegin;
+  if (rootmtype != PETSC_MEMTYPE_HOST || leafmtype != PETSC_MEMTYPE_HOST) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_SUP,"PETSCSFNODE only supports data in host memory");
+  ierr = PetscSFNodeLinkGet_Private(sf,unit,rootdata,leafdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFNodePack_Private(link,link->base[dat->nrank],dat->ioffset[dat->ndiranks],dat->ioffset[dat->niranks],dat->irootloc,dat->selfrootpackopt,dat->rootpackopt,rootdata);CHKERRQ(ierr);
+  ierr = PetscSFNodeSync_Private(sf,link);CHKERRQ(ierr);
+  if (!dat->nrank) {ierr = PetscSFNodeStartLeader_Private(sf,link,&dat->rplan,&dat->lplan);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpEnd_Node(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,void *leafdata,MPI_Op op)
+{
+  PetscErrorCode  ierr;
+  PetscSF_Node    *dat = (PetscSF_Node*)sf->data;
+  PetscSFNodeLink link;
+  PetscInt        j;
+  size_t          ub;
+  const char      *buf;
+
+  PetscFunctionBegin;
+  ierr = PetscSFNodeLinkGetInUse_Private(sf,unit,rootdata,leafdata,&link);CHKERRQ(ierr);
+  if (!dat->nrank) {ierr = MPI_Waitall(link->nreqs,link->reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);}
+  ierr = PetscSFNodeSync_Private(sf,link);CHKERRQ(ierr);
+  ub   = link->pack->unitbytes;
+  for (j=0; j<sf->nranks; j++) {
+    if (dat->lnrank[j] != MPI_UNDEFINED) buf = link->base[dat->lnrank[j]]+dat->loff[j]*ub;
+    else buf = link->base[0]+(dat->segsize+dat->loff[j])*ub;
+    ierr = PetscSFNodeUnpackAndOp_Private(link,sf->roffset[j+1]-sf->roffset[j],sf->rmine+sf->roffset[j],leafdata,buf,op);CHKERRQ(ierr);
+  }
+  /* Nobody may overwrite the segments before all ranks on the node are done reading them */
+  ierr = PetscSFNodeSync_Private(sf,link);CHKERRQ(ierr);
+  ierr = PetscSFNodeLinkReclaim_Private(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceBegin_Node(PetscSF sf,MPI_Datatype unit,PetscMemType leafmtype,const void *leafdata,PetscMemType rootmtype,void *rootdata,MPI_Op op)
+{
+  PetscErrorCode  ierr;
+  PetscSF_Node    *dat = (PetscSF_Node*)sf->data;
+  PetscSFNodeLink link;
+
+  PetscFunctionBegin;
+  if (rootmtype != PETSC_MEMTYPE_HOST || leafmtype != PETSC_MEMTYPE_HOST) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_SUP,"PETSCSFNODE only supports data in host memory");
+  ierr = PetscSFNodeLinkGet_Private(sf,unit,rootdata,leafdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFNodePack_Private(link,link->base[dat->nrank],sf->roffset[sf->ndranks],sf->roffset[sf->nranks],sf->rmine,sf->selfleafpackopt,sf->leafpackopt,leafdata);CHKERRQ(ierr);
+  ierr = PetscSFNodeSync_Private(sf,link);CHKERRQ(ierr);
+  if (!dat->nrank) {ierr = PetscSFNodeStartLeader_Private(sf,link,&dat->lplan,&dat->rplan);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceEnd_Node(PetscSF sf,MPI_Datatype unit,PetscMemType leafmtype,const void *leafdata,PetscMemType rootmtype,void *rootdata,MPI_Op op)
+{
+  PetscErrorCode  ierr;
+  PetscSF_Node    *dat = (PetscSF_Node*)sf->data;
+  PetscSFNodeLink link;
+  PetscInt        i;
+  size_t          ub;
+  const char      *buf;
+
+  PetscFunctionBegin;
+  ierr = PetscSFNodeLinkGetInUse_Private(sf,unit,rootdata,leafdata,&link);CHKERRQ(ierr);
+  if (!dat->nrank) {ierr = MPI_Waitall(link->nreqs,link->reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);}
+  ierr = PetscSFNodeSync_Private(sf,link);CHKERRQ(ierr);
+  ub   = link->pack->unitbytes;
+  /* Pieces are reduced one rank at a time in the order of iranks[], so the result does not depend on message arrival */
+  for (i=0; i<dat->niranks; i++) {
+    if (dat->inrank[i] != MPI_UNDEFINED) buf = link->base[dat->inrank[i]]+dat->ioff[i]*ub;
+    else buf = link->base[0]+(dat->segsize+dat->ioff[i])*ub;
+    ierr = PetscSFNodeUnpackAndOp_Private(link,dat->ioffset[i+1]-dat->ioffset[i],dat->irootloc+dat->ioffset[i],rootdata,buf,op);CHKERRQ(ierr);
+  }
+  ierr = PetscSFNodeSync_Private(sf,link);CHKERRQ(ierr);
+  ierr = PetscSFNodeLinkReclaim_Private(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Fetch-and-op needs the atomic update of roots done in SFBasic, so it takes the point-to-point path */
+static PetscErrorCode PetscSFFetchAndOpBegin_Node(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,void *rootdata,PetscMemType leafmtype,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReduceBegin_Basic(sf,unit,leafmtype,leafdata,rootmtype,rootdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFNodeSetNodeSize_Node(PetscSF sf,PetscInt nodesize)
+{
+  PetscSF_Node *dat = (PetscSF_Node*)sf->data;
+
+  PetscFunctionBegin;
+  if (sf->setupcalled && nodesize != dat->nodesize) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Cannot change the node size after PetscSFSetUp()");
+  dat->nodesize = nodesize;
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode PetscSFCreate_Node(PetscSF sf)
+{
+  PetscErrorCode ierr;
+  PetscSF_Node   *dat;
+
+  PetscFunctionBegin;
+  sf->ops->CreateEmbeddedSF     = PetscSFCreateEmbeddedSF_Basic;
+  sf->ops->CreateEmbeddedLeafSF = PetscSFCreateEmbeddedLeafSF_Basic;
+  sf->ops->FetchAndOpEnd        = PetscSFFetchAndOpEnd_Basic;
+  sf->ops->GetLeafRanks         = PetscSFGetLeafRanks_Basic;
+
+  sf->ops->SetUp                = PetscSFSetUp_Node;
+  sf->ops->SetFromOptions       = PetscSFSetFromOptions_Node;
+  sf->ops->Reset                = PetscSFReset_Node;
+  sf->ops->Destroy              = PetscSFDestroy_Node;
+  sf->ops->View                 = PetscSFView_Node;
+  sf->ops->Duplicate            = PetscSFDuplicate_Node;
+  sf->ops->BcastAndOpBegin      = PetscSFBcastAndOpBegin_Node;
+  sf->ops->BcastAndOpEnd        = PetscSFBcastAndOpEnd_Node;
+  sf->ops->ReduceBegin          = PetscSFReduceBegin_Node;
+  sf->ops->ReduceEnd            = PetscSFReduceEnd_Node;
+  sf->ops->FetchAndOpBegin      = PetscSFFetchAndOpBegin_Node;
+
+  ierr = PetscNewLog(sf,&dat);CHKERRQ(ierr);
+  dat->ncomm = MPI_COMM_NULL;
+  sf->data   = (void*)dat;
+  ierr = PetscObjectComposeFunction((PetscObject)sf,"PetscSFNodeSetNodeSize_C",PetscSFNodeSetNodeSize_Node);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+#endif
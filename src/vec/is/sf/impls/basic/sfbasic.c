@@ -5,6 +5,121 @@
 /*              Internal routines for PetscSFPack                              */
 /*===================================================================================*/
 
+/* Create the datatype of an in-place message to the n entries idx[], which form a run with a constant stride. Contiguous
+   runs need no datatype other than the unit, so type is MPI_DATATYPE_NULL for them */
+static PetscErrorCode PetscSFPackCreateDirectType_Basic(PetscSFPack link,PetscInt n,const PetscInt *idx,MPI_Datatype *type)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    count,stride;
+
+  PetscFunctionBegin;
+  *type = MPI_DATATYPE_NULL;
+  if (n > 1 && idx[1]-idx[0] != 1) {
+    ierr = PetscMPIIntCast(n,&count);CHKERRQ(ierr);
+    ierr = PetscMPIIntCast(idx[1]-idx[0],&stride);CHKERRQ(ierr);
+    ierr = MPI_Type_vector(count,1,stride,link->unit,type);CHKERRQ(ierr);
+    ierr = MPI_Type_commit(type);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Return the persistent requests communicating the remote roots (leaves) in place in rootdata (leafdata), for the sides
+   the current operation does so on. The requests are bound to the data, so they are rebuilt when the data changes.
+*/
+static PetscErrorCode PetscSFPackGetDirectReqs_Basic(PetscSF sf,PetscSFPack link,PetscSFDirection direction,MPI_Request **rootreqs,MPI_Request **leafreqs)
+{
+  PetscErrorCode ierr;
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscInt       i,j,n,nreqs = link->nrootreqs+link->nleafreqs;
+  PetscMPIInt    count;
+  MPI_Comm       comm = PetscObjectComm((PetscObject)sf);
+  MPI_Datatype   type;
+  char           *buf;
+
+  PetscFunctionBegin;
+  if (!link->directreqs) {
+    ierr = PetscMalloc2(2*nreqs,&link->directreqs,nreqs,&link->directtypes);CHKERRQ(ierr);
+    for (i=0; i<2*nreqs; i++) link->directreqs[i] = MPI_REQUEST_NULL;
+    for (i=0; i<nreqs; i++) link->directtypes[i] = MPI_DATATYPE_NULL;
+    for (i=0; i<2; i++) {
+      link->rootdirectreqs[i] = link->directreqs + nreqs*i;
+      link->leafdirectreqs[i] = link->directreqs + nreqs*i + link->nrootreqs;
+    }
+    if (bas->rootdirect) {
+      for (i=bas->ndiranks,j=0; i<bas->niranks; i++,j++) {ierr = PetscSFPackCreateDirectType_Basic(link,bas->ioffset[i+1]-bas->ioffset[i],bas->irootloc+bas->ioffset[i],&link->directtypes[j]);CHKERRQ(ierr);}
+    }
+    if (bas->leafdirect) {
+      for (i=sf->ndranks,j=link->nrootreqs; i<sf->nranks; i++,j++) {ierr = PetscSFPackCreateDirectType_Basic(link,sf->roffset[i+1]-sf->roffset[i],sf->rmine+sf->roffset[i],&link->directtypes[j]);CHKERRQ(ierr);}
+    }
+  }
+
+  if (rootreqs && link->rootdirect) {
+    if (link->rootdirectdata[direction] != link->rkey) {
+      for (i=bas->ndiranks,j=0; i<bas->niranks; i++,j++) {
+        n    = bas->ioffset[i+1]-bas->ioffset[i];
+        buf  = (char*)link->rkey + (n ? bas->irootloc[bas->ioffset[i]]*link->unitbytes : 0);
+        type = link->directtypes[j] != MPI_DATATYPE_NULL ? link->directtypes[j] : link->unit;
+        ierr = PetscMPIIntCast(link->directtypes[j] != MPI_DATATYPE_NULL ? 1 : n,&count);CHKERRQ(ierr);
+        if (link->rootdirectreqs[direction][j] != MPI_REQUEST_NULL) {ierr = MPI_Request_free(&link->rootdirectreqs[direction][j]);CHKERRQ(ierr);}
+        if (direction == PETSCSF_LEAF2ROOT_REDUCE) {ierr = MPI_Recv_init(buf,count,type,bas->iranks[i],link->tag,comm,&link->rootdirectreqs[direction][j]);CHKERRQ(ierr);}
+        else {ierr = MPI_Send_init(buf,count,type,bas->iranks[i],link->tag,comm,&link->rootdirectreqs[direction][j]);CHKERRQ(ierr);}
+      }
+      link->rootdirectdata[direction] = link->rkey;
+    }
+    *rootreqs = link->rootdirectreqs[direction];
+  }
+
+  if (leafreqs && link->leafdirect) {
+    if (link->leafdirectdata[direction] != link->lkey) {
+      for (i=sf->ndranks,j=0; i<sf->nranks; i++,j++) {
+        n    = sf->roffset[i+1]-sf->roffset[i];
+        buf  = (char*)link->lkey + (n ? sf->rmine[sf->roffset[i]]*link->unitbytes : 0);
+        type = link->directtypes[link->nrootreqs+j] != MPI_DATATYPE_NULL ? link->directtypes[link->nrootreqs+j] : link->unit;
+        ierr = PetscMPIIntCast(link->directtypes[link->nrootreqs+j] != MPI_DATATYPE_NULL ? 1 : n,&count);CHKERRQ(ierr);
+        if (link->leafdirectreqs[direction][j] != MPI_REQUEST_NULL) {ierr = MPI_Request_free(&link->leafdirectreqs[direction][j]);CHKERRQ(ierr);}
+        if (direction == PETSCSF_LEAF2ROOT_REDUCE) {ierr = MPI_Send_init(buf,count,type,sf->ranks[i],link->tag,comm,&link->leafdirectreqs[direction][j]);CHKERRQ(ierr);}
+        else {ierr = MPI_Recv_init(buf,count,type,sf->ranks[i],link->tag,comm,&link->leafdirectreqs[direction][j]);CHKERRQ(ierr);}
+      }
+      link->leafdirectdata[direction] = link->lkey;
+    }
+    *leafreqs = link->leafdirectreqs[direction];
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Decide which parts of the current operation communicate in place, without packing into buffers. Remote roots (leaves)
+   are sent from the data in place when they are contiguous or strided runs for each rank, and received into the data in
+   place when, in addition, the op is a replacement and no entry is received twice. Local leaves read local roots in place
+   when the roots are one contiguous run (the leaves for a reduction), with a plain copy, or nothing at all when the two
+   runs are the same memory, for a replacement. All of this is only done on the host, when rootdata and leafdata do not
+   overlap, so that writing to leaves never changes roots still in flight.
+*/
+static PetscErrorCode PetscSFPackSetDirect_Basic(PetscSF sf,PetscSFPack link,PetscSFDirection direction,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,const void *leafdata,MPI_Op op)
+{
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  const size_t   ub = link->unitbytes;
+  PetscBool      disjoint,replace = (op == MPIU_REPLACE) ? PETSC_TRUE : PETSC_FALSE,bcast = (direction == PETSCSF_ROOT2LEAF_BCAST) ? PETSC_TRUE : PETSC_FALSE;
+  size_t         r0,r1,l0,l1;
+
+  PetscFunctionBegin;
+  link->rootdirect = link->leafdirect = link->selfdirect = PETSC_FALSE;
+  if (!bas->usedirect || rootmtype != PETSC_MEMTYPE_HOST || leafmtype != PETSC_MEMTYPE_HOST || link->narrays != 1) PetscFunctionReturn(0);
+  r0       = (size_t)rootdata;
+  r1       = r0 + sf->nroots*ub;
+  l0       = (size_t)leafdata + sf->minleaf*ub;
+  l1       = (size_t)leafdata + (sf->maxleaf+1)*ub;
+  disjoint = (!sf->nroots || sf->nleaves <= 0 || r1 <= l0 || l1 <= r0) ? PETSC_TRUE : PETSC_FALSE;
+  if (disjoint) {
+    link->rootdirect = bcast ? bas->rootdirect : (PetscBool)(bas->rootdirect && bas->rootunique && replace);
+    link->leafdirect = bcast ? (PetscBool)(bas->leafdirect && bas->leafunique && replace) : bas->leafdirect;
+  }
+  if (bas->ioffset[bas->ndiranks]) {
+    if (disjoint) link->selfdirect = bcast ? bas->selfrootcontig : bas->selfleafcontig;
+    else if (replace && bas->selfrootcontig && bas->selfleafcontig && r0+bas->irootloc[0]*ub == (size_t)leafdata+sf->rmine[0]*ub) link->selfdirect = PETSC_TRUE;
+  }
+  PetscFunctionReturn(0);
+}
+
 /* Return root and leaf MPI requests for communication in the given direction. If the requests have not been
    initialized (since we use persistent requests), then initialize them.
 */
@@ -24,14 +139,14 @@ static PetscErrorCode PetscSFPackGetReqs_Basic(PetscSF sf,PetscSFPack link,Petsc
     ierr = PetscSFGetRootInfo_Basic(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,NULL);CHKERRQ(ierr);
     if (direction == PETSCSF_LEAF2ROOT_REDUCE) {
       for (i=ndrootranks,j=0; i<nrootranks; i++,j++) {
-        disp = (rootoffset[i] - rootoffset[ndrootranks])*link->unitbytes;
-        ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
+        disp = (rootoffset[i] - rootoffset[ndrootranks])*link->narrays*link->unitbytes;
+        ierr = PetscMPIIntCast((rootoffset[i+1]-rootoffset[i])*link->narrays,&n);CHKERRQ(ierr);
         ierr = MPI_Recv_init(link->rootbuf[rootmtype]+disp,n,unit,bas->iranks[i],link->tag,comm,&link->rootreqs[direction][rootmtype][j]);CHKERRQ(ierr);
       }
     } else if (direction == PETSCSF_ROOT2LEAF_BCAST) {
       for (i=ndrootranks,j=0; i<nrootranks; i++,j++) {
-        disp = (rootoffset[i] - rootoffset[ndrootranks])*link->unitbytes;
-        ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
+        disp = (rootoffset[i] - rootoffset[ndrootranks])*link->narrays*link->unitbytes;
+        ierr = PetscMPIIntCast((rootoffset[i+1]-rootoffset[i])*link->narrays,&n);CHKERRQ(ierr);
         ierr = MPI_Send_init(link->rootbuf[rootmtype]+disp,n,unit,bas->iranks[i],link->tag,comm,&link->rootreqs[direction][rootmtype][j]);CHKERRQ(ierr);
       }
     } else SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Out-of-range PetscSFDirection = %d\n",(int)direction);
@@ -42,14 +157,14 @@ static PetscErrorCode PetscSFPackGetReqs_Basic(PetscSF sf,PetscSFPack link,Petsc
     ierr = PetscSFGetLeafInfo_Basic(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,NULL,NULL);CHKERRQ(ierr);
     if (direction == PETSCSF_LEAF2ROOT_REDUCE) {
       for (i=ndleafranks,j=0; i<nleafranks; i++,j++) {
-        disp = (leafoffset[i] - leafoffset[ndleafranks])*link->unitbytes;
-        ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
+        disp = (leafoffset[i] - leafoffset[ndleafranks])*link->narrays*link->unitbytes;
+        ierr = PetscMPIIntCast((leafoffset[i+1]-leafoffset[i])*link->narrays,&n);CHKERRQ(ierr);
         ierr = MPI_Send_init(link->leafbuf[leafmtype]+disp,n,unit,sf->ranks[i],link->tag,comm,&link->leafreqs[direction][leafmtype][j]);CHKERRQ(ierr);
       }
     } else if (direction == PETSCSF_ROOT2LEAF_BCAST) {
       for (i=ndleafranks,j=0; i<nleafranks; i++,j++) {
-        disp = (leafoffset[i] - leafoffset[ndleafranks])*link->unitbytes;
-        ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
+        disp = (leafoffset[i] - leafoffset[ndleafranks])*link->narrays*link->unitbytes;
+        ierr = PetscMPIIntCast((leafoffset[i+1]-leafoffset[i])*link->narrays,&n);CHKERRQ(ierr);
         ierr = MPI_Recv_init(link->leafbuf[leafmtype]+disp,n,unit,sf->ranks[i],link->tag,comm,&link->leafreqs[direction][leafmtype][j]);CHKERRQ(ierr);
       }
     } else SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Out-of-range PetscSFDirection = %d\n",(int)direction);
@@ -58,11 +173,12 @@ static PetscErrorCode PetscSFPackGetReqs_Basic(PetscSF sf,PetscSFPack link,Petsc
 
   if (rootreqs) *rootreqs = link->rootreqs[direction][rootmtype];
   if (leafreqs) *leafreqs = link->leafreqs[direction][leafmtype];
+  if (link->rootdirect || link->leafdirect) {ierr = PetscSFPackGetDirectReqs_Basic(sf,link,direction,rootreqs,leafreqs);CHKERRQ(ierr);}
   PetscFunctionReturn(0);
 }
 
 /* Common part shared by SFBasic and SFNeighbor based on the fact they all deal with sparse graphs. */
-PETSC_INTERN PetscErrorCode PetscSFPackGet_Basic_Common(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,const void *leafdata,PetscInt nrootreqs,PetscInt nleafreqs,PetscSFPack *mylink)
+PETSC_INTERN PetscErrorCode PetscSFPackGet_Basic_Common(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,const void *leafdata,PetscInt nrootreqs,PetscInt nleafreqs,PetscInt narrays,PetscSFPack *mylink)
 {
   PetscErrorCode    ierr;
   PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
@@ -77,7 +193,7 @@ PETSC_INTERN PetscErrorCode PetscSFPackGet_Basic_Common(PetscSF sf,MPI_Datatype
   /* Look for types in cache */
   for (p=&bas->avail; (link=*p); p=&link->next) {
     ierr = MPIPetsc_Type_compare(unit,link->unit,&match);CHKERRQ(ierr);
-    if (match) {
+    if (match && link->narrays == narrays) {
       *p = link->next; /* Remove from available list */
       goto found;
     }
@@ -90,9 +206,10 @@ PETSC_INTERN PetscErrorCode PetscSFPackGet_Basic_Common(PetscSF sf,MPI_Datatype
   ierr = PetscCommGetNewTag(PetscObjectComm((PetscObject)sf),&link->tag);CHKERRQ(ierr); /* One tag per link */
 
   /* Allocate root, leaf, self buffers, and MPI requests */
-  link->rootbuflen = rootoffset[nrootranks]-rootoffset[ndrootranks];
-  link->leafbuflen = leafoffset[nleafranks]-leafoffset[ndleafranks];
-  link->selfbuflen = rootoffset[ndrootranks]*link->unitbytes;
+  link->narrays    = narrays;
+  link->rootbuflen = (rootoffset[nrootranks]-rootoffset[ndrootranks])*narrays;
+  link->leafbuflen = (leafoffset[nleafranks]-leafoffset[ndleafranks])*narrays;
+  link->selfbuflen = rootoffset[ndrootranks]*narrays*link->unitbytes;
   link->nrootreqs  = nrootreqs;
   link->nleafreqs  = nleafreqs;
   nreqs            = (nrootreqs+nleafreqs)*4; /* Quadruple the requests since there are two communication directions and two memory types */
@@ -107,7 +224,10 @@ PETSC_INTERN PetscErrorCode PetscSFPackGet_Basic_Common(PetscSF sf,MPI_Datatype
   }
 
 found:
-  link->rootmtype = rootmtype;
+  link->rootdirect = PETSC_FALSE; /* Buffered unless the caller decides otherwise */
+  link->leafdirect = PETSC_FALSE;
+  link->selfdirect = PETSC_FALSE;
+  link->rootmtype  = rootmtype;
   link->leafmtype = leafmtype;
 #if defined(PETSC_HAVE_CUDA)
   if (rootmtype == PETSC_MEMTYPE_DEVICE || leafmtype == PETSC_MEMTYPE_DEVICE) {ierr = PetscSFPackSetUp_Device(sf,link,unit);CHKERRQ(ierr);}
@@ -133,7 +253,54 @@ static PetscErrorCode PetscSFPackGet_Basic(PetscSF sf,MPI_Datatype unit,PetscMem
   PetscFunctionBegin;
   ierr = PetscSFGetRootInfo_Basic(sf,&nrootranks,&ndrootranks,NULL,NULL,NULL);CHKERRQ(ierr);
   ierr = PetscSFGetLeafInfo_Basic(sf,&nleafranks,&ndleafranks,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
-  ierr = PetscSFPackGet_Basic_Common(sf,unit,rootmtype,rootdata,leafmtype,leafdata,nrootranks-ndrootranks,nleafranks-ndleafranks,mylink);CHKERRQ(ierr);
+  ierr = PetscSFPackGet_Basic_Common(sf,unit,rootmtype,rootdata,leafmtype,leafdata,nrootranks-ndrootranks,nleafranks-ndleafranks,1,mylink);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Are the indices idx[offset[i],offset[i+1]) of each of the n ranks a run with a constant positive stride? Of stride one,
+   when contig is PETSC_TRUE */
+static PetscErrorCode PetscSFCheckRuns_Basic(PetscInt n,const PetscInt *offset,const PetscInt *idx,PetscBool contig,PetscBool *runs)
+{
+  PetscInt i,j,step;
+
+  PetscFunctionBegin;
+  *runs = PETSC_TRUE;
+  for (i=0; i<n; i++) {
+    if (offset[i+1]-offset[i] < 2) continue;
+    step = idx[offset[i]+1]-idx[offset[i]];
+    if (step < 1 || (contig && step != 1)) {*runs = PETSC_FALSE; break;}
+    for (j=offset[i]+2; j<offset[i+1]; j++) {
+      if (idx[j]-idx[j-1] != step) {*runs = PETSC_FALSE; PetscFunctionReturn(0);}
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Find the patterns in the root and leaf indices that let messages and local copies use rootdata and leafdata in place.
+   This is the case for the contiguous or strided index sets VecScatter gets from fieldsplit, DMComposite etc., and for
+   the ghost values of a matrix-vector product, received into contiguous pieces of the local vector.
+*/
+static PetscErrorCode PetscSFSetUpDirect_Basic(PetscSF sf)
+{
+  PetscErrorCode ierr;
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscBool      dups;
+
+  PetscFunctionBegin;
+  ierr = PetscSFCheckRuns_Basic(bas->niranks-bas->ndiranks,bas->ioffset+bas->ndiranks,bas->irootloc,PETSC_FALSE,&bas->rootdirect);CHKERRQ(ierr);
+  ierr = PetscSFCheckRuns_Basic(sf->nranks-sf->ndranks,sf->roffset+sf->ndranks,sf->rmine,PETSC_FALSE,&bas->leafdirect);CHKERRQ(ierr);
+  ierr = PetscSFCheckRuns_Basic(bas->ndiranks,bas->ioffset,bas->irootloc,PETSC_TRUE,&bas->selfrootcontig);CHKERRQ(ierr);
+  ierr = PetscSFCheckRuns_Basic(sf->ndranks,sf->roffset,sf->rmine,PETSC_TRUE,&bas->selfleafcontig);CHKERRQ(ierr);
+  bas->rootunique = PETSC_FALSE;
+  bas->leafunique = PETSC_FALSE;
+  if (bas->rootdirect) {
+    ierr = PetscCheckDupsInt(bas->itotal,bas->irootloc,&dups);CHKERRQ(ierr);
+    bas->rootunique = dups ? PETSC_FALSE : PETSC_TRUE;
+  }
+  if (bas->leafdirect) {
+    ierr = PetscCheckDupsInt(sf->roffset[sf->nranks],sf->rmine,&dups);CHKERRQ(ierr);
+    bas->leafunique = dups ? PETSC_FALSE : PETSC_TRUE;
+  }
   PetscFunctionReturn(0);
 }
 
@@ -221,15 +388,18 @@ PETSC_INTERN PetscErrorCode PetscSFSetUp_Basic(PetscSF sf)
 
   /* Setup packing optimization for roots and leaves */
   ierr = PetscSFPackSetupOptimizations_Basic(sf);CHKERRQ(ierr);
+  if (bas->usedirect) {ierr = PetscSFSetUpDirect_Basic(sf);CHKERRQ(ierr);}
   PetscFunctionReturn(0);
 }
 
 static PetscErrorCode PetscSFSetFromOptions_Basic(PetscOptionItems *PetscOptionsObject,PetscSF sf)
 {
   PetscErrorCode ierr;
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
 
   PetscFunctionBegin;
   ierr = PetscOptionsHead(PetscOptionsObject,"PetscSF Basic options");CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-sf_basic_direct","Communicate contiguous or strided roots and leaves in place, without packing them","PetscSFSetFromOptions",bas->usedirect,&bas->usedirect,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -263,16 +433,31 @@ PETSC_INTERN PetscErrorCode PetscSFDestroy_Basic(PetscSF sf)
 
 PETSC_INTERN PetscErrorCode PetscSFView_Basic(PetscSF sf,PetscViewer viewer)
 {
-  PetscErrorCode ierr;
-  PetscBool      iascii;
+  PetscErrorCode    ierr;
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
+  PetscBool         iascii;
+  PetscViewerFormat format;
+  PetscMPIInt       rank;
 
   PetscFunctionBegin;
   ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
-  if (iascii) {ierr = PetscViewerASCIIPrintf(viewer,"  sort=%s\n",sf->rankorder ? "rank-order" : "unordered");CHKERRQ(ierr);}
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  sort=%s\n",sf->rankorder ? "rank-order" : "unordered");CHKERRQ(ierr);
+    ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+    /* Which runs of roots and leaves can be communicated in place, see PetscSFPackSetDirect_Basic() */
+    if (format == PETSC_VIEWER_ASCII_INFO && bas->usedirect && sf->setupcalled) {
+      ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)sf),&rank);CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPushSynchronized(viewer);CHKERRQ(ierr);
+      ierr = PetscViewerASCIISynchronizedPrintf(viewer,"[%d] In place: remote roots %s (unique %s), remote leaves %s (unique %s), local roots %s, local leaves %s\n",rank,PetscBools[bas->rootdirect],PetscBools[bas->rootunique],PetscBools[bas->leafdirect],PetscBools[bas->leafunique],PetscBools[bas->selfrootcontig],PetscBools[bas->selfleafcontig]);CHKERRQ(ierr);
+      ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPopSynchronized(viewer);CHKERRQ(ierr);
+    }
+  }
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBcastAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,void *leafdata,MPI_Op op)
+/* root -> leaf with op, communicating in place where possible when direct is true */
+static PetscErrorCode PetscSFBcastAndOpBegin_Basic_Private(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,void *leafdata,MPI_Op op,PetscBool direct)
 {
   PetscErrorCode    ierr;
   PetscSFPack       link;
@@ -281,6 +466,7 @@ static PetscErrorCode PetscSFBcastAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,
 
   PetscFunctionBegin;
   ierr = PetscSFPackGet_Basic(sf,unit,rootmtype,rootdata,leafmtype,leafdata,PETSCSF_ROOT2LEAF_BCAST,&link);CHKERRQ(ierr);
+  if (direct) {ierr = PetscSFPackSetDirect_Basic(sf,link,PETSCSF_ROOT2LEAF_BCAST,rootmtype,rootdata,leafmtype,leafdata,op);CHKERRQ(ierr);}
   ierr = PetscSFGetRootIndicesWithMemType_Basic(sf,rootmtype,&rootloc);CHKERRQ(ierr);
 
   ierr = PetscSFPackGetReqs_Basic(sf,link,PETSCSF_ROOT2LEAF_BCAST,&rootreqs,&leafreqs);CHKERRQ(ierr);
@@ -296,6 +482,15 @@ static PetscErrorCode PetscSFBcastAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode PetscSFBcastAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,void *leafdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBcastAndOpBegin_Basic_Private(sf,unit,rootmtype,rootdata,leafmtype,leafdata,op,PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PETSC_INTERN PetscErrorCode PetscSFBcastAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,void *leafdata,MPI_Op op)
 {
   PetscErrorCode    ierr;
@@ -311,8 +506,82 @@ PETSC_INTERN PetscErrorCode PetscSFBcastAndOpEnd_Basic(PetscSF sf,MPI_Datatype u
   PetscFunctionReturn(0);
 }
 
-/* leaf -> root with reduction */
-static PetscErrorCode PetscSFReduceBegin_Basic(PetscSF sf,MPI_Datatype unit,PetscMemType leafmtype,const void *leafdata,PetscMemType rootmtype,void *rootdata,MPI_Op op)
+/* Unpack and Op count leaves, either those connected to self or those connected to one remote rank */
+static PetscErrorCode PetscSFUnpackAndOpLeafPart_Basic(PetscSFPack link,PetscInt count,const PetscInt *idx,PetscSFPackOpt opt,void *leafdata,const char *buf,MPI_Op op,PetscBool atomic)
+{
+  PetscErrorCode ierr;
+  PetscErrorCode (*UnpackAndOp)(PetscInt,const PetscInt*,PetscSFPack,PetscSFPackOpt,void*,const void*);
+
+  PetscFunctionBegin;
+  if (!count) PetscFunctionReturn(0);
+  ierr = PetscSFPackGetUnpackAndOp(link,link->leafmtype,op,atomic,&UnpackAndOp);CHKERRQ(ierr);
+  if (UnpackAndOp) {ierr = (*UnpackAndOp)(count,idx,link,opt,leafdata,buf);CHKERRQ(ierr);}
+#if defined(PETSC_HAVE_MPI_REDUCE_LOCAL)
+  else {
+    PetscInt j;
+    for (j=0; j<count; j++) {ierr = MPI_Reduce_local(buf+j*link->unitbytes,(char*)leafdata+idx[j]*link->unitbytes,1,link->unit,op);CHKERRQ(ierr);}
+  }
+#else
+  else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No unpacking reduction operation for this MPI_Op");
+#endif
+  PetscFunctionReturn(0);
+}
+
+/* The leaves connected to self are unpacked on the first call, then those of the remote ranks in the order their messages complete */
+static PetscErrorCode PetscSFBcastAndOpEndAny_Basic(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,void *leafdata,MPI_Op op,PetscMPIInt *rank)
+{
+  PetscErrorCode    ierr;
+  PetscSFPack       link;
+  const PetscInt    *leafloc = NULL;
+  PetscInt          j;
+  PetscMPIInt       i;
+
+  PetscFunctionBegin;
+  if (leafmtype != PETSC_MEMTYPE_HOST) { /* One unpacking kernel per rank does not pay off on the device */
+    ierr  = PetscSFBcastAndOpEnd_Basic(sf,unit,rootmtype,rootdata,leafmtype,leafdata,op);CHKERRQ(ierr);
+    *rank = MPI_ANY_SOURCE;
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscSFPackGetInUse(sf,unit,rootdata,leafdata,PETSC_USE_POINTER,&link);CHKERRQ(ierr);
+  ierr = PetscSFGetLeafIndicesWithMemType_Basic(sf,leafmtype,&leafloc);CHKERRQ(ierr);
+  if (!link->endany) {
+    link->endany = PETSC_TRUE;
+    if (sf->ndranks) {
+      PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
+      const char    *buf = link->selfbuf[leafmtype];
+      PetscInt      n    = sf->roffset[sf->ndranks];
+
+      if (link->selfdirect) { /* See PetscSFUnpackAndOpLeafData() */
+        buf = (const char*)rootdata+bas->irootloc[0]*link->unitbytes;
+        if (bas->selfleafcontig && op == MPIU_REPLACE) {
+          if ((char*)leafdata+leafloc[0]*link->unitbytes != buf) {ierr = PetscMemcpy((char*)leafdata+leafloc[0]*link->unitbytes,buf,n*link->unitbytes);CHKERRQ(ierr);}
+          n = 0;
+        }
+      }
+      ierr  = PetscSFUnpackAndOpLeafPart_Basic(link,n,leafloc,sf->selfleafpackopt,leafdata,buf,op,sf->selfleafdups);CHKERRQ(ierr);
+      *rank = sf->ranks[0];
+      PetscFunctionReturn(0);
+    }
+  }
+  /* Completed persistent requests become inactive, so MPI_Waitany() returns each of them once, then MPI_UNDEFINED */
+  ierr = MPI_Waitany(link->nleafreqs,link->leafdirect ? link->leafdirectreqs[PETSCSF_ROOT2LEAF_BCAST] : link->leafreqs[PETSCSF_ROOT2LEAF_BCAST][leafmtype],&i,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+  if (i == MPI_UNDEFINED) {
+    ierr = MPI_Waitall(link->nrootreqs,link->rootdirect ? link->rootdirectreqs[PETSCSF_ROOT2LEAF_BCAST] : link->rootreqs[PETSCSF_ROOT2LEAF_BCAST][rootmtype],MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+    link->endany = PETSC_FALSE;
+    ierr  = PetscSFPackGetInUse(sf,unit,rootdata,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+    ierr  = PetscSFPackReclaim(sf,&link);CHKERRQ(ierr);
+    *rank = MPI_UNDEFINED;
+    PetscFunctionReturn(0);
+  }
+  j     = sf->ndranks+i;
+  *rank = sf->ranks[j];
+  if (link->leafdirect) PetscFunctionReturn(0); /* The message was received into leafdata in place */
+  ierr  = PetscSFUnpackAndOpLeafPart_Basic(link,sf->roffset[j+1]-sf->roffset[j],leafloc+sf->roffset[j],NULL,leafdata,link->leafbuf[leafmtype]+(sf->roffset[j]-sf->roffset[sf->ndranks])*link->unitbytes,op,sf->remoteleafdups);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* leaf -> root with reduction, communicating in place where possible when direct is true */
+static PetscErrorCode PetscSFReduceBegin_Basic_Private(PetscSF sf,MPI_Datatype unit,PetscMemType leafmtype,const void *leafdata,PetscMemType rootmtype,void *rootdata,MPI_Op op,PetscBool direct)
 {
   PetscErrorCode    ierr;
   PetscSFPack       link;
@@ -323,6 +592,7 @@ static PetscErrorCode PetscSFReduceBegin_Basic(PetscSF sf,MPI_Datatype unit,Pets
   ierr = PetscSFGetLeafIndicesWithMemType_Basic(sf,leafmtype,&leafloc);
 
   ierr = PetscSFPackGet_Basic(sf,unit,rootmtype,rootdata,leafmtype,leafdata,PETSCSF_LEAF2ROOT_REDUCE,&link);CHKERRQ(ierr);
+  if (direct) {ierr = PetscSFPackSetDirect_Basic(sf,link,PETSCSF_LEAF2ROOT_REDUCE,rootmtype,rootdata,leafmtype,leafdata,op);CHKERRQ(ierr);}
   ierr = PetscSFPackGetReqs_Basic(sf,link,PETSCSF_LEAF2ROOT_REDUCE,&rootreqs,&leafreqs);CHKERRQ(ierr);
   /* Eagerly post root receives for non-distinguished ranks */
   ierr = MPI_Startall_irecv(link->rootbuflen,unit,link->nrootreqs,rootreqs);CHKERRQ(ierr);
@@ -335,6 +605,15 @@ static PetscErrorCode PetscSFReduceBegin_Basic(PetscSF sf,MPI_Datatype unit,Pets
   PetscFunctionReturn(0);
 }
 
+PETSC_INTERN PetscErrorCode PetscSFReduceBegin_Basic(PetscSF sf,MPI_Datatype unit,PetscMemType leafmtype,const void *leafdata,PetscMemType rootmtype,void *rootdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReduceBegin_Basic_Private(sf,unit,leafmtype,leafdata,rootmtype,rootdata,op,PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PETSC_INTERN PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,PetscMemType leafmtype,const void *leafdata,PetscMemType rootmtype,void *rootdata,MPI_Op op)
 {
   PetscErrorCode    ierr;
@@ -359,7 +638,17 @@ PETSC_INTERN PetscErrorCode PetscSFFetchAndOpBegin_Basic(PetscSF sf,MPI_Datatype
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFFetchAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,void *rootdata,PetscMemType leafmtype,const void *leafdata,void *leafupdate,MPI_Op op)
+/* Fetch-and-op needs the old roots and the local leaves in the buffers, so it never communicates in place */
+static PetscErrorCode PetscSFFetchAndOpBeginBuffered_Basic(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,void *rootdata,PetscMemType leafmtype,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReduceBegin_Basic_Private(sf,unit,leafmtype,leafdata,rootmtype,rootdata,op,PETSC_FALSE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode PetscSFFetchAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,void *rootdata,PetscMemType leafmtype,const void *leafdata,void *leafupdate,MPI_Op op)
 {
   PetscErrorCode    ierr;
   PetscSFPack       link;
@@ -436,7 +725,7 @@ PETSC_INTERN PetscErrorCode PetscSFCreateEmbeddedSF_Basic(PetscSF sf,PetscInt ns
      sf but do not do unpacking (from leaf buffer to leafdata). The raw data in leaf buffer is what we are
      interested in since it tells which leaves are connected to which ranks.
    */
-  ierr = PetscSFBcastAndOpBegin_Basic(sf,MPIU_INT,PETSC_MEMTYPE_HOST,rootdata,PETSC_MEMTYPE_HOST,leafdata-minleaf,MPIU_REPLACE);CHKERRQ(ierr); /* Need to give leafdata but we won't use it */
+  ierr = PetscSFBcastAndOpBegin_Basic_Private(sf,MPIU_INT,PETSC_MEMTYPE_HOST,rootdata,PETSC_MEMTYPE_HOST,leafdata-minleaf,MPIU_REPLACE,PETSC_FALSE);CHKERRQ(ierr); /* Need to give leafdata but we won't use it; the leaf buffer must be filled, so do not communicate in place */
   ierr = PetscSFPackGetInUse(sf,MPIU_INT,rootdata,leafdata-minleaf,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
   ierr = PetscSFPackWaitall_Basic(link,PETSCSF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
   ierr = PetscSFGetLeafInfo_Basic(sf,&nranks,&ndranks,&ranks,&roffset,&rmine,&rremote);CHKERRQ(ierr); /* Get send info */
@@ -520,6 +809,7 @@ PETSC_INTERN PetscErrorCode PetscSFCreateEmbeddedSF_Basic(PetscSF sf,PetscInt ns
 
   /* Setup packing optimizations */
   ierr = PetscSFPackSetupOptimizations_Basic(esf);CHKERRQ(ierr);
+  if (bas->usedirect) {ierr = PetscSFSetUpDirect_Basic(esf);CHKERRQ(ierr);}
   esf->setupcalled = PETSC_TRUE; /* We have done setup ourselves! */
 
   ierr = PetscFree2(rootdata,leafdata);CHKERRQ(ierr);
@@ -603,6 +893,7 @@ PETSC_INTERN PetscErrorCode PetscSFCreateEmbeddedLeafSF_Basic(PetscSF sf,PetscIn
 
   /* Setup packing optimizations */
   ierr = PetscSFPackSetupOptimizations_Basic(esf);CHKERRQ(ierr);
+  if (bas->usedirect) {ierr = PetscSFSetUpDirect_Basic(esf);CHKERRQ(ierr);}
   esf->setupcalled = PETSC_TRUE; /* We have done setup ourselves! */
 
   ierr = PetscFree2(rootdata,leafdata);CHKERRQ(ierr);
@@ -610,6 +901,129 @@ PETSC_INTERN PetscErrorCode PetscSFCreateEmbeddedLeafSF_Basic(PetscSF sf,PetscIn
   PetscFunctionReturn(0);
 }
 
+/*===================================================================================*/
+/*              Communication of several arrays with one message per rank            */
+/*===================================================================================*/
+
+/* Op the packed entries buf[] into data[idx[]] with UnpackAndOp, or entry by entry with MPI_Reduce_local() if there is no such routine for op */
+static PetscErrorCode PetscSFUnpackAndOp_Multiple_Basic(PetscSFPack link,PetscInt count,const PetscInt *idx,PetscSFPackOpt opt,void *data,const char *buf,MPI_Op op,PetscBool atomic)
+{
+  PetscErrorCode ierr;
+  PetscErrorCode (*UnpackAndOp)(PetscInt,const PetscInt*,PetscSFPack,PetscSFPackOpt,void*,const void*);
+
+  PetscFunctionBegin;
+  if (!count) PetscFunctionReturn(0);
+  ierr = PetscSFPackGetUnpackAndOp(link,PETSC_MEMTYPE_HOST,op,atomic,&UnpackAndOp);CHKERRQ(ierr);
+  if (UnpackAndOp) {ierr = (*UnpackAndOp)(count,idx,link,opt,data,buf);CHKERRQ(ierr);}
+#if defined(PETSC_HAVE_MPI_REDUCE_LOCAL)
+  else {
+    PetscInt j;
+    for (j=0; j<count; j++) {ierr = MPI_Reduce_local((void*)(buf+j*link->unitbytes),(char*)data+idx[j]*link->unitbytes,1,link->unit,op);CHKERRQ(ierr);}
+  }
+#else
+  else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No unpacking reduction operation for this MPI_Op");
+#endif
+  PetscFunctionReturn(0);
+}
+
+/* Pack the k arrays into the self buffer, one array after the other, and into the remote buffer, where the piece for
+   each rank holds its entries of array 0, then of array 1 etc. so that one message carries all the arrays. When packing
+   roots, (noff,off,loc,opt) describe the roots, otherwise the leaves. */
+static PetscErrorCode PetscSFPackData_Multiple_Basic(PetscSFPack link,PetscInt nself,PetscInt nranks,const PetscInt *off,const PetscInt *loc,PetscSFPackOpt selfopt,PetscInt k,const void *const *data,char *selfbuf,char *buf)
+{
+  PetscErrorCode ierr;
+  PetscInt       a,i,n;
+  const size_t   ub = link->unitbytes;
+  PetscErrorCode (*Pack)(PetscInt,const PetscInt*,PetscSFPack,PetscSFPackOpt,const void*,void*);
+
+  PetscFunctionBegin;
+  ierr = PetscSFPackGetPack(link,PETSC_MEMTYPE_HOST,&Pack);CHKERRQ(ierr);
+  if (off[nself]) {
+    for (a=0; a<k; a++) {ierr = (*Pack)(off[nself],loc,link,selfopt,data[a],selfbuf+a*off[nself]*ub);CHKERRQ(ierr);}
+  }
+  for (i=nself; i<nranks; i++) {
+    n = off[i+1]-off[i];
+    if (!n) continue;
+    for (a=0; a<k; a++) {ierr = (*Pack)(n,loc+off[i],link,NULL,data[a],buf+(k*(off[i]-off[nself])+a*n)*ub);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+/* The reverse of PetscSFPackData_Multiple_Basic(), op-ing the buffers into the k arrays */
+static PetscErrorCode PetscSFUnpackAndOpData_Multiple_Basic(PetscSFPack link,PetscInt nself,PetscInt nranks,const PetscInt *off,const PetscInt *loc,PetscSFPackOpt selfopt,PetscBool selfdups,PetscBool remotedups,PetscInt k,void *const *data,const char *selfbuf,const char *buf,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscInt       a,i,n;
+  const size_t   ub = link->unitbytes;
+
+  PetscFunctionBegin;
+  for (a=0; a<k; a++) {ierr = PetscSFUnpackAndOp_Multiple_Basic(link,off[nself],loc,selfopt,data[a],selfbuf+a*off[nself]*ub,op,selfdups);CHKERRQ(ierr);}
+  for (i=nself; i<nranks; i++) {
+    n = off[i+1]-off[i];
+    for (a=0; a<k; a++) {ierr = PetscSFUnpackAndOp_Multiple_Basic(link,n,loc+off[i],NULL,data[a],buf+(k*(off[i]-off[nself])+a*n)*ub,op,remotedups);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpMultipleBegin_Basic(PetscSF sf,MPI_Datatype unit,PetscInt k,const void *const *rootdata,void *const *leafdata,MPI_Op op)
+{
+  PetscErrorCode    ierr;
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
+  PetscSFPack       link;
+  MPI_Request       *rootreqs,*leafreqs;
+
+  PetscFunctionBegin;
+  ierr = PetscSFPackGet_Basic_Common(sf,unit,PETSC_MEMTYPE_HOST,rootdata[0],PETSC_MEMTYPE_HOST,leafdata[0],bas->niranks-bas->ndiranks,sf->nranks-sf->ndranks,k,&link);CHKERRQ(ierr);
+  ierr = PetscSFPackGetReqs_Basic(sf,link,PETSCSF_ROOT2LEAF_BCAST,&rootreqs,&leafreqs);CHKERRQ(ierr);
+  ierr = MPI_Startall_irecv(link->leafbuflen,unit,link->nleafreqs,leafreqs);CHKERRQ(ierr);
+  ierr = PetscSFPackData_Multiple_Basic(link,bas->ndiranks,bas->niranks,bas->ioffset,bas->irootloc,bas->selfrootpackopt,k,rootdata,link->selfbuf[PETSC_MEMTYPE_HOST],link->rootbuf[PETSC_MEMTYPE_HOST]);CHKERRQ(ierr);
+  ierr = MPI_Startall_isend(link->rootbuflen,unit,link->nrootreqs,rootreqs);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpMultipleEnd_Basic(PetscSF sf,MPI_Datatype unit,PetscInt k,const void *const *rootdata,void *const *leafdata,MPI_Op op)
+{
+  PetscErrorCode    ierr;
+  PetscSFPack       link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFPackGetInUse(sf,unit,rootdata[0],leafdata[0],PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = PetscSFPackWaitall_Basic(link,PETSCSF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
+  ierr = PetscSFUnpackAndOpData_Multiple_Basic(link,sf->ndranks,sf->nranks,sf->roffset,sf->rmine,sf->selfleafpackopt,sf->selfleafdups,sf->remoteleafdups,k,leafdata,link->selfbuf[PETSC_MEMTYPE_HOST],link->leafbuf[PETSC_MEMTYPE_HOST],op);CHKERRQ(ierr);
+  ierr = PetscSFPackReclaim(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceMultipleBegin_Basic(PetscSF sf,MPI_Datatype unit,PetscInt k,const void *const *leafdata,void *const *rootdata,MPI_Op op)
+{
+  PetscErrorCode    ierr;
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
+  PetscSFPack       link;
+  MPI_Request       *rootreqs,*leafreqs;
+
+  PetscFunctionBegin;
+  ierr = PetscSFPackGet_Basic_Common(sf,unit,PETSC_MEMTYPE_HOST,rootdata[0],PETSC_MEMTYPE_HOST,leafdata[0],bas->niranks-bas->ndiranks,sf->nranks-sf->ndranks,k,&link);CHKERRQ(ierr);
+  ierr = PetscSFPackGetReqs_Basic(sf,link,PETSCSF_LEAF2ROOT_REDUCE,&rootreqs,&leafreqs);CHKERRQ(ierr);
+  ierr = MPI_Startall_irecv(link->rootbuflen,unit,link->nrootreqs,rootreqs);CHKERRQ(ierr);
+  ierr = PetscSFPackData_Multiple_Basic(link,sf->ndranks,sf->nranks,sf->roffset,sf->rmine,sf->selfleafpackopt,k,leafdata,link->selfbuf[PETSC_MEMTYPE_HOST],link->leafbuf[PETSC_MEMTYPE_HOST]);CHKERRQ(ierr);
+  ierr = MPI_Startall_isend(link->leafbuflen,unit,link->nleafreqs,leafreqs);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceMultipleEnd_Basic(PetscSF sf,MPI_Datatype unit,PetscInt k,const void *const *leafdata,void *const *rootdata,MPI_Op op)
+{
+  PetscErrorCode    ierr;
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
+  PetscSFPack       link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFPackGetInUse(sf,unit,rootdata[0],leafdata[0],PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = PetscSFPackWaitall_Basic(link,PETSCSF_LEAF2ROOT_REDUCE);CHKERRQ(ierr);
+  ierr = PetscSFUnpackAndOpData_Multiple_Basic(link,bas->ndiranks,bas->niranks,bas->ioffset,bas->irootloc,bas->selfrootpackopt,bas->selfrootdups,bas->remoterootdups,k,rootdata,link->selfbuf[PETSC_MEMTYPE_HOST],link->rootbuf[PETSC_MEMTYPE_HOST],op);CHKERRQ(ierr);
+  ierr = PetscSFPackReclaim(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PETSC_EXTERN PetscErrorCode PetscSFCreate_Basic(PetscSF sf)
 {
   PetscSF_Basic  *dat;
@@ -623,15 +1037,21 @@ PETSC_EXTERN PetscErrorCode PetscSFCreate_Basic(PetscSF sf)
   sf->ops->View                 = PetscSFView_Basic;
   sf->ops->BcastAndOpBegin      = PetscSFBcastAndOpBegin_Basic;
   sf->ops->BcastAndOpEnd        = PetscSFBcastAndOpEnd_Basic;
+  sf->ops->BcastAndOpEndAny     = PetscSFBcastAndOpEndAny_Basic;
   sf->ops->ReduceBegin          = PetscSFReduceBegin_Basic;
   sf->ops->ReduceEnd            = PetscSFReduceEnd_Basic;
-  sf->ops->FetchAndOpBegin      = PetscSFFetchAndOpBegin_Basic;
+  sf->ops->FetchAndOpBegin      = PetscSFFetchAndOpBeginBuffered_Basic;
   sf->ops->FetchAndOpEnd        = PetscSFFetchAndOpEnd_Basic;
+  sf->ops->BcastAndOpMultipleBegin = PetscSFBcastAndOpMultipleBegin_Basic;
+  sf->ops->BcastAndOpMultipleEnd   = PetscSFBcastAndOpMultipleEnd_Basic;
+  sf->ops->ReduceMultipleBegin     = PetscSFReduceMultipleBegin_Basic;
+  sf->ops->ReduceMultipleEnd       = PetscSFReduceMultipleEnd_Basic;
   sf->ops->GetLeafRanks         = PetscSFGetLeafRanks_Basic;
   sf->ops->CreateEmbeddedSF     = PetscSFCreateEmbeddedSF_Basic;
   sf->ops->CreateEmbeddedLeafSF = PetscSFCreateEmbeddedLeafSF_Basic;
 
   ierr = PetscNewLog(sf,&dat);CHKERRQ(ierr);
-  sf->data = (void*)dat;
+  dat->usedirect = PETSC_TRUE;
+  sf->data       = (void*)dat;
   PetscFunctionReturn(0);
 }
@@ -19,7 +19,14 @@ typedef enum {PETSCSF_LEAF2ROOT_REDUCE=0, PETSCSF_ROOT2LEAF_BCAST=1} PetscSFDire
   PetscSFPack      inuse;           /* Buffers being used for transactions that have not yet completed */                          \
   PetscBool        selfrootdups;    /* Indices of roots in irootloc[0,ioffset[ndiranks]) have dups, implying theads working ... */ \
                                     /* ... on these roots in parallel may have data race. */                                       \
-  PetscBool        remoterootdups   /* Indices of roots in irootloc[ioffset[ndiranks],ioffset[niranks]) have dups */
+  PetscBool        remoterootdups;  /* Indices of roots in irootloc[ioffset[ndiranks],ioffset[niranks]) have dups */               \
+  PetscBool        usedirect;       /* Communicate contiguous or strided entries in place when possible, only set by SFBasic */    \
+  PetscBool        rootdirect;      /* Are the roots of each remote rank a contiguous or strided run, usable by MPI in place? */   \
+  PetscBool        leafdirect;      /* Are the leaves of each remote rank a contiguous or strided run, usable by MPI in place? */  \
+  PetscBool        rootunique;      /* Are the roots in irootloc[] distinct, so that they can be received into in place? */        \
+  PetscBool        leafunique;      /* Are the leaves in rmine[] distinct, so that they can be received into in place? */          \
+  PetscBool        selfrootcontig;  /* Are the roots connected to local leaves one contiguous run, in irootloc[0] and on? */       \
+  PetscBool        selfleafcontig   /* Are the local leaves connected to local roots one contiguous run, in rmine[0] and on? */
 
 typedef struct {
   SFBASICHEADER;
@@ -128,6 +135,8 @@ PETSC_STATIC_INLINE PetscErrorCode PetscSFPackRootData(PetscSF sf,PetscSFPack li
     p[0].opt    = bas->selfrootpackopt;           p[1].opt    = bas->rootpackopt;
     p[0].buf    = link->selfbuf[link->rootmtype]; p[1].buf    = link->rootbuf[link->rootmtype];
     p[0].atomic = PETSC_FALSE;                    p[1].atomic = PETSC_FALSE;
+    if (link->selfdirect) p[0].count = 0; /* Local leaves read the roots in place */
+    if (link->rootdirect) p[1].count = 0; /* Messages are sent from rootdata in place */
   } else {
     /* For SFAllgatherv etc collectives, which have a dense root space and do not differentiate self/remote communication. */
     p[0].count  = sf->nroots;
@@ -163,6 +172,8 @@ PETSC_STATIC_INLINE PetscErrorCode PetscSFPackLeafData(PetscSF sf,PetscSFPack li
     p[0].opt    = sf->selfleafpackopt;            p[1].opt    = sf->leafpackopt;
     p[0].buf    = link->selfbuf[link->leafmtype]; p[1].buf    = link->leafbuf[link->leafmtype];
     p[0].atomic = PETSC_FALSE;                    p[1].atomic = PETSC_FALSE;
+    if (link->selfdirect) p[0].count = 0;
+    if (link->leafdirect) p[1].count = 0;
   } else {
     p[0].count  = sf->nleaves;
     p[0].idx    = NULL;
@@ -196,6 +207,15 @@ PETSC_STATIC_INLINE PetscErrorCode PetscSFUnpackAndOpRootData(PetscSF sf,PetscSF
     p[0].opt    = bas->selfrootpackopt;           p[1].opt    = bas->rootpackopt;
     p[0].buf    = link->selfbuf[link->rootmtype]; p[1].buf    = link->rootbuf[link->rootmtype];
     p[0].atomic = bas->selfrootdups;              p[1].atomic = bas->remoterootdups;
+    if (link->selfdirect) { /* The local leaves are one contiguous run of leafdata, which serves as the self buffer */
+      p[0].buf = (char*)link->lkey+sf->rmine[0]*link->unitbytes;
+      if (bas->selfrootcontig && op == MPIU_REPLACE) {
+        char *dst = (char*)rootdata+rootloc[0]*link->unitbytes;
+        if (dst != p[0].buf) {ierr = PetscMemcpy(dst,p[0].buf,p[0].count*link->unitbytes);CHKERRQ(ierr);}
+        p[0].count = 0;
+      }
+    }
+    if (link->rootdirect) p[1].count = 0; /* Messages were received into rootdata in place */
   } else {
     p[0].count  = sf->nroots;
     p[0].idx    = NULL;
@@ -249,6 +269,16 @@ PETSC_STATIC_INLINE PetscErrorCode PetscSFUnpackAndOpLeafData(PetscSF sf,PetscSF
     p[0].opt    = sf->selfleafpackopt;            p[1].opt    = sf->leafpackopt;
     p[0].buf    = link->selfbuf[link->leafmtype]; p[1].buf    = link->leafbuf[link->leafmtype];
     p[0].atomic = sf->selfleafdups;               p[1].atomic = sf->remoteleafdups;
+    if (link->selfdirect) { /* The roots connected to local leaves are one contiguous run of rootdata, which serves as the self buffer */
+      PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
+      p[0].buf = (char*)link->rkey+bas->irootloc[0]*link->unitbytes;
+      if (bas->selfleafcontig && op == MPIU_REPLACE) {
+        char *dst = (char*)leafdata+leafloc[0]*link->unitbytes;
+        if (dst != p[0].buf) {ierr = PetscMemcpy(dst,p[0].buf,p[0].count*link->unitbytes);CHKERRQ(ierr);}
+        p[0].count = 0;
+      }
+    }
+    if (link->leafdirect) p[1].count = 0;
   } else {
     p[0].count  = sf->nleaves;
     p[0].idx    = NULL;
@@ -369,8 +399,8 @@ PETSC_STATIC_INLINE PetscErrorCode PetscSFPackWaitall_Basic(PetscSFPack link,Pet
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = MPI_Waitall(link->nrootreqs,link->rootreqs[direction][link->rootmtype],MPI_STATUSES_IGNORE);CHKERRQ(ierr);
-  ierr = MPI_Waitall(link->nleafreqs,link->leafreqs[direction][link->leafmtype],MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  ierr = MPI_Waitall(link->nrootreqs,link->rootdirect ? link->rootdirectreqs[direction] : link->rootreqs[direction][link->rootmtype],MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  ierr = MPI_Waitall(link->nleafreqs,link->leafdirect ? link->leafdirectreqs[direction] : link->leafreqs[direction][link->leafmtype],MPI_STATUSES_IGNORE);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -379,10 +409,12 @@ PETSC_INTERN PetscErrorCode PetscSFView_Basic(PetscSF,PetscViewer);
 PETSC_INTERN PetscErrorCode PetscSFReset_Basic(PetscSF);
 PETSC_INTERN PetscErrorCode PetscSFDestroy_Basic(PetscSF);
 PETSC_INTERN PetscErrorCode PetscSFBcastAndOpEnd_Basic  (PetscSF,MPI_Datatype,PetscMemType,const void*,PetscMemType,      void*,      MPI_Op);
+PETSC_INTERN PetscErrorCode PetscSFReduceBegin_Basic    (PetscSF,MPI_Datatype,PetscMemType,const void*,PetscMemType,      void*,      MPI_Op);
 PETSC_INTERN PetscErrorCode PetscSFReduceEnd_Basic      (PetscSF,MPI_Datatype,PetscMemType,const void*,PetscMemType,      void*,      MPI_Op);
 PETSC_INTERN PetscErrorCode PetscSFFetchAndOpBegin_Basic(PetscSF,MPI_Datatype,PetscMemType,      void*,PetscMemType,const void*,void*,MPI_Op);
+PETSC_INTERN PetscErrorCode PetscSFFetchAndOpEnd_Basic  (PetscSF,MPI_Datatype,PetscMemType,      void*,PetscMemType,const void*,void*,MPI_Op);
 PETSC_INTERN PetscErrorCode PetscSFCreateEmbeddedSF_Basic(PetscSF,PetscInt,const PetscInt*,PetscSF*);
 PETSC_INTERN PetscErrorCode PetscSFCreateEmbeddedLeafSF_Basic(PetscSF,PetscInt,const PetscInt*,PetscSF*);
 PETSC_INTERN PetscErrorCode PetscSFGetLeafRanks_Basic(PetscSF,PetscInt*,const PetscMPIInt**,const PetscInt**,const PetscInt**);
-PETSC_INTERN PetscErrorCode PetscSFPackGet_Basic_Common(PetscSF,MPI_Datatype,PetscMemType,const void*,PetscMemType,const void*,PetscInt,PetscInt,PetscSFPack*);
+PETSC_INTERN PetscErrorCode PetscSFPackGet_Basic_Common(PetscSF,MPI_Datatype,PetscMemType,const void*,PetscMemType,const void*,PetscInt,PetscInt,PetscInt,PetscSFPack*);
 #endif
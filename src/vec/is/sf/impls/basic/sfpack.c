@@ -558,6 +558,15 @@ PetscErrorCode PetscSFPackDestroyAvailable(PetscSFPack *avail)
       if (link->reqs[i] != MPI_REQUEST_NULL) {ierr = MPI_Request_free(&link->reqs[i]);CHKERRQ(ierr);}
     }
     ierr = PetscFree(link->reqs);CHKERRQ(ierr);
+    if (link->directreqs) {
+      for (i=0; i<(link->nrootreqs+link->nleafreqs)*2; i++) {
+        if (link->directreqs[i] != MPI_REQUEST_NULL) {ierr = MPI_Request_free(&link->directreqs[i]);CHKERRQ(ierr);}
+      }
+      for (i=0; i<link->nrootreqs+link->nleafreqs; i++) {
+        if (link->directtypes[i] != MPI_DATATYPE_NULL) {ierr = MPI_Type_free(&link->directtypes[i]);CHKERRQ(ierr);}
+      }
+      ierr = PetscFree2(link->directreqs,link->directtypes);CHKERRQ(ierr);
+    }
     ierr = PetscFreeWithMemType(PETSC_MEMTYPE_HOST,link->rootbuf[PETSC_MEMTYPE_HOST]);CHKERRQ(ierr);
     ierr = PetscFreeWithMemType(PETSC_MEMTYPE_HOST,link->leafbuf[PETSC_MEMTYPE_HOST]);CHKERRQ(ierr);
     ierr = PetscFreeWithMemType(PETSC_MEMTYPE_HOST,link->selfbuf[PETSC_MEMTYPE_HOST]);CHKERRQ(ierr);
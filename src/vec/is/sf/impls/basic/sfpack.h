@@ -137,6 +137,17 @@ struct _n_PetscSFPack {
   PetscInt       rootbuflen;             /* Length of root buffer in <unit> */
   PetscInt       leafbuflen;             /* Length of leaf buffer in <unit> */
   PetscInt       selfbuflen;             /* Length of self buffer in <unit> */
+  PetscInt       narrays;                /* Number of root/leaf arrays communicated together; the message to a rank holds its entries of each array in turn */
+  PetscBool      endany;                 /* Has PetscSFBcastAndOpEndAny() already unpacked the leaves connected to some ranks? */
+  PetscBool      rootdirect;             /* Are the remote roots sent from or received into rootdata in place in the current operation? */
+  PetscBool      leafdirect;             /* Are the remote leaves sent from or received into leafdata in place in the current operation? */
+  PetscBool      selfdirect;             /* Are the self to self entries read in place from rootdata (bcast) or leafdata (reduce), without selfbuf? */
+  const void     *rootdirectdata[2];     /* [PETSCSF_DIRECTION] The rootdata the in-place root requests are bound to */
+  const void     *leafdirectdata[2];     /* [PETSCSF_DIRECTION] The leafdata the in-place leaf requests are bound to */
+  MPI_Request    *rootdirectreqs[2];     /* [PETSCSF_DIRECTION] Persistent root requests on rootdata in place, pointing into directreqs */
+  MPI_Request    *leafdirectreqs[2];     /* [PETSCSF_DIRECTION] Persistent leaf requests on leafdata in place, pointing into directreqs */
+  MPI_Request    *directreqs;            /* An array of length (nrootreqs+nleafreqs)*2, lazily allocated */
+  MPI_Datatype   *directtypes;           /* [nrootreqs+nleafreqs] Datatypes of in-place messages to strided entries, MPI_DATATYPE_NULL for contiguous ones */
   PetscMemType   rootmtype;              /* rootdata's memory type */
   PetscMemType   leafmtype;              /* leafdata's memory type */
   PetscMPIInt    nrootreqs;              /* Number of root requests */
@@ -267,7 +267,8 @@ PetscErrorCode PetscSFSetUp(PetscSF sf)
 
    Options Database Keys:
 +  -sf_type - implementation type, see PetscSFSetType()
--  -sf_rank_order - sort composite points for gathers and scatters in rank order, gathers are non-deterministic otherwise
+.  -sf_rank_order - sort composite points for gathers and scatters in rank order, gathers are non-deterministic otherwise
+-  -sf_basic_direct - with PETSCSFBASIC, communicate roots and leaves that are contiguous or strided for each process in place, without packing them (default true)
 
    Level: intermediate
 
@@ -1302,6 +1303,10 @@ PetscErrorCode PetscSFCreateEmbeddedLeafSF(PetscSF sf,PetscInt nselected,const P
    Output Arguments:
 .  leafdata - buffer to be reduced with values from each leaf's respective root
 
+   Notes:
+   The roots may be sent in place when they are contiguous or strided for each receiving process, so rootdata must not be
+   changed before PetscSFBcastAndOpEnd(). Use -sf_basic_direct 0 to always pack them into a separate buffer with PETSCSFBASIC.
+
    Level: intermediate
 
 .seealso: PetscSFBcastAndOpEnd(), PetscSFBcastBegin(), PetscSFBcastEnd()
@@ -1366,6 +1371,56 @@ PetscErrorCode PetscSFBcastAndOpEnd(PetscSF sf,MPI_Datatype unit,const void *roo
   PetscFunctionReturn(0);
 }
 
+/*@C
+   PetscSFBcastAndOpEndAny - complete part of a broadcast & reduce operation started with PetscSFBcastAndOpBegin(), namely the leaves
+   connected to one process, as soon as its data has arrived
+
+   Collective
+
+   Input Arguments:
++  sf - star forest
+.  unit - data type
+.  rootdata - buffer to broadcast
+-  op - operation to use for reduction
+
+   Output Arguments:
++  leafdata - buffer to be reduced with values from each leaf's respective root
+-  rank - the rank of the roots whose leaves have been updated by this call, MPI_ANY_SOURCE if all the remaining leaves have been
+          updated, or MPI_UNDEFINED if there was nothing left to update
+
+   Notes:
+   The function is called repeatedly until it returns MPI_UNDEFINED or MPI_ANY_SOURCE, at which point the operation is complete
+   and is not to be ended with PetscSFBcastAndOpEnd(). In between, the leaves connected to the returned ranks can be used while the
+   data of other processes is still in flight. Each rank is returned at most once and the leaves connected to the local process come first.
+
+   Star forest types which cannot complete an operation piecewise complete it entirely and return MPI_ANY_SOURCE on the first call.
+
+   Level: developer
+
+.seealso: PetscSFBcastAndOpBegin(), PetscSFBcastAndOpEnd(), PetscSFGetRanks()
+@*/
+PetscErrorCode PetscSFBcastAndOpEndAny(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op,PetscMPIInt *rank)
+{
+  PetscErrorCode ierr;
+  PetscMemType   rootmtype,leafmtype;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  PetscValidPointer(rank,6);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(PETSCSF_BcastAndOpEnd,sf,0,0,0);CHKERRQ(ierr);
+  ierr = PetscGetMemType(rootdata,&rootmtype);CHKERRQ(ierr);
+  ierr = PetscGetMemType(leafdata,&leafmtype);CHKERRQ(ierr);
+  if (sf->ops->BcastAndOpEndAny) {
+    ierr = (*sf->ops->BcastAndOpEndAny)(sf,unit,rootmtype,rootdata,leafmtype,leafdata,op,rank);CHKERRQ(ierr);
+  } else {
+    ierr  = (*sf->ops->BcastAndOpEnd)(sf,unit,rootmtype,rootdata,leafmtype,leafdata,op);CHKERRQ(ierr);
+    *rank = MPI_ANY_SOURCE;
+  }
+  ierr = PetscLogEventEnd(PETSCSF_BcastAndOpEnd,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
    PetscSFReduceBegin - begin reduction of leafdata into rootdata, to be completed with call to PetscSFReduceEnd()
 
@@ -1380,6 +1435,10 @@ PetscErrorCode PetscSFBcastAndOpEnd(PetscSF sf,MPI_Datatype unit,const void *roo
    Output Arguments:
 .  rootdata - result of reduction of values from all leaves of each root
 
+   Notes:
+   The leaves may be sent in place when they are contiguous or strided for each receiving process, so leafdata must not be
+   changed before PetscSFReduceEnd(). Use -sf_basic_direct 0 to always pack them into a separate buffer with PETSCSFBASIC.
+
    Level: intermediate
 
 .seealso: PetscSFBcastBegin()
@@ -1437,6 +1496,196 @@ PetscErrorCode PetscSFReduceEnd(PetscSF sf,MPI_Datatype unit,const void *leafdat
   PetscFunctionReturn(0);
 }
 
+/* Whether the k arrays can be communicated together with the implementation's multiple-array routines, which only work on host memory */
+static PetscErrorCode PetscSFMultipleUseOps_Private(PetscSF sf,PetscInt k,const void *const *rootdata,const void *const *leafdata,PetscBool *useops)
+{
+  PetscErrorCode ierr;
+  PetscMemType   mtype;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  *useops = (sf->ops->BcastAndOpMultipleBegin && k > 1) ? PETSC_TRUE : PETSC_FALSE;
+  for (i=0; i<k && *useops; i++) {
+    ierr = PetscGetMemType(rootdata[i],&mtype);CHKERRQ(ierr);
+    if (mtype != PETSC_MEMTYPE_HOST) *useops = PETSC_FALSE;
+    ierr = PetscGetMemType(leafdata[i],&mtype);CHKERRQ(ierr);
+    if (mtype != PETSC_MEMTYPE_HOST) *useops = PETSC_FALSE;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSFBcastAndOpMultipleBegin - begin a broadcast & reduce of several root arrays to several leaf arrays on the same graph, to be concluded with PetscSFBcastAndOpMultipleEnd()
+
+   Collective on PetscSF
+
+   Input Arguments:
++  sf - star forest on which to communicate
+.  unit - data type associated with each node
+.  k - number of arrays
+.  rootdata - the k buffers to broadcast
+-  op - operation to use for reduction
+
+   Output Arguments:
+.  leafdata - the k buffers to be reduced with values from each leaf's respective root, leafdata[i] receiving from rootdata[i]
+
+   Notes:
+   With PETSCSFBASIC the entries of all k arrays going to the same process are packed into one buffer and sent in one
+   message, so the latency is paid once instead of k times. Other types, or arrays in device memory, fall back to k
+   separate broadcasts.
+
+   The arrays must not be changed between the Begin and the End calls, and the same arrays must be passed to both.
+
+   Level: intermediate
+
+.seealso: PetscSFBcastAndOpMultipleEnd(), PetscSFBcastAndOpBegin(), PetscSFReduceMultipleBegin()
+@*/
+PetscErrorCode PetscSFBcastAndOpMultipleBegin(PetscSF sf,MPI_Datatype unit,PetscInt k,const void *const *rootdata,void *const *leafdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscBool      useops;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  if (k < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of arrays %D cannot be negative",k);
+  if (!k) PetscFunctionReturn(0);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+  ierr = PetscSFMultipleUseOps_Private(sf,k,rootdata,(const void*const*)leafdata,&useops);CHKERRQ(ierr);
+  if (!useops) {
+    for (i=0; i<k; i++) {ierr = PetscSFBcastAndOpBegin(sf,unit,rootdata[i],leafdata[i],op);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscLogEventBegin(PETSCSF_BcastAndOpBegin,sf,0,0,0);CHKERRQ(ierr);
+  ierr = (*sf->ops->BcastAndOpMultipleBegin)(sf,unit,k,rootdata,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(PETSCSF_BcastAndOpBegin,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSFBcastAndOpMultipleEnd - end a broadcast & reduce of several arrays started with PetscSFBcastAndOpMultipleBegin()
+
+   Collective
+
+   Input Arguments:
++  sf - star forest
+.  unit - data type
+.  k - number of arrays
+.  rootdata - the k buffers to broadcast
+-  op - operation to use for reduction
+
+   Output Arguments:
+.  leafdata - the k buffers to be reduced with values from each leaf's respective root
+
+   Level: intermediate
+
+.seealso: PetscSFBcastAndOpMultipleBegin(), PetscSFBcastAndOpEnd()
+@*/
+PetscErrorCode PetscSFBcastAndOpMultipleEnd(PetscSF sf,MPI_Datatype unit,PetscInt k,const void *const *rootdata,void *const *leafdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscBool      useops;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  if (k <= 0) PetscFunctionReturn(0);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+  ierr = PetscSFMultipleUseOps_Private(sf,k,rootdata,(const void*const*)leafdata,&useops);CHKERRQ(ierr);
+  if (!useops) {
+    for (i=0; i<k; i++) {ierr = PetscSFBcastAndOpEnd(sf,unit,rootdata[i],leafdata[i],op);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscLogEventBegin(PETSCSF_BcastAndOpEnd,sf,0,0,0);CHKERRQ(ierr);
+  ierr = (*sf->ops->BcastAndOpMultipleEnd)(sf,unit,k,rootdata,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(PETSCSF_BcastAndOpEnd,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSFReduceMultipleBegin - begin reduction of several leaf arrays into several root arrays on the same graph, to be completed with PetscSFReduceMultipleEnd()
+
+   Collective
+
+   Input Arguments:
++  sf - star forest
+.  unit - data type
+.  k - number of arrays
+.  leafdata - the k arrays of values to reduce
+-  op - reduction operation
+
+   Output Arguments:
+.  rootdata - the k arrays of results, rootdata[i] receiving the reduction of leafdata[i]
+
+   Notes:
+   As with PetscSFBcastAndOpMultipleBegin(), PETSCSFBASIC sends one message per process for all k arrays.
+
+   Level: intermediate
+
+.seealso: PetscSFReduceMultipleEnd(), PetscSFReduceBegin(), PetscSFBcastAndOpMultipleBegin()
+@*/
+PetscErrorCode PetscSFReduceMultipleBegin(PetscSF sf,MPI_Datatype unit,PetscInt k,const void *const *leafdata,void *const *rootdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscBool      useops;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  if (k < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of arrays %D cannot be negative",k);
+  if (!k) PetscFunctionReturn(0);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+  ierr = PetscSFMultipleUseOps_Private(sf,k,(const void*const*)rootdata,leafdata,&useops);CHKERRQ(ierr);
+  if (!useops) {
+    for (i=0; i<k; i++) {ierr = PetscSFReduceBegin(sf,unit,leafdata[i],rootdata[i],op);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscLogEventBegin(PETSCSF_ReduceBegin,sf,0,0,0);CHKERRQ(ierr);
+  ierr = (*sf->ops->ReduceMultipleBegin)(sf,unit,k,leafdata,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(PETSCSF_ReduceBegin,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSFReduceMultipleEnd - end a reduction of several arrays started with PetscSFReduceMultipleBegin()
+
+   Collective
+
+   Input Arguments:
++  sf - star forest
+.  unit - data type
+.  k - number of arrays
+.  leafdata - the k arrays of values to reduce
+-  op - reduction operation
+
+   Output Arguments:
+.  rootdata - the k arrays of results
+
+   Level: intermediate
+
+.seealso: PetscSFReduceMultipleBegin(), PetscSFReduceEnd()
+@*/
+PetscErrorCode PetscSFReduceMultipleEnd(PetscSF sf,MPI_Datatype unit,PetscInt k,const void *const *leafdata,void *const *rootdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscBool      useops;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  if (k <= 0) PetscFunctionReturn(0);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+  ierr = PetscSFMultipleUseOps_Private(sf,k,(const void*const*)rootdata,leafdata,&useops);CHKERRQ(ierr);
+  if (!useops) {
+    for (i=0; i<k; i++) {ierr = PetscSFReduceEnd(sf,unit,leafdata[i],rootdata[i],op);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscLogEventBegin(PETSCSF_ReduceEnd,sf,0,0,0);CHKERRQ(ierr);
+  ierr = (*sf->ops->ReduceMultipleEnd)(sf,unit,k,leafdata,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(PETSCSF_ReduceEnd,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
    PetscSFFetchAndOpBegin - begin operation that fetches values from root and updates atomically by applying operation using my leaf value, to be completed with PetscSFFetchAndOpEnd()
 
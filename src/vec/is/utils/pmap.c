@@ -140,6 +140,7 @@ PetscErrorCode PetscLayoutDestroy(PetscLayout *map)
   if (!(*map)->refcnt--) {
     if ((*map)->range_alloc) {ierr = PetscFree((*map)->range);CHKERRQ(ierr);}
     ierr = ISLocalToGlobalMappingDestroy(&(*map)->mapping);CHKERRQ(ierr);
+    if ((*map)->pooldestroy) {ierr = (*(*map)->pooldestroy)(&(*map)->pool);CHKERRQ(ierr);}
     ierr = PetscFree((*map));CHKERRQ(ierr);
   }
   *map = NULL;
@@ -318,7 +319,9 @@ PetscErrorCode PetscLayoutDuplicate(PetscLayout in,PetscLayout *out)
     ierr = PetscArraycpy((*out)->range,in->range,size+1);CHKERRQ(ierr);
   }
 
-  (*out)->refcnt = 0;
+  (*out)->refcnt      = 0;
+  (*out)->pool        = NULL;
+  (*out)->pooldestroy = NULL;
   PetscFunctionReturn(0);
 }
 
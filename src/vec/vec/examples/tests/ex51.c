@@ -0,0 +1,107 @@
+static char help[] = "Tests VecFuse, the fused vector operations, against the individual Vec operations.\n\n";
+
+#include <petscvec.h>
+
+/* Sets entry j of x to a value that only depends on j and s, so that the results do not depend on the number of processes */
+static PetscErrorCode FillVec(Vec x,PetscInt s)
+{
+  PetscInt       j,rstart,rend;
+  PetscScalar    *xa;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecGetOwnershipRange(x,&rstart,&rend);CHKERRQ(ierr);
+  ierr = VecGetArray(x,&xa);CHKERRQ(ierr);
+  for (j=rstart; j<rend; j++) xa[j-rstart] = 1.0/(1 + j + s) + 0.1*((j + s) % 5);
+  ierr = VecRestoreArray(x,&xa);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Vec            x[4],y[4];
+  VecFuse        fuse;
+  PetscInt       i,k,n = 1000;
+  PetscBool      nest = PETSC_FALSE;
+  PetscScalar    alpha = 0.7,beta = -1.3,dot[2],tdot[2];
+  PetscReal      nrm[2];
+  PetscBool      flg[4];
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-nest",&nest,NULL);CHKERRQ(ierr);
+  for (i=0; i<4; i++) {
+    ierr = VecCreate(PETSC_COMM_WORLD,&x[i]);CHKERRQ(ierr);
+    ierr = VecSetSizes(x[i],PETSC_DECIDE,n);CHKERRQ(ierr);
+    ierr = VecSetFromOptions(x[i]);CHKERRQ(ierr);
+    ierr = FillVec(x[i],i);CHKERRQ(ierr);
+    if (nest) {
+      Vec sub[2];
+
+      /* a VECNEST does not give access to its entries, which VecFuseExecute() handles without fusing */
+      sub[0] = x[i];
+      ierr   = VecDuplicate(sub[0],&sub[1]);CHKERRQ(ierr);
+      ierr   = FillVec(sub[1],4+i);CHKERRQ(ierr);
+      ierr   = VecCreateNest(PETSC_COMM_WORLD,2,NULL,sub,&x[i]);CHKERRQ(ierr);
+      ierr   = VecDestroy(&sub[0]);CHKERRQ(ierr);
+      ierr   = VecDestroy(&sub[1]);CHKERRQ(ierr);
+    }
+    ierr = VecDuplicate(x[i],&y[i]);CHKERRQ(ierr);
+    ierr = VecCopy(x[i],y[i]);CHKERRQ(ierr);
+  }
+
+  /* the record is cleared by VecFuseExecute() so the same object is used twice */
+  ierr = VecFuseCreate(PETSC_COMM_WORLD,&fuse);CHKERRQ(ierr);
+  for (k=0; k<2; k++) {
+    ierr = VecFuseAXPY(fuse,x[0],alpha,x[1]);CHKERRQ(ierr);
+    ierr = VecFuseAYPX(fuse,x[1],beta,x[2]);CHKERRQ(ierr);
+    ierr = VecFuseDot(fuse,x[0],x[1],&dot[0]);CHKERRQ(ierr);
+    ierr = VecFuseWAXPY(fuse,x[3],alpha,x[0],x[1]);CHKERRQ(ierr);
+    ierr = VecFuseNorm(fuse,x[3],&nrm[0]);CHKERRQ(ierr);
+    ierr = VecFusePointwiseMult(fuse,x[2],x[3],x[0]);CHKERRQ(ierr);
+    ierr = VecFuseTDot(fuse,x[2],x[1],&tdot[0]);CHKERRQ(ierr);
+    ierr = VecFuseExecute(fuse);CHKERRQ(ierr);
+
+    ierr = VecAXPY(y[0],alpha,y[1]);CHKERRQ(ierr);
+    ierr = VecAYPX(y[1],beta,y[2]);CHKERRQ(ierr);
+    ierr = VecDot(y[0],y[1],&dot[1]);CHKERRQ(ierr);
+    ierr = VecWAXPY(y[3],alpha,y[0],y[1]);CHKERRQ(ierr);
+    ierr = VecNorm(y[3],NORM_2,&nrm[1]);CHKERRQ(ierr);
+    ierr = VecPointwiseMult(y[2],y[3],y[0]);CHKERRQ(ierr);
+    ierr = VecTDot(y[2],y[1],&tdot[1]);CHKERRQ(ierr);
+
+    /* the fused loops do the same operations on each entry as the separate ones, only the reductions may differ */
+    for (i=0; i<4; i++) {ierr = VecEqual(x[i],y[i],&flg[i]);CHKERRQ(ierr);}
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Pass %D: vectors equal %s %s %s %s\n",k,PetscBools[flg[0]],PetscBools[flg[1]],PetscBools[flg[2]],PetscBools[flg[3]]);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"  VecFuseDot() %g VecDot() %g\n",(double)PetscRealPart(dot[0]),(double)PetscRealPart(dot[1]));CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"  VecFuseTDot() %g VecTDot() %g\n",(double)PetscRealPart(tdot[0]),(double)PetscRealPart(tdot[1]));CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"  VecFuseNorm() %g VecNorm() %g\n",(double)nrm[0],(double)nrm[1]);CHKERRQ(ierr);
+  }
+  ierr = VecFuseDestroy(&fuse);CHKERRQ(ierr);
+
+  for (i=0; i<4; i++) {
+    ierr = VecDestroy(&x[i]);CHKERRQ(ierr);
+    ierr = VecDestroy(&y[i]);CHKERRQ(ierr);
+  }
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      output_file: output/ex51_1.out
+
+   test:
+      suffix: 2
+      nsize: 3
+      output_file: output/ex51_1.out
+
+   test:
+      suffix: nest
+      nsize: 2
+      args: -nest
+
+TEST*/
@@ -0,0 +1,93 @@
+static char help[] = "Tests reproducible inner products and norms, the output does not depend on the number of processes.\n\n";
+
+#include <petscvec.h>
+
+int main(int argc,char **argv)
+{
+  Vec            x,y[3];
+  PetscInt       i,k,n = 1000,rstart,rend;
+  PetscScalar    v,dot,dots[3];
+  PetscReal      nrm[2],norms[3];
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+
+  /* Entries of magnitudes between 2^-30 and 2^30 that depend on their global index only, the last vector has a large
+     entry near its end so that the bins used for the first entries must be moved up */
+  ierr = VecCreate(PETSC_COMM_WORLD,&x);CHKERRQ(ierr);
+  ierr = VecSetSizes(x,PETSC_DECIDE,n);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(x);CHKERRQ(ierr);
+  for (k=0; k<3; k++) {ierr = VecDuplicate(x,&y[k]);CHKERRQ(ierr);}
+  ierr = VecGetOwnershipRange(x,&rstart,&rend);CHKERRQ(ierr);
+  for (i=rstart; i<rend; i++) {
+    v    = PetscSinReal(i+1.0)*PetscPowReal(2.0,(PetscReal)((37*i)%61-30));
+    ierr = VecSetValues(x,1,&i,&v,INSERT_VALUES);CHKERRQ(ierr);
+    for (k=0; k<3; k++) {
+      v    = PetscCosReal((k+2.0)*i)*PetscPowReal(2.0,(PetscReal)((17*i+5*k)%41-20));
+      if (k == 2 && i == n-3) v = 1.e40;
+      ierr = VecSetValues(y[k],1,&i,&v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = VecAssemblyBegin(x);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(x);CHKERRQ(ierr);
+  for (k=0; k<3; k++) {
+    ierr = VecAssemblyBegin(y[k]);CHKERRQ(ierr);
+    ierr = VecAssemblyEnd(y[k]);CHKERRQ(ierr);
+  }
+
+  ierr = VecDot(x,y[0],&dot);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"VecDot          %.17e\n",(double)PetscRealPart(dot));CHKERRQ(ierr);
+  ierr = VecTDot(x,y[1],&dot);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"VecTDot         %.17e\n",(double)PetscRealPart(dot));CHKERRQ(ierr);
+  ierr = VecMDot(x,3,y,dots);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"VecMDot         %.17e %.17e %.17e\n",(double)PetscRealPart(dots[0]),(double)PetscRealPart(dots[1]),(double)PetscRealPart(dots[2]));CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_1,&nrm[0]);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"VecNorm 1       %.17e\n",(double)nrm[0]);CHKERRQ(ierr);
+  ierr = VecNorm(y[2],NORM_2,&nrm[0]);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"VecNorm 2       %.17e\n",(double)nrm[0]);CHKERRQ(ierr);
+  ierr = VecNorm(y[1],NORM_1_AND_2,nrm);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"VecNorm 1 and 2 %.17e %.17e\n",(double)nrm[0],(double)nrm[1]);CHKERRQ(ierr);
+  ierr = VecDotNorm2(x,y[0],&dot,&nrm[0]);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"VecDotNorm2     %.17e %.17e\n",(double)PetscRealPart(dot),(double)nrm[0]);CHKERRQ(ierr);
+
+  /* the split phase reductions, with the norms of vectors whose cached norms were invalidated */
+  for (k=0; k<3; k++) {ierr = VecScale(y[k],3.0);CHKERRQ(ierr);}
+  ierr = VecDotBegin(x,y[2],&dot);CHKERRQ(ierr);
+  ierr = VecMDotBegin(x,3,y,dots);CHKERRQ(ierr);
+  ierr = VecNormBegin(y[0],NORM_1,&norms[0]);CHKERRQ(ierr);
+  ierr = VecNormBegin(y[1],NORM_2,&norms[1]);CHKERRQ(ierr);
+  ierr = VecNormBegin(y[2],NORM_INFINITY,&norms[2]);CHKERRQ(ierr);
+  ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)x));CHKERRQ(ierr);
+  ierr = VecDotEnd(x,y[2],&dot);CHKERRQ(ierr);
+  ierr = VecMDotEnd(x,3,y,dots);CHKERRQ(ierr);
+  ierr = VecNormEnd(y[0],NORM_1,&norms[0]);CHKERRQ(ierr);
+  ierr = VecNormEnd(y[1],NORM_2,&norms[1]);CHKERRQ(ierr);
+  ierr = VecNormEnd(y[2],NORM_INFINITY,&norms[2]);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"VecDotBegin     %.17e\n",(double)PetscRealPart(dot));CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"VecMDotBegin    %.17e %.17e %.17e\n",(double)PetscRealPart(dots[0]),(double)PetscRealPart(dots[1]),(double)PetscRealPart(dots[2]));CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"VecNormBegin    %.17e %.17e %.17e\n",(double)norms[0],(double)norms[1],(double)norms[2]);CHKERRQ(ierr);
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  for (k=0; k<3; k++) {ierr = VecDestroy(&y[k]);CHKERRQ(ierr);}
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      nsize: {{1 2 3 5}}
+      requires: double
+      args: -vec_reproducible
+      output_file: output/ex52_1.out
+
+   test:
+      suffix: 2
+      nsize: {{1 4}}
+      requires: double
+      args: -vec_reproducible -splitreduction_async 0
+      output_file: output/ex52_1.out
+
+TEST*/
@@ -0,0 +1,125 @@
+static char help[] = "Tests reusing the arrays of destroyed vectors in VecDuplicate() and MatCreateVecs().\n\n";
+
+#include <petscmat.h>
+
+/* Checks whether the new vector y got the array of a destroyed vector and that its entries are zero; without the
+   pool the array of the destroyed vector is freed and the new one may be at the same address, so it is not checked */
+static PetscErrorCode CheckReused(Vec y,const PetscScalar *old,const char *name)
+{
+  PetscScalar    *a;
+  PetscReal      nrm;
+  PetscInt       reused;
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr   = VecNorm(y,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+  ierr   = VecGetPoolArrays(&flg);CHKERRQ(ierr);
+  if (!flg) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: norm %g\n",name,(double)nrm);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr   = VecGetArray(y,&a);CHKERRQ(ierr);
+  reused = (PetscInt)(a == old);
+  ierr   = VecRestoreArray(y,&a);CHKERRQ(ierr);
+  ierr   = MPI_Allreduce(MPI_IN_PLACE,&reused,1,MPIU_INT,MPI_MIN,PetscObjectComm((PetscObject)y));CHKERRQ(ierr);
+  ierr   = PetscPrintf(PETSC_COMM_WORLD,"%s: reused %D norm %g\n",name,reused,(double)nrm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Vec            x,y,z,g,*w;
+  Mat            A;
+  PetscScalar    *a,*b,*olda,*oldb;
+  PetscInt       i,n = 10,ghost;
+  PetscMPIInt    rank,size;
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = VecCreate(PETSC_COMM_WORLD,&x);CHKERRQ(ierr);
+  ierr = VecSetSizes(x,n,PETSC_DECIDE);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(x);CHKERRQ(ierr);
+  ierr = VecGetPoolArrays(&flg);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Pool arrays %d\n",(int)flg);CHKERRQ(ierr);
+
+  /* a destroyed duplicate gives its array to the next one, whose entries are set to zero */
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = VecSet(y,2.0);CHKERRQ(ierr);
+  ierr = VecGetArray(y,&a);CHKERRQ(ierr);
+  olda = a;
+  ierr = VecRestoreArray(y,&a);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = CheckReused(y,olda,"Duplicate");CHKERRQ(ierr);
+
+  /* the work vectors of solvers */
+  ierr = VecDuplicateVecs(x,3,&w);CHKERRQ(ierr);
+  ierr = VecGetArray(w[2],&b);CHKERRQ(ierr);
+  oldb = b;
+  ierr = VecRestoreArray(w[2],&b);CHKERRQ(ierr);
+  for (i=0; i<3; i++) {ierr = VecSet(w[i],1.0);CHKERRQ(ierr);}
+  ierr = VecDestroyVecs(3,&w);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&z);CHKERRQ(ierr);
+  ierr = CheckReused(z,oldb,"DuplicateVecs");CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+
+  /* a vector with another layout does not get the arrays */
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecCreateMPI(PETSC_COMM_WORLD,n,PETSC_DETERMINE,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(z,&y);CHKERRQ(ierr);
+  ierr = CheckReused(y,olda,"Other layout");CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+
+  /* the ghosted vectors have longer arrays */
+  ghost = (rank*n+n)%(size*n);
+  ierr  = VecCreateGhost(PETSC_COMM_WORLD,n,PETSC_DECIDE,1,&ghost,&g);CHKERRQ(ierr);
+  ierr  = VecDuplicate(g,&y);CHKERRQ(ierr);
+  ierr  = VecSet(y,3.0);CHKERRQ(ierr);
+  ierr  = VecGetArray(y,&a);CHKERRQ(ierr);
+  olda  = a;
+  ierr  = VecRestoreArray(y,&a);CHKERRQ(ierr);
+  ierr  = VecDestroy(&y);CHKERRQ(ierr);
+  ierr  = VecDuplicate(g,&y);CHKERRQ(ierr);
+  ierr  = CheckReused(y,olda,"Ghosted");CHKERRQ(ierr);
+  ierr  = VecGhostUpdateBegin(y,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr  = VecGhostUpdateEnd(y,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr  = VecDestroy(&y);CHKERRQ(ierr);
+  ierr  = VecDestroy(&g);CHKERRQ(ierr);
+
+  /* the vectors of a matrix share its layouts */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,n,n,PETSC_DETERMINE,PETSC_DETERMINE,1,NULL,0,NULL,&A);CHKERRQ(ierr);
+  ierr = MatSetUp(A);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&y,NULL);CHKERRQ(ierr);
+  ierr = VecGetArray(y,&a);CHKERRQ(ierr);
+  olda = a;
+  ierr = VecRestoreArray(y,&a);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&y,NULL);CHKERRQ(ierr);
+  ierr = CheckReused(y,olda,"MatCreateVecs");CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      nsize: {{1 3}}
+      output_file: output/ex53_1.out
+
+   test:
+      suffix: 2
+      nsize: 2
+      args: -vec_pool_arrays 0
+      output_file: output/ex53_2.out
+
+TEST*/
@@ -15,6 +15,9 @@ typedef struct {
   VECHEADER
 } Vec_Seq;
 
+PETSC_INTERN PetscInt  VecSeqMultiBlockSize;
+PETSC_INTERN PetscBool VecSeqMultiUseThreads;
+
 PETSC_INTERN PetscErrorCode VecMDot_Seq(Vec,PetscInt,const Vec[],PetscScalar*);
 PETSC_INTERN PetscErrorCode VecMTDot_Seq(Vec,PetscInt,const Vec[],PetscScalar*);
 PETSC_INTERN PetscErrorCode VecMin_Seq(Vec,PetscInt*,PetscReal*);
@@ -512,7 +512,12 @@ PetscErrorCode VecCreate_MPI_Private(Vec v,PetscBool alloc,PetscInt nghost,const
   s->array_allocated = 0;
   if (alloc && !array) {
     PetscInt n = v->map->n+nghost;
-    ierr               = PetscCalloc1(n,&s->array);CHKERRQ(ierr);
+    ierr = VecPoolGetArray_Private(v->map,n,&s->array);CHKERRQ(ierr);
+    if (!s->array) {
+      ierr = PetscCalloc1(n,&s->array);CHKERRQ(ierr);
+    } else {
+      ierr = PetscArrayzero(s->array,n);CHKERRQ(ierr);
+    }
     ierr               = PetscLogObjectMemory((PetscObject)v,n*sizeof(PetscScalar));CHKERRQ(ierr);
     s->array_allocated = s->array;
   }
@@ -18,7 +18,7 @@ PetscErrorCode VecDestroy_MPI(Vec v)
   PetscLogObjectState((PetscObject)v,"Length=%D",v->map->N);
 #endif
   if (!x) PetscFunctionReturn(0);
-  ierr = PetscFree(x->array_allocated);CHKERRQ(ierr);
+  ierr = VecPoolRestoreArray_Private(v->map,v->map->n+x->nghost,&x->array_allocated);CHKERRQ(ierr);
 
   /* Destroy local representation of vector if it exists */
   if (x->localrep) {
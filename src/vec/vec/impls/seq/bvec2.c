@@ -793,7 +793,7 @@ PetscErrorCode VecDestroy_Seq(Vec v)
 #if defined(PETSC_USE_LOG)
   PetscLogObjectState((PetscObject)v,"Length=%D",v->map->n);
 #endif
-  ierr = PetscFree(vs->array_allocated);CHKERRQ(ierr);
+  ierr = VecPoolRestoreArray_Private(v->map,v->map->n,&vs->array_allocated);CHKERRQ(ierr);
   ierr = PetscFree(v->data);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -812,8 +812,8 @@ PetscErrorCode VecDuplicate_Seq(Vec win,Vec *V)
   PetscFunctionBegin;
   ierr = VecCreate(PetscObjectComm((PetscObject)win),V);CHKERRQ(ierr);
   ierr = VecSetSizes(*V,win->map->n,win->map->n);CHKERRQ(ierr);
+  ierr = PetscLayoutReference(win->map,&(*V)->map);CHKERRQ(ierr); /* before the type is set, so the array may be reused */
   ierr = VecSetType(*V,((PetscObject)win)->type_name);CHKERRQ(ierr);
-  ierr = PetscLayoutReference(win->map,&(*V)->map);CHKERRQ(ierr);
   ierr = PetscObjectListDuplicate(((PetscObject)win)->olist,&((PetscObject)(*V))->olist);CHKERRQ(ierr);
   ierr = PetscFunctionListDuplicate(((PetscObject)win)->qlist,&((PetscObject)(*V))->qlist);CHKERRQ(ierr);
 
@@ -32,7 +32,8 @@ PETSC_EXTERN PetscErrorCode VecCreate_Seq(Vec V)
   ierr = MPI_Comm_size(PetscObjectComm((PetscObject)V),&size);CHKERRQ(ierr);
   if (size > 1) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Cannot create VECSEQ on more than one process");
 #if !defined(PETSC_USE_MIXED_PRECISION)
-  ierr = PetscMalloc1(n,&array);CHKERRQ(ierr);
+  ierr = VecPoolGetArray_Private(V->map,n,&array);CHKERRQ(ierr);
+  if (!array) {ierr = PetscMalloc1(n,&array);CHKERRQ(ierr);}
   ierr = PetscLogObjectMemory((PetscObject)V, n*sizeof(PetscScalar));CHKERRQ(ierr);
   ierr = VecCreate_Seq_Private(V,array);CHKERRQ(ierr);
 
@@ -5,8 +5,36 @@
 */
 #include <../src/vec/vec/impls/dvecimpl.h>
 #include <petsc/private/kernels/petscaxpy.h>
+#if defined(PETSC_HAVE_IMMINTRIN_H) && (defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__))) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+#include <immintrin.h>
+#define PETSC_VEC_MULTI_USE_SIMD
+#endif
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+extern PetscInt PetscNumOMPThreads;
+#endif
 
+/*
+   VecMDot_Seq() and VecMAXPY_Seq() tile over the vector length: each tile of VecSeqMultiBlockSize entries of x is
+   combined with up to VEC_MULTI_MAXV vectors y before moving to the next one, so x stays in cache and is read (and
+   for VecMAXPY_Seq() written) once instead of once for every four vectors. A block size of 0 turns the tiling off.
+   The tiles are shared among the OpenMP threads for long vectors when VecSeqMultiUseThreads is set, which is off by
+   default since the calling code may already be running on the threads.
+*/
+PetscInt  VecSeqMultiBlockSize  = 4096;
+PetscBool VecSeqMultiUseThreads = PETSC_FALSE;
+#define VEC_MULTI_MAXV 64
 
+/* the number of threads used for a vector of length n split into tiles of length bs */
+PETSC_STATIC_INLINE PetscInt VecMultiNumThreads_Private(PetscInt n,PetscInt bs)
+{
+  PetscInt nt = 1;
+
+#if defined(PETSC_HAVE_OPENMP)
+  if (VecSeqMultiUseThreads && PetscNumOMPThreads > 1 && n >= PetscNumOMPThreads*bs) nt = PetscNumOMPThreads;
+#endif
+  return nt;
+}
 
 #if defined(PETSC_USE_FORTRAN_KERNEL_MDOT)
 #include <../src/vec/vec/impls/seq/ftn-kernels/fmdot.h>
@@ -91,200 +119,147 @@ PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
 }
 
 #else
-PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+#if defined(PETSC_VEC_MULTI_USE_SIMD) && !defined(__AVX512F__)
+PETSC_STATIC_INLINE PetscScalar VecMultiReduceAVX2_Private(__m256d v)
 {
-  PetscErrorCode    ierr;
-  PetscInt          n = xin->map->n,i,j,nv_rem,j_rem;
-  PetscScalar       sum0,sum1,sum2,sum3,x0,x1,x2,x3;
-  const PetscScalar *yy0,*yy1,*yy2,*yy3,*x,*xbase;
-  Vec               *yy;
+  __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v),_mm256_extractf128_pd(v,1));
 
-  PetscFunctionBegin;
-  sum0 = 0.;
-  sum1 = 0.;
-  sum2 = 0.;
+  return _mm_cvtsd_f64(_mm_add_sd(s,_mm_unpackhi_pd(s,s)));
+}
+#endif
 
-  i      = nv;
-  nv_rem = nv&0x3;
-  yy     = (Vec*)yin;
-  j      = n;
-  ierr   = VecGetArrayRead(xin,&xbase);CHKERRQ(ierr);
-  x      = xbase;
+/* z[j] += sum of x[i] conj(y[j][i]) over [s,e) for four vectors; e-s is a multiple of four */
+PETSC_STATIC_INLINE void VecMDotKernel4_Private(PetscInt s,PetscInt e,const PetscScalar *x,const PetscScalar *const *y,PetscScalar *z)
+{
+  const PetscScalar *yy0 = y[0],*yy1 = y[1],*yy2 = y[2],*yy3 = y[3];
+  PetscInt          i = s;
+#if defined(PETSC_VEC_MULTI_USE_SIMD) && defined(__AVX512F__)
+  __m512d           vx,v0 = _mm512_setzero_pd(),v1 = _mm512_setzero_pd(),v2 = _mm512_setzero_pd(),v3 = _mm512_setzero_pd();
+  __mmask8          m;
+
+  for (; i<e; i+=8) {
+    m  = (e-i) >= 8 ? 0xff : 0x0f;
+    vx = _mm512_maskz_loadu_pd(m,x+i);
+    v0 = _mm512_fmadd_pd(vx,_mm512_maskz_loadu_pd(m,yy0+i),v0);
+    v1 = _mm512_fmadd_pd(vx,_mm512_maskz_loadu_pd(m,yy1+i),v1);
+    v2 = _mm512_fmadd_pd(vx,_mm512_maskz_loadu_pd(m,yy2+i),v2);
+    v3 = _mm512_fmadd_pd(vx,_mm512_maskz_loadu_pd(m,yy3+i),v3);
+  }
+  z[0] += _mm512_reduce_add_pd(v0);
+  z[1] += _mm512_reduce_add_pd(v1);
+  z[2] += _mm512_reduce_add_pd(v2);
+  z[3] += _mm512_reduce_add_pd(v3);
+#elif defined(PETSC_VEC_MULTI_USE_SIMD)
+  __m256d           vx,v0 = _mm256_setzero_pd(),v1 = _mm256_setzero_pd(),v2 = _mm256_setzero_pd(),v3 = _mm256_setzero_pd();
+
+  for (; i<e; i+=4) {
+    vx = _mm256_loadu_pd(x+i);
+    v0 = _mm256_fmadd_pd(vx,_mm256_loadu_pd(yy0+i),v0);
+    v1 = _mm256_fmadd_pd(vx,_mm256_loadu_pd(yy1+i),v1);
+    v2 = _mm256_fmadd_pd(vx,_mm256_loadu_pd(yy2+i),v2);
+    v3 = _mm256_fmadd_pd(vx,_mm256_loadu_pd(yy3+i),v3);
+  }
+  z[0] += VecMultiReduceAVX2_Private(v0);
+  z[1] += VecMultiReduceAVX2_Private(v1);
+  z[2] += VecMultiReduceAVX2_Private(v2);
+  z[3] += VecMultiReduceAVX2_Private(v3);
+#else
+  PetscScalar       sum0 = z[0],sum1 = z[1],sum2 = z[2],sum3 = z[3],x0,x1,x2,x3;
+
+  for (; i<e; i+=4) {
+    x0 = x[i];
+    x1 = x[i+1];
+    x2 = x[i+2];
+    x3 = x[i+3];
+
+    sum0 += x0*PetscConj(yy0[i]) + x1*PetscConj(yy0[i+1]) + x2*PetscConj(yy0[i+2]) + x3*PetscConj(yy0[i+3]);
+    sum1 += x0*PetscConj(yy1[i]) + x1*PetscConj(yy1[i+1]) + x2*PetscConj(yy1[i+2]) + x3*PetscConj(yy1[i+3]);
+    sum2 += x0*PetscConj(yy2[i]) + x1*PetscConj(yy2[i+1]) + x2*PetscConj(yy2[i+2]) + x3*PetscConj(yy2[i+3]);
+    sum3 += x0*PetscConj(yy3[i]) + x1*PetscConj(yy3[i+1]) + x2*PetscConj(yy3[i+2]) + x3*PetscConj(yy3[i+3]);
+  }
+  z[0] = sum0;
+  z[1] = sum1;
+  z[2] = sum2;
+  z[3] = sum3;
+#endif
+}
 
-  switch (nv_rem) {
-  case 3:
-    ierr = VecGetArrayRead(yy[0],&yy0);CHKERRQ(ierr);
-    ierr = VecGetArrayRead(yy[1],&yy1);CHKERRQ(ierr);
-    ierr = VecGetArrayRead(yy[2],&yy2);CHKERRQ(ierr);
-    switch (j_rem=j&0x3) {
-    case 3:
-      x2    = x[2];
-      sum0 += x2*PetscConj(yy0[2]); sum1 += x2*PetscConj(yy1[2]);
-      sum2 += x2*PetscConj(yy2[2]);
-    case 2:
-      x1    = x[1];
-      sum0 += x1*PetscConj(yy0[1]); sum1 += x1*PetscConj(yy1[1]);
-      sum2 += x1*PetscConj(yy2[1]);
-    case 1:
-      x0    = x[0];
-      sum0 += x0*PetscConj(yy0[0]); sum1 += x0*PetscConj(yy1[0]);
-      sum2 += x0*PetscConj(yy2[0]);
-    case 0:
-      x   += j_rem;
-      yy0 += j_rem;
-      yy1 += j_rem;
-      yy2 += j_rem;
-      j   -= j_rem;
-      break;
-    }
-    while (j>0) {
-      x0 = x[0];
-      x1 = x[1];
-      x2 = x[2];
-      x3 = x[3];
-      x += 4;
+/* the same for a single vector */
+PETSC_STATIC_INLINE void VecMDotKernel1_Private(PetscInt s,PetscInt e,const PetscScalar *x,const PetscScalar *yy0,PetscScalar *z)
+{
+  PetscInt          i = s;
+#if defined(PETSC_VEC_MULTI_USE_SIMD) && defined(__AVX512F__)
+  __m512d           v0 = _mm512_setzero_pd();
+  __mmask8          m;
+
+  for (; i<e; i+=8) {
+    m  = (e-i) >= 8 ? 0xff : 0x0f;
+    v0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m,x+i),_mm512_maskz_loadu_pd(m,yy0+i),v0);
+  }
+  z[0] += _mm512_reduce_add_pd(v0);
+#elif defined(PETSC_VEC_MULTI_USE_SIMD)
+  __m256d           v0 = _mm256_setzero_pd();
 
-      sum0 += x0*PetscConj(yy0[0]) + x1*PetscConj(yy0[1]) + x2*PetscConj(yy0[2]) + x3*PetscConj(yy0[3]); yy0+=4;
-      sum1 += x0*PetscConj(yy1[0]) + x1*PetscConj(yy1[1]) + x2*PetscConj(yy1[2]) + x3*PetscConj(yy1[3]); yy1+=4;
-      sum2 += x0*PetscConj(yy2[0]) + x1*PetscConj(yy2[1]) + x2*PetscConj(yy2[2]) + x3*PetscConj(yy2[3]); yy2+=4;
-      j    -= 4;
-    }
-    z[0] = sum0;
-    z[1] = sum1;
-    z[2] = sum2;
-    ierr = VecRestoreArrayRead(yy[0],&yy0);CHKERRQ(ierr);
-    ierr = VecRestoreArrayRead(yy[1],&yy1);CHKERRQ(ierr);
-    ierr = VecRestoreArrayRead(yy[2],&yy2);CHKERRQ(ierr);
-    break;
-  case 2:
-    ierr = VecGetArrayRead(yy[0],&yy0);CHKERRQ(ierr);
-    ierr = VecGetArrayRead(yy[1],&yy1);CHKERRQ(ierr);
-    switch (j_rem=j&0x3) {
-    case 3:
-      x2    = x[2];
-      sum0 += x2*PetscConj(yy0[2]); sum1 += x2*PetscConj(yy1[2]);
-    case 2:
-      x1    = x[1];
-      sum0 += x1*PetscConj(yy0[1]); sum1 += x1*PetscConj(yy1[1]);
-    case 1:
-      x0    = x[0];
-      sum0 += x0*PetscConj(yy0[0]); sum1 += x0*PetscConj(yy1[0]);
-    case 0:
-      x   += j_rem;
-      yy0 += j_rem;
-      yy1 += j_rem;
-      j   -= j_rem;
-      break;
-    }
-    while (j>0) {
-      x0 = x[0];
-      x1 = x[1];
-      x2 = x[2];
-      x3 = x[3];
-      x += 4;
+  for (; i<e; i+=4) v0 = _mm256_fmadd_pd(_mm256_loadu_pd(x+i),_mm256_loadu_pd(yy0+i),v0);
+  z[0] += VecMultiReduceAVX2_Private(v0);
+#else
+  PetscScalar       sum0 = z[0];
 
-      sum0 += x0*PetscConj(yy0[0]) + x1*PetscConj(yy0[1]) + x2*PetscConj(yy0[2]) + x3*PetscConj(yy0[3]); yy0+=4;
-      sum1 += x0*PetscConj(yy1[0]) + x1*PetscConj(yy1[1]) + x2*PetscConj(yy1[2]) + x3*PetscConj(yy1[3]); yy1+=4;
-      j    -= 4;
-    }
-    z[0] = sum0;
-    z[1] = sum1;
+  for (; i<e; i+=4) sum0 += x[i]*PetscConj(yy0[i]) + x[i+1]*PetscConj(yy0[i+1]) + x[i+2]*PetscConj(yy0[i+2]) + x[i+3]*PetscConj(yy0[i+3]);
+  z[0] = sum0;
+#endif
+}
 
-    ierr = VecRestoreArrayRead(yy[0],&yy0);CHKERRQ(ierr);
-    ierr = VecRestoreArrayRead(yy[1],&yy1);CHKERRQ(ierr);
-    break;
-  case 1:
-    ierr = VecGetArrayRead(yy[0],&yy0);CHKERRQ(ierr);
-    switch (j_rem=j&0x3) {
-    case 3:
-      x2 = x[2]; sum0 += x2*PetscConj(yy0[2]);
-    case 2:
-      x1 = x[1]; sum0 += x1*PetscConj(yy0[1]);
-    case 1:
-      x0 = x[0]; sum0 += x0*PetscConj(yy0[0]);
-    case 0:
-      x   += j_rem;
-      yy0 += j_rem;
-      j   -= j_rem;
-      break;
-    }
-    while (j>0) {
-      sum0 += x[0]*PetscConj(yy0[0]) + x[1]*PetscConj(yy0[1])
-            + x[2]*PetscConj(yy0[2]) + x[3]*PetscConj(yy0[3]);
-      yy0  +=4;
-      j    -= 4; x+=4;
-    }
-    z[0] = sum0;
+/* accumulates the products of the tiles [s,e) of x with the nv vectors y into z */
+static void VecMDotTiles_Private(PetscInt s,PetscInt e,PetscInt bs,const PetscScalar *x,PetscInt nv,const PetscScalar *const *y,PetscScalar *z)
+{
+  PetscInt start,end,j;
 
-    ierr = VecRestoreArrayRead(yy[0],&yy0);CHKERRQ(ierr);
-    break;
-  case 0:
-    break;
+  for (start=s; start<e; start=end) {
+    end = PetscMin(start+bs,e);
+    for (j=0; j<nv-3; j+=4) VecMDotKernel4_Private(start,end,x,y+j,z+j);
+    for (; j<nv; j++) VecMDotKernel1_Private(start,end,x,y[j],z+j);
   }
-  z  += nv_rem;
-  i  -= nv_rem;
-  yy += nv_rem;
+}
 
-  while (i >0) {
-    sum0 = 0.;
-    sum1 = 0.;
-    sum2 = 0.;
-    sum3 = 0.;
-    ierr = VecGetArrayRead(yy[0],&yy0);CHKERRQ(ierr);
-    ierr = VecGetArrayRead(yy[1],&yy1);CHKERRQ(ierr);
-    ierr = VecGetArrayRead(yy[2],&yy2);CHKERRQ(ierr);
-    ierr = VecGetArrayRead(yy[3],&yy3);CHKERRQ(ierr);
+PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = xin->map->n,n_rem = n&0x3,bs,nt,ntiles,nb,i,j,k,t;
+  const PetscScalar *x,*y[VEC_MULTI_MAXV];
+  PetscScalar       *work = NULL;
 
-    j = n;
-    x = xbase;
-    switch (j_rem=j&0x3) {
-    case 3:
-      x2    = x[2];
-      sum0 += x2*PetscConj(yy0[2]); sum1 += x2*PetscConj(yy1[2]);
-      sum2 += x2*PetscConj(yy2[2]); sum3 += x2*PetscConj(yy3[2]);
-    case 2:
-      x1    = x[1];
-      sum0 += x1*PetscConj(yy0[1]); sum1 += x1*PetscConj(yy1[1]);
-      sum2 += x1*PetscConj(yy2[1]); sum3 += x1*PetscConj(yy3[1]);
-    case 1:
-      x0    = x[0];
-      sum0 += x0*PetscConj(yy0[0]); sum1 += x0*PetscConj(yy1[0]);
-      sum2 += x0*PetscConj(yy2[0]); sum3 += x0*PetscConj(yy3[0]);
-    case 0:
-      x   += j_rem;
-      yy0 += j_rem;
-      yy1 += j_rem;
-      yy2 += j_rem;
-      yy3 += j_rem;
-      j   -= j_rem;
-      break;
+  PetscFunctionBegin;
+  bs     = VecSeqMultiBlockSize > 0 ? VecSeqMultiBlockSize : n;
+  bs     = PetscMax(bs-(bs&0x3),4);
+  nt     = VecMultiNumThreads_Private(n,bs);
+  ntiles = (n-n_rem+bs-1)/bs;
+  if (nt > 1) {ierr = PetscMalloc1(nt*VEC_MULTI_MAXV,&work);CHKERRQ(ierr);}
+  ierr = VecGetArrayRead(xin,&x);CHKERRQ(ierr);
+  for (k=0; k<nv; k+=nb) {
+    nb = PetscMin(nv-k,VEC_MULTI_MAXV);
+    for (j=0; j<nb; j++) {
+      ierr = VecGetArrayRead(yin[k+j],&y[j]);CHKERRQ(ierr);
+      /* the leading n%4 entries, so that every tile is a multiple of four long */
+      z[k+j] = 0.0;
+      for (i=n_rem-1; i>=0; i--) z[k+j] += x[i]*PetscConj(y[j][i]);
     }
-    while (j>0) {
-      x0 = x[0];
-      x1 = x[1];
-      x2 = x[2];
-      x3 = x[3];
-      x += 4;
-
-      sum0 += x0*PetscConj(yy0[0]) + x1*PetscConj(yy0[1]) + x2*PetscConj(yy0[2]) + x3*PetscConj(yy0[3]); yy0+=4;
-      sum1 += x0*PetscConj(yy1[0]) + x1*PetscConj(yy1[1]) + x2*PetscConj(yy1[2]) + x3*PetscConj(yy1[3]); yy1+=4;
-      sum2 += x0*PetscConj(yy2[0]) + x1*PetscConj(yy2[1]) + x2*PetscConj(yy2[2]) + x3*PetscConj(yy2[3]); yy2+=4;
-      sum3 += x0*PetscConj(yy3[0]) + x1*PetscConj(yy3[1]) + x2*PetscConj(yy3[2]) + x3*PetscConj(yy3[3]); yy3+=4;
-      j    -= 4;
+    if (nt == 1) VecMDotTiles_Private(n_rem,n,bs,x,nb,y,z+k);
+    else {
+      /* each thread sums over a contiguous range of tiles; the partial sums are added in thread order so the result does not vary between runs */
+      for (j=0; j<nt*nb; j++) work[j] = 0.0;
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+#endif
+      for (t=0; t<nt; t++) VecMDotTiles_Private(n_rem+(t*ntiles/nt)*bs,PetscMin(n_rem+((t+1)*ntiles/nt)*bs,n),bs,x,nb,y,work+t*nb);
+      for (t=0; t<nt; t++) {
+        for (j=0; j<nb; j++) z[k+j] += work[t*nb+j];
+      }
     }
-    z[0] = sum0;
-    z[1] = sum1;
-    z[2] = sum2;
-    z[3] = sum3;
-    z   += 4;
-    i   -= 4;
-    ierr = VecRestoreArrayRead(yy[0],&yy0);CHKERRQ(ierr);
-    ierr = VecRestoreArrayRead(yy[1],&yy1);CHKERRQ(ierr);
-    ierr = VecRestoreArrayRead(yy[2],&yy2);CHKERRQ(ierr);
-    ierr = VecRestoreArrayRead(yy[3],&yy3);CHKERRQ(ierr);
-    yy  += 4;
+    for (j=0; j<nb; j++) {ierr = VecRestoreArrayRead(yin[k+j],&y[j]);CHKERRQ(ierr);}
   }
-  ierr = VecRestoreArrayRead(xin,&xbase);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xin,&x);CHKERRQ(ierr);
+  ierr = PetscFree(work);CHKERRQ(ierr);
   ierr = PetscLogFlops(PetscMax(nv*(2.0*xin->map->n-1),0.0));CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -553,71 +528,103 @@ PetscErrorCode VecSet_Seq(Vec xin,PetscScalar alpha)
   PetscFunctionReturn(0);
 }
 
-PetscErrorCode VecMAXPY_Seq(Vec xin, PetscInt nv,const PetscScalar *alpha,Vec *y)
+/* x[i] += alpha[0] y[0][i] + ... + alpha[3] y[3][i] over [s,e) */
+PETSC_STATIC_INLINE void VecMAXPYKernel4_Private(PetscInt s,PetscInt e,PetscScalar *xx,const PetscScalar *alpha,const PetscScalar *const *y)
 {
-  PetscErrorCode    ierr;
-  PetscInt          n = xin->map->n,j,j_rem;
-  const PetscScalar *yy0,*yy1,*yy2,*yy3;
-  PetscScalar       *xx,alpha0,alpha1,alpha2,alpha3;
-
-#if defined(PETSC_HAVE_PRAGMA_DISJOINT)
-#pragma disjoint(*xx,*yy0,*yy1,*yy2,*yy3,*alpha)
+  PetscScalar       alpha0 = alpha[0],alpha1 = alpha[1],alpha2 = alpha[2],alpha3 = alpha[3],*x = xx+s;
+  const PetscScalar *yy0 = y[0]+s,*yy1 = y[1]+s,*yy2 = y[2]+s,*yy3 = y[3]+s;
+  PetscInt          n = e-s;
+#if defined(PETSC_VEC_MULTI_USE_SIMD) && defined(__AVX512F__)
+  __m512d           vx,va0 = _mm512_set1_pd(alpha0),va1 = _mm512_set1_pd(alpha1),va2 = _mm512_set1_pd(alpha2),va3 = _mm512_set1_pd(alpha3);
+  __mmask8          m;
+  PetscInt          i;
+
+  for (i=0; i<n; i+=8) {
+    m  = (n-i) >= 8 ? 0xff : (__mmask8)((1 << (n-i))-1);
+    vx = _mm512_maskz_loadu_pd(m,x+i);
+    vx = _mm512_fmadd_pd(va0,_mm512_maskz_loadu_pd(m,yy0+i),vx);
+    vx = _mm512_fmadd_pd(va1,_mm512_maskz_loadu_pd(m,yy1+i),vx);
+    vx = _mm512_fmadd_pd(va2,_mm512_maskz_loadu_pd(m,yy2+i),vx);
+    vx = _mm512_fmadd_pd(va3,_mm512_maskz_loadu_pd(m,yy3+i),vx);
+    _mm512_mask_storeu_pd(x+i,m,vx);
+  }
+#elif defined(PETSC_VEC_MULTI_USE_SIMD)
+  __m256d           vx,va0 = _mm256_set1_pd(alpha0),va1 = _mm256_set1_pd(alpha1),va2 = _mm256_set1_pd(alpha2),va3 = _mm256_set1_pd(alpha3);
+  PetscInt          i;
+
+  for (i=0; i<n-3; i+=4) {
+    vx = _mm256_loadu_pd(x+i);
+    vx = _mm256_fmadd_pd(va0,_mm256_loadu_pd(yy0+i),vx);
+    vx = _mm256_fmadd_pd(va1,_mm256_loadu_pd(yy1+i),vx);
+    vx = _mm256_fmadd_pd(va2,_mm256_loadu_pd(yy2+i),vx);
+    vx = _mm256_fmadd_pd(va3,_mm256_loadu_pd(yy3+i),vx);
+    _mm256_storeu_pd(x+i,vx);
+  }
+  for (; i<n; i++) x[i] += alpha0*yy0[i] + alpha1*yy1[i] + alpha2*yy2[i] + alpha3*yy3[i];
+#else
+  PetscKernelAXPY4(x,alpha0,alpha1,alpha2,alpha3,yy0,yy1,yy2,yy3,n);
 #endif
+}
 
-  PetscFunctionBegin;
-  ierr = PetscLogFlops(nv*2.0*n);CHKERRQ(ierr);
-  ierr = VecGetArray(xin,&xx);CHKERRQ(ierr);
-  switch (j_rem=nv&0x3) {
-  case 3:
-    ierr   = VecGetArrayRead(y[0],&yy0);CHKERRQ(ierr);
-    ierr   = VecGetArrayRead(y[1],&yy1);CHKERRQ(ierr);
-    ierr   = VecGetArrayRead(y[2],&yy2);CHKERRQ(ierr);
-    alpha0 = alpha[0];
-    alpha1 = alpha[1];
-    alpha2 = alpha[2];
-    alpha += 3;
-    PetscKernelAXPY3(xx,alpha0,alpha1,alpha2,yy0,yy1,yy2,n);
-    ierr = VecRestoreArrayRead(y[0],&yy0);CHKERRQ(ierr);
-    ierr = VecRestoreArrayRead(y[1],&yy1);CHKERRQ(ierr);
-    ierr = VecRestoreArrayRead(y[2],&yy2);CHKERRQ(ierr);
-    y   += 3;
-    break;
-  case 2:
-    ierr   = VecGetArrayRead(y[0],&yy0);CHKERRQ(ierr);
-    ierr   = VecGetArrayRead(y[1],&yy1);CHKERRQ(ierr);
+/* applies the tiles [s,e) of the update with the nv vectors y to x; the first nv%4 vectors are handled together as the unblocked code did */
+static void VecMAXPYTiles_Private(PetscInt s,PetscInt e,PetscInt bs,PetscScalar *xx,PetscInt nv,const PetscScalar *alpha,const PetscScalar *const *y)
+{
+  PetscScalar       alpha0,alpha1,alpha2,*x;
+  const PetscScalar *yy0,*yy1,*yy2;
+  PetscInt          start,end,j,n,nv_rem = nv&0x3;
+
+  for (start=s; start<e; start=end) {
+    end    = PetscMin(start+bs,e);
+    n      = end-start;
+    x      = xx+start;
     alpha0 = alpha[0];
-    alpha1 = alpha[1];
-    alpha +=2;
-    PetscKernelAXPY2(xx,alpha0,alpha1,yy0,yy1,n);
-    ierr = VecRestoreArrayRead(y[0],&yy0);CHKERRQ(ierr);
-    ierr = VecRestoreArrayRead(y[1],&yy1);CHKERRQ(ierr);
-    y   +=2;
-    break;
-  case 1:
-    ierr   = VecGetArrayRead(y[0],&yy0);CHKERRQ(ierr);
-    alpha0 = *alpha++;
-    PetscKernelAXPY(xx,alpha0,yy0,n);
-    ierr = VecRestoreArrayRead(y[0],&yy0);CHKERRQ(ierr);
-    y   +=1;
-    break;
+    yy0    = y[0]+start;
+    switch (nv_rem) {
+    case 3:
+      alpha1 = alpha[1]; alpha2 = alpha[2];
+      yy1    = y[1]+start; yy2 = y[2]+start;
+      PetscKernelAXPY3(x,alpha0,alpha1,alpha2,yy0,yy1,yy2,n);
+      break;
+    case 2:
+      alpha1 = alpha[1];
+      yy1    = y[1]+start;
+      PetscKernelAXPY2(x,alpha0,alpha1,yy0,yy1,n);
+      break;
+    case 1:
+      PetscKernelAXPY(x,alpha0,yy0,n);
+      break;
+    }
+    for (j=nv_rem; j<nv; j+=4) VecMAXPYKernel4_Private(start,end,xx,alpha+j,y+j);
   }
-  for (j=j_rem; j<nv; j+=4) {
-    ierr   = VecGetArrayRead(y[0],&yy0);CHKERRQ(ierr);
-    ierr   = VecGetArrayRead(y[1],&yy1);CHKERRQ(ierr);
-    ierr   = VecGetArrayRead(y[2],&yy2);CHKERRQ(ierr);
-    ierr   = VecGetArrayRead(y[3],&yy3);CHKERRQ(ierr);
-    alpha0 = alpha[0];
-    alpha1 = alpha[1];
-    alpha2 = alpha[2];
-    alpha3 = alpha[3];
-    alpha += 4;
-
-    PetscKernelAXPY4(xx,alpha0,alpha1,alpha2,alpha3,yy0,yy1,yy2,yy3,n);
-    ierr = VecRestoreArrayRead(y[0],&yy0);CHKERRQ(ierr);
-    ierr = VecRestoreArrayRead(y[1],&yy1);CHKERRQ(ierr);
-    ierr = VecRestoreArrayRead(y[2],&yy2);CHKERRQ(ierr);
-    ierr = VecRestoreArrayRead(y[3],&yy3);CHKERRQ(ierr);
-    y   += 4;
+}
+
+PetscErrorCode VecMAXPY_Seq(Vec xin, PetscInt nv,const PetscScalar *alpha,Vec *y)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = xin->map->n,bs,nt,ntiles,nb,j,k,t;
+  const PetscScalar *yy[VEC_MULTI_MAXV];
+  PetscScalar       *xx;
+
+  PetscFunctionBegin;
+  ierr   = PetscLogFlops(nv*2.0*n);CHKERRQ(ierr);
+  bs     = VecSeqMultiBlockSize > 0 ? VecSeqMultiBlockSize : n;
+  bs     = PetscMax(bs,1);
+  nt     = VecMultiNumThreads_Private(n,bs);
+  ntiles = (n+bs-1)/bs;
+  ierr   = VecGetArray(xin,&xx);CHKERRQ(ierr);
+  for (k=0; k<nv; k+=nb) {
+    /* only the first batch has a number of vectors that is not a multiple of four */
+    nb = (nv-k)&0x3 ? ((nv-k)&0x3) + VEC_MULTI_MAXV-4 : VEC_MULTI_MAXV;
+    nb = PetscMin(nb,nv-k);
+    for (j=0; j<nb; j++) {ierr = VecGetArrayRead(y[k+j],&yy[j]);CHKERRQ(ierr);}
+    if (nt == 1) VecMAXPYTiles_Private(0,n,bs,xx,nb,alpha+k,yy);
+    else {
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+#endif
+      for (t=0; t<nt; t++) VecMAXPYTiles_Private((t*ntiles/nt)*bs,PetscMin(((t+1)*ntiles/nt)*bs,n),bs,xx,nb,alpha+k,yy);
+    }
+    for (j=0; j<nb; j++) {ierr = VecRestoreArrayRead(y[k+j],&yy[j]);CHKERRQ(ierr);}
   }
   ierr = VecRestoreArray(xin,&xx);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -1,5 +1,6 @@
 
 #include <petsc/private/vecimpl.h>
+#include <../src/vec/vec/impls/dvecimpl.h>
 #include <petsc/private/isimpl.h>
 #include <petscpf.h>
 #include <petscsf.h>
@@ -148,7 +149,7 @@ static PetscBool  VecPackageInitialized = PETSC_FALSE;
 PetscErrorCode  VecInitializePackage(void)
 {
   char           logList[256];
-  PetscBool      opt,pkg;
+  PetscBool      opt,pkg,flg;
   PetscErrorCode ierr;
   PetscInt       i;
 
@@ -175,6 +176,7 @@ PetscErrorCode  VecInitializePackage(void)
   ierr = PetscLogEventRegister("VecAXPY",          VEC_CLASSID,&VEC_AXPY);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecAYPX",          VEC_CLASSID,&VEC_AYPX);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecAXPBYCZ",       VEC_CLASSID,&VEC_AXPBYPCZ);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("VecFuse",          VEC_CLASSID,&VEC_Fuse);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecWAXPY",         VEC_CLASSID,&VEC_WAXPY);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecMAXPY",         VEC_CLASSID,&VEC_MAXPY);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecSwap",          VEC_CLASSID,&VEC_Swap);CHKERRQ(ierr);
@@ -234,12 +236,27 @@ PetscErrorCode  VecInitializePackage(void)
     if (pkg) {ierr = PetscLogEventExcludeClass(VEC_SCATTER_CLASSID);CHKERRQ(ierr);}
   }
 
+  /* Tiling and threading of VecMDot() and VecMAXPY() for the vectors with a PETSc native array */
+  ierr = PetscOptionsGetInt(NULL,NULL,"-vec_multi_block_size",&VecSeqMultiBlockSize,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-vec_multi_use_threads",&VecSeqMultiUseThreads,NULL);CHKERRQ(ierr);
+
+  /* Reproducible inner products and norms */
+  ierr = PetscOptionsGetBool(NULL,NULL,"-vec_reproducible",&flg,&opt);CHKERRQ(ierr);
+  if (opt) {ierr = VecSetReproducibleReductions(flg);CHKERRQ(ierr);}
+  ierr = MPI_Type_contiguous(sizeof(PetscBinnedSum)/sizeof(PetscReal),MPIU_REAL,&MPIU_BINNEDSUM);CHKERRQ(ierr);
+  ierr = MPI_Type_commit(&MPIU_BINNEDSUM);CHKERRQ(ierr);
+
+  /* Reuse of the arrays of destroyed vectors */
+  ierr = PetscOptionsGetBool(NULL,NULL,"-vec_pool_arrays",&VecPoolArrays,NULL);CHKERRQ(ierr);
+  ierr = PetscMallocViewRegister(VecPoolView_Private);CHKERRQ(ierr);
+
   /*
     Create the special MPI reduction operation that may be used by VecNorm/DotBegin()
   */
   ierr = MPI_Op_create(PetscSplitReduction_Local,1,&PetscSplitReduction_Op);CHKERRQ(ierr);
   ierr = MPI_Op_create(MPIU_MaxIndex_Local,2,&MPIU_MAXINDEX_OP);CHKERRQ(ierr);
   ierr = MPI_Op_create(MPIU_MinIndex_Local,2,&MPIU_MININDEX_OP);CHKERRQ(ierr);
+  ierr = MPI_Op_create(PetscBinnedSum_Local,1,&MPIU_BINNEDSUM_OP);CHKERRQ(ierr);
 
   /* Register the different norm types for cached norms */
   for (i=0; i<4; i++) {
@@ -269,6 +286,8 @@ PetscErrorCode  VecFinalizePackage(void)
   ierr = MPI_Op_free(&PetscSplitReduction_Op);CHKERRQ(ierr);
   ierr = MPI_Op_free(&MPIU_MAXINDEX_OP);CHKERRQ(ierr);
   ierr = MPI_Op_free(&MPIU_MININDEX_OP);CHKERRQ(ierr);
+  ierr = MPI_Op_free(&MPIU_BINNEDSUM_OP);CHKERRQ(ierr);
+  ierr = MPI_Type_free(&MPIU_BINNEDSUM);CHKERRQ(ierr);
   if (Petsc_Reduction_keyval != MPI_KEYVAL_INVALID) {
     ierr = MPI_Comm_free_keyval(&Petsc_Reduction_keyval);CHKERRQ(ierr);
   }
@@ -121,7 +121,11 @@ PetscErrorCode  VecDot(Vec x,Vec y,PetscScalar *val)
   VecCheckSameSize(x,1,y,2);
 
   ierr = PetscLogEventBegin(VEC_Dot,x,y,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->dot)(x,y,val);CHKERRQ(ierr);
+  if (VecUseBinned_Private(x,1,&y)) {
+    ierr = VecDotBinned_Private(x,y,PETSC_TRUE,val);CHKERRQ(ierr);
+  } else {
+    ierr = (*x->ops->dot)(x,y,val);CHKERRQ(ierr);
+  }
   ierr = PetscLogEventEnd(VEC_Dot,x,y,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -223,7 +227,11 @@ PetscErrorCode  VecNorm(Vec x,NormType type,PetscReal *val)
     if (flg) PetscFunctionReturn(0);
   }
   ierr = PetscLogEventBegin(VEC_Norm,x,0,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->norm)(x,type,val);CHKERRQ(ierr);
+  if (type != NORM_INFINITY && VecUseBinned_Private(x,0,NULL)) {
+    ierr = VecNormBinned_Private(x,type,val);CHKERRQ(ierr);
+  } else {
+    ierr = (*x->ops->norm)(x,type,val);CHKERRQ(ierr);
+  }
   ierr = PetscLogEventEnd(VEC_Norm,x,0,0,0);CHKERRQ(ierr);
   if (type!=NORM_1_AND_2) {
     ierr = PetscObjectComposedDataSetReal((PetscObject)x,NormIds[type],*val);CHKERRQ(ierr);
@@ -431,7 +439,11 @@ PetscErrorCode  VecTDot(Vec x,Vec y,PetscScalar *val)
   VecCheckSameSize(x,1,y,2);
 
   ierr = PetscLogEventBegin(VEC_TDot,x,y,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->tdot)(x,y,val);CHKERRQ(ierr);
+  if (VecUseBinned_Private(x,1,&y)) {
+    ierr = VecDotBinned_Private(x,y,PETSC_FALSE,val);CHKERRQ(ierr);
+  } else {
+    ierr = (*x->ops->tdot)(x,y,val);CHKERRQ(ierr);
+  }
   ierr = PetscLogEventEnd(VEC_TDot,x,y,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -1106,7 +1118,11 @@ PetscErrorCode  VecMTDot(Vec x,PetscInt nv,const Vec y[],PetscScalar val[])
   VecCheckSameSize(x,1,*y,3);
 
   ierr = PetscLogEventBegin(VEC_MTDot,x,*y,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->mtdot)(x,nv,y,val);CHKERRQ(ierr);
+  if (VecUseBinned_Private(x,nv,y)) {
+    ierr = VecMDotBinned_Private(x,nv,y,PETSC_FALSE,val);CHKERRQ(ierr);
+  } else {
+    ierr = (*x->ops->mtdot)(x,nv,y,val);CHKERRQ(ierr);
+  }
   ierr = PetscLogEventEnd(VEC_MTDot,x,*y,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -1133,6 +1149,10 @@ $     val = (x,y) = y^H x,
 $     val = (x,y) = y^T x,
    where y^T denotes the transpose of y.
 
+   Options Database Keys:
++  -vec_multi_block_size <4096> - length of the pieces of x that are combined with all the y before moving on, 0 for no blocking
+-  -vec_multi_use_threads <false> - share the pieces among the OpenMP threads for long vectors
+
    Level: intermediate
 
 
@@ -1156,7 +1176,11 @@ PetscErrorCode  VecMDot(Vec x,PetscInt nv,const Vec y[],PetscScalar val[])
   VecCheckSameSize(x,1,*y,3);
 
   ierr = PetscLogEventBegin(VEC_MDot,x,*y,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->mdot)(x,nv,y,val);CHKERRQ(ierr);
+  if (VecUseBinned_Private(x,nv,y)) {
+    ierr = VecMDotBinned_Private(x,nv,y,PETSC_TRUE,val);CHKERRQ(ierr);
+  } else {
+    ierr = (*x->ops->mdot)(x,nv,y,val);CHKERRQ(ierr);
+  }
   ierr = PetscLogEventEnd(VEC_MDot,x,*y,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -1172,6 +1196,10 @@ PetscErrorCode  VecMDot(Vec x,PetscInt nv,const Vec y[],PetscScalar val[])
 .  y - one vector
 -  x - array of vectors
 
+   Options Database Keys:
++  -vec_multi_block_size <4096> - length of the pieces of y that are updated with all the x before moving on, 0 for no blocking
+-  -vec_multi_use_threads <false> - share the pieces among the OpenMP threads for long vectors
+
    Level: intermediate
 
    Notes:
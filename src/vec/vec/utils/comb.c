@@ -64,6 +64,9 @@ static PetscErrorCode  PetscSplitReductionCreate(MPI_Comm comm,PetscSplitReducti
 #undef MAXOPS
   (*sr)->comm        = comm;
   (*sr)->request     = MPI_REQUEST_NULL;
+  (*sr)->binned      = PETSC_FALSE;
+  (*sr)->lbinned     = NULL;
+  (*sr)->gbinned     = NULL;
   (*sr)->async       = PETSC_FALSE;
 #if defined(PETSC_HAVE_MPI_IALLREDUCE) || defined(PETSC_HAVE_MPIX_IALLREDUCE)
   (*sr)->async = PETSC_TRUE;    /* Enable by default */
@@ -73,6 +76,58 @@ static PetscErrorCode  PetscSplitReductionCreate(MPI_Comm comm,PetscSplitReducti
   PetscFunctionReturn(0);
 }
 
+/*
+   PetscSplitReductionSetUpBinned - Chooses reproducible reductions or the usual ones when the first operation is
+   queued, and gets the space for the binned sums
+*/
+static PetscErrorCode PetscSplitReductionSetUpBinned(PetscSplitReduction *sr)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!sr->numopsbegin) sr->binned = VecReproducibleReductions;
+  else if (sr->binned != VecReproducibleReductions) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Cannot change VecSetReproducibleReductions() while split phase reductions are pending");
+  if (sr->binned && !sr->lbinned) {
+    ierr = PetscMalloc2(PETSC_BINNED_CMUL*sr->maxops,&sr->lbinned,PETSC_BINNED_CMUL*sr->maxops,&sr->gbinned);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscSplitReductionBinnedBegin - Starts the reduction of the binned sums, they are merged exactly so the order in
+   which MPI combines them does not matter
+*/
+static PetscErrorCode PetscSplitReductionBinnedBegin(PetscSplitReduction *sr,PetscBool async)
+{
+  PetscErrorCode ierr;
+  PetscInt       count = PETSC_BINNED_CMUL*sr->numopsbegin;
+  PetscMPIInt    size,cnt;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_size(sr->comm,&size);CHKERRQ(ierr);
+  if (size == 1) {
+    ierr = PetscArraycpy(sr->gbinned,sr->lbinned,count);CHKERRQ(ierr);
+  } else {
+    ierr = PetscMPIIntCast(count,&cnt);CHKERRQ(ierr);
+    if (async) {
+      ierr = MPIPetsc_Iallreduce(sr->lbinned,sr->gbinned,cnt,MPIU_BINNEDSUM,MPIU_BINNEDSUM_OP,sr->comm,&sr->request);CHKERRQ(ierr);
+    } else {
+      ierr = MPIU_Allreduce(sr->lbinned,sr->gbinned,cnt,MPIU_BINNEDSUM,MPIU_BINNEDSUM_OP,sr->comm);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscSplitReductionBinnedEnd - Gets the reduced values from the reduced binned sums
+*/
+static void PetscSplitReductionBinnedEnd(PetscSplitReduction *sr)
+{
+  PetscInt i;
+
+  for (i=0; i<sr->numopsbegin; i++) sr->gvalues[i] = PetscBinnedSumGetScalar(sr->gbinned+PETSC_BINNED_CMUL*i);
+}
+
 /*
        This function is the MPI reduction operation used when there is
    a combination of sums and max in the reduction. The call below to
@@ -119,7 +174,7 @@ PETSC_EXTERN void MPIAPI PetscSplitReduction_Local(void *in,void *out,PetscMPIIn
    Calling this function is optional when using split-mode reduction. On supporting hardware, calling this after all
    VecXxxBegin() allows the reduction to make asynchronous progress before the result is needed (in VecXxxEnd()).
 
-.seealso: VecNormBegin(), VecNormEnd(), VecDotBegin(), VecDotEnd(), VecTDotBegin(), VecTDotEnd(), VecMDotBegin(), VecMDotEnd(), VecMTDotBegin(), VecMTDotEnd()
+.seealso: VecNormBegin(), VecNormEnd(), VecDotBegin(), VecDotEnd(), VecTDotBegin(), VecTDotEnd(), VecMDotBegin(), VecMDotEnd(), VecMTDotBegin(), VecMTDotEnd(), VecFuseExecuteBegin()
 @*/
 PetscErrorCode PetscCommSplitReductionBegin(MPI_Comm comm)
 {
@@ -129,7 +184,14 @@ PetscErrorCode PetscCommSplitReductionBegin(MPI_Comm comm)
   PetscFunctionBegin;
   ierr = PetscSplitReductionGet(comm,&sr);CHKERRQ(ierr);
   if (sr->numopsend > 0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Cannot call this after VecxxxEnd() has been called");
-  if (sr->async) {              /* Bad reuse, setup code copied from PetscSplitReductionApply(). */
+  if (!sr->numopsbegin) PetscFunctionReturn(0);    /* nothing was queued, for example all the operations were done immediately */
+  if (sr->async && sr->binned) {
+    ierr = PetscLogEventBegin(VEC_ReduceBegin,0,0,0,0);CHKERRQ(ierr);
+    ierr = PetscSplitReductionBinnedBegin(sr,PETSC_TRUE);CHKERRQ(ierr);
+    sr->state     = STATE_PENDING;
+    sr->numopsend = 0;
+    ierr = PetscLogEventEnd(VEC_ReduceBegin,0,0,0,0);CHKERRQ(ierr);
+  } else if (sr->async) {              /* Bad reuse, setup code copied from PetscSplitReductionApply(). */
     PetscInt       i,numops = sr->numopsbegin,*reducetype = sr->reducetype;
     PetscScalar    *lvalues = sr->lvalues,*gvalues = sr->gvalues;
     PetscInt       sum_flg = 0,max_flg = 0, min_flg = 0;
@@ -187,6 +249,7 @@ PetscErrorCode PetscSplitReductionEnd(PetscSplitReduction *sr)
     if (sr->request != MPI_REQUEST_NULL) {
       ierr = MPI_Wait(&sr->request,MPI_STATUS_IGNORE);CHKERRQ(ierr);
     }
+    if (sr->binned) PetscSplitReductionBinnedEnd(sr);
     sr->state = STATE_END;
     ierr = PetscLogEventEnd(VEC_ReduceEnd,0,0,0,0);CHKERRQ(ierr);
     break;
@@ -211,7 +274,10 @@ static PetscErrorCode PetscSplitReductionApply(PetscSplitReduction *sr)
   if (sr->numopsend > 0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Cannot call this after VecxxxEnd() has been called");
   ierr = PetscLogEventBegin(VEC_ReduceCommunication,0,0,0,0);CHKERRQ(ierr);
   ierr = MPI_Comm_size(sr->comm,&size);CHKERRQ(ierr);
-  if (size == 1) {
+  if (sr->binned) {
+    ierr = PetscSplitReductionBinnedBegin(sr,PETSC_FALSE);CHKERRQ(ierr);
+    PetscSplitReductionBinnedEnd(sr);
+  } else if (size == 1) {
     ierr = PetscArraycpy(gvalues,lvalues,numops);CHKERRQ(ierr);
   } else {
     /* determine if all reductions are sum, max, or min */
@@ -260,6 +326,13 @@ PetscErrorCode  PetscSplitReductionExtend(PetscSplitReduction *sr)
   ierr = PetscArraycpy(sr->reducetype,reducetype,maxops);CHKERRQ(ierr);
   ierr = PetscArraycpy(sr->invecs,invecs,maxops);CHKERRQ(ierr);
   ierr = PetscFree4(lvalues,gvalues,reducetype,invecs);CHKERRQ(ierr);
+  if (sr->lbinned) {
+    PetscBinnedSum *lbinned = sr->lbinned,*gbinned = sr->gbinned;
+
+    ierr = PetscMalloc2(PETSC_BINNED_CMUL*2*maxops,&sr->lbinned,PETSC_BINNED_CMUL*2*maxops,&sr->gbinned);CHKERRQ(ierr);
+    ierr = PetscArraycpy(sr->lbinned,lbinned,PETSC_BINNED_CMUL*maxops);CHKERRQ(ierr);
+    ierr = PetscFree2(lbinned,gbinned);CHKERRQ(ierr);
+  }
   PetscFunctionReturn(0);
 }
 
@@ -269,6 +342,7 @@ PetscErrorCode  PetscSplitReductionDestroy(PetscSplitReduction *sr)
 
   PetscFunctionBegin;
   ierr = PetscFree4(sr->lvalues,sr->gvalues,sr->reducetype,sr->invecs);CHKERRQ(ierr);
+  ierr = PetscFree2(sr->lbinned,sr->gbinned);CHKERRQ(ierr);
   ierr = PetscFree(sr);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -352,6 +426,7 @@ PetscErrorCode  VecDotBegin(Vec x,Vec y,PetscScalar *result)
   ierr = PetscObjectGetComm((PetscObject)x,&comm);CHKERRQ(ierr);
   ierr = PetscSplitReductionGet(comm,&sr);CHKERRQ(ierr);
   if (sr->state != STATE_BEGIN) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Called before all VecxxxEnd() called");
+  ierr = PetscSplitReductionSetUpBinned(sr);CHKERRQ(ierr);
   if (sr->numopsbegin >= sr->maxops) {
     ierr = PetscSplitReductionExtend(sr);CHKERRQ(ierr);
   }
@@ -359,7 +434,11 @@ PetscErrorCode  VecDotBegin(Vec x,Vec y,PetscScalar *result)
   sr->invecs[sr->numopsbegin]     = (void*)x;
   if (!x->ops->dot_local) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Vector does not suppport local dots");
   ierr = PetscLogEventBegin(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->dot_local)(x,y,sr->lvalues+sr->numopsbegin++);CHKERRQ(ierr);
+  if (sr->binned) {
+    ierr = VecDotBinnedLocal_Private(x,y,PETSC_TRUE,sr->lbinned+PETSC_BINNED_CMUL*sr->numopsbegin++);CHKERRQ(ierr);
+  } else {
+    ierr = (*x->ops->dot_local)(x,y,sr->lvalues+sr->numopsbegin++);CHKERRQ(ierr);
+  }
   ierr = PetscLogEventEnd(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -435,6 +514,7 @@ PetscErrorCode  VecTDotBegin(Vec x,Vec y,PetscScalar *result)
   ierr = PetscObjectGetComm((PetscObject)x,&comm);CHKERRQ(ierr);
   ierr = PetscSplitReductionGet(comm,&sr);CHKERRQ(ierr);
   if (sr->state != STATE_BEGIN) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Called before all VecxxxEnd() called");
+  ierr = PetscSplitReductionSetUpBinned(sr);CHKERRQ(ierr);
   if (sr->numopsbegin >= sr->maxops) {
     ierr = PetscSplitReductionExtend(sr);CHKERRQ(ierr);
   }
@@ -442,7 +522,11 @@ PetscErrorCode  VecTDotBegin(Vec x,Vec y,PetscScalar *result)
   sr->invecs[sr->numopsbegin]     = (void*)x;
   if (!x->ops->tdot_local) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Vector does not suppport local dots");
   ierr = PetscLogEventBegin(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->tdot_local)(x,y,sr->lvalues+sr->numopsbegin++);CHKERRQ(ierr);
+  if (sr->binned) {
+    ierr = VecDotBinnedLocal_Private(x,y,PETSC_FALSE,sr->lbinned+PETSC_BINNED_CMUL*sr->numopsbegin++);CHKERRQ(ierr);
+  } else {
+    ierr = (*x->ops->tdot_local)(x,y,sr->lvalues+sr->numopsbegin++);CHKERRQ(ierr);
+  }
   ierr = PetscLogEventEnd(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -505,6 +589,7 @@ PetscErrorCode  VecNormBegin(Vec x,NormType ntype,PetscReal *result)
   ierr = PetscObjectGetComm((PetscObject)x,&comm);CHKERRQ(ierr);
   ierr = PetscSplitReductionGet(comm,&sr);CHKERRQ(ierr);
   if (sr->state != STATE_BEGIN) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Called before all VecxxxEnd() called");
+  ierr = PetscSplitReductionSetUpBinned(sr);CHKERRQ(ierr);
   if (sr->numopsbegin >= sr->maxops || (sr->numopsbegin == sr->maxops-1 && ntype == NORM_1_AND_2)) {
     ierr = PetscSplitReductionExtend(sr);CHKERRQ(ierr);
   }
@@ -512,7 +597,13 @@ PetscErrorCode  VecNormBegin(Vec x,NormType ntype,PetscReal *result)
   sr->invecs[sr->numopsbegin] = (void*)x;
   if (!x->ops->norm_local) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Vector does not support local norms");
   ierr = PetscLogEventBegin(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->norm_local)(x,ntype,lresult);CHKERRQ(ierr);
+  if (sr->binned) {
+    /* the binned sums of the squares for the 2-norm, the values in lvalues are not used */
+    ierr = VecNormBinnedLocal_Private(x,ntype,sr->lbinned+PETSC_BINNED_CMUL*sr->numopsbegin);CHKERRQ(ierr);
+    lresult[0] = lresult[1] = 0.0;
+  } else {
+    ierr = (*x->ops->norm_local)(x,ntype,lresult);CHKERRQ(ierr);
+  }
   ierr = PetscLogEventEnd(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
   if (ntype == NORM_2)         lresult[0]                = lresult[0]*lresult[0];
   if (ntype == NORM_1_AND_2)   lresult[1]                = lresult[1]*lresult[1];
@@ -615,6 +706,7 @@ PetscErrorCode  VecMDotBegin(Vec x,PetscInt nv,const Vec y[],PetscScalar result[
   ierr = PetscObjectGetComm((PetscObject)x,&comm);CHKERRQ(ierr);
   ierr = PetscSplitReductionGet(comm,&sr);CHKERRQ(ierr);
   if (sr->state != STATE_BEGIN) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Called before all VecxxxEnd() called");
+  ierr = PetscSplitReductionSetUpBinned(sr);CHKERRQ(ierr);
   for (i=0; i<nv; i++) {
     if (sr->numopsbegin+i >= sr->maxops) {
       ierr = PetscSplitReductionExtend(sr);CHKERRQ(ierr);
@@ -624,7 +716,11 @@ PetscErrorCode  VecMDotBegin(Vec x,PetscInt nv,const Vec y[],PetscScalar result[
   }
   if (!x->ops->mdot_local) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Vector does not suppport local mdots");
   ierr = PetscLogEventBegin(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->mdot_local)(x,nv,y,sr->lvalues+sr->numopsbegin);CHKERRQ(ierr);
+  if (sr->binned) {
+    ierr = VecMDotBinnedLocal_Private(x,nv,y,PETSC_TRUE,sr->lbinned+PETSC_BINNED_CMUL*sr->numopsbegin);CHKERRQ(ierr);
+  } else {
+    ierr = (*x->ops->mdot_local)(x,nv,y,sr->lvalues+sr->numopsbegin);CHKERRQ(ierr);
+  }
   ierr = PetscLogEventEnd(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
   sr->numopsbegin += nv;
   PetscFunctionReturn(0);
@@ -707,6 +803,7 @@ PetscErrorCode  VecMTDotBegin(Vec x,PetscInt nv,const Vec y[],PetscScalar result
   ierr = PetscObjectGetComm((PetscObject)x,&comm);CHKERRQ(ierr);
   ierr = PetscSplitReductionGet(comm,&sr);CHKERRQ(ierr);
   if (sr->state != STATE_BEGIN) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Called before all VecxxxEnd() called");
+  ierr = PetscSplitReductionSetUpBinned(sr);CHKERRQ(ierr);
   for (i=0; i<nv; i++) {
     if (sr->numopsbegin+i >= sr->maxops) {
       ierr = PetscSplitReductionExtend(sr);CHKERRQ(ierr);
@@ -716,7 +813,11 @@ PetscErrorCode  VecMTDotBegin(Vec x,PetscInt nv,const Vec y[],PetscScalar result
   }
   if (!x->ops->mtdot_local) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Vector does not suppport local mdots");
   ierr = PetscLogEventBegin(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->mdot_local)(x,nv,y,sr->lvalues+sr->numopsbegin);CHKERRQ(ierr);
+  if (sr->binned) {
+    ierr = VecMDotBinnedLocal_Private(x,nv,y,PETSC_FALSE,sr->lbinned+PETSC_BINNED_CMUL*sr->numopsbegin);CHKERRQ(ierr);
+  } else {
+    ierr = (*x->ops->mdot_local)(x,nv,y,sr->lvalues+sr->numopsbegin);CHKERRQ(ierr);
+  }
   ierr = PetscLogEventEnd(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
   sr->numopsbegin += nv;
   PetscFunctionReturn(0);
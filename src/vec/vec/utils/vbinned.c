@@ -0,0 +1,641 @@
+
+/*
+      Reproducible inner products and norms: the results are bitwise identical whatever the number of processes and
+   the distribution of the entries among them.
+
+      The summands are accumulated with binned summation on a fixed grid of bins of PETSC_BINNED_W bits: bin j holds
+   multiples of its unit u_j = 2^(j W - 1074), so bin 0 holds the subnormal numbers. A summand r of magnitude below
+   2^(W-1) u_J is deposited into the bins J, J-1, ..., J-PETSC_BINNED_FOLD+1, the part of r in bin j being the multiple
+   of u_j nearest to r, computed as (sigma_j + r) - sigma_j with sigma_j = 1.5 2^52 u_j, and the rest going to bin j-1.
+   This part does not depend on J as long as J is large enough, so each bin accumulates the same sum whatever the
+   order of the summands or the blocks in which they are deposited. The sums are exact: each bin is kept below the
+   unit of the bin above it by moving multiples of that unit into an integer carry, and two binned sums are merged
+   by adding their bins and carries. The bins are chosen from the largest summand, when a larger summand arrives the
+   sum moves to higher bins and the lowest ones are dropped. The result is thus accurate to about the unit of the
+   lowest bin, 2^(-(FOLD-1) W) relative to the largest summand, which is better than the usual floating point sum.
+
+      The local kernels deposit the summands into PETSC_BINNED_LANES independent partial sums so that they can be
+   computed with SIMD instructions; as the partial sums are exact, the order in which they are added does not matter.
+*/
+
+#include <petsc/private/vecimpl.h>    /*I   "petscvec.h"    I*/
+
+/* the operations on the SIMD registers used by the local kernels, PetscBinnedAbsMax() ignores not-a-number */
+#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(PETSC_USE_REAL_DOUBLE) && (defined(__AVX512F__) || defined(__AVX__) || defined(__SSE2__))
+#include <immintrin.h>
+#endif
+#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(PETSC_USE_REAL_DOUBLE) && defined(__AVX512F__)
+typedef __m512d PetscBinnedVec;
+#define PETSC_BINNED_WIDTH       8
+#define PetscBinnedLoad(a)       _mm512_loadu_pd(a)
+#define PetscBinnedStore(a,v)    _mm512_storeu_pd(a,v)
+#define PetscBinnedSet(a)        _mm512_set1_pd(a)
+#define PetscBinnedAdd(a,b)      _mm512_add_pd(a,b)
+#define PetscBinnedSub(a,b)      _mm512_sub_pd(a,b)
+#define PetscBinnedAbsMax(m,a)   _mm512_max_pd(_mm512_abs_pd(a),m)
+#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(PETSC_USE_REAL_DOUBLE) && defined(__AVX__)
+typedef __m256d PetscBinnedVec;
+#define PETSC_BINNED_WIDTH       4
+#define PetscBinnedLoad(a)       _mm256_loadu_pd(a)
+#define PetscBinnedStore(a,v)    _mm256_storeu_pd(a,v)
+#define PetscBinnedSet(a)        _mm256_set1_pd(a)
+#define PetscBinnedAdd(a,b)      _mm256_add_pd(a,b)
+#define PetscBinnedSub(a,b)      _mm256_sub_pd(a,b)
+#define PetscBinnedAbsMax(m,a)   _mm256_max_pd(_mm256_andnot_pd(_mm256_set1_pd(-0.0),a),m)
+#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(PETSC_USE_REAL_DOUBLE) && defined(__SSE2__)
+typedef __m128d PetscBinnedVec;
+#define PETSC_BINNED_WIDTH       2
+#define PetscBinnedLoad(a)       _mm_loadu_pd(a)
+#define PetscBinnedStore(a,v)    _mm_storeu_pd(a,v)
+#define PetscBinnedSet(a)        _mm_set1_pd(a)
+#define PetscBinnedAdd(a,b)      _mm_add_pd(a,b)
+#define PetscBinnedSub(a,b)      _mm_sub_pd(a,b)
+#define PetscBinnedAbsMax(m,a)   _mm_max_pd(_mm_andnot_pd(_mm_set1_pd(-0.0),a),m)
+#else
+typedef PetscReal PetscBinnedVec;
+#define PETSC_BINNED_WIDTH       1
+#define PetscBinnedLoad(a)       (*(a))
+#define PetscBinnedStore(a,v)    (*(a) = (v))
+#define PetscBinnedSet(a)        (a)
+#define PetscBinnedAdd(a,b)      ((a)+(b))
+#define PetscBinnedSub(a,b)      ((a)-(b))
+#define PetscBinnedAbsMax(m,a)   (PetscAbsReal(a) > (m) ? PetscAbsReal(a) : (m))
+#endif
+
+PetscBool    VecReproducibleReductions = PETSC_FALSE;
+MPI_Datatype MPIU_BINNEDSUM            = MPI_DATATYPE_NULL;
+MPI_Op       MPIU_BINNEDSUM_OP         = 0;
+
+#define PETSC_BINNED_W        32          /* bits per bin */
+#define PETSC_BINNED_EMIN     (-1074)     /* exponent of the unit of bin 0 */
+#define PETSC_BINNED_MAXINDEX 63          /* the highest bin, sigma_j overflows for the bins above */
+#define PETSC_BINNED_LANES    (2*PETSC_BINNED_WIDTH) /* independent partial sums of the local kernels, two registers */
+#define PETSC_BINNED_BLOCK    512         /* entries whose summands are deposited together */
+#define PETSC_BINNED_FLUSH    (1<<18)     /* deposits into a partial sum after which it could become inexact */
+
+typedef struct {
+  PetscBinnedSum *sum;
+  PetscReal      lane[PETSC_BINNED_FOLD][PETSC_BINNED_LANES];  /* partial sums of the bins of sum */
+  PetscInt       count;                                        /* deposits into each partial sum since they were added to sum */
+  PetscReal      sigma[PETSC_BINNED_FOLD];                     /* the constants that split the summands for the bins of sum */
+  PetscInt       sindex;                                       /* the bin for which sigma[] was computed */
+} PetscBinnedAcc;
+
+#if defined(PETSC_USE_REAL_DOUBLE)
+PETSC_STATIC_INLINE PetscReal PetscBinnedUnit(PetscInt j)
+{
+  return ldexp(1.0,(int)(j*PETSC_BINNED_W+PETSC_BINNED_EMIN));
+}
+
+/* keeps bin k of s below the unit of the bin above it */
+PETSC_STATIC_INLINE void PetscBinnedSumCarry_Private(PetscBinnedSum *s,PetscInt k)
+{
+  PetscInt  j = (PetscInt)s->index-k;
+  PetscReal U,c;
+
+  if (j < 0) return; /* only zeros (or not-a-number) are deposited below bin 0 */
+  U              = PetscBinnedUnit(j+1);
+  c              = PetscFloorReal(s->bins[k]/U);
+  s->bins[k]    -= c*U;
+  s->carries[k] += c;
+}
+
+/* moves s up by d bins, dropping the lowest ones */
+PETSC_STATIC_INLINE void PetscBinnedSumShift_Private(PetscBinnedSum *s,PetscInt d)
+{
+  PetscInt k;
+
+  for (k=PETSC_BINNED_FOLD-1; k>=0; k--) {
+    s->bins[k]    = k >= d ? s->bins[k-d]    : 0.0;
+    s->carries[k] = k >= d ? s->carries[k-d] : 0.0;
+  }
+  s->index += d;
+}
+
+static void PetscBinnedAccFlush_Private(PetscBinnedAcc *acc)
+{
+  PetscBinnedSum *s = acc->sum;
+  PetscReal      t;
+  PetscInt       k,l;
+
+  for (k=0; k<PETSC_BINNED_FOLD; k++) {
+    for (l=0,t=0.0; l<PETSC_BINNED_LANES; l++) {t += acc->lane[k][l]; acc->lane[k][l] = 0.0;}
+    s->bins[k] += t;
+    PetscBinnedSumCarry_Private(s,k);
+  }
+  /* not-a-number summands end up in all the bins, keep them in value so that they are not dropped with the bins */
+  if (PetscIsNanReal(s->bins[0])) s->value = s->bins[0];
+  acc->count = 0;
+}
+
+/* deposits the m summands p[], p[] must have room for m rounded up to a multiple of PETSC_BINNED_LANES */
+static PetscErrorCode PetscBinnedAccAdd_Private(PetscBinnedAcc *acc,PetscInt m,PetscReal *p)
+{
+  PetscBinnedSum *s = acc->sum;
+  PetscReal      amax = 0.0,*sigma = acc->sigma;
+  PetscInt       i,k,l,J;
+  int            e;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (; m%PETSC_BINNED_LANES; m++) p[m] = 0.0;
+  if (!m) PetscFunctionReturn(0);
+  {
+    PetscBinnedVec vmax = PetscBinnedSet(0.0);
+    PetscReal      t[PETSC_BINNED_WIDTH];
+
+    for (i=0; i<m; i+=PETSC_BINNED_WIDTH) vmax = PetscBinnedAbsMax(vmax,PetscBinnedLoad(p+i));
+    PetscBinnedStore(t,vmax);
+    for (l=0; l<PETSC_BINNED_WIDTH; l++) amax = t[l] > amax ? t[l] : amax;
+  }
+  if (amax >= PetscBinnedUnit(PETSC_BINNED_MAXINDEX)*ldexp(1.0,PETSC_BINNED_W-1)) {
+    /* the summands too large for the bins, in particular the infinite ones, are summed apart in the usual way so that
+       they give infinity or not-a-number as usual */
+    for (i=0; i<m; i++) if (PetscAbsReal(p[i]) >= PetscBinnedUnit(PETSC_BINNED_MAXINDEX)*ldexp(1.0,PETSC_BINNED_W-1)) {s->value += p[i]; p[i] = 0.0;}
+    ierr = PetscBinnedAccAdd_Private(acc,m,p);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  /* the lowest bin J for which amax < 2^(W-1) u_J; it depends on amax only, so that the bins kept in the end are
+     those of the largest summand */
+  J = 0;
+  if (amax > 0.0) {
+    (void)frexp(amax,&e); /* amax < 2^e */
+    J = e-PETSC_BINNED_EMIN-(PETSC_BINNED_W-1);
+    J = J > 0 ? (J+PETSC_BINNED_W-1)/PETSC_BINNED_W : 0;
+  }
+  if (J > s->index) {
+    PetscBinnedAccFlush_Private(acc);
+    PetscBinnedSumShift_Private(s,J-(PetscInt)s->index);
+  }
+  J = (PetscInt)s->index;
+  if (J != acc->sindex) {
+    for (k=0; k<PETSC_BINNED_FOLD; k++) sigma[k] = 1.5*ldexp(1.0,52)*PetscBinnedUnit(J-k > 0 ? J-k : 0);
+    acc->sindex = J;
+  }
+  if (acc->count + m/PETSC_BINNED_LANES > PETSC_BINNED_FLUSH) PetscBinnedAccFlush_Private(acc);
+  {
+    /* the two registers of partial sums of each bin are kept in separate variables so that they stay in registers */
+    PetscBinnedVec s0 = PetscBinnedSet(sigma[0]),s1 = PetscBinnedSet(sigma[1]),s2 = PetscBinnedSet(sigma[2]),r,t,q,u;
+    PetscBinnedVec a0 = PetscBinnedLoad(acc->lane[0]),b0 = PetscBinnedLoad(acc->lane[0]+PETSC_BINNED_WIDTH);
+    PetscBinnedVec a1 = PetscBinnedLoad(acc->lane[1]),b1 = PetscBinnedLoad(acc->lane[1]+PETSC_BINNED_WIDTH);
+    PetscBinnedVec a2 = PetscBinnedLoad(acc->lane[2]),b2 = PetscBinnedLoad(acc->lane[2]+PETSC_BINNED_WIDTH);
+
+    for (i=0; i<m; i+=PETSC_BINNED_LANES) {
+      r  = PetscBinnedLoad(p+i);
+      t  = PetscBinnedLoad(p+i+PETSC_BINNED_WIDTH);
+      q  = PetscBinnedSub(PetscBinnedAdd(s0,r),s0);
+      u  = PetscBinnedSub(PetscBinnedAdd(s0,t),s0);
+      r  = PetscBinnedSub(r,q);
+      t  = PetscBinnedSub(t,u);
+      a0 = PetscBinnedAdd(a0,q);
+      b0 = PetscBinnedAdd(b0,u);
+      q  = PetscBinnedSub(PetscBinnedAdd(s1,r),s1);
+      u  = PetscBinnedSub(PetscBinnedAdd(s1,t),s1);
+      r  = PetscBinnedSub(r,q);
+      t  = PetscBinnedSub(t,u);
+      a1 = PetscBinnedAdd(a1,q);
+      b1 = PetscBinnedAdd(b1,u);
+      a2 = PetscBinnedAdd(a2,PetscBinnedSub(PetscBinnedAdd(s2,r),s2));
+      b2 = PetscBinnedAdd(b2,PetscBinnedSub(PetscBinnedAdd(s2,t),s2));
+    }
+    PetscBinnedStore(acc->lane[0],a0);
+    PetscBinnedStore(acc->lane[0]+PETSC_BINNED_WIDTH,b0);
+    PetscBinnedStore(acc->lane[1],a1);
+    PetscBinnedStore(acc->lane[1]+PETSC_BINNED_WIDTH,b1);
+    PetscBinnedStore(acc->lane[2],a2);
+    PetscBinnedStore(acc->lane[2]+PETSC_BINNED_WIDTH,b2);
+  }
+  acc->count += m/PETSC_BINNED_LANES;
+  PetscFunctionReturn(0);
+}
+
+/* adds the binned sum in to out */
+static void PetscBinnedSumMerge_Private(const PetscBinnedSum *in,PetscBinnedSum *out)
+{
+  PetscInt k,d;
+
+  if (in->op == PETSC_SR_REDUCE_MAX) {out->value = PetscMax(out->value,in->value); return;}
+  if (in->op == PETSC_SR_REDUCE_MIN) {out->value = PetscMin(out->value,in->value); return;}
+  out->value += in->value;
+  if (in->index < 0) return;
+  if (in->index > out->index) PetscBinnedSumShift_Private(out,(PetscInt)(in->index-out->index));
+  d = (PetscInt)(out->index-in->index);
+  for (k=0; k+d<PETSC_BINNED_FOLD; k++) {
+    out->bins[k+d]    += in->bins[k];
+    out->carries[k+d] += in->carries[k];
+    PetscBinnedSumCarry_Private(out,k+d);
+  }
+}
+
+static PetscReal PetscBinnedSumGetReal_Private(const PetscBinnedSum *s)
+{
+  PetscReal d[PETSC_BINNED_FOLD+1],U,c,r;
+  PetscInt  t,j,J = (PetscInt)s->index;
+
+  if (s->op != PETSC_SR_REDUCE_SUM || J < 0) return s->value;
+  /* digit t holds multiples of the unit of bin J+1-t: the carry of bin J-t and bin J+1-t itself; these are exact */
+  for (t=0; t<=PETSC_BINNED_FOLD; t++) {
+    j    = J+1-t;
+    d[t] = t ? s->bins[t-1] : 0.0;
+    if (t < PETSC_BINNED_FOLD && j > 0) d[t] += s->carries[t]*PetscBinnedUnit(j);
+  }
+  /* round each digit to the nearest multiple of the unit of the one above, so that the digits do not cancel when added */
+  for (t=PETSC_BINNED_FOLD; t>0; t--) {
+    j = J+1-t;
+    if (j < 0) continue;
+    U       = PetscBinnedUnit(j+1);
+    c       = PetscFloorReal(d[t]/U+0.5);
+    d[t]   -= c*U;
+    d[t-1] += c*U;
+  }
+  for (t=1,r=d[0]; t<=PETSC_BINNED_FOLD; t++) r += d[t];
+  return r+s->value;
+}
+#else
+static void PetscBinnedAccFlush_Private(PetscBinnedAcc *acc) {return;}
+static void PetscBinnedSumMerge_Private(const PetscBinnedSum *in,PetscBinnedSum *out) {return;}
+static PetscReal PetscBinnedSumGetReal_Private(const PetscBinnedSum *s) {return s->value;}
+static PetscErrorCode PetscBinnedAccAdd_Private(PetscBinnedAcc *acc,PetscInt m,PetscReal *p)
+{
+  PetscFunctionBegin;
+  SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Reproducible reductions require double precision");
+  PetscFunctionReturn(0);
+}
+#endif
+
+static void PetscBinnedSumInitialize_Private(PetscBinnedSum *s)
+{
+  PetscInt k;
+
+  s->op    = PETSC_SR_REDUCE_SUM;
+  s->index = -1;
+  s->value = 0.0;
+  for (k=0; k<PETSC_BINNED_FOLD; k++) s->bins[k] = s->carries[k] = 0.0;
+}
+
+static void PetscBinnedAccInitialize_Private(PetscBinnedAcc *acc,PetscBinnedSum *sum)
+{
+  PetscInt k,l;
+
+  PetscBinnedSumInitialize_Private(sum);
+  acc->sum    = sum;
+  acc->count  = 0;
+  acc->sindex = -1;
+  for (k=0; k<PETSC_BINNED_FOLD; k++) for (l=0; l<PETSC_BINNED_LANES; l++) acc->lane[k][l] = 0.0;
+}
+
+/* a binned sum of a PetscScalar computed otherwise, it only gives reproducible results on one process */
+static void PetscBinnedSumSetScalar_Private(PetscScalar v,PetscBinnedSum s[])
+{
+  PetscInt i;
+
+  for (i=0; i<PETSC_BINNED_CMUL; i++) PetscBinnedSumInitialize_Private(s+i);
+  s[0].value = PetscRealPart(v);
+#if defined(PETSC_USE_COMPLEX)
+  s[1].value = PetscImaginaryPart(v);
+#endif
+}
+
+/*
+   The MPI reduction operation that merges binned sums, it is exact so the order in which MPI applies it does not
+   matter. Maxima and minima (used by the split phase reductions) are marked by the op field.
+*/
+void MPIAPI PetscBinnedSum_Local(void *in,void *out,PetscMPIInt *cnt,MPI_Datatype *datatype)
+{
+  PetscBinnedSum *xin = (PetscBinnedSum*)in,*xout = (PetscBinnedSum*)out;
+  PetscInt       i,count = (PetscInt)*cnt;
+
+  PetscFunctionBegin;
+  if (*datatype != MPIU_BINNEDSUM) {
+    (*PetscErrorPrintf)("Can only handle MPIU_BINNEDSUM data types");
+    PETSCABORT(MPI_COMM_SELF,PETSC_ERR_ARG_WRONG);
+  }
+  for (i=0; i<count; i++) PetscBinnedSumMerge_Private(xin+i,xout+i);
+  PetscFunctionReturnVoid();
+}
+
+/*
+   PetscBinnedSumGetScalar - The value of a reduced binned sum of PetscScalar, which consists of PETSC_BINNED_CMUL
+   binned sums of PetscReal
+*/
+PetscScalar PetscBinnedSumGetScalar(const PetscBinnedSum s[])
+{
+#if defined(PETSC_USE_COMPLEX)
+  return PetscCMPLX(PetscBinnedSumGetReal_Private(s),PetscBinnedSumGetReal_Private(s+1));
+#else
+  return PetscBinnedSumGetReal_Private(s);
+#endif
+}
+
+/* reduces count binned sums over comm in place */
+static PetscErrorCode PetscBinnedSumAllreduce_Private(PetscBinnedSum *sum,PetscInt count,MPI_Comm comm)
+{
+  PetscBinnedSum gsum[2*PETSC_BINNED_CMUL],*work = gsum;
+  PetscMPIInt    size,cnt;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  if (size == 1) PetscFunctionReturn(0);
+  if (count > 2*PETSC_BINNED_CMUL) {ierr = PetscMalloc1(count,&work);CHKERRQ(ierr);}
+  ierr = PetscMPIIntCast(count,&cnt);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(sum,work,cnt,MPIU_BINNEDSUM,MPIU_BINNEDSUM_OP,comm);CHKERRQ(ierr);
+  ierr = PetscArraycpy(sum,work,count);CHKERRQ(ierr);
+  if (work != gsum) {ierr = PetscFree(work);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/* the summands of the entries [0,n) of x^H y (conj) or x^T y, the real parts into re[] and the imaginary ones into im[] */
+PETSC_STATIC_INLINE PetscInt VecDotBinnedSummands_Private(PetscInt n,const PetscScalar *x,const PetscScalar *y,PetscBool conj,PetscReal *re,PetscReal *im)
+{
+  PetscInt i;
+
+#if defined(PETSC_USE_COMPLEX)
+  /* each product is stored, so that the compiler cannot contract them into fused multiply-adds */
+  if (conj) {
+    for (i=0; i<n; i++) {
+      re[i]   = PetscRealPart(x[i])*PetscRealPart(y[i]);
+      re[n+i] = PetscImaginaryPart(x[i])*PetscImaginaryPart(y[i]);
+      im[i]   = PetscImaginaryPart(x[i])*PetscRealPart(y[i]);
+      im[n+i] = -(PetscRealPart(x[i])*PetscImaginaryPart(y[i]));
+    }
+  } else {
+    for (i=0; i<n; i++) {
+      re[i]   = PetscRealPart(x[i])*PetscRealPart(y[i]);
+      re[n+i] = -(PetscImaginaryPart(x[i])*PetscImaginaryPart(y[i]));
+      im[i]   = PetscRealPart(x[i])*PetscImaginaryPart(y[i]);
+      im[n+i] = PetscImaginaryPart(x[i])*PetscRealPart(y[i]);
+    }
+  }
+  return 2*n;
+#else
+  for (i=0; i<n; i++) re[i] = x[i]*y[i];
+  return n;
+#endif
+}
+
+/*
+   VecDotBinnedLocal_Private - The binned sums of the local part of x^H y (conj true) or x^T y, PETSC_BINNED_CMUL of
+   them for the real and imaginary parts
+*/
+PetscErrorCode VecDotBinnedLocal_Private(Vec x,Vec y,PetscBool conj,PetscBinnedSum sum[])
+{
+  PetscBinnedAcc    acc[PETSC_BINNED_CMUL];
+  PetscReal         re[2*PETSC_BINNED_BLOCK],im[2*PETSC_BINNED_BLOCK];
+  const PetscScalar *xa,*ya;
+  PetscInt          i,b,m,n = x->map->n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (!x->petscnative || !y->petscnative) {
+    PetscScalar val;
+
+    if (conj) {ierr = (*x->ops->dot_local)(x,y,&val);CHKERRQ(ierr);}
+    else      {ierr = (*x->ops->tdot_local)(x,y,&val);CHKERRQ(ierr);}
+    PetscBinnedSumSetScalar_Private(val,sum);
+    PetscFunctionReturn(0);
+  }
+  for (i=0; i<PETSC_BINNED_CMUL; i++) PetscBinnedAccInitialize_Private(acc+i,sum+i);
+  ierr = VecGetArrayRead(x,&xa);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(y,&ya);CHKERRQ(ierr);
+  for (i=0; i<n; i+=PETSC_BINNED_BLOCK) {
+    b    = PetscMin(PETSC_BINNED_BLOCK,n-i);
+    m    = VecDotBinnedSummands_Private(b,xa+i,ya+i,conj,re,im);
+    ierr = PetscBinnedAccAdd_Private(acc,m,re);CHKERRQ(ierr);
+#if defined(PETSC_USE_COMPLEX)
+    ierr = PetscBinnedAccAdd_Private(acc+1,m,im);CHKERRQ(ierr);
+#endif
+  }
+  for (i=0; i<PETSC_BINNED_CMUL; i++) PetscBinnedAccFlush_Private(acc+i);
+  ierr = VecRestoreArrayRead(x,&xa);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(y,&ya);CHKERRQ(ierr);
+  ierr = PetscLogFlops(PetscMax(2.0*n-1,0.0));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   VecMDotBinnedLocal_Private - The binned sums of the local parts of x^H y[j] (conj true) or x^T y[j], PETSC_BINNED_CMUL
+   of them for each j
+*/
+PetscErrorCode VecMDotBinnedLocal_Private(Vec x,PetscInt nv,const Vec y[],PetscBool conj,PetscBinnedSum sum[])
+{
+  PetscBinnedAcc    *acc;
+  PetscReal         re[2*PETSC_BINNED_BLOCK],im[2*PETSC_BINNED_BLOCK];
+  const PetscScalar *xa,**ya;
+  PetscInt          i,j,b,m,n = x->map->n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  for (j=0; j<nv; j++) if (!y[j]->petscnative) break;
+  if (!x->petscnative || j < nv) {
+    PetscScalar *val;
+
+    ierr = PetscMalloc1(nv,&val);CHKERRQ(ierr);
+    if (conj) {ierr = (*x->ops->mdot_local)(x,nv,y,val);CHKERRQ(ierr);}
+    else      {ierr = (*x->ops->mtdot_local)(x,nv,y,val);CHKERRQ(ierr);}
+    for (j=0; j<nv; j++) PetscBinnedSumSetScalar_Private(val[j],sum+PETSC_BINNED_CMUL*j);
+    ierr = PetscFree(val);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscMalloc2(PETSC_BINNED_CMUL*nv,&acc,nv,&ya);CHKERRQ(ierr);
+  for (i=0; i<PETSC_BINNED_CMUL*nv; i++) PetscBinnedAccInitialize_Private(acc+i,sum+i);
+  ierr = VecGetArrayRead(x,&xa);CHKERRQ(ierr);
+  for (j=0; j<nv; j++) {ierr = VecGetArrayRead(y[j],&ya[j]);CHKERRQ(ierr);}
+  /* a block of x is combined with all the y before moving on */
+  for (i=0; i<n; i+=PETSC_BINNED_BLOCK) {
+    b = PetscMin(PETSC_BINNED_BLOCK,n-i);
+    for (j=0; j<nv; j++) {
+      m    = VecDotBinnedSummands_Private(b,xa+i,ya[j]+i,conj,re,im);
+      ierr = PetscBinnedAccAdd_Private(acc+PETSC_BINNED_CMUL*j,m,re);CHKERRQ(ierr);
+#if defined(PETSC_USE_COMPLEX)
+      ierr = PetscBinnedAccAdd_Private(acc+PETSC_BINNED_CMUL*j+1,m,im);CHKERRQ(ierr);
+#endif
+    }
+  }
+  for (i=0; i<PETSC_BINNED_CMUL*nv; i++) PetscBinnedAccFlush_Private(acc+i);
+  ierr = VecRestoreArrayRead(x,&xa);CHKERRQ(ierr);
+  for (j=0; j<nv; j++) {ierr = VecRestoreArrayRead(y[j],&ya[j]);CHKERRQ(ierr);}
+  ierr = PetscFree2(acc,ya);CHKERRQ(ierr);
+  ierr = PetscLogFlops(PetscMax(nv*(2.0*n-1),0.0));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   VecNormBinnedLocal_Private - The binned sums of the local part of the 1-norm or of the square of the 2-norm of x,
+   stored as those of a PetscScalar; for NORM_1_AND_2 the two of them, for NORM_INFINITY the local maximum marked as such
+*/
+PetscErrorCode VecNormBinnedLocal_Private(Vec x,NormType type,PetscBinnedSum sum[])
+{
+  PetscBinnedAcc    acc[2];
+  PetscReal         p1[2*PETSC_BINNED_BLOCK],p2[2*PETSC_BINNED_BLOCK],amax = 0.0;
+  const PetscScalar *xa;
+  PetscInt          i,k,b,n = x->map->n;
+  PetscBool         one = (PetscBool)(type == NORM_1 || type == NORM_1_AND_2),two = (PetscBool)(type == NORM_2 || type == NORM_FROBENIUS || type == NORM_1_AND_2);
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  PetscBinnedSumSetScalar_Private(0.0,sum);
+  if (type == NORM_1_AND_2) PetscBinnedSumSetScalar_Private(0.0,sum+PETSC_BINNED_CMUL);
+  if (!x->petscnative) {
+    PetscReal val[2];
+
+    ierr = (*x->ops->norm_local)(x,type,val);CHKERRQ(ierr);
+    if (type == NORM_1_AND_2) {
+      sum[0].value                 = val[0];
+      sum[PETSC_BINNED_CMUL].value = val[1]*val[1];
+    } else sum[0].value = two ? val[0]*val[0] : val[0];
+    if (type == NORM_INFINITY) sum[0].op = PETSC_SR_REDUCE_MAX;
+    PetscFunctionReturn(0);
+  }
+  ierr = VecGetArrayRead(x,&xa);CHKERRQ(ierr);
+  if (type == NORM_INFINITY) {
+    for (i=0; i<n; i++) amax = PetscMax(amax,PetscAbsScalar(xa[i]));
+    sum[0].op    = PETSC_SR_REDUCE_MAX;
+    sum[0].value = amax;
+  } else {
+    PetscBinnedAccInitialize_Private(acc,sum);
+    if (type == NORM_1_AND_2) PetscBinnedAccInitialize_Private(acc+1,sum+PETSC_BINNED_CMUL);
+    for (i=0; i<n; i+=PETSC_BINNED_BLOCK) {
+      b = PetscMin(PETSC_BINNED_BLOCK,n-i);
+      if (one) {
+        for (k=0; k<b; k++) p1[k] = PetscAbsScalar(xa[i+k]);
+        ierr = PetscBinnedAccAdd_Private(acc,b,p1);CHKERRQ(ierr);
+      }
+      if (two) {
+#if defined(PETSC_USE_COMPLEX)
+        for (k=0; k<b; k++) {
+          p2[k]   = PetscRealPart(xa[i+k])*PetscRealPart(xa[i+k]);
+          p2[b+k] = PetscImaginaryPart(xa[i+k])*PetscImaginaryPart(xa[i+k]);
+        }
+        ierr = PetscBinnedAccAdd_Private(acc+(one ? 1 : 0),2*b,p2);CHKERRQ(ierr);
+#else
+        for (k=0; k<b; k++) p2[k] = xa[i+k]*xa[i+k];
+        ierr = PetscBinnedAccAdd_Private(acc+(one ? 1 : 0),b,p2);CHKERRQ(ierr);
+#endif
+      }
+    }
+    PetscBinnedAccFlush_Private(acc);
+    if (type == NORM_1_AND_2) PetscBinnedAccFlush_Private(acc+1);
+    ierr = PetscLogFlops(PetscMax((type == NORM_1_AND_2 ? 3.0 : 2.0)*n-1,0.0));CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArrayRead(x,&xa);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* VecDot() and VecTDot() (conj false) with binned sums */
+PetscErrorCode VecDotBinned_Private(Vec x,Vec y,PetscBool conj,PetscScalar *val)
+{
+  PetscBinnedSum sum[PETSC_BINNED_CMUL];
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDotBinnedLocal_Private(x,y,conj,sum);CHKERRQ(ierr);
+  ierr = PetscBinnedSumAllreduce_Private(sum,PETSC_BINNED_CMUL,PetscObjectComm((PetscObject)x));CHKERRQ(ierr);
+  *val = PetscBinnedSumGetScalar(sum);
+  PetscFunctionReturn(0);
+}
+
+/* VecMDot() and VecMTDot() (conj false) with binned sums */
+PetscErrorCode VecMDotBinned_Private(Vec x,PetscInt nv,const Vec y[],PetscBool conj,PetscScalar val[])
+{
+  PetscBinnedSum *sum;
+  PetscInt       j;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(PETSC_BINNED_CMUL*nv,&sum);CHKERRQ(ierr);
+  ierr = VecMDotBinnedLocal_Private(x,nv,y,conj,sum);CHKERRQ(ierr);
+  ierr = PetscBinnedSumAllreduce_Private(sum,PETSC_BINNED_CMUL*nv,PetscObjectComm((PetscObject)x));CHKERRQ(ierr);
+  for (j=0; j<nv; j++) val[j] = PetscBinnedSumGetScalar(sum+PETSC_BINNED_CMUL*j);
+  ierr = PetscFree(sum);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* VecNorm() with binned sums, for all the norms but NORM_INFINITY whose usual computation is exact */
+PetscErrorCode VecNormBinned_Private(Vec x,NormType type,PetscReal *val)
+{
+  PetscBinnedSum sum[2*PETSC_BINNED_CMUL];
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecNormBinnedLocal_Private(x,type,sum);CHKERRQ(ierr);
+  ierr = PetscBinnedSumAllreduce_Private(sum,(type == NORM_1_AND_2 ? 2 : 1)*PETSC_BINNED_CMUL,PetscObjectComm((PetscObject)x));CHKERRQ(ierr);
+  val[0] = PetscBinnedSumGetReal_Private(sum);
+  if (type == NORM_1_AND_2) val[1] = PetscSqrtReal(PetscBinnedSumGetReal_Private(sum+PETSC_BINNED_CMUL));
+  else if (type == NORM_2 || type == NORM_FROBENIUS) val[0] = PetscSqrtReal(val[0]);
+  PetscFunctionReturn(0);
+}
+
+/* VecDotNorm2() with binned sums */
+PetscErrorCode VecDotNorm2Binned_Private(Vec s,Vec t,PetscScalar *dp,PetscReal *nm)
+{
+  PetscBinnedSum sum[2*PETSC_BINNED_CMUL];
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDotBinnedLocal_Private(s,t,PETSC_TRUE,sum);CHKERRQ(ierr);
+  ierr = VecNormBinnedLocal_Private(t,NORM_2,sum+PETSC_BINNED_CMUL);CHKERRQ(ierr);
+  ierr = PetscBinnedSumAllreduce_Private(sum,2*PETSC_BINNED_CMUL,PetscObjectComm((PetscObject)s));CHKERRQ(ierr);
+  *dp  = PetscBinnedSumGetScalar(sum);
+  *nm  = PetscBinnedSumGetReal_Private(sum+PETSC_BINNED_CMUL);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecSetReproducibleReductions - Makes the inner products and norms of vectors bitwise reproducible: they do not
+   depend on the number of processes or on the distribution of the entries among them
+
+   Not Collective, but must be called with the same value on all processes
+
+   Input Parameter:
+.  flg - PETSC_TRUE to compute reproducible inner products and norms
+
+   Options Database Key:
+.  -vec_reproducible <false> - compute reproducible inner products and norms
+
+   Notes:
+   This applies to VecDot(), VecTDot(), VecMDot(), VecMTDot(), VecNorm(), VecDotNorm2() and to the split phase
+   reductions VecDotBegin(), VecNormBegin(), VecMDotBegin() and so on, for the vectors that give access to their
+   entries with VecGetArrayRead(), such as VECSEQ and VECMPI; the inner products of VECNEST are computed from those of
+   its blocks. The local sums are computed with binned summation: the summands are split on a fixed grid of
+   exponents and accumulated exactly, and the sums of the processes are merged exactly by a custom MPI reduction.
+   The result is more accurate than the usual sum, at about twice the cost of the usual local kernels for vectors that
+   do not fit in cache, and the communication is a few times larger. VecFuse objects compute their operations one
+   at a time in this mode. Summands larger than about 1e290 in magnitude, such as the squares of entries larger than
+   about 1e145 in the 2-norms, are added in the usual way, so those results are not reproducible.
+
+   The mode must not be changed while split phase reductions are pending. It requires double precision.
+
+   Level: advanced
+
+.seealso: VecGetReproducibleReductions(), VecDot(), VecNorm(), VecMDot(), VecDotBegin()
+@*/
+PetscErrorCode VecSetReproducibleReductions(PetscBool flg)
+{
+  PetscFunctionBegin;
+#if !defined(PETSC_USE_REAL_DOUBLE)
+  if (flg) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Reproducible reductions require double precision");
+#endif
+  VecReproducibleReductions = flg;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecGetReproducibleReductions - Tells whether the inner products and norms of vectors are bitwise reproducible
+
+   Not Collective
+
+   Output Parameter:
+.  flg - PETSC_TRUE if reproducible inner products and norms are computed
+
+   Level: advanced
+
+.seealso: VecSetReproducibleReductions()
+@*/
+PetscErrorCode VecGetReproducibleReductions(PetscBool *flg)
+{
+  PetscFunctionBegin;
+  PetscValidPointer(flg,1);
+  *flg = VecReproducibleReductions;
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,615 @@
+/*
+      Fused vector kernels: a short sequence of vector updates and reductions is recorded and then executed
+   as a single loop over the entries, with all the reductions combined into one MPI_Allreduce().
+
+       Usage:
+             VecFuseCreate(comm,&fuse);
+             VecFuseAXPY(fuse,x,alpha,p);
+             VecFuseAXPY(fuse,r,-alpha,w);
+             VecFuseNorm(fuse,r,&rnorm);
+             VecFuseExecute(fuse);      rnorm is available from here on
+             ....
+             VecFuseDestroy(&fuse);
+
+      VecFuseExecuteBegin() and VecFuseExecuteEnd() split the execution so that the reductions can be
+   communicated with those of VecDotBegin() and friends, and overlapped with other work.
+
+      Since every recorded operation is pointwise, the loop is strip mined: each operation is applied to a
+   small block of entries before moving on to the next block, so the entries of a block are brought into the
+   cache once and reused by all the operations instead of being streamed from memory by each of them.
+*/
+
+#include <petsc/private/vecimpl.h>    /*I   "petscvec.h"    I*/
+
+#define VECFUSE_MAX_OPS  16
+#define VECFUSE_MAX_VECS 16
+#define VECFUSE_BLOCK    256
+
+typedef enum {VECFUSE_AXPY,VECFUSE_AYPX,VECFUSE_WAXPY,VECFUSE_POINTWISEMULT,VECFUSE_AXPBYPCZ,VECFUSE_DOT,VECFUSE_TDOT,VECFUSE_NORM} VecFuseOpType;
+
+typedef struct {
+  VecFuseOpType type;
+  PetscInt      w,x,y;       /* locations in vecs[] of the operands, w is the vector that is changed */
+  PetscScalar   alpha,beta,gamma;
+  PetscScalar   *dot;        /* where the result of a reduction goes */
+  PetscReal     *norm;
+} VecFuseOp;
+
+struct _n_VecFuse {
+  MPI_Comm  comm;
+  PetscInt  n;                          /* local length of the vectors */
+  PetscInt  nops,nvecs;
+  VecFuseOp ops[VECFUSE_MAX_OPS];
+  Vec       vecs[VECFUSE_MAX_VECS];
+  PetscBool write[VECFUSE_MAX_VECS];    /* vecs[i] is changed by one of the operations */
+
+  /* reductions started by VecFuseExecuteBegin() whose results are set by VecFuseExecuteEnd() */
+  PetscInt            npending;
+  VecFuseOp           pending[VECFUSE_MAX_OPS];
+  PetscSplitReduction *sr;
+};
+
+/*@C
+   VecFuseCreate - Creates an object that records a sequence of vector operations and computes them in a
+   single pass over the vector entries.
+
+   Collective
+
+   Input Parameter:
+.  comm - the communicator of the vectors that will be used
+
+   Output Parameter:
+.  fuse - the new object
+
+   Notes:
+   The operations are recorded with VecFuseAXPY(), VecFuseAYPX(), VecFuseWAXPY(), VecFusePointwiseMult(),
+   VecFuseAXPBYPCZ(), VecFuseDot(), VecFuseTDot() and VecFuseNorm() and computed by VecFuseExecute(). The results
+   equal those of calling the corresponding Vec routines in the order they were recorded, but each vector is read
+   from memory once instead of once per operation and all the inner products and norms share one global reduction.
+
+   Level: advanced
+
+.seealso: VecFuseExecute(), VecFuseDestroy(), VecDotBegin(), VecDotNorm2()
+@*/
+PetscErrorCode VecFuseCreate(MPI_Comm comm,VecFuse *fuse)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fuse,2);
+  ierr = PetscNew(fuse);CHKERRQ(ierr);
+  (*fuse)->comm = comm;
+  (*fuse)->n    = -1;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   VecFuseDestroy - Destroys an object created with VecFuseCreate()
+
+   Not Collective
+
+   Input Parameter:
+.  fuse - the object
+
+   Level: advanced
+
+.seealso: VecFuseCreate()
+@*/
+PetscErrorCode VecFuseDestroy(VecFuse *fuse)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!*fuse) PetscFunctionReturn(0);
+  ierr = PetscFree(*fuse);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* returns the location of v in fuse->vecs[], adding it if needed */
+static PetscErrorCode VecFuseAddVec_Private(VecFuse fuse,Vec v,PetscInt arg,PetscBool write,PetscInt *loc)
+{
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(v,VEC_CLASSID,arg);
+  if (fuse->n < 0) fuse->n = v->map->n;
+  else if (v->map->n != fuse->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Vector local length %D differs from the %D of the vectors already recorded",v->map->n,fuse->n);
+  for (i=0; i<fuse->nvecs; i++) if (fuse->vecs[i] == v) break;
+  if (i == fuse->nvecs) {
+    if (fuse->nvecs == VECFUSE_MAX_VECS) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SUP,"At most %d different vectors can be recorded",VECFUSE_MAX_VECS);
+    fuse->vecs[i]  = v;
+    fuse->write[i] = PETSC_FALSE;
+    fuse->nvecs++;
+  }
+  if (write) {
+    ierr = VecSetErrorIfLocked(v,arg);CHKERRQ(ierr);
+    fuse->write[i] = PETSC_TRUE;
+  }
+  *loc = i;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode VecFuseAddOp_Private(VecFuse fuse,VecFuseOpType type,Vec w,Vec x,Vec y,PetscScalar alpha,PetscScalar *dot,PetscReal *norm)
+{
+  VecFuseOp      *op;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (fuse->nops == VECFUSE_MAX_OPS) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SUP,"At most %d operations can be recorded",VECFUSE_MAX_OPS);
+  op        = &fuse->ops[fuse->nops];
+  op->type  = type;
+  op->alpha = alpha;
+  op->beta  = 0.0;
+  op->gamma = 0.0;
+  op->dot   = dot;
+  op->norm  = norm;
+  op->w     = op->x = op->y = -1;
+  if (w) {ierr = VecFuseAddVec_Private(fuse,w,2,(PetscBool)(type < VECFUSE_DOT),&op->w);CHKERRQ(ierr);}
+  if (x) {ierr = VecFuseAddVec_Private(fuse,x,3,PETSC_FALSE,&op->x);CHKERRQ(ierr);}
+  if (y) {ierr = VecFuseAddVec_Private(fuse,y,4,PETSC_FALSE,&op->y);CHKERRQ(ierr);}
+  fuse->nops++;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   VecFuseAXPY - Records y = y + alpha x
+
+   Not Collective
+
+   Input Parameters:
++  fuse - the object
+.  y - the vector that is changed
+.  alpha - the scalar
+-  x - the other vector
+
+   Level: advanced
+
+.seealso: VecFuseCreate(), VecFuseExecute(), VecAXPY()
+@*/
+PetscErrorCode VecFuseAXPY(VecFuse fuse,Vec y,PetscScalar alpha,Vec x)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fuse,1);
+  ierr = VecFuseAddOp_Private(fuse,VECFUSE_AXPY,y,x,NULL,alpha,NULL,NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   VecFuseAYPX - Records y = x + beta y
+
+   Not Collective
+
+   Input Parameters:
++  fuse - the object
+.  y - the vector that is changed
+.  beta - the scalar
+-  x - the other vector
+
+   Level: advanced
+
+.seealso: VecFuseCreate(), VecFuseExecute(), VecAYPX()
+@*/
+PetscErrorCode VecFuseAYPX(VecFuse fuse,Vec y,PetscScalar beta,Vec x)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fuse,1);
+  ierr = VecFuseAddOp_Private(fuse,VECFUSE_AYPX,y,x,NULL,beta,NULL,NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   VecFuseWAXPY - Records w = alpha x + y
+
+   Not Collective
+
+   Input Parameters:
++  fuse - the object
+.  w - the vector that is changed
+.  alpha - the scalar
+-  x, y - the other vectors
+
+   Level: advanced
+
+.seealso: VecFuseCreate(), VecFuseExecute(), VecWAXPY()
+@*/
+PetscErrorCode VecFuseWAXPY(VecFuse fuse,Vec w,PetscScalar alpha,Vec x,Vec y)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fuse,1);
+  ierr = VecFuseAddOp_Private(fuse,VECFUSE_WAXPY,w,x,y,alpha,NULL,NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   VecFusePointwiseMult - Records w_i = x_i y_i
+
+   Not Collective
+
+   Input Parameters:
++  fuse - the object
+.  w - the vector that is changed
+-  x, y - the other vectors
+
+   Level: advanced
+
+.seealso: VecFuseCreate(), VecFuseExecute(), VecPointwiseMult()
+@*/
+PetscErrorCode VecFusePointwiseMult(VecFuse fuse,Vec w,Vec x,Vec y)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fuse,1);
+  ierr = VecFuseAddOp_Private(fuse,VECFUSE_POINTWISEMULT,w,x,y,0.0,NULL,NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   VecFuseAXPBYPCZ - Records z = alpha x + beta y + gamma z
+
+   Not Collective
+
+   Input Parameters:
++  fuse - the object
+.  z - the vector that is changed
+.  alpha, beta, gamma - the scalars
+-  x, y - the other vectors
+
+   Level: advanced
+
+.seealso: VecFuseCreate(), VecFuseExecute(), VecAXPBYPCZ()
+@*/
+PetscErrorCode VecFuseAXPBYPCZ(VecFuse fuse,Vec z,PetscScalar alpha,PetscScalar beta,PetscScalar gamma,Vec x,Vec y)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fuse,1);
+  ierr = VecFuseAddOp_Private(fuse,VECFUSE_AXPBYPCZ,z,x,y,alpha,NULL,NULL);CHKERRQ(ierr);
+  fuse->ops[fuse->nops-1].beta  = beta;
+  fuse->ops[fuse->nops-1].gamma = gamma;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   VecFuseDot - Records the inner product val = y^H x
+
+   Not Collective
+
+   Input Parameters:
++  fuse - the object
+-  x, y - the vectors
+
+   Output Parameter:
+.  val - the location of the inner product, it is set by VecFuseExecute()
+
+   Level: advanced
+
+.seealso: VecFuseCreate(), VecFuseExecute(), VecDot(), VecFuseTDot()
+@*/
+PetscErrorCode VecFuseDot(VecFuse fuse,Vec x,Vec y,PetscScalar *val)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fuse,1);
+  PetscValidScalarPointer(val,4);
+  ierr = VecFuseAddOp_Private(fuse,VECFUSE_DOT,NULL,x,y,0.0,val,NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   VecFuseTDot - Records the indefinite inner product val = y^T x
+
+   Not Collective
+
+   Input Parameters:
++  fuse - the object
+-  x, y - the vectors
+
+   Output Parameter:
+.  val - the location of the inner product, it is set by VecFuseExecute()
+
+   Level: advanced
+
+.seealso: VecFuseCreate(), VecFuseExecute(), VecTDot(), VecFuseDot()
+@*/
+PetscErrorCode VecFuseTDot(VecFuse fuse,Vec x,Vec y,PetscScalar *val)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fuse,1);
+  PetscValidScalarPointer(val,4);
+  ierr = VecFuseAddOp_Private(fuse,VECFUSE_TDOT,NULL,x,y,0.0,val,NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   VecFuseNorm - Records the 2-norm of a vector
+
+   Not Collective
+
+   Input Parameters:
++  fuse - the object
+-  x - the vector
+
+   Output Parameter:
+.  val - the location of the norm, it is set by VecFuseExecute()
+
+   Notes:
+   The norm is computed as the square root of the sum of squares, without the scaling that VecNorm() may use
+   to avoid overflow.
+
+   Level: advanced
+
+.seealso: VecFuseCreate(), VecFuseExecute(), VecNorm()
+@*/
+PetscErrorCode VecFuseNorm(VecFuse fuse,Vec x,PetscReal *val)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fuse,1);
+  PetscValidRealPointer(val,3);
+  ierr = VecFuseAddOp_Private(fuse,VECFUSE_NORM,NULL,x,NULL,0.0,NULL,val);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Used for vectors without a PETSc native array and for reproducible reductions, the operations are done one after
+   the other by the Vec routines. VecDotBegin() is not used since the local parts of the VECNEST reductions are already global
+*/
+static PetscErrorCode VecFuseExecute_Unfused(VecFuse fuse)
+{
+  VecFuseOp      *op;
+  Vec            *v = fuse->vecs;
+  PetscInt       k;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (k=0; k<fuse->nops; k++) {
+    op = &fuse->ops[k];
+    switch (op->type) {
+    case VECFUSE_AXPY:          ierr = VecAXPY(v[op->w],op->alpha,v[op->x]);CHKERRQ(ierr); break;
+    case VECFUSE_AYPX:          ierr = VecAYPX(v[op->w],op->alpha,v[op->x]);CHKERRQ(ierr); break;
+    case VECFUSE_WAXPY:         ierr = VecWAXPY(v[op->w],op->alpha,v[op->x],v[op->y]);CHKERRQ(ierr); break;
+    case VECFUSE_POINTWISEMULT: ierr = VecPointwiseMult(v[op->w],v[op->x],v[op->y]);CHKERRQ(ierr); break;
+    case VECFUSE_AXPBYPCZ:      ierr = VecAXPBYPCZ(v[op->w],op->alpha,op->beta,op->gamma,v[op->x],v[op->y]);CHKERRQ(ierr); break;
+    case VECFUSE_DOT:           ierr = VecDot(v[op->x],v[op->y],op->dot);CHKERRQ(ierr); break;
+    case VECFUSE_TDOT:          ierr = VecTDot(v[op->x],v[op->y],op->dot);CHKERRQ(ierr); break;
+    case VECFUSE_NORM:          ierr = VecNorm(v[op->x],NORM_2,op->norm);CHKERRQ(ierr); break;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+
+/* does the loop over the entries, lsum[] gets the local parts of the reductions in the order they were recorded */
+static PetscErrorCode VecFuseExecuteLocal_Private(VecFuse fuse,PetscScalar lsum[],PetscInt *nred)
+{
+  PetscScalar    *a[VECFUSE_MAX_VECS];
+  PetscInt       i,k,start,end,n = fuse->n;
+  PetscLogDouble flops = 0.0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<fuse->nvecs; i++) {
+    if (fuse->write[i]) {ierr = VecGetArray(fuse->vecs[i],&a[i]);CHKERRQ(ierr);}
+    else {ierr = VecGetArrayRead(fuse->vecs[i],(const PetscScalar**)&a[i]);CHKERRQ(ierr);}
+  }
+  for (k=0; k<fuse->nops; k++) lsum[k] = 0.0;
+
+  for (start=0; start<n; start=end) {
+    end = PetscMin(start+VECFUSE_BLOCK,n);
+    for (k=0; k<fuse->nops; k++) {
+      const VecFuseOp   *op = &fuse->ops[k];
+      const PetscScalar alpha = op->alpha,beta = op->beta,gamma = op->gamma,*x = op->x >= 0 ? a[op->x] : NULL,*y = op->y >= 0 ? a[op->y] : NULL;
+      PetscScalar       *w = op->w >= 0 ? a[op->w] : NULL,sum = 0.0;
+
+      switch (op->type) {
+      case VECFUSE_AXPY:          for (i=start; i<end; i++) w[i] += alpha*x[i]; break;
+      case VECFUSE_AYPX:          for (i=start; i<end; i++) w[i]  = x[i] + alpha*w[i]; break;
+      case VECFUSE_WAXPY:         for (i=start; i<end; i++) w[i]  = alpha*x[i] + y[i]; break;
+      case VECFUSE_POINTWISEMULT: for (i=start; i<end; i++) w[i]  = x[i]*y[i]; break;
+      case VECFUSE_AXPBYPCZ:      for (i=start; i<end; i++) w[i]  = alpha*x[i] + beta*y[i] + gamma*w[i]; break;
+      case VECFUSE_DOT:           for (i=start; i<end; i++) sum += x[i]*PetscConj(y[i]); lsum[k] += sum; break;
+      case VECFUSE_TDOT:          for (i=start; i<end; i++) sum += x[i]*y[i]; lsum[k] += sum; break;
+      case VECFUSE_NORM:          for (i=start; i<end; i++) sum += PetscRealPart(x[i]*PetscConj(x[i])); lsum[k] += sum; break;
+      }
+    }
+  }
+
+  for (i=0; i<fuse->nvecs; i++) {
+    if (fuse->write[i]) {ierr = VecRestoreArray(fuse->vecs[i],&a[i]);CHKERRQ(ierr);}
+    else {ierr = VecRestoreArrayRead(fuse->vecs[i],(const PetscScalar**)&a[i]);CHKERRQ(ierr);}
+  }
+
+  *nred = 0;
+  for (k=0; k<fuse->nops; k++) {
+    if (fuse->ops[k].type >= VECFUSE_DOT) lsum[(*nred)++] = lsum[k];
+    flops += (fuse->ops[k].type == VECFUSE_POINTWISEMULT) ? n : (fuse->ops[k].type == VECFUSE_AXPBYPCZ ? 5.0*n : 2.0*n);
+  }
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* sets the results of the reductions of op[], gsum[] has the global values in the order they were recorded */
+static void VecFuseSetResults_Private(PetscInt nops,const VecFuseOp op[],const PetscScalar gsum[])
+{
+  PetscInt k,nred = 0;
+
+  for (k=0; k<nops; k++) {
+    if (op[k].type == VECFUSE_NORM) *op[k].norm = PetscSqrtReal(PetscRealPart(gsum[nred++]));
+    else if (op[k].type >= VECFUSE_DOT) *op[k].dot = gsum[nred++];
+  }
+}
+
+static void VecFuseClear_Private(VecFuse fuse)
+{
+  fuse->nops  = 0;
+  fuse->nvecs = 0;
+  fuse->n     = -1;
+}
+
+/*@C
+   VecFuseExecute - Computes the operations recorded in a VecFuse object and clears the record
+
+   Collective on the communicator of the vectors
+
+   Input Parameter:
+.  fuse - the object
+
+   Notes:
+   The results of the inner products and norms are available when this routine returns.
+
+   Vectors that do not provide direct access to their entries (for example VECNEST) are handled by calling the
+   Vec routines one after the other; each inner product and norm then does its own reduction.
+
+   Level: advanced
+
+.seealso: VecFuseCreate(), VecFuseAXPY(), VecFuseAYPX(), VecFuseWAXPY(), VecFusePointwiseMult(), VecFuseAXPBYPCZ(), VecFuseDot(),
+          VecFuseTDot(), VecFuseNorm(), VecFuseExecuteBegin()
+@*/
+PetscErrorCode VecFuseExecute(VecFuse fuse)
+{
+  PetscScalar    lsum[VECFUSE_MAX_OPS],gsum[VECFUSE_MAX_OPS];
+  PetscInt       i,nred;
+  PetscBool      native = (PetscBool)!VecReproducibleReductions;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fuse,1);
+  if (!fuse->nops) PetscFunctionReturn(0);
+  for (i=0; i<fuse->nvecs; i++) native = (PetscBool)(native && fuse->vecs[i]->petscnative);
+  ierr = PetscLogEventBegin(VEC_Fuse,fuse->vecs[0],0,0,0);CHKERRQ(ierr);
+  if (!native) {
+    ierr = VecFuseExecute_Unfused(fuse);CHKERRQ(ierr);
+  } else {
+    ierr = VecFuseExecuteLocal_Private(fuse,lsum,&nred);CHKERRQ(ierr);
+    /* all the reductions are communicated together */
+    if (nred) {ierr = MPIU_Allreduce(lsum,gsum,nred,MPIU_SCALAR,MPIU_SUM,fuse->comm);CHKERRQ(ierr);}
+    VecFuseSetResults_Private(fuse->nops,fuse->ops,gsum);
+  }
+  ierr = PetscLogEventEnd(VEC_Fuse,fuse->vecs[0],0,0,0);CHKERRQ(ierr);
+  VecFuseClear_Private(fuse);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   VecFuseExecuteBegin - Computes the operations recorded in a VecFuse object and queues the local parts of its
+   inner products and norms for a split phase reduction, then clears the record
+
+   Collective on the communicator of the vectors
+
+   Input Parameter:
+.  fuse - the object
+
+   Notes:
+   The vector updates are done when this routine returns, the inner products and norms are available after
+   VecFuseExecuteEnd(). The reductions share the split phase reduction of the communicator with VecDotBegin(),
+   VecNormBegin() and the other VecXxxBegin() routines, so they may be mixed with these and are all communicated
+   together. Calling PetscCommSplitReductionBegin() starts the communication without waiting for it, so that it
+   can progress during computations that do not depend on the results, for example the update of the solution
+   in a Krylov method. Those computations must not use a split phase reduction on the same communicator.
+
+   Operations may be recorded and VecFuseExecuteBegin() called again before VecFuseExecuteEnd(), one call to
+   VecFuseExecuteEnd() then gets the results of all of them.
+
+   Level: advanced
+
+.seealso: VecFuseExecuteEnd(), VecFuseExecute(), PetscCommSplitReductionBegin(), VecDotBegin(), VecNormBegin()
+@*/
+PetscErrorCode VecFuseExecuteBegin(VecFuse fuse)
+{
+  PetscScalar         lsum[VECFUSE_MAX_OPS];
+  PetscInt            i,k,nred;
+  PetscBool           native = (PetscBool)!VecReproducibleReductions;
+  PetscSplitReduction *sr;
+  MPI_Comm            comm;
+  PetscErrorCode      ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fuse,1);
+  if (!fuse->nops) PetscFunctionReturn(0);
+  for (i=0; i<fuse->nvecs; i++) native = (PetscBool)(native && fuse->vecs[i]->petscnative);
+  ierr = PetscLogEventBegin(VEC_Fuse,fuse->vecs[0],0,0,0);CHKERRQ(ierr);
+  if (!native) {
+    ierr = VecFuseExecute_Unfused(fuse);CHKERRQ(ierr);
+  } else {
+    ierr = PetscObjectGetComm((PetscObject)fuse->vecs[0],&comm);CHKERRQ(ierr);
+    ierr = PetscSplitReductionGet(comm,&sr);CHKERRQ(ierr);
+    if (sr->state != STATE_BEGIN) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Called before all VecxxxEnd() called");
+    if (sr->numopsbegin && sr->binned) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Cannot change VecSetReproducibleReductions() while split phase reductions are pending");
+    if (fuse->npending && sr != fuse->sr) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"The vectors are on a different communicator than those of the pending reductions");
+    for (k=0,nred=0; k<fuse->nops; k++) if (fuse->ops[k].type >= VECFUSE_DOT) nred++;
+    if (fuse->npending+nred > VECFUSE_MAX_OPS) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SUP,"At most %d reductions can wait for VecFuseExecuteEnd()",VECFUSE_MAX_OPS);
+    ierr = VecFuseExecuteLocal_Private(fuse,lsum,&nred);CHKERRQ(ierr);
+    for (k=0; k<fuse->nops; k++) {
+      if (fuse->ops[k].type >= VECFUSE_DOT) fuse->pending[fuse->npending++] = fuse->ops[k];
+    }
+    for (k=0; k<nred; k++) {
+      if (sr->numopsbegin >= sr->maxops) {ierr = PetscSplitReductionExtend(sr);CHKERRQ(ierr);}
+      sr->reducetype[sr->numopsbegin] = PETSC_SR_REDUCE_SUM;
+      sr->invecs[sr->numopsbegin]     = (void*)fuse;
+      sr->lvalues[sr->numopsbegin++]  = lsum[k];
+    }
+    fuse->sr = sr;
+  }
+  ierr = PetscLogEventEnd(VEC_Fuse,fuse->vecs[0],0,0,0);CHKERRQ(ierr);
+  VecFuseClear_Private(fuse);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   VecFuseExecuteEnd - Completes the reductions started with VecFuseExecuteBegin()
+
+   Collective on the communicator of the vectors
+
+   Input Parameter:
+.  fuse - the object
+
+   Notes:
+   The inner products and norms are available when this routine returns. The reductions of the split phase must
+   be completed in the order they were started, so VecXxxEnd() must be called for VecXxxBegin() calls that came
+   before VecFuseExecuteBegin() first.
+
+   Level: advanced
+
+.seealso: VecFuseExecuteBegin(), VecFuseExecute(), PetscCommSplitReductionBegin()
+@*/
+PetscErrorCode VecFuseExecuteEnd(VecFuse fuse)
+{
+  PetscSplitReduction *sr = fuse->sr;
+  PetscScalar         gsum[VECFUSE_MAX_OPS];
+  PetscInt            k;
+  PetscErrorCode      ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fuse,1);
+  if (!fuse->npending) PetscFunctionReturn(0);
+  ierr = PetscSplitReductionEnd(sr);CHKERRQ(ierr);
+  if (sr->numopsend+fuse->npending > sr->numopsbegin) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Called VecxxxEnd() more times then VecxxxBegin()");
+  for (k=0; k<fuse->npending; k++) {
+    if (sr->invecs[sr->numopsend] != (void*)fuse) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Called VecxxxEnd() in a different order or with a different vector than VecxxxBegin()");
+    gsum[k] = sr->gvalues[sr->numopsend++];
+  }
+  VecFuseSetResults_Private(fuse->npending,fuse->pending,gsum);
+  fuse->npending = 0;
+  fuse->sr       = NULL;
+
+  /* all the results have been gotten so reset to no outstanding requests */
+  if (sr->numopsend == sr->numopsbegin) {
+    sr->state       = STATE_BEGIN;
+    sr->numopsend   = 0;
+    sr->numopsbegin = 0;
+  }
+  PetscFunctionReturn(0);
+}
@@ -1303,7 +1303,9 @@ PetscErrorCode  VecDotNorm2(Vec s,Vec t,PetscScalar *dp, PetscReal *nm)
   if (s->map->n != t->map->n) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Incompatible vector local lengths");
 
   ierr = PetscLogEventBegin(VEC_DotNorm2,s,t,0,0);CHKERRQ(ierr);
-  if (s->ops->dotnorm2) {
+  if (VecUseBinned_Private(s,1,&t)) {
+    ierr = VecDotNorm2Binned_Private(s,t,dp,nm);CHKERRQ(ierr);
+  } else if (s->ops->dotnorm2) {
     ierr = (*s->ops->dotnorm2)(s,t,dp,&dpx);CHKERRQ(ierr);
     *nm  = PetscRealPart(dpx);
   } else {
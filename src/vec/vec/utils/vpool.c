@@ -0,0 +1,178 @@
+/*
+      A pool of the arrays of vectors, so that the work vectors repeatedly created with VecDuplicate() and destroyed,
+   for example by KSPCreateVecs(), the SNES line searches and the TS stages, reuse memory that is already mapped and
+   touched instead of going through PetscMalloc() and the page faults of a fresh allocation.
+
+      When a vector is destroyed its array is cached in its PetscLayout, and the next vector created with that layout
+   and an array of the same length (the local length plus the number of ghost points) takes it. The layout is shared
+   by the duplicates of a vector and by the vectors obtained from MatCreateVecs() with the same matrix, so the arrays
+   are handed back to those only. They are freed when the layout is destroyed, or when more than VEC_POOL_SIZE arrays
+   are cached in it, the one cached first being freed then.
+*/
+
+#include <petsc/private/vecimpl.h>    /*I   "petscvec.h"    I*/
+
+#define VEC_POOL_SIZE 8
+
+typedef struct {
+  PetscInt    n;                    /* number of cached arrays, the most recently cached last */
+  PetscInt    len[VEC_POOL_SIZE];   /* their lengths */
+  PetscScalar *array[VEC_POOL_SIZE];
+} VecPool;
+
+PetscBool VecPoolArrays = PETSC_TRUE;
+
+/* the statistics shown by -malloc_view */
+static PetscLogDouble VecPoolReused = 0,VecPoolAllocated = 0,VecPoolMem = 0,VecPoolMaxMem = 0;
+
+static PetscErrorCode VecPoolDestroy_Private(void **ptr)
+{
+  VecPool        *pool = (VecPool*)*ptr;
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<pool->n; i++) {
+    VecPoolMem -= pool->len[i]*sizeof(PetscScalar);
+    ierr = PetscFree(pool->array[i]);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(*ptr);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   VecPoolGetArray_Private - Takes an array of length n cached in the layout, its entries are not initialized; the
+   array is NULL if there is none and the caller must allocate it
+*/
+PetscErrorCode VecPoolGetArray_Private(PetscLayout map,PetscInt n,PetscScalar **array)
+{
+  VecPool  *pool = (VecPool*)map->pool;
+  PetscInt i,j;
+
+  PetscFunctionBegin;
+  *array = NULL;
+#if !defined(PETSC_USE_MIXED_PRECISION)
+  if (!VecPoolArrays) PetscFunctionReturn(0);
+  for (i=pool ? pool->n-1 : -1; i>=0; i--) {
+    if (pool->len[i] == n) {
+      *array = pool->array[i];
+      for (j=i+1; j<pool->n; j++) {
+        pool->len[j-1]   = pool->len[j];
+        pool->array[j-1] = pool->array[j];
+      }
+      pool->n--;
+      VecPoolMem -= n*sizeof(PetscScalar);
+      VecPoolReused++;
+      PetscFunctionReturn(0);
+    }
+  }
+  VecPoolAllocated++;
+#endif
+  PetscFunctionReturn(0);
+}
+
+/*
+   VecPoolRestoreArray_Private - Caches the array of length n, allocated with PetscMalloc(), of a vector with the
+   layout that is destroyed, or frees it
+*/
+PetscErrorCode VecPoolRestoreArray_Private(PetscLayout map,PetscInt n,PetscScalar **array)
+{
+  VecPool        *pool;
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!*array) PetscFunctionReturn(0);
+#if !defined(PETSC_USE_MIXED_PRECISION)
+  if (VecPoolArrays && n > 0) {
+    if (!map->pool) {
+      ierr = PetscNew(&pool);CHKERRQ(ierr);
+      map->pool        = (void*)pool;
+      map->pooldestroy = VecPoolDestroy_Private;
+    }
+    pool = (VecPool*)map->pool;
+    if (pool->n == VEC_POOL_SIZE) {
+      VecPoolMem -= pool->len[0]*sizeof(PetscScalar);
+      ierr = PetscFree(pool->array[0]);CHKERRQ(ierr);
+      for (i=1; i<pool->n; i++) {
+        pool->len[i-1]   = pool->len[i];
+        pool->array[i-1] = pool->array[i];
+      }
+      pool->n--;
+    }
+    pool->len[pool->n]     = n;
+    pool->array[pool->n++] = *array;
+    *array                 = NULL;
+    VecPoolMem            += n*sizeof(PetscScalar);
+    VecPoolMaxMem          = PetscMax(VecPoolMaxMem,VecPoolMem);
+    PetscFunctionReturn(0);
+  }
+#endif
+  ierr = PetscFree(*array);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode VecPoolView_Private(FILE *fp)
+{
+  PetscMPIInt    rank;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(MPI_COMM_WORLD,&rank);CHKERRQ(ierr);
+  (void) fprintf(fp,"[%d] Vec arrays reused %.0f allocated %.0f maximum memory cached for reuse %.0f\n",rank,VecPoolReused,VecPoolAllocated,VecPoolMaxMem);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecSetPoolArrays - Makes the arrays of destroyed vectors be reused by the vectors created next with the same
+   layout, such as the work vectors obtained with VecDuplicate()
+
+   Not Collective
+
+   Input Parameter:
+.  flg - PETSC_TRUE to reuse the arrays, PETSC_FALSE to free them when the vectors are destroyed
+
+   Options Database Key:
+.  -vec_pool_arrays <true> - reuse the arrays of destroyed vectors
+
+   Notes:
+   The array of a destroyed vector is kept with its PetscLayout, which is shared by the vectors obtained from it with
+   VecDuplicate() and by the vectors obtained from the same matrix with MatCreateVecs(), and it is handed to the next of
+   those vectors created with an array of the same length. This avoids the cost of allocating and first touching
+   memory for the work vectors that solvers create and destroy repeatedly. A few arrays are kept for each layout, they
+   are freed when the layout is destroyed, that is when its last vector or matrix is destroyed. The number of arrays
+   reused and allocated and the maximum memory kept are shown by -malloc_view.
+
+   Turn this off when debugging memory errors with -malloc_debug or valgrind, so that the accesses to the array of a
+   destroyed vector are detected.
+
+   Level: advanced
+
+.seealso: VecGetPoolArrays(), VecDuplicate(), VecDestroy(), PetscMallocView()
+@*/
+PetscErrorCode VecSetPoolArrays(PetscBool flg)
+{
+  PetscFunctionBegin;
+  VecPoolArrays = flg;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecGetPoolArrays - Tells whether the arrays of destroyed vectors are reused
+
+   Not Collective
+
+   Output Parameter:
+.  flg - PETSC_TRUE if the arrays are reused
+
+   Level: advanced
+
+.seealso: VecSetPoolArrays()
+@*/
+PetscErrorCode VecGetPoolArrays(PetscBool *flg)
+{
+  PetscFunctionBegin;
+  PetscValidPointer(flg,1);
+  *flg = VecPoolArrays;
+  PetscFunctionReturn(0);
+}
@@ -12,6 +12,8 @@ typedef struct {
   PetscSF           lsf;    /* the local part of the scatter, used for SCATTER_LOCAL */
   PetscInt          bs;     /* block size */
   MPI_Datatype      unit;   /* one unit = bs PetscScalars */
+  const PetscScalar **xarrays; /* arrays of the vectors between VecScatterBeginMultiple() and VecScatterEndMultiple() */
+  PetscScalar       **yarrays;
 } VecScatter_SF;
 
 static PetscErrorCode VecScatterBegin_SF(VecScatter vscat,Vec x,Vec y,InsertMode addv,ScatterMode mode)
@@ -72,6 +74,24 @@ static PetscErrorCode VecScatterBegin_SF(VecScatter vscat,Vec x,Vec y,InsertMode
   PetscFunctionReturn(0);
 }
 
+/* Give back the arrays and locks taken by VecScatterBegin_SF() */
+static PetscErrorCode VecScatterRestoreArrays_SF(VecScatter vscat,Vec x,Vec y)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (x != y) {
+    if (use_gpu_aware_mpi) {ierr = VecRestoreArrayReadInPlace(x,&vscat->xdata);CHKERRQ(ierr);}
+    else {ierr = VecRestoreArrayRead(x,&vscat->xdata);CHKERRQ(ierr);}
+    ierr = VecLockReadPop(x);CHKERRQ(ierr);
+  }
+
+  if (use_gpu_aware_mpi) {ierr = VecRestoreArrayInPlace(y,&vscat->ydata);CHKERRQ(ierr);}
+  else {ierr = VecRestoreArray(y,&vscat->ydata);CHKERRQ(ierr);}
+  ierr = VecLockWriteSet_Private(y,PETSC_FALSE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode VecScatterEnd_SF(VecScatter vscat,Vec x,Vec y,InsertMode addv,ScatterMode mode)
 {
   VecScatter_SF  *data=(VecScatter_SF*)vscat->data;
@@ -96,17 +116,121 @@ static PetscErrorCode VecScatterEnd_SF(VecScatter vscat,Vec x,Vec y,InsertMode a
   } else { /* forward scatter sends roots to leaves, i.e., x to y */
     ierr = PetscSFBcastAndOpEnd(sf,data->unit,vscat->xdata,vscat->ydata,mop);CHKERRQ(ierr);
   }
+  ierr = VecScatterRestoreArrays_SF(vscat,x,y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 
-  if (x != y) {
-    if (use_gpu_aware_mpi) {ierr = VecRestoreArrayReadInPlace(x,&vscat->xdata);CHKERRQ(ierr);}
-    else {ierr = VecRestoreArrayRead(x,&vscat->xdata);CHKERRQ(ierr);}
-    ierr = VecLockReadPop(x);CHKERRQ(ierr);
+/* Only the forward scatter is completed piecewise, the reverse one gathers contributions of all ranks into the same entries */
+static PetscErrorCode VecScatterEndAny_SF(VecScatter vscat,Vec x,Vec y,InsertMode addv,ScatterMode mode,PetscMPIInt *rank)
+{
+  VecScatter_SF  *data=(VecScatter_SF*)vscat->data;
+  PetscSF        sf;
+  MPI_Op         mop=MPI_OP_NULL;
+  PetscMPIInt    size;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (mode & SCATTER_REVERSE) {
+    ierr  = VecScatterEnd_SF(vscat,x,y,addv,mode);CHKERRQ(ierr);
+    *rank = MPI_ANY_SOURCE;
+    PetscFunctionReturn(0);
   }
+  ierr = MPI_Comm_size(PetscObjectComm((PetscObject)data->sf),&size);CHKERRQ(ierr);
+  sf = ((mode & SCATTER_LOCAL) && size > 1) ? data->lsf : data->sf;
 
-  if (use_gpu_aware_mpi) {ierr = VecRestoreArrayInPlace(y,&vscat->ydata);CHKERRQ(ierr);}
-  else {ierr = VecRestoreArray(y,&vscat->ydata);CHKERRQ(ierr);}
-  ierr = VecLockWriteSet_Private(y,PETSC_FALSE);CHKERRQ(ierr);
+  if (addv == INSERT_VALUES)   mop = MPIU_REPLACE;
+  else if (addv == ADD_VALUES) mop = MPIU_SUM;
+  else if (addv == MAX_VALUES) mop = MPIU_MAX;
+  else if (addv == MIN_VALUES) mop = MPIU_MIN;
+  else SETERRQ1(PetscObjectComm((PetscObject)sf),PETSC_ERR_SUP,"Unsupported InsertMode %D in VecScatterBegin/End",addv);
 
+  ierr = PetscSFBcastAndOpEndAny(sf,data->unit,vscat->xdata,vscat->ydata,mop,rank);CHKERRQ(ierr);
+  if (*rank == MPI_UNDEFINED || *rank == MPI_ANY_SOURCE) {ierr = VecScatterRestoreArrays_SF(vscat,x,y);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/* The arrays of the k vectors are kept in data->xarrays and data->yarrays between the Begin and End */
+static PetscErrorCode VecScatterBeginMultiple_SF(VecScatter vscat,PetscInt k,Vec *x,Vec *y,InsertMode addv,ScatterMode mode)
+{
+  VecScatter_SF  *data=(VecScatter_SF*)vscat->data;
+  PetscSF        sf;
+  MPI_Op         mop=MPI_OP_NULL;
+  PetscMPIInt    size;
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc2(k,&data->xarrays,k,&data->yarrays);CHKERRQ(ierr);
+  for (i=0; i<k; i++) {
+    if (x[i] != y[i]) {ierr = VecLockReadPush(x[i]);CHKERRQ(ierr);}
+    /* Device arrays make PetscSF communicate the vectors one by one */
+    if (use_gpu_aware_mpi) {ierr = VecGetArrayReadInPlace(x[i],&data->xarrays[i]);CHKERRQ(ierr);}
+    else {ierr = VecGetArrayRead(x[i],&data->xarrays[i]);CHKERRQ(ierr);}
+    if (x[i] != y[i]) {
+      if (use_gpu_aware_mpi) {ierr = VecGetArrayInPlace(y[i],&data->yarrays[i]);CHKERRQ(ierr);}
+      else {ierr = VecGetArray(y[i],&data->yarrays[i]);CHKERRQ(ierr);}
+    } else data->yarrays[i] = (PetscScalar*)data->xarrays[i];
+    ierr = VecLockWriteSet_Private(y[i],PETSC_TRUE);CHKERRQ(ierr);
+  }
+
+  ierr = MPI_Comm_size(PetscObjectComm((PetscObject)data->sf),&size);CHKERRQ(ierr);
+  if ((mode & SCATTER_LOCAL) && size > 1) {
+    if (!data->lsf) {ierr = PetscSFCreateLocalSF_Private(data->sf,&data->lsf);CHKERRQ(ierr);}
+    sf = data->lsf;
+  } else {
+    sf = data->sf;
+  }
+
+  if (addv == INSERT_VALUES)   mop = MPIU_REPLACE;
+  else if (addv == ADD_VALUES) mop = MPIU_SUM;
+  else if (addv == MAX_VALUES) mop = MPIU_MAX;
+  else if (addv == MIN_VALUES) mop = MPIU_MIN;
+  else SETERRQ1(PetscObjectComm((PetscObject)sf),PETSC_ERR_SUP,"Unsupported InsertMode %D in VecScatterBeginMultiple/EndMultiple",addv);
+
+  if (mode & SCATTER_REVERSE) {
+    ierr = PetscSFReduceMultipleBegin(sf,data->unit,k,(const void*const*)data->xarrays,(void*const*)data->yarrays,mop);CHKERRQ(ierr);
+  } else {
+    ierr = PetscSFBcastAndOpMultipleBegin(sf,data->unit,k,(const void*const*)data->xarrays,(void*const*)data->yarrays,mop);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode VecScatterEndMultiple_SF(VecScatter vscat,PetscInt k,Vec *x,Vec *y,InsertMode addv,ScatterMode mode)
+{
+  VecScatter_SF  *data=(VecScatter_SF*)vscat->data;
+  PetscSF        sf;
+  MPI_Op         mop=MPI_OP_NULL;
+  PetscMPIInt    size;
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_size(PetscObjectComm((PetscObject)data->sf),&size);CHKERRQ(ierr);
+  sf = ((mode & SCATTER_LOCAL) && size > 1) ? data->lsf : data->sf;
+
+  if (addv == INSERT_VALUES)   mop = MPIU_REPLACE;
+  else if (addv == ADD_VALUES) mop = MPIU_SUM;
+  else if (addv == MAX_VALUES) mop = MPIU_MAX;
+  else if (addv == MIN_VALUES) mop = MPIU_MIN;
+  else SETERRQ1(PetscObjectComm((PetscObject)sf),PETSC_ERR_SUP,"Unsupported InsertMode %D in VecScatterBeginMultiple/EndMultiple",addv);
+
+  if (mode & SCATTER_REVERSE) {
+    ierr = PetscSFReduceMultipleEnd(sf,data->unit,k,(const void*const*)data->xarrays,(void*const*)data->yarrays,mop);CHKERRQ(ierr);
+  } else {
+    ierr = PetscSFBcastAndOpMultipleEnd(sf,data->unit,k,(const void*const*)data->xarrays,(void*const*)data->yarrays,mop);CHKERRQ(ierr);
+  }
+
+  for (i=0; i<k; i++) {
+    if (x[i] != y[i]) {
+      if (use_gpu_aware_mpi) {ierr = VecRestoreArrayReadInPlace(x[i],&data->xarrays[i]);CHKERRQ(ierr);}
+      else {ierr = VecRestoreArrayRead(x[i],&data->xarrays[i]);CHKERRQ(ierr);}
+      ierr = VecLockReadPop(x[i]);CHKERRQ(ierr);
+    }
+    if (use_gpu_aware_mpi) {ierr = VecRestoreArrayInPlace(y[i],&data->yarrays[i]);CHKERRQ(ierr);}
+    else {ierr = VecRestoreArray(y[i],&data->yarrays[i]);CHKERRQ(ierr);}
+    ierr = VecLockWriteSet_Private(y[i],PETSC_FALSE);CHKERRQ(ierr);
+  }
+  ierr = PetscFree2(data->xarrays,data->yarrays);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -116,7 +240,7 @@ static PetscErrorCode VecScatterCopy_SF(VecScatter vscat,VecScatter ctx)
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = PetscMemcpy(ctx->ops,vscat->ops,sizeof(vscat->ops));CHKERRQ(ierr);
+  ierr = PetscMemcpy(ctx->ops,vscat->ops,sizeof(struct _VecScatterOps));CHKERRQ(ierr);
   ierr = PetscNewLog(ctx,&out);CHKERRQ(ierr);
   ierr = PetscSFDuplicate(data->sf,PETSCSF_DUPLICATE_GRAPH,&out->sf);CHKERRQ(ierr);
   ierr = PetscSFSetUp(out->sf);CHKERRQ(ierr);
@@ -749,6 +873,9 @@ functionend:
   vscat->data                      = (void*)data;
   vscat->ops->begin                = VecScatterBegin_SF;
   vscat->ops->end                  = VecScatterEnd_SF;
+  vscat->ops->endany               = VecScatterEndAny_SF;
+  vscat->ops->beginmultiple        = VecScatterBeginMultiple_SF;
+  vscat->ops->endmultiple          = VecScatterEndMultiple_SF;
   vscat->ops->remap                = VecScatterRemap_SF;
   vscat->ops->copy                 = VecScatterCopy_SF;
   vscat->ops->destroy              = VecScatterDestroy_SF;
@@ -156,6 +156,144 @@ PetscErrorCode  VecScatterEnd(VecScatter ctx,Vec x,Vec y,InsertMode addv,Scatter
   PetscFunctionReturn(0);
 }
 
+/*@
+   VecScatterEndAny - Completes part of a scatter started with VecScatterBegin(), namely the entries of y coming from one
+   process, as soon as they have arrived.
+
+   Neighbor-wise Collective on VecScatter
+
+   Input Parameters:
++  ctx - scatter context generated by VecScatterCreate()
+.  x - the vector from which we scatter
+.  y - the vector to which we scatter
+.  addv - one of ADD_VALUES, MAX_VALUES, MIN_VALUES or INSERT_VALUES
+-  mode - the scattering mode, usually SCATTER_FORWARD
+
+   Output Parameter:
+.  rank - the process, in the communicator of ctx, whose entries of y have been set by this call, MPI_ANY_SOURCE if all
+          the remaining entries have been set, or MPI_UNDEFINED if there was nothing left to set
+
+   Level: developer
+
+   Notes:
+   Call it repeatedly, instead of VecScatterEnd(), until it returns MPI_UNDEFINED or MPI_ANY_SOURCE, which completes the scatter.
+   In between, the entries of y coming from the returned processes may be read, for example with VecGetArrayRead(), while the
+   others are still in flight. Each process is returned at most once.
+
+   Scatter types, and modes, which cannot complete a scatter piecewise complete it entirely and return MPI_ANY_SOURCE.
+
+.seealso: VecScatterBegin(), VecScatterEnd(), VecScatterCreate()
+@*/
+PetscErrorCode VecScatterEndAny(VecScatter ctx,Vec x,Vec y,InsertMode addv,ScatterMode mode,PetscMPIInt *rank)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ctx,VEC_SCATTER_CLASSID,1);
+  PetscValidHeaderSpecific(x,VEC_CLASSID,2);
+  PetscValidHeaderSpecific(y,VEC_CLASSID,3);
+  PetscValidPointer(rank,6);
+  if (!ctx->ops->endany || ctx->beginandendtogether) {
+    ierr  = VecScatterEnd(ctx,x,y,addv,mode);CHKERRQ(ierr);
+    *rank = MPI_ANY_SOURCE;
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscLogEventBegin(VEC_ScatterEnd,ctx,x,y,0);CHKERRQ(ierr);
+  ierr = (*ctx->ops->endany)(ctx,x,y,addv,mode,rank);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(VEC_ScatterEnd,ctx,x,y,0);CHKERRQ(ierr);
+  if (*rank == MPI_UNDEFINED || *rank == MPI_ANY_SOURCE) ctx->inuse = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecScatterBeginMultiple - Begins scattering several vectors with the same scatter context, sending one message per
+   process for all of them when the scatter type supports it. Complete with VecScatterEndMultiple().
+
+   Neighbor-wise Collective on VecScatter
+
+   Input Parameters:
++  ctx - scatter context generated by VecScatterCreate()
+.  k - the number of vectors
+.  x - the k vectors from which we scatter
+.  y - the k vectors to which we scatter, y[i] receiving from x[i]
+.  addv - either ADD_VALUES, MAX_VALUES, MIN_VALUES or INSERT_VALUES
+-  mode - the scattering mode, usually SCATTER_FORWARD
+
+   Level: intermediate
+
+   Notes:
+   This is equivalent to calling VecScatterBegin() and VecScatterEnd() on each pair x[i], y[i], but with VECSCATTERSF
+   the entries of all k vectors that go to the same process are sent in a single message, so the message latency is
+   paid once instead of k times. Scatter types without such support complete the k scatters, one after the other,
+   in VecScatterBeginMultiple().
+
+   The vectors must have the layouts of the vectors used to create the scatter, as in VecScatterBegin().
+
+.seealso: VecScatterEndMultiple(), VecScatterBegin(), DMGlobalToLocalBeginMultiple()
+@*/
+PetscErrorCode VecScatterBeginMultiple(VecScatter ctx,PetscInt k,Vec x[],Vec y[],InsertMode addv,ScatterMode mode)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ctx,VEC_SCATTER_CLASSID,1);
+  if (k < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of vectors %D cannot be negative",k);
+  if (!k) PetscFunctionReturn(0);
+  PetscValidPointer(x,3);
+  PetscValidPointer(y,4);
+  for (i=0; i<k; i++) {
+    PetscValidHeaderSpecific(x[i],VEC_CLASSID,3);
+    PetscValidHeaderSpecific(y[i],VEC_CLASSID,4);
+  }
+  if (!ctx->ops->beginmultiple || ctx->beginandendtogether) {
+    for (i=0; i<k; i++) {
+      ierr = VecScatterBegin(ctx,x[i],y[i],addv,mode);CHKERRQ(ierr);
+      ierr = VecScatterEnd(ctx,x[i],y[i],addv,mode);CHKERRQ(ierr);
+    }
+    PetscFunctionReturn(0);
+  }
+  if (ctx->inuse) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE," Scatter ctx already in use");
+  ctx->inuse = PETSC_TRUE;
+  ierr = PetscLogEventBegin(VEC_ScatterBegin,ctx,x[0],y[0],0);CHKERRQ(ierr);
+  ierr = (*ctx->ops->beginmultiple)(ctx,k,x,y,addv,mode);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(VEC_ScatterBegin,ctx,x[0],y[0],0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecScatterEndMultiple - Ends the scatter of several vectors started with VecScatterBeginMultiple().
+
+   Neighbor-wise Collective on VecScatter
+
+   Input Parameters:
++  ctx - scatter context generated by VecScatterCreate()
+.  k - the number of vectors
+.  x - the k vectors from which we scatter
+.  y - the k vectors to which we scatter
+.  addv - one of ADD_VALUES, MAX_VALUES, MIN_VALUES or INSERT_VALUES
+-  mode - the scattering mode, usually SCATTER_FORWARD
+
+   Level: intermediate
+
+.seealso: VecScatterBeginMultiple(), VecScatterEnd()
+@*/
+PetscErrorCode VecScatterEndMultiple(VecScatter ctx,PetscInt k,Vec x[],Vec y[],InsertMode addv,ScatterMode mode)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ctx,VEC_SCATTER_CLASSID,1);
+  if (k <= 0 || !ctx->ops->beginmultiple || ctx->beginandendtogether) PetscFunctionReturn(0);
+  PetscValidPointer(x,3);
+  PetscValidPointer(y,4);
+  ctx->inuse = PETSC_FALSE;
+  ierr = PetscLogEventBegin(VEC_ScatterEnd,ctx,x[0],y[0],0);CHKERRQ(ierr);
+  ierr = (*ctx->ops->endmultiple)(ctx,k,x,y,addv,mode);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(VEC_ScatterEnd,ctx,x[0],y[0],0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
    VecScatterDestroy - Destroys a scatter context created by VecScatterCreate()
 